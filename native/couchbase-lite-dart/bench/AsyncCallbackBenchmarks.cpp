@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AsyncCallback.h"
+#include "Benchmark.h"
+
+namespace CBLDart::Bench {
+
+// === AsyncCallback ==========================================================
+
+/**
+ * Stands in for posting a message to a Dart isolate, so that only the cost of
+ * the native side of a call is measured.
+ */
+static bool postCObject(Dart_Port, Dart_CObject *) { return true; }
+
+/** The number of callbacks which are registered while measuring lookups. */
+static const size_t kRegisteredCallbackCount = 64;
+
+/**
+ * Runs `body` concurrently on `threadCount` threads, which are started
+ * together.
+ */
+static void runConcurrently(size_t threadCount,
+                            const std::function<void(size_t thread)> &body) {
+  std::atomic<bool> start = false;
+  std::vector<std::thread> threads;
+  for (size_t thread = 0; thread < threadCount; thread++) {
+    threads.emplace_back([&, thread] {
+      while (!start.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      body(thread);
+    });
+  }
+  start.store(true, std::memory_order_release);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+static std::vector<size_t> threadCounts() {
+  auto maxThreadCount =
+      std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  std::vector<size_t> counts;
+  for (size_t count = 1; count <= std::min<size_t>(maxThreadCount, 16);
+       count *= 2) {
+    counts.push_back(count);
+  }
+  return counts;
+}
+
+static std::vector<std::unique_ptr<AsyncCallback>> createCallbacks(
+    size_t count) {
+  std::vector<std::unique_ptr<AsyncCallback>> callbacks;
+  for (size_t i = 0; i < count; i++) {
+    // The send port is never used, since posting messages is stubbed out.
+    callbacks.push_back(std::make_unique<AsyncCallback>(
+        static_cast<uint32_t>(i), static_cast<Dart_Port>(i + 1), false));
+  }
+  return callbacks;
+}
+
+static void executeCalls(AsyncCallback &callback, size_t iterations) {
+  for (size_t i = 0; i < iterations; i++) {
+    Dart_CObject argument{};
+    argument.type = Dart_CObject_kInt64;
+    argument.value.as_int64 = static_cast<int64_t>(i);
+
+    Dart_CObject *argsValues[] = {&argument};
+
+    Dart_CObject args{};
+    args.type = Dart_CObject_kArray;
+    args.value.as_array.length = 1;
+    args.value.as_array.values = argsValues;
+
+    AsyncCallbackCall(callback).execute(args);
+  }
+}
+
+void runAsyncCallbackBenchmarks(BenchmarkRunner &runner) {
+  Dart_PostCObject_DL = postCObject;
+
+  for (auto threadCount : threadCounts()) {
+    auto threads = "/threads:" + std::to_string(threadCount);
+
+    {
+      auto callbacks = createCallbacks(threadCount);
+      runner.run("AsyncCallbackCall/execute/separateCallbacks" + threads,
+                 threadCount, "calls", [&](size_t iterations) {
+                   runConcurrently(threadCount, [&](size_t thread) {
+                     executeCalls(*callbacks[thread], iterations);
+                   });
+                 });
+    }
+
+    {
+      auto callbacks = createCallbacks(1);
+      runner.run("AsyncCallbackCall/execute/sharedCallback" + threads,
+                 threadCount, "calls", [&](size_t iterations) {
+                   runConcurrently(threadCount, [&](size_t) {
+                     executeCalls(*callbacks[0], iterations);
+                   });
+                 });
+    }
+
+    {
+      auto callbacks = createCallbacks(kRegisteredCallbackCount);
+      runner.run(
+          "AsyncCallbackRegistry/callbackExists" + threads, threadCount,
+          "lookups", [&](size_t iterations) {
+            runConcurrently(threadCount, [&](size_t thread) {
+              auto &registry = AsyncCallbackRegistry::instance;
+              bool exists = true;
+              for (size_t i = 0; i < iterations; i++) {
+                auto &callback =
+                    *callbacks[(thread + i) % kRegisteredCallbackCount];
+                exists &= registry.callbackExists(callback);
+              }
+              doNotOptimize(exists);
+            });
+          });
+    }
+
+    runner.run("AsyncCallbackRegistry/registerUnregister" + threads,
+               threadCount, "callbacks", [&](size_t iterations) {
+                 runConcurrently(threadCount, [&](size_t thread) {
+                   for (size_t i = 0; i < iterations; i++) {
+                     AsyncCallback callback(static_cast<uint32_t>(thread),
+                                            1, false);
+                     doNotOptimize(callback);
+                   }
+                 });
+               });
+  }
+}
+
+}  // namespace CBLDart::Bench
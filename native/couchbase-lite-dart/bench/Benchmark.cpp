@@ -0,0 +1,91 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace CBLDart::Bench {
+
+// === Benchmark ==============================================================
+
+const void *volatile doNotOptimizeSink = nullptr;
+
+static const double kMinSampleSeconds = 0.1;
+static const size_t kSampleCount = 5;
+
+static std::string formatRate(double rate, const char *unit) {
+  static const char *prefixes[] = {"", "k", "M", "G"};
+  size_t prefix = 0;
+  while (rate >= 1000 && prefix < 3) {
+    rate /= 1000;
+    prefix++;
+  }
+  char buffer[64];
+  std::snprintf(buffer, sizeof(buffer), "%8.2f %s%s/s", rate,
+                prefixes[prefix], unit);
+  return buffer;
+}
+
+void BenchmarkRunner::run(const std::string &name, size_t items,
+                          const char *unit, const BenchmarkBody &body) {
+  if (name.find(filter_) == std::string::npos) {
+    return;
+  }
+  benchmarkCount_++;
+
+  // The first measurement also warms up caches and pools.
+  size_t iterations = 1;
+  auto seconds = measure(iterations, body);
+  while (seconds < kMinSampleSeconds) {
+    // Overshoot slightly, so that the next sample most likely takes long
+    // enough.
+    auto factor = seconds > 0 ? kMinSampleSeconds / seconds * 1.2 : 10.0;
+    iterations = static_cast<size_t>(
+        static_cast<double>(iterations) * std::clamp(factor, 2.0, 100.0));
+    seconds = measure(iterations, body);
+  }
+
+  std::vector<double> secondsPerIteration;
+  for (size_t i = 0; i < kSampleCount; i++) {
+    secondsPerIteration.push_back(measure(iterations, body) /
+                                  static_cast<double>(iterations));
+  }
+  std::sort(secondsPerIteration.begin(), secondsPerIteration.end());
+  auto median = secondsPerIteration[kSampleCount / 2];
+
+  std::printf("%-64s %12.1f ns/iteration %s\n", name.c_str(), median * 1e9,
+              formatRate(static_cast<double>(items) / median, unit).c_str());
+  std::fflush(stdout);
+}
+
+double BenchmarkRunner::measure(size_t iterations, const BenchmarkBody &body) {
+  auto start = std::chrono::steady_clock::now();
+  body(iterations);
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+// === Fixtures ===============================================================
+
+std::string readFixture(const std::string &name) {
+  std::string directory = CBL_DART_BENCH_FIXTURES_DIR;
+  if (auto override = std::getenv("CBL_DART_BENCH_FIXTURES_DIR")) {
+    directory = override;
+  }
+
+  auto path = directory + "/" + name;
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Could not open fixture: " + path);
+  }
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+}  // namespace CBLDart::Bench
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace CBLDart::Bench {
+
+// === Benchmark ==============================================================
+
+/**
+ * The body of a benchmark, which has to perform the measured operation
+ * `iterations` times.
+ */
+typedef std::function<void(size_t iterations)> BenchmarkBody;
+
+extern const void *volatile doNotOptimizeSink;
+
+/**
+ * Prevents the compiler from optimizing away the computation of `value`.
+ */
+template <typename T>
+inline void doNotOptimize(const T &value) {
+  doNotOptimizeSink = &value;
+}
+
+/**
+ * Runs benchmarks and prints their results.
+ *
+ * The number of iterations of a benchmark is calibrated, so that a sample
+ * takes at least the minimum sample time. The median of several samples is
+ * reported, so that outliers caused by other processes are ignored.
+ */
+class BenchmarkRunner {
+ public:
+  /** Only benchmarks whose name contains `filter` are run. */
+  explicit BenchmarkRunner(std::string filter) : filter_(std::move(filter)) {}
+
+  /**
+   * Runs the benchmark `name`.
+   *
+   * An iteration processes `items` items of `unit`, e.g. values or bytes,
+   * which is used to report the throughput of the benchmark.
+   */
+  void run(const std::string &name, size_t items, const char *unit,
+           const BenchmarkBody &body);
+
+  /** The number of benchmarks which have been run. */
+  size_t benchmarkCount() const { return benchmarkCount_; }
+
+ private:
+  double measure(size_t iterations, const BenchmarkBody &body);
+
+  std::string filter_;
+  size_t benchmarkCount_ = 0;
+};
+
+// === Fixtures ===============================================================
+
+/**
+ * Returns the content of the fixture file `name`.
+ *
+ * Fixtures are read from the fixtures of the e2e tests, unless the
+ * `CBL_DART_BENCH_FIXTURES_DIR` environment variable specifies a different
+ * directory.
+ */
+std::string readFixture(const std::string &name);
+
+// === Suites =================================================================
+
+void runFleeceBenchmarks(BenchmarkRunner &runner);
+
+void runAsyncCallbackBenchmarks(BenchmarkRunner &runner);
+
+void runBlobBenchmarks(BenchmarkRunner &runner);
+
+}  // namespace CBLDart::Bench
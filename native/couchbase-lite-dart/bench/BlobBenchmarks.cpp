@@ -0,0 +1,87 @@
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "CBL+Dart.h"
+
+namespace CBLDart::Bench {
+
+// === Blob ===================================================================
+
+/**
+ * The chunk sizes which are measured, from the initial chunk size of the
+ * Dart blob read stream up to its maximum chunk size, and a smaller one for
+ * comparison.
+ */
+static const size_t kChunkSizes[] = {4 * 1024,   8 * 1024,   64 * 1024,
+                                     256 * 1024, 1024 * 1024};
+
+static void checkError(bool success, const CBLError &error,
+                       const char *operation) {
+  if (success) {
+    return;
+  }
+  auto message = CBLError_Message(&error);
+  std::string description(static_cast<const char *>(message.buf),
+                          message.size);
+  FLSliceResult_Release(message);
+  throw std::runtime_error(std::string(operation) + ": " + description);
+}
+
+static void readBlob(const CBLBlob *blob, std::vector<uint8_t> &buffer,
+                     size_t chunkSize) {
+  CBLError error{};
+  auto stream = CBLBlob_OpenContentStream(blob, &error);
+  checkError(stream != nullptr, error, "CBLBlob_OpenContentStream");
+
+  int bytesRead;
+  while ((bytesRead = CBLBlobReader_Read(stream, buffer.data(), chunkSize,
+                                         &error)) > 0) {
+  }
+  CBLBlobReader_Close(stream);
+  checkError(bytesRead == 0, error, "CBLBlobReader_Read");
+}
+
+void runBlobBenchmarks(BenchmarkRunner &runner) {
+  auto content = readFixture("1000people.json");
+
+  auto directory =
+      (std::filesystem::temp_directory_path() / "cblitedart_bench").string();
+  std::filesystem::remove_all(directory);
+
+  CBLError error{};
+  auto config = CBLDatabaseConfiguration_Default();
+  config.directory = {directory.data(), directory.size()};
+  auto database = CBLDatabase_Open(FLStr("blobs"), &config, &error);
+  checkError(database != nullptr, error, "CBLDatabase_Open");
+
+  auto newBlob = CBLBlob_CreateWithData(FLStr("application/json"),
+                                        {content.data(), content.size()});
+  checkError(CBLDatabase_SaveBlob(database, newBlob, &error), error,
+             "CBLDatabase_SaveBlob");
+  auto blob =
+      CBLDatabase_GetBlob(database, CBLBlob_Properties(newBlob), &error);
+  CBLBlob_Release(newBlob);
+  checkError(blob != nullptr, error, "CBLDatabase_GetBlob");
+
+  std::vector<uint8_t> buffer(kChunkSizes[std::size(kChunkSizes) - 1]);
+  for (auto chunkSize : kChunkSizes) {
+    runner.run("CBLBlobReader_Read/chunkSize:" + std::to_string(chunkSize),
+               content.size(), "B", [&](size_t iterations) {
+                 for (size_t i = 0; i < iterations; i++) {
+                   readBlob(blob, buffer, chunkSize);
+                 }
+                 doNotOptimize(buffer);
+               });
+  }
+
+  CBLBlob_Release(blob);
+  checkError(CBLDatabase_Delete(database, &error), error,
+             "CBLDatabase_Delete");
+  CBLDatabase_Release(database);
+  std::filesystem::remove_all(directory);
+}
+
+}  // namespace CBLDart::Bench
@@ -0,0 +1,186 @@
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Fleece+Dart.h"
+
+namespace CBLDart::Bench {
+
+// === Fleece =================================================================
+
+/** The size of the batches in which the Dart decoder loads entries. */
+static const uint32_t kBatchCapacity = 64;
+
+static FLDoc encodeJSON(const std::string &json, FLSharedKeys sharedKeys) {
+  auto encoder = FLEncoder_New();
+  if (sharedKeys) {
+    FLEncoder_SetSharedKeys(encoder, sharedKeys);
+  }
+  FLEncoder_ConvertJSON(encoder, {json.data(), json.size()});
+  auto data = FLEncoder_Finish(encoder, nullptr);
+  FLEncoder_Free(encoder);
+  return FLDoc_FromResultData(data, kFLTrusted, sharedKeys, kFLSliceNull);
+}
+
+/** Collects `value` and all values nested in it. */
+static void collectValues(FLValue value, std::vector<FLValue> &values,
+                          std::vector<FLDict> &dicts,
+                          std::vector<FLArray> &arrays) {
+  values.push_back(value);
+  switch (FLValue_GetType(value)) {
+    case kFLArray: {
+      auto array = FLValue_AsArray(value);
+      arrays.push_back(array);
+      FLArrayIterator iterator;
+      FLArrayIterator_Begin(array, &iterator);
+      while (auto element = FLArrayIterator_GetValue(&iterator)) {
+        collectValues(element, values, dicts, arrays);
+        FLArrayIterator_Next(&iterator);
+      }
+      break;
+    }
+    case kFLDict: {
+      auto dict = FLValue_AsDict(value);
+      dicts.push_back(dict);
+      FLDictIterator iterator;
+      FLDictIterator_Begin(dict, &iterator);
+      while (auto entry = FLDictIterator_GetValue(&iterator)) {
+        collectValues(entry, values, dicts, arrays);
+        FLDictIterator_Next(&iterator);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+/** A decoded fixture and the values nested in it. */
+struct FleeceFixture {
+  FleeceFixture(const std::string &json, FLSharedKeys sharedKeys)
+      : doc(encodeJSON(json, sharedKeys)) {
+    collectValues(FLDoc_GetRoot(doc), values, dicts, arrays);
+    for (auto dict : dicts) {
+      dictEntryCount += FLDict_Count(dict);
+    }
+    for (auto array : arrays) {
+      arrayElementCount += FLArray_Count(array);
+    }
+  }
+
+  ~FleeceFixture() { FLDoc_Release(doc); }
+
+  FLDoc doc;
+  std::vector<FLValue> values;
+  std::vector<FLDict> dicts;
+  std::vector<FLArray> arrays;
+  size_t dictEntryCount = 0;
+  size_t arrayElementCount = 0;
+};
+
+static void iterateDicts(const FleeceFixture &fixture,
+                         KnownSharedKeys *knownSharedKeys, bool batched) {
+  CBLDart_LoadedDictKey keys[kBatchCapacity];
+  CBLDart_LoadedFLValue values[kBatchCapacity];
+  for (auto dict : fixture.dicts) {
+    auto iterator = CBLDart_FLDictIterator_Begin(dict, knownSharedKeys, keys,
+                                                 values, true, true);
+    if (batched) {
+      while (CBLDart_FLDictIterator_NextBatch(iterator, keys, values,
+                                              kBatchCapacity) > 0) {
+      }
+    } else {
+      while (CBLDart_FLDictIterator_Next(iterator)) {
+      }
+    }
+  }
+  doNotOptimize(keys);
+  doNotOptimize(values);
+}
+
+static void iterateArrays(const FleeceFixture &fixture, bool batched) {
+  CBLDart_LoadedFLValue values[kBatchCapacity];
+  for (auto array : fixture.arrays) {
+    auto iterator = CBLDart_FLArrayIterator_Begin(array, values, true);
+    if (batched) {
+      while (CBLDart_FLArrayIterator_NextBatch(iterator, values,
+                                               kBatchCapacity) > 0) {
+      }
+    } else {
+      while (CBLDart_FLArrayIterator_Next(iterator)) {
+      }
+    }
+  }
+  doNotOptimize(values);
+}
+
+void runFleeceBenchmarks(BenchmarkRunner &runner) {
+  auto json = readFixture("1000people.json");
+  auto sharedKeys = FLSharedKeys_New();
+  FleeceFixture plain(json, nullptr);
+  FleeceFixture shared(json, sharedKeys);
+
+  runner.run("Fleece/GetLoadedFLValue", plain.values.size(), "values",
+             [&](size_t iterations) {
+               CBLDart_LoadedFLValue out;
+               for (size_t i = 0; i < iterations; i++) {
+                 for (auto value : plain.values) {
+                   CBLDart_GetLoadedFLValue(value, &out);
+                 }
+               }
+               doNotOptimize(out);
+             });
+
+  for (auto batched : {false, true}) {
+    std::string method = batched ? "NextBatch" : "Next";
+
+    runner.run("Fleece/DictIterator/" + method + "/stringKeys",
+               plain.dictEntryCount, "entries", [&](size_t iterations) {
+                 for (size_t i = 0; i < iterations; i++) {
+                   iterateDicts(plain, nullptr, batched);
+                 }
+               });
+
+    runner.run("Fleece/DictIterator/" + method + "/sharedKeys",
+               shared.dictEntryCount, "entries", [&](size_t iterations) {
+                 for (size_t i = 0; i < iterations; i++) {
+                   iterateDicts(shared, nullptr, batched);
+                 }
+               });
+
+    // Every iteration starts with no known shared keys, like the first
+    // decoding of a document.
+    runner.run(
+        "Fleece/DictIterator/" + method + "/sharedKeys/coldKnownSharedKeys",
+        shared.dictEntryCount, "entries", [&](size_t iterations) {
+          for (size_t i = 0; i < iterations; i++) {
+            auto knownSharedKeys = CBLDart_KnownSharedKeys_New();
+            iterateDicts(shared, knownSharedKeys, batched);
+            CBLDart_KnownSharedKeys_Delete(knownSharedKeys);
+          }
+        });
+
+    // All shared keys are known after the first iteration, like when
+    // documents of the same database are decoded repeatedly.
+    runner.run(
+        "Fleece/DictIterator/" + method + "/sharedKeys/warmKnownSharedKeys",
+        shared.dictEntryCount, "entries", [&](size_t iterations) {
+          auto knownSharedKeys = CBLDart_KnownSharedKeys_New();
+          for (size_t i = 0; i < iterations; i++) {
+            iterateDicts(shared, knownSharedKeys, batched);
+          }
+          CBLDart_KnownSharedKeys_Delete(knownSharedKeys);
+        });
+
+    runner.run("Fleece/ArrayIterator/" + method, plain.arrayElementCount,
+               "elements", [&](size_t iterations) {
+                 for (size_t i = 0; i < iterations; i++) {
+                   iterateArrays(plain, batched);
+                 }
+               });
+  }
+
+  FLSharedKeys_Release(sharedKeys);
+}
+
+}  // namespace CBLDart::Bench
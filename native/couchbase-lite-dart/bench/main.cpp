@@ -0,0 +1,39 @@
+#include <cstdio>
+#include <exception>
+#include <string>
+
+#include "Benchmark.h"
+#include "CBL+Dart.h"
+
+using namespace CBLDart::Bench;
+
+/**
+ * Runs the native benchmarks.
+ *
+ * The only argument is an optional filter, which selects the benchmarks whose
+ * name contains it.
+ */
+int main(int argc, char **argv) {
+  if (argc > 2) {
+    std::fprintf(stderr, "Usage: %s [filter]\n", argv[0]);
+    return 2;
+  }
+
+  CBLLog_SetConsoleLevel(kCBLLogWarning);
+
+  BenchmarkRunner runner(argc == 2 ? argv[1] : "");
+  try {
+    runFleeceBenchmarks(runner);
+    runAsyncCallbackBenchmarks(runner);
+    runBlobBenchmarks(runner);
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "Benchmark failed: %s\n", e.what());
+    return 1;
+  }
+
+  if (runner.benchmarkCount() == 0) {
+    std::fprintf(stderr, "No benchmark matches the filter.\n");
+    return 1;
+  }
+  return 0;
+}
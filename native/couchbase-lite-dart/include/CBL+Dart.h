@@ -24,17 +24,23 @@ enum CBLDartInitializeResult {
   CBLDartInitializeResult_kCBLInitError,
 };
 
+typedef struct CBLDart_FunctionTable CBLDart_FunctionTable;
+
 /**
  * Initializes the native libraries.
  *
  * This function can be called multiple times and is thread save. The
  * libraries are only initialized by the first call and subsequent calls are
  * NOOPs.
+ *
+ * Every successful call stores the function table of this library in
+ * `functionTableOut`, so that an isolate can bind the functions it needs
+ * during startup without looking up each symbol.
  */
 CBLDART_EXPORT
-CBLDartInitializeResult CBLDart_Initialize(void *dartInitializeDlData,
-                                           void *cblInitContext,
-                                           CBLError *errorOut);
+CBLDartInitializeResult CBLDart_Initialize(
+    void *dartInitializeDlData, void *cblInitContext,
+    const CBLDart_FunctionTable **functionTableOut, CBLError *errorOut);
 
 // === Dart Native ============================================================
 
@@ -52,10 +58,135 @@ void CBLDart_AsyncCallback_Delete(CBLDart_AsyncCallback callback);
 CBLDART_EXPORT
 void CBLDart_AsyncCallback_Close(CBLDart_AsyncCallback callback);
 
+/**
+ * Enables delivering the arguments of non-blocking calls of `callback` in
+ * batches of up to `maxBatchSize` calls.
+ *
+ * After the Dart side has handled a batch, it must call
+ * `CBLDart_AsyncCallback_BatchDelivered`, before the next batch is sent.
+ */
+CBLDART_EXPORT
+void CBLDart_AsyncCallback_EnableBatching(CBLDart_AsyncCallback callback,
+                                          uint32_t maxBatchSize);
+
+CBLDART_EXPORT
+void CBLDart_AsyncCallback_BatchDelivered(CBLDart_AsyncCallback callback);
+
 CBLDART_EXPORT
 void CBLDart_AsyncCallback_CallForTest(CBLDart_AsyncCallback callback,
                                        int64_t argument);
 
+// === Stats
+
+/** The number of buckets of a `CBLDart_LatencyHistogram`. */
+#define kCBLDart_LatencyHistogramBuckets 24
+
+/**
+ * A histogram of durations, such as those of the calls to a callback.
+ *
+ * Bucket `0` counts calls which took less than 1 microsecond and bucket `i`
+ * calls which took at least 2^(i - 1) and less than 2^i microseconds. The last
+ * bucket also counts all longer calls.
+ */
+typedef struct {
+  uint64_t count;
+  uint64_t totalMicros;
+  uint64_t maxMicros;
+  uint64_t buckets[kCBLDart_LatencyHistogramBuckets];
+} CBLDart_LatencyHistogram;
+
+/**
+ * Statistics of the hot paths of this library, which are collected since it
+ * has been loaded.
+ */
+typedef struct {
+  /** The number of calls of async callbacks, blocking or not. */
+  uint64_t asyncCallbackCalls;
+  /**
+   * The durations of blocking calls of async callbacks, from sending the call
+   * to its completion.
+   */
+  CBLDart_LatencyHistogram blockingAsyncCallbackCalls;
+  /** The number of invocations of the native wrappers of listeners. */
+  uint64_t listenerInvocations;
+  /** The number of log messages which have been sent to the log callback. */
+  uint64_t logCallbackMessages;
+  /**
+   * The number of bytes of blob content which have been read by this library,
+   * from the blob cache or to write blobs to files.
+   */
+  uint64_t blobBytesRead;
+  /** The number of times a database lock has been acquired. */
+  uint64_t databaseLockAcquisitions;
+  /**
+   * The durations of the waits for database locks which were held by another
+   * thread, when they were acquired.
+   */
+  CBLDart_LatencyHistogram databaseLockWaits;
+} CBLDart_Stats;
+
+/** Copies the current statistics of this library into `statsOut`. */
+CBLDART_EXPORT
+void CBLDart_Stats_Snapshot(CBLDart_Stats *statsOut);
+
+// === Timeline
+
+/**
+ * Enables recording native work, such as callbacks into Dart, listeners and
+ * replicator filters, as events in the `Embedder` stream of the Dart
+ * timeline.
+ *
+ * Calls into Dart are linked to their handling in Dart by flows. Calls of
+ * this function must be balanced by calls of `CBLDart_Timeline_Disable`.
+ *
+ * Returns false if the timeline is not available in the current process, in
+ * which case `CBLDart_Timeline_Disable` must not be called.
+ */
+CBLDART_EXPORT
+bool CBLDart_Timeline_Enable(void);
+
+CBLDART_EXPORT
+void CBLDart_Timeline_Disable(void);
+
+// === Function Table
+
+/**
+ * The version of the layout of `CBLDart_FunctionTable`.
+ *
+ * It must be incremented whenever the layout changes.
+ */
+#define kCBLDart_FunctionTableVersion 1
+
+/**
+ * The functions which every isolate needs during startup.
+ *
+ * The table is returned by `CBLDart_Initialize`. All other functions are
+ * looked up on demand, by the group of bindings that uses them.
+ */
+struct CBLDart_FunctionTable {
+  /** The value of `kCBLDart_FunctionTableVersion` of this library. */
+  uint32_t version;
+
+  // Base
+  CBLRefCounted *(*CBL_Retain)(CBLRefCounted *);
+  void (*CBL_Release)(CBLRefCounted *);
+  FLSliceResult (*CBLError_Message)(const CBLError *);
+  void (*CBLListener_Remove)(CBLListenerToken *);
+  void (*CBLDart_Stats_Snapshot)(CBLDart_Stats *);
+  bool (*CBLDart_Timeline_Enable)(void);
+  void (*CBLDart_Timeline_Disable)(void);
+
+  // Async Callbacks
+  CBLDart_AsyncCallback (*CBLDart_AsyncCallback_New)(uint32_t, Dart_Port,
+                                                     bool);
+  void (*CBLDart_AsyncCallback_Delete)(CBLDart_AsyncCallback);
+  void (*CBLDart_AsyncCallback_Close)(CBLDart_AsyncCallback);
+  void (*CBLDart_AsyncCallback_EnableBatching)(CBLDart_AsyncCallback,
+                                               uint32_t);
+  void (*CBLDart_AsyncCallback_BatchDelivered)(CBLDart_AsyncCallback);
+  void (*CBLDart_AsyncCallback_CallForTest)(CBLDart_AsyncCallback, int64_t);
+};
+
 // === Couchbase Lite =========================================================
 
 // === Log
@@ -63,9 +194,21 @@ void CBLDart_AsyncCallback_CallForTest(CBLDart_AsyncCallback callback,
 CBLDART_EXPORT
 bool CBLDart_CBLLog_SetCallback(CBLDart_AsyncCallback callback);
 
+/** Sets the level of the messages of all domains, which are delivered. */
 CBLDART_EXPORT
 void CBLDart_CBLLog_SetCallbackLevel(CBLLogLevel level);
 
+/**
+ * Sets the level of the messages of `domain`, which are delivered to the
+ * callback.
+ *
+ * Messages are filtered by the level of their domain on the logging thread,
+ * before they are buffered for delivery.
+ */
+CBLDART_EXPORT
+void CBLDart_CBLLog_SetCallbackDomainLevel(CBLLogDomain domain,
+                                           CBLLogLevel level);
+
 CBLDART_EXPORT
 bool CBLDart_CBLLog_SetFileConfig(CBLLogFileConfiguration *config,
                                   CBLError *errorOut);
@@ -76,6 +219,19 @@ CBLLogFileConfiguration *CBLDart_CBLLog_GetFileConfig();
 CBLDART_EXPORT
 bool CBLDart_CBLLog_SetSentryBreadcrumbs(bool enabled);
 
+/**
+ * Configures which log messages are recorded as Sentry breadcrumbs.
+ *
+ * Only messages at or above `level` are recorded, and at most `maxPerSecond`
+ * messages per second, or an unlimited number if `maxPerSecond` is 0.
+ * Breadcrumbs are recorded asynchronously, off the logging threads.
+ *
+ * The defaults are `kCBLLogInfo` and 100 messages per second.
+ */
+CBLDART_EXPORT
+void CBLDart_CBLLog_ConfigureSentryBreadcrumbs(CBLLogLevel level,
+                                               uint32_t maxPerSecond);
+
 // === Database
 
 CBLDART_EXPORT
@@ -90,29 +246,336 @@ CBLDART_EXPORT
 bool CBLDart_CBLDatabase_Close(CBLDatabase *database, bool andDelete,
                                CBLError *errorOut);
 
+/**
+ * Begins a transaction on `database`.
+ *
+ * All transactions must be begun and ended through these functions, so that
+ * the document cache knows when uncommitted changes can be read.
+ */
+CBLDART_EXPORT
+bool CBLDart_CBLDatabase_BeginTransaction(CBLDatabase *database,
+                                          CBLError *errorOut);
+
+CBLDART_EXPORT
+bool CBLDart_CBLDatabase_EndTransaction(CBLDatabase *database, bool commit,
+                                        CBLError *errorOut);
+
+/**
+ * A handle to a database which is shared by all the openers of the database
+ * in the process.
+ */
+typedef struct CBLDart_SharedDatabase CBLDart_SharedDatabase;
+
+/**
+ * Opens a handle to the database with the given `name` in the directory of
+ * `config`.
+ *
+ * All handles to the same database share one `CBLDatabase`, which is only
+ * opened by the first handle and closed when the last handle is closed.
+ * Opening a handle fails with `kCBLErrorInvalidParameter` if the database is
+ * already open with a different encryption key.
+ */
+CBLDART_EXPORT
+CBLDart_SharedDatabase *CBLDart_CBLDatabase_OpenShared(
+    FLString name, CBLDatabaseConfiguration *config, CBLError *errorOut);
+
+/** Returns the database shared through `handle`. */
+CBLDART_EXPORT
+CBLDatabase *CBLDart_SharedDatabase_Database(CBLDart_SharedDatabase *handle);
+
+/**
+ * Closes `handle` and the shared database, if it is the last open handle.
+ *
+ * Closing a handle more than once has no effect. Deleting the database fails
+ * with `kCBLErrorBusy` while other handles are open.
+ */
+CBLDART_EXPORT
+bool CBLDart_SharedDatabase_Close(CBLDart_SharedDatabase *handle,
+                                  bool andDelete, CBLError *errorOut);
+
+CBLDART_EXPORT
+void CBLDart_SharedDatabase_Release(CBLDart_SharedDatabase *handle);
+
+/**
+ * Begins a transaction through `handle`.
+ *
+ * The handles of a shared database share the transaction of its
+ * `CBLDatabase`. To keep the transactions of different handles apart, this
+ * function waits until no other handle has a transaction open. Nested
+ * transactions of the same handle do not wait.
+ */
+CBLDART_EXPORT
+bool CBLDart_SharedDatabase_BeginTransaction(CBLDart_SharedDatabase *handle,
+                                             CBLError *errorOut);
+
+/** Ends a transaction which has been begun through `handle`. */
+CBLDART_EXPORT
+bool CBLDart_SharedDatabase_EndTransaction(CBLDart_SharedDatabase *handle,
+                                           bool commit, CBLError *errorOut);
+
+/**
+ * Starts running the maintenance `types` of `db` on a background thread.
+ *
+ * `types` is a bit set of `CBLMaintenanceType`s, which are performed in the
+ * order of their values. A run starts at most every `intervalMs`, once no
+ * document of the collections which exist when the schedule starts has been
+ * changed for `idleMs`. The database level lock is only held while a single
+ * type of maintenance is performed.
+ *
+ * `callback` is called with `[false, type]` when a type of maintenance starts.
+ * When a run has finished, it is called with `[true, sizeBefore, sizeAfter]`,
+ * the size of the database file before and after the run, followed by the
+ * error domain, code and message, if the run failed.
+ *
+ * Closing `callback` stops the schedule. A type of maintenance which is being
+ * performed cannot be interrupted, but the remaining types of the run are
+ * skipped.
+ */
+CBLDART_EXPORT
+void CBLDart_CBLDatabase_ScheduleMaintenance(const CBLDatabase *db,
+                                             uint32_t types,
+                                             uint64_t intervalMs,
+                                             uint64_t idleMs,
+                                             CBLDart_AsyncCallback callback);
+
 // === Collection
 
+/**
+ * Notifies `listener` when the document with `docID` in `collection` changes.
+ *
+ * All document change listeners of a collection share a single collection
+ * change listener, which dispatches changes natively to the listeners of the
+ * changed documents.
+ *
+ * If `debounceMilliseconds` is larger than 0, `listener` is notified at the
+ * end of the debounce window that starts with the first change of the
+ * document, and all changes in the window are coalesced into one
+ * notification.
+ */
 CBLDART_EXPORT
 void CBLDart_CBLCollection_AddDocumentChangeListener(
     const CBLDatabase *db, const CBLCollection *collection,
-    const FLString docID, CBLDart_AsyncCallback listener);
+    const FLString docID, uint32_t debounceMilliseconds,
+    CBLDart_AsyncCallback listener);
+
+/**
+ * Gets the documents with the given `docIDs` from `collection` in a single
+ * call.
+ *
+ * `documentsOut` must have room for `count` documents. For each id, it
+ * receives the document, which must be released by the caller, or `NULL` if
+ * the document does not exist.
+ *
+ * If an error occurs, no documents are returned and `false` is returned.
+ */
+CBLDART_EXPORT
+bool CBLDart_CBLCollection_GetDocuments(const CBLCollection *collection,
+                                        const FLString *docIDs, size_t count,
+                                        const CBLDocument **documentsOut,
+                                        CBLError *errorOut);
+
+/**
+ * Saves `count` documents to `collection` in a single transaction.
+ *
+ * For each document, `resultsOut` receives `1` if the document was saved or
+ * `0` if it was not saved because of a conflict, which is only possible with
+ * `kCBLConcurrencyControlFailOnConflict`.
+ *
+ * If any other error occurs, the transaction is aborted, no documents are
+ * saved and `false` is returned.
+ */
+CBLDART_EXPORT
+bool CBLDart_CBLCollection_SaveDocuments(
+    CBLCollection *collection, CBLDocument **documents, size_t count,
+    CBLConcurrencyControl concurrencyControl, uint8_t *resultsOut,
+    CBLError *errorOut);
+
+/**
+ * Sets the expiration dates of `count` documents with `docIDs` in
+ * `collection` in a single transaction. An expiration of `0` clears the
+ * expiration date of a document.
+ *
+ * If the expiration date of any document cannot be set, for example because
+ * the document does not exist, the transaction is aborted, no expiration dates
+ * are changed and `false` is returned.
+ *
+ * The expiration dates are tracked to count the documents which are purged
+ * because they expired. See `CBLDart_CBLCollection_ExpirationStats`.
+ */
+CBLDART_EXPORT
+bool CBLDart_CBLCollection_SetDocumentExpirations(
+    CBLCollection *collection, const FLString *docIDs,
+    const CBLTimestamp *expirations, size_t count, CBLError *errorOut);
+
+/**
+ * Sets the `expiration` date of the document with `docID` in `collection`,
+ * like `CBLCollection_SetDocumentExpiration`, and tracks it like
+ * `CBLDart_CBLCollection_SetDocumentExpirations`.
+ */
+CBLDART_EXPORT
+bool CBLDart_CBLCollection_SetDocumentExpiration(CBLCollection *collection,
+                                                 FLString docID,
+                                                 CBLTimestamp expiration,
+                                                 CBLError *errorOut);
+
+typedef struct {
+  /**
+   * The number of tracked documents which have been purged, because they
+   * expired.
+   */
+  uint64_t purgedCount;
+  /** The number of tracked documents, which have not been purged yet. */
+  uint64_t pendingCount;
+  /** The earliest expiration date of the tracked documents, or `0`. */
+  CBLTimestamp nextExpiration;
+} CBLDart_ExpirationStats;
+
+/**
+ * Returns the stats of the document expirations of `collection`, which have
+ * been set through `CBLDart_CBLCollection_SetDocumentExpiration` or
+ * `CBLDart_CBLCollection_SetDocumentExpirations`, since the database has been
+ * opened.
+ */
+CBLDART_EXPORT
+CBLDart_ExpirationStats CBLDart_CBLCollection_ExpirationStats(
+    const CBLCollection *collection);
+
+/**
+ * Applies `patch` to the properties of the document with `docID` in
+ * `collection`, as a JSON merge patch (RFC 7386), and saves the document.
+ *
+ * `patch` is the Fleece encoded dict of the patch. Keys with `null` values are
+ * removed, dicts are merged recursively and all other values replace the
+ * existing values. If the document does not exist, it is created with the
+ * patch applied to empty properties.
+ *
+ * The document is loaded, patched and saved in a single transaction, without
+ * decoding its properties in Dart. Returns false and sets `errorOut` if the
+ * document could not be saved, which includes conflicts if
+ * `concurrencyControl` is `kCBLConcurrencyControlFailOnConflict`.
+ */
+CBLDART_EXPORT
+bool CBLDart_CBLCollection_PatchDocument(
+    CBLCollection *collection, FLString docID, FLSlice patch,
+    CBLConcurrencyControl concurrencyControl, CBLError *errorOut);
 
 CBLDART_EXPORT
 void CBLDart_CBLCollection_AddChangeListener(const CBLDatabase *db,
                                              const CBLCollection *collection,
                                              CBLDart_AsyncCallback listener);
 
+/**
+ * Gets the document with `docID` from `collection`, through the document
+ * cache.
+ *
+ * Has the same semantics as `CBLCollection_GetDocument`. If the document cache
+ * is disabled, the document is loaded from the database.
+ */
+CBLDART_EXPORT
+const CBLDocument *CBLDart_CBLCollection_GetDocument(
+    const CBLCollection *collection, FLString docID, CBLError *errorOut);
+
+/**
+ * Sets the maximum number of documents the document cache keeps for each
+ * collection and the maximum total size of those documents. A maximum count
+ * or size of `0` disables the cache.
+ */
+CBLDART_EXPORT
+void CBLDart_DocumentCache_SetLimits(size_t maxCount, size_t maxSize);
+
+typedef struct {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+  /**
+   * The number of cached documents which have been removed from the cache,
+   * because they changed.
+   */
+  uint64_t invalidations;
+  /** The number of cached documents. */
+  size_t count;
+  /** The approximate total size of the cached documents. */
+  size_t size;
+  size_t maxCount;
+  size_t maxSize;
+} CBLDart_DocumentCacheStats;
+
+CBLDART_EXPORT
+CBLDart_DocumentCacheStats CBLDart_DocumentCache_Stats(void);
+
+/**
+ * A cursor over the documents of a collection in the order of their
+ * sequences.
+ */
+typedef struct _CBLDart_ChangeCursor *CBLDart_ChangeCursor;
+
+/**
+ * Creates a cursor over the documents of `collection` whose sequence is
+ * larger than `sequence`, including deleted documents.
+ *
+ * Each document appears at most once, with its current revision. `sequence`
+ * is usually a checkpoint, which has been persisted by the consumer of the
+ * cursor.
+ */
+CBLDART_EXPORT
+CBLDart_ChangeCursor CBLDart_CBLCollection_NewChangeCursor(
+    const CBLCollection *collection, uint64_t sequence);
+
+/**
+ * Reads the next batch of at most `maxCount` documents from `cursor`.
+ *
+ * The batch is encoded as a Fleece array, in which each document is an array
+ * of its id, sequence, revision id, deleted flag and properties. The
+ * properties of deleted documents are missing. An empty array is returned
+ * when there are no more documents.
+ *
+ * If an error occurs, a null slice is returned.
+ */
+CBLDART_EXPORT
+FLSliceResult CBLDart_ChangeCursor_Next(CBLDart_ChangeCursor cursor,
+                                        uint32_t maxCount, CBLError *errorOut);
+
+CBLDART_EXPORT
+void CBLDart_ChangeCursor_Release(CBLDart_ChangeCursor cursor);
+
 typedef enum : uint8_t {
   kCBLDart_IndexTypeValue,
   kCBLDart_IndexTypeFullText,
+  kCBLDart_IndexTypeArray,
+  kCBLDart_IndexTypeVector,
 } CBLDart_IndexType;
 
+typedef enum : uint8_t {
+  kCBLDart_VectorEncodingTypeNone,
+  kCBLDart_VectorEncodingTypeScalarQuantizer,
+  kCBLDart_VectorEncodingTypeProductQuantizer,
+} CBLDart_VectorEncodingType;
+
+/**
+ * The specification of an index.
+ *
+ * `path` is only used by array indexes. The fields after it are only used by
+ * vector indexes, which are only supported by the enterprise edition.
+ * Training sizes and the number of probes of `0` select the defaults of
+ * Couchbase Lite.
+ */
 struct CBLDart_CBLIndexSpec {
   CBLDart_IndexType type;
   CBLQueryLanguage expressionLanguage;
   FLString expressions;
   bool ignoreAccents;
   FLString language;
+  FLString path;
+  uint32_t dimensions;
+  uint32_t centroids;
+  CBLDart_VectorEncodingType encodingType;
+  uint32_t scalarQuantizerType;
+  uint32_t subquantizers;
+  uint32_t bits;
+  uint32_t metric;
+  uint32_t minTrainingSize;
+  uint32_t maxTrainingSize;
+  uint32_t numProbes;
 };
 
 CBLDART_EXPORT
@@ -120,28 +583,656 @@ bool CBLDart_CBLCollection_CreateIndex(CBLCollection *collection, FLString name,
                                        CBLDart_CBLIndexSpec indexSpec,
                                        CBLError *errorOut);
 
+/**
+ * A build of an index, which runs on a background thread.
+ */
+struct CBLDart_IndexBuilder;
+
+/**
+ * Starts building the index specified by `indexSpec` with `name` for
+ * `collection` on a background thread.
+ *
+ * `callback` is called with `[false]` when the index starts to be built. When
+ * the build has finished, it is called with `[true, created]`, followed by the
+ * error domain, code and message, if the build failed. `created` is `false` if
+ * the build was cancelled. After that the callback is not called again.
+ *
+ * The builder stays valid until `callback` is closed. Closing the callback
+ * cancels the build, if it is still running.
+ */
+CBLDART_EXPORT
+CBLDart_IndexBuilder *CBLDart_CBLCollection_BuildIndex(
+    const CBLDatabase *db, CBLCollection *collection, FLString name,
+    CBLDart_CBLIndexSpec indexSpec, CBLDart_AsyncCallback callback);
+
+/**
+ * Cancels the build of `builder`.
+ *
+ * A build which has not started yet is skipped. Couchbase Lite cannot
+ * interrupt a build which is running, so it is completed and the index is
+ * deleted again, unless it replaced an existing index with the same name.
+ */
+CBLDART_EXPORT
+void CBLDart_IndexBuilder_Cancel(CBLDart_IndexBuilder *builder);
+
+/**
+ * An import of documents from JSON lines (also known as NDJSON) into a
+ * collection, which runs on a background thread.
+ */
+struct CBLDart_JSONLinesImporter;
+
+/**
+ * Starts importing documents from JSON lines into `collection`.
+ *
+ * Every non-empty line of the input must contain a JSON object, which becomes
+ * the properties of a new document. If `idKeyPath` is not null, the string at
+ * this key path in the object is used as the document ID. Otherwise, or if
+ * there is no string at the key path, a random ID is used.
+ *
+ * Documents are saved in transactions of `batchSize` documents.
+ *
+ * The input is provided with `CBLDart_JSONLinesImporter_AddChunk` and
+ * `CBLDart_JSONLinesImporter_AddFile`, and completed with
+ * `CBLDart_JSONLinesImporter_Finish`.
+ *
+ * `callback` is called with `[false, importedCount, consumedInputCount]` after
+ * every saved batch and consumed input. When the import has finished it is
+ * called with `[true, importedCount, consumedInputCount]`, followed by the
+ * error domain, code and message, if the import failed. After that the
+ * callback is not called again.
+ *
+ * The importer stays valid until `callback` is closed. Closing the callback
+ * cancels the import, if it is still running.
+ */
+CBLDART_EXPORT
+CBLDart_JSONLinesImporter *CBLDart_CBLCollection_ImportJSONLines(
+    const CBLDatabase *db, CBLCollection *collection, FLString idKeyPath,
+    uint32_t batchSize, CBLDart_AsyncCallback callback, CBLError *errorOut);
+
+/**
+ * Adds a chunk of JSON lines to the input of `importer`.
+ *
+ * Lines can span multiple chunks.
+ */
+CBLDART_EXPORT
+void CBLDart_JSONLinesImporter_AddChunk(CBLDart_JSONLinesImporter *importer,
+                                        FLSlice chunk);
+
+/**
+ * Adds the contents of the file at `path` to the input of `importer`.
+ */
+CBLDART_EXPORT
+void CBLDart_JSONLinesImporter_AddFile(CBLDart_JSONLinesImporter *importer,
+                                       FLString path);
+
+/**
+ * Signals that all input has been added to `importer`.
+ *
+ * If `cancel` is `true`, input which has not been imported yet is discarded
+ * and the current batch is not saved.
+ */
+CBLDART_EXPORT
+void CBLDart_JSONLinesImporter_Finish(CBLDart_JSONLinesImporter *importer,
+                                      bool cancel);
+
+/**
+ * Starts deleting the documents of `collection` which match `predicate` on a
+ * background thread.
+ *
+ * `predicate` is an expression of the JSON query language. The matching
+ * documents are deleted in transactions of at most `batchSize` documents, and
+ * the database level lock is only held while a batch is deleted. Documents
+ * are matched when their batch is deleted, in the order of their IDs.
+ *
+ * `callback` is called with `[false, affectedCount]` after every deleted
+ * batch. When all matching documents have been deleted, it is called with
+ * `[true, affectedCount]`, followed by the error domain, code and message, if
+ * the operation failed. After that the callback is not called again. Closing
+ * the callback cancels the operation after the current batch.
+ *
+ * Returns `false` and does not use `callback` if the query for the matching
+ * documents cannot be compiled.
+ */
+CBLDART_EXPORT
+bool CBLDart_CBLCollection_DeleteWhere(const CBLDatabase *db,
+                                       CBLCollection *collection,
+                                       FLString predicate, uint32_t batchSize,
+                                       CBLDart_AsyncCallback callback,
+                                       CBLError *errorOut);
+
+/**
+ * Starts purging the documents of `collection` which match `predicate` on a
+ * background thread.
+ *
+ * Works like `CBLDart_CBLCollection_DeleteWhere`, but purges the matching
+ * documents instead of deleting them.
+ */
+CBLDART_EXPORT
+bool CBLDart_CBLCollection_PurgeWhere(const CBLDatabase *db,
+                                      CBLCollection *collection,
+                                      FLString predicate, uint32_t batchSize,
+                                      CBLDart_AsyncCallback callback,
+                                      CBLError *errorOut);
+
+// === Document Operations
+
+/**
+ * A queue of document operations of a database, which are executed on
+ * background threads, so that they don't block the isolate which submits
+ * them.
+ *
+ * Operations are started in the order in which they are submitted, but can
+ * complete in any order.
+ */
+struct CBLDart_DocumentOperations;
+
+/**
+ * Creates a queue for document operations of `db`, whose results are sent to
+ * `callback`.
+ *
+ * When an operation has finished, `callback` is called with
+ * `[operationId, result]`, followed by the error domain, code and message, if
+ * the operation failed. The result depends on the operation:
+ *
+ * - Getting a document: The address of the document, or null if it does not
+ *   exist. The call is blocking and the document is released after it
+ *   returns, so the callback has to retain the document.
+ * - Saving or deleting a document: `false` if the operation failed because of
+ *   a conflict, `true` otherwise.
+ * - Purging a document: `true`.
+ *
+ * The queue stays valid until `callback` is closed. Operations which have not
+ * started when the callback is closed are skipped.
+ */
+CBLDART_EXPORT
+CBLDart_DocumentOperations *CBLDart_DocumentOperations_New(
+    const CBLDatabase *db, CBLDart_AsyncCallback callback);
+
+CBLDART_EXPORT
+void CBLDart_DocumentOperations_GetDocument(
+    CBLDart_DocumentOperations *operations, const CBLCollection *collection,
+    FLString docID, int64_t operationId);
+
+/**
+ * Saves `doc` to `collection`.
+ *
+ * `doc` must not be used until the operation has finished.
+ */
+CBLDART_EXPORT
+void CBLDart_DocumentOperations_SaveDocument(
+    CBLDart_DocumentOperations *operations, CBLCollection *collection,
+    CBLDocument *doc, CBLConcurrencyControl concurrencyControl,
+    int64_t operationId);
+
+CBLDART_EXPORT
+void CBLDart_DocumentOperations_DeleteDocument(
+    CBLDart_DocumentOperations *operations, CBLCollection *collection,
+    const CBLDocument *doc, CBLConcurrencyControl concurrencyControl,
+    int64_t operationId);
+
+CBLDART_EXPORT
+void CBLDart_DocumentOperations_PurgeDocument(
+    CBLDart_DocumentOperations *operations, CBLCollection *collection,
+    FLString docID, int64_t operationId);
+
 // === Query
 
+/**
+ * Adds a change listener to `query`, which is called without arguments when
+ * the results of the query change.
+ *
+ * The listener is called at most once every `minIntervalMs` milliseconds.
+ * Changes within that interval are coalesced into a single call at the end of
+ * the interval. Intermediate changes are dropped on the native side.
+ */
 CBLDART_EXPORT
 CBLListenerToken *CBLDart_CBLQuery_AddChangeListener(
-    const CBLDatabase *db, CBLQuery *query, CBLDart_AsyncCallback listener);
+    const CBLDatabase *db, CBLQuery *query, uint32_t minIntervalMs,
+    CBLDart_AsyncCallback listener);
+
+/**
+ * Pauses or resumes the calls of a change listener which has been added with
+ * `CBLDart_CBLQuery_AddChangeListener`.
+ *
+ * While a listener is paused, changes are not delivered to it. When it is
+ * resumed, a single call is made if the results changed in the meantime.
+ */
+CBLDART_EXPORT
+void CBLDart_CBLQuery_SetChangeListenerPaused(CBLDart_AsyncCallback listener,
+                                              bool paused);
+
+/**
+ * Adds a change listener to `query`, which is called with the difference
+ * between consecutive results of the query, instead of having to copy the
+ * current results.
+ *
+ * Rows are matched by the value of the column at `keyColumn` or, if
+ * `keyColumn` is `-1`, by their content.
+ *
+ * `listener` is called with the number of rows, the indexes of the removed,
+ * inserted, moved (from and to) and changed rows, as `Int32List`s, and a
+ * Fleece array of the inserted and changed rows, in the order of their
+ * indexes. If the results of the query could not be copied, `listener` is
+ * called with the domain, code and message of the error instead.
+ */
+CBLDART_EXPORT
+void CBLDart_CBLQuery_AddDiffListener(const CBLDatabase *db, CBLQuery *query,
+                                      int keyColumn,
+                                      CBLDart_AsyncCallback listener);
+
+/**
+ * Executes `query` on a background thread pool and sends its results to
+ * `callback` in batches of up to `batchSize` rows.
+ *
+ * `callback` is called with the address and size of a slice result which
+ * contains a Fleece array of the rows of a batch and whether it is the last
+ * batch. The slice result is only kept alive until the call returns, so
+ * `callback` must retain it to use it afterwards. The next batch is encoded
+ * once the call for the previous batch has returned, so that the Dart side
+ * can apply back pressure by delaying its return. If the query could not be
+ * executed, `callback` is called with the domain, code and message of the
+ * error instead.
+ *
+ * Closing `callback` cancels the execution.
+ *
+ * Takes ownership of `query`, which must have been created with
+ * `CBLDart_QueryCache_CreateQuery` and not be used by anyone else, so that
+ * its parameters cannot change while it is executed. It is given back to the
+ * query cache when the execution is done.
+ */
+CBLDART_EXPORT
+void CBLDart_CBLQuery_ExecuteAsync(const CBLDatabase *db, CBLQuery *query,
+                                   uint32_t batchSize,
+                                   CBLDart_AsyncCallback callback);
+
+/**
+ * Creates a query like `CBLDatabase_CreateQuery`, but reuses a prepared query
+ * with the same language and query string from the query cache of `db`, if
+ * one is idle.
+ *
+ * The query must be released through `CBLDart_QueryCache_ReleaseQuery`, which
+ * gives it back to the cache, with its parameters reset.
+ */
+CBLDART_EXPORT
+CBLQuery *CBLDart_QueryCache_CreateQuery(const CBLDatabase *db,
+                                         CBLQueryLanguage language,
+                                         FLString queryString,
+                                         int *errorPosOut, CBLError *errorOut);
+
+CBLDART_EXPORT
+void CBLDart_QueryCache_ReleaseQuery(CBLQuery *query);
+
+/**
+ * Sets the maximum number of idle queries the query cache keeps for each
+ * database. A capacity of `0` disables the cache.
+ */
+CBLDART_EXPORT
+void CBLDart_QueryCache_SetCapacity(size_t capacity);
+
+typedef struct {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+  /** The number of idle queries in the cache. */
+  size_t size;
+  size_t capacity;
+} CBLDart_QueryCacheStats;
+
+CBLDART_EXPORT
+CBLDart_QueryCacheStats CBLDart_QueryCache_Stats(void);
+
+/**
+ * Writes the remaining rows of `resultSet` as a JSON array of objects, which
+ * map column names to values, into `buffer`.
+ *
+ * Rows are written until the size of `buffer` reaches `chunkSize` or the
+ * result set has been consumed, in which case `isDoneOut` is set to `true`.
+ * Calling this function repeatedly, with `isFirstChunk` set to `true` for the
+ * first call only, writes the complete JSON array in chunks.
+ *
+ * Returns `false` and sets `errorOut` if a row could not be encoded.
+ */
+CBLDART_EXPORT
+bool CBLDart_CBLResultSet_WriteJSON(CBLResultSet *resultSet,
+                                    CBLDart_FLJSONBuffer *buffer,
+                                    size_t chunkSize, bool isFirstChunk,
+                                    bool *isDoneOut, CBLError *errorOut);
+
+/**
+ * Advances `resultSet` by up to `maxCount` rows and writes the arrays of the
+ * column values of the rows into `rowsOut`.
+ *
+ * The arrays are retained and must be released by the caller. The values in
+ * the arrays stay valid as long as the arrays are retained.
+ *
+ * Returns the number of rows which have been written, which is less than
+ * `maxCount` only if the result set has been consumed.
+ */
+CBLDART_EXPORT
+size_t CBLDart_CBLResultSet_NextBatch(CBLResultSet *resultSet, FLArray *rowsOut,
+                                      size_t maxCount);
+
+/**
+ * Like `CBLDart_CBLResultSet_NextBatch`, but also loads the document of each
+ * row from `collection`, through the document cache, and writes it into
+ * `documentsOut`.
+ *
+ * The id of the document of a row is the string value of the column at
+ * `idColumn`. If the value is not a string or the document does not exist,
+ * `nullptr` is written instead.
+ *
+ * The documents are retained and must be released by the caller. Returns
+ * `false` and sets `errorOut` if a document could not be loaded, in which
+ * case no rows or documents are written.
+ */
+CBLDART_EXPORT
+bool CBLDart_CBLResultSet_NextBatchWithDocuments(
+    CBLResultSet *resultSet, const CBLCollection *collection,
+    unsigned idColumn, FLArray *rowsOut, const CBLDocument **documentsOut,
+    size_t maxCount, size_t *countOut, CBLError *errorOut);
+
+typedef enum : uint8_t {
+  kCBLDart_ColumnTypeInt64,
+  kCBLDart_ColumnTypeFloat64,
+  kCBLDart_ColumnTypeString,
+} CBLDart_ColumnType;
+
+/**
+ * A column of a result set, which is extracted into contiguous memory by
+ * `CBLDart_CBLResultSet_ExtractColumns`.
+ *
+ * `index` and `type` are inputs, the other fields are outputs.
+ */
+typedef struct {
+  /** The index of the column in the rows of the result set. */
+  unsigned index;
+  CBLDart_ColumnType type;
+
+  /**
+   * The values of the column, as `int64_t` or `double`, one for each row, or
+   * the UTF-8 encoded strings of the column, one after the other.
+   */
+  FLSliceResult values;
+
+  /**
+   * For string columns only, `rowCount + 1` `uint32_t` offsets into `values`.
+   * The string of row `i` spans from offset `i` to offset `i + 1`.
+   */
+  FLSliceResult offsets;
+
+  /**
+   * A bitmap with one bit for each row, which is set if the value of the row
+   * is not null. The bit of row `i` is bit `i % 8` of byte `i / 8`.
+   */
+  FLSliceResult validity;
+} CBLDart_Column;
+
+/**
+ * Consumes the remaining rows of `resultSet` and extracts the values of
+ * `columns` into contiguous memory, in a single pass over the rows.
+ *
+ * The `fetchedRowCount` rows in `fetchedRows` are extracted before the rows
+ * of the result set. These are rows which have already been fetched from the
+ * result set, for example through `CBLDart_CBLResultSet_NextBatch`.
+ *
+ * A value is null if it is missing, `null` or not of the type of its column.
+ * Booleans are extracted as numbers. Numbers are converted to the type of
+ * their column, truncating floating point numbers when extracting integers.
+ *
+ * The data in the output slices of `columns` starts at the first address of
+ * the slice which is aligned to the size of an element. The slices must be
+ * released by the caller, as must be the fetched rows.
+ */
+CBLDART_EXPORT
+void CBLDart_CBLResultSet_ExtractColumns(CBLResultSet *resultSet,
+                                         const FLArray *fetchedRows,
+                                         size_t fetchedRowCount,
+                                         CBLDart_Column *columns,
+                                         size_t columnCount,
+                                         uint64_t *rowCountOut);
+
+typedef struct {
+  /** The name of the full-text index to search. */
+  FLString indexName;
+  /** The full-text query, in the syntax of the `MATCH` function. */
+  FLString query;
+  /** The maximum number of results. */
+  uint32_t limit;
+  /** The number of best ranked results to skip. */
+  uint32_t offset;
+  /**
+   * The key path of the string property from which snippets are made, or a
+   * null slice to not make snippets.
+   */
+  FLString snippetProperty;
+  /** The maximum number of words in a snippet. */
+  uint32_t snippetWordCount;
+  /** The text which is inserted before each matched word in a snippet. */
+  FLString matchStart;
+  /** The text which is inserted after each matched word in a snippet. */
+  FLString matchEnd;
+  /** The text which marks text that has been left out of a snippet. */
+  FLString ellipsis;
+} CBLDart_FullTextSearchOptions;
+
+/**
+ * Searches the full-text index of `collection` and encodes a page of the
+ * matching documents, ordered by descending rank, as a Fleece array, which
+ * must be released by the caller.
+ *
+ * Each element of the array is an array of the id and rank of a document,
+ * followed by its snippet, if `snippetProperty` is set. The snippet is the
+ * window of at most `snippetWordCount` words of the property, which contains
+ * the most distinct terms of the query, with matched words marked. It is
+ * `null` if the property is not a string.
+ *
+ * The query is checked out of the query cache, so that searching repeatedly
+ * with different full-text queries reuses the same prepared query.
+ *
+ * If an error occurs, a null slice is returned.
+ */
+CBLDART_EXPORT
+FLSliceResult CBLDart_CBLCollection_FullTextSearch(
+    const CBLCollection *collection,
+    const CBLDart_FullTextSearchOptions *options, CBLError *errorOut);
 
 // === Blob
 
+/**
+ * Creates a blob with `contentType` from the content of the file at `path`
+ * and saves it into `db`, on a background thread.
+ *
+ * The content is copied natively, without being sent to Dart, and its digest
+ * is computed while it is copied.
+ *
+ * `callback` is called once, with the address of the new blob, which must be
+ * released by the receiver, or with the error domain, code and message, if the
+ * blob could not be created.
+ */
+CBLDART_EXPORT
+void CBLDart_CBLBlob_CreateFromFile(const CBLDatabase *db, FLString path,
+                                    FLString contentType,
+                                    CBLDart_AsyncCallback callback);
+
+/**
+ * Writes the content of `blob`, which belongs to `db`, to the file at `path`,
+ * on a background thread.
+ *
+ * An existing file at `path` is replaced.
+ *
+ * `callback` is called once, with `null`, or with the error domain, code and
+ * message, if the content could not be written.
+ */
+CBLDART_EXPORT
+void CBLDart_CBLBlob_WriteToFile(const CBLDatabase *db, const CBLBlob *blob,
+                                 FLString path,
+                                 CBLDart_AsyncCallback callback);
+
+/**
+ * Returns the content of the blob with `digest` in `db` from the blob cache,
+ * which must be released by the caller, or a null slice if it is not cached.
+ */
+CBLDART_EXPORT
+FLSliceResult CBLDart_BlobCache_Get(const CBLDatabase *db, FLString digest);
+
+/**
+ * Adds `content` as the content of the blob with `digest` in `db` to the blob
+ * cache, unless it is too large to be cached.
+ */
+CBLDART_EXPORT
+void CBLDart_BlobCache_Put(const CBLDatabase *db, FLString digest,
+                           FLSlice content);
+
+/**
+ * Sets the maximum size of the content the blob cache keeps for each database
+ * and the maximum size of the content of a single blob it caches. A maximum
+ * size of `0` disables the cache.
+ */
+CBLDART_EXPORT
+void CBLDart_BlobCache_SetLimits(size_t maxSize, size_t maxEntrySize);
+
+typedef struct {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+  /** The total size of the cached content. */
+  size_t size;
+  size_t maxSize;
+  size_t maxEntrySize;
+} CBLDart_BlobCacheStats;
+
+CBLDART_EXPORT
+CBLDart_BlobCacheStats CBLDart_BlobCache_Stats(void);
+
+/**
+ * Saves `blob`, which has been created from content in memory, into `db`.
+ *
+ * The digest of such a blob is known before its content is written. If `db`
+ * already contains a blob with the same digest, and therefore the same
+ * content, the content is not written again.
+ */
+CBLDART_EXPORT
+bool CBLDart_CBLDatabase_SaveBlob(CBLDatabase *db, CBLBlob *blob,
+                                  CBLError *errorOut);
+
+typedef struct {
+  /**
+   * The number of blobs saved through `CBLDart_CBLDatabase_SaveBlob`, whose
+   * content has been written.
+   */
+  uint64_t writes;
+  /**
+   * The number of blobs saved through `CBLDart_CBLDatabase_SaveBlob`, whose
+   * content has not been written, because it already existed.
+   */
+  uint64_t deduplications;
+  /** The total size of the content which has not been written again. */
+  uint64_t deduplicatedSize;
+} CBLDart_BlobDeduplicationStats;
+
+CBLDART_EXPORT
+CBLDart_BlobDeduplicationStats CBLDart_BlobDeduplication_Stats(void);
+
+/**
+ * Reads the content of a blob on a background thread, ahead of the consumer.
+ */
+struct CBLDart_BlobReadAhead;
+
+typedef enum : uint8_t {
+  /** A chunk has been taken. */
+  kCBLDart_BlobReadAheadChunk,
+  /** The next chunk has not been read yet. */
+  kCBLDart_BlobReadAheadPending,
+  /** All chunks have been taken. */
+  kCBLDart_BlobReadAheadDone,
+  /** Reading the content failed. */
+  kCBLDart_BlobReadAheadError,
+} CBLDart_BlobReadAheadResult;
+
+/**
+ * Starts reading the content of `blob`, which belongs to `db`, from the byte
+ * at `start` up to, but not including, the byte at `end`, or to the end of
+ * the content if `end` is negative, on a background thread.
+ *
+ * Up to `chunkCount` chunks of up to `chunkSize` bytes are read ahead of the
+ * consumer, which takes them with `CBLDart_BlobReadAhead_Next`.
+ *
+ * `callback` is called without arguments, once the next chunk has been read
+ * or reading has finished, after `CBLDart_BlobReadAhead_Next` has returned
+ * `kCBLDart_BlobReadAheadPending`.
+ *
+ * The read-ahead stays valid until `callback` is closed, which stops the
+ * background thread.
+ */
+CBLDART_EXPORT
+CBLDart_BlobReadAhead *CBLDart_CBLBlob_ReadAhead(
+    const CBLDatabase *db, const CBLBlob *blob, uint64_t start, int64_t end,
+    size_t chunkSize, size_t chunkCount, CBLDart_AsyncCallback callback);
+
+/**
+ * Takes the next chunk which has been read ahead by `readAhead`.
+ *
+ * If the result is `kCBLDart_BlobReadAheadChunk`, the chunk is stored in
+ * `chunkOut` and must be released by the caller. The content of the chunk is
+ * not copied.
+ */
 CBLDART_EXPORT
-FLSliceResult CBLDart_CBLBlobReader_Read(CBLBlobReadStream *stream,
-                                         uint64_t bufferSize,
-                                         CBLError *outError);
+CBLDart_BlobReadAheadResult CBLDart_BlobReadAhead_Next(
+    CBLDart_BlobReadAhead *readAhead, FLSliceResult *chunkOut,
+    CBLError *errorOut);
 
 // === Replicator
 
+/**
+ * Conflict resolution strategies which are executed natively, without calling
+ * into Dart.
+ *
+ * - `kCBLDart_ConflictResolutionCustom` uses the `conflictResolver` callback,
+ *   if it is set, or the default conflict resolver of CBL C.
+ * - `kCBLDart_ConflictResolutionRemoteWins` and
+ *   `kCBLDart_ConflictResolutionLocalWins` always resolve to the remote or
+ *   local revision, including deletions.
+ * - `kCBLDart_ConflictResolutionLastWriteWins` resolves to the revision with
+ *   the greater timestamp at `conflictResolutionTimestampKeyPath`. Numbers and
+ *   strings are compared by value, a revision with a timestamp wins against
+ *   one without and ties are resolved by revision ID.
+ * - `kCBLDart_ConflictResolutionMergeDicts` merges the top-level properties of
+ *   both revisions into a new revision. Properties which exist in both
+ *   revisions are taken from the local revision.
+ *
+ * Except for `RemoteWins` and `LocalWins`, a deletion on either side wins.
+ */
+typedef enum : uint8_t {
+  kCBLDart_ConflictResolutionCustom,
+  kCBLDart_ConflictResolutionRemoteWins,
+  kCBLDart_ConflictResolutionLocalWins,
+  kCBLDart_ConflictResolutionLastWriteWins,
+  kCBLDart_ConflictResolutionMergeDicts,
+} CBLDart_ConflictResolutionStrategy;
+
+/**
+ * The replication configuration of a collection.
+ *
+ * `pushFilterExpression` and `pullFilterExpression` are optional filters in
+ * the JSON syntax of query expressions, which are evaluated natively. If a
+ * collection has both a filter expression and a filter callback, a document
+ * is only replicated if both accept it, and the callback is only called for
+ * documents which pass the expression.
+ *
+ * If `conflictResolutionStrategy` is not `kCBLDart_ConflictResolutionCustom`,
+ * conflicts are resolved natively and `conflictResolver` is ignored.
+ */
 struct CBLDart_ReplicationCollection {
   CBLCollection *collection;
   FLArray channels;
   FLArray documentIDs;
   CBLDart_AsyncCallback pushFilter;
   CBLDart_AsyncCallback pullFilter;
+  FLString pushFilterExpression;
+  FLString pullFilterExpression;
   CBLDart_AsyncCallback conflictResolver;
+  CBLDart_ConflictResolutionStrategy conflictResolutionStrategy;
+  FLString conflictResolutionTimestampKeyPath;
 };
 
 struct CBLDart_ReplicatorConfiguration {
@@ -160,6 +1251,23 @@ struct CBLDart_ReplicatorConfiguration {
   FLSlice *trustedRootCertificates;
   CBLDart_ReplicationCollection *collections;
   size_t collectionsCount;
+  /**
+   * The maximum time in milliseconds for which the replicator waits for a
+   * Dart filter or conflict resolver, or `0` to wait indefinitely.
+   *
+   * Filters which miss the deadline reject or accept the document, according
+   * to `callbackTimeoutFilterResult`, and conflict resolvers which miss it
+   * resolve to the local revision. The Dart side still handles these calls,
+   * but their results are ignored.
+   */
+  uint32_t callbackTimeoutMs;
+  bool callbackTimeoutFilterResult;
+  /**
+   * The time in milliseconds after which a call of a Dart filter or conflict
+   * resolver is counted in `CBLDart_ReplicatorMetrics.callbacksOverBudget`,
+   * or `0` to not count calls.
+   */
+  uint32_t callbackLatencyBudgetMs;
 };
 
 CBLDART_EXPORT
@@ -169,12 +1277,133 @@ CBLReplicator *CBLDart_CBLReplicator_Create(
 CBLDART_EXPORT
 void CBLDart_CBLReplicator_Release(CBLReplicator *replicator);
 
+/**
+ * Adds a listener for status changes of `replicator`.
+ *
+ * If `minIntervalMs` is not `0`, changes which only update the progress are
+ * coalesced and delivered at most once per `minIntervalMs`, with the latest
+ * status. Changes of the activity level and errors are always delivered
+ * immediately.
+ */
 CBLDART_EXPORT
 void CBLDart_CBLReplicator_AddChangeListener(const CBLDatabase *db,
                                              CBLReplicator *replicator,
+                                             uint32_t minIntervalMs,
                                              CBLDart_AsyncCallback listenerId);
 
+/**
+ * Adds a listener for replicated documents, which receives each batch of
+ * documents packed into a string buffer and an integer buffer.
+ *
+ * If `errorsOnly` is true, only documents whose replication failed are sent
+ * to the listener.
+ */
 CBLDART_EXPORT
 void CBLDart_CBLReplicator_AddDocumentReplicationListener(
-    const CBLDatabase *db, CBLReplicator *replicator,
+    const CBLDatabase *db, CBLReplicator *replicator, bool errorsOnly,
     CBLDart_AsyncCallback listenerId);
+
+/**
+ * Metrics of a replicator, which are collected natively, since it has been
+ * created.
+ *
+ * The histograms measure the push and pull filters, including filter
+ * expressions, and the conflict resolvers, including native strategies.
+ */
+typedef struct {
+  uint64_t documentsPushed;
+  uint64_t documentsPulled;
+  /** The number of documents whose replication failed. */
+  uint64_t documentErrors;
+  CBLDart_LatencyHistogram pushFilter;
+  CBLDart_LatencyHistogram pullFilter;
+  CBLDart_LatencyHistogram conflictResolver;
+  /**
+   * The number of calls of Dart filters and conflict resolvers which took
+   * longer than the latency budget of the replicator.
+   */
+  uint64_t callbacksOverBudget;
+  /**
+   * The number of calls of Dart filters and conflict resolvers which missed
+   * the deadline of the replicator and were answered with the fallback
+   * result.
+   */
+  uint64_t callbacksTimedOut;
+} CBLDart_ReplicatorMetrics;
+
+/**
+ * Sets the maximum number of replicators which the replicator scheduler keeps
+ * active at the same time. A `maxActive` of `0`, the default, means that
+ * there is no limit.
+ */
+CBLDART_EXPORT
+void CBLDart_ReplicatorScheduler_SetMaxActive(uint32_t maxActive);
+
+typedef struct {
+  uint32_t maxActive;
+  /** The number of scheduled replicators which occupy a slot. */
+  size_t active;
+  /** The number of scheduled replicators which wait for a slot. */
+  size_t waiting;
+} CBLDart_ReplicatorSchedulerStats;
+
+CBLDART_EXPORT
+CBLDart_ReplicatorSchedulerStats CBLDart_ReplicatorScheduler_Stats(void);
+
+/**
+ * Schedules `replicator` to be started, once the replicator scheduler has a
+ * free slot for it.
+ *
+ * Replicators with a higher `priority` are started first. Continuous
+ * replicators which have become idle give up their slot to waiting
+ * replicators with at least the same priority, by being suspended until it is
+ * their turn again. Scheduling a replicator which has already been scheduled
+ * updates its priority.
+ */
+CBLDART_EXPORT
+void CBLDart_CBLReplicator_Schedule(const CBLDatabase *db,
+                                    CBLReplicator *replicator,
+                                    bool resetCheckpoint, int32_t priority);
+
+/**
+ * Removes `replicator` from the replicator scheduler, without stopping it.
+ *
+ * Returns whether the replicator has been started by the scheduler.
+ */
+CBLDART_EXPORT
+bool CBLDart_CBLReplicator_Unschedule(CBLReplicator *replicator);
+
+/**
+ * Checks for each of the `count` documents in `docIDs`, in `collection`,
+ * whether it has revisions pending to be pushed.
+ *
+ * Bit `i % 8` of byte `i / 8` of `bitsetOut` is set if document `i` is
+ * pending. `bitsetOut` must have space for `(count + 7) / 8` bytes. Larger
+ * batches are checked against the pending document IDs, which are read once,
+ * instead of checking each document separately.
+ */
+CBLDART_EXPORT
+bool CBLDart_CBLReplicator_AreDocumentsPending(CBLReplicator *replicator,
+                                               const CBLCollection *collection,
+                                               const FLString *docIDs,
+                                               size_t count, uint8_t *bitsetOut,
+                                               CBLError *errorOut);
+
+/**
+ * Returns the number of documents in `collection` which have revisions pending
+ * to be pushed, or `-1` if an error occurred.
+ */
+CBLDART_EXPORT
+int64_t CBLDart_CBLReplicator_PendingDocumentCount(
+    CBLReplicator *replicator, const CBLCollection *collection,
+    CBLError *errorOut);
+
+/**
+ * Reads the metrics of `replicator` into `metricsOut`.
+ *
+ * Returns false if `replicator` was not created by
+ * `CBLDart_CBLReplicator_Create`.
+ */
+CBLDART_EXPORT
+bool CBLDart_CBLReplicator_Metrics(CBLReplicator *replicator,
+                                   CBLDart_ReplicatorMetrics *metricsOut);
@@ -32,6 +32,7 @@ struct CBLDart_LoadedDictKey {
   bool isKnownSharedKey;  // Whether the key has been seen before. For shared
                           // keys, stringBuf and stringSize are only set the
                           // first time the key is seen.
+  bool isAscii;  // Whether the key string contains only ASCII characters.
   int sharedKey;  // The id of the shared key or -1 if the key is not shared.
   const void *stringBuf;  // The pointer to the start of the key string.
   size_t stringSize;      // The length of the key string.
@@ -42,6 +43,7 @@ struct CBLDart_LoadedFLValue {
   bool exists;
   int8_t type;
   bool isInteger;
+  bool isAscii;  // Whether a string contains only ASCII characters.
   uint32_t collectionSize;
   bool asBool;
   int64_t asInt;
@@ -65,6 +67,14 @@ void CBLDart_FLDict_GetLoadedFLValue(FLDict dict, FLString key,
 
 struct CBLDart_FLDictIterator;
 
+/**
+ * Begins iterating over `dict`.
+ *
+ * Iterators are reused through a thread local pool. When `deleteOnDone` is
+ * `true`, the iterator is returned to the pool once it is done and must not
+ * be used afterwards. Otherwise it has to be returned with
+ * `CBLDart_FLDictIterator_Delete`.
+ */
 CBLDART_EXPORT
 CBLDart_FLDictIterator *CBLDart_FLDictIterator_Begin(
     FLDict dict, KnownSharedKeys *knownSharedKeys,
@@ -77,8 +87,30 @@ void CBLDart_FLDictIterator_Delete(CBLDart_FLDictIterator *iterator);
 CBLDART_EXPORT
 bool CBLDart_FLDictIterator_Next(CBLDart_FLDictIterator *iterator);
 
+/**
+ * Loads up to `capacity` of the next entries of `iterator` into the parallel
+ * arrays `keysOut` and `valuesOut`, either of which can be `NULL`.
+ *
+ * Shared keys are reported through `knownSharedKeys` in the same way as by
+ * `CBLDart_FLDictIterator_Next`, so the string of a shared key is only loaded
+ * the first time it is seen.
+ *
+ * Returns the number of loaded entries, which is `0` when the iterator is
+ * done.
+ */
+CBLDART_EXPORT
+uint32_t CBLDart_FLDictIterator_NextBatch(CBLDart_FLDictIterator *iterator,
+                                          CBLDart_LoadedDictKey *keysOut,
+                                          CBLDart_LoadedFLValue *valuesOut,
+                                          uint32_t capacity);
+
 struct CBLDart_FLArrayIterator;
 
+/**
+ * Begins iterating over `array`.
+ *
+ * Iterators are pooled in the same way as by `CBLDart_FLDictIterator_Begin`.
+ */
 CBLDART_EXPORT
 CBLDart_FLArrayIterator *CBLDart_FLArrayIterator_Begin(
     FLArray array, CBLDart_LoadedFLValue *valueOut, bool deleteOnDone);
@@ -89,8 +121,223 @@ void CBLDart_FLArrayIterator_Delete(CBLDart_FLArrayIterator *iterator);
 CBLDART_EXPORT
 bool CBLDart_FLArrayIterator_Next(CBLDart_FLArrayIterator *iterator);
 
+/**
+ * Loads up to `capacity` of the next values of `iterator` into `valuesOut`.
+ *
+ * Returns the number of loaded values, which is `0` when the iterator is done.
+ */
+CBLDART_EXPORT
+uint32_t CBLDart_FLArrayIterator_NextBatch(CBLDart_FLArrayIterator *iterator,
+                                           CBLDart_LoadedFLValue *valuesOut,
+                                           uint32_t capacity);
+
+// === Tape ===================================================================
+
+/**
+ * The type of tape entries which hold the key of a dict entry.
+ *
+ * All other tape entries use the `FLValueType` of the value they hold.
+ */
+#define kCBLDart_FLTapeEntryTypeDictKey 16
+
+/**
+ * A single entry of a tape, which holds a Fleece value in flattened form.
+ *
+ * The meaning of the fields depends on the type of the entry:
+ *
+ * - Booleans: `flag` is the value.
+ * - Numbers: `flag` is whether the number is an integer, in which case it is
+ *   stored in `asInt`, otherwise in `asDouble`.
+ * - Strings and data: `buf` and `size` point to the bytes in the Fleece data.
+ *   For strings, `isAscii` is whether the string contains only ASCII
+ *   characters and `sharedKey` is the id of the string in the string
+ *   interner or -1 if the string has not been interned.
+ * - Arrays and dicts: `size` is the number of elements or entries which
+ *   follow. Dict entries are stored as a key entry followed by the value.
+ * - Dict keys: `sharedKey` is the id of the shared key or -1 if the key is
+ *   not shared. For shared keys, `flag` is whether the key has been seen
+ *   before, in which case `buf`, `size` and `isAscii` are not set.
+ */
+struct CBLDart_FLTapeEntry {
+  int8_t type;
+  bool flag;
+  bool isAscii;
+  int32_t sharedKey;
+  uint32_t size;
+  union {
+    int64_t asInt;
+    double asDouble;
+    const void *buf;
+  };
+};
+
+/**
+ * A table which assigns small integer ids to strings, so that strings which
+ * are repeated across multiple tapes only have to be decoded once.
+ *
+ * Strings are identified by their content, not by their location in Fleece
+ * data, which makes the interner safe to use with Fleece data that is not
+ * immutable, such as the data of query results.
+ *
+ * Only short strings are interned and the number of interned strings is
+ * limited, since long strings are unlikely to be repeated.
+ */
+struct CBLDart_FLStringInterner;
+
+CBLDART_EXPORT
+CBLDart_FLStringInterner *CBLDart_FLStringInterner_New();
+
+CBLDART_EXPORT
+void CBLDart_FLStringInterner_Delete(CBLDart_FLStringInterner *interner);
+
+/**
+ * A growable buffer of tape entries.
+ *
+ * The entries are valid until the tape is written to again or deleted.
+ */
+struct CBLDart_FLTape {
+  CBLDart_FLTapeEntry *entries;
+  size_t count;
+  size_t capacity;
+};
+
+CBLDART_EXPORT
+CBLDart_FLTape *CBLDart_FLTape_New();
+
+CBLDART_EXPORT
+void CBLDart_FLTape_Delete(CBLDart_FLTape *tape);
+
+/**
+ * Flattens the given value and all its children into `tape`, in pre-order.
+ *
+ * Previous entries of `tape` are overwritten.
+ *
+ * If `interner` is not `NULL`, string values are interned in it.
+ *
+ * Returns `false` and sets `errorOut` to `kFLMemoryError`, if the entries
+ * could not be allocated. The tape then contains the entries which have been
+ * written so far, so that their shared keys can be registered.
+ */
+CBLDART_EXPORT
+bool CBLDart_FLTape_WriteValue(CBLDart_FLTape *tape, FLValue value,
+                               KnownSharedKeys *knownSharedKeys,
+                               CBLDart_FLStringInterner *interner,
+                               FLError *errorOut);
+
+// === DictProjection =========================================================
+
+/**
+ * A precompiled list of key paths, which can be evaluated against a dict to
+ * load the values at all key paths in a single call.
+ */
+struct CBLDart_FLDictProjection;
+
+/**
+ * Creates a projection from the `count` key paths in `keyPaths`.
+ *
+ * Returns `NULL` and sets `errorOut` if one of the key paths is invalid.
+ */
+CBLDART_EXPORT
+CBLDart_FLDictProjection *CBLDart_FLDictProjection_New(const FLString *keyPaths,
+                                                       uint32_t count,
+                                                       FLError *errorOut);
+
+CBLDART_EXPORT
+void CBLDart_FLDictProjection_Delete(CBLDart_FLDictProjection *projection);
+
+/**
+ * Loads the values at the key paths of `projection` in `dict` into
+ * `valuesOut`, which must have room for one value per key path.
+ *
+ * Values which do not exist are loaded with `exists` set to `false`.
+ */
+CBLDART_EXPORT
+void CBLDart_FLDictProjection_Eval(CBLDart_FLDictProjection *projection,
+                                   FLDict dict,
+                                   CBLDart_LoadedFLValue *valuesOut);
+
 // === Encoder ================================================================
 
+/**
+ * The operations which can be recorded in an encoder tape.
+ *
+ * Each operation is encoded as a single byte, followed by its operands.
+ * Operands are encoded in native byte order and are not aligned. Operands
+ * which are described as bytes are encoded as a `uint32_t` size, followed by
+ * that number of bytes.
+ */
+typedef enum : uint8_t {
+  CBLDart_FLEncoderTapeOp_WriteNull,
+  CBLDart_FLEncoderTapeOp_WriteFalse,
+  CBLDart_FLEncoderTapeOp_WriteTrue,
+  /** Operand: `int64_t` value. */
+  CBLDart_FLEncoderTapeOp_WriteInt,
+  /** Operand: `double` value. */
+  CBLDart_FLEncoderTapeOp_WriteDouble,
+  /** Operand: the UTF-8 bytes of the string. */
+  CBLDart_FLEncoderTapeOp_WriteString,
+  /** Operand: the bytes of the data. */
+  CBLDart_FLEncoderTapeOp_WriteData,
+  /** Operand: `FLValue` value. */
+  CBLDart_FLEncoderTapeOp_WriteValue,
+  /** Operands: `FLArray` array, `uint32_t` index. */
+  CBLDart_FLEncoderTapeOp_WriteArrayValue,
+  /** Operand: `uint32_t` reserve count. */
+  CBLDart_FLEncoderTapeOp_BeginArray,
+  CBLDart_FLEncoderTapeOp_EndArray,
+  /** Operand: `uint32_t` reserve count. */
+  CBLDart_FLEncoderTapeOp_BeginDict,
+  /** Operand: the UTF-8 bytes of the key. */
+  CBLDart_FLEncoderTapeOp_WriteKey,
+  /** Operand: `FLValue` key. */
+  CBLDart_FLEncoderTapeOp_WriteKeyValue,
+  CBLDart_FLEncoderTapeOp_EndDict,
+  /**
+   * Operands: `uint32_t` count, followed by that number of UTF-16 code units
+   * of the string, which are transcoded to UTF-8 when the tape is replayed.
+   */
+  CBLDart_FLEncoderTapeOp_WriteUTF16String,
+} CBLDart_FLEncoderTapeOp;
+
+/**
+ * Replays the operations recorded in `tape` into `encoder`.
+ *
+ * This allows a sequence of writes to be performed with a single call.
+ * Values which are referenced by the tape must stay valid until this function
+ * returns.
+ *
+ * Returns `false` if an operation failed, after which the remaining operations
+ * are not replayed. The error can be retrieved with `FLEncoder_GetError`.
+ */
+CBLDART_EXPORT
+bool CBLDart_FLEncoder_WriteTape(FLEncoder encoder, const uint8_t *tape,
+                                 size_t size);
+
+// === JSONBuffer =============================================================
+
+/**
+ * A growable buffer into which Fleece values are written as JSON.
+ *
+ * The buffer is meant to be reused for writing multiple chunks of JSON. `buf`
+ * and `size` are valid until the buffer is written to again, cleared or
+ * deleted.
+ */
+struct CBLDart_FLJSONBuffer {
+  uint8_t *buf;
+  size_t size;
+  size_t capacity;
+  // The JSON encoder which is reused for writing values into the buffer.
+  FLEncoder encoder;
+};
+
+CBLDART_EXPORT
+CBLDart_FLJSONBuffer *CBLDart_FLJSONBuffer_New();
+
+CBLDART_EXPORT
+void CBLDart_FLJSONBuffer_Delete(CBLDart_FLJSONBuffer *buffer);
+
+/**
+ * Removes all bytes from `buffer`, without releasing its memory.
+ */
 CBLDART_EXPORT
-bool CBLDart_FLEncoder_WriteArrayValue(FLEncoder encoder, FLArray array,
-                                       uint32_t index);
+void CBLDart_FLJSONBuffer_Clear(CBLDart_FLJSONBuffer *buffer);
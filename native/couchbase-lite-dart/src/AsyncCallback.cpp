@@ -1,49 +1,172 @@
 #include "AsyncCallback.h"
 
+#include <chrono>
+#include <cstring>
 #include <sstream>
 
+#include "Stats.h"
+#include "Timeline.h"
 #include "Utils.h"
 
 namespace CBLDart {
 
+// === CObjectCopy =============================================================
+
+static size_t CBLDart_TypedDataElementSize(Dart_TypedData_Type type) {
+  switch (type) {
+    case Dart_TypedData_kByteData:
+    case Dart_TypedData_kInt8:
+    case Dart_TypedData_kUint8:
+    case Dart_TypedData_kUint8Clamped:
+      return 1;
+    case Dart_TypedData_kInt16:
+    case Dart_TypedData_kUint16:
+      return 2;
+    case Dart_TypedData_kInt32:
+    case Dart_TypedData_kUint32:
+    case Dart_TypedData_kFloat32:
+      return 4;
+    case Dart_TypedData_kInt64:
+    case Dart_TypedData_kUint64:
+    case Dart_TypedData_kFloat64:
+      return 8;
+    default:
+      assert(false);
+      return 0;
+  }
+}
+
+CObjectCopy::CObjectCopy(const Dart_CObject &object) {
+  object_ = copy(object);
+}
+
+Dart_CObject *CObjectCopy::copy(const Dart_CObject &object) {
+  auto &result = objects_.emplace_back(object);
+
+  switch (object.type) {
+    case Dart_CObject_kNull:
+    case Dart_CObject_kBool:
+    case Dart_CObject_kInt32:
+    case Dart_CObject_kInt64:
+    case Dart_CObject_kDouble:
+      break;
+    case Dart_CObject_kString: {
+      auto string = object.value.as_string;
+      auto &buffer =
+          buffers_.emplace_back(string, string + std::strlen(string) + 1);
+      result.value.as_string = reinterpret_cast<char *>(buffer.data());
+      break;
+    }
+    case Dart_CObject_kTypedData: {
+      auto &typedData = object.value.as_typed_data;
+      auto values = typedData.values;
+      auto size = typedData.length *
+                  CBLDart_TypedDataElementSize(typedData.type);
+      auto &buffer = buffers_.emplace_back(values, values + size);
+      result.value.as_typed_data.values = buffer.data();
+      break;
+    }
+    case Dart_CObject_kArray: {
+      auto &array = object.value.as_array;
+      auto &values = arrays_.emplace_back();
+      values.reserve(array.length);
+      for (intptr_t i = 0; i < array.length; i++) {
+        values.push_back(copy(*array.values[i]));
+      }
+      result.value.as_array.values = values.data();
+      break;
+    }
+    default:
+      // Other types of objects are not sent by callbacks.
+      assert(false);
+      break;
+  }
+
+  return &result;
+}
+
 // === AsyncCallbackRegistry ==================================================
 
 AsyncCallbackRegistry AsyncCallbackRegistry::instance;
 
 void AsyncCallbackRegistry::registerCallback(const AsyncCallback &callback) {
-  std::scoped_lock lock(mutex_);
-  callbacks_.push_back(&callback);
+  callbacks_.insert(&callback);
 }
 
 void AsyncCallbackRegistry::unregisterCallback(const AsyncCallback &callback) {
-  std::scoped_lock lock(mutex_);
-  callbacks_.erase(std::remove(callbacks_.begin(), callbacks_.end(), &callback),
-                   callbacks_.end());
+  callbacks_.erase(&callback);
 }
 
 bool AsyncCallbackRegistry::callbackExists(
     const AsyncCallback &callback) const {
-  std::scoped_lock lock(mutex_);
-  return std::find(callbacks_.begin(), callbacks_.end(), &callback) !=
-         callbacks_.end();
+  return callbacks_.contains(&callback);
 }
 
 void AsyncCallbackRegistry::addBlockingCall(AsyncCallbackCall &call) {
   assert(call.isBlocking());
-  std::scoped_lock lock(mutex_);
-  blockingCalls_.push_back(&call);
+  blockingCalls_.insert(call.id_, &call);
 }
 
 bool AsyncCallbackRegistry::takeBlockingCall(AsyncCallbackCall &call) {
-  std::scoped_lock lock(mutex_);
-  auto position =
-      std::find(blockingCalls_.begin(), blockingCalls_.end(), &call);
-  if (position != blockingCalls_.end()) {
-    blockingCalls_.erase(position);
-    return true;
-  } else {
+  return blockingCalls_.erase(call.id_);
+}
+
+AsyncCallbackCall *AsyncCallbackRegistry::takeBlockingCall(uint64_t callId) {
+  return blockingCalls_.take(callId);
+}
+
+bool AsyncCallbackRegistry::abandonBlockingCall(
+    AsyncCallbackCall &call, AbandonedCallHandler abandonedHandler) {
+  // The call is moved while holding the lock of the abandoned calls, so that
+  // a response which does not find the blocking call finds the abandoned
+  // call.
+  std::scoped_lock lock(abandonedCallsMutex_);
+  if (!blockingCalls_.erase(call.id_)) {
     return false;
   }
+  abandonedCalls_.emplace(
+      call.id_, AbandonedCall{&call.callback_, std::move(abandonedHandler)});
+  return true;
+}
+
+void AsyncCallbackRegistry::completeAbandonedCall(uint64_t callId,
+                                                  Dart_CObject *result) {
+  AbandonedCallHandler handler;
+  {
+    std::scoped_lock lock(abandonedCallsMutex_);
+    auto position = abandonedCalls_.find(callId);
+    if (position == abandonedCalls_.end()) {
+      return;
+    }
+    handler = std::move(position->second.handler);
+    abandonedCalls_.erase(position);
+  }
+
+  if (handler) {
+    handler(result);
+  }
+}
+
+void AsyncCallbackRegistry::closeAbandonedCalls(
+    const AsyncCallback &callback) {
+  std::vector<AbandonedCallHandler> handlers;
+  {
+    std::scoped_lock lock(abandonedCallsMutex_);
+    for (auto it = abandonedCalls_.begin(); it != abandonedCalls_.end();) {
+      if (it->second.callback == &callback) {
+        handlers.push_back(std::move(it->second.handler));
+        it = abandonedCalls_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  for (auto &handler : handlers) {
+    if (handler) {
+      handler(nullptr);
+    }
+  }
 }
 
 AsyncCallbackRegistry::AsyncCallbackRegistry() {}
@@ -98,17 +221,43 @@ void AsyncCallback::close() {
   std::unique_lock lock(mutex_);
   cv_.wait(lock, [this] { return activeCalls_.empty(); });
 
+  if (responsePort_ != ILLEGAL_PORT) {
+    auto didCloseResponsePort = Dart_CloseNativePort_DL(responsePort_);
+    assert(didCloseResponsePort);
+    responsePort_ = ILLEGAL_PORT;
+  }
+
+  // The responses to abandoned calls are not received after the response
+  // port has been closed.
+  AsyncCallbackRegistry::instance.closeAbandonedCalls(*this);
+
   AsyncCallbackRegistry::instance.unregisterCallback(*this);
 
   debugLog("closed");
 }
 
-void AsyncCallback::registerCall(AsyncCallbackCall &call) {
+bool AsyncCallback::tryRegisterCall(AsyncCallbackCall &call,
+                                    bool isBlocking) {
   assert(AsyncCallbackRegistry::instance.callbackExists(*this));
 
   std::scoped_lock lock(mutex_);
-  assert(!closed_);
+  if (closed_) {
+    return false;
+  }
   activeCalls_.push_back(&call);
+
+  if (isBlocking) {
+    // The response port is shared by all blocking calls, so that only the
+    // first one has to create a port.
+    if (responsePort_ == ILLEGAL_PORT) {
+      responsePort_ = Dart_NewNativePort_DL(
+          "AsyncCallback", &AsyncCallbackCall::messageHandler, false);
+      assert(responsePort_ != ILLEGAL_PORT);
+    }
+    call.responsePort_ = responsePort_;
+  }
+
+  return true;
 }
 
 void AsyncCallback::unregisterCall(AsyncCallbackCall &call) {
@@ -123,6 +272,79 @@ void AsyncCallback::unregisterCall(AsyncCallbackCall &call) {
   }
 }
 
+void AsyncCallback::enableBatching(uint32_t maxBatchSize) {
+  assert(maxBatchSize > 0);
+  maxBatchSize_ = maxBatchSize;
+}
+
+void AsyncCallback::batchDelivered() {
+  std::unique_lock lock(batchMutex_);
+  assert(batchInFlight_);
+  sendBatch(lock);
+}
+
+bool AsyncCallback::enqueueBatchedCall(const Dart_CObject &arguments) {
+  if (maxBatchSize_ == 0) {
+    return false;
+  }
+
+  // Copying the arguments is done without holding the lock.
+  auto call = std::make_unique<CObjectCopy>(arguments);
+
+  std::unique_lock lock(batchMutex_);
+  batchedCalls_.push_back(std::move(call));
+  if (!batchInFlight_) {
+    sendBatch(lock);
+  }
+  return true;
+}
+
+void AsyncCallback::sendBatch(std::unique_lock<std::mutex> &lock) {
+  if (batchedCalls_.empty()) {
+    batchInFlight_ = false;
+    return;
+  }
+
+  // Only one batch is in flight at a time, which keeps the calls in order,
+  // even though the batch is sent without holding the lock.
+  batchInFlight_ = true;
+
+  auto batchSize = std::min<size_t>(batchedCalls_.size(), maxBatchSize_);
+  std::vector<std::unique_ptr<CObjectCopy>> batch;
+  batch.reserve(batchSize);
+  for (size_t i = 0; i < batchSize; i++) {
+    batch.push_back(std::move(batchedCalls_.front()));
+    batchedCalls_.pop_front();
+  }
+  lock.unlock();
+
+  std::vector<Dart_CObject *> batchValues;
+  batchValues.reserve(batchSize);
+  for (auto &call : batch) {
+    batchValues.push_back(call->object());
+  }
+
+  Dart_CObject calls{};
+  calls.type = Dart_CObject_kArray;
+  calls.value.as_array.length = batchSize;
+  calls.value.as_array.values = batchValues.data();
+
+  // A batch is sent as an array, which only contains the list of the
+  // arguments of the batched calls.
+  Dart_CObject *requestValues[] = {&calls};
+
+  Dart_CObject request{};
+  request.type = Dart_CObject_kArray;
+  request.value.as_array.length = 1;
+  request.value.as_array.values = requestValues;
+
+  if (!sendRequest(&request)) {
+    // The callback has been closed and will never deliver the batch, so
+    // further batches are never sent.
+    debugLog("did not send batch because callback is already closed");
+  }
+}
+
 bool AsyncCallback::sendRequest(Dart_CObject *request) {
   // If the send port and therefore the callback is closed before the request
   // can be sent, this call returns false. This allows us to avoid calling this
@@ -142,23 +364,25 @@ inline void AsyncCallback::debugLog(const char *message) {
 
 static std::string failureResult = "__ASYNC_CALLBACK_FAILED__";
 
-AsyncCallbackCall::AsyncCallbackCall(AsyncCallback &callback, bool isBlocking)
-    : callback_(callback) {
-  callback_.registerCall(*this);
+// Ids start at 1, so that no call has the id `0`, which the Dart side sends
+// for non-blocking calls.
+static std::atomic<uint64_t> nextCallId{1};
 
-  if (isBlocking) {
-    receivePort_ = Dart_NewNativePort_DL(
-        "AsyncCallbackCall", &AsyncCallbackCall::messageHandler, false);
-    assert(receivePort_ != ILLEGAL_PORT);
+AsyncCallbackCall::AsyncCallbackCall(AsyncCallback &callback, bool isBlocking)
+    : callback_(callback),
+      id_(nextCallId.fetch_add(1, std::memory_order_relaxed)) {
+  isRegistered_ = callback_.tryRegisterCall(*this, isBlocking);
+  if (!isRegistered_) {
+    // The callback is being closed, so the call is completed early, like
+    // calls which are closed before they are executed.
+    debugLog("not registered because callback is already closed");
+    isCompleted_ = true;
   }
 };
 
 AsyncCallbackCall::~AsyncCallbackCall() {
-  callback_.unregisterCall(*this);
-
-  if (isBlocking()) {
-    auto didCloseReceivePort = Dart_CloseNativePort_DL(receivePort_);
-    assert(didCloseReceivePort);
+  if (isRegistered_) {
+    callback_.unregisterCall(*this);
   }
 }
 
@@ -167,44 +391,72 @@ void AsyncCallbackCall::execute(Dart_CObject &arguments) {
 
   assert(!isExecuted_);
   isExecuted_ = true;
+  Stats::instance.asyncCallbackCalled();
 
   if (isCompleted_) {
-    // Call was completed early by `close`.
-    assert(!hasResultHandler());
+    // Call was completed early by `close` or created after its callback was
+    // closed.
+    assert(!hasResultHandler() || !isRegistered_);
     debugLog("not sending request because call is already closed");
     return;
   }
 
+  if (!isBlocking() && callback_.enqueueBatchedCall(arguments)) {
+    debugLog("enqueued batched call");
+    isCompleted_ = true;
+    return;
+  }
+
+  // The span covers sending the call and, for blocking calls, waiting for its
+  // completion. The flow links the span to the handling of the call in Dart.
+  TimelineSpan span("CBLDart AsyncCallbackCall");
+  Dart_CObject flowId{};
+  if (span.isRecorded()) {
+    flowId.type = Dart_CObject_kInt64;
+    flowId.value.as_int64 = Timeline::newFlowId();
+    Timeline::recordFlowBegin("CBLDart AsyncCallbackCall",
+                              flowId.value.as_int64);
+  } else {
+    flowId.type = Dart_CObject_kNull;
+  }
+
   // The SendPort to signal the return of the callback.
   // Only necessary if the caller is interested in it.
   Dart_CObject responsePort{};
   if (isBlocking()) {
     responsePort.type = Dart_CObject_kSendPort;
-    responsePort.value.as_send_port.id = receivePort_;
+    responsePort.value.as_send_port.id = responsePort_;
     responsePort.value.as_send_port.origin_id = ILLEGAL_PORT;
   } else {
     responsePort.type = Dart_CObject_kNull;
   }
 
-  // Pointer to this call, which is sent back by the Dart side in the result
+  // Id of this call, which is sent back by the Dart side in the result
   // response. This is how we get a reference to this call in the response
   // handler. Only necessary if the caller is waiting for the return of the
   // callback.
-  Dart_CObject callPointer{};
-  CBLDart_CObject_SetPointer(&callPointer, isBlocking() ? this : nullptr);
+  Dart_CObject callId{};
+  if (isBlocking()) {
+    callId.type = Dart_CObject_kInt64;
+    callId.value.as_int64 = static_cast<int64_t>(id_);
+  } else {
+    callId.type = Dart_CObject_kNull;
+  }
 
   // The request is sent as an array.
-  Dart_CObject *requestValues[] = {&responsePort, &callPointer, &arguments};
+  Dart_CObject *requestValues[] = {&responsePort, &callId, &arguments,
+                                   &flowId};
 
   Dart_CObject request{};
   request.type = Dart_CObject_kArray;
-  request.value.as_array.length = 3;
+  request.value.as_array.length = 4;
   request.value.as_array.values = requestValues;
 
   if (isBlocking()) {
     AsyncCallbackRegistry::instance.addBlockingCall(*this);
   }
 
+  auto sendTime = std::chrono::steady_clock::now();
   auto didSendRequest = callback_.sendRequest(&request);
   if (!didSendRequest) {
     // The request could not be sent because the callback has already been
@@ -226,6 +478,8 @@ void AsyncCallbackCall::execute(Dart_CObject &arguments) {
   if (isBlocking()) {
     debugLog("waiting for completion");
     waitForCompletion(lock);
+    Stats::instance.blockingAsyncCallbackCalls.record(
+        std::chrono::steady_clock::now() - sendTime);
   } else {
     isCompleted_ = true;
   }
@@ -236,11 +490,6 @@ void AsyncCallbackCall::execute(Dart_CObject &arguments) {
 void AsyncCallbackCall::complete(Dart_CObject *result) {
   assert(result);
 
-  if (!AsyncCallbackRegistry::instance.takeBlockingCall(*this)) {
-    // Prevent completing calls which have been completed by `close`.
-    return;
-  }
-
   std::scoped_lock lock(mutex_);
 
   debugLog("completing with result");
@@ -298,17 +547,38 @@ void AsyncCallbackCall::messageHandler(Dart_Port dest_port_id,
   assert(response->type == Dart_CObject_kArray);
   assert(response->value.as_array.length == 2);
 
-  auto callPointer = response->value.as_array.values[0];
+  auto callId = static_cast<uint64_t>(
+      CBLDart_CObject_getIntValueAsInt64(response->value.as_array.values[0]));
   auto result = response->value.as_array.values[1];
 
-  AsyncCallbackCall &call = *reinterpret_cast<AsyncCallbackCall *>(
-      CBLDart_CObject_getIntValueAsInt64(callPointer));
+  auto call = AsyncCallbackRegistry::instance.takeBlockingCall(callId);
+  if (!call) {
+    // Prevent completing calls which have been completed by `close` or have
+    // been abandoned after missing their deadline.
+    AsyncCallbackRegistry::instance.completeAbandonedCall(callId, result);
+    return;
+  }
 
-  call.complete(result);
+  call->complete(result);
 }
 
 void AsyncCallbackCall::waitForCompletion(std::unique_lock<std::mutex> &lock) {
-  completedCv_.wait(lock, [this] { return isCompleted_; });
+  auto isCompleted = [this] { return isCompleted_; };
+  if (!timeout_) {
+    completedCv_.wait(lock, isCompleted);
+  } else if (!completedCv_.wait_for(lock, *timeout_, isCompleted)) {
+    if (AsyncCallbackRegistry::instance.abandonBlockingCall(
+            *this, std::move(abandonedHandler_))) {
+      debugLog("abandoned after missing deadline");
+      didTimeOut_ = true;
+      isCompleted_ = true;
+      return;
+    }
+
+    // The response has been received just in time and `complete` is waiting
+    // for the lock on this call.
+    completedCv_.wait(lock, isCompleted);
+  }
 
   if (didFail_) {
     debugLog("failed");
@@ -1,8 +1,17 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "dart/dart_api_dl.h"
@@ -12,6 +21,135 @@ namespace CBLDart {
 class AsyncCallback;
 class AsyncCallbackCall;
 
+/**
+ * Handles the result of a blocking call which has been abandoned after
+ * missing its deadline, or `nullptr` if the callback has been closed before
+ * the result was received.
+ */
+typedef std::function<void(Dart_CObject *result)> AbandonedCallHandler;
+
+// === ShardedPointerSet ======================================================
+
+/**
+ * A set of pointers which is striped into shards, each guarded by its own
+ * lock.
+ *
+ * Threads which access different pointers rarely contend for the same lock
+ * and every operation is O(1) on average.
+ */
+template <typename T>
+class ShardedPointerSet {
+ public:
+  void insert(T *pointer) {
+    auto &shard = shardFor(pointer);
+    std::scoped_lock lock(shard.mutex);
+    shard.pointers.insert(pointer);
+  }
+
+  bool erase(T *pointer) {
+    auto &shard = shardFor(pointer);
+    std::scoped_lock lock(shard.mutex);
+    return shard.pointers.erase(pointer) != 0;
+  }
+
+  bool contains(T *pointer) const {
+    auto &shard = shardFor(pointer);
+    std::scoped_lock lock(shard.mutex);
+    return shard.pointers.count(pointer) != 0;
+  }
+
+ private:
+  static const size_t kShardCount = 16;
+
+  // Shards are aligned to cache lines to avoid false sharing between locks.
+  struct alignas(64) Shard {
+    std::mutex mutex;
+    std::unordered_set<T *> pointers;
+  };
+
+  Shard &shardFor(T *pointer) const {
+    // The low bits of pointers are mostly zero because of alignment.
+    auto hash = reinterpret_cast<uintptr_t>(pointer) >> 4;
+    return shards_[(hash ^ (hash >> 8)) % kShardCount];
+  }
+
+  mutable std::array<Shard, kShardCount> shards_;
+};
+
+// === ShardedIdMap ===========================================================
+
+/**
+ * A map from unique ids to pointers, which is striped into shards, each
+ * guarded by its own lock, like `ShardedPointerSet`.
+ */
+template <typename T>
+class ShardedIdMap {
+ public:
+  void insert(uint64_t id, T *pointer) {
+    auto &shard = shardFor(id);
+    std::scoped_lock lock(shard.mutex);
+    shard.pointers.emplace(id, pointer);
+  }
+
+  bool erase(uint64_t id) {
+    auto &shard = shardFor(id);
+    std::scoped_lock lock(shard.mutex);
+    return shard.pointers.erase(id) != 0;
+  }
+
+  /** Erases the pointer with `id` and returns it, or `nullptr`. */
+  T *take(uint64_t id) {
+    auto &shard = shardFor(id);
+    std::scoped_lock lock(shard.mutex);
+    auto position = shard.pointers.find(id);
+    if (position == shard.pointers.end()) {
+      return nullptr;
+    }
+    auto pointer = position->second;
+    shard.pointers.erase(position);
+    return pointer;
+  }
+
+ private:
+  static const size_t kShardCount = 16;
+
+  struct alignas(64) Shard {
+    std::mutex mutex;
+    std::unordered_map<uint64_t, T *> pointers;
+  };
+
+  // Ids are allocated sequentially, so consecutive ids use different shards.
+  Shard &shardFor(uint64_t id) { return shards_[id % kShardCount]; }
+
+  std::array<Shard, kShardCount> shards_;
+};
+
+// === CObjectCopy =============================================================
+
+/**
+ * A deep copy of a `Dart_CObject`, which owns the memory of all nested
+ * objects.
+ *
+ * Supports null, bool, int, double, string, array and typed data objects.
+ */
+class CObjectCopy {
+ public:
+  explicit CObjectCopy(const Dart_CObject &object);
+
+  CObjectCopy(const CObjectCopy &) = delete;
+  CObjectCopy &operator=(const CObjectCopy &) = delete;
+
+  Dart_CObject *object() { return object_; }
+
+ private:
+  Dart_CObject *copy(const Dart_CObject &object);
+
+  Dart_CObject *object_;
+  std::deque<Dart_CObject> objects_;
+  std::deque<std::vector<Dart_CObject *>> arrays_;
+  std::deque<std::vector<uint8_t>> buffers_;
+};
+
 // === AsyncCallbackRegistry ==================================================
 
 class AsyncCallbackRegistry {
@@ -28,12 +166,51 @@ class AsyncCallbackRegistry {
 
   bool takeBlockingCall(AsyncCallbackCall &call);
 
+  /**
+   * Takes the blocking call with the id `callId`.
+   *
+   * Calls are identified by ids, which are never reused, instead of their
+   * addresses, so that a late response to a call which has been completed
+   * early cannot complete a later call at the same address.
+   */
+  AsyncCallbackCall *takeBlockingCall(uint64_t callId);
+
+  /**
+   * Takes the blocking `call` and keeps its `abandonedHandler` until the
+   * response to the call is received or its callback is closed.
+   *
+   * Returns `false` if the call has already been taken, because its response
+   * has been received.
+   */
+  bool abandonBlockingCall(AsyncCallbackCall &call,
+                           AbandonedCallHandler abandonedHandler);
+
+  /**
+   * Calls and removes the handler of the abandoned call with the id
+   * `callId` with the `result` of the call.
+   */
+  void completeAbandonedCall(uint64_t callId, Dart_CObject *result);
+
+  /**
+   * Calls and removes the handlers of all abandoned calls of `callback`,
+   * whose responses will never be received, with `nullptr`.
+   */
+  void closeAbandonedCalls(const AsyncCallback &callback);
+
  private:
   AsyncCallbackRegistry();
 
-  mutable std::mutex mutex_;
-  std::vector<const AsyncCallback *> callbacks_;
-  std::vector<AsyncCallbackCall *> blockingCalls_;
+  struct AbandonedCall {
+    const AsyncCallback *callback;
+    AbandonedCallHandler handler;
+  };
+
+  ShardedPointerSet<const AsyncCallback> callbacks_;
+  ShardedIdMap<AsyncCallbackCall> blockingCalls_;
+  // Calls are only abandoned when they miss their deadline, which is rare
+  // enough for a single lock.
+  std::mutex abandonedCallsMutex_;
+  std::unordered_map<uint64_t, AbandonedCall> abandonedCalls_;
 };
 
 // === AsyncCallback ==========================================================
@@ -51,12 +228,37 @@ class AsyncCallback {
   void setFinalizer(void *context, CallbackFinalizer finalizer);
   void close();
 
+  /**
+   * Enables delivering the arguments of non-blocking calls in batches of up
+   * to `maxBatchSize` calls.
+   *
+   * While a batch is being handled by the Dart side, the arguments of new
+   * calls are queued. Once the Dart side reports that it has handled the
+   * batch through `batchDelivered`, the queued arguments are sent as the next
+   * batch. The first call after the queue has been drained is sent
+   * immediately.
+   *
+   * Must be called before the callback is called for the first time.
+   */
+  void enableBatching(uint32_t maxBatchSize);
+
+  void batchDelivered();
+
  private:
   friend class AsyncCallbackCall;
 
-  void registerCall(AsyncCallbackCall &call);
+  /**
+   * Registers `call`, unless this callback has already been closed.
+   *
+   * A callback is closed before its finalizer runs, so the owner of a
+   * callback can still create calls while the callback is being closed.
+   * Those calls are not registered and do nothing when executed.
+   */
+  bool tryRegisterCall(AsyncCallbackCall &call, bool isBlocking);
   void unregisterCall(AsyncCallbackCall &call);
   bool sendRequest(Dart_CObject *request);
+  bool enqueueBatchedCall(const Dart_CObject &arguments);
+  void sendBatch(std::unique_lock<std::mutex> &lock);
   inline void debugLog(const char *message);
 
   uint32_t id_;
@@ -65,9 +267,17 @@ class AsyncCallback {
   std::condition_variable cv_;
   bool closed_ = false;
   Dart_Port sendPort_ = ILLEGAL_PORT;
+  // The port through which the results of all blocking calls of this
+  // callback are received. Responses are matched to calls by the call id sent
+  // in the request, which is never reused.
+  Dart_Port responsePort_ = ILLEGAL_PORT;
   void *finalizerContext_ = nullptr;
   CallbackFinalizer finalizer_ = nullptr;
   std::vector<AsyncCallbackCall *> activeCalls_;
+  std::atomic<uint32_t> maxBatchSize_ = 0;
+  std::mutex batchMutex_;
+  bool batchInFlight_ = false;
+  std::deque<std::unique_ptr<CObjectCopy>> batchedCalls_;
 };
 
 // === AsyncCallbackCall ======================================================
@@ -86,7 +296,14 @@ class AsyncCallbackCall {
 
   ~AsyncCallbackCall();
 
-  bool isBlocking() { return receivePort_ != ILLEGAL_PORT; }
+  /**
+   * Whether this call has been created before its callback was closed.
+   *
+   * Calls which are not registered do nothing when they are executed, so
+   * their arguments are never delivered.
+   */
+  bool isRegistered() { return isRegistered_; }
+  bool isBlocking() { return responsePort_ != ILLEGAL_PORT; }
   bool hasResultHandler() { return resultHandler_ != nullptr; }
   bool isExecuted() {
     std::scoped_lock lock(mutex_);
@@ -97,11 +314,36 @@ class AsyncCallbackCall {
     return isCompleted_;
   }
 
+  /**
+   * Limits how long `execute` waits for the result of this blocking call to
+   * `timeout`.
+   *
+   * If the call has not been completed in time, it is abandoned: `execute`
+   * returns without calling the result handler and `didTimeOut` returns
+   * `true`. The Dart side still handles the call, so the memory which the
+   * arguments refer to must stay valid until `abandonedHandler` is called.
+   *
+   * Must be called before the call is executed.
+   */
+  void setTimeout(std::chrono::milliseconds timeout,
+                  AbandonedCallHandler abandonedHandler) {
+    timeout_ = timeout;
+    abandonedHandler_ = std::move(abandonedHandler);
+  }
+
+  bool didTimeOut() {
+    std::scoped_lock lock(mutex_);
+    return didTimeOut_;
+  }
+
   void execute(Dart_CObject &arguments);
   void complete(Dart_CObject *result);
   void close();
 
  private:
+  friend class AsyncCallback;
+  friend class AsyncCallbackRegistry;
+
   static void messageHandler(Dart_Port dest_port_id, Dart_CObject *message);
 
   void waitForCompletion(std::unique_lock<std::mutex> &lock);
@@ -111,10 +353,15 @@ class AsyncCallbackCall {
   std::mutex mutex_;
   AsyncCallback &callback_;
   const std::function<CallbackResultHandler> *resultHandler_ = nullptr;
-  Dart_Port receivePort_ = ILLEGAL_PORT;
+  uint64_t id_;
+  Dart_Port responsePort_ = ILLEGAL_PORT;
+  std::optional<std::chrono::milliseconds> timeout_;
+  AbandonedCallHandler abandonedHandler_;
+  bool isRegistered_ = false;
   bool isExecuted_ = false;
   bool isCompleted_ = false;
   bool didFail_ = false;
+  bool didTimeOut_ = false;
   std::condition_variable completedCv_;
 };
 
@@ -0,0 +1,124 @@
+#include "BlobCache.h"
+
+namespace CBLDart {
+
+// === BlobCache ==============================================================
+
+BlobCache &BlobCache::instance() {
+  // The cache is never destroyed, because blobs can still be read by other
+  // threads while static objects are destroyed.
+  static auto cache = new BlobCache;
+  return *cache;
+}
+
+FLSliceResult BlobCache::get(const CBLDatabase *database, FLString digest) {
+  std::string key(static_cast<const char *>(digest.buf), digest.size);
+
+  std::scoped_lock lock(mutex_);
+  auto databaseIt = databases_.find(database);
+  if (databaseIt != databases_.end()) {
+    auto &cache = databaseIt->second;
+    auto it = cache.index.find(key);
+    if (it != cache.index.end()) {
+      cache.entries.splice(cache.entries.begin(), cache.entries, it->second);
+      hits_++;
+      return FLSliceResult_Retain(it->second->content);
+    }
+  }
+  misses_++;
+  return {};
+}
+
+void BlobCache::put(const CBLDatabase *database, FLString digest,
+                    FLSlice content) {
+  std::list<FLSliceResult> evicted;
+  {
+    std::scoped_lock lock(mutex_);
+    if (content.size > maxEntrySize_ || content.size > maxSize_) {
+      return;
+    }
+
+    std::string key(static_cast<const char *>(digest.buf), digest.size);
+    auto &cache = databases_[database];
+    if (cache.index.find(key) != cache.index.end()) {
+      return;
+    }
+
+    cache.entries.push_front({key, FLSlice_Copy(content)});
+    cache.index.emplace(std::move(key), cache.entries.begin());
+    cache.size += content.size;
+    evict(cache, evicted);
+  }
+
+  for (auto content : evicted) {
+    FLSliceResult_Release(content);
+  }
+}
+
+void BlobCache::purge(const CBLDatabase *database) {
+  std::list<Entry> entries;
+  {
+    std::scoped_lock lock(mutex_);
+    auto it = databases_.find(database);
+    if (it == databases_.end()) {
+      return;
+    }
+    entries = std::move(it->second.entries);
+    databases_.erase(it);
+  }
+
+  for (auto &entry : entries) {
+    FLSliceResult_Release(entry.content);
+  }
+}
+
+void BlobCache::setLimits(size_t maxSize, size_t maxEntrySize) {
+  std::list<FLSliceResult> evicted;
+  {
+    std::scoped_lock lock(mutex_);
+    maxSize_ = maxSize;
+    maxEntrySize_ = maxEntrySize;
+    for (auto &[_, cache] : databases_) {
+      evict(cache, evicted);
+    }
+  }
+
+  for (auto content : evicted) {
+    FLSliceResult_Release(content);
+  }
+}
+
+CBLDart_BlobCacheStats BlobCache::stats() {
+  std::scoped_lock lock(mutex_);
+  size_t size = 0;
+  for (auto &[_, cache] : databases_) {
+    size += cache.size;
+  }
+  return {hits_, misses_, evictions_, size, maxSize_, maxEntrySize_};
+}
+
+void BlobCache::evict(DatabaseCache &cache,
+                      std::list<FLSliceResult> &evicted) {
+  for (auto it = cache.entries.begin(); it != cache.entries.end();) {
+    if (it->content.size > maxEntrySize_) {
+      cache.size -= it->content.size;
+      cache.index.erase(it->digest);
+      evicted.push_back(it->content);
+      it = cache.entries.erase(it);
+      evictions_++;
+    } else {
+      ++it;
+    }
+  }
+
+  while (cache.size > maxSize_) {
+    auto &last = cache.entries.back();
+    cache.size -= last.content.size;
+    cache.index.erase(last.digest);
+    evicted.push_back(last.content);
+    cache.entries.pop_back();
+    evictions_++;
+  }
+}
+
+}  // namespace CBLDart
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "CBL+Dart.h"
+
+namespace CBLDart {
+
+// === BlobCache ==============================================================
+
+/**
+ * An in-memory cache of the content of small blobs, which allows frequently
+ * read blobs to be read without opening and reading their files again.
+ *
+ * Content is keyed by the digest of the blob, which identifies it, so that
+ * cached content never has to be invalidated. The content of each database is
+ * kept in a least recently used list, whose total size is at most `maxSize`
+ * bytes. Content which is larger than `maxEntrySize` bytes is not cached.
+ */
+class BlobCache {
+ public:
+  static BlobCache &instance();
+
+  BlobCache(const BlobCache &) = delete;
+  BlobCache &operator=(const BlobCache &) = delete;
+
+  /**
+   * Returns the cached content of the blob with `digest` in `database`, which
+   * must be released by the caller, or a null slice if it is not cached.
+   */
+  FLSliceResult get(const CBLDatabase *database, FLString digest);
+
+  /**
+   * Caches a copy of `content` as the content of the blob with `digest` in
+   * `database`, unless it is larger than `maxEntrySize` bytes.
+   */
+  void put(const CBLDatabase *database, FLString digest, FLSlice content);
+
+  /**
+   * Releases the cached content of `database`.
+   *
+   * Must be called before `database` is closed.
+   */
+  void purge(const CBLDatabase *database);
+
+  /**
+   * Sets the maximum size of the cached content of each database and of a
+   * single blob, and evicts the least recently used content which exceeds
+   * them.
+   */
+  void setLimits(size_t maxSize, size_t maxEntrySize);
+
+  CBLDart_BlobCacheStats stats();
+
+ private:
+  BlobCache() = default;
+
+  struct Entry {
+    std::string digest;
+    FLSliceResult content;
+  };
+
+  struct DatabaseCache {
+    /** The cached content, with the most recently used content first. */
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    size_t size = 0;
+  };
+
+  /** Removes the least recently used content which exceeds the limits. */
+  void evict(DatabaseCache &cache, std::list<FLSliceResult> &evicted);
+
+  std::mutex mutex_;
+  size_t maxSize_ = 0;
+  size_t maxEntrySize_ = 64 * 1024;
+  std::unordered_map<const CBLDatabase *, DatabaseCache> databases_;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t evictions_ = 0;
+};
+
+}  // namespace CBLDart
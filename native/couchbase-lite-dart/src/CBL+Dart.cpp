@@ -1,24 +1,82 @@
-#include <future>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <shared_mutex>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include "AsyncCallback.h"
+#include "BlobCache.h"
 #include "CBL+Dart.h"
+#include "ChangeCursor.h"
+#include "ChunkQueue.h"
+#include "DatabaseLock.h"
+#include "DatabaseThreads.h"
+#include "DocumentCache.h"
+#include "DocumentWatcher.h"
+#include "Executor.h"
+#include "ExpirationTracker.h"
+#include "FilterExpression.h"
+#include "FullTextSearch.h"
+#include "ListenerThrottle.h"
+#include "LogRingBuffer.h"
+#include "MaintenanceScheduler.h"
+#include "MessageArena.h"
+#include "QueryCache.h"
+#include "QueryResultsDiffer.h"
+#include "ReplicatorMetrics.h"
+#include "ReplicatorScheduler.h"
 #include "Sentry.h"
+#include "Stats.h"
+#include "Timeline.h"
 #include "Utils.h"
 
 static std::mutex initializeMutex;
 static bool initialized = false;
 
-CBLDartInitializeResult CBLDart_Initialize(void *dartInitializeDlData,
-                                           void *cblInitContext,
-                                           CBLError *errorOut) {
+static const CBLDart_FunctionTable functionTable = {
+    kCBLDart_FunctionTableVersion,
+
+    // Base
+    CBL_Retain,
+    CBL_Release,
+    CBLError_Message,
+    CBLListener_Remove,
+    CBLDart_Stats_Snapshot,
+    CBLDart_Timeline_Enable,
+    CBLDart_Timeline_Disable,
+
+    // Async Callbacks
+    CBLDart_AsyncCallback_New,
+    CBLDart_AsyncCallback_Delete,
+    CBLDart_AsyncCallback_Close,
+    CBLDart_AsyncCallback_EnableBatching,
+    CBLDart_AsyncCallback_BatchDelivered,
+    CBLDart_AsyncCallback_CallForTest,
+};
+
+CBLDartInitializeResult CBLDart_Initialize(
+    void *dartInitializeDlData, void *cblInitContext,
+    const CBLDart_FunctionTable **functionTableOut, CBLError *errorOut) {
   std::scoped_lock lock(initializeMutex);
 
   if (initialized) {
     // Only initialize libraries once.
+    *functionTableOut = &functionTable;
     return CBLDartInitializeResult_kSuccess;
   }
 
@@ -36,6 +94,7 @@ CBLDartInitializeResult CBLDart_Initialize(void *dartInitializeDlData,
   }
 
   initialized = true;
+  *functionTableOut = &functionTable;
   return CBLDartInitializeResult_kSuccess;
 }
 
@@ -62,6 +121,15 @@ void CBLDart_AsyncCallback_Close(CBLDart_AsyncCallback callback) {
   ASYNC_CALLBACK_FROM_C(callback)->close();
 }
 
+void CBLDart_AsyncCallback_EnableBatching(CBLDart_AsyncCallback callback,
+                                          uint32_t maxBatchSize) {
+  ASYNC_CALLBACK_FROM_C(callback)->enableBatching(maxBatchSize);
+}
+
+void CBLDart_AsyncCallback_BatchDelivered(CBLDart_AsyncCallback callback) {
+  ASYNC_CALLBACK_FROM_C(callback)->batchDelivered();
+}
+
 void CBLDart_AsyncCallback_CallForTest(CBLDart_AsyncCallback callback,
                                        int64_t argument) {
   std::thread([=]() {
@@ -80,128 +148,117 @@ void CBLDart_AsyncCallback_CallForTest(CBLDart_AsyncCallback callback,
   }).detach();
 }
 
-// === Couchbase Lite =========================================================
-
-// === Database level locking
-
-/**
- * Database level locking is only required in certain scenarios.
- *
- * Any given database is only ever accessed by the same Dart isolate. Since
- * Dart isolates are single threaded, we can safely use the CBL C API, which is
- * generally not thread safe.
- *
- * An exception are native finalizers. These are called from the Dart VM during
- * GC. Even though the Dart isolate will never execute while native finalizers
- * are running, native code called through FFI from the Dart isolate can.
- *
- * According to the CBL C docs we need to serialize all access to a database
- * instance and objects that belong to it. In reality, many operations of the
- * CBL C API are thread safe. We only use locking for the operations where it
- * turned out that it is necessary.
- *
- * Specifically we need to ensure that:
- *
- * - listeners are not finalized while the database is closing.
- * - replicators are not stopped while the database is closing.
- */
-
-/**
- * Mapping of objects to the mutex that is used for database level locking of
- * the database the objects belong to.
- *
- * Every object in this mapping owns a shared_ptr to the database level mutex.
- *
- * `CBLDart_CreateDatabaseLock`, `CBLDart_CloneDatabaseLock`,
- * `CBLDart_AcquireDatabaseLock` and `CBLDart_ReleaseDatabaseLock` are used
- * to create, clone and acquire and release (the shared_ptr, not the lock)
- * database level locks.
- *
- * When a database is opened it uses `CBLDart_CreateDatabaseLock` to create the
- * mutex that belongs to the database.
- *
- * Other objects that need to lock access to the database use
- * `CBLDart_CloneDatabaseLock` to create a shared_ptr to the mutex of the
- * database they belong to.
- *
- * Callers of `CBLDart_CloneDatabaseLock` must ensure that the database is
- * still open when they call `CBLDart_CloneDatabaseLock`.
- *
- * These objects can then use `CBLDart_AcquireDatabaseLock` to acquire the
- * database level lock by providing a pointer to themself.
- *
- * When an object that has cloned a lock is destroyed it must call
- * `CBLDart_ReleaseDatabaseLock`.
- */
-static std::map<void *, std::shared_ptr<std::mutex>> databaseMutexes;
-static std::mutex databaseMutexesMutex;
+// === Stats
 
-static void CBLDart_CreateDatabaseLock(CBLDatabase *database) {
-  std::scoped_lock lock(databaseMutexesMutex);
-  databaseMutexes[database] = std::make_shared<std::mutex>();
+void CBLDart_Stats_Snapshot(CBLDart_Stats *statsOut) {
+  CBLDart::Stats::instance.read(statsOut);
 }
 
-static void CBLDart_CloneDatabaseLock(const CBLDatabase *database,
-                                      void *owner) {
-  std::scoped_lock lock(databaseMutexesMutex);
-  assert(databaseMutexes.find(const_cast<CBLDatabase *>(database)) !=
-         databaseMutexes.end());
-  databaseMutexes[owner] = databaseMutexes[const_cast<CBLDatabase *>(database)];
-}
+// === Timeline
 
-static std::scoped_lock<std::mutex> CBLDart_AcquireDatabaseLock(void *owner) {
-  std::scoped_lock lock(databaseMutexesMutex);
-  return std::scoped_lock(*databaseMutexes[owner]);
-}
+bool CBLDart_Timeline_Enable(void) { return CBLDart::Timeline::enable(); }
 
-static void CBLDart_ReleaseDatabaseLock(void *owner) {
-  std::scoped_lock lock(databaseMutexesMutex);
-  databaseMutexes.erase(owner);
-}
+void CBLDart_Timeline_Disable(void) { CBLDart::Timeline::disable(); }
+
+// === Couchbase Lite =========================================================
 
 // === Base
 
-// Listeners that use this finalizer must use `CBLDart_CloneDatabaseLock`
-// to retain the database lock of the database they belong to.
+struct CBLDart_ListenerContext {
+  CBLListenerToken *listenerToken;
+  CBLDart_DatabaseLock *databaseLock;
+};
+
 static void CBLDart_CBLListenerFinalizer(void *context) {
-  auto listenerToken = reinterpret_cast<CBLListenerToken *>(context);
+  auto listenerContext = reinterpret_cast<CBLDart_ListenerContext *>(context);
   {
     // We acquire the database lock here to ensure that the database is not
     // closed while we are still executing.
-    auto databaseLock = CBLDart_AcquireDatabaseLock(listenerToken);
-    CBLListener_Remove(listenerToken);
+    auto databaseLock = listenerContext->databaseLock->acquire();
+    CBLListener_Remove(listenerContext->listenerToken);
   }
-  CBLDart_ReleaseDatabaseLock(listenerToken);
+  listenerContext->databaseLock->release();
+  delete listenerContext;
+}
+
+/**
+ * Removes the listener with `listenerToken`, which belongs to `database`,
+ * when `listener` is closed.
+ */
+static void CBLDart_SetListenerFinalizer(const CBLDatabase *database,
+                                         CBLListenerToken *listenerToken,
+                                         CBLDart_AsyncCallback listener) {
+  auto listenerContext = new CBLDart_ListenerContext{
+      listenerToken, CBLDart_CloneDatabaseLock(database)};
+  ASYNC_CALLBACK_FROM_C(listener)->setFinalizer(listenerContext,
+                                                CBLDart_CBLListenerFinalizer);
 }
 
 // === Log
 
 static std::shared_mutex loggingMutex;
 static CBLDart::AsyncCallback *logCallback = nullptr;
-static CBLLogLevel logCallbackLevel = CBLLog_CallbackLevel();
+static constexpr size_t kLogDomainCount = kCBLLogDomainNetwork + 1;
+
+static CBLLogLevel logCallbackLevels[kLogDomainCount] = {
+    CBLLog_CallbackLevel(), CBLLog_CallbackLevel(), CBLLog_CallbackLevel(),
+    CBLLog_CallbackLevel()};
 static CBLLogFileConfiguration *logFileConfig = nullptr;
 static bool logSentryBreadcrumbsEnabled = false;
+static CBLLogLevel logSentryBreadcrumbsLevel = kCBLLogInfo;
+
+// Copies of the logging state which are read on the logging threads, without
+// acquiring `loggingMutex`.
+static std::atomic<bool> logCallbackEnabled = false;
+static std::atomic<CBLLogLevel> effectiveLogCallbackLevels[kLogDomainCount] = {
+    logCallbackLevels[0], logCallbackLevels[1], logCallbackLevels[2],
+    logCallbackLevels[3]};
+static std::atomic<bool> effectiveLogSentryBreadcrumbsEnabled = false;
+static std::atomic<CBLLogLevel> effectiveLogSentryBreadcrumbsLevel =
+    logSentryBreadcrumbsLevel;
+static std::atomic<uint32_t> logSentryBreadcrumbsMaxPerSecond = 100;
 
 // Forward declarations for the logging functions.
 static void CBLDart_LogSentryBreadcrumb(CBLLogDomain domain, CBLLogLevel level,
                                         FLString message);
-static void CBLDart_CallDartLogCallback(CBLLogDomain domain, CBLLogLevel level,
-                                        FLString message);
+static void CBLDart_EnqueueDartLogMessage(CBLLogDomain domain,
+                                          CBLLogLevel level, FLString message);
+static void CBLDart_EnqueueSentryBreadcrumb(CBLLogDomain domain,
+                                            CBLLogLevel level,
+                                            FLString message);
 
 static void CBLDart_LogCallback(CBLLogDomain domain, CBLLogLevel level,
                                 FLString message) {
-  std::shared_lock lock(loggingMutex);
+  if (effectiveLogSentryBreadcrumbsEnabled.load(std::memory_order_relaxed) &&
+      level >=
+          effectiveLogSentryBreadcrumbsLevel.load(std::memory_order_relaxed)) {
+    CBLDart_EnqueueSentryBreadcrumb(domain, level, message);
+  }
 
-  if (logSentryBreadcrumbsEnabled) {
-    CBLDart_LogSentryBreadcrumb(domain, level, message);
+  // Messages are filtered by the level of their domain before they are
+  // copied, so that verbose logging of one domain does not make delivering
+  // the messages of the other domains more expensive.
+  if (logCallbackEnabled.load(std::memory_order_relaxed) &&
+      domain < kLogDomainCount &&
+      level >= effectiveLogCallbackLevels[domain].load(
+                   std::memory_order_relaxed)) {
+    CBLDart_EnqueueDartLogMessage(domain, level, message);
   }
+}
 
-  if (logCallback && level >= logCallbackLevel) {
-    CBLDart_CallDartLogCallback(domain, level, message);
+/** Copies `logCallbackLevels` into `effectiveLogCallbackLevels`. */
+static void CBLDart_UpdateEffectiveLogCallbackLevels() {
+  for (size_t i = 0; i < kLogDomainCount; i++) {
+    effectiveLogCallbackLevels[i] = logCallbackLevels[i];
   }
 }
 
 static void CBLDart_UpdateEffectiveLogCallback() {
+  logCallbackEnabled = logCallback != nullptr;
+  CBLDart_UpdateEffectiveLogCallbackLevels();
+  effectiveLogSentryBreadcrumbsEnabled = logSentryBreadcrumbsEnabled;
+  effectiveLogSentryBreadcrumbsLevel = logSentryBreadcrumbsLevel;
+
   if (logSentryBreadcrumbsEnabled || logCallback) {
     CBLLog_SetCallback(CBLDart_LogCallback);
   } else {
@@ -210,34 +267,247 @@ static void CBLDart_UpdateEffectiveLogCallback() {
 }
 
 static void CBLDart_UpdateEffectiveLogCallbackLevel() {
+  CBLDart_UpdateEffectiveLogCallbackLevels();
+  effectiveLogSentryBreadcrumbsLevel = logSentryBreadcrumbsLevel;
+
+  // LiteCore has a single callback level for all domains, which must be the
+  // lowest level of any domain.
+  auto logCallbackLevel =
+      *std::min_element(std::begin(logCallbackLevels),
+                        std::end(logCallbackLevels));
+
+  // LiteCore only formats messages at or above the callback level, so it must
+  // not be lower than what one of the consumers needs.
   if (logSentryBreadcrumbsEnabled) {
-    CBLLog_SetCallbackLevel(kCBLLogDebug);
+    CBLLog_SetCallbackLevel(logCallback ? std::min(logCallbackLevel,
+                                                   logSentryBreadcrumbsLevel)
+                                        : logSentryBreadcrumbsLevel);
   } else {
     CBLLog_SetCallbackLevel(logCallbackLevel);
   }
 }
 
-static void CBLDart_CallDartLogCallback(CBLLogDomain domain, CBLLogLevel level,
-                                        FLString message) {
-  Dart_CObject domain_{};
-  domain_.type = Dart_CObject_kInt32;
-  domain_.value.as_int32 = static_cast<int32_t>(domain);
+/**
+ * Delivers log messages to the Dart log callback and records them as Sentry
+ * breadcrumbs.
+ *
+ * Logging threads only copy messages into ring buffers. A drain thread
+ * delivers the buffered messages to Dart in batches, through one call per
+ * batch, whose arguments are the domain, level and message of each log
+ * message, interleaved. Messages which don't fit into the buffer are dropped
+ * and reported in a warning, once there is room again.
+ *
+ * The drain thread also records breadcrumbs, so that the Sentry API is never
+ * called on a logging thread. Breadcrumbs are rate limited before they are
+ * buffered.
+ */
+class CBLDart_LogPipeline {
+ public:
+  static CBLDart_LogPipeline &instance() {
+    // The pipeline is never destroyed, because logging threads and the drain
+    // thread can still be running while static objects are destroyed.
+    static auto pipeline = new CBLDart_LogPipeline;
+    return *pipeline;
+  }
 
-  Dart_CObject level_{};
-  level_.type = Dart_CObject_kInt32;
-  level_.value.as_int32 = static_cast<int32_t>(level);
+  void enqueue(CBLLogDomain domain, CBLLogLevel level, FLString message) {
+    buffer_.push(domain, level, message);
+
+    // Warnings and errors are delivered promptly. Other messages are
+    // delivered periodically, unless the buffer is filling up.
+    if (level >= kCBLLogWarning || buffer_.size() >= buffer_.capacity() / 2) {
+      wake();
+    }
+  }
 
-  Dart_CObject message_{};
-  CBLDart_CObject_SetFLString(&message_, message);
+  void enqueueBreadcrumb(CBLLogDomain domain, CBLLogLevel level,
+                         FLString message) {
+    if (!acquireBreadcrumbPermit()) {
+      return;
+    }
 
-  Dart_CObject *argsValues[] = {&domain_, &level_, &message_};
+    breadcrumbs_.push(domain, level, message);
 
-  Dart_CObject args{};
-  args.type = Dart_CObject_kArray;
-  args.value.as_array.length = 3;
-  args.value.as_array.values = argsValues;
+    if (breadcrumbs_.size() >= breadcrumbs_.capacity() / 2) {
+      wake();
+    }
+  }
 
-  CBLDart::AsyncCallbackCall(*logCallback).execute(args);
+ private:
+  static constexpr size_t kCapacity = 4096;
+  static constexpr size_t kMaxBatchSize = 256;
+  static constexpr auto kDrainInterval = std::chrono::milliseconds(20);
+
+  static constexpr size_t kBreadcrumbsCapacity = 1024;
+
+  CBLDart_LogPipeline()
+      : buffer_(kCapacity), breadcrumbs_(kBreadcrumbsCapacity) {
+    std::thread([this]() { drainLoop(); }).detach();
+  }
+
+  void wake() {
+    if (wakeRequested_.exchange(true, std::memory_order_relaxed)) {
+      return;
+    }
+    std::scoped_lock lock(mutex_);
+    cv_.notify_one();
+  }
+
+  void drainLoop() {
+    while (true) {
+      {
+        std::unique_lock lock(mutex_);
+        cv_.wait_for(lock, kDrainInterval, [this]() {
+          return wakeRequested_.load(std::memory_order_relaxed);
+        });
+      }
+      wakeRequested_.store(false, std::memory_order_relaxed);
+
+      drain();
+    }
+  }
+
+  /**
+   * Limits the rate of breadcrumbs to `logSentryBreadcrumbsMaxPerSecond`,
+   * with a window of one second.
+   */
+  bool acquireBreadcrumbPermit() {
+    auto maxPerSecond =
+        logSentryBreadcrumbsMaxPerSecond.load(std::memory_order_relaxed);
+    if (maxPerSecond == 0) {
+      return true;
+    }
+
+    auto now = std::chrono::duration_cast<std::chrono::seconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+                   .count();
+    auto window = breadcrumbsWindow_.load(std::memory_order_relaxed);
+    if (window != now &&
+        breadcrumbsWindow_.compare_exchange_strong(window, now,
+                                                   std::memory_order_relaxed)) {
+      breadcrumbsInWindow_.store(0, std::memory_order_relaxed);
+    }
+
+    if (breadcrumbsInWindow_.fetch_add(1, std::memory_order_relaxed) >=
+        maxPerSecond) {
+      rateLimitedBreadcrumbs_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  }
+
+  void drainBreadcrumbs() {
+    CBLDart::LogRingBuffer::Entry *entries[kMaxBatchSize];
+    size_t count;
+    while ((count = breadcrumbs_.peek(entries, kMaxBatchSize)) > 0) {
+      for (size_t i = 0; i < count; i++) {
+        auto &entry = *entries[i];
+        CBLDart_LogSentryBreadcrumb(
+            entry.domain, entry.level,
+            {entry.message.data(), entry.message.size()});
+      }
+      breadcrumbs_.release(count);
+    }
+
+    auto droppedCount = breadcrumbs_.droppedCount() +
+                        rateLimitedBreadcrumbs_.load(std::memory_order_relaxed);
+    if (droppedCount != reportedDroppedBreadcrumbs_) {
+      auto message =
+          std::to_string(droppedCount - reportedDroppedBreadcrumbs_) +
+          " log messages were not recorded as breadcrumbs, because of the "
+          "rate limit or because the buffer was full.";
+      reportedDroppedBreadcrumbs_ = droppedCount;
+      CBLDart_LogSentryBreadcrumb(kCBLLogDomainDatabase, kCBLLogWarning,
+                                  {message.data(), message.size()});
+    }
+  }
+
+  void drain() {
+    drainBreadcrumbs();
+
+    std::shared_lock lock(loggingMutex);
+
+    CBLDart::LogRingBuffer::Entry *entries[kMaxBatchSize];
+    size_t count;
+    while ((count = buffer_.peek(entries, kMaxBatchSize)) > 0) {
+      if (logCallback) {
+        sendBatch(entries, count);
+      }
+      buffer_.release(count);
+    }
+
+    auto droppedCount = buffer_.droppedCount();
+    if (droppedCount != reportedDroppedCount_) {
+      auto message = std::to_string(droppedCount - reportedDroppedCount_) +
+                     " log messages were dropped, because they were logged "
+                     "faster than they could be delivered.";
+      reportedDroppedCount_ = droppedCount;
+
+      CBLDart::LogRingBuffer::Entry entry{kCBLLogDomainDatabase,
+                                         kCBLLogWarning, message};
+      auto entryPointer = &entry;
+      if (logCallback) {
+        sendBatch(&entryPointer, 1);
+      }
+    }
+  }
+
+  void sendBatch(CBLDart::LogRingBuffer::Entry **entries, size_t count) {
+    CBLDart::MessageArena::Scope arenaScope;
+    auto &arena = arenaScope.arena();
+    auto objects = arena.allocateArray<Dart_CObject>(count * 3);
+    auto values = arena.allocateArray<Dart_CObject *>(count * 3);
+
+    for (size_t i = 0; i < count; i++) {
+      auto &entry = *entries[i];
+
+      auto &domain = objects[i * 3];
+      domain.type = Dart_CObject_kInt32;
+      domain.value.as_int32 = static_cast<int32_t>(entry.domain);
+
+      auto &level = objects[i * 3 + 1];
+      level.type = Dart_CObject_kInt32;
+      level.value.as_int32 = static_cast<int32_t>(entry.level);
+
+      auto &message = objects[i * 3 + 2];
+      CBLDart_CObject_SetFLString(
+          &message, {entry.message.data(), entry.message.size()});
+
+      values[i * 3] = &domain;
+      values[i * 3 + 1] = &level;
+      values[i * 3 + 2] = &message;
+    }
+
+    Dart_CObject args{};
+    args.type = Dart_CObject_kArray;
+    args.value.as_array.length = count * 3;
+    args.value.as_array.values = values;
+
+    CBLDart::AsyncCallbackCall(*logCallback).execute(args);
+    CBLDart::Stats::instance.logMessagesSent(count);
+  }
+
+  CBLDart::LogRingBuffer buffer_;
+  CBLDart::LogRingBuffer breadcrumbs_;
+  std::atomic<int64_t> breadcrumbsWindow_ = 0;
+  std::atomic<uint32_t> breadcrumbsInWindow_ = 0;
+  std::atomic<uint64_t> rateLimitedBreadcrumbs_ = 0;
+  uint64_t reportedDroppedBreadcrumbs_ = 0;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::atomic<bool> wakeRequested_ = false;
+  uint64_t reportedDroppedCount_ = 0;
+};
+
+static void CBLDart_EnqueueDartLogMessage(CBLLogDomain domain,
+                                          CBLLogLevel level, FLString message) {
+  CBLDart_LogPipeline::instance().enqueue(domain, level, message);
+}
+
+static void CBLDart_EnqueueSentryBreadcrumb(CBLLogDomain domain,
+                                            CBLLogLevel level,
+                                            FLString message) {
+  CBLDart_LogPipeline::instance().enqueueBreadcrumb(domain, level, message);
 }
 
 static void CBLDart_LogCallbackFinalizer(void *context) {
@@ -270,7 +540,18 @@ bool CBLDart_CBLLog_SetCallback(CBLDart_AsyncCallback callback) {
 
 void CBLDart_CBLLog_SetCallbackLevel(CBLLogLevel level) {
   std::unique_lock lock(loggingMutex);
-  logCallbackLevel = level;
+  std::fill(std::begin(logCallbackLevels), std::end(logCallbackLevels), level);
+  CBLDart_UpdateEffectiveLogCallbackLevel();
+}
+
+void CBLDart_CBLLog_SetCallbackDomainLevel(CBLLogDomain domain,
+                                           CBLLogLevel level) {
+  if (domain >= kLogDomainCount) {
+    return;
+  }
+
+  std::unique_lock lock(loggingMutex);
+  logCallbackLevels[domain] = level;
   CBLDart_UpdateEffectiveLogCallbackLevel();
 }
 
@@ -402,6 +683,14 @@ bool CBLDart_CBLLog_SetSentryBreadcrumbs(bool enabled) {
   return true;
 }
 
+void CBLDart_CBLLog_ConfigureSentryBreadcrumbs(CBLLogLevel level,
+                                               uint32_t maxPerSecond) {
+  std::unique_lock lock(loggingMutex);
+  logSentryBreadcrumbsLevel = level;
+  logSentryBreadcrumbsMaxPerSecond = maxPerSecond;
+  CBLDart_UpdateEffectiveLogCallbackLevel();
+}
+
 // === Database
 
 /**
@@ -431,6 +720,18 @@ static bool CBLDart_UnregisterOpenDatabase(CBLDatabase *database) {
   return true;
 }
 
+/**
+ * Whether `database` has not been closed yet.
+ *
+ * The result stays valid while the database lock is held, because databases
+ * are closed under the lock.
+ */
+static bool CBLDart_IsDatabaseOpen(const CBLDatabase *database) {
+  std::scoped_lock lock(openDatabasesMutex);
+  return std::find(openDatabases.begin(), openDatabases.end(), database) !=
+         openDatabases.end();
+}
+
 bool CBLDart_CBLDatabase_Close(CBLDatabase *database, bool andDelete,
                                CBLError *errorOut) {
   if (!CBLDart_UnregisterOpenDatabase(database)) {
@@ -438,14 +739,44 @@ bool CBLDart_CBLDatabase_Close(CBLDatabase *database, bool andDelete,
     return true;
   }
 
+  CBLDart::QueryCache::instance().purge(database);
+  CBLDart::BlobCache::instance().purge(database);
+  CBLDart::DocumentCache::instance().purge(database);
+  CBLDart::ExpirationTracker::instance().purge(database);
+  CBLDart::DatabaseThreads::instance().purge(database);
+
   // We close the database under a lock to ensure that certain finalizers are
   // not running while the database is being closed.
-  auto databaseLock = CBLDart_AcquireDatabaseLock(database);
-  if (andDelete) {
-    return CBLDatabase_Delete(database, errorOut);
-  } else {
-    return CBLDatabase_Close(database, errorOut);
+  auto databaseLockRef = CBLDart_CloneDatabaseLock(database);
+  bool success;
+  {
+    auto databaseLock = databaseLockRef->acquire();
+    if (andDelete) {
+      success = CBLDatabase_Delete(database, errorOut);
+    } else {
+      success = CBLDatabase_Close(database, errorOut);
+    }
   }
+  databaseLockRef->release();
+  return success;
+}
+
+bool CBLDart_CBLDatabase_BeginTransaction(CBLDatabase *database,
+                                          CBLError *errorOut) {
+  auto &documentCache = CBLDart::DocumentCache::instance();
+  documentCache.beginTransaction(database);
+  if (!CBLDatabase_BeginTransaction(database, errorOut)) {
+    documentCache.endTransaction(database);
+    return false;
+  }
+  return true;
+}
+
+bool CBLDart_CBLDatabase_EndTransaction(CBLDatabase *database, bool commit,
+                                        CBLError *errorOut) {
+  auto success = CBLDatabase_EndTransaction(database, commit, errorOut);
+  CBLDart::DocumentCache::instance().endTransaction(database);
+  return success;
 }
 
 CBLDatabase *CBLDart_CBLDatabase_Open(FLString name,
@@ -478,148 +809,3181 @@ void CBLDart_CBLDatabase_Release(CBLDatabase *database) {
   CBLDatabase_Release(database);
 }
 
-// === Collection
+// === Shared Database
 
-static void CBLDart_CollectionDocumentChangeListenerWrapper(
-    void *context, const CBLDocumentChange *change) {
-  auto callback = ASYNC_CALLBACK_FROM_C(context);
+/**
+ * Serializes the transactions of the users of a shared database.
+ *
+ * All handles of a shared database use the same `CBLDatabase`, which has a
+ * single transaction. Without the gate, a transaction which is begun through
+ * one handle would join a transaction which is open through another handle
+ * and be committed or aborted together with it.
+ *
+ * The gate is entered by one owner at a time, which can enter it again for
+ * nested transactions. Other owners wait until the owner has exited its
+ * outermost transaction. Owners are identified by address and not by thread,
+ * since the transactions of a Dart isolate can span multiple threads.
+ */
+class CBLDart_TransactionGate {
+ public:
+  void enter(const void *owner) {
+    std::unique_lock lock(mutex_);
+    released_.wait(lock, [&] { return !owner_ || owner_ == owner; });
+    owner_ = owner;
+    depth_++;
+  }
 
-  Dart_CObject args{};
-  CBLDart_CObject_SetEmptyArray(&args);
+  void exit(const void *owner) {
+    std::scoped_lock lock(mutex_);
+    assert(owner_ == owner);
+    if (--depth_ == 0) {
+      owner_ = nullptr;
+      released_.notify_all();
+    }
+  }
 
-  CBLDart::AsyncCallbackCall(*callback).execute(args);
-}
+  /** Returns the number of nested transactions `owner` has entered. */
+  size_t depth(const void *owner) {
+    std::scoped_lock lock(mutex_);
+    return owner_ == owner ? depth_ : 0;
+  }
 
-void CBLDart_CBLCollection_AddDocumentChangeListener(
-    const CBLDatabase *db, const CBLCollection *collection,
-    const FLString docID, CBLDart_AsyncCallback listener) {
-  auto listenerToken = CBLCollection_AddDocumentChangeListener(
-      collection, docID, CBLDart_CollectionDocumentChangeListenerWrapper,
-      listener);
+ private:
+  std::mutex mutex_;
+  std::condition_variable released_;
+  const void *owner_ = nullptr;
+  size_t depth_ = 0;
+};
 
-  CBLDart_CloneDatabaseLock(db, listenerToken);
+/**
+ * Enters a transaction gate, if there is one, for the lifetime of the scope.
+ *
+ * Background operations must enter the gate before they acquire the database
+ * lock, since users of shared databases acquire the lock while their
+ * transaction is open.
+ */
+class CBLDart_TransactionGateScope {
+ public:
+  CBLDart_TransactionGateScope(CBLDart_TransactionGate *gate,
+                               const void *owner)
+      : gate_(gate), owner_(owner) {
+    if (gate_) {
+      gate_->enter(owner_);
+    }
+  }
 
-  ASYNC_CALLBACK_FROM_C(listener)->setFinalizer(listenerToken,
-                                                CBLDart_CBLListenerFinalizer);
-}
+  ~CBLDart_TransactionGateScope() {
+    if (gate_) {
+      gate_->exit(owner_);
+    }
+  }
 
-static void CBLDart_CollectionChangeListenerWrapper(
-    void *context, const CBLCollectionChange *change) {
-  auto callback = ASYNC_CALLBACK_FROM_C(context);
-  auto numDocs = change->numDocs;
-  auto docIDs = change->docIDs;
+  CBLDart_TransactionGateScope(const CBLDart_TransactionGateScope &) = delete;
+  CBLDart_TransactionGateScope &operator=(
+      const CBLDart_TransactionGateScope &) = delete;
 
-  std::vector<Dart_CObject> docIdObjects(numDocs);
+ private:
+  CBLDart_TransactionGate *gate_;
+  const void *owner_;
+};
 
-  for (size_t i = 0; i < numDocs; i++) {
-    CBLDart_CObject_SetFLString(&docIdObjects[i], docIDs[i]);
+/**
+ * Begins a transaction on `database` for `owner`, after entering `gate`, if
+ * the database is shared.
+ */
+static bool CBLDart_BeginGatedTransaction(CBLDatabase *database,
+                                          CBLDart_TransactionGate *gate,
+                                          const void *owner,
+                                          CBLError *errorOut) {
+  if (gate) {
+    gate->enter(owner);
+  }
+  if (!CBLDart_CBLDatabase_BeginTransaction(database, errorOut)) {
+    if (gate) {
+      gate->exit(owner);
+    }
+    return false;
   }
+  return true;
+}
 
-  auto docIdObjectsArray = docIdObjects.data();
+/**
+ * Ends a transaction which has been begun with
+ * `CBLDart_BeginGatedTransaction`.
+ */
+static bool CBLDart_EndGatedTransaction(CBLDatabase *database,
+                                        CBLDart_TransactionGate *gate,
+                                        const void *owner, bool commit,
+                                        CBLError *errorOut) {
+  auto success =
+      CBLDart_CBLDatabase_EndTransaction(database, commit, errorOut);
+  if (gate) {
+    gate->exit(owner);
+  }
+  return success;
+}
 
-  Dart_CObject args{};
-  args.type = Dart_CObject_kArray;
-  args.value.as_array.length = numDocs;
-  args.value.as_array.values = &docIdObjectsArray;
+/**
+ * A database which has been opened with `CBLDart_CBLDatabase_OpenShared`,
+ * together with the number of its handles which have not been closed yet.
+ */
+struct CBLDart_SharedDatabaseEntry {
+  CBLDatabase *database;
+  size_t openHandles;
+  std::shared_ptr<CBLDart_TransactionGate> transactionGate;
+#ifdef COUCHBASE_ENTERPRISE
+  CBLEncryptionKey encryptionKey;
+#endif
+};
 
-  CBLDart::AsyncCallbackCall(*callback).execute(args);
-}
+/** Identifies a shared database by its name and directory. */
+using CBLDart_SharedDatabaseKey = std::pair<std::string, std::string>;
 
-void CBLDart_CBLCollection_AddChangeListener(const CBLDatabase *db,
-                                             const CBLCollection *collection,
-                                             CBLDart_AsyncCallback listener) {
-  auto listenerToken = CBLCollection_AddChangeListener(
-      collection, CBLDart_CollectionChangeListenerWrapper, listener);
+/**
+ * The process-wide cache of shared databases.
+ *
+ * A database is removed from the cache once its last handle has been closed.
+ */
+static std::map<CBLDart_SharedDatabaseKey, CBLDart_SharedDatabaseEntry>
+    sharedDatabases;
+static std::mutex sharedDatabasesMutex;
 
-  CBLDart_CloneDatabaseLock(db, listenerToken);
+/**
+ * Returns the transaction gate of `database`, if it is shared, so that
+ * background operations, which begin their own transactions, don't join the
+ * transactions of the handles of the database.
+ */
+static std::shared_ptr<CBLDart_TransactionGate> CBLDart_TransactionGateOf(
+    const CBLDatabase *database) {
+  std::scoped_lock lock(sharedDatabasesMutex);
+  for (auto &[key, entry] : sharedDatabases) {
+    if (entry.database == database) {
+      return entry.transactionGate;
+    }
+  }
+  return nullptr;
+}
 
-  ASYNC_CALLBACK_FROM_C(listener)->setFinalizer(listenerToken,
-                                                CBLDart_CBLListenerFinalizer);
+#ifdef COUCHBASE_ENTERPRISE
+static bool CBLDart_EncryptionKeysEqual(const CBLEncryptionKey &a,
+                                        const CBLEncryptionKey &b) {
+  return a.algorithm == b.algorithm &&
+         (a.algorithm == kCBLEncryptionNone ||
+          std::memcmp(a.bytes, b.bytes, sizeof(a.bytes)) == 0);
 }
+#endif
 
-bool CBLDart_CBLCollection_CreateIndex(CBLCollection *collection, FLString name,
-                                       CBLDart_CBLIndexSpec indexSpec,
-                                       CBLError *errorOut) {
-  switch (indexSpec.type) {
-    case kCBLDart_IndexTypeValue: {
-      CBLValueIndexConfiguration config{};
-      config.expressionLanguage = indexSpec.expressionLanguage;
-      config.expressions = indexSpec.expressions;
+struct CBLDart_SharedDatabase {
+  CBLDart_SharedDatabaseKey key;
+  CBLDatabase *database;
+  std::shared_ptr<CBLDart_TransactionGate> transactionGate;
+  bool closed = false;
+};
 
-      return CBLCollection_CreateValueIndex(collection, name, config, errorOut);
+CBLDart_SharedDatabase *CBLDart_CBLDatabase_OpenShared(
+    FLString name, CBLDatabaseConfiguration *config, CBLError *errorOut) {
+  auto config_ = config ? *config : CBLDatabaseConfiguration_Default();
+  CBLDart_SharedDatabaseKey key{
+      std::string(static_cast<const char *>(name.buf), name.size),
+      std::string(static_cast<const char *>(config_.directory.buf),
+                  config_.directory.size)};
+
+  std::scoped_lock lock(sharedDatabasesMutex);
+
+  auto it = sharedDatabases.find(key);
+  if (it == sharedDatabases.end()) {
+    auto database = CBLDart_CBLDatabase_Open(name, &config_, errorOut);
+    if (!database) {
+      return nullptr;
     }
-    case kCBLDart_IndexTypeFullText: {
+    CBLDart_SharedDatabaseEntry entry{
+        database, 0, std::make_shared<CBLDart_TransactionGate>()};
+#ifdef COUCHBASE_ENTERPRISE
+    entry.encryptionKey = config_.encryptionKey;
+#endif
+    it = sharedDatabases.emplace(key, std::move(entry)).first;
+  } else {
+#ifdef COUCHBASE_ENTERPRISE
+    // The database cannot be opened with a different key, while it is open.
+    if (!CBLDart_EncryptionKeysEqual(it->second.encryptionKey,
+                                     config_.encryptionKey)) {
+      *errorOut = {kCBLDomain, kCBLErrorInvalidParameter, 0};
+      return nullptr;
     }
-      CBLFullTextIndexConfiguration config{};
-      config.expressionLanguage = indexSpec.expressionLanguage;
-      config.expressions = indexSpec.expressions;
-      config.ignoreAccents = static_cast<bool>(indexSpec.ignoreAccents);
-      config.language = indexSpec.language;
-
-      return CBLCollection_CreateFullTextIndex(collection, name, config,
-                                               errorOut);
+#endif
+    // Each handle holds its own reference to the database, so that it stays
+    // valid until the last handle has been released.
+    CBLDatabase_Retain(it->second.database);
   }
 
-  // Is never reached, but stops the compiler warnings.
-  return 0;
+  it->second.openHandles++;
+  return new CBLDart_SharedDatabase{key, it->second.database,
+                                    it->second.transactionGate};
 }
 
-// === Query
+CBLDatabase *CBLDart_SharedDatabase_Database(CBLDart_SharedDatabase *handle) {
+  return handle->database;
+}
 
-static void CBLDart_QueryChangeListenerWrapper(void *context, CBLQuery *query,
-                                               CBLListenerToken *token) {
-  auto callback = ASYNC_CALLBACK_FROM_C(context);
+bool CBLDart_SharedDatabase_Close(CBLDart_SharedDatabase *handle,
+                                  bool andDelete, CBLError *errorOut) {
+  CBLDatabase *databaseToClose = nullptr;
+  {
+    std::scoped_lock lock(sharedDatabasesMutex);
+    if (handle->closed) {
+      // Return early since the handle has already been closed.
+      return true;
+    }
 
-  Dart_CObject args{};
-  CBLDart_CObject_SetEmptyArray(&args);
+    auto &entry = sharedDatabases.at(handle->key);
+    if (andDelete && entry.openHandles > 1) {
+      // The database is still in use through other handles.
+      *errorOut = {kCBLDomain, kCBLErrorBusy};
+      return false;
+    }
 
-  CBLDart::AsyncCallbackCall(*callback).execute(args);
-}
+    handle->closed = true;
+    if (--entry.openHandles == 0) {
+      databaseToClose = entry.database;
+      sharedDatabases.erase(handle->key);
+    }
+  }
 
-CBLListenerToken *CBLDart_CBLQuery_AddChangeListener(
-    const CBLDatabase *db, CBLQuery *query, CBLDart_AsyncCallback listener) {
-  auto listenerToken = CBLQuery_AddChangeListener(
-      query, CBLDart_QueryChangeListenerWrapper, listener);
+  // Abort the transactions which the handle has left open, for example
+  // because its isolate has exited, so that other handles can proceed.
+  for (auto depth = handle->transactionGate->depth(handle); depth > 0;
+       depth--) {
+    CBLError error;
+    CBLDart_EndGatedTransaction(handle->database,
+                                handle->transactionGate.get(), handle, false,
+                                &error);
+  }
 
-  CBLDart_CloneDatabaseLock(db, listenerToken);
+  if (!databaseToClose) {
+    return true;
+  }
 
-  ASYNC_CALLBACK_FROM_C(listener)->setFinalizer(listenerToken,
-                                                CBLDart_CBLListenerFinalizer);
+  auto success =
+      CBLDart_CBLDatabase_Close(databaseToClose, andDelete, errorOut);
+  CBLDart_ReleaseDatabaseLock(databaseToClose);
+  return success;
+}
+
+void CBLDart_SharedDatabase_Release(CBLDart_SharedDatabase *handle) {
+  CBLError error;
+  if (!CBLDart_SharedDatabase_Close(handle, false, &error)) {
+    auto errorMessage = CBLError_Message(&error);
+    CBL_Log(kCBLLogDomainDatabase, kCBLLogError,
+            "Error closing shared database %p in Dart finalizer: %*.s",
+            handle->database, static_cast<int>(errorMessage.size),
+            (char *)errorMessage.buf);
+    FLSliceResult_Release(errorMessage);
+  }
+  CBLDatabase_Release(handle->database);
+  delete handle;
+}
+
+bool CBLDart_SharedDatabase_BeginTransaction(CBLDart_SharedDatabase *handle,
+                                             CBLError *errorOut) {
+  return CBLDart_BeginGatedTransaction(
+      handle->database, handle->transactionGate.get(), handle, errorOut);
+}
+
+bool CBLDart_SharedDatabase_EndTransaction(CBLDart_SharedDatabase *handle,
+                                           bool commit, CBLError *errorOut) {
+  return CBLDart_EndGatedTransaction(handle->database,
+                                     handle->transactionGate.get(), handle,
+                                     commit, errorOut);
+}
+
+// === Maintenance Scheduler
+
+void CBLDart_CBLDatabase_ScheduleMaintenance(const CBLDatabase *db,
+                                             uint32_t types,
+                                             uint64_t intervalMs,
+                                             uint64_t idleMs,
+                                             CBLDart_AsyncCallback callback) {
+  CBLDart::MaintenanceScheduler::schedule(db, types, intervalMs, idleMs,
+                                          ASYNC_CALLBACK_FROM_C(callback));
+}
+
+// === Collection
+
+struct CBLDart_DocumentWatchContext {
+  std::shared_ptr<CBLDart::DocumentWatcher::Watch> watch;
+  CBLDart_DatabaseLock *databaseLock;
+};
+
+static void CBLDart_DocumentWatchFinalizer(void *context) {
+  auto watchContext = reinterpret_cast<CBLDart_DocumentWatchContext *>(context);
+  {
+    // We acquire the database lock here to ensure that the database is not
+    // closed while the watch is removed.
+    auto databaseLock = watchContext->databaseLock->acquire();
+    CBLDart::DocumentWatcher::removeWatch(watchContext->watch);
+  }
+  watchContext->databaseLock->release();
+  delete watchContext;
+}
+
+void CBLDart_CBLCollection_AddDocumentChangeListener(
+    const CBLDatabase *db, const CBLCollection *collection,
+    const FLString docID, uint32_t debounceMilliseconds,
+    CBLDart_AsyncCallback listener) {
+  auto callback = ASYNC_CALLBACK_FROM_C(listener);
+  auto watch = CBLDart::DocumentWatcher::addWatch(
+      collection, docID, callback,
+      std::chrono::milliseconds(debounceMilliseconds));
+
+  auto watchContext =
+      new CBLDart_DocumentWatchContext{watch, CBLDart_CloneDatabaseLock(db)};
+  callback->setFinalizer(watchContext, CBLDart_DocumentWatchFinalizer);
+}
+
+static void CBLDart_CollectionChangeListenerWrapper(
+    void *context, const CBLCollectionChange *change) {
+  CBLDart::Stats::instance.listenerInvoked();
+  CBLDart::TimelineSpan span("CBLDart CollectionChangeListener");
+  auto callback = ASYNC_CALLBACK_FROM_C(context);
+
+  // The ids are sent packed into a single buffer, instead of as one object
+  // per id, so that large changes don't require an allocation per id.
+  CBLDart::MessageArena::Scope arenaScope;
+  Dart_CObject docIDs;
+  CBLDart_CObject_SetPackedStrings(&docIDs, change->docIDs, change->numDocs,
+                                   arenaScope.arena());
+
+  Dart_CObject *argsValues[] = {&docIDs};
+
+  Dart_CObject args{};
+  args.type = Dart_CObject_kArray;
+  args.value.as_array.length = 1;
+  args.value.as_array.values = argsValues;
+
+  CBLDart::AsyncCallbackCall(*callback).execute(args);
+}
+
+bool CBLDart_CBLCollection_GetDocuments(const CBLCollection *collection,
+                                        const FLString *docIDs, size_t count,
+                                        const CBLDocument **documentsOut,
+                                        CBLError *errorOut) {
+  auto &documentCache = CBLDart::DocumentCache::instance();
+  for (size_t i = 0; i < count; i++) {
+    CBLError error{};
+    documentsOut[i] = documentCache.getDocument(collection, docIDs[i], &error);
+    if (!documentsOut[i] && error.code != 0) {
+      for (size_t j = 0; j < i; j++) {
+        CBLDocument_Release(documentsOut[j]);
+        documentsOut[j] = nullptr;
+      }
+      *errorOut = error;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CBLDart_CBLCollection_SaveDocuments(
+    CBLCollection *collection, CBLDocument **documents, size_t count,
+    CBLConcurrencyControl concurrencyControl, uint8_t *resultsOut,
+    CBLError *errorOut) {
+  auto database = CBLCollection_Database(collection);
+  if (!CBLDart_CBLDatabase_BeginTransaction(database, errorOut)) {
+    return false;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    CBLError error{};
+    if (CBLCollection_SaveDocumentWithConcurrencyControl(
+            collection, documents[i], concurrencyControl, &error)) {
+      resultsOut[i] = 1;
+    } else if (error.domain == kCBLDomain && error.code == kCBLErrorConflict) {
+      resultsOut[i] = 0;
+    } else {
+      *errorOut = error;
+      CBLDart_CBLDatabase_EndTransaction(database, false, &error);
+      return false;
+    }
+  }
+
+  return CBLDart_CBLDatabase_EndTransaction(database, true, errorOut);
+}
+
+bool CBLDart_CBLCollection_SetDocumentExpirations(
+    CBLCollection *collection, const FLString *docIDs,
+    const CBLTimestamp *expirations, size_t count, CBLError *errorOut) {
+  auto database = CBLCollection_Database(collection);
+  if (!CBLDart_CBLDatabase_BeginTransaction(database, errorOut)) {
+    return false;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    if (!CBLCollection_SetDocumentExpiration(collection, docIDs[i],
+                                             expirations[i], errorOut)) {
+      CBLError error{};
+      CBLDart_CBLDatabase_EndTransaction(database, false, &error);
+      return false;
+    }
+  }
+
+  if (!CBLDart_CBLDatabase_EndTransaction(database, true, errorOut)) {
+    return false;
+  }
+
+  CBLDart::ExpirationTracker::instance().track(collection, docIDs, expirations,
+                                               count);
+  return true;
+}
+
+bool CBLDart_CBLCollection_SetDocumentExpiration(CBLCollection *collection,
+                                                 FLString docID,
+                                                 CBLTimestamp expiration,
+                                                 CBLError *errorOut) {
+  if (!CBLCollection_SetDocumentExpiration(collection, docID, expiration,
+                                           errorOut)) {
+    return false;
+  }
+
+  CBLDart::ExpirationTracker::instance().track(collection, &docID, &expiration,
+                                               1);
+  return true;
+}
+
+CBLDart_ExpirationStats CBLDart_CBLCollection_ExpirationStats(
+    const CBLCollection *collection) {
+  return CBLDart::ExpirationTracker::instance().stats(collection);
+}
+
+/**
+ * Merges `patch` into `target`, according to the JSON merge patch algorithm
+ * (RFC 7386).
+ */
+static void CBLDart_MergePatch(FLMutableDict target, FLDict patch) {
+  FLDictIterator iterator;
+  FLDictIterator_Begin(patch, &iterator);
+  FLValue value;
+  while ((value = FLDictIterator_GetValue(&iterator))) {
+    auto key = FLDictIterator_GetKeyString(&iterator);
+
+    switch (FLValue_GetType(value)) {
+      case kFLNull:
+        FLMutableDict_Remove(target, key);
+        break;
+      case kFLDict: {
+        auto nestedTarget = FLMutableDict_GetMutableDict(target, key);
+        if (nestedTarget) {
+          CBLDart_MergePatch(nestedTarget, FLValue_AsDict(value));
+        } else {
+          // A dict replaces any value which is not a dict, but is still
+          // merged, so that its null values are removed.
+          auto newTarget = FLMutableDict_New();
+          CBLDart_MergePatch(newTarget, FLValue_AsDict(value));
+          FLMutableDict_SetDict(target, key, newTarget);
+          FLMutableDict_Release(newTarget);
+        }
+        break;
+      }
+      default:
+        FLMutableDict_SetValue(target, key, value);
+        break;
+    }
+
+    FLDictIterator_Next(&iterator);
+  }
+}
+
+bool CBLDart_CBLCollection_PatchDocument(
+    CBLCollection *collection, FLString docID, FLSlice patch,
+    CBLConcurrencyControl concurrencyControl, CBLError *errorOut) {
+  auto patchDict = FLValue_AsDict(FLValue_FromData(patch, kFLUntrusted));
+  if (!patchDict) {
+    *errorOut = {kCBLDomain, kCBLErrorInvalidParameter, 0};
+    return false;
+  }
+
+  auto database = CBLCollection_Database(collection);
+  if (!CBLDart_CBLDatabase_BeginTransaction(database, errorOut)) {
+    return false;
+  }
+
+  CBLError error{};
+  auto document = CBLCollection_GetMutableDocument(collection, docID, &error);
+  if (!document && error.code != 0) {
+    *errorOut = error;
+    CBLDart_CBLDatabase_EndTransaction(database, false, &error);
+    return false;
+  }
+  if (!document) {
+    document = CBLDocument_CreateWithID(docID);
+  }
+
+  CBLDart_MergePatch(CBLDocument_MutableProperties(document), patchDict);
+
+  auto saved = CBLCollection_SaveDocumentWithConcurrencyControl(
+      collection, document, concurrencyControl, errorOut);
+  CBLDocument_Release(document);
+
+  if (!saved) {
+    CBLDart_CBLDatabase_EndTransaction(database, false, &error);
+    return false;
+  }
+
+  return CBLDart_CBLDatabase_EndTransaction(database, true, errorOut);
+}
+
+void CBLDart_CBLCollection_AddChangeListener(const CBLDatabase *db,
+                                             const CBLCollection *collection,
+                                             CBLDart_AsyncCallback listener) {
+  auto listenerToken = CBLCollection_AddChangeListener(
+      collection, CBLDart_CollectionChangeListenerWrapper, listener);
+
+  CBLDart_SetListenerFinalizer(db, listenerToken, listener);
+}
+
+const CBLDocument *CBLDart_CBLCollection_GetDocument(
+    const CBLCollection *collection, FLString docID, CBLError *errorOut) {
+  return CBLDart::DocumentCache::instance().getDocument(collection, docID,
+                                                        errorOut);
+}
+
+void CBLDart_DocumentCache_SetLimits(size_t maxCount, size_t maxSize) {
+  CBLDart::DocumentCache::instance().setLimits(maxCount, maxSize);
+}
+
+CBLDart_DocumentCacheStats CBLDart_DocumentCache_Stats(void) {
+  return CBLDart::DocumentCache::instance().stats();
+}
+
+#define CHANGE_CURSOR_FROM_C(cursor) \
+  reinterpret_cast<CBLDart::ChangeCursor *>(cursor)
+
+#define CHANGE_CURSOR_TO_C(cursor) \
+  reinterpret_cast<CBLDart_ChangeCursor>(cursor)
+
+CBLDart_ChangeCursor CBLDart_CBLCollection_NewChangeCursor(
+    const CBLCollection *collection, uint64_t sequence) {
+  return CHANGE_CURSOR_TO_C(new CBLDart::ChangeCursor(collection, sequence));
+}
+
+FLSliceResult CBLDart_ChangeCursor_Next(CBLDart_ChangeCursor cursor,
+                                        uint32_t maxCount, CBLError *errorOut) {
+  return CHANGE_CURSOR_FROM_C(cursor)->next(maxCount, errorOut);
+}
+
+void CBLDart_ChangeCursor_Release(CBLDart_ChangeCursor cursor) {
+  delete CHANGE_CURSOR_FROM_C(cursor);
+}
+
+bool CBLDart_CBLCollection_CreateIndex(CBLCollection *collection, FLString name,
+                                       CBLDart_CBLIndexSpec indexSpec,
+                                       CBLError *errorOut) {
+  switch (indexSpec.type) {
+    case kCBLDart_IndexTypeValue: {
+      CBLValueIndexConfiguration config{};
+      config.expressionLanguage = indexSpec.expressionLanguage;
+      config.expressions = indexSpec.expressions;
+
+      return CBLCollection_CreateValueIndex(collection, name, config, errorOut);
+    }
+    case kCBLDart_IndexTypeFullText: {
+      CBLFullTextIndexConfiguration config{};
+      config.expressionLanguage = indexSpec.expressionLanguage;
+      config.expressions = indexSpec.expressions;
+      config.ignoreAccents = static_cast<bool>(indexSpec.ignoreAccents);
+      config.language = indexSpec.language;
+
+      return CBLCollection_CreateFullTextIndex(collection, name, config,
+                                               errorOut);
+    }
+    case kCBLDart_IndexTypeArray: {
+      CBLArrayIndexConfiguration config{};
+      config.expressionLanguage = indexSpec.expressionLanguage;
+      config.path = indexSpec.path;
+      config.expressions = indexSpec.expressions;
+
+      return CBLCollection_CreateArrayIndex(collection, name, config, errorOut);
+    }
+    case kCBLDart_IndexTypeVector: {
+#ifdef COUCHBASE_ENTERPRISE
+      CBLVectorEncoding *encoding = nullptr;
+      switch (indexSpec.encodingType) {
+        case kCBLDart_VectorEncodingTypeNone:
+          encoding = CBLVectorEncoding_CreateNone();
+          break;
+        case kCBLDart_VectorEncodingTypeScalarQuantizer:
+          encoding = CBLVectorEncoding_CreateScalarQuantizer(
+              static_cast<CBLScalarQuantizerType>(
+                  indexSpec.scalarQuantizerType));
+          break;
+        case kCBLDart_VectorEncodingTypeProductQuantizer:
+          encoding = CBLVectorEncoding_CreateProductQuantizer(
+              indexSpec.subquantizers, indexSpec.bits);
+          break;
+      }
+
+      CBLVectorIndexConfiguration config{};
+      config.expressionLanguage = indexSpec.expressionLanguage;
+      config.expression = indexSpec.expressions;
+      config.dimensions = indexSpec.dimensions;
+      config.centroids = indexSpec.centroids;
+      config.encoding = encoding;
+      config.metric = static_cast<CBLDistanceMetric>(indexSpec.metric);
+      config.minTrainingSize = indexSpec.minTrainingSize;
+      config.maxTrainingSize = indexSpec.maxTrainingSize;
+      config.numProbes = indexSpec.numProbes;
+
+      auto result =
+          CBLCollection_CreateVectorIndex(collection, name, config, errorOut);
+      CBLVectorEncoding_Free(encoding);
+      return result;
+#else
+      *errorOut = {kCBLDomain, kCBLErrorUnsupported};
+      return false;
+#endif
+    }
+  }
+
+  // Is never reached, but stops the compiler warnings.
+  return 0;
+}
+
+/**
+ * The state of an index build, which is shared between the background thread
+ * that builds the index and the callback of the build.
+ *
+ * The thread is one of the `DatabaseThreads` of the database, so that the
+ * database lock is not held while the index is built. When the database is
+ * closed, a build which has not started yet is skipped and a running build
+ * is waited for.
+ */
+struct CBLDart_IndexBuilder {
+  CBLDart_IndexBuilder(const CBLDatabase *database, CBLCollection *collection,
+                       FLString name, CBLDart_CBLIndexSpec indexSpec,
+                       CBLDart_AsyncCallback callback)
+      : database_(
+            CBLDatabase_Retain(const_cast<CBLDatabase *>(database))),
+        collection_(CBLCollection_Retain(collection)),
+        name_(CBLDart_FLStringToString(name)),
+        indexSpec_(indexSpec),
+        expressions_(CBLDart_FLStringToString(indexSpec.expressions)),
+        language_(CBLDart_FLStringToString(indexSpec.language)),
+        path_(CBLDart_FLStringToString(indexSpec.path)),
+        callback_(ASYNC_CALLBACK_FROM_C(callback)) {
+    // The strings of the spec are owned by the caller, so the spec refers to
+    // copies instead. Null strings stay null.
+    if (indexSpec.expressions.buf) {
+      indexSpec_.expressions = {expressions_.data(), expressions_.size()};
+    }
+    if (indexSpec.language.buf) {
+      indexSpec_.language = {language_.data(), language_.size()};
+    }
+    if (indexSpec.path.buf) {
+      indexSpec_.path = {path_.data(), path_.size()};
+    }
+  }
+
+  ~CBLDart_IndexBuilder() {
+    CBLCollection_Release(collection_);
+    CBLDatabase_Release(database_);
+  }
+
+  void cancel() {
+    std::scoped_lock lock(mutex_);
+    cancelled_ = true;
+  }
+
+  /**
+   * Skips the build if it has not started yet, because the database is being
+   * closed.
+   */
+  void stop() {
+    std::scoped_lock lock(mutex_);
+    stopped_ = true;
+  }
+
+  /**
+   * Must be called when the callback has been closed, after which it must not
+   * be called anymore.
+   */
+  void callbackClosed() {
+    std::scoped_lock lock(mutex_);
+    callbackClosed_ = true;
+    cancelled_ = true;
+  }
+
+  void run() {
+    auto created = false;
+    CBLError error{};
+    if (!isCancelled() && !isStopped()) {
+      sendMessage(false, false, error);
+
+      FLString name{name_.data(), name_.size()};
+      auto existed = indexExists(name);
+      created = CBLDart_CBLCollection_CreateIndex(collection_, name,
+                                                  indexSpec_, &error);
+      if (created && !existed && isCancelled()) {
+        CBLError deleteError;
+        CBLCollection_DeleteIndex(collection_, name, &deleteError);
+        created = false;
+      }
+    }
+
+    sendMessage(true, created, error);
+  }
+
+ private:
+  bool isCancelled() {
+    std::scoped_lock lock(mutex_);
+    return cancelled_;
+  }
+
+  bool isStopped() {
+    std::scoped_lock lock(mutex_);
+    return stopped_;
+  }
+
+  bool indexExists(FLString name) {
+    CBLError error{};
+    auto names = CBLCollection_GetIndexNames(collection_, &error);
+    if (!names) {
+      return false;
+    }
+
+    auto exists = false;
+    for (uint32_t i = 0, count = FLArray_Count(names); i < count; i++) {
+      if (FLSlice_Equal(FLValue_AsString(FLArray_Get(names, i)), name)) {
+        exists = true;
+        break;
+      }
+    }
+    FLMutableArray_Release(names);
+    return exists;
+  }
+
+  void sendMessage(bool isDone, bool created, CBLError error) {
+    auto hasError = isDone && error.code != 0;
+
+    FLSliceResult errorMessage{};
+    if (hasError) {
+      errorMessage = CBLError_Message(&error);
+    }
+
+    Dart_CObject isDone_{};
+    isDone_.type = Dart_CObject_kBool;
+    isDone_.value.as_bool = isDone;
+
+    Dart_CObject created_{};
+    created_.type = Dart_CObject_kBool;
+    created_.value.as_bool = created;
+
+    Dart_CObject errorDomain{};
+    errorDomain.type = Dart_CObject_kInt32;
+    errorDomain.value.as_int32 = error.domain;
+
+    Dart_CObject errorCode{};
+    errorCode.type = Dart_CObject_kInt32;
+    errorCode.value.as_int32 = error.code;
+
+    Dart_CObject errorMessage_{};
+    CBLDart_CObject_SetFLString(&errorMessage_,
+                                static_cast<FLString>(errorMessage));
+
+    Dart_CObject *argsValues[] = {&isDone_, &created_, &errorDomain,
+                                  &errorCode, &errorMessage_};
+
+    Dart_CObject args{};
+    args.type = Dart_CObject_kArray;
+    args.value.as_array.length = hasError ? 5 : isDone ? 2 : 1;
+    args.value.as_array.values = argsValues;
+
+    {
+      std::scoped_lock lock(mutex_);
+      if (!callbackClosed_) {
+        CBLDart::AsyncCallbackCall(*callback_).execute(args);
+      }
+    }
+
+    FLSliceResult_Release(errorMessage);
+  }
+
+  CBLDatabase *database_;
+  CBLCollection *collection_;
+  std::string name_;
+  CBLDart_CBLIndexSpec indexSpec_;
+  std::string expressions_;
+  std::string language_;
+  std::string path_;
+  CBLDart::AsyncCallback *callback_;
+
+  std::mutex mutex_;
+  bool cancelled_ = false;
+  bool stopped_ = false;
+  bool callbackClosed_ = false;
+};
+
+// The callback owns a reference to the builder, which is released when the
+// callback is closed.
+static void CBLDart_IndexBuilderCallbackFinalizer(void *context) {
+  auto builder =
+      reinterpret_cast<std::shared_ptr<CBLDart_IndexBuilder> *>(context);
+  (*builder)->callbackClosed();
+  delete builder;
+}
+
+CBLDart_IndexBuilder *CBLDart_CBLCollection_BuildIndex(
+    const CBLDatabase *db, CBLCollection *collection, FLString name,
+    CBLDart_CBLIndexSpec indexSpec, CBLDart_AsyncCallback callback) {
+  auto builder = std::make_shared<CBLDart_IndexBuilder>(
+      db, collection, name, indexSpec, callback);
+
+  ASYNC_CALLBACK_FROM_C(callback)->setFinalizer(
+      new std::shared_ptr<CBLDart_IndexBuilder>(builder),
+      CBLDart_IndexBuilderCallbackFinalizer);
+
+  CBLDart::DatabaseThreads::instance().start(
+      db, [builder] { builder->run(); }, [builder] { builder->stop(); });
+
+  return builder.get();
+}
+
+void CBLDart_IndexBuilder_Cancel(CBLDart_IndexBuilder *builder) {
+  builder->cancel();
+}
+
+// The size of the chunks in which files are read by JSON lines importers.
+static const size_t kJSONLinesFileChunkSize = 64 * 1024;
+
+/**
+ * The state of a JSON lines import, which is shared between the background
+ * thread that runs the import and the callback of the import.
+ *
+ * The database and collection are accessed from the background thread, which
+ * is safe because CBL C serializes access to a database internally. The
+ * database level lock is held while a batch is saved, so that the database is
+ * not closed in the middle of a transaction.
+ */
+struct CBLDart_JSONLinesImporter {
+  CBLDart_JSONLinesImporter(const CBLDatabase *database,
+                            CBLCollection *collection, FLKeyPath idKeyPath,
+                            uint32_t batchSize, CBLDart_AsyncCallback callback)
+      : database_(
+            CBLDatabase_Retain(const_cast<CBLDatabase *>(database))),
+        collection_(CBLCollection_Retain(collection)),
+        idKeyPath_(idKeyPath),
+        batchSize_(batchSize),
+        callback_(ASYNC_CALLBACK_FROM_C(callback)),
+        databaseLock_(CBLDart_CloneDatabaseLock(database)),
+        transactionGate_(CBLDart_TransactionGateOf(database)) {}
+
+  ~CBLDart_JSONLinesImporter() {
+    releaseBatch();
+    FLKeyPath_Free(idKeyPath_);
+    CBLCollection_Release(collection_);
+    CBLDatabase_Release(database_);
+    databaseLock_->release();
+  }
+
+  void addInput(bool isFile, std::string data) {
+    std::scoped_lock lock(mutex_);
+    assert(!finished_);
+    inputs_.push_back({isFile, std::move(data)});
+    cv_.notify_one();
+  }
+
+  void finish(bool cancel) {
+    std::scoped_lock lock(mutex_);
+    finished_ = true;
+    cancelled_ = cancelled_ || cancel;
+    cv_.notify_one();
+  }
+
+  /**
+   * Must be called when the callback has been closed, after which it must not
+   * be called anymore.
+   */
+  void callbackClosed() {
+    std::scoped_lock lock(mutex_);
+    callbackClosed_ = true;
+    finished_ = true;
+    cancelled_ = true;
+    cv_.notify_one();
+  }
+
+  void run() {
+    auto ok = true;
+    while (ok) {
+      Input input;
+      {
+        std::unique_lock lock(mutex_);
+        cv_.wait(lock, [this] { return !inputs_.empty() || finished_; });
+        if (cancelled_ || inputs_.empty()) {
+          break;
+        }
+        input = std::move(inputs_.front());
+        inputs_.pop_front();
+      }
+
+      ok = input.isFile ? importFile(input.data) : importChunk(input.data);
+      consumedInputCount_++;
+      sendMessage(false);
+    }
+
+    if (ok && !isCancelled()) {
+      // The last line does not have to end with a new line.
+      ok = importLine(line_) && saveBatch();
+    }
+
+    sendMessage(true);
+  }
+
+ private:
+  struct Input {
+    bool isFile;
+    std::string data;
+  };
+
+  bool isCancelled() {
+    std::scoped_lock lock(mutex_);
+    return cancelled_;
+  }
+
+  bool importFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      error_ = {kCBLPOSIXDomain, errno, 0};
+      return false;
+    }
+
+    std::string chunk(kJSONLinesFileChunkSize, '\0');
+    while (file) {
+      file.read(chunk.data(), chunk.size());
+      auto size = static_cast<size_t>(file.gcount());
+      if (!importChunk(std::string_view(chunk.data(), size))) {
+        return false;
+      }
+      if (isCancelled()) {
+        return true;
+      }
+    }
+
+    if (file.bad()) {
+      error_ = {kCBLPOSIXDomain, errno, 0};
+      return false;
+    }
+
+    return true;
+  }
+
+  bool importChunk(std::string_view chunk) {
+    size_t start = 0;
+    while (start < chunk.size()) {
+      auto end = chunk.find('\n', start);
+      if (end == std::string_view::npos) {
+        line_.append(chunk.substr(start));
+        break;
+      }
+
+      auto line = chunk.substr(start, end - start);
+      if (!line_.empty()) {
+        // The line started in a previous chunk.
+        line_.append(line);
+        line = line_;
+      }
+      if (!importLine(line)) {
+        return false;
+      }
+      line_.clear();
+      start = end + 1;
+    }
+
+    return true;
+  }
+
+  bool importLine(std::string_view line) {
+    // Skip empty lines, including lines which only contain a carriage return.
+    if (line.find_first_not_of(" \t\r") == std::string_view::npos) {
+      return true;
+    }
+
+    FLError flError;
+    auto json = FLDoc_FromJSON({line.data(), line.size()}, &flError);
+    if (!json) {
+      error_ = {kCBLFleeceDomain, static_cast<int>(flError), 0};
+      return false;
+    }
+
+    auto root = FLDoc_GetRoot(json);
+    auto dict = FLValue_AsDict(root);
+    if (!dict) {
+      FLDoc_Release(json);
+      error_ = {kCBLDomain, kCBLErrorInvalidParameter, 0};
+      return false;
+    }
+
+    FLString id{};
+    if (idKeyPath_) {
+      id = FLValue_AsString(FLKeyPath_Eval(idKeyPath_, root));
+    }
+
+    auto document =
+        id.buf ? CBLDocument_CreateWithID(id) : CBLDocument_Create();
+    auto properties = FLDict_MutableCopy(dict, kFLDeepCopyImmutables);
+    CBLDocument_SetProperties(document, properties);
+    FLMutableDict_Release(properties);
+    FLDoc_Release(json);
+
+    batch_.push_back(document);
+    if (batch_.size() == batchSize_) {
+      return saveBatch();
+    }
+
+    return true;
+  }
+
+  bool saveBatch() {
+    if (batch_.empty()) {
+      return true;
+    }
+
+    auto ok = false;
+    {
+      CBLDart_TransactionGateScope gate(transactionGate_.get(), this);
+      auto databaseLock = databaseLock_->acquire();
+      if (CBLDart_CBLDatabase_BeginTransaction(database_, &error_)) {
+        ok = true;
+        for (auto document : batch_) {
+          if (!CBLCollection_SaveDocument(collection_, document, &error_)) {
+            ok = false;
+            break;
+          }
+        }
+
+        CBLError endError;
+        if (!CBLDart_CBLDatabase_EndTransaction(database_, ok, &endError) &&
+            ok) {
+          error_ = endError;
+          ok = false;
+        }
+      }
+    }
+
+    if (ok) {
+      importedCount_ += batch_.size();
+    }
+    releaseBatch();
+    sendMessage(false);
+
+    return ok;
+  }
+
+  void releaseBatch() {
+    for (auto document : batch_) {
+      CBLDocument_Release(document);
+    }
+    batch_.clear();
+  }
+
+  void sendMessage(bool isDone) {
+    auto hasError = isDone && error_.code != 0;
+
+    FLSliceResult errorMessage{};
+    if (hasError) {
+      errorMessage = CBLError_Message(&error_);
+    }
+
+    Dart_CObject isDone_{};
+    isDone_.type = Dart_CObject_kBool;
+    isDone_.value.as_bool = isDone;
+
+    Dart_CObject importedCount{};
+    importedCount.type = Dart_CObject_kInt64;
+    importedCount.value.as_int64 = static_cast<int64_t>(importedCount_);
+
+    Dart_CObject consumedInputCount{};
+    consumedInputCount.type = Dart_CObject_kInt64;
+    consumedInputCount.value.as_int64 =
+        static_cast<int64_t>(consumedInputCount_);
+
+    Dart_CObject errorDomain{};
+    errorDomain.type = Dart_CObject_kInt32;
+    errorDomain.value.as_int32 = error_.domain;
+
+    Dart_CObject errorCode{};
+    errorCode.type = Dart_CObject_kInt32;
+    errorCode.value.as_int32 = error_.code;
+
+    Dart_CObject errorMessage_{};
+    CBLDart_CObject_SetFLString(&errorMessage_,
+                                static_cast<FLString>(errorMessage));
+
+    Dart_CObject *argsValues[] = {&isDone_,     &importedCount,
+                                  &consumedInputCount, &errorDomain,
+                                  &errorCode,   &errorMessage_};
+
+    Dart_CObject args{};
+    args.type = Dart_CObject_kArray;
+    args.value.as_array.length = hasError ? 6 : 3;
+    args.value.as_array.values = argsValues;
+
+    {
+      std::scoped_lock lock(mutex_);
+      if (!callbackClosed_) {
+        CBLDart::AsyncCallbackCall(*callback_).execute(args);
+      }
+    }
+
+    FLSliceResult_Release(errorMessage);
+  }
+
+  CBLDatabase *database_;
+  CBLCollection *collection_;
+  FLKeyPath idKeyPath_;
+  size_t batchSize_;
+  CBLDart::AsyncCallback *callback_;
+  CBLDart_DatabaseLock *databaseLock_;
+  std::shared_ptr<CBLDart_TransactionGate> transactionGate_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Input> inputs_;
+  bool finished_ = false;
+  bool cancelled_ = false;
+  bool callbackClosed_ = false;
+
+  // The following fields are only accessed by the import thread.
+  std::string line_;
+  std::vector<CBLDocument *> batch_;
+  uint64_t importedCount_ = 0;
+  uint64_t consumedInputCount_ = 0;
+  CBLError error_{};
+};
+
+// The callback owns a reference to the importer, which is released when the
+// callback is closed.
+static void CBLDart_JSONLinesImporterCallbackFinalizer(void *context) {
+  auto importer =
+      reinterpret_cast<std::shared_ptr<CBLDart_JSONLinesImporter> *>(context);
+  (*importer)->callbackClosed();
+  delete importer;
+}
+
+CBLDart_JSONLinesImporter *CBLDart_CBLCollection_ImportJSONLines(
+    const CBLDatabase *db, CBLCollection *collection, FLString idKeyPath,
+    uint32_t batchSize, CBLDart_AsyncCallback callback, CBLError *errorOut) {
+  FLKeyPath keyPath = nullptr;
+  if (idKeyPath.buf) {
+    FLError flError;
+    keyPath = FLKeyPath_New(idKeyPath, &flError);
+    if (!keyPath) {
+      *errorOut = {kCBLFleeceDomain, static_cast<int>(flError), 0};
+      return nullptr;
+    }
+  }
+
+  auto importer = std::make_shared<CBLDart_JSONLinesImporter>(
+      db, collection, keyPath, batchSize, callback);
+
+  ASYNC_CALLBACK_FROM_C(callback)->setFinalizer(
+      new std::shared_ptr<CBLDart_JSONLinesImporter>(importer),
+      CBLDart_JSONLinesImporterCallbackFinalizer);
+
+  std::thread([importer] { importer->run(); }).detach();
+
+  return importer.get();
+}
+
+void CBLDart_JSONLinesImporter_AddChunk(CBLDart_JSONLinesImporter *importer,
+                                        FLSlice chunk) {
+  importer->addInput(
+      false, std::string(static_cast<const char *>(chunk.buf), chunk.size));
+}
+
+void CBLDart_JSONLinesImporter_AddFile(CBLDart_JSONLinesImporter *importer,
+                                       FLString path) {
+  importer->addInput(true, CBLDart_FLStringToString(path));
+}
+
+void CBLDart_JSONLinesImporter_Finish(CBLDart_JSONLinesImporter *importer,
+                                      bool cancel) {
+  importer->finish(cancel);
+}
+
+/**
+ * The state of a deletion or purge of the documents which match a predicate,
+ * which is shared between the background thread that removes the documents
+ * and the callback of the operation.
+ *
+ * The matching documents are queried in the order of their IDs, one batch at
+ * a time, and each batch is removed in its own transaction. The database
+ * level lock is only held while a batch is removed, so that other operations
+ * and closing the database are not blocked for the whole operation.
+ */
+struct CBLDart_DocumentRemover {
+  CBLDart_DocumentRemover(const CBLDatabase *database,
+                          CBLCollection *collection, CBLQuery *query,
+                          bool purge, uint32_t batchSize,
+                          CBLDart_AsyncCallback callback)
+      : database_(
+            CBLDatabase_Retain(const_cast<CBLDatabase *>(database))),
+        collection_(CBLCollection_Retain(collection)),
+        query_(query),
+        purge_(purge),
+        batchSize_(batchSize),
+        callback_(ASYNC_CALLBACK_FROM_C(callback)),
+        databaseLock_(CBLDart_CloneDatabaseLock(database)),
+        transactionGate_(CBLDart_TransactionGateOf(database)) {}
+
+  ~CBLDart_DocumentRemover() {
+    CBLQuery_Release(query_);
+    CBLCollection_Release(collection_);
+    CBLDatabase_Release(database_);
+    databaseLock_->release();
+  }
+
+  /**
+   * Compiles the query for the IDs of the documents in `collection` which
+   * match `predicate`, after the ID in the `lastId` parameter.
+   */
+  static CBLQuery *createQuery(const CBLDatabase *database,
+                               CBLCollection *collection, FLString predicate,
+                               CBLError *errorOut) {
+    // The predicate is parsed and encoded again, so that it cannot change the
+    // structure of the query it is embedded into.
+    FLError flError;
+    auto predicateDoc = FLDoc_FromJSON(predicate, &flError);
+    if (!predicateDoc) {
+      *errorOut = {kCBLFleeceDomain, static_cast<int>(flError), 0};
+      return nullptr;
+    }
+    auto predicateJSON = FLValue_ToJSON(FLDoc_GetRoot(predicateDoc));
+    FLDoc_Release(predicateDoc);
+
+    auto scope = CBLCollection_Scope(collection);
+    auto fullName = CBLDart_FLStringToString(CBLScope_Name(scope)) + "." +
+                    CBLDart_FLStringToString(CBLCollection_Name(collection));
+    CBLScope_Release(scope);
+
+    auto queryJSON =
+        "{\"WHAT\":[[\"._id\"]],\"FROM\":[{\"COLLECTION\":" +
+        CBLDart_JSONString(fullName) + "}],\"WHERE\":[\"AND\"," +
+        std::string(static_cast<const char *>(predicateJSON.buf),
+                    predicateJSON.size) +
+        ",[\">\",[\"._id\"],[\"$lastId\"]]],\"ORDER_BY\":[[\"._id\"]],"
+        "\"LIMIT\":[\"$limit\"]}";
+    FLSliceResult_Release(predicateJSON);
+
+    return CBLDatabase_CreateQuery(database, kCBLJSONLanguage,
+                                   {queryJSON.data(), queryJSON.size()},
+                                   nullptr, errorOut);
+  }
+
+  /**
+   * Must be called when the callback has been closed, after which it must not
+   * be called anymore.
+   */
+  void callbackClosed() {
+    std::scoped_lock lock(mutex_);
+    callbackClosed_ = true;
+  }
+
+  void run() {
+    auto matchedCount = batchSize_;
+    while (matchedCount == batchSize_ && !isCancelled()) {
+      if (!removeBatch(matchedCount)) {
+        break;
+      }
+      sendMessage(false);
+    }
+
+    sendMessage(true);
+  }
+
+ private:
+  bool isCancelled() {
+    std::scoped_lock lock(mutex_);
+    return callbackClosed_;
+  }
+
+  /**
+   * Removes the next batch of matching documents and sets `matchedCount` to
+   * the number of documents which matched.
+   */
+  bool removeBatch(uint32_t &matchedCount) {
+    CBLDart_TransactionGateScope gate(transactionGate_.get(), this);
+    auto databaseLock = databaseLock_->acquire();
+    if (!CBLDart_CBLDatabase_BeginTransaction(database_, &error_)) {
+      return false;
+    }
+
+    auto ok = false;
+    std::vector<std::string> ids;
+    uint64_t removedCount = 0;
+    if (queryBatch(ids)) {
+      ok = true;
+      for (auto &id : ids) {
+        auto removed = false;
+        if (!removeDocument({id.data(), id.size()}, removed)) {
+          ok = false;
+          break;
+        }
+        removedCount += removed;
+      }
+    }
+
+    CBLError endError;
+    if (!CBLDart_CBLDatabase_EndTransaction(database_, ok, &endError) &&
+        ok) {
+      error_ = endError;
+      ok = false;
+    }
+
+    if (ok) {
+      matchedCount = static_cast<uint32_t>(ids.size());
+      affectedCount_ += removedCount;
+      lastId_ = ids.empty() ? lastId_ : ids.back();
+    }
+    return ok;
+  }
+
+  bool queryBatch(std::vector<std::string> &ids) {
+    auto parameters = FLMutableDict_New();
+    FLMutableDict_SetString(parameters, FLSTR("lastId"),
+                            {lastId_.data(), lastId_.size()});
+    FLMutableDict_SetUInt(parameters, FLSTR("limit"), batchSize_);
+    CBLQuery_SetParameters(query_, parameters);
+    FLMutableDict_Release(parameters);
+
+    auto resultSet = CBLQuery_Execute(query_, &error_);
+    if (!resultSet) {
+      return false;
+    }
+
+    ids.reserve(batchSize_);
+    while (CBLResultSet_Next(resultSet)) {
+      auto id = FLValue_AsString(CBLResultSet_ValueAtIndex(resultSet, 0));
+      ids.emplace_back(static_cast<const char *>(id.buf), id.size);
+    }
+    CBLResultSet_Release(resultSet);
+    return true;
+  }
+
+  /**
+   * Removes the document with `id` and sets `removed` to whether it still
+   * existed.
+   */
+  bool removeDocument(FLString id, bool &removed) {
+    if (purge_) {
+      if (!CBLCollection_PurgeDocumentByID(collection_, id, &error_)) {
+        if (error_.domain == kCBLDomain && error_.code == kCBLErrorNotFound) {
+          error_ = {};
+          return true;
+        }
+        return false;
+      }
+      removed = true;
+      return true;
+    }
+
+    auto document = CBLCollection_GetDocument(collection_, id, &error_);
+    if (!document) {
+      return error_.code == 0;
+    }
+    removed = CBLCollection_DeleteDocumentWithConcurrencyControl(
+        collection_, document, kCBLConcurrencyControlLastWriteWins, &error_);
+    CBLDocument_Release(document);
+    return removed;
+  }
+
+  void sendMessage(bool isDone) {
+    auto hasError = isDone && error_.code != 0;
+
+    FLSliceResult errorMessage{};
+    if (hasError) {
+      errorMessage = CBLError_Message(&error_);
+    }
+
+    Dart_CObject isDone_{};
+    isDone_.type = Dart_CObject_kBool;
+    isDone_.value.as_bool = isDone;
+
+    Dart_CObject affectedCount{};
+    affectedCount.type = Dart_CObject_kInt64;
+    affectedCount.value.as_int64 = static_cast<int64_t>(affectedCount_);
+
+    Dart_CObject errorDomain{};
+    errorDomain.type = Dart_CObject_kInt32;
+    errorDomain.value.as_int32 = error_.domain;
+
+    Dart_CObject errorCode{};
+    errorCode.type = Dart_CObject_kInt32;
+    errorCode.value.as_int32 = error_.code;
+
+    Dart_CObject errorMessage_{};
+    CBLDart_CObject_SetFLString(&errorMessage_,
+                                static_cast<FLString>(errorMessage));
+
+    Dart_CObject *argsValues[] = {&isDone_, &affectedCount, &errorDomain,
+                                  &errorCode, &errorMessage_};
+
+    Dart_CObject args{};
+    args.type = Dart_CObject_kArray;
+    args.value.as_array.length = hasError ? 5 : 2;
+    args.value.as_array.values = argsValues;
+
+    {
+      std::scoped_lock lock(mutex_);
+      if (!callbackClosed_) {
+        CBLDart::AsyncCallbackCall(*callback_).execute(args);
+      }
+    }
+
+    FLSliceResult_Release(errorMessage);
+  }
+
+  CBLDatabase *database_;
+  CBLCollection *collection_;
+  CBLQuery *query_;
+  bool purge_;
+  uint32_t batchSize_;
+  CBLDart::AsyncCallback *callback_;
+  CBLDart_DatabaseLock *databaseLock_;
+  std::shared_ptr<CBLDart_TransactionGate> transactionGate_;
+
+  std::mutex mutex_;
+  bool callbackClosed_ = false;
+
+  // The following fields are only accessed by the background thread.
+  std::string lastId_;
+  uint64_t affectedCount_ = 0;
+  CBLError error_{};
+};
+
+// The callback owns a reference to the remover, which is released when the
+// callback is closed.
+static void CBLDart_DocumentRemoverCallbackFinalizer(void *context) {
+  auto remover =
+      reinterpret_cast<std::shared_ptr<CBLDart_DocumentRemover> *>(context);
+  (*remover)->callbackClosed();
+  delete remover;
+}
+
+static bool CBLDart_CBLCollection_RemoveWhere(
+    const CBLDatabase *db, CBLCollection *collection, FLString predicate,
+    bool purge, uint32_t batchSize, CBLDart_AsyncCallback callback,
+    CBLError *errorOut) {
+  auto query = CBLDart_DocumentRemover::createQuery(db, collection, predicate,
+                                                    errorOut);
+  if (!query) {
+    return false;
+  }
+
+  auto remover = std::make_shared<CBLDart_DocumentRemover>(
+      db, collection, query, purge, batchSize, callback);
+
+  ASYNC_CALLBACK_FROM_C(callback)->setFinalizer(
+      new std::shared_ptr<CBLDart_DocumentRemover>(remover),
+      CBLDart_DocumentRemoverCallbackFinalizer);
+
+  std::thread([remover] { remover->run(); }).detach();
+
+  return true;
+}
+
+bool CBLDart_CBLCollection_DeleteWhere(const CBLDatabase *db,
+                                       CBLCollection *collection,
+                                       FLString predicate, uint32_t batchSize,
+                                       CBLDart_AsyncCallback callback,
+                                       CBLError *errorOut) {
+  return CBLDart_CBLCollection_RemoveWhere(db, collection, predicate, false,
+                                           batchSize, callback, errorOut);
+}
+
+bool CBLDart_CBLCollection_PurgeWhere(const CBLDatabase *db,
+                                      CBLCollection *collection,
+                                      FLString predicate, uint32_t batchSize,
+                                      CBLDart_AsyncCallback callback,
+                                      CBLError *errorOut) {
+  return CBLDart_CBLCollection_RemoveWhere(db, collection, predicate, true,
+                                           batchSize, callback, errorOut);
+}
+
+// === Document Operations
+
+struct CBLDart_DocumentOperations
+    : std::enable_shared_from_this<CBLDart_DocumentOperations> {
+  /** Sends the result of an operation, without holding the database lock. */
+  using Send = std::function<void(CBLDart_DocumentOperations &)>;
+
+  /**
+   * An operation, which is either run, its result sent and then released, or,
+   * if it is skipped, only released.
+   */
+  struct Operation {
+    std::function<Send()> run;
+    std::function<void()> release;
+  };
+
+  CBLDart::AsyncCallback *callback;
+  CBLDart_DatabaseLock *databaseLock;
+  std::mutex mutex;
+  bool isClosed = false;
+  /** The operations which have been submitted but not run yet. */
+  std::deque<Operation> pending;
+  /** Whether a task which runs the pending operations has been submitted. */
+  bool isRunning = false;
+
+  ~CBLDart_DocumentOperations() { databaseLock->release(); }
+
+  /**
+   * Runs `run` on a background thread, while holding the database lock, then
+   * calls the function it returns to send the result, after the lock has been
+   * released, and finally calls `release`, which must release the resources
+   * of the operation.
+   *
+   * The operation is skipped if the queue has been closed before it starts,
+   * in which case only `release` is called. Since the database is closed
+   * under the database lock, it stays open while the operation runs.
+   *
+   * Results are never sent while holding the database lock, since a blocking
+   * call waits for the Dart isolate, which might itself wait for the lock.
+   */
+  template <typename Run, typename Release>
+  void submit(Run run, Release release) {
+    std::unique_lock lock(mutex);
+    if (isClosed) {
+      lock.unlock();
+      release();
+      return;
+    }
+    pending.push_back({std::move(run), std::move(release)});
+    if (isRunning) {
+      return;
+    }
+    isRunning = true;
+    lock.unlock();
+
+    CBLDart::Executor::queries().submit(
+        [self = shared_from_this()]() { self->runPending(); });
+  }
+
+  /**
+   * Runs the pending operations in batches, which are each run under a
+   * single acquisition of the database lock, until none are left. The
+   * results of a batch are sent after the lock has been released.
+   */
+  void runPending() {
+    while (true) {
+      std::deque<Operation> batch;
+      {
+        std::scoped_lock lock(mutex);
+        if (pending.empty()) {
+          isRunning = false;
+          return;
+        }
+        batch.swap(pending);
+      }
+
+      std::vector<Send> sends(batch.size());
+      {
+        auto databaseLock = this->databaseLock->acquire();
+        for (size_t i = 0; i < batch.size(); i++) {
+          if (!isQueueClosed()) {
+            sends[i] = batch[i].run();
+          }
+        }
+      }
+
+      for (size_t i = 0; i < batch.size(); i++) {
+        if (sends[i]) {
+          sends[i](*this);
+        }
+        batch[i].release();
+      }
+    }
+  }
+
+  /**
+   * Closes the queue and releases the operations which have not been run
+   * yet.
+   */
+  void close() {
+    std::deque<Operation> skipped;
+    {
+      std::scoped_lock lock(mutex);
+      isClosed = true;
+      skipped.swap(pending);
+    }
+    for (auto &operation : skipped) {
+      operation.release();
+    }
+  }
+
+  bool isQueueClosed() {
+    std::scoped_lock lock(mutex);
+    return isClosed;
+  }
+
+  /**
+   * Sends the `result` of the operation with `operationId` to the callback,
+   * together with `error`, if the operation failed.
+   */
+  void send(int64_t operationId, Dart_CObject &result, const CBLError &error,
+            bool isBlocking = false) {
+    std::unique_ptr<CBLDart::AsyncCallbackCall> call;
+    {
+      // After the queue has been closed the callback must not be used
+      // anymore. Calls which are created while the callback is being closed
+      // are not registered and do nothing.
+      std::scoped_lock lock(mutex);
+      if (isClosed) {
+        return;
+      }
+      call = std::make_unique<CBLDart::AsyncCallbackCall>(*callback,
+                                                          isBlocking);
+    }
+
+    auto hasError = error.code != 0;
+    FLSliceResult errorMessage{};
+    if (hasError) {
+      errorMessage = CBLError_Message(&error);
+    }
+
+    Dart_CObject operationId_{};
+    operationId_.type = Dart_CObject_kInt64;
+    operationId_.value.as_int64 = operationId;
+
+    Dart_CObject errorDomain{};
+    errorDomain.type = Dart_CObject_kInt32;
+    errorDomain.value.as_int32 = error.domain;
+
+    Dart_CObject errorCode{};
+    errorCode.type = Dart_CObject_kInt32;
+    errorCode.value.as_int32 = error.code;
+
+    Dart_CObject errorMessage_{};
+    CBLDart_CObject_SetFLString(&errorMessage_,
+                                static_cast<FLString>(errorMessage));
+
+    Dart_CObject *argsValues[] = {&operationId_, &result, &errorDomain,
+                                  &errorCode, &errorMessage_};
+
+    Dart_CObject args{};
+    args.type = Dart_CObject_kArray;
+    args.value.as_array.length = hasError ? 5 : 2;
+    args.value.as_array.values = argsValues;
+
+    call->execute(args);
+
+    FLSliceResult_Release(errorMessage);
+  }
+
+  /**
+   * Sends the result of an operation which saves or deletes a document,
+   * which is `false` if the operation failed because of a conflict.
+   */
+  void sendWriteResult(int64_t operationId, bool success, CBLError error) {
+    if (!success && error.domain == kCBLDomain &&
+        error.code == kCBLErrorConflict) {
+      error = {};
+    }
+
+    Dart_CObject result{};
+    result.type = Dart_CObject_kBool;
+    result.value.as_bool = success;
+    send(operationId, result, error);
+  }
+};
+
+static void CBLDart_DocumentOperationsFinalizer(void *context) {
+  auto operations =
+      reinterpret_cast<std::shared_ptr<CBLDart_DocumentOperations> *>(context);
+  (*operations)->close();
+  delete operations;
+}
+
+CBLDart_DocumentOperations *CBLDart_DocumentOperations_New(
+    const CBLDatabase *db, CBLDart_AsyncCallback callback) {
+  auto operations = std::make_shared<CBLDart_DocumentOperations>();
+  operations->callback = ASYNC_CALLBACK_FROM_C(callback);
+  operations->databaseLock = CBLDart_CloneDatabaseLock(db);
+
+  operations->callback->setFinalizer(
+      new std::shared_ptr<CBLDart_DocumentOperations>(operations),
+      CBLDart_DocumentOperationsFinalizer);
+
+  return operations.get();
+}
+
+void CBLDart_DocumentOperations_GetDocument(
+    CBLDart_DocumentOperations *operations, const CBLCollection *collection,
+    FLString docID, int64_t operationId) {
+  CBLCollection_Retain(collection);
+  operations->submit(
+      [collection, operationId, docID = CBLDart_FLStringToString(docID)]() {
+        CBLError error{};
+        auto document = CBLDart::DocumentCache::instance().getDocument(
+            collection, {docID.data(), docID.size()}, &error);
+
+        return [operationId, document,
+                error](CBLDart_DocumentOperations &operations) {
+          // The document is sent in a blocking call, so that it can be
+          // released after the callback has retained it.
+          Dart_CObject result{};
+          CBLDart_CObject_SetPointer(&result, document);
+          operations.send(operationId, result, error, true);
+
+          CBLDocument_Release(document);
+        };
+      },
+      [collection]() { CBLCollection_Release(collection); });
+}
+
+void CBLDart_DocumentOperations_SaveDocument(
+    CBLDart_DocumentOperations *operations, CBLCollection *collection,
+    CBLDocument *doc, CBLConcurrencyControl concurrencyControl,
+    int64_t operationId) {
+  CBLCollection_Retain(collection);
+  CBLDocument_Retain(doc);
+  operations->submit(
+      [collection, doc, concurrencyControl, operationId]() {
+        CBLError error{};
+        auto success = CBLCollection_SaveDocumentWithConcurrencyControl(
+            collection, doc, concurrencyControl, &error);
+        return [operationId, success,
+                error](CBLDart_DocumentOperations &operations) {
+          operations.sendWriteResult(operationId, success, error);
+        };
+      },
+      [collection, doc]() {
+        CBLDocument_Release(doc);
+        CBLCollection_Release(collection);
+      });
+}
+
+void CBLDart_DocumentOperations_DeleteDocument(
+    CBLDart_DocumentOperations *operations, CBLCollection *collection,
+    const CBLDocument *doc, CBLConcurrencyControl concurrencyControl,
+    int64_t operationId) {
+  CBLCollection_Retain(collection);
+  CBLDocument_Retain(doc);
+  operations->submit(
+      [collection, doc, concurrencyControl, operationId]() {
+        CBLError error{};
+        auto success = CBLCollection_DeleteDocumentWithConcurrencyControl(
+            collection, doc, concurrencyControl, &error);
+        return [operationId, success,
+                error](CBLDart_DocumentOperations &operations) {
+          operations.sendWriteResult(operationId, success, error);
+        };
+      },
+      [collection, doc]() {
+        CBLDocument_Release(doc);
+        CBLCollection_Release(collection);
+      });
+}
+
+void CBLDart_DocumentOperations_PurgeDocument(
+    CBLDart_DocumentOperations *operations, CBLCollection *collection,
+    FLString docID, int64_t operationId) {
+  CBLCollection_Retain(collection);
+  operations->submit(
+      [collection, operationId, docID = CBLDart_FLStringToString(docID)]() {
+        CBLError error{};
+        CBLCollection_PurgeDocumentByID(
+            collection, {docID.data(), docID.size()}, &error);
+
+        return [operationId, error](CBLDart_DocumentOperations &operations) {
+          Dart_CObject result{};
+          result.type = Dart_CObject_kBool;
+          result.value.as_bool = true;
+          operations.send(operationId, result, error);
+        };
+      },
+      [collection]() { CBLCollection_Release(collection); });
+}
+
+// === Query
+
+struct CBLDart_QueryListenerContext {
+  CBLDart::AsyncCallback *callback;
+  std::shared_ptr<CBLDart::ListenerThrottle> throttle;
+  CBLListenerToken *listenerToken;
+  CBLDart_DatabaseLock *databaseLock;
+};
+
+// The throttles of query change listeners, by their callbacks, so that they
+// can be paused and resumed.
+static std::mutex queryListenerThrottlesMutex;
+static std::unordered_map<CBLDart::AsyncCallback *,
+                          std::shared_ptr<CBLDart::ListenerThrottle>>
+    queryListenerThrottles;
+
+static void CBLDart_QueryChangeListenerWrapper(void *context, CBLQuery *query,
+                                               CBLListenerToken *token) {
+  CBLDart::Stats::instance.listenerInvoked();
+  CBLDart::TimelineSpan span("CBLDart QueryChangeListener");
+  reinterpret_cast<CBLDart_QueryListenerContext *>(context)
+      ->throttle->notify();
+}
+
+static void CBLDart_QueryChangeListenerFinalizer(void *context) {
+  auto listenerContext =
+      reinterpret_cast<CBLDart_QueryListenerContext *>(context);
+  {
+    std::scoped_lock lock(queryListenerThrottlesMutex);
+    queryListenerThrottles.erase(listenerContext->callback);
+  }
+  {
+    auto databaseLock = listenerContext->databaseLock->acquire();
+    CBLListener_Remove(listenerContext->listenerToken);
+  }
+  listenerContext->databaseLock->release();
+  listenerContext->throttle->stop();
+  delete listenerContext;
+}
+
+CBLListenerToken *CBLDart_CBLQuery_AddChangeListener(
+    const CBLDatabase *db, CBLQuery *query, uint32_t minIntervalMs,
+    CBLDart_AsyncCallback listener) {
+  // A query which has had a change listener is not reused.
+  CBLDart::QueryCache::instance().detach(query);
+
+  auto callback = ASYNC_CALLBACK_FROM_C(listener);
+  auto throttle = std::make_shared<CBLDart::ListenerThrottle>(
+      callback, std::chrono::milliseconds(minIntervalMs));
+  auto listenerContext = new CBLDart_QueryListenerContext{
+      callback, throttle, nullptr, CBLDart_CloneDatabaseLock(db)};
+
+  {
+    std::scoped_lock lock(queryListenerThrottlesMutex);
+    queryListenerThrottles[callback] = throttle;
+  }
+
+  listenerContext->listenerToken = CBLQuery_AddChangeListener(
+      query, CBLDart_QueryChangeListenerWrapper, listenerContext);
+  callback->setFinalizer(listenerContext,
+                         CBLDart_QueryChangeListenerFinalizer);
+
+  return listenerContext->listenerToken;
+}
+
+void CBLDart_CBLQuery_SetChangeListenerPaused(CBLDart_AsyncCallback listener,
+                                              bool paused) {
+  std::shared_ptr<CBLDart::ListenerThrottle> throttle;
+  {
+    std::scoped_lock lock(queryListenerThrottlesMutex);
+    auto it = queryListenerThrottles.find(ASYNC_CALLBACK_FROM_C(listener));
+    if (it == queryListenerThrottles.end()) {
+      return;
+    }
+    throttle = it->second;
+  }
+  throttle->setPaused(paused);
+}
+
+struct CBLDart_QueryDiffListenerContext {
+  CBLDart::QueryResultsDiffer differ;
+  CBLListenerToken *listenerToken;
+  CBLDart_DatabaseLock *databaseLock;
+};
+
+static void CBLDart_QueryDiffListenerWrapper(void *context, CBLQuery *query,
+                                             CBLListenerToken *token) {
+  CBLDart::Stats::instance.listenerInvoked();
+  CBLDart::TimelineSpan span("CBLDart QueryDiffListener");
+  auto listenerContext =
+      reinterpret_cast<CBLDart_QueryDiffListenerContext *>(context);
+
+  CBLError error{};
+  auto results = CBLQuery_CopyCurrentResults(query, token, &error);
+  listenerContext->differ.update(results, error);
+}
+
+static void CBLDart_QueryDiffListenerFinalizer(void *context) {
+  auto listenerContext =
+      reinterpret_cast<CBLDart_QueryDiffListenerContext *>(context);
+  {
+    auto databaseLock = listenerContext->databaseLock->acquire();
+    CBLListener_Remove(listenerContext->listenerToken);
+  }
+  listenerContext->databaseLock->release();
+  delete listenerContext;
+}
+
+void CBLDart_CBLQuery_AddDiffListener(const CBLDatabase *db, CBLQuery *query,
+                                      int keyColumn,
+                                      CBLDart_AsyncCallback listener) {
+  CBLDart::QueryCache::instance().detach(query);
+
+  auto callback = ASYNC_CALLBACK_FROM_C(listener);
+  auto listenerContext = new CBLDart_QueryDiffListenerContext{
+      CBLDart::QueryResultsDiffer(callback, keyColumn), nullptr,
+      CBLDart_CloneDatabaseLock(db)};
+  listenerContext->listenerToken = CBLQuery_AddChangeListener(
+      query, CBLDart_QueryDiffListenerWrapper, listenerContext);
+  callback->setFinalizer(listenerContext, CBLDart_QueryDiffListenerFinalizer);
+}
+
+struct CBLDart_QueryExecution {
+  CBLDart::AsyncCallback *callback;
+  CBLQuery *query;
+  CBLDart_DatabaseLock *databaseLock;
+  uint32_t batchSize;
+  std::mutex mutex;
+  bool isCanceled = false;
+
+  ~CBLDart_QueryExecution() {
+    CBLDart::QueryCache::instance().release(query);
+    databaseLock->release();
+  }
+};
+
+static void CBLDart_QueryExecutionFinalizer(void *context) {
+  auto execution =
+      reinterpret_cast<std::shared_ptr<CBLDart_QueryExecution> *>(context);
+  {
+    std::scoped_lock lock((*execution)->mutex);
+    (*execution)->isCanceled = true;
+  }
+  delete execution;
+}
+
+/**
+ * Sends `arguments` to the callback of `execution` and waits until they have
+ * been consumed.
+ *
+ * Returns `false` if the execution has been canceled.
+ */
+static bool CBLDart_QueryExecution_Send(CBLDart_QueryExecution &execution,
+                                        Dart_CObject &arguments) {
+  std::unique_ptr<CBLDart::AsyncCallbackCall> call;
+  {
+    // After the execution has been canceled the callback has been closed and
+    // must not be used anymore. The callback is closed before the execution
+    // is canceled, though, and calls which are created in between are not
+    // registered.
+    std::scoped_lock lock(execution.mutex);
+    if (execution.isCanceled) {
+      return false;
+    }
+    call = std::make_unique<CBLDart::AsyncCallbackCall>(*execution.callback,
+                                                        true);
+  }
+  call->execute(arguments);
+  return call->isRegistered();
+}
+
+static void CBLDart_QueryExecution_SendError(CBLDart_QueryExecution &execution,
+                                             const CBLError &error) {
+  auto errorMessage = CBLError_Message(&error);
+
+  Dart_CObject errorDomain{};
+  errorDomain.type = Dart_CObject_kInt32;
+  errorDomain.value.as_int32 = error.domain;
+
+  Dart_CObject errorCode{};
+  errorCode.type = Dart_CObject_kInt32;
+  errorCode.value.as_int32 = error.code;
+
+  Dart_CObject errorMessage_{};
+  CBLDart_CObject_SetFLString(&errorMessage_,
+                              {errorMessage.buf, errorMessage.size});
+
+  Dart_CObject *argsValues[] = {&errorDomain, &errorCode, &errorMessage_};
+
+  Dart_CObject args{};
+  args.type = Dart_CObject_kArray;
+  args.value.as_array.length = 3;
+  args.value.as_array.values = argsValues;
+
+  CBLDart_QueryExecution_Send(execution, args);
+
+  FLSliceResult_Release(errorMessage);
+}
+
+static void CBLDart_QueryExecution_Run(CBLDart_QueryExecution &execution) {
+  CBLError error{};
+  CBLResultSet *results;
+  {
+    auto databaseLock = execution.databaseLock->acquire();
+    results = CBLQuery_Execute(execution.query, &error);
+  }
+  if (!results) {
+    CBLDart_QueryExecution_SendError(execution, error);
+    return;
+  }
+
+  // The next batch is only encoded after the previous one has been consumed,
+  // which limits the rows which are buffered for a slow consumer.
+  auto hasMoreRows = true;
+  while (hasMoreRows) {
+    auto encoder = FLEncoder_New();
+    FLEncoder_BeginArray(encoder, execution.batchSize);
+    {
+      auto databaseLock = execution.databaseLock->acquire();
+      for (uint32_t i = 0; i < execution.batchSize; i++) {
+        if (!(hasMoreRows = CBLResultSet_Next(results))) {
+          break;
+        }
+        FLEncoder_WriteValue(
+            encoder,
+            reinterpret_cast<FLValue>(CBLResultSet_ResultArray(results)));
+      }
+    }
+    FLEncoder_EndArray(encoder);
+    auto encodedRows = FLEncoder_Finish(encoder, nullptr);
+    FLEncoder_Free(encoder);
+
+    // Only the address and size of the encoded rows are sent. The call is
+    // blocking and the Dart side retains the rows before it returns, so that
+    // they are adopted without being copied.
+    Dart_CObject rowsBuf{};
+    CBLDart_CObject_SetPointer(&rowsBuf, encodedRows.buf);
+
+    Dart_CObject rowsSize{};
+    rowsSize.type = Dart_CObject_kInt64;
+    rowsSize.value.as_int64 = static_cast<int64_t>(encodedRows.size);
+
+    Dart_CObject *rowsValues[] = {&rowsBuf, &rowsSize};
+
+    Dart_CObject rows{};
+    rows.type = Dart_CObject_kArray;
+    rows.value.as_array.length = 2;
+    rows.value.as_array.values = rowsValues;
+
+    Dart_CObject isLast{};
+    isLast.type = Dart_CObject_kBool;
+    isLast.value.as_bool = !hasMoreRows;
+
+    Dart_CObject *argsValues[] = {&rows, &isLast};
+
+    Dart_CObject args{};
+    args.type = Dart_CObject_kArray;
+    args.value.as_array.length = 2;
+    args.value.as_array.values = argsValues;
+
+    auto didSend = CBLDart_QueryExecution_Send(execution, args);
+    FLSliceResult_Release(encodedRows);
+    if (!didSend) {
+      break;
+    }
+  }
+
+  CBLResultSet_Release(results);
+}
+
+void CBLDart_CBLQuery_ExecuteAsync(const CBLDatabase *db, CBLQuery *query,
+                                   uint32_t batchSize,
+                                   CBLDart_AsyncCallback callback) {
+  auto execution = std::make_shared<CBLDart_QueryExecution>();
+  execution->callback = ASYNC_CALLBACK_FROM_C(callback);
+  execution->query = query;
+  execution->databaseLock = CBLDart_CloneDatabaseLock(db);
+  execution->batchSize = std::max(batchSize, 1u);
+
+  execution->callback->setFinalizer(
+      new std::shared_ptr<CBLDart_QueryExecution>(execution),
+      CBLDart_QueryExecutionFinalizer);
+
+  CBLDart::Executor::queries().submit(
+      [execution = std::move(execution)]() {
+        CBLDart_QueryExecution_Run(*execution);
+      });
+}
+
+CBLQuery *CBLDart_QueryCache_CreateQuery(const CBLDatabase *db,
+                                         CBLQueryLanguage language,
+                                         FLString queryString,
+                                         int *errorPosOut, CBLError *errorOut) {
+  return CBLDart::QueryCache::instance().acquire(db, language, queryString,
+                                                 errorPosOut, errorOut);
+}
+
+void CBLDart_QueryCache_ReleaseQuery(CBLQuery *query) {
+  CBLDart::QueryCache::instance().release(query);
+}
+
+void CBLDart_QueryCache_SetCapacity(size_t capacity) {
+  CBLDart::QueryCache::instance().setCapacity(capacity);
+}
+
+CBLDart_QueryCacheStats CBLDart_QueryCache_Stats(void) {
+  return CBLDart::QueryCache::instance().stats();
+}
+
+/**
+ * Appends `size` bytes from `data` to `buffer`.
+ *
+ * Throws `std::bad_alloc` if the buffer can not be grown.
+ */
+static void CBLDart_FLJSONBuffer_WriteRaw(CBLDart_FLJSONBuffer *buffer,
+                                          const void *data, size_t size) {
+  auto requiredCapacity = buffer->size + size;
+  if (requiredCapacity > buffer->capacity) {
+    auto capacity = buffer->capacity == 0 ? 1024 : buffer->capacity * 2;
+    capacity = std::max(capacity, requiredCapacity);
+    auto buf = static_cast<uint8_t *>(std::realloc(buffer->buf, capacity));
+    if (!buf) {
+      throw std::bad_alloc();
+    }
+    buffer->buf = buf;
+    buffer->capacity = capacity;
+  }
+
+  std::memcpy(buffer->buf + buffer->size, data, size);
+  buffer->size = requiredCapacity;
+}
+
+/**
+ * Appends the JSON which has been written to the encoder of `buffer` since it
+ * was last flushed to `buffer`.
+ *
+ * Returns `false` and sets `errorOut` if the encoder failed.
+ */
+static bool CBLDart_FLJSONBuffer_FlushEncoder(CBLDart_FLJSONBuffer *buffer,
+                                              FLError *errorOut) {
+  auto json = FLEncoder_Finish(buffer->encoder, errorOut);
+  FLEncoder_Reset(buffer->encoder);
+  if (!json.buf) {
+    return false;
+  }
+
+  try {
+    CBLDart_FLJSONBuffer_WriteRaw(buffer, json.buf, json.size);
+  } catch (...) {
+    FLSliceResult_Release(json);
+    throw;
+  }
+  FLSliceResult_Release(json);
+  return true;
+}
+
+bool CBLDart_CBLResultSet_WriteJSON(CBLResultSet *resultSet,
+                                    CBLDart_FLJSONBuffer *buffer,
+                                    size_t chunkSize, bool isFirstChunk,
+                                    bool *isDoneOut, CBLError *errorOut) {
+  auto query = CBLResultSet_GetQuery(resultSet);
+  auto columnCount = CBLQuery_ColumnCount(query);
+  auto encoder = buffer->encoder;
+
+  *isDoneOut = false;
+  // Exceptions must not propagate to Dart, so a failure to grow the buffer
+  // is reported as an error.
+  try {
+    if (isFirstChunk) {
+      CBLDart_FLJSONBuffer_WriteRaw(buffer, "[", 1);
+    }
+
+    auto isFirstRow = isFirstChunk;
+    while (buffer->size < chunkSize) {
+      if (!CBLResultSet_Next(resultSet)) {
+        CBLDart_FLJSONBuffer_WriteRaw(buffer, "]", 1);
+        *isDoneOut = true;
+        break;
+      }
+
+      if (!isFirstRow) {
+        CBLDart_FLJSONBuffer_WriteRaw(buffer, ",", 1);
+      }
+      isFirstRow = false;
+
+      // Missing values are written as `null`, like when encoding a
+      // `Result`.
+      FLEncoder_BeginDict(encoder, columnCount);
+      for (unsigned i = 0; i < columnCount; i++) {
+        FLEncoder_WriteKey(encoder, CBLQuery_ColumnName(query, i));
+        auto value = CBLResultSet_ValueAtIndex(resultSet, i);
+        if (value && FLValue_GetType(value) != kFLUndefined) {
+          FLEncoder_WriteValue(encoder, value);
+        } else {
+          FLEncoder_WriteNull(encoder);
+        }
+      }
+      FLEncoder_EndDict(encoder);
+
+      FLError flError;
+      if (!CBLDart_FLJSONBuffer_FlushEncoder(buffer, &flError)) {
+        *errorOut = {kCBLFleeceDomain, static_cast<int>(flError), 0};
+        return false;
+      }
+    }
+  } catch (const std::bad_alloc &) {
+    FLEncoder_Reset(encoder);
+    *errorOut = {kCBLDomain, kCBLErrorMemoryError, 0};
+    return false;
+  }
+
+  return true;
+}
+
+size_t CBLDart_CBLResultSet_NextBatch(CBLResultSet *resultSet, FLArray *rowsOut,
+                                      size_t maxCount) {
+  size_t count = 0;
+  while (count < maxCount && CBLResultSet_Next(resultSet)) {
+    // The array of the current row is released when the result set is
+    // advanced, so it is retained for the caller.
+    rowsOut[count++] = FLArray_Retain(CBLResultSet_ResultArray(resultSet));
+  }
+  return count;
+}
+
+bool CBLDart_CBLResultSet_NextBatchWithDocuments(
+    CBLResultSet *resultSet, const CBLCollection *collection,
+    unsigned idColumn, FLArray *rowsOut, const CBLDocument **documentsOut,
+    size_t maxCount, size_t *countOut, CBLError *errorOut) {
+  auto &documentCache = CBLDart::DocumentCache::instance();
+  size_t count = 0;
+  while (count < maxCount && CBLResultSet_Next(resultSet)) {
+    auto row = FLArray_Retain(CBLResultSet_ResultArray(resultSet));
+    auto &document = documentsOut[count];
+    rowsOut[count++] = row;
+    document = nullptr;
+
+    auto docID = FLValue_AsString(FLArray_Get(row, idColumn));
+    if (!docID.buf) {
+      continue;
+    }
+
+    CBLError error{};
+    document = documentCache.getDocument(collection, docID, &error);
+    if (!document && error.code != 0) {
+      for (size_t i = 0; i < count; i++) {
+        FLArray_Release(rowsOut[i]);
+        CBLDocument_Release(documentsOut[i]);
+        rowsOut[i] = nullptr;
+        documentsOut[i] = nullptr;
+      }
+      *errorOut = error;
+      *countOut = 0;
+      return false;
+    }
+  }
+
+  *countOut = count;
+  return true;
+}
+
+/**
+ * Accumulates the values of a `CBLDart_Column` while the rows of a result set
+ * are extracted.
+ */
+class CBLDart_ColumnBuilder {
+ public:
+  explicit CBLDart_ColumnBuilder(CBLDart_Column *column) : column_(column) {
+    if (column_->type == kCBLDart_ColumnTypeString) {
+      offsets_.push_back(0);
+    }
+  }
+
+  void add(FLArray row, uint64_t rowIndex) {
+    auto value = FLArray_Get(row, column_->index);
+    auto type = FLValue_GetType(value);
+
+    if (rowIndex % 8 == 0) {
+      validity_.push_back(0);
+    }
+
+    bool isValid;
+    switch (column_->type) {
+      case kCBLDart_ColumnTypeInt64: {
+        isValid = type == kFLNumber || type == kFLBoolean;
+        append(isValid ? FLValue_AsInt(value) : int64_t{0});
+        break;
+      }
+      case kCBLDart_ColumnTypeFloat64: {
+        isValid = type == kFLNumber || type == kFLBoolean;
+        if (isValid && type == kFLBoolean) {
+          append(FLValue_AsBool(value) ? 1.0 : 0.0);
+        } else {
+          append(isValid ? FLValue_AsDouble(value) : 0.0);
+        }
+        break;
+      }
+      case kCBLDart_ColumnTypeString: {
+        isValid = type == kFLString;
+        if (isValid) {
+          auto string = FLValue_AsString(value);
+          values_.append(static_cast<const char *>(string.buf), string.size);
+        }
+        offsets_.push_back(static_cast<uint32_t>(values_.size()));
+        break;
+      }
+    }
+
+    if (isValid) {
+      validity_.back() |= static_cast<uint8_t>(1 << (rowIndex % 8));
+    }
+  }
+
+  void finish() {
+    switch (column_->type) {
+      case kCBLDart_ColumnTypeInt64:
+        column_->values = toSliceResult(values_, alignof(int64_t));
+        break;
+      case kCBLDart_ColumnTypeFloat64:
+        column_->values = toSliceResult(values_, alignof(double));
+        break;
+      case kCBLDart_ColumnTypeString:
+        column_->values = toSliceResult(values_, 1);
+        break;
+    }
+    column_->offsets =
+        column_->type == kCBLDart_ColumnTypeString
+            ? toSliceResult(offsets_.data(), offsets_.size() * sizeof(uint32_t),
+                            alignof(uint32_t))
+            : FLSliceResult{nullptr, 0};
+    column_->validity = toSliceResult(validity_.data(), validity_.size(), 1);
+  }
+
+ private:
+  template <typename T>
+  void append(T value) {
+    values_.append(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  static FLSliceResult toSliceResult(const std::string &data,
+                                     size_t alignment) {
+    return toSliceResult(data.data(), data.size(), alignment);
+  }
+
+  /**
+   * Copies `data` into a new slice, at the first address of the slice which
+   * is aligned to `alignment`, since the buffers of slices are not
+   * guaranteed to be aligned.
+   */
+  static FLSliceResult toSliceResult(const void *data, size_t size,
+                                     size_t alignment) {
+    auto result = FLSliceResult_New(size + alignment - 1);
+    auto address = reinterpret_cast<uintptr_t>(result.buf);
+    auto padding = (alignment - address % alignment) % alignment;
+    std::memcpy(static_cast<char *>(const_cast<void *>(result.buf)) + padding,
+                data, size);
+    return result;
+  }
+
+  CBLDart_Column *column_;
+  std::string values_;
+  std::vector<uint32_t> offsets_;
+  std::vector<uint8_t> validity_;
+};
+
+void CBLDart_CBLResultSet_ExtractColumns(CBLResultSet *resultSet,
+                                         const FLArray *fetchedRows,
+                                         size_t fetchedRowCount,
+                                         CBLDart_Column *columns,
+                                         size_t columnCount,
+                                         uint64_t *rowCountOut) {
+  std::vector<CBLDart_ColumnBuilder> builders;
+  builders.reserve(columnCount);
+  for (size_t i = 0; i < columnCount; i++) {
+    builders.emplace_back(&columns[i]);
+  }
+
+  uint64_t rowCount = 0;
+  auto addRow = [&](FLArray row) {
+    for (auto &builder : builders) {
+      builder.add(row, rowCount);
+    }
+    rowCount++;
+  };
+
+  for (size_t i = 0; i < fetchedRowCount; i++) {
+    addRow(fetchedRows[i]);
+  }
+  while (CBLResultSet_Next(resultSet)) {
+    addRow(CBLResultSet_ResultArray(resultSet));
+  }
+
+  for (auto &builder : builders) {
+    builder.finish();
+  }
+  *rowCountOut = rowCount;
+}
 
-  return listenerToken;
+FLSliceResult CBLDart_CBLCollection_FullTextSearch(
+    const CBLCollection *collection,
+    const CBLDart_FullTextSearchOptions *options, CBLError *errorOut) {
+  return CBLDart::fullTextSearch(collection, *options, errorOut);
 }
 
 // === Blob
 
-FLSliceResult CBLDart_CBLBlobReader_Read(CBLBlobReadStream *stream,
-                                         uint64_t bufferSize,
-                                         CBLError *outError) {
-  auto bufferSize_t = static_cast<size_t>(bufferSize);
-  auto buffer = FLSliceResult_New(bufferSize_t);
+static const size_t kBlobFileCopyBufferSize = 1024 * 1024;
+
+/**
+ * A copy of a file into a new blob, or of the content of a blob into a file,
+ * which runs on a background thread.
+ *
+ * The database level lock is only held while the blob is accessed, so that
+ * file IO does not block other users of the lock. Each time the lock is
+ * acquired, the copy checks that the database has not been closed in the
+ * meantime.
+ *
+ * Failures of file IO are reported as `kCBLErrorCantOpenFile` or
+ * `kCBLErrorIOError`, because file streams do not reliably report the cause
+ * of a failure through `errno`.
+ */
+struct CBLDart_BlobFileCopy {
+  CBLDart_BlobFileCopy(const CBLDatabase *database, const CBLBlob *blob,
+                       FLString path, FLString contentType,
+                       CBLDart_AsyncCallback callback)
+      : database_(
+            CBLDatabase_Retain(const_cast<CBLDatabase *>(database))),
+        blob_(blob ? CBLBlob_Retain(blob) : nullptr),
+        path_(CBLDart_FLStringToString(path)),
+        contentType_(CBLDart_FLStringToString(contentType)),
+        callback_(ASYNC_CALLBACK_FROM_C(callback)),
+        databaseLock_(CBLDart_CloneDatabaseLock(database)) {}
+
+  ~CBLDart_BlobFileCopy() {
+    if (blob_) {
+      CBLBlob_Release(blob_);
+    }
+    CBLDatabase_Release(database_);
+    databaseLock_->release();
+  }
+
+  /**
+   * Must be called when the callback has been closed, after which it must not
+   * be called anymore.
+   */
+  void callbackClosed() {
+    std::scoped_lock lock(mutex_);
+    callbackClosed_ = true;
+  }
+
+  void run() {
+    CBLError error{};
+    CBLBlob *createdBlob = nullptr;
+    if (blob_) {
+      writeToFile(error);
+    } else {
+      createdBlob = createFromFile(error);
+    }
+
+    sendMessage(createdBlob, error);
+  }
+
+ private:
+  /**
+   * Calls `body` while holding the database lock, unless the database has
+   * been closed, in which case `error` is set and `false` is returned.
+   */
+  template <typename Body>
+  bool withDatabaseLock(CBLError &error, Body body) {
+    auto databaseLock = databaseLock_->acquire();
+    if (!CBLDart_IsDatabaseOpen(database_)) {
+      error = {kCBLDomain, kCBLErrorNotOpen, 0};
+      return false;
+    }
+    return body();
+  }
+
+  CBLBlob *createFromFile(CBLError &error) {
+    std::ifstream file(path_, std::ios::binary);
+    if (!file) {
+      error = {kCBLDomain, kCBLErrorCantOpenFile, 0};
+      return nullptr;
+    }
+
+    CBLBlobWriteStream *writer = nullptr;
+    if (!withDatabaseLock(error, [&] {
+          writer = CBLBlobWriter_Create(database_, &error);
+          return writer != nullptr;
+        })) {
+      return nullptr;
+    }
+
+    std::vector<char> buffer(kBlobFileCopyBufferSize);
+    auto ok = true;
+    while (ok && file) {
+      file.read(buffer.data(), buffer.size());
+      auto size = static_cast<size_t>(file.gcount());
+      if (size > 0) {
+        ok = withDatabaseLock(error, [&] {
+          return CBLBlobWriter_Write(writer, buffer.data(), size, &error);
+        });
+      }
+    }
+
+    if (ok && file.bad()) {
+      error = {kCBLDomain, kCBLErrorIOError, 0};
+      ok = false;
+    }
+
+    if (!ok) {
+      auto databaseLock = databaseLock_->acquire();
+      CBLBlobWriter_Close(writer);
+      return nullptr;
+    }
+
+    // The digest of the content has been computed while it was written.
+    CBLBlob *blob = nullptr;
+    auto saved = withDatabaseLock(error, [&] {
+      blob = CBLBlob_CreateWithStream(
+          {contentType_.data(), contentType_.size()}, writer);
+      return CBLDatabase_SaveBlob(database_, blob, &error);
+    });
+    if (!saved) {
+      // The writer is consumed by `CBLBlob_CreateWithStream`.
+      auto databaseLock = databaseLock_->acquire();
+      if (blob) {
+        CBLBlob_Release(blob);
+      } else {
+        CBLBlobWriter_Close(writer);
+      }
+      return nullptr;
+    }
+    return blob;
+  }
+
+  bool writeToFile(CBLError &error) {
+    CBLBlobReadStream *reader = nullptr;
+    if (!withDatabaseLock(error, [&] {
+          reader = CBLBlob_OpenContentStream(blob_, &error);
+          return reader != nullptr;
+        })) {
+      return false;
+    }
+
+    std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+    auto ok = static_cast<bool>(file);
+    if (!ok) {
+      error = {kCBLDomain, kCBLErrorCantOpenFile, 0};
+    }
+
+    std::vector<char> buffer(kBlobFileCopyBufferSize);
+    while (ok) {
+      int bytesRead = 0;
+      ok = withDatabaseLock(error, [&] {
+        bytesRead =
+            CBLBlobReader_Read(reader, buffer.data(), buffer.size(), &error);
+        return bytesRead >= 0;
+      });
+      if (!ok || bytesRead == 0) {
+        break;
+      }
+      CBLDart::Stats::instance.blobBytesRead(bytesRead);
+      if (!file.write(buffer.data(), bytesRead)) {
+        error = {kCBLDomain, kCBLErrorIOError, 0};
+        ok = false;
+      }
+    }
+    {
+      auto databaseLock = databaseLock_->acquire();
+      CBLBlobReader_Close(reader);
+    }
+
+    if (ok) {
+      file.close();
+      if (file.fail()) {
+        error = {kCBLDomain, kCBLErrorIOError, 0};
+        ok = false;
+      }
+    }
+    return ok;
+  }
+
+  void sendMessage(CBLBlob *createdBlob, CBLError error) {
+    auto hasError = error.code != 0;
+
+    FLSliceResult errorMessage{};
+    if (hasError) {
+      errorMessage = CBLError_Message(&error);
+    }
+
+    Dart_CObject blob{};
+    CBLDart_CObject_SetPointer(&blob, createdBlob);
+
+    Dart_CObject errorDomain{};
+    errorDomain.type = Dart_CObject_kInt32;
+    errorDomain.value.as_int32 = error.domain;
+
+    Dart_CObject errorCode{};
+    errorCode.type = Dart_CObject_kInt32;
+    errorCode.value.as_int32 = error.code;
+
+    Dart_CObject errorMessage_{};
+    CBLDart_CObject_SetFLString(&errorMessage_,
+                                static_cast<FLString>(errorMessage));
+
+    Dart_CObject *successValues[] = {&blob};
+    Dart_CObject *errorValues[] = {&errorDomain, &errorCode, &errorMessage_};
+
+    Dart_CObject args{};
+    args.type = Dart_CObject_kArray;
+    args.value.as_array.length = hasError ? 3 : 1;
+    args.value.as_array.values = hasError ? errorValues : successValues;
+
+    {
+      // The created blob is adopted by the Dart side, if it is delivered.
+      std::scoped_lock lock(mutex_);
+      auto delivered = false;
+      if (!callbackClosed_) {
+        CBLDart::AsyncCallbackCall call(*callback_);
+        delivered = call.isRegistered();
+        call.execute(args);
+      }
+      if (!delivered && createdBlob) {
+        CBLBlob_Release(createdBlob);
+      }
+    }
+
+    FLSliceResult_Release(errorMessage);
+  }
+
+  CBLDatabase *database_;
+  const CBLBlob *blob_;
+  std::string path_;
+  std::string contentType_;
+  CBLDart::AsyncCallback *callback_;
+  CBLDart_DatabaseLock *databaseLock_;
+
+  std::mutex mutex_;
+  bool callbackClosed_ = false;
+};
+
+// The callback owns a reference to the copy, which is released when the
+// callback is closed.
+static void CBLDart_BlobFileCopyCallbackFinalizer(void *context) {
+  auto copy =
+      reinterpret_cast<std::shared_ptr<CBLDart_BlobFileCopy> *>(context);
+  (*copy)->callbackClosed();
+  delete copy;
+}
+
+static void CBLDart_StartBlobFileCopy(
+    std::shared_ptr<CBLDart_BlobFileCopy> copy,
+    CBLDart_AsyncCallback callback) {
+  ASYNC_CALLBACK_FROM_C(callback)->setFinalizer(
+      new std::shared_ptr<CBLDart_BlobFileCopy>(copy),
+      CBLDart_BlobFileCopyCallbackFinalizer);
+
+  std::thread([copy] { copy->run(); }).detach();
+}
+
+void CBLDart_CBLBlob_CreateFromFile(const CBLDatabase *db, FLString path,
+                                    FLString contentType,
+                                    CBLDart_AsyncCallback callback) {
+  CBLDart_StartBlobFileCopy(std::make_shared<CBLDart_BlobFileCopy>(
+                                db, nullptr, path, contentType, callback),
+                            callback);
+}
+
+void CBLDart_CBLBlob_WriteToFile(const CBLDatabase *db, const CBLBlob *blob,
+                                 FLString path,
+                                 CBLDart_AsyncCallback callback) {
+  CBLDart_StartBlobFileCopy(std::make_shared<CBLDart_BlobFileCopy>(
+                                db, blob, path, kFLSliceNull, callback),
+                            callback);
+}
+
+FLSliceResult CBLDart_BlobCache_Get(const CBLDatabase *db, FLString digest) {
+  auto content = CBLDart::BlobCache::instance().get(db, digest);
+  CBLDart::Stats::instance.blobBytesRead(content.size);
+  return content;
+}
+
+void CBLDart_BlobCache_Put(const CBLDatabase *db, FLString digest,
+                           FLSlice content) {
+  CBLDart::BlobCache::instance().put(db, digest, content);
+}
+
+void CBLDart_BlobCache_SetLimits(size_t maxSize, size_t maxEntrySize) {
+  CBLDart::BlobCache::instance().setLimits(maxSize, maxEntrySize);
+}
+
+CBLDart_BlobCacheStats CBLDart_BlobCache_Stats(void) {
+  return CBLDart::BlobCache::instance().stats();
+}
+
+static std::atomic<uint64_t> blobWrites = 0;
+static std::atomic<uint64_t> blobDeduplications = 0;
+static std::atomic<uint64_t> blobDeduplicatedSize = 0;
+
+bool CBLDart_CBLDatabase_SaveBlob(CBLDatabase *db, CBLBlob *blob,
+                                  CBLError *errorOut) {
+  // Looking up the existing blob is only a pre-check. If it fails, the blob
+  // is saved as usual.
+  CBLError error{};
+  auto existingBlob = CBLDatabase_GetBlob(db, CBLBlob_Properties(blob), &error);
+  if (existingBlob) {
+    CBLBlob_Release(existingBlob);
+    blobDeduplications.fetch_add(1, std::memory_order_relaxed);
+    blobDeduplicatedSize.fetch_add(CBLBlob_Length(blob),
+                                   std::memory_order_relaxed);
+    return true;
+  }
+
+  if (!CBLDatabase_SaveBlob(db, blob, errorOut)) {
+    return false;
+  }
+  blobWrites.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+CBLDart_BlobDeduplicationStats CBLDart_BlobDeduplication_Stats(void) {
+  return {
+      blobWrites.load(std::memory_order_relaxed),
+      blobDeduplications.load(std::memory_order_relaxed),
+      blobDeduplicatedSize.load(std::memory_order_relaxed),
+  };
+}
+
+/**
+ * Reads the content of a blob on a background thread into a `ChunkQueue`,
+ * from which the consumer takes the chunks without copying them.
+ *
+ * The reader thread sleeps while the queue is full and is woken up by the
+ * consumer when it takes a chunk. The consumer is notified through the
+ * callback when it has found the queue empty and the reader has pushed the
+ * next chunk or has finished.
+ */
+struct CBLDart_BlobReadAhead {
+  CBLDart_BlobReadAhead(const CBLDatabase *database, const CBLBlob *blob,
+                        uint64_t start, int64_t end, size_t chunkSize,
+                        size_t chunkCount, CBLDart_AsyncCallback callback)
+      : blob_(CBLBlob_Retain(blob)),
+        start_(start),
+        end_(end < 0 ? CBLBlob_Length(blob) : static_cast<uint64_t>(end)),
+        chunkSize_(chunkSize < 1 ? 1 : chunkSize),
+        queue_(chunkCount),
+        callback_(ASYNC_CALLBACK_FROM_C(callback)),
+        databaseLock_(CBLDart_CloneDatabaseLock(database)) {}
+
+  ~CBLDart_BlobReadAhead() {
+    CBLBlob_Release(blob_);
+    databaseLock_->release();
+  }
+
+  /**
+   * Must be called when the callback has been closed, after which it must not
+   * be called anymore. Stops the reader thread.
+   */
+  void callbackClosed() {
+    {
+      std::scoped_lock lock(mutex_);
+      callbackClosed_ = true;
+    }
+    readerCv_.notify_one();
+  }
+
+  CBLDart_BlobReadAheadResult next(FLSliceResult *chunkOut,
+                                   CBLError *errorOut) {
+    auto chunk = queue_.pop();
+    if (!chunk.buf) {
+      // The reader must see that the consumer is waiting, or the consumer
+      // must see the chunk or the end that the reader has pushed, or both.
+      consumerWaiting_.store(true);
+      auto finished = finished_.load();
+      chunk = queue_.pop();
+      if (!chunk.buf) {
+        if (!finished) {
+          return kCBLDart_BlobReadAheadPending;
+        }
+        consumerWaiting_.store(false);
+        if (error_.code != 0) {
+          *errorOut = error_;
+          return kCBLDart_BlobReadAheadError;
+        }
+        return kCBLDart_BlobReadAheadDone;
+      }
+      consumerWaiting_.store(false);
+    }
+
+    if (readerWaiting_.load()) {
+      std::scoped_lock lock(mutex_);
+      readerCv_.notify_one();
+    }
+
+    *chunkOut = chunk;
+    return kCBLDart_BlobReadAheadChunk;
+  }
+
+  void run() {
+    CBLError error{};
+    CBLBlobReadStream *reader;
+    {
+      auto databaseLock = databaseLock_->acquire();
+      reader = CBLBlob_OpenContentStream(blob_, &error);
+      if (reader && start_ > 0 &&
+          CBLBlobReader_Seek(reader, start_, kCBLSeekModeFromStart, &error) <
+              0) {
+        CBLBlobReader_Close(reader);
+        reader = nullptr;
+      }
+    }
+
+    auto position = start_;
+    while (reader && position < end_ && waitForSpace()) {
+      auto size = std::min<uint64_t>(chunkSize_, end_ - position);
+      auto chunk = FLSliceResult_New(size);
+
+      int bytesRead;
+      {
+        auto databaseLock = databaseLock_->acquire();
+        bytesRead = CBLBlobReader_Read(reader, const_cast<void *>(chunk.buf),
+                                       size, &error);
+      }
+      if (bytesRead <= 0) {
+        FLSliceResult_Release(chunk);
+        break;
+      }
+      CBLDart::Stats::instance.blobBytesRead(bytesRead);
+
+      chunk.size = bytesRead;
+      queue_.push(chunk);
+      position += bytesRead;
+      notifyConsumer();
+    }
+
+    if (reader) {
+      auto databaseLock = databaseLock_->acquire();
+      CBLBlobReader_Close(reader);
+    }
+
+    error_ = error;
+    finished_.store(true);
+    notifyConsumer();
+  }
+
+ private:
+  /**
+   * Waits until the queue has room for another chunk and returns `true`, or
+   * returns `false` if the callback has been closed.
+   */
+  bool waitForSpace() {
+    std::unique_lock lock(mutex_);
+    readerWaiting_.store(true);
+    readerCv_.wait(lock, [this] {
+      return callbackClosed_ || queue_.size() < queue_.capacity();
+    });
+    readerWaiting_.store(false);
+    return !callbackClosed_;
+  }
+
+  void notifyConsumer() {
+    if (!consumerWaiting_.exchange(false)) {
+      return;
+    }
 
-  auto bytesRead = CBLBlobReader_Read(stream, const_cast<void *>(buffer.buf),
-                                      bufferSize_t, outError);
+    Dart_CObject args{};
+    args.type = Dart_CObject_kArray;
+    args.value.as_array.length = 0;
+    args.value.as_array.values = nullptr;
 
-  // Handle error
-  if (bytesRead == -1) {
-    FLSliceResult_Release(buffer);
-    return {nullptr, 0};
+    std::scoped_lock lock(mutex_);
+    if (!callbackClosed_) {
+      CBLDart::AsyncCallbackCall(*callback_).execute(args);
+    }
   }
 
-  buffer.size = bytesRead;
+  const CBLBlob *blob_;
+  uint64_t start_;
+  uint64_t end_;
+  size_t chunkSize_;
+  CBLDart::ChunkQueue queue_;
+  CBLDart::AsyncCallback *callback_;
+  CBLDart_DatabaseLock *databaseLock_;
+
+  std::mutex mutex_;
+  std::condition_variable readerCv_;
+  bool callbackClosed_ = false;
+  std::atomic<bool> readerWaiting_ = false;
+  std::atomic<bool> consumerWaiting_ = false;
+  std::atomic<bool> finished_ = false;
+  CBLError error_{};
+};
+
+// The callback owns a reference to the read-ahead, which is released when the
+// callback is closed. The reader thread owns another one, until it has
+// finished.
+static void CBLDart_BlobReadAheadCallbackFinalizer(void *context) {
+  auto readAhead =
+      reinterpret_cast<std::shared_ptr<CBLDart_BlobReadAhead> *>(context);
+  (*readAhead)->callbackClosed();
+  delete readAhead;
+}
+
+CBLDart_BlobReadAhead *CBLDart_CBLBlob_ReadAhead(
+    const CBLDatabase *db, const CBLBlob *blob, uint64_t start, int64_t end,
+    size_t chunkSize, size_t chunkCount, CBLDart_AsyncCallback callback) {
+  auto readAhead = std::make_shared<CBLDart_BlobReadAhead>(
+      db, blob, start, end, chunkSize, chunkCount, callback);
 
-  return buffer;
+  ASYNC_CALLBACK_FROM_C(callback)->setFinalizer(
+      new std::shared_ptr<CBLDart_BlobReadAhead>(readAhead),
+      CBLDart_BlobReadAheadCallbackFinalizer);
+
+  std::thread([readAhead] { readAhead->run(); }).detach();
+
+  return readAhead.get();
+}
+
+CBLDart_BlobReadAheadResult CBLDart_BlobReadAhead_Next(
+    CBLDart_BlobReadAhead *readAhead, FLSliceResult *chunkOut,
+    CBLError *errorOut) {
+  return readAhead->next(chunkOut, errorOut);
 }
 
 // === Replicator
 
-typedef std::map<const CBLCollection *, CBLDart::AsyncCallback *>
-    ReplicatorCollectionCallbackMap;
+typedef std::map<const CBLCollection *, CBLDart::AsyncCallback *>
+    ReplicatorCollectionCallbackMap;
+
+typedef std::map<const CBLCollection *,
+                 std::unique_ptr<CBLDart::FilterExpression>>
+    ReplicatorCollectionFilterExpressionMap;
+
+/**
+ * A conflict resolution strategy of a collection, which is executed natively.
+ */
+struct ReplicatorConflictStrategy {
+  ReplicatorConflictStrategy(CBLDart_ConflictResolutionStrategy strategy,
+                             FLKeyPath timestampKeyPath)
+      : strategy(strategy), timestampKeyPath(timestampKeyPath) {}
+
+  ~ReplicatorConflictStrategy() {
+    if (timestampKeyPath) {
+      FLKeyPath_Free(timestampKeyPath);
+    }
+  }
+
+  ReplicatorConflictStrategy(const ReplicatorConflictStrategy &) = delete;
+  ReplicatorConflictStrategy &operator=(const ReplicatorConflictStrategy &) =
+      delete;
+
+  CBLDart_ConflictResolutionStrategy strategy;
+  FLKeyPath timestampKeyPath;
+};
+
+typedef std::map<const CBLCollection *,
+                 std::unique_ptr<ReplicatorConflictStrategy>>
+    ReplicatorCollectionConflictStrategyMap;
+
+/**
+ * The deadline and the latency budget of the calls of a replicator into Dart
+ * filters and conflict resolvers.
+ */
+struct ReplicatorCallbackLimits {
+  /** The deadline of a call, or `0` if calls wait for their result. */
+  std::chrono::milliseconds timeout{0};
+  /** The result of filter calls which miss their deadline. */
+  bool timeoutFilterResult = false;
+  /**
+   * The duration after which a call is counted as over budget, or `0` if
+   * calls are not counted.
+   */
+  std::chrono::milliseconds latencyBudget{0};
+  CBLDart::ReplicatorMetrics *metrics = nullptr;
+
+  bool hasTimeout() const { return timeout.count() > 0; }
+
+  /**
+   * Executes the blocking `call` with `args` and counts it in the metrics if
+   * it is over budget or misses its deadline.
+   *
+   * If the call misses its deadline, `false` is returned and
+   * `abandonedHandler` is called once the Dart side has handled the call.
+   */
+  bool execute(CBLDart::AsyncCallbackCall &call, Dart_CObject &args,
+               CBLDart::AbandonedCallHandler abandonedHandler) const {
+    if (hasTimeout()) {
+      call.setTimeout(timeout, std::move(abandonedHandler));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    call.execute(args);
+
+    if (call.didTimeOut()) {
+      metrics->callbackTimedOut();
+      return false;
+    }
+    if (latencyBudget.count() > 0 &&
+        std::chrono::steady_clock::now() - start > latencyBudget) {
+      metrics->callbackOverBudget();
+    }
+    return true;
+  }
+};
+
+/**
+ * Calls a Dart replication filter with batches of documents.
+ *
+ * LiteCore can call a filter from multiple threads at the same time. Instead
+ * of making one round trip to Dart per document, the calls that arrive while
+ * a batch is being filtered in Dart are collected and sent as the next batch,
+ * in one `AsyncCallbackCall`. A call which finds no batch in flight is sent
+ * right away, so that filtering documents one at a time is not delayed.
+ *
+ * The arguments of a call are the pointers and flags of the documents,
+ * interleaved. The result is a bitset with the decision for each document, or
+ * a single boolean for all documents.
+ */
+class ReplicatorFilterBatcher {
+ public:
+  static constexpr size_t kMaxBatchSize = 64;
+
+  ReplicatorFilterBatcher(CBLDart::AsyncCallback *callback,
+                          const ReplicatorCallbackLimits &limits)
+      : callback_(callback), limits_(limits) {}
+
+  ReplicatorFilterBatcher(const ReplicatorFilterBatcher &) = delete;
+  ReplicatorFilterBatcher &operator=(const ReplicatorFilterBatcher &) =
+      delete;
+
+  bool filter(CBLDocument *document, CBLDocumentFlags flags) {
+    Request request{document, flags};
+
+    std::unique_lock lock(mutex_);
+    pending_.push_back(&request);
+
+    while (!request.done) {
+      if (sending_) {
+        cv_.wait(lock);
+        continue;
+      }
+
+      // Become the sender of the next batch, which does not necessarily
+      // include the request of this thread.
+      sending_ = true;
+      auto batchSize = std::min(pending_.size(), kMaxBatchSize);
+      std::vector<Request *> batch(pending_.begin(),
+                                   pending_.begin() + batchSize);
+      pending_.erase(pending_.begin(), pending_.begin() + batchSize);
+      lock.unlock();
+
+      try {
+        sendBatch(batch);
+      } catch (...) {
+        lock.lock();
+        finishBatch(batch);
+        pending_.erase(std::remove(pending_.begin(), pending_.end(), &request),
+                       pending_.end());
+        throw;
+      }
+
+      lock.lock();
+      finishBatch(batch);
+    }
+
+    return request.decision;
+  }
+
+ private:
+  struct Request {
+    CBLDocument *document;
+    CBLDocumentFlags flags;
+    bool decision = false;
+    bool done = false;
+  };
+
+  void finishBatch(const std::vector<Request *> &batch) {
+    for (auto request : batch) {
+      request->done = true;
+    }
+    sending_ = false;
+    cv_.notify_all();
+  }
+
+  void sendBatch(const std::vector<Request *> &batch) {
+    CBLDart::MessageArena::Scope arenaScope;
+    auto &arena = arenaScope.arena();
+    auto argsObjects = arena.allocateArray<Dart_CObject>(batch.size() * 2);
+    auto argsValues = arena.allocateArray<Dart_CObject *>(batch.size() * 2);
+    for (size_t i = 0; i < batch.size(); i++) {
+      auto &document = argsObjects[i * 2];
+      CBLDart_CObject_SetPointer(&document, batch[i]->document);
+
+      auto &flags = argsObjects[i * 2 + 1];
+      flags.type = Dart_CObject_kInt32;
+      flags.value.as_int32 = batch[i]->flags;
+
+      argsValues[i * 2] = &document;
+      argsValues[i * 2 + 1] = &flags;
+    }
+
+    Dart_CObject args{};
+    args.type = Dart_CObject_kArray;
+    args.value.as_array.length = batch.size() * 2;
+    args.value.as_array.values = argsValues;
+
+    auto resultHandler = [&](Dart_CObject *result) {
+      const uint8_t *bitset = nullptr;
+      switch (result->type) {
+        case Dart_CObject_kBool:
+          // The filter threw an exception.
+          for (auto request : batch) {
+            request->decision = result->value.as_bool;
+          }
+          return;
+        case Dart_CObject_kTypedData:
+          bitset = result->value.as_typed_data.values;
+          break;
+        case Dart_CObject_kExternalTypedData:
+          bitset = result->value.as_external_typed_data.data;
+          break;
+        default:
+          throw std::logic_error(
+              "Unexpected result from replication filter, with "
+              "Dart_CObject_Type: " +
+              std::to_string(result->type));
+      }
+
+      for (size_t i = 0; i < batch.size(); i++) {
+        batch[i]->decision = (bitset[i >> 3] >> (i & 7)) & 1;
+      }
+    };
+
+    // With a deadline, the documents are retained until the Dart side has
+    // handled the call, since they are released by LiteCore when a call which
+    // missed its deadline returns.
+    std::vector<const CBLDocument *> documents;
+    if (limits_.hasTimeout()) {
+      documents.reserve(batch.size());
+      for (auto request : batch) {
+        documents.push_back(CBLDocument_Retain(request->document));
+      }
+    }
+    auto releaseDocuments = [documents](Dart_CObject *) {
+      for (auto document : documents) {
+        CBLDocument_Release(document);
+      }
+    };
+
+    CBLDart::AsyncCallbackCall call(*callback_, resultHandler);
+    if (!limits_.execute(call, args, releaseDocuments)) {
+      for (auto request : batch) {
+        request->decision = limits_.timeoutFilterResult;
+      }
+      return;
+    }
+    releaseDocuments(nullptr);
+  }
+
+  CBLDart::AsyncCallback *callback_;
+  const ReplicatorCallbackLimits &limits_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<Request *> pending_;
+  bool sending_ = false;
+};
+
+typedef std::map<const CBLCollection *,
+                 std::unique_ptr<ReplicatorFilterBatcher>>
+    ReplicatorCollectionFilterMap;
 
 struct ReplicatorCallbackWrapperContext {
-  ReplicatorCollectionCallbackMap pushFilters;
-  ReplicatorCollectionCallbackMap pullFilters;
+  ReplicatorCollectionFilterMap pushFilters;
+  ReplicatorCollectionFilterMap pullFilters;
+  ReplicatorCollectionFilterExpressionMap pushFilterExpressions;
+  ReplicatorCollectionFilterExpressionMap pullFilterExpressions;
   ReplicatorCollectionCallbackMap conflictResolvers;
+  ReplicatorCollectionConflictStrategyMap conflictStrategies;
+  CBLDart_DatabaseLock *databaseLock = nullptr;
+  CBLDart::ReplicatorMetrics metrics;
+  ReplicatorCallbackLimits callbackLimits;
+  CBLListenerToken *metricsListenerToken = nullptr;
 
   void retainCollections() {
     for (auto &pair : pushFilters) {
@@ -628,9 +3992,18 @@ struct ReplicatorCallbackWrapperContext {
     for (auto &pair : pullFilters) {
       CBLCollection_Retain(pair.first);
     }
+    for (auto &pair : pushFilterExpressions) {
+      CBLCollection_Retain(pair.first);
+    }
+    for (auto &pair : pullFilterExpressions) {
+      CBLCollection_Retain(pair.first);
+    }
     for (auto &pair : conflictResolvers) {
       CBLCollection_Retain(pair.first);
     }
+    for (auto &pair : conflictStrategies) {
+      CBLCollection_Retain(pair.first);
+    }
   }
 
   void releaseCollections() {
@@ -640,44 +4013,57 @@ struct ReplicatorCallbackWrapperContext {
     for (auto &pair : pullFilters) {
       CBLCollection_Release(pair.first);
     }
+    for (auto &pair : pushFilterExpressions) {
+      CBLCollection_Release(pair.first);
+    }
+    for (auto &pair : pullFilterExpressions) {
+      CBLCollection_Release(pair.first);
+    }
     for (auto &pair : conflictResolvers) {
       CBLCollection_Release(pair.first);
     }
+    for (auto &pair : conflictStrategies) {
+      CBLCollection_Release(pair.first);
+    }
   }
 
-  ~ReplicatorCallbackWrapperContext() { releaseCollections(); }
+  ~ReplicatorCallbackWrapperContext() {
+    releaseCollections();
+    if (databaseLock) {
+      databaseLock->release();
+    }
+  }
 };
 
 static std::map<CBLReplicator *, ReplicatorCallbackWrapperContext *>
     replicatorCallbackWrapperContexts;
 static std::mutex replicatorCallbackWrapperContextsMutex;
 
-static bool CBLDart_ReplicatorFilterWrapper(CBLDart::AsyncCallback *callback,
-                                            CBLDocument *document,
-                                            CBLDocumentFlags flags) {
-  Dart_CObject document_{};
-  CBLDart_CObject_SetPointer(&document_, document);
-
-  Dart_CObject flags_{};
-  flags_.type = Dart_CObject_kInt32;
-  flags_.value.as_int32 = flags;
-
-  Dart_CObject *argsValues[] = {&document_, &flags_};
-
-  Dart_CObject args{};
-  args.type = Dart_CObject_kArray;
-  args.value.as_array.length = 2;
-  args.value.as_array.values = argsValues;
-
-  bool decision;
+/**
+ * Evaluates the filter expression and then the filter callback of the
+ * collection of `document`, if they exist.
+ *
+ * The filter expression is evaluated first, so that the round trip to Dart
+ * is only made for documents which pass it.
+ */
+static bool CBLDart_ReplicatorCollectionFilter(
+    const ReplicatorCollectionFilterExpressionMap &filterExpressions,
+    const ReplicatorCollectionFilterMap &filters, CBLDocument *document,
+    CBLDocumentFlags flags) {
+  auto collection = CBLDocument_Collection(document);
 
-  auto resultHandler = [&](Dart_CObject *result) {
-    decision = result->value.as_bool;
-  };
+  auto filterExpression = filterExpressions.find(collection);
+  if (filterExpression != filterExpressions.end() &&
+      !filterExpression->second->evaluate(document, flags)) {
+    return false;
+  }
 
-  CBLDart::AsyncCallbackCall(*callback, resultHandler).execute(args);
+  auto filter = filters.find(collection);
+  if (filter != filters.end()) {
+    return filter->second->filter(document, flags);
+  }
 
-  return decision;
+  return true;
 }
 
 static bool CBLDart_ReplicatorPushFilterWrapper(void *context,
@@ -685,9 +4071,11 @@ static bool CBLDart_ReplicatorPushFilterWrapper(void *context,
                                                 CBLDocumentFlags flags) {
   auto wrapperContext =
       reinterpret_cast<ReplicatorCallbackWrapperContext *>(context);
-  auto collection = CBLDocument_Collection(document);
-  return CBLDart_ReplicatorFilterWrapper(
-      wrapperContext->pushFilters[collection], document, flags);
+  CBLDart::LatencyTimer timer(wrapperContext->metrics.pushFilter);
+  CBLDart::TimelineSpan span("CBLDart ReplicatorPushFilter");
+  return CBLDart_ReplicatorCollectionFilter(
+      wrapperContext->pushFilterExpressions, wrapperContext->pushFilters,
+      document, flags);
 }
 
 static bool CBLDart_ReplicatorPullFilterWrapper(void *context,
@@ -695,9 +4083,102 @@ static bool CBLDart_ReplicatorPullFilterWrapper(void *context,
                                                 CBLDocumentFlags flags) {
   auto wrapperContext =
       reinterpret_cast<ReplicatorCallbackWrapperContext *>(context);
-  auto collection = CBLDocument_Collection(document);
-  return CBLDart_ReplicatorFilterWrapper(
-      wrapperContext->pullFilters[collection], document, flags);
+  CBLDart::LatencyTimer timer(wrapperContext->metrics.pullFilter);
+  CBLDart::TimelineSpan span("CBLDart ReplicatorPullFilter");
+  return CBLDart_ReplicatorCollectionFilter(
+      wrapperContext->pullFilterExpressions, wrapperContext->pullFilters,
+      document, flags);
+}
+
+/**
+ * Compares the values of two timestamps, which are either numbers or strings.
+ *
+ * A timestamp wins against a missing timestamp or one with a different type.
+ * Returns a negative number, zero or a positive number if `local` is less
+ * than, equal to or greater than `remote`.
+ */
+static int CBLDart_CompareConflictTimestamps(FLValue local, FLValue remote) {
+  auto localType = FLValue_GetType(local);
+  auto remoteType = FLValue_GetType(remote);
+  auto localIsTimestamp = localType == kFLNumber || localType == kFLString;
+  auto remoteIsTimestamp = remoteType == kFLNumber || remoteType == kFLString;
+
+  if (!localIsTimestamp || !remoteIsTimestamp || localType != remoteType) {
+    return static_cast<int>(localIsTimestamp) -
+           static_cast<int>(remoteIsTimestamp);
+  }
+
+  if (localType == kFLString) {
+    return FLSlice_Compare(FLValue_AsString(local), FLValue_AsString(remote));
+  }
+
+  if (FLValue_IsInteger(local) && FLValue_IsInteger(remote)) {
+    auto localInt = FLValue_AsInt(local);
+    auto remoteInt = FLValue_AsInt(remote);
+    return localInt < remoteInt ? -1 : (localInt > remoteInt ? 1 : 0);
+  }
+
+  auto localDouble = FLValue_AsDouble(local);
+  auto remoteDouble = FLValue_AsDouble(remote);
+  return localDouble < remoteDouble ? -1 : (localDouble > remoteDouble ? 1 : 0);
+}
+
+/**
+ * Resolves a conflict with one of the built-in strategies.
+ *
+ * Like a Dart conflict resolver, this function returns `localDocument` or
+ * `remoteDocument` without retaining them, and new documents with a
+ * reference count of +1.
+ */
+static const CBLDocument *CBLDart_ResolveConflictWithStrategy(
+    const ReplicatorConflictStrategy &strategy,
+    const CBLDocument *localDocument, const CBLDocument *remoteDocument) {
+  switch (strategy.strategy) {
+    case kCBLDart_ConflictResolutionRemoteWins:
+      return remoteDocument;
+    case kCBLDart_ConflictResolutionLocalWins:
+      return localDocument;
+    default:
+      break;
+  }
+
+  // With the remaining strategies a deletion wins.
+  if (!localDocument || !remoteDocument) {
+    return nullptr;
+  }
+
+  auto localProperties = CBLDocument_Properties(localDocument);
+  auto remoteProperties = CBLDocument_Properties(remoteDocument);
+
+  if (strategy.strategy == kCBLDart_ConflictResolutionMergeDicts) {
+    auto mergedDocument = CBLDocument_MutableCopy(remoteDocument);
+    auto mergedProperties = CBLDocument_MutableProperties(mergedDocument);
+
+    FLDictIterator iterator;
+    FLDictIterator_Begin(localProperties, &iterator);
+    FLValue value;
+    while ((value = FLDictIterator_GetValue(&iterator))) {
+      FLSlot_SetValue(FLMutableDict_Set(mergedProperties,
+                                        FLDictIterator_GetKeyString(&iterator)),
+                      value);
+      FLDictIterator_Next(&iterator);
+    }
+
+    return mergedDocument;
+  }
+
+  auto comparison = CBLDart_CompareConflictTimestamps(
+      FLKeyPath_Eval(strategy.timestampKeyPath,
+                     reinterpret_cast<FLValue>(localProperties)),
+      FLKeyPath_Eval(strategy.timestampKeyPath,
+                     reinterpret_cast<FLValue>(remoteProperties)));
+  if (comparison == 0) {
+    // Fall back to the strategy of the default conflict resolver.
+    comparison = FLSlice_Compare(CBLDocument_RevisionID(localDocument),
+                                 CBLDocument_RevisionID(remoteDocument));
+  }
+
+  return comparison > 0 ? localDocument : remoteDocument;
 }
 
 static const CBLDocument *CBLDart_ReplicatorConflictResolverWrapper(
@@ -705,8 +4186,17 @@ static const CBLDocument *CBLDart_ReplicatorConflictResolverWrapper(
     const CBLDocument *remoteDocument) {
   auto wrapperContext =
       reinterpret_cast<ReplicatorCallbackWrapperContext *>(context);
+  CBLDart::LatencyTimer timer(wrapperContext->metrics.conflictResolver);
+  CBLDart::TimelineSpan span("CBLDart ReplicatorConflictResolver");
   auto collection =
       CBLDocument_Collection(localDocument ? localDocument : remoteDocument);
+
+  auto strategy = wrapperContext->conflictStrategies.find(collection);
+  if (strategy != wrapperContext->conflictStrategies.end()) {
+    return CBLDart_ResolveConflictWithStrategy(*strategy->second,
+                                               localDocument, remoteDocument);
+  }
+
   auto callback = wrapperContext->conflictResolvers[collection];
 
   Dart_CObject documentID_{};
@@ -725,7 +4215,7 @@ static const CBLDocument *CBLDart_ReplicatorConflictResolverWrapper(
   args.value.as_array.length = 3;
   args.value.as_array.values = argsValues;
 
-  const CBLDocument *decision;
+  const CBLDocument *decision = nullptr;
   auto resolverThrewException = false;
 
   auto resultHandler = [&](Dart_CObject *result) {
@@ -756,15 +4246,55 @@ static const CBLDocument *CBLDart_ReplicatorConflictResolverWrapper(
     }
   };
 
-  CBLDart::AsyncCallbackCall(*callback, resultHandler).execute(args);
+  // With a deadline, the documents are retained until the Dart side has
+  // handled the call, like the documents of filter calls. The Dart side
+  // always retains the document it resolves to, so a document which the
+  // resolver returns after the deadline is released as well, even if it is
+  // the local or remote document.
+  const CBLDocument *local_ = nullptr;
+  const CBLDocument *remote_ = nullptr;
+  if (wrapperContext->callbackLimits.hasTimeout()) {
+    local_ = CBLDocument_Retain(const_cast<CBLDocument *>(localDocument));
+    remote_ = CBLDocument_Retain(const_cast<CBLDocument *>(remoteDocument));
+  }
+  auto releaseDocuments = [local_, remote_](Dart_CObject *result) {
+    if (result && (result->type == Dart_CObject_kInt32 ||
+                   result->type == Dart_CObject_kInt64)) {
+      CBLDocument_Release(reinterpret_cast<const CBLDocument *>(
+          CBLDart_CObject_getIntValueAsInt64(result)));
+    }
+    CBLDocument_Release(local_);
+    CBLDocument_Release(remote_);
+  };
+
+  CBLDart::AsyncCallbackCall call(*callback, resultHandler);
+  if (!wrapperContext->callbackLimits.execute(call, args, releaseDocuments)) {
+    // A resolver which misses its deadline resolves to the local revision.
+    return localDocument;
+  }
+  releaseDocuments(nullptr);
 
   if (resolverThrewException) {
     throw std::runtime_error("Replicator conflict resolver threw an exception");
   }
 
+  // The replicator only expects a new document to be retained. The local and
+  // remote documents are still retained by the replicator, so the reference
+  // from the Dart side can be released right away.
+  if (decision && (decision == localDocument || decision == remoteDocument)) {
+    CBLDocument_Release(decision);
+  }
+
   return decision;
 }
 
+static void CBLDart_ReplicatorMetrics_DocumentReplicationListener(
+    void *context, CBLReplicator *replicator, bool isPush,
+    unsigned numDocuments, const CBLReplicatedDocument *documents) {
+  reinterpret_cast<ReplicatorCallbackWrapperContext *>(context)
+      ->metrics.documentsReplicated(isPush, numDocuments, documents);
+}
+
 CBLReplicator *CBLDart_CBLReplicator_Create(
     CBLDart_ReplicatorConfiguration *config, CBLError *errorOut) {
   CBLReplicatorConfiguration config_{};
@@ -791,8 +4321,61 @@ CBLReplicator *CBLDart_CBLReplicator_Create(
   config_.collections = replicationCollections.data();
   config_.collectionCount = config->collectionsCount;
 
+  // Filter expressions and conflict strategies are compiled before anything
+  // else is set up, so that invalid ones can be reported without having to
+  // clean up.
+  std::vector<std::unique_ptr<CBLDart::FilterExpression>>
+      pushFilterExpressions(config->collectionsCount);
+  std::vector<std::unique_ptr<CBLDart::FilterExpression>>
+      pullFilterExpressions(config->collectionsCount);
+  std::vector<std::unique_ptr<ReplicatorConflictStrategy>> conflictStrategies(
+      config->collectionsCount);
+  for (size_t i = 0; i < config->collectionsCount; i++) {
+    auto &replicationCollection = config->collections[i];
+
+    if (replicationCollection.pushFilterExpression.buf) {
+      pushFilterExpressions[i] = CBLDart::FilterExpression::compile(
+          replicationCollection.pushFilterExpression, errorOut);
+      if (!pushFilterExpressions[i]) {
+        return nullptr;
+      }
+    }
+
+    if (replicationCollection.pullFilterExpression.buf) {
+      pullFilterExpressions[i] = CBLDart::FilterExpression::compile(
+          replicationCollection.pullFilterExpression, errorOut);
+      if (!pullFilterExpressions[i]) {
+        return nullptr;
+      }
+    }
+
+    auto strategy = replicationCollection.conflictResolutionStrategy;
+    if (strategy != kCBLDart_ConflictResolutionCustom) {
+      FLKeyPath timestampKeyPath = nullptr;
+      if (strategy == kCBLDart_ConflictResolutionLastWriteWins) {
+        FLError flError;
+        timestampKeyPath = FLKeyPath_New(
+            replicationCollection.conflictResolutionTimestampKeyPath, &flError);
+        if (!timestampKeyPath) {
+          *errorOut = {kCBLFleeceDomain, static_cast<int>(flError), 0};
+          return nullptr;
+        }
+      }
+      conflictStrategies[i] =
+          std::make_unique<ReplicatorConflictStrategy>(strategy,
+                                                       timestampKeyPath);
+    }
+  }
+
   auto context = new ReplicatorCallbackWrapperContext;
   config_.context = context;
+  context->callbackLimits.timeout =
+      std::chrono::milliseconds(config->callbackTimeoutMs);
+  context->callbackLimits.timeoutFilterResult =
+      config->callbackTimeoutFilterResult;
+  context->callbackLimits.latencyBudget =
+      std::chrono::milliseconds(config->callbackLatencyBudgetMs);
+  context->callbackLimits.metrics = &context->metrics;
 
   for (size_t i = 0; i < config->collectionsCount; i++) {
     auto replicationCollection = config->collections[i];
@@ -805,19 +4388,40 @@ CBLReplicator *CBLDart_CBLReplicator_Create(
     replicationCollection_->channels = replicationCollection.channels;
     replicationCollection_->documentIDs = replicationCollection.documentIDs;
 
-    if (replicationCollection.pushFilter) {
+    if (replicationCollection.pushFilter || pushFilterExpressions[i]) {
       replicationCollection_->pushFilter = CBLDart_ReplicatorPushFilterWrapper;
+    }
+    if (replicationCollection.pushFilter) {
       context->pushFilters[collection] =
-          ASYNC_CALLBACK_FROM_C(replicationCollection.pushFilter);
+          std::make_unique<ReplicatorFilterBatcher>(
+              ASYNC_CALLBACK_FROM_C(replicationCollection.pushFilter),
+              context->callbackLimits);
+    }
+    if (pushFilterExpressions[i]) {
+      context->pushFilterExpressions[collection] =
+          std::move(pushFilterExpressions[i]);
     }
 
-    if (replicationCollection.pullFilter) {
+    if (replicationCollection.pullFilter || pullFilterExpressions[i]) {
       replicationCollection_->pullFilter = CBLDart_ReplicatorPullFilterWrapper;
+    }
+    if (replicationCollection.pullFilter) {
       context->pullFilters[collection] =
-          ASYNC_CALLBACK_FROM_C(replicationCollection.pullFilter);
+          std::make_unique<ReplicatorFilterBatcher>(
+              ASYNC_CALLBACK_FROM_C(replicationCollection.pullFilter),
+              context->callbackLimits);
+    }
+    if (pullFilterExpressions[i]) {
+      context->pullFilterExpressions[collection] =
+          std::move(pullFilterExpressions[i]);
     }
 
-    if (replicationCollection.conflictResolver) {
+    if (conflictStrategies[i]) {
+      replicationCollection_->conflictResolver =
+          CBLDart_ReplicatorConflictResolverWrapper;
+      context->conflictStrategies[collection] =
+          std::move(conflictStrategies[i]);
+    } else if (replicationCollection.conflictResolver) {
       replicationCollection_->conflictResolver =
           CBLDart_ReplicatorConflictResolverWrapper;
       context->conflictResolvers[collection] =
@@ -832,10 +4436,14 @@ CBLReplicator *CBLDart_CBLReplicator_Create(
   if (replicator) {
     // Associate callback context with this instance so we can it released
     // when the replicator is released.
+    context->databaseLock = CBLDart_CloneDatabaseLock(config->database);
+    context->metricsListenerToken =
+        CBLReplicator_AddDocumentReplicationListener(
+            replicator, CBLDart_ReplicatorMetrics_DocumentReplicationListener,
+            context);
+
     std::scoped_lock lock(replicatorCallbackWrapperContextsMutex);
     replicatorCallbackWrapperContexts[replicator] = context;
-
-    CBLDart_CloneDatabaseLock(config->database, replicator);
   } else {
     delete context;
   }
@@ -843,40 +4451,137 @@ CBLReplicator *CBLDart_CBLReplicator_Create(
   return replicator;
 }
 
-static void CBLDart_CBLReplicator_Release_Internal(CBLReplicator *replicator) {
+void CBLDart_ReplicatorScheduler_SetMaxActive(uint32_t maxActive) {
+  CBLDart::ReplicatorScheduler::instance().setMaxActive(maxActive);
+}
+
+CBLDart_ReplicatorSchedulerStats CBLDart_ReplicatorScheduler_Stats(void) {
+  return CBLDart::ReplicatorScheduler::instance().stats();
+}
+
+void CBLDart_CBLReplicator_Schedule(const CBLDatabase *db,
+                                    CBLReplicator *replicator,
+                                    bool resetCheckpoint, int32_t priority) {
+  CBLDart::ReplicatorScheduler::instance().schedule(db, replicator,
+                                                    resetCheckpoint, priority);
+}
+
+bool CBLDart_CBLReplicator_Unschedule(CBLReplicator *replicator) {
+  return CBLDart::ReplicatorScheduler::instance().unschedule(replicator);
+}
+
+static void CBLDart_CBLReplicator_Release_Internal(
+    CBLReplicator *replicator, ReplicatorCallbackWrapperContext *context) {
+  CBLDart::TimelineSpan span("CBLDart ReplicatorRelease");
+  CBLListener_Remove(context->metricsListenerToken);
+
   // Release the replicator.
   CBLReplicator_Release(replicator);
 
   // Clean up context for callback wrappers as the last step.
-  std::scoped_lock lock(replicatorCallbackWrapperContextsMutex);
-  auto nh = replicatorCallbackWrapperContexts.extract(replicator);
-  delete nh.mapped();
-
-  CBLDart_ReleaseDatabaseLock(replicator);
+  delete context;
 }
 
-void CBLDart_CBLReplicator_Release(CBLReplicator *replicator) {
-  if (CBLReplicator_Status(replicator).activity == kCBLReplicatorStopped) {
-    CBLDart_CBLReplicator_Release_Internal(replicator);
-  } else {
+/**
+ * A replicator which is being released, once it has stopped.
+ *
+ * Whether the replicator has stopped is observed through a change listener,
+ * and the replicator is released on the cleanup executor, since it cannot be
+ * released from within one of its own listeners.
+ *
+ * The replicator is only released once the finalizer, which stops it, is done
+ * with it as well, since it can stop while the finalizer is still using it.
+ */
+struct ReplicatorRelease {
+  CBLReplicator *replicator;
+  ReplicatorCallbackWrapperContext *context;
+  CBLListenerToken *listenerToken = nullptr;
+
+  std::mutex mutex;
+  bool hasStopped = false;
+  bool isFinalizerDone = false;
+
+  /** Must be called once the replicator has stopped. */
+  void stopped() {
     {
-      // Stop the replicator, since it is still running.
-      auto databaseLock = CBLDart_AcquireDatabaseLock(replicator);
-      CBLReplicator_Stop(replicator);
+      std::scoped_lock lock(mutex);
+      if (hasStopped) {
+        return;
+      }
+      hasStopped = true;
+      if (!isFinalizerDone) {
+        return;
+      }
     }
+    schedule();
+  }
 
-    // Get of the Dart finalizer thread.
-    auto _ = std::async(std::launch::async, [=]() {
-      // Wait for the replicator to stop.
-      while (CBLReplicator_Status(replicator).activity !=
-             kCBLReplicatorStopped) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  /** Must be called once the finalizer does not use the replicator anymore. */
+  void finalizerDone() {
+    {
+      std::scoped_lock lock(mutex);
+      isFinalizerDone = true;
+      if (!hasStopped) {
+        return;
       }
+    }
+    schedule();
+  }
 
-      // Now release the replicator.
-      CBLDart_CBLReplicator_Release_Internal(replicator);
+ private:
+  void schedule() {
+    CBLDart::Executor::cleanup().submit([this]() {
+      CBLListener_Remove(listenerToken);
+      CBLDart_CBLReplicator_Release_Internal(replicator, context);
+      delete this;
     });
   }
+};
+
+static void CBLDart_ReplicatorRelease_ChangeListener(
+    void *context, CBLReplicator *replicator,
+    const CBLReplicatorStatus *status) {
+  if (status->activity == kCBLReplicatorStopped) {
+    reinterpret_cast<ReplicatorRelease *>(context)->stopped();
+  }
+}
+
+void CBLDart_CBLReplicator_Release(CBLReplicator *replicator) {
+  CBLDart::ReplicatorScheduler::instance().unschedule(replicator);
+
+  ReplicatorCallbackWrapperContext *context;
+  {
+    std::scoped_lock lock(replicatorCallbackWrapperContextsMutex);
+    auto nh = replicatorCallbackWrapperContexts.extract(replicator);
+    context = nh.mapped();
+  }
+
+  if (CBLReplicator_Status(replicator).activity == kCBLReplicatorStopped) {
+    CBLDart_CBLReplicator_Release_Internal(replicator, context);
+    return;
+  }
+
+  // The replicator is still running and is released once it has stopped,
+  // without blocking the Dart finalizer thread.
+  auto release = new ReplicatorRelease{replicator, context};
+  {
+    std::scoped_lock lock(release->mutex);
+    release->listenerToken = CBLReplicator_AddChangeListener(
+        replicator, CBLDart_ReplicatorRelease_ChangeListener, release);
+  }
+
+  // The replicator might have stopped before the listener was added.
+  if (CBLReplicator_Status(replicator).activity == kCBLReplicatorStopped) {
+    release->stopped();
+  } else {
+    // Stop the replicator, since it is still running.
+    auto databaseLock = context->databaseLock->acquire();
+    CBLReplicator_Stop(replicator);
+  }
+
+  // `release`, the replicator and `context` must not be used after this call,
+  // since they might be released by it.
+  release->finalizerDone();
 }
 
 class ReplicatorStatus_CObject_Helper {
@@ -940,11 +4645,8 @@ class ReplicatorStatus_CObject_Helper {
   FLSliceResult errorMessageStr = {nullptr, 0};
 };
 
-static void CBLDart_Replicator_ChangeListenerWrapper(
-    void *context, CBLReplicator *replicator,
-    const CBLReplicatorStatus *status) {
-  auto callback = ASYNC_CALLBACK_FROM_C(context);
-
+static void CBLDart_Replicator_SendStatus(CBLDart::AsyncCallback *callback,
+                                          const CBLReplicatorStatus *status) {
   ReplicatorStatus_CObject_Helper cObjectStatus;
   cObjectStatus.init(status);
 
@@ -958,125 +4660,271 @@ static void CBLDart_Replicator_ChangeListenerWrapper(
   CBLDart::AsyncCallbackCall(*callback).execute(args);
 }
 
+static void CBLDart_Replicator_ChangeListenerWrapper(
+    void *context, CBLReplicator *replicator,
+    const CBLReplicatorStatus *status) {
+  CBLDart::Stats::instance.listenerInvoked();
+  CBLDart::TimelineSpan span("CBLDart ReplicatorChangeListener");
+  CBLDart_Replicator_SendStatus(ASYNC_CALLBACK_FROM_C(context), status);
+}
+
+/**
+ * The context of a replicator change listener, whose progress updates are
+ * throttled.
+ *
+ * Changes of the activity level and errors are delivered immediately, while
+ * other status changes, which only update the progress, are coalesced and
+ * delivered at most once per minimum interval, with the latest status.
+ */
+struct CBLDart_ReplicatorListenerContext {
+  CBLDart::AsyncCallback *callback;
+  std::shared_ptr<CBLDart::ListenerThrottle> throttle;
+  CBLListenerToken *listenerToken = nullptr;
+  CBLDart_DatabaseLock *databaseLock;
+
+  std::mutex mutex;
+  CBLReplicatorStatus status{};
+  int lastActivity = -1;
+};
+
+static void CBLDart_Replicator_ThrottledChangeListenerWrapper(
+    void *context, CBLReplicator *replicator,
+    const CBLReplicatorStatus *status) {
+  CBLDart::Stats::instance.listenerInvoked();
+  CBLDart::TimelineSpan span("CBLDart ReplicatorChangeListener");
+  auto listenerContext =
+      reinterpret_cast<CBLDart_ReplicatorListenerContext *>(context);
+
+  bool isTransition;
+  {
+    std::scoped_lock lock(listenerContext->mutex);
+    isTransition = status->activity != listenerContext->lastActivity ||
+                   status->error.code != 0;
+    listenerContext->lastActivity = status->activity;
+    listenerContext->status = *status;
+  }
+
+  if (isTransition) {
+    listenerContext->throttle->notifyNow();
+  } else {
+    listenerContext->throttle->notify();
+  }
+}
+
+static void CBLDart_Replicator_ThrottledChangeListenerFinalizer(
+    void *context) {
+  auto listenerContext =
+      reinterpret_cast<CBLDart_ReplicatorListenerContext *>(context);
+  {
+    auto databaseLock = listenerContext->databaseLock->acquire();
+    CBLListener_Remove(listenerContext->listenerToken);
+  }
+  listenerContext->databaseLock->release();
+  listenerContext->throttle->stop();
+  delete listenerContext;
+}
+
 void CBLDart_CBLReplicator_AddChangeListener(const CBLDatabase *db,
                                              CBLReplicator *replicator,
+                                             uint32_t minIntervalMs,
                                              CBLDart_AsyncCallback listener) {
-  auto listenerToken = CBLReplicator_AddChangeListener(
-      replicator, CBLDart_Replicator_ChangeListenerWrapper, listener);
+  if (minIntervalMs == 0) {
+    auto listenerToken = CBLReplicator_AddChangeListener(
+        replicator, CBLDart_Replicator_ChangeListenerWrapper, listener);
 
-  CBLDart_CloneDatabaseLock(db, listenerToken);
+    CBLDart_SetListenerFinalizer(db, listenerToken, listener);
+    return;
+  }
 
-  ASYNC_CALLBACK_FROM_C(listener)->setFinalizer(listenerToken,
-                                                CBLDart_CBLListenerFinalizer);
+  auto callback = ASYNC_CALLBACK_FROM_C(listener);
+  auto listenerContext = new CBLDart_ReplicatorListenerContext{
+      callback, nullptr, nullptr, CBLDart_CloneDatabaseLock(db)};
+  listenerContext->throttle = std::make_shared<CBLDart::ListenerThrottle>(
+      std::chrono::milliseconds(minIntervalMs), [listenerContext]() {
+        CBLReplicatorStatus status;
+        {
+          std::scoped_lock lock(listenerContext->mutex);
+          status = listenerContext->status;
+        }
+        CBLDart_Replicator_SendStatus(listenerContext->callback, &status);
+      });
+
+  listenerContext->listenerToken = CBLReplicator_AddChangeListener(
+      replicator, CBLDart_Replicator_ThrottledChangeListenerWrapper,
+      listenerContext);
+  callback->setFinalizer(listenerContext,
+                         CBLDart_Replicator_ThrottledChangeListenerFinalizer);
 }
 
-class ReplicatedDocument_CObject_Helper {
- public:
-  void init(const CBLReplicatedDocument *document) {
-    assert(!errorMessageStr);
-
-    auto hasError = document->error.code != 0;
+/**
+ * Sends a batch of replicated documents to `callback`, packed into a string
+ * buffer and an integer buffer, instead of an array of objects per document.
+ *
+ * The string buffer contains the ID, scope, collection and error message of
+ * each document, in that order, and the integer buffer contains the flags,
+ * error domain and error code of each document. The error message is empty
+ * and the error domain and code are `0`, if there was no error.
+ *
+ * If `errorsOnly` is true, only documents with an error are sent, and no
+ * message is sent if there are none.
+ */
+static void CBLDart_Replicator_SendDocumentReplications(
+    CBLDart::AsyncCallback *callback, bool isPush, unsigned numDocuments,
+    const CBLReplicatedDocument *documents, bool errorsOnly) {
+  // The buffers of the message are allocated from the arena of the thread, so
+  // that sending replicated documents does not allocate from the heap.
+  CBLDart::MessageArena::Scope arenaScope;
+  auto &arena = arenaScope.arena();
+  auto strings = arena.allocateArray<FLString>(numDocuments * 4);
+  auto records = arena.allocateArray<int32_t>(numDocuments * 3);
+  auto errorMessages = arena.allocateArray<FLSliceResult>(numDocuments);
+  size_t count = 0;
+  size_t errorCount = 0;
+
+  for (unsigned i = 0; i < numDocuments; i++) {
+    auto &document = documents[i];
+    auto hasError = document.error.code != 0;
+    if (errorsOnly && !hasError) {
+      continue;
+    }
 
+    FLString errorMessage = kFLSliceNull;
     if (hasError) {
-      errorMessageStr = CBLError_Message(&document->error);
+      errorMessages[errorCount] = CBLError_Message(&document.error);
+      errorMessage = static_cast<FLString>(errorMessages[errorCount++]);
     }
 
-    // Build CObject.
-    object.type = Dart_CObject_kArray;
-    object.value.as_array.length = hasError ? 7 : 4;
-    object.value.as_array.values = objectValues;
+    strings[count * 4] = document.ID;
+    strings[count * 4 + 1] = document.scope;
+    strings[count * 4 + 2] = document.collection;
+    strings[count * 4 + 3] = errorMessage;
 
-    objectValues[0] = &id;
-    CBLDart_CObject_SetFLString(&id, document->ID);
+    records[count * 3] = static_cast<int32_t>(document.flags);
+    records[count * 3 + 1] = hasError ? document.error.domain : 0;
+    records[count * 3 + 2] = document.error.code;
+    count++;
+  }
 
-    objectValues[1] = &flags;
-    flags.type = Dart_CObject_kInt32;
-    flags.value.as_int32 = document->flags;
+  if (count > 0) {
+    Dart_CObject isPush_{};
+    isPush_.type = Dart_CObject_kBool;
+    isPush_.value.as_bool = isPush;
 
-    objectValues[2] = &scope;
-    CBLDart_CObject_SetFLString(&scope, document->scope);
+    Dart_CObject strings_{};
+    CBLDart_CObject_SetPackedStrings(&strings_, strings, count * 4, arena);
 
-    objectValues[3] = &collection;
-    CBLDart_CObject_SetFLString(&collection, document->collection);
+    Dart_CObject records_{};
+    records_.type = Dart_CObject_kTypedData;
+    records_.value.as_typed_data.type = Dart_TypedData_kInt32;
+    records_.value.as_typed_data.values = reinterpret_cast<uint8_t *>(records);
+    records_.value.as_typed_data.length = static_cast<intptr_t>(count * 3);
 
-    if (hasError) {
-      objectValues[4] = &errorDomain;
-      errorDomain.type = Dart_CObject_kInt32;
-      errorDomain.value.as_int32 = document->error.domain;
+    Dart_CObject *argsValues[] = {&isPush_, &strings_, &records_};
 
-      objectValues[5] = &errorCode;
-      errorCode.type = Dart_CObject_kInt32;
-      errorCode.value.as_int32 = document->error.code;
+    Dart_CObject args{};
+    args.type = Dart_CObject_kArray;
+    args.value.as_array.length = 3;
+    args.value.as_array.values = argsValues;
 
-      objectValues[6] = &errorMessage;
-      CBLDart_CObject_SetFLString(&errorMessage,
-                                  static_cast<FLString>(errorMessageStr));
-    }
+    CBLDart::AsyncCallbackCall(*callback).execute(args);
   }
 
-  ~ReplicatedDocument_CObject_Helper() {
-    FLSliceResult_Release(errorMessageStr);
+  for (size_t i = 0; i < errorCount; i++) {
+    FLSliceResult_Release(errorMessages[i]);
   }
-
-  Dart_CObject *cObject() { return &object; }
-
- private:
-  Dart_CObject object{};
-  Dart_CObject *objectValues[7];
-  Dart_CObject id{};
-  Dart_CObject flags{};
-  Dart_CObject scope{};
-  Dart_CObject collection{};
-  Dart_CObject errorDomain{};
-  Dart_CObject errorCode{};
-  Dart_CObject errorMessage{};
-
-  FLSliceResult errorMessageStr = {nullptr, 0};
-};
+}
 
 static void CBLDart_Replicator_DocumentReplicationListenerWrapper(
     void *context, CBLReplicator *replicator, bool isPush,
     unsigned numDocuments, const CBLReplicatedDocument *documents) {
-  auto callback = ASYNC_CALLBACK_FROM_C(context);
-
-  Dart_CObject isPush_{};
-  isPush_.type = Dart_CObject_kBool;
-  isPush_.value.as_bool = isPush;
-
-  std::vector<ReplicatedDocument_CObject_Helper> documentObjectHelpers(
-      numDocuments);
-  std::vector<Dart_CObject *> documentObjects(numDocuments);
-
-  for (size_t i = 0; i < numDocuments; i++) {
-    auto helper = &documentObjectHelpers[i];
-    helper->init(&documents[i]);
-    documentObjects[i] = helper->cObject();
-  }
-
-  Dart_CObject cObjectDocumentsArray{};
-  cObjectDocumentsArray.type = Dart_CObject_kArray;
-  cObjectDocumentsArray.value.as_array.length = numDocuments;
-  cObjectDocumentsArray.value.as_array.values = documentObjects.data();
-
-  Dart_CObject *argsValues[] = {&isPush_, &cObjectDocumentsArray};
-
-  Dart_CObject args{};
-  args.type = Dart_CObject_kArray;
-  args.value.as_array.length = 2;
-  args.value.as_array.values = argsValues;
+  CBLDart::Stats::instance.listenerInvoked();
+  CBLDart::TimelineSpan span("CBLDart DocumentReplicationListener");
+  CBLDart_Replicator_SendDocumentReplications(
+      ASYNC_CALLBACK_FROM_C(context), isPush, numDocuments, documents, false);
+}
 
-  CBLDart::AsyncCallbackCall(*callback).execute(args);
+static void CBLDart_Replicator_DocumentReplicationErrorListenerWrapper(
+    void *context, CBLReplicator *replicator, bool isPush,
+    unsigned numDocuments, const CBLReplicatedDocument *documents) {
+  CBLDart::Stats::instance.listenerInvoked();
+  CBLDart::TimelineSpan span("CBLDart DocumentReplicationListener");
+  CBLDart_Replicator_SendDocumentReplications(
+      ASYNC_CALLBACK_FROM_C(context), isPush, numDocuments, documents, true);
 }
 
 void CBLDart_CBLReplicator_AddDocumentReplicationListener(
-    const CBLDatabase *db, CBLReplicator *replicator,
+    const CBLDatabase *db, CBLReplicator *replicator, bool errorsOnly,
     CBLDart_AsyncCallback listener) {
   auto listenerToken = CBLReplicator_AddDocumentReplicationListener(
-      replicator, CBLDart_Replicator_DocumentReplicationListenerWrapper,
+      replicator,
+      errorsOnly ? CBLDart_Replicator_DocumentReplicationErrorListenerWrapper
+                 : CBLDart_Replicator_DocumentReplicationListenerWrapper,
       (void *)listener);
 
-  CBLDart_CloneDatabaseLock(db, listenerToken);
+  CBLDart_SetListenerFinalizer(db, listenerToken, listener);
+}
 
-  ASYNC_CALLBACK_FROM_C(listener)->setFinalizer(listenerToken,
-                                                CBLDart_CBLListenerFinalizer);
+/**
+ * The number of document IDs above which `AreDocumentsPending` reads all
+ * pending document IDs once, instead of checking each document separately.
+ */
+static constexpr size_t kCBLDart_PendingDocumentsLookupThreshold = 16;
+
+bool CBLDart_CBLReplicator_AreDocumentsPending(CBLReplicator *replicator,
+                                               const CBLCollection *collection,
+                                               const FLString *docIDs,
+                                               size_t count, uint8_t *bitsetOut,
+                                               CBLError *errorOut) {
+  std::memset(bitsetOut, 0, (count + 7) >> 3);
+
+  if (count <= kCBLDart_PendingDocumentsLookupThreshold) {
+    for (size_t i = 0; i < count; i++) {
+      CBLError error{};
+      if (CBLReplicator_IsDocumentPending2(replicator, docIDs[i], collection,
+                                           &error)) {
+        bitsetOut[i >> 3] |= 1 << (i & 7);
+      } else if (error.code != 0) {
+        *errorOut = error;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  auto pendingDocumentIDs =
+      CBLReplicator_PendingDocumentIDs2(replicator, collection, errorOut);
+  if (!pendingDocumentIDs) {
+    return false;
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (FLDict_Get(pendingDocumentIDs, docIDs[i])) {
+      bitsetOut[i >> 3] |= 1 << (i & 7);
+    }
+  }
+  FLDict_Release(pendingDocumentIDs);
+  return true;
+}
+
+int64_t CBLDart_CBLReplicator_PendingDocumentCount(
+    CBLReplicator *replicator, const CBLCollection *collection,
+    CBLError *errorOut) {
+  auto pendingDocumentIDs =
+      CBLReplicator_PendingDocumentIDs2(replicator, collection, errorOut);
+  if (!pendingDocumentIDs) {
+    return -1;
+  }
+  int64_t count = FLDict_Count(pendingDocumentIDs);
+  FLDict_Release(pendingDocumentIDs);
+  return count;
+}
+
+bool CBLDart_CBLReplicator_Metrics(CBLReplicator *replicator,
+                                   CBLDart_ReplicatorMetrics *metricsOut) {
+  std::scoped_lock lock(replicatorCallbackWrapperContextsMutex);
+  auto it = replicatorCallbackWrapperContexts.find(replicator);
+  if (it == replicatorCallbackWrapperContexts.end()) {
+    return false;
+  }
+  it->second->metrics.read(metricsOut);
+  return true;
 }
@@ -0,0 +1,91 @@
+#include "ChangeCursor.h"
+
+#include "QueryCache.h"
+
+namespace CBLDart {
+
+// === ChangeCursor ===========================================================
+
+/** Quotes `name` as an identifier in a SQL++ query. */
+static std::string quoteIdentifier(FLString name) {
+  std::string result = "`";
+  for (size_t i = 0; i < name.size; i++) {
+    auto c = static_cast<const char *>(name.buf)[i];
+    result += c;
+    if (c == '`') {
+      result += c;
+    }
+  }
+  result += "`";
+  return result;
+}
+
+ChangeCursor::ChangeCursor(const CBLCollection *collection, uint64_t sequence)
+    : collection_(
+          CBLCollection_Retain(const_cast<CBLCollection *>(collection))),
+      sequence_(sequence) {
+  auto scope = CBLCollection_Scope(collection);
+  auto name = quoteIdentifier(CBLScope_Name(scope)) + "." +
+              quoteIdentifier(CBLCollection_Name(collection));
+  CBLScope_Release(scope);
+
+  // Deleted documents are only included in the results of a query, whose
+  // WHERE clause refers to meta().deleted.
+  queryString_ =
+      "SELECT meta(c).id, meta(c).sequence, meta(c).revisionID, "
+      "meta(c).deleted, c FROM " +
+      name +
+      " AS c WHERE meta(c).sequence > $sequence AND (meta(c).deleted OR NOT "
+      "meta(c).deleted) ORDER BY meta(c).sequence LIMIT $limit";
+}
+
+ChangeCursor::~ChangeCursor() {
+  CBLCollection_Release(const_cast<CBLCollection *>(collection_));
+}
+
+FLSliceResult ChangeCursor::next(uint32_t maxCount, CBLError *errorOut) {
+  auto &queryCache = QueryCache::instance();
+  auto query = queryCache.acquire(
+      CBLCollection_Database(collection_), kCBLN1QLLanguage,
+      {queryString_.data(), queryString_.size()}, nullptr, errorOut);
+  if (!query) {
+    return {};
+  }
+
+  auto parameters = FLMutableDict_New();
+  FLMutableDict_SetUInt(parameters, FLSTR("sequence"), sequence_);
+  FLMutableDict_SetUInt(parameters, FLSTR("limit"), maxCount);
+  CBLQuery_SetParameters(query, parameters);
+  FLMutableDict_Release(parameters);
+
+  auto resultSet = CBLQuery_Execute(query, errorOut);
+  if (!resultSet) {
+    queryCache.release(query);
+    return {};
+  }
+
+  auto encoder = FLEncoder_New();
+  FLEncoder_BeginArray(encoder, maxCount);
+  auto sequence = sequence_;
+  while (CBLResultSet_Next(resultSet)) {
+    auto row = CBLResultSet_ResultArray(resultSet);
+    FLEncoder_WriteValue(encoder, reinterpret_cast<FLValue>(row));
+    sequence = FLValue_AsUnsigned(CBLResultSet_ValueAtIndex(resultSet, 1));
+  }
+  FLEncoder_EndArray(encoder);
+  CBLResultSet_Release(resultSet);
+  queryCache.release(query);
+
+  FLError flError;
+  auto result = FLEncoder_Finish(encoder, &flError);
+  FLEncoder_Free(encoder);
+  if (!result.buf) {
+    *errorOut = {kCBLFleeceDomain, static_cast<int>(flError), 0};
+    return {};
+  }
+
+  sequence_ = sequence;
+  return result;
+}
+
+}  // namespace CBLDart
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "CBL+Dart.h"
+
+namespace CBLDart {
+
+// === ChangeCursor ===========================================================
+
+/**
+ * A cursor over the documents of a collection in the order of their
+ * sequences, which starts after a checkpoint sequence.
+ *
+ * Every document appears at most once, with its current revision, and
+ * deleted documents are included, so that consumers can apply deletions.
+ *
+ * The documents are read by a query, which is checked out of the
+ * `QueryCache` for each batch, so that the cursor does not keep a query
+ * alive between batches.
+ */
+class ChangeCursor {
+ public:
+  ChangeCursor(const CBLCollection *collection, uint64_t sequence);
+
+  ~ChangeCursor();
+
+  ChangeCursor(const ChangeCursor &) = delete;
+  ChangeCursor &operator=(const ChangeCursor &) = delete;
+
+  /**
+   * Reads the next batch of at most `maxCount` documents and encodes it as a
+   * Fleece array, which must be released by the caller.
+   *
+   * Each element of the array is an array of the id, sequence, revision id,
+   * deleted flag and properties of a document. The properties of deleted
+   * documents are missing. An empty array is returned when there are no more
+   * documents.
+   *
+   * If an error occurs, a null slice is returned.
+   */
+  FLSliceResult next(uint32_t maxCount, CBLError *errorOut);
+
+ private:
+  const CBLCollection *collection_;
+  std::string queryString_;
+  uint64_t sequence_;
+};
+
+}  // namespace CBLDart
@@ -0,0 +1,54 @@
+#include "ChunkQueue.h"
+
+namespace CBLDart {
+
+// === ChunkQueue =============================================================
+
+// The producer only writes `tail_` and the consumer only writes `head_`. A
+// slot is published to the consumer by the release store of `tail_` after it
+// has been written, and returned to the producer by the release store of
+// `head_` after it has been read.
+//
+// The positions are accessed sequentially consistent, so that a thread which
+// goes to sleep after it has found the queue full or empty, and the other
+// thread, which has just changed the queue, cannot both miss each other.
+
+ChunkQueue::ChunkQueue(size_t capacity)
+    : capacity_(capacity < 1 ? 1 : capacity),
+      chunks_(new FLSliceResult[capacity_]()) {}
+
+ChunkQueue::~ChunkQueue() {
+  while (true) {
+    auto chunk = pop();
+    if (!chunk.buf) {
+      break;
+    }
+    FLSliceResult_Release(chunk);
+  }
+}
+
+bool ChunkQueue::push(FLSliceResult chunk) {
+  auto tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_seq_cst) == capacity_) {
+    return false;
+  }
+
+  chunks_[tail % capacity_] = chunk;
+  tail_.store(tail + 1, std::memory_order_seq_cst);
+  return true;
+}
+
+FLSliceResult ChunkQueue::pop() {
+  auto head = head_.load(std::memory_order_relaxed);
+  if (head == tail_.load(std::memory_order_seq_cst)) {
+    return {};
+  }
+
+  auto &slot = chunks_[head % capacity_];
+  auto chunk = slot;
+  slot = {};
+  head_.store(head + 1, std::memory_order_seq_cst);
+  return chunk;
+}
+
+}  // namespace CBLDart
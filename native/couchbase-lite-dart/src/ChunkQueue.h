@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "CBL+Dart.h"
+
+namespace CBLDart {
+
+// === ChunkQueue =============================================================
+
+/**
+ * A bounded, lock-free queue of chunks of data, which is pushed to by a single
+ * producer thread and popped from by a single consumer thread.
+ *
+ * Chunks are handed off as `FLSliceResult`s, whose ownership is transferred
+ * from the producer to the consumer, without copying their content.
+ */
+class ChunkQueue {
+ public:
+  explicit ChunkQueue(size_t capacity);
+
+  /** Releases the chunks which have not been popped. */
+  ~ChunkQueue();
+
+  ChunkQueue(const ChunkQueue &) = delete;
+  ChunkQueue &operator=(const ChunkQueue &) = delete;
+
+  /**
+   * Pushes `chunk` into the queue and takes ownership of it.
+   *
+   * Returns `false`, without taking ownership, if the queue is full. Must
+   * only be called by the producer.
+   */
+  bool push(FLSliceResult chunk);
+
+  /**
+   * Pops the oldest chunk, whose ownership is transferred to the caller, or
+   * returns a null slice if the queue is empty.
+   *
+   * Must only be called by the consumer.
+   */
+  FLSliceResult pop();
+
+  /** The number of chunks in the queue. */
+  size_t size() const {
+    return tail_.load(std::memory_order_seq_cst) -
+           head_.load(std::memory_order_seq_cst);
+  }
+
+  size_t capacity() const { return capacity_; }
+
+ private:
+  size_t capacity_;
+  std::unique_ptr<FLSliceResult[]> chunks_;
+  // Positions only increase and are mapped to slots modulo the capacity.
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+};
+
+}  // namespace CBLDart
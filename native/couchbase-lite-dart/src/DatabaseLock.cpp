@@ -0,0 +1,38 @@
+#include "DatabaseLock.h"
+
+#include <cassert>
+#include <unordered_map>
+
+// === DatabaseLock ===========================================================
+
+/**
+ * The locks of the open databases, which are only looked up when a lock is
+ * cloned or the database is closed.
+ */
+static std::unordered_map<const CBLDatabase *, CBLDart_DatabaseLock *>
+    databaseLocks;
+static std::mutex databaseLocksMutex;
+
+void CBLDart_CreateDatabaseLock(CBLDatabase *database) {
+  std::scoped_lock lock(databaseLocksMutex);
+  assert(databaseLocks.find(database) == databaseLocks.end());
+  databaseLocks[database] = new CBLDart_DatabaseLock;
+}
+
+CBLDart_DatabaseLock *CBLDart_CloneDatabaseLock(const CBLDatabase *database) {
+  std::scoped_lock lock(databaseLocksMutex);
+  auto databaseLock = databaseLocks.find(database);
+  assert(databaseLock != databaseLocks.end());
+  return databaseLock->second->retain();
+}
+
+void CBLDart_ReleaseDatabaseLock(const CBLDatabase *database) {
+  CBLDart_DatabaseLock *databaseLock;
+  {
+    std::scoped_lock lock(databaseLocksMutex);
+    auto nh = databaseLocks.extract(database);
+    assert(!nh.empty());
+    databaseLock = nh.mapped();
+  }
+  databaseLock->release();
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "CBL+Dart.h"
+#include "Stats.h"
+
+// === DatabaseLock ===========================================================
+
+/**
+ * Database level locking is only required in certain scenarios.
+ *
+ * Any given database is only ever accessed by the same Dart isolate. Since
+ * Dart isolates are single threaded, we can safely use the CBL C API, which is
+ * generally not thread safe.
+ *
+ * An exception are native finalizers. These are called from the Dart VM during
+ * GC. Even though the Dart isolate will never execute while native finalizers
+ * are running, native code called through FFI from the Dart isolate can.
+ *
+ * According to the CBL C docs we need to serialize all access to a database
+ * instance and objects that belong to it. In reality, many operations of the
+ * CBL C API are thread safe. We only use locking for the operations where it
+ * turned out that it is necessary.
+ *
+ * Specifically we need to ensure that:
+ *
+ * - listeners are not finalized while the database is closing.
+ * - replicators are not stopped while the database is closing.
+ */
+
+/**
+ * The mutex that is used for database level locking, which is shared by a
+ * database and the objects that belong to it.
+ *
+ * The lock is reference counted intrusively. Objects that need to lock access
+ * to the database hold a reference to the lock of the database they belong to
+ * and acquire it directly, without looking it up. This way, database level
+ * locking only costs the lock itself and objects of different databases never
+ * contend with each other.
+ *
+ * When a database is opened it uses `CBLDart_CreateDatabaseLock` to create its
+ * lock. Other objects use `CBLDart_CloneDatabaseLock` to get a new reference
+ * to the lock of the database they belong to. Callers of
+ * `CBLDart_CloneDatabaseLock` must ensure that the database is still open when
+ * they call it.
+ *
+ * Every reference must be released with `release`, when the object that holds
+ * it is destroyed.
+ */
+class CBLDart_DatabaseLock {
+ public:
+  CBLDart_DatabaseLock() = default;
+
+  CBLDart_DatabaseLock(const CBLDart_DatabaseLock &) = delete;
+  CBLDart_DatabaseLock &operator=(const CBLDart_DatabaseLock &) = delete;
+
+  CBLDart_DatabaseLock *retain() {
+    refCount_.fetch_add(1, std::memory_order_relaxed);
+    return this;
+  }
+
+  void release() {
+    if (refCount_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+  std::scoped_lock<std::mutex> acquire() {
+    CBLDart::Stats::instance.databaseLockAcquired();
+    // Only waits for the lock are timed, to keep uncontended acquisitions
+    // cheap.
+    if (!mutex_.try_lock()) {
+      CBLDart::LatencyTimer timer(CBLDart::Stats::instance.databaseLockWaits);
+      mutex_.lock();
+    }
+    return std::scoped_lock(std::adopt_lock, mutex_);
+  }
+
+ private:
+  ~CBLDart_DatabaseLock() = default;
+
+  std::mutex mutex_;
+  std::atomic<uint32_t> refCount_ = 1;
+};
+
+/** Creates the lock of `database`, when it is opened. */
+void CBLDart_CreateDatabaseLock(CBLDatabase *database);
+
+/** Returns a new reference to the lock of `database`, which must be open. */
+CBLDart_DatabaseLock *CBLDart_CloneDatabaseLock(const CBLDatabase *database);
+
+/** Releases the lock of `database`, when it is closed. */
+void CBLDart_ReleaseDatabaseLock(const CBLDatabase *database);
@@ -0,0 +1,68 @@
+#include "DatabaseThreads.h"
+
+#include <vector>
+
+namespace CBLDart {
+
+// === DatabaseThreads ========================================================
+
+DatabaseThreads &DatabaseThreads::instance() {
+  // The registry is never destroyed, because its threads can still be running
+  // while static objects are destroyed.
+  static auto threads = new DatabaseThreads;
+  return *threads;
+}
+
+void DatabaseThreads::start(const CBLDatabase *database,
+                            std::function<void()> body,
+                            std::function<void()> stop) {
+  // The thread is registered before it can exit, because the lock is held
+  // until then.
+  std::scoped_lock lock(mutex_);
+  auto id = nextId_++;
+  auto &entry = threads_[id];
+  entry.database = database;
+  entry.stop = std::move(stop);
+  entry.thread = std::thread([this, id, body = std::move(body)] {
+    body();
+    exited(id);
+  });
+}
+
+void DatabaseThreads::purge(const CBLDatabase *database) {
+  std::vector<Entry> purged;
+  {
+    std::scoped_lock lock(mutex_);
+    for (auto it = threads_.begin(); it != threads_.end();) {
+      if (it->second.database == database) {
+        purged.push_back(std::move(it->second));
+        it = threads_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  for (auto &entry : purged) {
+    entry.stop();
+  }
+  for (auto &entry : purged) {
+    entry.thread.join();
+  }
+}
+
+void DatabaseThreads::exited(uint64_t id) {
+  // If the thread has been purged, it is joined by `purge` instead.
+  // `stop` can own the state of the thread, so it is destroyed after the
+  // lock has been released.
+  std::function<void()> stop;
+  std::scoped_lock lock(mutex_);
+  auto it = threads_.find(id);
+  if (it != threads_.end()) {
+    it->second.thread.detach();
+    stop = std::move(it->second.stop);
+    threads_.erase(it);
+  }
+}
+
+}  // namespace CBLDart
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "CBL+Dart.h"
+
+namespace CBLDart {
+
+// === DatabaseThreads ========================================================
+
+/**
+ * Background threads which use a database without holding the database lock,
+ * because they perform operations which can take a long time, such as
+ * building an index or running maintenance.
+ *
+ * Instead of the database lock, such threads rely on `purge`, which asks them
+ * to stop and waits for them to exit, before the database is closed. A thread
+ * which exits on its own is detached.
+ */
+class DatabaseThreads {
+ public:
+  static DatabaseThreads &instance();
+
+  DatabaseThreads(const DatabaseThreads &) = delete;
+  DatabaseThreads &operator=(const DatabaseThreads &) = delete;
+
+  /**
+   * Runs `body` on a new thread, which uses `database`.
+   *
+   * `stop` is called when `database` is purged while `body` is still
+   * running, and must make `body` return soon.
+   */
+  void start(const CBLDatabase *database, std::function<void()> body,
+             std::function<void()> stop);
+
+  /**
+   * Stops the threads of `database` and waits for them to exit.
+   *
+   * Must be called before `database` is closed.
+   */
+  void purge(const CBLDatabase *database);
+
+ private:
+  DatabaseThreads() = default;
+
+  struct Entry {
+    const CBLDatabase *database;
+    std::thread thread;
+    std::function<void()> stop;
+  };
+
+  void exited(uint64_t id);
+
+  std::mutex mutex_;
+  uint64_t nextId_ = 0;
+  std::unordered_map<uint64_t, Entry> threads_;
+};
+
+}  // namespace CBLDart
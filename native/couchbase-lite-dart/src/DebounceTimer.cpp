@@ -0,0 +1,51 @@
+#include "DebounceTimer.h"
+
+#include <thread>
+
+namespace CBLDart {
+
+// === DebounceTimer ==========================================================
+
+DebounceTimer &DebounceTimer::instance() {
+  // The timer is never destroyed, because its thread can still be running
+  // while static objects are destroyed.
+  static auto timer = new DebounceTimer;
+  return *timer;
+}
+
+DebounceTimer::DebounceTimer() { std::thread([this]() { run(); }).detach(); }
+
+void DebounceTimer::schedule(std::chrono::steady_clock::time_point deadline,
+                             std::function<void()> task) {
+  std::scoped_lock lock(mutex_);
+  auto isEarliest = queue_.empty() || deadline < queue_.begin()->first;
+  queue_.emplace(deadline, std::move(task));
+  if (isEarliest) {
+    cv_.notify_one();
+  }
+}
+
+void DebounceTimer::run() {
+  std::unique_lock lock(mutex_);
+  while (true) {
+    if (queue_.empty()) {
+      cv_.wait(lock);
+      continue;
+    }
+
+    auto it = queue_.begin();
+    if (it->first > std::chrono::steady_clock::now()) {
+      cv_.wait_until(lock, it->first);
+      continue;
+    }
+
+    auto task = std::move(it->second);
+    queue_.erase(it);
+
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
+
+}  // namespace CBLDart
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+
+namespace CBLDart {
+
+// === DebounceTimer ==========================================================
+
+/**
+ * Runs tasks at their deadlines on a single background thread, which is used
+ * to end debounce and throttle windows.
+ *
+ * Tasks must be short, since they delay the tasks which are due after them.
+ */
+class DebounceTimer {
+ public:
+  static DebounceTimer &instance();
+
+  DebounceTimer(const DebounceTimer &) = delete;
+  DebounceTimer &operator=(const DebounceTimer &) = delete;
+
+  void schedule(std::chrono::steady_clock::time_point deadline,
+                std::function<void()> task);
+
+ private:
+  DebounceTimer();
+
+  void run();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::multimap<std::chrono::steady_clock::time_point, std::function<void()>>
+      queue_;
+};
+
+}  // namespace CBLDart
@@ -0,0 +1,246 @@
+#include "DocumentCache.h"
+
+namespace CBLDart {
+
+// === DocumentCache ==========================================================
+
+/**
+ * Returns the approximate number of bytes `document` occupies in memory, which
+ * is dominated by the encoded Fleece data of its properties.
+ */
+static size_t documentSize(FLString docID, const CBLDocument *document) {
+  size_t size = docID.size;
+  auto doc = FLValue_FindDoc(
+      reinterpret_cast<FLValue>(CBLDocument_Properties(document)));
+  if (doc) {
+    size += FLDoc_GetData(doc).size;
+    FLDoc_Release(doc);
+  }
+  return size;
+}
+
+DocumentCache &DocumentCache::instance() {
+  // The cache is never destroyed, because change listeners can still be
+  // called by other threads while static objects are destroyed.
+  static auto cache = new DocumentCache;
+  return *cache;
+}
+
+const CBLDocument *DocumentCache::getDocument(const CBLCollection *collection,
+                                              FLString docID,
+                                              CBLError *errorOut) {
+  if (!enabled_.load(std::memory_order_relaxed)) {
+    return CBLCollection_GetDocument(collection, docID, errorOut);
+  }
+
+  std::string key(static_cast<const char *>(docID.buf), docID.size);
+
+  std::unique_lock lock(mutex_);
+  auto cache = collectionCache(collection, lock);
+  if (!cache || openTransactions_.count(cache->database)) {
+    lock.unlock();
+    return CBLCollection_GetDocument(collection, docID, errorOut);
+  }
+
+  auto it = cache->index.find(key);
+  if (it != cache->index.end()) {
+    cache->entries.splice(cache->entries.begin(), cache->entries, it->second);
+    hits_++;
+    return CBLDocument_Retain(it->second->document);
+  }
+  misses_++;
+  auto generation = cache->generation;
+  lock.unlock();
+
+  auto document = CBLCollection_GetDocument(collection, docID, errorOut);
+  if (!document) {
+    return nullptr;
+  }
+
+  auto size = documentSize(docID, document);
+  std::vector<const CBLDocument *> evicted;
+  lock.lock();
+  auto collectionIt = collections_.find(collection);
+  if (collectionIt != collections_.end()) {
+    auto &cache = collectionIt->second;
+    // The document is only cached if the collection has not changed since it
+    // has been loaded, because it could be stale otherwise.
+    if (cache.generation == generation && enabled() && size <= maxSize_ &&
+        !openTransactions_.count(cache.database) &&
+        cache.index.find(key) == cache.index.end()) {
+      cache.entries.push_front({key, CBLDocument_Retain(document), size});
+      cache.index.emplace(std::move(key), cache.entries.begin());
+      cache.size += size;
+      evict(cache, evicted);
+    }
+  }
+  lock.unlock();
+
+  for (auto document : evicted) {
+    CBLDocument_Release(document);
+  }
+
+  return document;
+}
+
+void DocumentCache::purge(const CBLDatabase *database) {
+  std::vector<std::pair<const CBLCollection *, CollectionCache>> caches;
+  {
+    std::scoped_lock lock(mutex_);
+    openTransactions_.erase(database);
+    for (auto it = collections_.begin(); it != collections_.end();) {
+      if (it->second.database == database) {
+        caches.emplace_back(it->first, std::move(it->second));
+        it = collections_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  for (auto &[collection, cache] : caches) {
+    CBLListener_Remove(cache.listenerToken);
+    for (auto &entry : cache.entries) {
+      CBLDocument_Release(entry.document);
+    }
+    CBLCollection_Release(collection);
+  }
+}
+
+void DocumentCache::beginTransaction(const CBLDatabase *database) {
+  std::scoped_lock lock(mutex_);
+  openTransactions_[database]++;
+  invalidateLoads(database);
+}
+
+void DocumentCache::endTransaction(const CBLDatabase *database) {
+  std::scoped_lock lock(mutex_);
+  auto it = openTransactions_.find(database);
+  if (it != openTransactions_.end() && --it->second == 0) {
+    openTransactions_.erase(it);
+  }
+  // Documents which have been loaded while the transaction was open can
+  // contain changes which have been aborted.
+  invalidateLoads(database);
+}
+
+void DocumentCache::setLimits(size_t maxCount, size_t maxSize) {
+  std::vector<const CBLDocument *> evicted;
+  {
+    std::scoped_lock lock(mutex_);
+    maxCount_ = maxCount;
+    maxSize_ = maxSize;
+    enabled_ = enabled();
+    for (auto &[_, cache] : collections_) {
+      evict(cache, evicted);
+    }
+  }
+
+  for (auto document : evicted) {
+    CBLDocument_Release(document);
+  }
+}
+
+CBLDart_DocumentCacheStats DocumentCache::stats() {
+  std::scoped_lock lock(mutex_);
+  size_t count = 0;
+  size_t size = 0;
+  for (auto &[_, cache] : collections_) {
+    count += cache.entries.size();
+    size += cache.size;
+  }
+  return {hits_,  misses_, evictions_, invalidations_,
+          count,  size,    maxCount_,  maxSize_};
+}
+
+void DocumentCache::collectionChanged(void *context,
+                                      const CBLCollectionChange *change) {
+  auto &self = instance();
+  std::vector<const CBLDocument *> invalidated;
+  {
+    std::scoped_lock lock(self.mutex_);
+    auto it = self.collections_.find(change->collection);
+    if (it == self.collections_.end()) {
+      return;
+    }
+
+    auto &cache = it->second;
+    cache.generation++;
+    for (unsigned i = 0; i < change->numDocs; i++) {
+      auto docID = change->docIDs[i];
+      auto entryIt = cache.index.find(
+          std::string(static_cast<const char *>(docID.buf), docID.size));
+      if (entryIt == cache.index.end()) {
+        continue;
+      }
+
+      auto entry = entryIt->second;
+      cache.size -= entry->size;
+      invalidated.push_back(entry->document);
+      cache.index.erase(entryIt);
+      cache.entries.erase(entry);
+      self.invalidations_++;
+    }
+  }
+
+  for (auto document : invalidated) {
+    CBLDocument_Release(document);
+  }
+}
+
+DocumentCache::CollectionCache *DocumentCache::collectionCache(
+    const CBLCollection *collection, std::unique_lock<std::mutex> &lock) {
+  while (true) {
+    auto it = collections_.find(collection);
+    if (it != collections_.end()) {
+      return &it->second;
+    }
+    if (!enabled()) {
+      return nullptr;
+    }
+
+    // The listener is added without holding the lock, because change
+    // listeners are called while Couchbase Lite holds its own locks, and
+    // they acquire the lock of the cache.
+    lock.unlock();
+    auto listenerToken =
+        CBLCollection_AddChangeListener(collection, collectionChanged, nullptr);
+    lock.lock();
+
+    if (collections_.find(collection) == collections_.end()) {
+      auto &cache = collections_[collection];
+      cache.database = CBLCollection_Database(collection);
+      cache.listenerToken = listenerToken;
+      CBLCollection_Retain(collection);
+      return &cache;
+    }
+
+    // Another thread has created the cache in the meantime.
+    lock.unlock();
+    CBLListener_Remove(listenerToken);
+    lock.lock();
+  }
+}
+
+void DocumentCache::invalidateLoads(const CBLDatabase *database) {
+  for (auto &[_, cache] : collections_) {
+    if (cache.database == database) {
+      cache.generation++;
+    }
+  }
+}
+
+void DocumentCache::evict(CollectionCache &cache,
+                          std::vector<const CBLDocument *> &evicted) {
+  while (!cache.entries.empty() &&
+         (cache.entries.size() > maxCount_ || cache.size > maxSize_)) {
+    auto &last = cache.entries.back();
+    cache.size -= last.size;
+    cache.index.erase(last.docID);
+    evicted.push_back(last.document);
+    cache.entries.pop_back();
+    evictions_++;
+  }
+}
+
+}  // namespace CBLDart
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CBL+Dart.h"
+
+namespace CBLDart {
+
+// === DocumentCache ==========================================================
+
+/**
+ * An in-memory cache of immutable documents, which allows frequently read
+ * documents to be read without loading them from the database again.
+ *
+ * Documents are keyed by their collection and id. The documents of each
+ * collection are kept in a least recently used list, which holds at most
+ * `maxCount` documents with a total size of at most `maxSize` bytes.
+ *
+ * The cache of a collection registers a collection change listener, through
+ * which the cached documents of the collection are invalidated when they
+ * change.
+ *
+ * Change listeners are only notified of committed changes. While a
+ * transaction is open on a database, its documents bypass the cache, so that
+ * reads see the changes of the transaction and uncommitted revisions, which
+ * would survive an abort, are not cached.
+ */
+class DocumentCache {
+ public:
+  static DocumentCache &instance();
+
+  DocumentCache(const DocumentCache &) = delete;
+  DocumentCache &operator=(const DocumentCache &) = delete;
+
+  /**
+   * Returns the document with `docID` in `collection`, which must be released
+   * by the caller, from the cache or from the database, in which case it is
+   * added to the cache.
+   *
+   * Has the same semantics as `CBLCollection_GetDocument`.
+   */
+  const CBLDocument *getDocument(const CBLCollection *collection,
+                                 FLString docID, CBLError *errorOut);
+
+  /**
+   * Releases the cached documents of all collections of `database` and
+   * removes their change listeners.
+   *
+   * Must be called before `database` is closed.
+   */
+  void purge(const CBLDatabase *database);
+
+  /** Must be called before a transaction is begun on `database`. */
+  void beginTransaction(const CBLDatabase *database);
+
+  /** Must be called after a transaction on `database` has ended. */
+  void endTransaction(const CBLDatabase *database);
+
+  /**
+   * Sets the maximum number and size of the cached documents of each
+   * collection and evicts the least recently used documents which exceed
+   * them.
+   */
+  void setLimits(size_t maxCount, size_t maxSize);
+
+  CBLDart_DocumentCacheStats stats();
+
+ private:
+  DocumentCache() = default;
+
+  struct Entry {
+    std::string docID;
+    const CBLDocument *document;
+    size_t size;
+  };
+
+  struct CollectionCache {
+    const CBLDatabase *database;
+    CBLListenerToken *listenerToken = nullptr;
+    /**
+     * Incremented whenever documents of the collection change, so that
+     * documents which were loaded before a change are not cached.
+     */
+    uint64_t generation = 0;
+    /** The cached documents, with the most recently used document first. */
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    size_t size = 0;
+  };
+
+  static void collectionChanged(void *context,
+                                const CBLCollectionChange *change);
+
+  /**
+   * Returns the cache of `collection`, registering its change listener if it
+   * does not exist yet, or `nullptr` if the cache is disabled.
+   *
+   * Must be called while holding `lock`, which is temporarily released.
+   */
+  CollectionCache *collectionCache(const CBLCollection *collection,
+                                   std::unique_lock<std::mutex> &lock);
+
+  /**
+   * Increments the generations of the caches of the collections of
+   * `database`, so that documents which are being loaded are not cached.
+   */
+  void invalidateLoads(const CBLDatabase *database);
+
+  /** Removes the least recently used documents which exceed the limits. */
+  void evict(CollectionCache &cache, std::vector<const CBLDocument *> &evicted);
+
+  bool enabled() const { return maxCount_ > 0 && maxSize_ > 0; }
+
+  std::mutex mutex_;
+  std::atomic<bool> enabled_ = false;
+  size_t maxCount_ = 0;
+  size_t maxSize_ = 16 * 1024 * 1024;
+  std::unordered_map<const CBLCollection *, CollectionCache> collections_;
+  /** The number of open, possibly nested, transactions of each database. */
+  std::unordered_map<const CBLDatabase *, size_t> openTransactions_;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t evictions_ = 0;
+  uint64_t invalidations_ = 0;
+};
+
+}  // namespace CBLDart
@@ -0,0 +1,179 @@
+#include "DocumentWatcher.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "DebounceTimer.h"
+#include "Stats.h"
+#include "Timeline.h"
+#include "Utils.h"
+
+namespace CBLDart {
+
+// === Watch ==================================================================
+
+class DocumentWatcher::Watch {
+ public:
+  Watch(const CBLCollection *collection, std::string docID,
+        AsyncCallback *callback, std::chrono::milliseconds debounce)
+      : collection(collection),
+        docID(std::move(docID)),
+        callback_(callback),
+        debounce_(debounce) {}
+
+  const CBLCollection *collection;
+  const std::string docID;
+
+  /**
+   * Notifies the callback of a change, either immediately or, if the watch
+   * is debounced, at the end of the current debounce window.
+   */
+  void changed(std::shared_ptr<Watch> self);
+
+  /** Notifies the callback at the end of a debounce window. */
+  void debounceWindowEnded();
+
+  void stop() {
+    std::scoped_lock lock(mutex_);
+    stopped_ = true;
+  }
+
+ private:
+  void notify() {
+    Dart_CObject args{};
+    CBLDart_CObject_SetEmptyArray(&args);
+    AsyncCallbackCall(*callback_).execute(args);
+  }
+
+  // Guards `callback_`, which must not be used once the watch is stopped.
+  std::mutex mutex_;
+  AsyncCallback *callback_;
+  std::chrono::milliseconds debounce_;
+  bool pending_ = false;
+  bool stopped_ = false;
+};
+
+void DocumentWatcher::Watch::changed(std::shared_ptr<Watch> self) {
+  std::scoped_lock lock(mutex_);
+  if (stopped_) {
+    return;
+  }
+
+  if (debounce_.count() == 0) {
+    notify();
+    return;
+  }
+
+  if (pending_) {
+    // The change is coalesced into the pending notification.
+    return;
+  }
+
+  pending_ = true;
+  DebounceTimer::instance().schedule(
+      std::chrono::steady_clock::now() + debounce_,
+      [self = std::move(self)]() { self->debounceWindowEnded(); });
+}
+
+void DocumentWatcher::Watch::debounceWindowEnded() {
+  std::scoped_lock lock(mutex_);
+  pending_ = false;
+  if (!stopped_) {
+    notify();
+  }
+}
+
+// === DocumentWatcher ========================================================
+
+static std::mutex watchersMutex;
+static std::unordered_map<const CBLCollection *, DocumentWatcher *> watchers;
+
+std::shared_ptr<DocumentWatcher::Watch> DocumentWatcher::addWatch(
+    const CBLCollection *collection, FLString docID, AsyncCallback *callback,
+    std::chrono::milliseconds debounce) {
+  auto watch = std::make_shared<Watch>(
+      collection,
+      std::string(static_cast<const char *>(docID.buf), docID.size),
+      callback, debounce);
+
+  std::scoped_lock lock(watchersMutex);
+
+  auto &watcher = watchers[collection];
+  if (!watcher) {
+    watcher = new DocumentWatcher(collection);
+  }
+
+  {
+    std::scoped_lock watcherLock(watcher->mutex_);
+    watcher->watches_[watch->docID].push_back(watch);
+  }
+
+  return watch;
+}
+
+void DocumentWatcher::removeWatch(const std::shared_ptr<Watch> &watch) {
+  watch->stop();
+
+  std::scoped_lock lock(watchersMutex);
+
+  auto it = watchers.find(watch->collection);
+  assert(it != watchers.end());
+  auto watcher = it->second;
+
+  bool isEmpty;
+  {
+    std::scoped_lock watcherLock(watcher->mutex_);
+    auto docWatches = watcher->watches_.find(watch->docID);
+    auto &list = docWatches->second;
+    list.erase(std::find(list.begin(), list.end(), watch));
+    if (list.empty()) {
+      watcher->watches_.erase(docWatches);
+    }
+    isEmpty = watcher->watches_.empty();
+  }
+
+  if (isEmpty) {
+    watchers.erase(it);
+    // The listener is removed without holding the lock of the watcher, since
+    // the listener can be running and waiting for the lock.
+    delete watcher;
+  }
+}
+
+DocumentWatcher::DocumentWatcher(const CBLCollection *collection)
+    : collection_(CBLCollection_Retain(collection)) {
+  listenerToken_ =
+      CBLCollection_AddChangeListener(collection_, collectionChanged, this);
+}
+
+DocumentWatcher::~DocumentWatcher() {
+  CBLListener_Remove(listenerToken_);
+  CBLCollection_Release(collection_);
+}
+
+void DocumentWatcher::collectionChanged(void *context,
+                                        const CBLCollectionChange *change) {
+  Stats::instance.listenerInvoked();
+  TimelineSpan span("CBLDart DocumentChangeListener");
+  auto watcher = reinterpret_cast<DocumentWatcher *>(context);
+
+  std::vector<std::shared_ptr<Watch>> changedWatches;
+  {
+    std::scoped_lock lock(watcher->mutex_);
+    for (unsigned i = 0; i < change->numDocs; i++) {
+      auto docID = change->docIDs[i];
+      auto it = watcher->watches_.find(
+          std::string(static_cast<const char *>(docID.buf), docID.size));
+      if (it != watcher->watches_.end()) {
+        changedWatches.insert(changedWatches.end(), it->second.begin(),
+                              it->second.end());
+      }
+    }
+  }
+
+  for (auto &watch : changedWatches) {
+    watch->changed(watch);
+  }
+}
+
+}  // namespace CBLDart
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AsyncCallback.h"
+#include "CBL+Dart.h"
+
+namespace CBLDart {
+
+// === DocumentWatcher ========================================================
+
+/**
+ * Watches documents of a collection for changes, through a single collection
+ * change listener, and notifies the callbacks which watch a changed document.
+ *
+ * Each collection has at most one watcher, which exists as long as it has
+ * watches.
+ *
+ * A watch can have a debounce window, in which case it is notified at the end
+ * of the window that starts with the first change of the document, instead of
+ * for every change. All changes in the window are coalesced into a single
+ * notification.
+ */
+class DocumentWatcher {
+ public:
+  class Watch;
+
+  /**
+   * Starts to watch the document with `docID` in `collection` and notifies
+   * `callback` when it changes.
+   *
+   * The returned watch must be passed to `removeWatch` before `callback` is
+   * deleted.
+   */
+  static std::shared_ptr<Watch> addWatch(const CBLCollection *collection,
+                                         FLString docID,
+                                         AsyncCallback *callback,
+                                         std::chrono::milliseconds debounce);
+
+  /**
+   * Stops `watch` and removes the watcher of its collection if it was its last
+   * watch.
+   *
+   * Must be called while holding the lock of the database of the collection.
+   */
+  static void removeWatch(const std::shared_ptr<Watch> &watch);
+
+  DocumentWatcher(const DocumentWatcher &) = delete;
+  DocumentWatcher &operator=(const DocumentWatcher &) = delete;
+
+ private:
+  explicit DocumentWatcher(const CBLCollection *collection);
+  ~DocumentWatcher();
+
+  static void collectionChanged(void *context,
+                                const CBLCollectionChange *change);
+
+  const CBLCollection *collection_;
+  CBLListenerToken *listenerToken_ = nullptr;
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::vector<std::shared_ptr<Watch>>>
+      watches_;
+};
+
+}  // namespace CBLDart
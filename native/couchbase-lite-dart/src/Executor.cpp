@@ -0,0 +1,54 @@
+#include "Executor.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace CBLDart {
+
+// === Executor ===============================================================
+
+// The executors are never destroyed, because their threads can still be
+// running while static objects are destroyed.
+
+Executor &Executor::queries() {
+  // SQLite serializes the queries of a database, so more threads than this
+  // rarely help.
+  static auto executor =
+      new Executor(std::clamp(std::thread::hardware_concurrency(), 2u, 4u));
+  return *executor;
+}
+
+Executor &Executor::cleanup() {
+  static auto executor = new Executor(1);
+  return *executor;
+}
+
+Executor::Executor(unsigned threadCount) {
+  for (unsigned i = 0; i < threadCount; i++) {
+    std::thread([this]() { run(); }).detach();
+  }
+}
+
+void Executor::submit(std::function<void()> task) {
+  {
+    std::scoped_lock lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+void Executor::run() {
+  std::unique_lock lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() { return !tasks_.empty(); });
+
+    auto task = std::move(tasks_.front());
+    tasks_.pop_front();
+
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
+
+}  // namespace CBLDart
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace CBLDart {
+
+// === Executor ===============================================================
+
+/**
+ * A pool of background threads on which tasks are executed, so that they
+ * don't block the thread which submitted them.
+ *
+ * Tasks are run in the order in which they were submitted, by as many threads
+ * as there are in the pool.
+ */
+class Executor {
+ public:
+  /**
+   * The executor on which queries and document operations are executed, so
+   * that they don't block the isolate which started them.
+   */
+  static Executor &queries();
+
+  /**
+   * The executor with a single thread, on which native objects are released
+   * when releasing them has to wait for something, like a replicator that is
+   * stopping, so that neither the Dart finalizer thread nor the thread which
+   * is waited for is blocked. The replicator scheduler also uses it to start
+   * and suspend replicators outside of their change listeners.
+   *
+   * Tasks are run one after the other.
+   */
+  static Executor &cleanup();
+
+  Executor(const Executor &) = delete;
+  Executor &operator=(const Executor &) = delete;
+
+  void submit(std::function<void()> task);
+
+ private:
+  explicit Executor(unsigned threadCount);
+
+  void run();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+};
+
+}  // namespace CBLDart
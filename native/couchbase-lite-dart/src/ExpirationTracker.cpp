@@ -0,0 +1,183 @@
+#include "ExpirationTracker.h"
+
+#include "Executor.h"
+
+namespace CBLDart {
+
+// === ExpirationTracker ======================================================
+
+ExpirationTracker &ExpirationTracker::instance() {
+  // The tracker is never destroyed, because change listeners can still be
+  // called by other threads while static objects are destroyed.
+  static auto tracker = new ExpirationTracker;
+  return *tracker;
+}
+
+void ExpirationTracker::track(const CBLCollection *collection,
+                              const FLString *docIDs,
+                              const CBLTimestamp *expirations, size_t count) {
+  std::unique_lock lock(mutex_);
+  auto it = collections_.find(collection);
+  auto state = it == collections_.end() ? nullptr : &it->second;
+
+  for (size_t i = 0; i < count; i++) {
+    std::string docID(static_cast<const char *>(docIDs[i].buf),
+                      docIDs[i].size);
+    if (expirations[i] > 0) {
+      if (!state) {
+        state = &collectionState(collection, lock);
+      }
+      state->expirations[std::move(docID)] = expirations[i];
+    } else if (state) {
+      state->expirations.erase(docID);
+    }
+  }
+}
+
+void ExpirationTracker::purge(const CBLDatabase *database) {
+  std::vector<std::pair<const CBLCollection *, CBLListenerToken *>> removed;
+  {
+    std::scoped_lock lock(mutex_);
+    for (auto it = collections_.begin(); it != collections_.end();) {
+      if (it->second.database == database) {
+        removed.emplace_back(it->first, it->second.listenerToken);
+        it = collections_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  for (auto [collection, listenerToken] : removed) {
+    CBLListener_Remove(listenerToken);
+    CBLCollection_Release(collection);
+  }
+}
+
+CBLDart_ExpirationStats ExpirationTracker::stats(
+    const CBLCollection *collection) {
+  CBLDart_ExpirationStats stats{};
+  std::scoped_lock lock(mutex_);
+  auto it = collections_.find(collection);
+  if (it == collections_.end()) {
+    return stats;
+  }
+
+  auto &state = it->second;
+  stats.purgedCount = state.purgedCount;
+  stats.pendingCount = state.expirations.size();
+  for (auto &[_, expiration] : state.expirations) {
+    if (stats.nextExpiration == 0 || expiration < stats.nextExpiration) {
+      stats.nextExpiration = expiration;
+    }
+  }
+  return stats;
+}
+
+void ExpirationTracker::collectionChanged(void *context,
+                                          const CBLCollectionChange *change) {
+  auto &self = instance();
+  auto now = CBL_Now();
+
+  std::vector<std::string> expired;
+  {
+    std::scoped_lock lock(self.mutex_);
+    auto it = self.collections_.find(change->collection);
+    if (it == self.collections_.end()) {
+      return;
+    }
+
+    auto &state = it->second;
+    for (unsigned i = 0; i < change->numDocs; i++) {
+      auto docID = change->docIDs[i];
+      std::string id(static_cast<const char *>(docID.buf), docID.size);
+      auto entryIt = state.expirations.find(id);
+      // Changes of documents which have not expired yet are regular updates,
+      // which keep the expiration date of the document.
+      if (entryIt == state.expirations.end() || entryIt->second > now) {
+        continue;
+      }
+      expired.push_back(std::move(id));
+    }
+  }
+  if (expired.empty()) {
+    return;
+  }
+
+  // Documents cannot be read from within a change listener, since it is
+  // called while Couchbase Lite holds its own locks.
+  auto collection = CBLCollection_Retain(change->collection);
+  Executor::cleanup().submit([collection, expired = std::move(expired)]() {
+    instance().checkPurged(collection, expired);
+    CBLCollection_Release(collection);
+  });
+}
+
+void ExpirationTracker::checkPurged(const CBLCollection *collection,
+                                    const std::vector<std::string> &docIDs) {
+  std::vector<const std::string *> purged;
+  for (auto &docID : docIDs) {
+    CBLError error{};
+    auto document = CBLCollection_GetDocument(
+        collection, {docID.data(), docID.size()}, &error);
+    if (document) {
+      CBLDocument_Release(document);
+    } else if (error.code == 0) {
+      // A document which does not exist is returned without an error.
+      purged.push_back(&docID);
+    }
+  }
+  if (purged.empty()) {
+    return;
+  }
+
+  std::scoped_lock lock(mutex_);
+  auto it = collections_.find(collection);
+  if (it == collections_.end()) {
+    return;
+  }
+
+  auto &state = it->second;
+  for (auto docID : purged) {
+    // The expiration might have been reset in the meantime.
+    auto entryIt = state.expirations.find(*docID);
+    if (entryIt == state.expirations.end() || entryIt->second > CBL_Now()) {
+      continue;
+    }
+    state.expirations.erase(entryIt);
+    state.purgedCount++;
+  }
+}
+
+ExpirationTracker::CollectionState &ExpirationTracker::collectionState(
+    const CBLCollection *collection, std::unique_lock<std::mutex> &lock) {
+  while (true) {
+    auto it = collections_.find(collection);
+    if (it != collections_.end()) {
+      return it->second;
+    }
+
+    // The listener is added without holding the lock, because change
+    // listeners are called while Couchbase Lite holds its own locks, and
+    // they acquire the lock of the tracker.
+    lock.unlock();
+    auto listenerToken =
+        CBLCollection_AddChangeListener(collection, collectionChanged, nullptr);
+    lock.lock();
+
+    if (collections_.find(collection) == collections_.end()) {
+      auto &state = collections_[collection];
+      state.database = CBLCollection_Database(collection);
+      state.listenerToken = listenerToken;
+      CBLCollection_Retain(collection);
+      return state;
+    }
+
+    // Another thread has created the state in the meantime.
+    lock.unlock();
+    CBLListener_Remove(listenerToken);
+    lock.lock();
+  }
+}
+
+}  // namespace CBLDart
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CBL+Dart.h"
+
+namespace CBLDart {
+
+// === ExpirationTracker ======================================================
+
+/**
+ * Tracks the expiration dates of documents which have been set through
+ * `CBLDart_CBLCollection_SetDocumentExpiration` or
+ * `CBLDart_CBLCollection_SetDocumentExpirations`, to count the documents
+ * which are purged because they expired.
+ *
+ * Couchbase Lite purges expired documents in the background, without
+ * reporting which documents it purged. The tracker registers a collection
+ * change listener for each collection with tracked documents. When a tracked
+ * document whose expiration date has passed changes, the tracker looks the
+ * document up on the cleanup executor and only counts an expiration purge if
+ * the document no longer exists. Other changes, such as an update shortly
+ * before the document is purged, keep the document tracked.
+ */
+class ExpirationTracker {
+ public:
+  static ExpirationTracker &instance();
+
+  ExpirationTracker(const ExpirationTracker &) = delete;
+  ExpirationTracker &operator=(const ExpirationTracker &) = delete;
+
+  /**
+   * Records the `expirations` of the `count` documents with `docIDs` in
+   * `collection`. An expiration of `0` stops tracking a document.
+   */
+  void track(const CBLCollection *collection, const FLString *docIDs,
+             const CBLTimestamp *expirations, size_t count);
+
+  /**
+   * Stops tracking the documents of all collections of `database` and
+   * removes their change listeners.
+   *
+   * Must be called before `database` is closed.
+   */
+  void purge(const CBLDatabase *database);
+
+  CBLDart_ExpirationStats stats(const CBLCollection *collection);
+
+ private:
+  ExpirationTracker() = default;
+
+  struct CollectionState {
+    const CBLDatabase *database;
+    CBLListenerToken *listenerToken = nullptr;
+    /** The expiration dates of the tracked documents, keyed by their ids. */
+    std::unordered_map<std::string, CBLTimestamp> expirations;
+    uint64_t purgedCount = 0;
+  };
+
+  static void collectionChanged(void *context,
+                                const CBLCollectionChange *change);
+
+  /**
+   * Counts the documents with `docIDs` in `collection`, which no longer
+   * exist, as purged.
+   */
+  void checkPurged(const CBLCollection *collection,
+                   const std::vector<std::string> &docIDs);
+
+  /**
+   * Returns the state of `collection`, registering its change listener if it
+   * does not exist yet.
+   *
+   * Must be called while holding `lock`, which is temporarily released.
+   */
+  CollectionState &collectionState(const CBLCollection *collection,
+                                   std::unique_lock<std::mutex> &lock);
+
+  std::mutex mutex_;
+  std::unordered_map<const CBLCollection *, CollectionState> collections_;
+};
+
+}  // namespace CBLDart
@@ -0,0 +1,776 @@
+#include "FilterExpression.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Utils.h"
+
+namespace CBLDart {
+
+// === Values =================================================================
+
+namespace {
+
+/**
+ * The result of evaluating a node.
+ *
+ * The order of the types is the order in which values of different types are
+ * collated.
+ */
+struct FilterValue {
+  enum Type : uint8_t {
+    kMissing,
+    kNull,
+    kBool,
+    kNumber,
+    kString,
+    kArray,
+    kDict,
+    kData,
+  };
+
+  Type type = kMissing;
+  bool boolean = false;
+  double number = 0;
+  FLString string = kFLSliceNull;
+  FLValue value = nullptr;
+
+  static FilterValue missing() { return {}; }
+
+  static FilterValue null() {
+    FilterValue result;
+    result.type = kNull;
+    return result;
+  }
+
+  static FilterValue fromBool(bool boolean) {
+    FilterValue result;
+    result.type = kBool;
+    result.boolean = boolean;
+    return result;
+  }
+
+  static FilterValue fromNumber(double number) {
+    FilterValue result;
+    result.type = kNumber;
+    result.number = number;
+    return result;
+  }
+
+  static FilterValue fromString(FLString string) {
+    FilterValue result;
+    result.type = kString;
+    result.string = string;
+    return result;
+  }
+
+  static FilterValue fromFLValue(FLValue value) {
+    FilterValue result;
+    result.value = value;
+    switch (FLValue_GetType(value)) {
+      case kFLUndefined:
+        result.type = kMissing;
+        break;
+      case kFLNull:
+        result.type = kNull;
+        break;
+      case kFLBoolean:
+        result.type = kBool;
+        result.boolean = FLValue_AsBool(value);
+        break;
+      case kFLNumber:
+        result.type = kNumber;
+        result.number = FLValue_AsDouble(value);
+        break;
+      case kFLString:
+        result.type = kString;
+        result.string = FLValue_AsString(value);
+        break;
+      case kFLData:
+        result.type = kData;
+        break;
+      case kFLArray:
+        result.type = kArray;
+        break;
+      case kFLDict:
+        result.type = kDict;
+        break;
+    }
+    return result;
+  }
+
+  bool isUnknown() const { return type == kMissing || type == kNull; }
+
+  bool isTrue() const { return type == kBool && boolean; }
+};
+
+int CBLDart_CompareFilterValues(const FilterValue &a, const FilterValue &b);
+
+int CBLDart_CompareFLValues(FLValue a, FLValue b) {
+  return CBLDart_CompareFilterValues(FilterValue::fromFLValue(a),
+                                     FilterValue::fromFLValue(b));
+}
+
+int CBLDart_CompareFilterValues(const FilterValue &a, const FilterValue &b) {
+  if (a.type != b.type) {
+    return a.type < b.type ? -1 : 1;
+  }
+
+  switch (a.type) {
+    case FilterValue::kMissing:
+    case FilterValue::kNull:
+      return 0;
+    case FilterValue::kBool:
+      return static_cast<int>(a.boolean) - static_cast<int>(b.boolean);
+    case FilterValue::kNumber:
+      return a.number < b.number ? -1 : (a.number > b.number ? 1 : 0);
+    case FilterValue::kString:
+      return FLSlice_Compare(a.string, b.string);
+    case FilterValue::kArray: {
+      auto arrayA = FLValue_AsArray(a.value);
+      auto arrayB = FLValue_AsArray(b.value);
+      auto countA = FLArray_Count(arrayA);
+      auto countB = FLArray_Count(arrayB);
+      for (uint32_t i = 0; i < countA && i < countB; i++) {
+        auto result = CBLDart_CompareFLValues(FLArray_Get(arrayA, i),
+                                              FLArray_Get(arrayB, i));
+        if (result != 0) {
+          return result;
+        }
+      }
+      return countA < countB ? -1 : (countA > countB ? 1 : 0);
+    }
+    case FilterValue::kDict:
+    case FilterValue::kData: {
+      // Dicts and data are only compared for equality.
+      if (FLValue_IsEqual(a.value, b.value)) {
+        return 0;
+      }
+      return a.value < b.value ? -1 : 1;
+    }
+  }
+
+  return 0;
+}
+
+size_t CBLDart_UTF8CharacterSize(uint8_t leadingByte) {
+  if ((leadingByte & 0xE0) == 0xC0) return 2;
+  if ((leadingByte & 0xF0) == 0xE0) return 3;
+  if ((leadingByte & 0xF8) == 0xF0) return 4;
+  return 1;
+}
+
+/**
+ * Matches `string` against a `LIKE` pattern, in which `%` matches any
+ * sequence of characters, `_` matches a single character and `\` escapes the
+ * following character.
+ */
+bool CBLDart_MatchesLikePattern(std::string_view string,
+                                std::string_view pattern) {
+  auto advance = [&](size_t position) {
+    return std::min(string.size(),
+                    position + CBLDart_UTF8CharacterSize(
+                                   static_cast<uint8_t>(string[position])));
+  };
+
+  size_t s = 0;
+  size_t p = 0;
+  // Where to resume after the last `%`, if the rest of the pattern does not
+  // match.
+  auto wildcardP = std::string_view::npos;
+  size_t wildcardS = 0;
+
+  while (s < string.size()) {
+    if (p < pattern.size()) {
+      auto c = pattern[p];
+      if (c == '%') {
+        wildcardP = ++p;
+        wildcardS = s;
+        continue;
+      }
+      if (c == '_') {
+        s = advance(s);
+        p++;
+        continue;
+      }
+      auto patternLength = 1;
+      if (c == '\\' && p + 1 < pattern.size()) {
+        c = pattern[p + 1];
+        patternLength = 2;
+      }
+      if (string[s] == c) {
+        s++;
+        p += patternLength;
+        continue;
+      }
+    }
+
+    if (wildcardP == std::string_view::npos) {
+      return false;
+    }
+    wildcardS = advance(wildcardS);
+    s = wildcardS;
+    p = wildcardP;
+  }
+
+  while (p < pattern.size() && pattern[p] == '%') {
+    p++;
+  }
+  return p == pattern.size();
+}
+
+}  // namespace
+
+// === Nodes ==================================================================
+
+enum class FilterOp : uint8_t {
+  kLiteral,
+  kArrayLiteral,
+  kProperty,
+  kMeta,
+  kVariable,
+  kMissing,
+  kNot,
+  kAnd,
+  kOr,
+  kEqual,
+  kNotEqual,
+  kLess,
+  kLessOrEqual,
+  kGreater,
+  kGreaterOrEqual,
+  kIs,
+  kIsNot,
+  kLike,
+  kIn,
+  kBetween,
+  kAny,
+  kEvery,
+  kAnyAndEvery,
+};
+
+enum class FilterMeta : uint8_t {
+  kID,
+  kRevisionID,
+  kSequence,
+  kDeleted,
+};
+
+struct FilterExpressionNode {
+  FilterOp op;
+  FLValue literal = nullptr;
+  FilterMeta meta = FilterMeta::kID;
+  FLKeyPath keyPath = nullptr;
+  std::string variable;
+  std::vector<std::unique_ptr<FilterExpressionNode>> operands;
+
+  explicit FilterExpressionNode(FilterOp op) : op(op) {}
+
+  ~FilterExpressionNode() {
+    if (keyPath) {
+      FLKeyPath_Free(keyPath);
+    }
+  }
+};
+
+// === Compiler ===============================================================
+
+namespace {
+
+struct FilterOperator {
+  const char *name;
+  FilterOp op;
+  // The number of operands, or -1 for two or more operands.
+  int operandCount;
+};
+
+const FilterOperator kFilterOperators[] = {
+    {"MISSING", FilterOp::kMissing, 0},
+    {"NOT", FilterOp::kNot, 1},
+    {"AND", FilterOp::kAnd, -1},
+    {"OR", FilterOp::kOr, -1},
+    {"=", FilterOp::kEqual, 2},
+    {"!=", FilterOp::kNotEqual, 2},
+    {"<", FilterOp::kLess, 2},
+    {"<=", FilterOp::kLessOrEqual, 2},
+    {">", FilterOp::kGreater, 2},
+    {">=", FilterOp::kGreaterOrEqual, 2},
+    {"IS", FilterOp::kIs, 2},
+    {"IS NOT", FilterOp::kIsNot, 2},
+    {"LIKE", FilterOp::kLike, 2},
+    {"IN", FilterOp::kIn, 2},
+    {"BETWEEN", FilterOp::kBetween, 3},
+    {"ANY", FilterOp::kAny, 3},
+    {"EVERY", FilterOp::kEvery, 3},
+    {"ANY AND EVERY", FilterOp::kAnyAndEvery, 3},
+};
+
+const std::pair<std::string_view, FilterMeta> kFilterMetaProperties[] = {
+    {"_id", FilterMeta::kID},
+    {"_revisionID", FilterMeta::kRevisionID},
+    {"_sequence", FilterMeta::kSequence},
+    {"_deleted", FilterMeta::kDeleted},
+};
+
+class FilterExpressionCompiler {
+ public:
+  std::unique_ptr<FilterExpressionNode> compile(FLValue value,
+                                                bool allowArrayLiteral) {
+    auto array = FLValue_AsArray(value);
+    if (!array) {
+      auto node = std::make_unique<FilterExpressionNode>(FilterOp::kLiteral);
+      node->literal = value;
+      return node;
+    }
+
+    auto count = FLArray_Count(array);
+    auto operatorSlice = FLValue_AsString(FLArray_Get(array, 0));
+    if (!operatorSlice.buf || operatorSlice.size == 0) {
+      return fail("expected an operator");
+    }
+    std::string_view name(static_cast<const char *>(operatorSlice.buf),
+                          operatorSlice.size);
+
+    if (name.front() == '.') {
+      if (count != 1) {
+        return fail("unsupported property syntax");
+      }
+      return compileProperty(name.substr(1));
+    }
+
+    if (name.front() == '?') {
+      if (count != 1) {
+        return fail("unsupported variable syntax");
+      }
+      return compileVariable(name.substr(1));
+    }
+
+    if (name == "[]") {
+      if (!allowArrayLiteral) {
+        return fail("array literals are only supported in IN and ANY");
+      }
+      auto node =
+          std::make_unique<FilterExpressionNode>(FilterOp::kArrayLiteral);
+      for (uint32_t i = 1; i < count; i++) {
+        if (!compileOperand(*node, FLArray_Get(array, i))) {
+          return nullptr;
+        }
+      }
+      return node;
+    }
+
+    for (auto &filterOperator : kFilterOperators) {
+      if (name != filterOperator.name) {
+        continue;
+      }
+
+      auto operandCount = static_cast<int>(count) - 1;
+      if (filterOperator.operandCount == -1 ? operandCount < 2
+                                            : operandCount !=
+                                                  filterOperator.operandCount) {
+        return fail("wrong number of operands for " + std::string(name));
+      }
+
+      auto node = std::make_unique<FilterExpressionNode>(filterOperator.op);
+      switch (filterOperator.op) {
+        case FilterOp::kIn:
+          if (!compileOperand(*node, FLArray_Get(array, 1)) ||
+              !compileOperand(*node, FLArray_Get(array, 2), true)) {
+            return nullptr;
+          }
+          break;
+        case FilterOp::kAny:
+        case FilterOp::kEvery:
+        case FilterOp::kAnyAndEvery: {
+          auto variable = FLValue_AsString(FLArray_Get(array, 1));
+          if (!variable.buf || variable.size == 0) {
+            return fail("expected a variable name");
+          }
+          node->variable = CBLDart_FLStringToString(variable);
+          if (!compileOperand(*node, FLArray_Get(array, 2), true) ||
+              !compileOperand(*node, FLArray_Get(array, 3))) {
+            return nullptr;
+          }
+          break;
+        }
+        default:
+          for (uint32_t i = 1; i < count; i++) {
+            if (!compileOperand(*node, FLArray_Get(array, i))) {
+              return nullptr;
+            }
+          }
+          break;
+      }
+      return node;
+    }
+
+    return fail("unsupported operator " + std::string(name));
+  }
+
+  const std::string &errorMessage() const { return errorMessage_; }
+
+ private:
+  bool compileOperand(FilterExpressionNode &node, FLValue value,
+                      bool allowArrayLiteral = false) {
+    auto operand = compile(value, allowArrayLiteral);
+    if (!operand) {
+      return false;
+    }
+    node.operands.push_back(std::move(operand));
+    return true;
+  }
+
+  std::unique_ptr<FilterExpressionNode> compileProperty(std::string_view path) {
+    for (auto &[metaPath, meta] : kFilterMetaProperties) {
+      if (path == metaPath) {
+        auto node = std::make_unique<FilterExpressionNode>(FilterOp::kMeta);
+        node->meta = meta;
+        return node;
+      }
+    }
+
+    auto node = std::make_unique<FilterExpressionNode>(FilterOp::kProperty);
+    // An empty path refers to the whole document.
+    if (!path.empty() && !(node->keyPath = compileKeyPath(path))) {
+      return nullptr;
+    }
+    return node;
+  }
+
+  std::unique_ptr<FilterExpressionNode> compileVariable(std::string_view path) {
+    auto nameEnd = path.find_first_of(".[");
+    auto node = std::make_unique<FilterExpressionNode>(FilterOp::kVariable);
+    node->variable = std::string(path.substr(0, nameEnd));
+    if (node->variable.empty()) {
+      return fail("expected a variable name");
+    }
+
+    if (nameEnd != std::string_view::npos) {
+      auto subPath = path.substr(nameEnd);
+      if (subPath.front() == '.') {
+        subPath.remove_prefix(1);
+      }
+      if (!(node->keyPath = compileKeyPath(subPath))) {
+        return nullptr;
+      }
+    }
+    return node;
+  }
+
+  FLKeyPath compileKeyPath(std::string_view path) {
+    FLError error;
+    auto keyPath = FLKeyPath_New({path.data(), path.size()}, &error);
+    if (!keyPath) {
+      fail("invalid key path " + std::string(path));
+    }
+    return keyPath;
+  }
+
+  std::nullptr_t fail(const std::string &message) {
+    if (errorMessage_.empty()) {
+      errorMessage_ = message;
+    }
+    return nullptr;
+  }
+
+  std::string errorMessage_;
+};
+
+}  // namespace
+
+// === Evaluator ==============================================================
+
+namespace {
+
+class FilterExpressionEvaluator {
+ public:
+  FilterExpressionEvaluator(const CBLDocument *document,
+                            CBLDocumentFlags flags)
+      : document_(document),
+        properties_(CBLDocument_Properties(document)),
+        flags_(flags) {}
+
+  FilterValue evaluate(const FilterExpressionNode &node) {
+    auto &operands = node.operands;
+
+    switch (node.op) {
+      case FilterOp::kLiteral:
+        return FilterValue::fromFLValue(node.literal);
+
+      case FilterOp::kArrayLiteral:
+        // Array literals are only used as operands of IN and range
+        // predicates, which iterate over them directly.
+        return FilterValue::missing();
+
+      case FilterOp::kProperty: {
+        auto root = reinterpret_cast<FLValue>(properties_);
+        return FilterValue::fromFLValue(
+            node.keyPath ? FLKeyPath_Eval(node.keyPath, root) : root);
+      }
+
+      case FilterOp::kMeta:
+        switch (node.meta) {
+          case FilterMeta::kID:
+            return FilterValue::fromString(CBLDocument_ID(document_));
+          case FilterMeta::kRevisionID:
+            return FilterValue::fromString(CBLDocument_RevisionID(document_));
+          case FilterMeta::kSequence:
+            return FilterValue::fromNumber(
+                static_cast<double>(CBLDocument_Sequence(document_)));
+          case FilterMeta::kDeleted:
+            return FilterValue::fromBool(flags_ & kCBLDocumentFlagsDeleted);
+        }
+        return FilterValue::missing();
+
+      case FilterOp::kVariable:
+        for (auto it = variables_.rbegin(); it != variables_.rend(); it++) {
+          if (it->first == node.variable) {
+            auto &value = it->second;
+            if (!node.keyPath) {
+              return value;
+            }
+            return FilterValue::fromFLValue(
+                value.value ? FLKeyPath_Eval(node.keyPath, value.value)
+                            : nullptr);
+          }
+        }
+        return FilterValue::missing();
+
+      case FilterOp::kMissing:
+        return FilterValue::missing();
+
+      case FilterOp::kNot: {
+        auto value = evaluate(*operands[0]);
+        if (value.type != FilterValue::kBool) {
+          return value.type == FilterValue::kMissing ? value
+                                                     : FilterValue::null();
+        }
+        return FilterValue::fromBool(!value.boolean);
+      }
+
+      case FilterOp::kAnd:
+      case FilterOp::kOr: {
+        auto isAnd = node.op == FilterOp::kAnd;
+        auto result = FilterValue::fromBool(isAnd);
+        for (auto &operand : operands) {
+          auto value = evaluate(*operand);
+          if (value.type == FilterValue::kBool) {
+            if (value.boolean != isAnd) {
+              return value;
+            }
+          } else if (value.type == FilterValue::kMissing) {
+            result = value;
+          } else if (result.type != FilterValue::kMissing) {
+            result = FilterValue::null();
+          }
+        }
+        return result;
+      }
+
+      case FilterOp::kEqual:
+      case FilterOp::kNotEqual:
+      case FilterOp::kLess:
+      case FilterOp::kLessOrEqual:
+      case FilterOp::kGreater:
+      case FilterOp::kGreaterOrEqual: {
+        auto left = evaluate(*operands[0]);
+        auto right = evaluate(*operands[1]);
+        if (left.isUnknown() || right.isUnknown()) {
+          return left.type == FilterValue::kMissing ||
+                         right.type == FilterValue::kMissing
+                     ? FilterValue::missing()
+                     : FilterValue::null();
+        }
+        return FilterValue::fromBool(
+            compare(node.op, CBLDart_CompareFilterValues(left, right)));
+      }
+
+      case FilterOp::kIs:
+      case FilterOp::kIsNot: {
+        auto left = evaluate(*operands[0]);
+        auto right = evaluate(*operands[1]);
+        auto isEqual = CBLDart_CompareFilterValues(left, right) == 0;
+        return FilterValue::fromBool(node.op == FilterOp::kIs ? isEqual
+                                                              : !isEqual);
+      }
+
+      case FilterOp::kLike: {
+        auto string = evaluate(*operands[0]);
+        auto pattern = evaluate(*operands[1]);
+        if (string.type == FilterValue::kMissing ||
+            pattern.type == FilterValue::kMissing) {
+          return FilterValue::missing();
+        }
+        if (string.type != FilterValue::kString ||
+            pattern.type != FilterValue::kString) {
+          return FilterValue::null();
+        }
+        return FilterValue::fromBool(CBLDart_MatchesLikePattern(
+            {static_cast<const char *>(string.string.buf), string.string.size},
+            {static_cast<const char *>(pattern.string.buf),
+             pattern.string.size}));
+      }
+
+      case FilterOp::kIn: {
+        auto value = evaluate(*operands[0]);
+        if (value.isUnknown()) {
+          return value;
+        }
+        auto isIn = false;
+        forEachElement(*operands[1], [&](const FilterValue &element) {
+          isIn = CBLDart_CompareFilterValues(value, element) == 0;
+          return !isIn;
+        });
+        return FilterValue::fromBool(isIn);
+      }
+
+      case FilterOp::kBetween: {
+        auto value = evaluate(*operands[0]);
+        auto lower = evaluate(*operands[1]);
+        auto upper = evaluate(*operands[2]);
+        if (value.isUnknown() || lower.isUnknown() || upper.isUnknown()) {
+          return FilterValue::null();
+        }
+        return FilterValue::fromBool(
+            CBLDart_CompareFilterValues(value, lower) >= 0 &&
+            CBLDart_CompareFilterValues(value, upper) <= 0);
+      }
+
+      case FilterOp::kAny:
+      case FilterOp::kEvery:
+      case FilterOp::kAnyAndEvery: {
+        auto isAny = node.op == FilterOp::kAny;
+        auto satisfiesAll = true;
+        auto satisfiesAny = false;
+        size_t count = 0;
+        forEachElement(*operands[0], [&](const FilterValue &element) {
+          count++;
+          variables_.emplace_back(node.variable, element);
+          auto satisfies = evaluate(*operands[1]).isTrue();
+          variables_.pop_back();
+
+          satisfiesAny |= satisfies;
+          satisfiesAll &= satisfies;
+          // Stop as soon as the result is known.
+          return isAny ? !satisfies : satisfies;
+        });
+
+        switch (node.op) {
+          case FilterOp::kAny:
+            return FilterValue::fromBool(satisfiesAny);
+          case FilterOp::kEvery:
+            return FilterValue::fromBool(satisfiesAll);
+          default:
+            return FilterValue::fromBool(count > 0 && satisfiesAll);
+        }
+      }
+    }
+
+    return FilterValue::missing();
+  }
+
+ private:
+  static bool compare(FilterOp op, int comparison) {
+    switch (op) {
+      case FilterOp::kEqual:
+        return comparison == 0;
+      case FilterOp::kNotEqual:
+        return comparison != 0;
+      case FilterOp::kLess:
+        return comparison < 0;
+      case FilterOp::kLessOrEqual:
+        return comparison <= 0;
+      case FilterOp::kGreater:
+        return comparison > 0;
+      default:
+        return comparison >= 0;
+    }
+  }
+
+  /**
+   * Calls `callback` for each element of the array that `node` evaluates to,
+   * until it returns `false`.
+   */
+  void forEachElement(
+      const FilterExpressionNode &node,
+      const std::function<bool(const FilterValue &)> &callback) {
+    if (node.op == FilterOp::kArrayLiteral) {
+      for (auto &operand : node.operands) {
+        if (!callback(evaluate(*operand))) {
+          return;
+        }
+      }
+      return;
+    }
+
+    auto value = evaluate(node);
+    if (value.type != FilterValue::kArray) {
+      return;
+    }
+
+    FLArrayIterator iterator;
+    FLArrayIterator_Begin(FLValue_AsArray(value.value), &iterator);
+    while (auto element = FLArrayIterator_GetValue(&iterator)) {
+      if (!callback(FilterValue::fromFLValue(element))) {
+        return;
+      }
+      FLArrayIterator_Next(&iterator);
+    }
+  }
+
+  const CBLDocument *document_;
+  FLDict properties_;
+  CBLDocumentFlags flags_;
+  std::vector<std::pair<std::string_view, FilterValue>> variables_;
+};
+
+}  // namespace
+
+// === FilterExpression =======================================================
+
+std::unique_ptr<FilterExpression> FilterExpression::compile(
+    FLString json, CBLError *errorOut) {
+  FLError error;
+  auto doc = FLDoc_FromJSON(json, &error);
+  if (!doc) {
+    *errorOut = {kCBLDomain, kCBLErrorInvalidQuery, 0};
+    CBL_Log(kCBLLogDomainReplicator, kCBLLogError,
+            "Replication filter expression is not valid JSON");
+    return nullptr;
+  }
+
+  FilterExpressionCompiler compiler;
+  auto root = compiler.compile(FLDoc_GetRoot(doc), false);
+  if (!root) {
+    FLDoc_Release(doc);
+    *errorOut = {kCBLDomain, kCBLErrorInvalidQuery, 0};
+    CBL_Log(kCBLLogDomainReplicator, kCBLLogError,
+            "Invalid replication filter expression: %s",
+            compiler.errorMessage().c_str());
+    return nullptr;
+  }
+
+  return std::unique_ptr<FilterExpression>(
+      new FilterExpression(doc, std::move(root)));
+}
+
+FilterExpression::FilterExpression(FLDoc doc,
+                                   std::unique_ptr<FilterExpressionNode> root)
+    : doc_(doc), root_(std::move(root)) {}
+
+FilterExpression::~FilterExpression() {
+  // The nodes reference values in the doc.
+  root_.reset();
+  FLDoc_Release(doc_);
+}
+
+bool FilterExpression::evaluate(const CBLDocument *document,
+                                CBLDocumentFlags flags) const {
+  return FilterExpressionEvaluator(document, flags).evaluate(*root_).isTrue();
+}
+
+}  // namespace CBLDart
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <memory>
+
+#include "CBL+Dart.h"
+
+namespace CBLDart {
+
+struct FilterExpressionNode;
+
+// === FilterExpression =======================================================
+
+/**
+ * A replication filter which is expressed as a query expression in the JSON
+ * syntax that is produced by the query builder, and which is evaluated
+ * natively against documents.
+ *
+ * The following subset of the syntax is supported:
+ *
+ * - Literals and dict literals.
+ * - Array literals (`["[]", ...]`), as the right operand of `IN` and the
+ *   source of range predicates.
+ * - Properties of the document (`[".path"]`), where `path` is a Fleece key
+ *   path.
+ * - Document metadata (`["._id"]`, `["._revisionID"]`, `["._sequence"]` and
+ *   `["._deleted"]`).
+ * - Variables of range predicates (`["?name"]` or `["?name.path"]`).
+ * - The operators `MISSING`, `NOT`, `AND`, `OR`, `=`, `!=`, `<`, `<=`, `>`,
+ *   `>=`, `IS`, `IS NOT`, `LIKE`, `IN` and `BETWEEN`.
+ * - The range predicates `ANY`, `EVERY` and `ANY AND EVERY`.
+ *
+ * A document passes the filter if the expression evaluates to `true`.
+ */
+class FilterExpression {
+ public:
+  /**
+   * Compiles a filter expression from its JSON representation.
+   *
+   * Returns `nullptr` and sets `errorOut` if the expression is invalid or
+   * uses unsupported syntax.
+   */
+  static std::unique_ptr<FilterExpression> compile(FLString json,
+                                                   CBLError *errorOut);
+
+  ~FilterExpression();
+
+  FilterExpression(const FilterExpression &) = delete;
+  FilterExpression &operator=(const FilterExpression &) = delete;
+
+  bool evaluate(const CBLDocument *document, CBLDocumentFlags flags) const;
+
+ private:
+  FilterExpression(FLDoc doc, std::unique_ptr<FilterExpressionNode> root);
+
+  // Owns the literals which are referenced by the nodes.
+  FLDoc doc_;
+  std::unique_ptr<FilterExpressionNode> root_;
+};
+
+}  // namespace CBLDart
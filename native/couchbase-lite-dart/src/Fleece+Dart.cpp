@@ -1,4 +1,18 @@
-#include <bitset>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <new>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 #include "Fleece+Dart.h"
 #include "Utils.h"
@@ -17,7 +31,48 @@ void CBLDart_FLSliceResult_ReleaseByBuf(void *buf) {
 
 // === Decoder ================================================================
 
-static const size_t kMaxSharedKeys = 2048;
+/**
+ * Returns whether the string in `buf` contains only ASCII characters.
+ *
+ * Dart can create strings which only contain ASCII characters without
+ * decoding UTF-8.
+ */
+static bool CBLDart_IsAscii(const void *buf, size_t size) {
+  auto bytes = static_cast<const uint8_t *>(buf);
+  size_t i = 0;
+
+#if defined(__SSE2__)
+  for (; i + 16 <= size; i += 16) {
+    auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i));
+    if (_mm_movemask_epi8(chunk)) {
+      return false;
+    }
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  for (; i + 16 <= size; i += 16) {
+    if (vmaxvq_u8(vld1q_u8(bytes + i)) & 0x80) {
+      return false;
+    }
+  }
+#endif
+
+  // Check 8 bytes at a time, before checking the remaining bytes one by one.
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i, sizeof(word));
+    if (word & 0x8080808080808080ULL) {
+      return false;
+    }
+  }
+
+  for (; i < size; i++) {
+    if (bytes[i] & 0x80) {
+      return false;
+    }
+  }
+
+  return true;
+}
 
 struct KnownSharedKeys {
   /**
@@ -26,15 +81,24 @@ struct KnownSharedKeys {
    * Returns true if the key was previously unknown.
    */
   bool makeKeyKnown(int key) {
-    if (_knownKeys[key]) {
+    auto index = static_cast<size_t>(key);
+    if (index >= _knownKeys.size()) {
+      // Shared key ids are dense, so growing to the next power of two keeps
+      // the number of reallocations small.
+      size_t size = _knownKeys.empty() ? 64 : _knownKeys.size();
+      while (size <= index) {
+        size *= 2;
+      }
+      _knownKeys.resize(size, false);
+    } else if (_knownKeys[index]) {
       return false;
-    } else {
-      _knownKeys[key] = true;
-      return true;
     }
+
+    _knownKeys[index] = true;
+    return true;
   };
 
-  std::bitset<kMaxSharedKeys> _knownKeys;
+  std::vector<bool> _knownKeys;
 };
 
 KnownSharedKeys *CBLDart_KnownSharedKeys_New() { return new KnownSharedKeys; }
@@ -69,6 +133,7 @@ static void CBLDart_GetLoadedDictKey(KnownSharedKeys *knownSharedKeys,
 
   out->stringBuf = string.buf;
   out->stringSize = string.size;
+  out->isAscii = CBLDart_IsAscii(string.buf, string.size);
 }
 
 void CBLDart_GetLoadedFLValue(FLValue value, CBLDart_LoadedFLValue *out) {
@@ -104,6 +169,7 @@ void CBLDart_GetLoadedFLValue(FLValue value, CBLDart_LoadedFLValue *out) {
       auto string = FLValue_AsString(value);
       out->stringBuf = string.buf;
       out->stringSize = string.size;
+      out->isAscii = CBLDart_IsAscii(string.buf, string.size);
       break;
     }
     case kFLData: {
@@ -134,6 +200,51 @@ void CBLDart_FLDict_GetLoadedFLValue(FLDict dict, FLString key,
   CBLDart_GetLoadedFLValue(FLDict_Get(dict, key), out);
 }
 
+/**
+ * A thread local free list of iterators.
+ *
+ * Decoding nested containers begins and finishes an iterator for each
+ * container. Instead of allocating each iterator, finished iterators are
+ * kept for reuse by the next iterator which is begun on the same thread.
+ */
+template <typename T>
+class CBLDart_IteratorPool {
+ public:
+  ~CBLDart_IteratorPool() {
+    for (auto iterator : _freeIterators) {
+      delete iterator;
+    }
+  }
+
+  static CBLDart_IteratorPool &instance() {
+    static thread_local CBLDart_IteratorPool pool;
+    return pool;
+  }
+
+  T *acquire() {
+    if (_freeIterators.empty()) {
+      return new T{};
+    }
+    auto iterator = _freeIterators.back();
+    _freeIterators.pop_back();
+    return iterator;
+  }
+
+  void release(T *iterator) {
+    if (_freeIterators.size() < kMaxFreeIterators) {
+      _freeIterators.push_back(iterator);
+    } else {
+      delete iterator;
+    }
+  }
+
+ private:
+  // Bounds the memory which is retained after decoding deeply nested data.
+  static const size_t kMaxFreeIterators = 64;
+
+  std::vector<T *> _freeIterators;
+};
+
 struct CBLDart_FLDictIterator {
   CBLDart_LoadedDictKey *_keyOut;
   CBLDart_LoadedFLValue *_valueOut;
@@ -148,7 +259,8 @@ CBLDart_FLDictIterator *CBLDart_FLDictIterator_Begin(
     FLDict dict, KnownSharedKeys *knownSharedKeys,
     CBLDart_LoadedDictKey *keyOut, CBLDart_LoadedFLValue *valueOut,
     bool deleteOnDone, bool preLoad) {
-  auto iterator = new CBLDart_FLDictIterator{};
+  auto iterator =
+      CBLDart_IteratorPool<CBLDart_FLDictIterator>::instance().acquire();
   iterator->_keyOut = keyOut;
   iterator->_valueOut = valueOut;
   iterator->_knownSharedKeys = knownSharedKeys;
@@ -162,7 +274,7 @@ CBLDart_FLDictIterator *CBLDart_FLDictIterator_Begin(
 }
 
 void CBLDart_FLDictIterator_Delete(CBLDart_FLDictIterator *iterator) {
-  delete iterator;
+  CBLDart_IteratorPool<CBLDart_FLDictIterator>::instance().release(iterator);
 }
 
 bool CBLDart_FLDictIterator_Next(CBLDart_FLDictIterator *iterator) {
@@ -191,12 +303,49 @@ bool CBLDart_FLDictIterator_Next(CBLDart_FLDictIterator *iterator) {
   }
 
   if (iterator->_deleteOnDone) {
-    delete iterator;
+    CBLDart_FLDictIterator_Delete(iterator);
   }
 
   return false;
 }
 
+uint32_t CBLDart_FLDictIterator_NextBatch(CBLDart_FLDictIterator *iterator,
+                                          CBLDart_LoadedDictKey *keysOut,
+                                          CBLDart_LoadedFLValue *valuesOut,
+                                          uint32_t capacity) {
+  auto dictIterator = &iterator->_iterator;
+  uint32_t count = 0;
+  while (count < capacity) {
+    auto value = FLDictIterator_GetValue(dictIterator);
+    if (!value) {
+      iterator->_isDone = true;
+      break;
+    }
+
+    if (keysOut) {
+      CBLDart_GetLoadedDictKey(iterator->_knownSharedKeys, dictIterator,
+                               &keysOut[count]);
+    }
+
+    if (valuesOut) {
+      if (iterator->_preLoad) {
+        CBLDart_GetLoadedFLValue(value, &valuesOut[count]);
+      } else {
+        valuesOut[count].value = value;
+      }
+    }
+
+    FLDictIterator_Next(dictIterator);
+    count++;
+  }
+
+  if (count == 0 && iterator->_deleteOnDone) {
+    CBLDart_FLDictIterator_Delete(iterator);
+  }
+
+  return count;
+}
+
 struct CBLDart_FLArrayIterator {
   CBLDart_LoadedFLValue *_valueOut;
   FLArrayIterator _iterator;
@@ -205,7 +354,8 @@ struct CBLDart_FLArrayIterator {
 
 CBLDart_FLArrayIterator *CBLDart_FLArrayIterator_Begin(
     FLArray array, CBLDart_LoadedFLValue *valueOut, bool deleteOnDone) {
-  auto iterator = new CBLDart_FLArrayIterator{};
+  auto iterator =
+      CBLDart_IteratorPool<CBLDart_FLArrayIterator>::instance().acquire();
   iterator->_valueOut = valueOut;
   iterator->_deleteOnDone = deleteOnDone;
 
@@ -215,7 +365,7 @@ CBLDart_FLArrayIterator *CBLDart_FLArrayIterator_Begin(
 }
 
 void CBLDart_FLArrayIterator_Delete(CBLDart_FLArrayIterator *iterator) {
-  delete iterator;
+  CBLDart_IteratorPool<CBLDart_FLArrayIterator>::instance().release(iterator);
 }
 
 bool CBLDart_FLArrayIterator_Next(CBLDart_FLArrayIterator *iterator) {
@@ -231,15 +381,473 @@ bool CBLDart_FLArrayIterator_Next(CBLDart_FLArrayIterator *iterator) {
   }
 
   if (iterator->_deleteOnDone) {
-    delete iterator;
+    CBLDart_FLArrayIterator_Delete(iterator);
   }
 
   return false;
 }
 
+uint32_t CBLDart_FLArrayIterator_NextBatch(CBLDart_FLArrayIterator *iterator,
+                                           CBLDart_LoadedFLValue *valuesOut,
+                                           uint32_t capacity) {
+  auto arrayIterator = &iterator->_iterator;
+  uint32_t count = 0;
+  while (count < capacity) {
+    auto value = FLArrayIterator_GetValue(arrayIterator);
+    if (!value) {
+      break;
+    }
+    CBLDart_GetLoadedFLValue(value, &valuesOut[count++]);
+    FLArrayIterator_Next(arrayIterator);
+  }
+
+  if (count == 0 && iterator->_deleteOnDone) {
+    CBLDart_FLArrayIterator_Delete(iterator);
+  }
+
+  return count;
+}
+
+// === Tape ===================================================================
+
+// The maximum size in bytes of strings which are interned.
+static const size_t kMaxInternedStringSize = 64;
+
+// The maximum number of strings which are interned by a single interner.
+static const size_t kMaxInternedStrings = 1 << 14;
+
+struct CBLDart_FLStringInterner {
+  // The `std::deque` keeps the strings at stable addresses, so that the keys
+  // of `ids` stay valid.
+  std::deque<std::string> strings;
+  std::unordered_map<std::string_view, int32_t> ids;
+
+  /**
+   * Returns the id of `string` or -1 if the string cannot be interned.
+   */
+  int32_t intern(FLString string) {
+    if (string.size > kMaxInternedStringSize) {
+      return -1;
+    }
+
+    std::string_view view(static_cast<const char *>(string.buf), string.size);
+    auto it = ids.find(view);
+    if (it != ids.end()) {
+      return it->second;
+    }
+
+    if (strings.size() == kMaxInternedStrings) {
+      return -1;
+    }
+
+    auto id = static_cast<int32_t>(strings.size());
+    strings.emplace_back(view);
+    ids.emplace(strings.back(), id);
+    return id;
+  }
+};
+
+CBLDart_FLStringInterner *CBLDart_FLStringInterner_New() {
+  return new CBLDart_FLStringInterner;
+}
+
+void CBLDart_FLStringInterner_Delete(CBLDart_FLStringInterner *interner) {
+  delete interner;
+}
+
+CBLDart_FLTape *CBLDart_FLTape_New() { return new CBLDart_FLTape{}; }
+
+void CBLDart_FLTape_Delete(CBLDart_FLTape *tape) {
+  std::free(tape->entries);
+  delete tape;
+}
+
+static CBLDart_FLTapeEntry *CBLDart_FLTape_AppendEntry(CBLDart_FLTape *tape) {
+  if (tape->count == tape->capacity) {
+    auto capacity = tape->capacity == 0 ? 64 : tape->capacity * 2;
+    auto entries = static_cast<CBLDart_FLTapeEntry *>(
+        std::realloc(tape->entries, capacity * sizeof(CBLDart_FLTapeEntry)));
+    if (!entries) {
+      throw std::bad_alloc();
+    }
+    tape->entries = entries;
+    tape->capacity = capacity;
+  }
+
+  auto entry = &tape->entries[tape->count++];
+  *entry = {};
+  return entry;
+}
+
+static void CBLDart_FLTape_AppendDictKey(CBLDart_FLTape *tape,
+                                         KnownSharedKeys *knownSharedKeys,
+                                         FLDictIterator *iterator) {
+  auto entry = CBLDart_FLTape_AppendEntry(tape);
+  entry->type = kCBLDart_FLTapeEntryTypeDictKey;
+  entry->sharedKey = -1;
+
+  auto key = FLDictIterator_GetKey(iterator);
+
+  FLString string;
+  if (knownSharedKeys && FLValue_IsInteger(key)) {
+    auto sharedKey = entry->sharedKey = static_cast<int>(FLValue_AsInt(key));
+    if (!knownSharedKeys->makeKeyKnown(sharedKey)) {
+      entry->flag = true;
+      return;
+    }
+    string = FLDictIterator_GetKeyString(iterator);
+  } else if (knownSharedKeys) {
+    string = FLValue_AsString(key);
+  } else {
+    string = FLDictIterator_GetKeyString(iterator);
+  }
+
+  entry->buf = string.buf;
+  entry->size = static_cast<uint32_t>(string.size);
+  entry->isAscii = CBLDart_IsAscii(string.buf, string.size);
+}
+
+static void CBLDart_FLTape_AppendValue(CBLDart_FLTape *tape, FLValue value,
+                                       KnownSharedKeys *knownSharedKeys,
+                                       CBLDart_FLStringInterner *interner) {
+  auto entry = CBLDart_FLTape_AppendEntry(tape);
+  auto type = FLValue_GetType(value);
+  entry->type = type;
+
+  switch (type) {
+    case kFLUndefined:
+    case kFLNull:
+      break;
+    case kFLBoolean: {
+      entry->flag = FLValue_AsBool(value);
+      break;
+    }
+    case kFLNumber: {
+      auto isInteger = entry->flag = FLValue_IsInteger(value);
+      if (isInteger) {
+        entry->asInt = FLValue_AsInt(value);
+      } else {
+        entry->asDouble = FLValue_AsDouble(value);
+      }
+      break;
+    }
+    case kFLString: {
+      auto string = FLValue_AsString(value);
+      entry->buf = string.buf;
+      entry->size = static_cast<uint32_t>(string.size);
+      entry->isAscii = CBLDart_IsAscii(string.buf, string.size);
+      entry->sharedKey = interner ? interner->intern(string) : -1;
+      break;
+    }
+    case kFLData: {
+      auto data = FLValue_AsData(value);
+      entry->buf = data.buf;
+      entry->size = static_cast<uint32_t>(data.size);
+      break;
+    }
+    case kFLArray: {
+      auto array = FLValue_AsArray(value);
+      entry->size = FLArray_Count(array);
+
+      // `entry` must not be used after this point, since appending children
+      // can reallocate the entries.
+      FLArrayIterator iterator;
+      FLArrayIterator_Begin(array, &iterator);
+      while (auto child = FLArrayIterator_GetValue(&iterator)) {
+        CBLDart_FLTape_AppendValue(tape, child, knownSharedKeys, interner);
+        FLArrayIterator_Next(&iterator);
+      }
+      break;
+    }
+    case kFLDict: {
+      auto dict = FLValue_AsDict(value);
+      entry->size = FLDict_Count(dict);
+
+      // `entry` must not be used after this point, since appending children
+      // can reallocate the entries.
+      FLDictIterator iterator;
+      FLDictIterator_Begin(dict, &iterator);
+      while (auto child = FLDictIterator_GetValue(&iterator)) {
+        CBLDart_FLTape_AppendDictKey(tape, knownSharedKeys, &iterator);
+        CBLDart_FLTape_AppendValue(tape, child, knownSharedKeys, interner);
+        FLDictIterator_Next(&iterator);
+      }
+      break;
+    }
+  }
+}
+
+bool CBLDart_FLTape_WriteValue(CBLDart_FLTape *tape, FLValue value,
+                               KnownSharedKeys *knownSharedKeys,
+                               CBLDart_FLStringInterner *interner,
+                               FLError *errorOut) {
+  tape->count = 0;
+  try {
+    CBLDart_FLTape_AppendValue(tape, value, knownSharedKeys, interner);
+  } catch (const std::bad_alloc &) {
+    // The exception must not escape into Dart.
+    *errorOut = kFLMemoryError;
+    return false;
+  }
+  return true;
+}
+
+// === DictProjection =========================================================
+
+struct CBLDart_FLDictProjection {
+  ~CBLDart_FLDictProjection() {
+    for (auto keyPath : keyPaths) {
+      FLKeyPath_Free(keyPath);
+    }
+  }
+
+  std::vector<FLKeyPath> keyPaths;
+};
+
+CBLDart_FLDictProjection *CBLDart_FLDictProjection_New(const FLString *keyPaths,
+                                                       uint32_t count,
+                                                       FLError *errorOut) {
+  auto projection = new CBLDart_FLDictProjection;
+  projection->keyPaths.reserve(count);
+
+  for (uint32_t i = 0; i < count; i++) {
+    auto keyPath = FLKeyPath_New(keyPaths[i], errorOut);
+    if (!keyPath) {
+      delete projection;
+      return nullptr;
+    }
+    projection->keyPaths.push_back(keyPath);
+  }
+
+  return projection;
+}
+
+void CBLDart_FLDictProjection_Delete(CBLDart_FLDictProjection *projection) {
+  delete projection;
+}
+
+void CBLDart_FLDictProjection_Eval(CBLDart_FLDictProjection *projection,
+                                   FLDict dict,
+                                   CBLDart_LoadedFLValue *valuesOut) {
+  auto root = reinterpret_cast<FLValue>(dict);
+  auto valueOut = valuesOut;
+  for (auto keyPath : projection->keyPaths) {
+    CBLDart_GetLoadedFLValue(FLKeyPath_Eval(keyPath, root), valueOut++);
+  }
+}
+
 // === Encoder ================================================================
 
-bool CBLDart_FLEncoder_WriteArrayValue(FLEncoder encoder, FLArray array,
-                                       uint32_t index) {
-  return FLEncoder_WriteValue(encoder, FLArray_Get(array, index));
+/**
+ * Returns the UTF-16 code unit at `index` of `units`, which are in native byte
+ * order and not necessarily aligned.
+ */
+static inline uint16_t CBLDart_ReadUTF16CodeUnit(const uint8_t *units,
+                                                 size_t index) {
+  uint16_t unit;
+  std::memcpy(&unit, units + index * 2, sizeof(unit));
+  return unit;
+}
+
+/**
+ * Transcodes `count` UTF-16 code units at `units`, which are in native byte
+ * order and not necessarily aligned, to UTF-8 in `buffer`.
+ *
+ * Like the UTF-8 encoder of Dart, unpaired surrogates are replaced with
+ * U+FFFD.
+ */
+static FLSlice CBLDart_TranscodeUTF16ToUTF8(const uint8_t *units, size_t count,
+                                            std::string &buffer) {
+  // A code unit takes at most 3 bytes and a surrogate pair 4 bytes.
+  buffer.resize(count * 3);
+  auto start = reinterpret_cast<uint8_t *>(buffer.data());
+  auto out = start;
+  size_t i = 0;
+
+  while (i < count) {
+    // Runs of ASCII characters are narrowed 8 code units at a time.
+#if defined(__SSE2__)
+    for (; i + 8 <= count; i += 8) {
+      auto chunk =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(units + i * 2));
+      auto nonAscii = _mm_and_si128(chunk, _mm_set1_epi16(-0x80));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii, _mm_setzero_si128())) !=
+          0xFFFF) {
+        break;
+      }
+      _mm_storel_epi64(reinterpret_cast<__m128i *>(out),
+                       _mm_packus_epi16(chunk, chunk));
+      out += 8;
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 8 <= count; i += 8) {
+      auto chunk = vreinterpretq_u16_u8(vld1q_u8(units + i * 2));
+      if (vmaxvq_u16(chunk) >= 0x80) {
+        break;
+      }
+      vst1_u8(out, vmovn_u16(chunk));
+      out += 8;
+    }
+#endif
+
+    // Encode at least one code unit without SIMD, so that the loop makes
+    // progress when a chunk contains non-ASCII characters.
+    auto end = std::min(i + 8, count);
+    while (i < end) {
+      uint32_t codePoint = CBLDart_ReadUTF16CodeUnit(units, i++);
+      if (codePoint < 0x80) {
+        *out++ = static_cast<uint8_t>(codePoint);
+        continue;
+      }
+      if (codePoint < 0x800) {
+        *out++ = static_cast<uint8_t>(0xC0 | (codePoint >> 6));
+        *out++ = static_cast<uint8_t>(0x80 | (codePoint & 0x3F));
+        continue;
+      }
+      if ((codePoint & 0xF800) == 0xD800) {
+        uint16_t tail = i < count ? CBLDart_ReadUTF16CodeUnit(units, i) : 0;
+        if ((codePoint & 0xFC00) == 0xD800 && (tail & 0xFC00) == 0xDC00) {
+          i++;
+          codePoint =
+              0x10000 + (((codePoint & 0x3FF) << 10) | (tail & 0x3FF));
+          *out++ = static_cast<uint8_t>(0xF0 | (codePoint >> 18));
+          *out++ = static_cast<uint8_t>(0x80 | ((codePoint >> 12) & 0x3F));
+          *out++ = static_cast<uint8_t>(0x80 | ((codePoint >> 6) & 0x3F));
+          *out++ = static_cast<uint8_t>(0x80 | (codePoint & 0x3F));
+          continue;
+        }
+        // Unpaired surrogate.
+        codePoint = 0xFFFD;
+      }
+      *out++ = static_cast<uint8_t>(0xE0 | (codePoint >> 12));
+      *out++ = static_cast<uint8_t>(0x80 | ((codePoint >> 6) & 0x3F));
+      *out++ = static_cast<uint8_t>(0x80 | (codePoint & 0x3F));
+    }
+  }
+
+  return {start, static_cast<size_t>(out - start)};
+}
+
+template <typename T>
+static T CBLDart_FLEncoderTape_Read(const uint8_t *&cursor) {
+  T value;
+  memcpy(&value, cursor, sizeof(T));
+  cursor += sizeof(T);
+  return value;
+}
+
+static FLSlice CBLDart_FLEncoderTape_ReadBytes(const uint8_t *&cursor) {
+  auto size = CBLDart_FLEncoderTape_Read<uint32_t>(cursor);
+  FLSlice bytes = {cursor, size};
+  cursor += size;
+  return bytes;
+}
+
+bool CBLDart_FLEncoder_WriteTape(FLEncoder encoder, const uint8_t *tape,
+                                 size_t size) {
+  auto cursor = tape;
+  auto end = tape + size;
+
+  // Reused for transcoding UTF-16 strings, so that large strings don't
+  // require an allocation each.
+  static thread_local std::string utf8Buffer;
+
+  while (cursor < end) {
+    auto op = static_cast<CBLDart_FLEncoderTapeOp>(*cursor++);
+
+    bool ok;
+    switch (op) {
+      case CBLDart_FLEncoderTapeOp_WriteNull:
+        ok = FLEncoder_WriteNull(encoder);
+        break;
+      case CBLDart_FLEncoderTapeOp_WriteFalse:
+        ok = FLEncoder_WriteBool(encoder, false);
+        break;
+      case CBLDart_FLEncoderTapeOp_WriteTrue:
+        ok = FLEncoder_WriteBool(encoder, true);
+        break;
+      case CBLDart_FLEncoderTapeOp_WriteInt:
+        ok = FLEncoder_WriteInt(encoder,
+                                CBLDart_FLEncoderTape_Read<int64_t>(cursor));
+        break;
+      case CBLDart_FLEncoderTapeOp_WriteDouble:
+        ok = FLEncoder_WriteDouble(encoder,
+                                   CBLDart_FLEncoderTape_Read<double>(cursor));
+        break;
+      case CBLDart_FLEncoderTapeOp_WriteString:
+        ok = FLEncoder_WriteString(encoder,
+                                   CBLDart_FLEncoderTape_ReadBytes(cursor));
+        break;
+      case CBLDart_FLEncoderTapeOp_WriteData:
+        ok = FLEncoder_WriteData(encoder,
+                                 CBLDart_FLEncoderTape_ReadBytes(cursor));
+        break;
+      case CBLDart_FLEncoderTapeOp_WriteValue:
+        ok = FLEncoder_WriteValue(encoder,
+                                  CBLDart_FLEncoderTape_Read<FLValue>(cursor));
+        break;
+      case CBLDart_FLEncoderTapeOp_WriteArrayValue: {
+        auto array = CBLDart_FLEncoderTape_Read<FLArray>(cursor);
+        auto index = CBLDart_FLEncoderTape_Read<uint32_t>(cursor);
+        ok = FLEncoder_WriteValue(encoder, FLArray_Get(array, index));
+        break;
+      }
+      case CBLDart_FLEncoderTapeOp_BeginArray:
+        ok = FLEncoder_BeginArray(encoder,
+                                  CBLDart_FLEncoderTape_Read<uint32_t>(cursor));
+        break;
+      case CBLDart_FLEncoderTapeOp_EndArray:
+        ok = FLEncoder_EndArray(encoder);
+        break;
+      case CBLDart_FLEncoderTapeOp_BeginDict:
+        ok = FLEncoder_BeginDict(encoder,
+                                 CBLDart_FLEncoderTape_Read<uint32_t>(cursor));
+        break;
+      case CBLDart_FLEncoderTapeOp_WriteKey:
+        ok = FLEncoder_WriteKey(encoder,
+                                CBLDart_FLEncoderTape_ReadBytes(cursor));
+        break;
+      case CBLDart_FLEncoderTapeOp_WriteKeyValue:
+        ok = FLEncoder_WriteKeyValue(
+            encoder, CBLDart_FLEncoderTape_Read<FLValue>(cursor));
+        break;
+      case CBLDart_FLEncoderTapeOp_EndDict:
+        ok = FLEncoder_EndDict(encoder);
+        break;
+      case CBLDart_FLEncoderTapeOp_WriteUTF16String: {
+        auto count = CBLDart_FLEncoderTape_Read<uint32_t>(cursor);
+        ok = FLEncoder_WriteString(
+            encoder, CBLDart_TranscodeUTF16ToUTF8(cursor, count, utf8Buffer));
+        cursor += static_cast<size_t>(count) * 2;
+        break;
+      }
+      default:
+        assert(false);
+        return false;
+    }
+
+    if (!ok) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// === JSONBuffer =============================================================
+
+CBLDart_FLJSONBuffer *CBLDart_FLJSONBuffer_New() {
+  auto buffer = new CBLDart_FLJSONBuffer{};
+  buffer->encoder = FLEncoder_NewWithOptions(kFLEncodeJSON, 0, false);
+  return buffer;
+}
+
+void CBLDart_FLJSONBuffer_Delete(CBLDart_FLJSONBuffer *buffer) {
+  FLEncoder_Free(buffer->encoder);
+  std::free(buffer->buf);
+  delete buffer;
+}
+
+void CBLDart_FLJSONBuffer_Clear(CBLDart_FLJSONBuffer *buffer) {
+  buffer->size = 0;
 }
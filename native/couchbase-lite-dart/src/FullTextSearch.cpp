@@ -0,0 +1,280 @@
+#include "FullTextSearch.h"
+
+#include <algorithm>
+#include <optional>
+
+#include "QueryCache.h"
+#include "Utils.h"
+
+namespace CBLDart {
+
+// === FullTextSnippetBuilder =================================================
+
+/** Whether `c` is part of a word. Non-ASCII bytes are always part of words. */
+static bool isWordByte(char c) {
+  auto byte = static_cast<unsigned char>(c);
+  return byte >= 0x80 || (byte >= '0' && byte <= '9') ||
+         ((byte | 0x20) >= 'a' && (byte | 0x20) <= 'z');
+}
+
+static char toLowerAscii(char c) {
+  return c >= 'A' && c <= 'Z' ? static_cast<char>(c | 0x20) : c;
+}
+
+FullTextSnippetBuilder::FullTextSnippetBuilder(std::string_view query,
+                                               size_t wordCount,
+                                               std::string_view matchStart,
+                                               std::string_view matchEnd,
+                                               std::string_view ellipsis)
+    : wordCount_(wordCount),
+      matchStart_(matchStart),
+      matchEnd_(matchEnd),
+      ellipsis_(ellipsis) {
+  // Operators, column filters, NEAR distances and excluded terms of the
+  // query are not terms which can be matched in a snippet.
+  auto isExcluded = false;
+  for (auto &word : splitWords(query)) {
+    auto text = query.substr(word.begin, word.end - word.begin);
+    auto next = word.end < query.size() ? query[word.end] : '\0';
+    auto previous = word.begin > 0 ? query[word.begin - 1] : '\0';
+
+    if (text == "AND" || text == "OR" || text == "NEAR") {
+      continue;
+    }
+    if (text == "NOT") {
+      isExcluded = true;
+      continue;
+    }
+    if (next == ':' || previous == '/') {
+      continue;
+    }
+    auto isNegated = previous == '-' &&
+                     (word.begin == 1 || query[word.begin - 2] == ' ');
+    if (isExcluded || isNegated) {
+      isExcluded = false;
+      continue;
+    }
+
+    std::string term(text);
+    std::transform(term.begin(), term.end(), term.begin(), toLowerAscii);
+    if (std::find(terms_.begin(), terms_.end(), term) == terms_.end()) {
+      terms_.push_back(std::move(term));
+    }
+  }
+}
+
+std::vector<FullTextSnippetBuilder::Word> FullTextSnippetBuilder::splitWords(
+    std::string_view text) const {
+  std::vector<Word> words;
+  size_t position = 0;
+  while (position < text.size()) {
+    while (position < text.size() && !isWordByte(text[position])) {
+      position++;
+    }
+    auto begin = position;
+    while (position < text.size() && isWordByte(text[position])) {
+      position++;
+    }
+    if (position > begin) {
+      auto term =
+          terms_.empty() ? -1 : matchTerm(text.substr(begin, position - begin));
+      words.push_back({begin, position, term});
+    }
+  }
+  return words;
+}
+
+int FullTextSnippetBuilder::matchTerm(std::string_view word) const {
+  for (size_t i = 0; i < terms_.size(); i++) {
+    auto &term = terms_[i];
+    auto maxPrefix = std::min(term.size(), word.size());
+    size_t prefix = 0;
+    while (prefix < maxPrefix && toLowerAscii(word[prefix]) == term[prefix]) {
+      prefix++;
+    }
+
+    if (prefix == term.size() ||
+        (prefix >= 3 && term.size() - prefix <= 3 &&
+         word.size() - prefix <= 3)) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+std::string FullTextSnippetBuilder::build(std::string_view text) const {
+  auto words = splitWords(text);
+  auto windowSize = std::min(wordCount_, words.size());
+  if (windowSize == 0) {
+    return {};
+  }
+
+  // The window is slid over the words, while counting the matched words of
+  // each term in the window.
+  std::vector<size_t> termCounts(terms_.size());
+  size_t distinctTerms = 0;
+  size_t matchedWords = 0;
+  auto addWord = [&](const Word &word) {
+    if (word.term >= 0) {
+      matchedWords++;
+      distinctTerms += termCounts[word.term]++ == 0;
+    }
+  };
+  auto removeWord = [&](const Word &word) {
+    if (word.term >= 0) {
+      matchedWords--;
+      distinctTerms -= --termCounts[word.term] == 0;
+    }
+  };
+
+  for (size_t i = 0; i < windowSize; i++) {
+    addWord(words[i]);
+  }
+
+  size_t bestStart = 0;
+  auto bestDistinctTerms = distinctTerms;
+  auto bestMatchedWords = matchedWords;
+  for (size_t start = 1; start + windowSize <= words.size(); start++) {
+    removeWord(words[start - 1]);
+    addWord(words[start + windowSize - 1]);
+
+    if (distinctTerms > bestDistinctTerms ||
+        (distinctTerms == bestDistinctTerms &&
+         matchedWords > bestMatchedWords)) {
+      bestStart = start;
+      bestDistinctTerms = distinctTerms;
+      bestMatchedWords = matchedWords;
+    }
+  }
+
+  auto end = bestStart + windowSize;
+  std::string snippet;
+  if (bestStart > 0) {
+    snippet += ellipsis_;
+  }
+  auto position = words[bestStart].begin;
+  for (auto i = bestStart; i < end; i++) {
+    auto &word = words[i];
+    snippet += text.substr(position, word.begin - position);
+    auto wordText = text.substr(word.begin, word.end - word.begin);
+    if (word.term >= 0) {
+      snippet += matchStart_;
+      snippet += wordText;
+      snippet += matchEnd_;
+    } else {
+      snippet += wordText;
+    }
+    position = word.end;
+  }
+  if (end < words.size()) {
+    snippet += ellipsis_;
+  }
+  return snippet;
+}
+
+// === FullTextSearch =========================================================
+
+static std::string_view toStringView(FLString string) {
+  return {static_cast<const char *>(string.buf), string.size};
+}
+
+/**
+ * Returns the JSON query for a page of the documents of `collection` which
+ * match the full-text query in the `query` parameter, ordered by descending
+ * rank. Documents with the same rank are ordered by their IDs, so that pages
+ * do not overlap.
+ */
+static std::string fullTextSearchQuery(
+    const CBLCollection *collection,
+    const CBLDart_FullTextSearchOptions &options) {
+  auto scope = CBLCollection_Scope(collection);
+  auto fullName = CBLDart_FLStringToString(CBLScope_Name(scope)) + "." +
+                  CBLDart_FLStringToString(CBLCollection_Name(collection));
+  CBLScope_Release(scope);
+
+  auto indexName = CBLDart_JSONString(toStringView(options.indexName));
+  auto rank = "[\"RANK()\"," + indexName + "]";
+
+  auto what = "[\"._id\"]," + rank;
+  if (options.snippetProperty.buf) {
+    what += ",[" +
+            CBLDart_JSONString(
+                "." + CBLDart_FLStringToString(options.snippetProperty)) +
+            "]";
+  }
+
+  return "{\"WHAT\":[" + what + "],\"FROM\":[{\"COLLECTION\":" +
+         CBLDart_JSONString(fullName) + "}],\"WHERE\":[\"MATCH()\"," +
+         indexName + ",[\"$query\"]],\"ORDER_BY\":[[\"DESC\"," + rank +
+         "],[\"._id\"]],\"LIMIT\":[\"$limit\"],\"OFFSET\":[\"$offset\"]}";
+}
+
+FLSliceResult fullTextSearch(const CBLCollection *collection,
+                             const CBLDart_FullTextSearchOptions &options,
+                             CBLError *errorOut) {
+  auto queryString = fullTextSearchQuery(collection, options);
+
+  auto &queryCache = QueryCache::instance();
+  auto query = queryCache.acquire(
+      CBLCollection_Database(collection), kCBLJSONLanguage,
+      {queryString.data(), queryString.size()}, nullptr, errorOut);
+  if (!query) {
+    return {};
+  }
+
+  auto parameters = FLMutableDict_New();
+  FLMutableDict_SetString(parameters, FLSTR("query"), options.query);
+  FLMutableDict_SetUInt(parameters, FLSTR("limit"), options.limit);
+  FLMutableDict_SetUInt(parameters, FLSTR("offset"), options.offset);
+  CBLQuery_SetParameters(query, parameters);
+  FLMutableDict_Release(parameters);
+
+  auto resultSet = CBLQuery_Execute(query, errorOut);
+  if (!resultSet) {
+    queryCache.release(query);
+    return {};
+  }
+
+  std::optional<FullTextSnippetBuilder> snippetBuilder;
+  if (options.snippetProperty.buf) {
+    snippetBuilder.emplace(toStringView(options.query),
+                           options.snippetWordCount,
+                           toStringView(options.matchStart),
+                           toStringView(options.matchEnd),
+                           toStringView(options.ellipsis));
+  }
+
+  auto encoder = FLEncoder_New();
+  FLEncoder_BeginArray(encoder, options.limit);
+  while (CBLResultSet_Next(resultSet)) {
+    FLEncoder_BeginArray(encoder, snippetBuilder ? 3 : 2);
+    FLEncoder_WriteValue(encoder, CBLResultSet_ValueAtIndex(resultSet, 0));
+    FLEncoder_WriteValue(encoder, CBLResultSet_ValueAtIndex(resultSet, 1));
+    if (snippetBuilder) {
+      auto text = CBLResultSet_ValueAtIndex(resultSet, 2);
+      if (FLValue_GetType(text) == kFLString) {
+        auto snippet =
+            snippetBuilder->build(toStringView(FLValue_AsString(text)));
+        FLEncoder_WriteString(encoder, {snippet.data(), snippet.size()});
+      } else {
+        FLEncoder_WriteNull(encoder);
+      }
+    }
+    FLEncoder_EndArray(encoder);
+  }
+  FLEncoder_EndArray(encoder);
+  CBLResultSet_Release(resultSet);
+  queryCache.release(query);
+
+  FLError flError;
+  auto result = FLEncoder_Finish(encoder, &flError);
+  FLEncoder_Free(encoder);
+  if (!result.buf) {
+    *errorOut = {kCBLFleeceDomain, static_cast<int>(flError), 0};
+    return {};
+  }
+
+  return result;
+}
+
+}  // namespace CBLDart
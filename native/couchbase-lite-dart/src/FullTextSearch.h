@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CBL+Dart.h"
+
+namespace CBLDart {
+
+// === FullTextSnippetBuilder =================================================
+
+/**
+ * Makes snippets of texts which matched a full-text query, natively, so that
+ * the texts do not have to be decoded in Dart.
+ *
+ * Snippets are made from the stored texts, not from the full-text index, so
+ * matching words is approximate: Words are split at ASCII characters other
+ * than letters and digits, and compared without regard to ASCII case. A word
+ * matches a term of the query if the term is a prefix of the word, or if
+ * both share a prefix of at least three bytes which leaves at most three
+ * bytes of each, to approximate stemming.
+ */
+class FullTextSnippetBuilder {
+ public:
+  FullTextSnippetBuilder(std::string_view query, size_t wordCount,
+                         std::string_view matchStart,
+                         std::string_view matchEnd,
+                         std::string_view ellipsis);
+
+  /**
+   * Returns the window of at most `wordCount` words of `text`, which contains
+   * the most distinct terms of the query and, of those, the most matched
+   * words. The earliest of equal windows is chosen.
+   */
+  std::string build(std::string_view text) const;
+
+ private:
+  struct Word {
+    size_t begin;
+    size_t end;
+    /** The index of the matched term, or `-1`. */
+    int term;
+  };
+
+  std::vector<Word> splitWords(std::string_view text) const;
+  int matchTerm(std::string_view word) const;
+
+  std::vector<std::string> terms_;
+  size_t wordCount_;
+  std::string matchStart_;
+  std::string matchEnd_;
+  std::string ellipsis_;
+};
+
+// === FullTextSearch =========================================================
+
+/**
+ * Implements `CBLDart_CBLCollection_FullTextSearch`.
+ */
+FLSliceResult fullTextSearch(const CBLCollection *collection,
+                             const CBLDart_FullTextSearchOptions &options,
+                             CBLError *errorOut);
+
+}  // namespace CBLDart
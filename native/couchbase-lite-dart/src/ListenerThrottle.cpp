@@ -0,0 +1,85 @@
+#include "ListenerThrottle.h"
+
+#include "DebounceTimer.h"
+#include "Utils.h"
+
+namespace CBLDart {
+
+// === ListenerThrottle =======================================================
+
+void ListenerThrottle::notify() {
+  std::scoped_lock lock(mutex_);
+  if (stopped_) {
+    return;
+  }
+
+  pending_ = true;
+  flush();
+}
+
+void ListenerThrottle::notifyNow() {
+  std::scoped_lock lock(mutex_);
+  if (stopped_) {
+    return;
+  }
+
+  pending_ = true;
+  if (!paused_) {
+    deliver();
+  }
+}
+
+void ListenerThrottle::setPaused(bool paused) {
+  std::scoped_lock lock(mutex_);
+  paused_ = paused;
+  if (!paused_ && !stopped_) {
+    flush();
+  }
+}
+
+void ListenerThrottle::stop() {
+  std::scoped_lock lock(mutex_);
+  stopped_ = true;
+}
+
+void ListenerThrottle::flush() {
+  if (!pending_ || paused_ || scheduled_) {
+    return;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  auto nextDelivery = lastDelivery_ + minInterval_;
+  if (now >= nextDelivery) {
+    deliver();
+    return;
+  }
+
+  scheduled_ = true;
+  DebounceTimer::instance().schedule(
+      nextDelivery,
+      [self = shared_from_this()]() { self->intervalEnded(); });
+}
+
+void ListenerThrottle::intervalEnded() {
+  std::scoped_lock lock(mutex_);
+  scheduled_ = false;
+  if (!stopped_) {
+    flush();
+  }
+}
+
+void ListenerThrottle::deliver() {
+  pending_ = false;
+  lastDelivery_ = std::chrono::steady_clock::now();
+
+  if (deliver_) {
+    deliver_();
+    return;
+  }
+
+  Dart_CObject args{};
+  CBLDart_CObject_SetEmptyArray(&args);
+  AsyncCallbackCall(*callback_).execute(args);
+}
+
+}  // namespace CBLDart
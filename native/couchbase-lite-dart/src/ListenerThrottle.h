@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "AsyncCallback.h"
+
+namespace CBLDart {
+
+// === ListenerThrottle =======================================================
+
+/**
+ * Throttles the notifications of a listener callback, which take no
+ * arguments, so that the callback is notified at most once per minimum
+ * interval.
+ *
+ * A notification which arrives within the minimum interval after the last
+ * delivered notification is delivered at the end of the interval, coalesced
+ * with all other notifications which arrive until then. Intermediate
+ * notifications are dropped before they are sent to the isolate of the
+ * callback.
+ *
+ * While the throttle is paused, notifications are not delivered. If a
+ * notification arrived while the throttle was paused, a single notification
+ * is delivered when it is resumed.
+ *
+ * Instead of notifying the callback with no arguments, a throttle can call a
+ * `deliver` function, which sends the latest state to the callback.
+ */
+class ListenerThrottle : public std::enable_shared_from_this<ListenerThrottle> {
+ public:
+  ListenerThrottle(AsyncCallback *callback,
+                   std::chrono::milliseconds minInterval)
+      : callback_(callback), minInterval_(minInterval) {}
+
+  ListenerThrottle(std::chrono::milliseconds minInterval,
+                   std::function<void()> deliver)
+      : callback_(nullptr),
+        minInterval_(minInterval),
+        deliver_(std::move(deliver)) {}
+
+  /** Notifies the callback, subject to the throttle. */
+  void notify();
+
+  /**
+   * Notifies the callback immediately, unless the throttle is paused, and
+   * coalesces it with a pending notification.
+   */
+  void notifyNow();
+
+  void setPaused(bool paused);
+
+  /** Stops the throttle, after which the callback is no longer used. */
+  void stop();
+
+ private:
+  /** Delivers or schedules a pending notification. Requires `mutex_`. */
+  void flush();
+
+  void intervalEnded();
+
+  void deliver();
+
+  std::mutex mutex_;
+  AsyncCallback *callback_;
+  std::chrono::milliseconds minInterval_;
+  std::function<void()> deliver_;
+  std::chrono::steady_clock::time_point lastDelivery_{};
+  bool pending_ = false;
+  bool scheduled_ = false;
+  bool paused_ = false;
+  bool stopped_ = false;
+};
+
+}  // namespace CBLDart
@@ -0,0 +1,88 @@
+#include "LogRingBuffer.h"
+
+namespace CBLDart {
+
+// === LogRingBuffer ==========================================================
+
+// The buffer is a bounded MPMC queue in the style of Dmitry Vyukov's, whose
+// cells carry a sequence number. A cell at position `p` is free for the
+// producer of position `p` if its sequence is `p` and holds the entry of
+// position `p` if its sequence is `p + 1`.
+
+static size_t roundUpToPowerOfTwo(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+LogRingBuffer::LogRingBuffer(size_t capacity)
+    : mask_(roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity) - 1),
+      cells_(new Cell[mask_ + 1]) {
+  for (size_t i = 0; i <= mask_; i++) {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+bool LogRingBuffer::push(CBLLogDomain domain, CBLLogLevel level,
+                         FLString message) {
+  auto position = enqueuePosition_.load(std::memory_order_relaxed);
+  Cell *cell;
+  while (true) {
+    cell = &cells_[position & mask_];
+    auto sequence = cell->sequence.load(std::memory_order_acquire);
+    auto difference =
+        static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+    if (difference == 0) {
+      if (enqueuePosition_.compare_exchange_weak(position, position + 1,
+                                                 std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      droppedCount_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      position = enqueuePosition_.load(std::memory_order_relaxed);
+    }
+  }
+
+  cell->entry.domain = domain;
+  cell->entry.level = level;
+  cell->entry.message.assign(static_cast<const char *>(message.buf),
+                             message.size);
+  cell->sequence.store(position + 1, std::memory_order_release);
+  return true;
+}
+
+size_t LogRingBuffer::peek(Entry **entries, size_t maxCount) {
+  auto position = dequeuePosition_.load(std::memory_order_relaxed);
+  size_t count = 0;
+  while (count < maxCount) {
+    auto &cell = cells_[(position + count) & mask_];
+    if (cell.sequence.load(std::memory_order_acquire) !=
+        position + count + 1) {
+      break;
+    }
+    entries[count++] = &cell.entry;
+  }
+  return count;
+}
+
+void LogRingBuffer::release(size_t count) {
+  auto position = dequeuePosition_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < count; i++) {
+    cells_[(position + i) & mask_].sequence.store(position + i + mask_ + 1,
+                                                  std::memory_order_release);
+  }
+  dequeuePosition_.store(position + count, std::memory_order_relaxed);
+}
+
+size_t LogRingBuffer::size() const {
+  auto enqueuePosition = enqueuePosition_.load(std::memory_order_relaxed);
+  auto dequeuePosition = dequeuePosition_.load(std::memory_order_relaxed);
+  return enqueuePosition > dequeuePosition ? enqueuePosition - dequeuePosition
+                                           : 0;
+}
+
+}  // namespace CBLDart
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "CBL+Dart.h"
+
+namespace CBLDart {
+
+// === LogRingBuffer ==========================================================
+
+/**
+ * A bounded, lock-free queue of log entries, which can be pushed from any
+ * number of threads and is drained by a single thread.
+ *
+ * When the buffer is full, new entries are dropped and counted instead of
+ * blocking the logging thread.
+ *
+ * The strings of the entries keep their capacity when an entry is drained, so
+ * that once the buffer has warmed up, pushing an entry does not allocate.
+ */
+class LogRingBuffer {
+ public:
+  struct Entry {
+    CBLLogDomain domain;
+    CBLLogLevel level;
+    std::string message;
+  };
+
+  /** `capacity` is rounded up to the next power of two. */
+  explicit LogRingBuffer(size_t capacity);
+
+  LogRingBuffer(const LogRingBuffer &) = delete;
+  LogRingBuffer &operator=(const LogRingBuffer &) = delete;
+
+  /**
+   * Pushes an entry into the buffer.
+   *
+   * Returns `false` if the buffer is full and the entry has been dropped.
+   */
+  bool push(CBLLogDomain domain, CBLLogLevel level, FLString message);
+
+  /**
+   * Peeks at up to `maxCount` of the oldest entries, which stay valid until
+   * they are released with `release`.
+   *
+   * Must only be called by the draining thread.
+   */
+  size_t peek(Entry **entries, size_t maxCount);
+
+  /** Releases the oldest `count` entries, which have been peeked at. */
+  void release(size_t count);
+
+  /** The approximate number of entries in the buffer. */
+  size_t size() const;
+
+  size_t capacity() const { return mask_ + 1; }
+
+  /** The number of entries which have been dropped so far. */
+  uint64_t droppedCount() const {
+    return droppedCount_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    Entry entry;
+  };
+
+  size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+  alignas(64) std::atomic<size_t> enqueuePosition_{0};
+  alignas(64) std::atomic<size_t> dequeuePosition_{0};
+  std::atomic<uint64_t> droppedCount_{0};
+};
+
+}  // namespace CBLDart
@@ -0,0 +1,262 @@
+#include "MaintenanceScheduler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+#include "DatabaseThreads.h"
+#include "Utils.h"
+
+namespace CBLDart {
+
+// === MaintenanceScheduler ===================================================
+
+/**
+ * Returns the combined size of the database file of `database` and its
+ * write-ahead log, which is where freed pages accumulate.
+ */
+static int64_t databaseFileSize(const CBLDatabase *database) {
+  auto directory = CBLDatabase_Path(database);
+  std::string path(static_cast<const char *>(directory.buf), directory.size);
+  FLSliceResult_Release(directory);
+  if (!path.empty() && path.back() != '/' && path.back() != '\\') {
+    path += '/';
+  }
+  path += "db.sqlite3";
+
+  int64_t size = 0;
+  for (auto suffix : {"", "-wal"}) {
+    std::ifstream file(path + suffix, std::ios::binary | std::ios::ate);
+    if (file) {
+      size += static_cast<int64_t>(file.tellg());
+    }
+  }
+  return size;
+}
+
+void MaintenanceScheduler::schedule(const CBLDatabase *database,
+                                    uint32_t types, uint64_t intervalMs,
+                                    uint64_t idleMs, AsyncCallback *callback) {
+  std::shared_ptr<MaintenanceScheduler> scheduler(
+      new MaintenanceScheduler(database, types, intervalMs, idleMs, callback));
+
+  // The callback owns a reference to the scheduler, which is released when
+  // the callback is closed.
+  callback->setFinalizer(new std::shared_ptr<MaintenanceScheduler>(scheduler),
+                         callbackFinalizer);
+
+  DatabaseThreads::instance().start(
+      database, [scheduler] { scheduler->run(); },
+      [scheduler] { scheduler->stop(); });
+}
+
+MaintenanceScheduler::MaintenanceScheduler(const CBLDatabase *database,
+                                           uint32_t types,
+                                           uint64_t intervalMs,
+                                           uint64_t idleMs,
+                                           AsyncCallback *callback)
+    : database_(CBLDatabase_Retain(const_cast<CBLDatabase *>(database))),
+      types_(types),
+      interval_(intervalMs),
+      idle_(idleMs),
+      callback_(callback) {}
+
+MaintenanceScheduler::~MaintenanceScheduler() {
+  CBLDatabase_Release(database_);
+}
+
+void MaintenanceScheduler::callbackFinalizer(void *context) {
+  auto scheduler =
+      reinterpret_cast<std::shared_ptr<MaintenanceScheduler> *>(context);
+  (*scheduler)->callbackClosed();
+  delete scheduler;
+}
+
+void MaintenanceScheduler::collectionChanged(
+    void *context, const CBLCollectionChange *change) {
+  auto self = reinterpret_cast<MaintenanceScheduler *>(context);
+  std::scoped_lock lock(self->mutex_);
+  self->lastChange_ = std::chrono::steady_clock::now();
+}
+
+void MaintenanceScheduler::stop() {
+  {
+    std::scoped_lock lock(mutex_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+}
+
+bool MaintenanceScheduler::isStopped() {
+  std::scoped_lock lock(mutex_);
+  return stopped_;
+}
+
+void MaintenanceScheduler::callbackClosed() {
+  {
+    std::scoped_lock lock(mutex_);
+    callbackClosed_ = true;
+    stopped_ = true;
+  }
+  cv_.notify_all();
+}
+
+void MaintenanceScheduler::run() {
+  addListeners();
+
+  std::unique_lock lock(mutex_);
+  auto nextRun = std::chrono::steady_clock::now() + interval_;
+  while (!stopped_) {
+    auto due = std::max(nextRun, lastChange_ + idle_);
+    if (std::chrono::steady_clock::now() < due) {
+      cv_.wait_until(lock, due);
+      continue;
+    }
+
+    lock.unlock();
+    runMaintenance();
+    lock.lock();
+    nextRun = std::chrono::steady_clock::now() + interval_;
+  }
+  lock.unlock();
+
+  removeListeners();
+}
+
+void MaintenanceScheduler::addListeners() {
+  CBLError error{};
+  auto scopeNames = CBLDatabase_ScopeNames(database_, &error);
+  if (!scopeNames) {
+    return;
+  }
+
+  for (uint32_t i = 0, count = FLArray_Count(scopeNames); i < count; i++) {
+    auto scopeName = FLValue_AsString(FLArray_Get(scopeNames, i));
+    auto collectionNames =
+        CBLDatabase_CollectionNames(database_, scopeName, &error);
+    if (!collectionNames) {
+      continue;
+    }
+
+    for (uint32_t j = 0, count = FLArray_Count(collectionNames); j < count;
+         j++) {
+      auto collectionName = FLValue_AsString(FLArray_Get(collectionNames, j));
+      auto collection =
+          CBLDatabase_Collection(database_, collectionName, scopeName, &error);
+      if (collection) {
+        listenerTokens_.push_back(CBLCollection_AddChangeListener(
+            collection, collectionChanged, this));
+        CBLCollection_Release(collection);
+      }
+    }
+    FLMutableArray_Release(collectionNames);
+  }
+  FLMutableArray_Release(scopeNames);
+}
+
+void MaintenanceScheduler::removeListeners() {
+  for (auto listenerToken : listenerTokens_) {
+    CBLListener_Remove(listenerToken);
+  }
+  listenerTokens_.clear();
+}
+
+void MaintenanceScheduler::runMaintenance() {
+  CBLError error{};
+  auto sizeBefore = databaseFileSize(database_);
+
+  for (uint32_t type = kCBLMaintenanceTypeCompact;
+       type <= kCBLMaintenanceTypeFullOptimize; type++) {
+    if (!(types_ & (1u << type))) {
+      continue;
+    }
+    if (isStopped()) {
+      break;
+    }
+
+    sendStepMessage(type);
+
+    if (!CBLDatabase_PerformMaintenance(
+            database_, static_cast<CBLMaintenanceType>(type), &error)) {
+      break;
+    }
+  }
+
+  auto sizeAfter = databaseFileSize(database_);
+
+  sendRunMessage(sizeBefore, sizeAfter, error);
+}
+
+void MaintenanceScheduler::sendStepMessage(uint32_t type) {
+  Dart_CObject isDone{};
+  isDone.type = Dart_CObject_kBool;
+  isDone.value.as_bool = false;
+
+  Dart_CObject type_{};
+  type_.type = Dart_CObject_kInt32;
+  type_.value.as_int32 = static_cast<int32_t>(type);
+
+  Dart_CObject *argsValues[] = {&isDone, &type_};
+
+  Dart_CObject args{};
+  args.type = Dart_CObject_kArray;
+  args.value.as_array.length = 2;
+  args.value.as_array.values = argsValues;
+
+  sendMessage(args);
+}
+
+void MaintenanceScheduler::sendRunMessage(int64_t sizeBefore,
+                                          int64_t sizeAfter, CBLError error) {
+  auto hasError = error.code != 0;
+
+  FLSliceResult errorMessage{};
+  if (hasError) {
+    errorMessage = CBLError_Message(&error);
+  }
+
+  Dart_CObject isDone{};
+  isDone.type = Dart_CObject_kBool;
+  isDone.value.as_bool = true;
+
+  Dart_CObject sizeBefore_{};
+  sizeBefore_.type = Dart_CObject_kInt64;
+  sizeBefore_.value.as_int64 = sizeBefore;
+
+  Dart_CObject sizeAfter_{};
+  sizeAfter_.type = Dart_CObject_kInt64;
+  sizeAfter_.value.as_int64 = sizeAfter;
+
+  Dart_CObject errorDomain{};
+  errorDomain.type = Dart_CObject_kInt32;
+  errorDomain.value.as_int32 = error.domain;
+
+  Dart_CObject errorCode{};
+  errorCode.type = Dart_CObject_kInt32;
+  errorCode.value.as_int32 = error.code;
+
+  Dart_CObject errorMessage_{};
+  CBLDart_CObject_SetFLString(&errorMessage_,
+                              static_cast<FLString>(errorMessage));
+
+  Dart_CObject *argsValues[] = {&isDone,      &sizeBefore_, &sizeAfter_,
+                                &errorDomain, &errorCode,   &errorMessage_};
+
+  Dart_CObject args{};
+  args.type = Dart_CObject_kArray;
+  args.value.as_array.length = hasError ? 6 : 3;
+  args.value.as_array.values = argsValues;
+
+  sendMessage(args);
+
+  FLSliceResult_Release(errorMessage);
+}
+
+void MaintenanceScheduler::sendMessage(Dart_CObject &args) {
+  std::scoped_lock lock(mutex_);
+  if (!callbackClosed_) {
+    AsyncCallbackCall(*callback_).execute(args);
+  }
+}
+
+}  // namespace CBLDart
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "AsyncCallback.h"
+#include "CBL+Dart.h"
+
+namespace CBLDart {
+
+// === MaintenanceScheduler ===================================================
+
+/**
+ * Runs the maintenance of a database periodically, on a background thread,
+ * when the database has been idle for a while.
+ *
+ * The thread observes the collections of the database through change
+ * listeners, to find out when the database is idle. The thread is one of the
+ * `DatabaseThreads` of the database, so that it does not hold the database
+ * lock while a type of maintenance, which can take a long time, is
+ * performed. When the database is closed, the scheduler stops after the type
+ * of maintenance which is being performed.
+ */
+class MaintenanceScheduler {
+ public:
+  /**
+   * Starts to run the maintenance `types` of `database` every `intervalMs`,
+   * once the database has been idle for `idleMs`, and reports each run to
+   * `callback`.
+   *
+   * The scheduler is stopped when `callback` is closed or the threads of
+   * `database` are purged.
+   */
+  static void schedule(const CBLDatabase *database, uint32_t types,
+                       uint64_t intervalMs, uint64_t idleMs,
+                       AsyncCallback *callback);
+
+  MaintenanceScheduler(const MaintenanceScheduler &) = delete;
+  MaintenanceScheduler &operator=(const MaintenanceScheduler &) = delete;
+
+  ~MaintenanceScheduler();
+
+ private:
+  MaintenanceScheduler(const CBLDatabase *database, uint32_t types,
+                       uint64_t intervalMs, uint64_t idleMs,
+                       AsyncCallback *callback);
+
+  static void callbackFinalizer(void *context);
+  static void collectionChanged(void *context,
+                                const CBLCollectionChange *change);
+
+  /** Makes the thread exit, without waiting for it. */
+  void stop();
+  bool isStopped();
+  /**
+   * Must be called when the callback has been closed, after which it must not
+   * be called anymore.
+   */
+  void callbackClosed();
+
+  void run();
+  void addListeners();
+  void removeListeners();
+  void runMaintenance();
+  void sendStepMessage(uint32_t type);
+  void sendRunMessage(int64_t sizeBefore, int64_t sizeAfter, CBLError error);
+  void sendMessage(Dart_CObject &args);
+
+  CBLDatabase *database_;
+  uint32_t types_;
+  std::chrono::milliseconds interval_;
+  std::chrono::milliseconds idle_;
+  AsyncCallback *callback_;
+  std::vector<CBLListenerToken *> listenerTokens_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::chrono::steady_clock::time_point lastChange_{};
+  bool stopped_ = false;
+  bool callbackClosed_ = false;
+};
+
+}  // namespace CBLDart
@@ -0,0 +1,70 @@
+#include "MessageArena.h"
+
+#include <algorithm>
+
+namespace CBLDart {
+
+// === MessageArena ===========================================================
+
+/** The size of the first chunk of an arena. */
+static constexpr size_t kMinChunkSize = 4 * 1024;
+
+/**
+ * The total size of chunks which an arena keeps once its outermost scope has
+ * been closed. Chunks beyond this size, which were needed for an unusually
+ * large message, are released.
+ */
+static constexpr size_t kMaxRetainedSize = 1024 * 1024;
+
+MessageArena &MessageArena::current() {
+  static thread_local MessageArena arena;
+  return arena;
+}
+
+void *MessageArena::allocate(size_t size, size_t alignment) {
+  while (true) {
+    if (chunk_ < chunks_.size()) {
+      auto &chunk = chunks_[chunk_];
+      auto address = reinterpret_cast<uintptr_t>(chunk.data.get()) + offset_;
+      auto padding = (alignment - address % alignment) % alignment;
+      if (offset_ + padding + size <= chunk.size) {
+        offset_ += padding + size;
+        return chunk.data.get() + offset_ - size;
+      }
+
+      if (chunk_ + 1 < chunks_.size() &&
+          chunks_[chunk_ + 1].size >= size + alignment) {
+        chunk_++;
+        offset_ = 0;
+        continue;
+      }
+    }
+
+    // Chunks after the current one are too small and are replaced by a chunk
+    // which is at least twice as large as the last one.
+    chunks_.resize(std::min(chunk_ + 1, chunks_.size()));
+    auto chunkSize = chunks_.empty() ? kMinChunkSize : chunks_.back().size * 2;
+    chunkSize = std::max(chunkSize, size + alignment);
+    chunks_.push_back({std::make_unique<uint8_t[]>(chunkSize), chunkSize});
+    chunk_ = chunks_.size() - 1;
+    offset_ = 0;
+  }
+}
+
+void MessageArena::rewind(Scope::Mark mark) {
+  chunk_ = mark.chunk;
+  offset_ = mark.offset;
+
+  if (chunk_ == 0 && offset_ == 0) {
+    size_t retainedSize = 0;
+    size_t retainedCount = 0;
+    while (retainedCount < chunks_.size() &&
+           retainedSize + chunks_[retainedCount].size <= kMaxRetainedSize) {
+      retainedSize += chunks_[retainedCount].size;
+      retainedCount++;
+    }
+    chunks_.resize(retainedCount);
+  }
+}
+
+}  // namespace CBLDart
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace CBLDart {
+
+// === MessageArena ===========================================================
+
+/**
+ * A thread-local bump allocator for the memory of the `Dart_CObject` graphs
+ * of messages, which only have to live until they have been posted.
+ *
+ * Memory is allocated from chunks, which are kept when the arena is reset,
+ * so that building messages does not allocate from the heap once the chunks
+ * are large enough for the messages of a thread.
+ *
+ * Allocations are scoped by a `Scope`, which rewinds the arena to where it
+ * was when the scope was created. Scopes can be nested, for example when a
+ * listener which builds a message is called while another message is built
+ * on the same thread.
+ */
+class MessageArena {
+ public:
+  /** Returns the arena of the current thread. */
+  static MessageArena &current();
+
+  MessageArena(const MessageArena &) = delete;
+  MessageArena &operator=(const MessageArena &) = delete;
+
+  /**
+   * Rewinds the arena to the position at which the scope was created, when
+   * it is destroyed.
+   */
+  class Scope {
+   public:
+    explicit Scope(MessageArena &arena = current())
+        : arena_(arena), mark_(arena.mark()) {}
+
+    ~Scope() { arena_.rewind(mark_); }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+    MessageArena &arena() { return arena_; }
+
+   private:
+    MessageArena &arena_;
+    struct Mark {
+      size_t chunk;
+      size_t offset;
+    } mark_;
+
+    friend class MessageArena;
+  };
+
+  /** Allocates `size` bytes, aligned to `alignment`. */
+  void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  /**
+   * Allocates an array of `count` value-initialized objects of type `T`,
+   * which must be trivially destructible, since their destructors are never
+   * run.
+   */
+  template <typename T>
+  T *allocateArray(size_t count) {
+    static_assert(std::is_trivially_destructible_v<T>);
+    auto memory = allocate(sizeof(T) * count, alignof(T));
+    return new (memory) T[count]();
+  }
+
+ private:
+  MessageArena() = default;
+
+  struct Chunk {
+    std::unique_ptr<uint8_t[]> data;
+    size_t size;
+  };
+
+  Scope::Mark mark() const { return {chunk_, offset_}; }
+  void rewind(Scope::Mark mark);
+
+  std::vector<Chunk> chunks_;
+  size_t chunk_ = 0;
+  size_t offset_ = 0;
+};
+
+}  // namespace CBLDart
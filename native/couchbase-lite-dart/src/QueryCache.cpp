@@ -0,0 +1,151 @@
+#include "QueryCache.h"
+
+#include <vector>
+
+namespace CBLDart {
+
+// === QueryCache =============================================================
+
+QueryCache &QueryCache::instance() {
+  // The cache is never destroyed, because queries can still be released by
+  // finalizers while static objects are destroyed.
+  static auto cache = new QueryCache;
+  return *cache;
+}
+
+CBLQuery *QueryCache::acquire(const CBLDatabase *database,
+                              CBLQueryLanguage language, FLString queryString,
+                              int *errorPosOut, CBLError *errorOut) {
+  Key key{language, std::string(static_cast<const char *>(queryString.buf),
+                                 queryString.size)};
+
+  {
+    std::scoped_lock lock(mutex_);
+    if (capacity_ > 0) {
+      auto &cache = databases_[database];
+      auto it = cache.index.find(key);
+      if (it != cache.index.end()) {
+        auto query = it->second->query;
+        cache.idleQueries.erase(it->second);
+        cache.index.erase(it);
+        checkedOut_.emplace(query, CheckedOutQuery{database, std::move(key)});
+        hits_++;
+        return query;
+      }
+    }
+    misses_++;
+  }
+
+  // The query is created without holding the lock, since parsing and
+  // preparing it can take a while.
+  auto query = CBLDatabase_CreateQuery(database, language, queryString,
+                                       errorPosOut, errorOut);
+  if (!query) {
+    return nullptr;
+  }
+
+  std::scoped_lock lock(mutex_);
+  if (capacity_ > 0) {
+    checkedOut_.emplace(query, CheckedOutQuery{database, std::move(key)});
+  }
+  return query;
+}
+
+void QueryCache::release(CBLQuery *query) {
+  std::list<CBLQuery *> evicted;
+  {
+    std::scoped_lock lock(mutex_);
+    auto it = checkedOut_.find(query);
+    if (it == checkedOut_.end()) {
+      evicted.push_back(query);
+    } else {
+      auto checkedOut = std::move(it->second);
+      checkedOut_.erase(it);
+
+      CBLQuery_SetParameters(query, kFLEmptyDict);
+
+      auto &cache = databases_[checkedOut.database];
+      cache.idleQueries.push_front({checkedOut.key, query});
+      cache.index.emplace(std::move(checkedOut.key),
+                          cache.idleQueries.begin());
+      evict(cache, evicted);
+    }
+  }
+
+  for (auto evictedQuery : evicted) {
+    CBLQuery_Release(evictedQuery);
+  }
+}
+
+void QueryCache::detach(CBLQuery *query) {
+  std::scoped_lock lock(mutex_);
+  checkedOut_.erase(query);
+}
+
+void QueryCache::purge(const CBLDatabase *database) {
+  std::vector<CBLQuery *> idleQueries;
+  {
+    std::scoped_lock lock(mutex_);
+    auto it = databases_.find(database);
+    if (it != databases_.end()) {
+      for (auto &idleQuery : it->second.idleQueries) {
+        idleQueries.push_back(idleQuery.query);
+      }
+      databases_.erase(it);
+    }
+
+    for (auto it = checkedOut_.begin(); it != checkedOut_.end();) {
+      if (it->second.database == database) {
+        it = checkedOut_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  for (auto query : idleQueries) {
+    CBLQuery_Release(query);
+  }
+}
+
+void QueryCache::setCapacity(size_t capacity) {
+  std::list<CBLQuery *> evicted;
+  {
+    std::scoped_lock lock(mutex_);
+    capacity_ = capacity;
+    for (auto &[_, cache] : databases_) {
+      evict(cache, evicted);
+    }
+  }
+
+  for (auto query : evicted) {
+    CBLQuery_Release(query);
+  }
+}
+
+CBLDart_QueryCacheStats QueryCache::stats() {
+  std::scoped_lock lock(mutex_);
+  size_t idleCount = 0;
+  for (auto &[_, cache] : databases_) {
+    idleCount += cache.idleQueries.size();
+  }
+  return {hits_, misses_, evictions_, idleCount, capacity_};
+}
+
+void QueryCache::evict(DatabaseCache &cache, std::list<CBLQuery *> &evicted) {
+  while (cache.idleQueries.size() > capacity_) {
+    auto last = std::prev(cache.idleQueries.end());
+    auto range = cache.index.equal_range(last->key);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == last) {
+        cache.index.erase(it);
+        break;
+      }
+    }
+    evicted.push_back(last->query);
+    cache.idleQueries.erase(last);
+    evictions_++;
+  }
+}
+
+}  // namespace CBLDart
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "CBL+Dart.h"
+
+namespace CBLDart {
+
+// === QueryCache =============================================================
+
+/**
+ * A cache of prepared queries, which allows queries with the same language and
+ * query string to be reused, instead of parsing and preparing them again.
+ *
+ * A query is checked out of the cache by `acquire` and belongs exclusively to
+ * the caller, until it is given back with `release`. Queries which are not
+ * checked out are idle and kept in a least recently used list for each
+ * database, which holds at most `capacity` queries.
+ *
+ * The parameters of a query are reset when it is given back.
+ */
+class QueryCache {
+ public:
+  static QueryCache &instance();
+
+  QueryCache(const QueryCache &) = delete;
+  QueryCache &operator=(const QueryCache &) = delete;
+
+  /**
+   * Checks a query out of the cache or, if there is no idle query with the
+   * same language and query string, creates a new one, like
+   * `CBLDatabase_CreateQuery`.
+   */
+  CBLQuery *acquire(const CBLDatabase *database, CBLQueryLanguage language,
+                    FLString queryString, int *errorPosOut,
+                    CBLError *errorOut);
+
+  /**
+   * Gives a query which has been checked out back to the cache, or releases
+   * it if it has been detached.
+   */
+  void release(CBLQuery *query);
+
+  /**
+   * Detaches a query which has been checked out from the cache, so that it is
+   * released instead of given back to the cache.
+   *
+   * Queries which have change listeners are detached, since removing their
+   * listeners does not make them reusable.
+   */
+  void detach(CBLQuery *query);
+
+  /**
+   * Releases the idle queries of `database` and detaches its queries which
+   * are checked out.
+   *
+   * Must be called before `database` is closed.
+   */
+  void purge(const CBLDatabase *database);
+
+  /**
+   * Sets the maximum number of idle queries, per database, and evicts the
+   * least recently used queries which exceed it.
+   */
+  void setCapacity(size_t capacity);
+
+  CBLDart_QueryCacheStats stats();
+
+ private:
+  QueryCache() = default;
+
+  using Key = std::pair<CBLQueryLanguage, std::string>;
+
+  struct IdleQuery {
+    Key key;
+    CBLQuery *query;
+  };
+
+  struct DatabaseCache {
+    /** The idle queries, with the most recently used query first. */
+    std::list<IdleQuery> idleQueries;
+    std::multimap<Key, std::list<IdleQuery>::iterator> index;
+  };
+
+  struct CheckedOutQuery {
+    const CBLDatabase *database;
+    Key key;
+  };
+
+  /** Removes the least recently used idle queries which exceed `capacity`. */
+  void evict(DatabaseCache &cache, std::list<CBLQuery *> &evicted);
+
+  std::mutex mutex_;
+  size_t capacity_ = 32;
+  std::unordered_map<const CBLDatabase *, DatabaseCache> databases_;
+  std::unordered_map<CBLQuery *, CheckedOutQuery> checkedOut_;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+  uint64_t evictions_ = 0;
+};
+
+}  // namespace CBLDart
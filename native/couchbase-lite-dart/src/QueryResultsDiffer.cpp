@@ -0,0 +1,234 @@
+#include "QueryResultsDiffer.h"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+
+#include "Utils.h"
+
+namespace CBLDart {
+
+// === QueryResultsDiffer =====================================================
+
+static std::string CBLDart_ValueToJSON(FLValue value) {
+  auto json = FLValue_ToJSON(value);
+  std::string result(static_cast<const char *>(json.buf), json.size);
+  FLSliceResult_Release(json);
+  return result;
+}
+
+static void CBLDart_CObject_SetInt32List(Dart_CObject *object,
+                                         std::vector<int32_t> &values) {
+  static int32_t empty = 0;
+  object->type = Dart_CObject_kTypedData;
+  object->value.as_typed_data.type = Dart_TypedData_kInt32;
+  object->value.as_typed_data.values = reinterpret_cast<uint8_t *>(
+      values.empty() ? &empty : values.data());
+  object->value.as_typed_data.length = static_cast<intptr_t>(values.size());
+}
+
+/**
+ * Returns whether each element of `sequence` belongs to a longest strictly
+ * increasing subsequence of it.
+ */
+static std::vector<bool> CBLDart_LongestIncreasingSubsequence(
+    const std::vector<size_t> &sequence) {
+  // `tails[k]` is the position of the smallest last element of an increasing
+  // subsequence of length `k + 1`.
+  std::vector<size_t> tails;
+  std::vector<ptrdiff_t> predecessors(sequence.size(), -1);
+  for (size_t i = 0; i < sequence.size(); i++) {
+    auto it = std::lower_bound(tails.begin(), tails.end(), sequence[i],
+                               [&](size_t position, size_t value) {
+                                 return sequence[position] < value;
+                               });
+    if (it != tails.begin()) {
+      predecessors[i] = static_cast<ptrdiff_t>(*std::prev(it));
+    }
+    if (it == tails.end()) {
+      tails.push_back(i);
+    } else {
+      *it = i;
+    }
+  }
+
+  std::vector<bool> result(sequence.size(), false);
+  auto position =
+      tails.empty() ? ptrdiff_t{-1} : static_cast<ptrdiff_t>(tails.back());
+  while (position >= 0) {
+    result[position] = true;
+    position = predecessors[position];
+  }
+  return result;
+}
+
+QueryResultsDiffer::~QueryResultsDiffer() { releaseRows(rows_); }
+
+bool QueryResultsDiffer::hasSameContent(const Row &a, const Row &b) {
+  return a.contentHash == b.contentHash &&
+         FLValue_IsEqual(reinterpret_cast<FLValue>(a.content),
+                         reinterpret_cast<FLValue>(b.content));
+}
+
+void QueryResultsDiffer::releaseRows(std::vector<Row> &rows) {
+  for (auto &row : rows) {
+    FLArray_Release(row.content);
+  }
+  rows.clear();
+}
+
+void QueryResultsDiffer::update(CBLResultSet *results, const CBLError &error) {
+  if (!results) {
+    sendError(error);
+    return;
+  }
+
+  // The arrays of the rows are released when the result set is advanced, so
+  // they are retained until the rows are replaced by the next results.
+  std::vector<Row> rows;
+  while (CBLResultSet_Next(results)) {
+    auto array = FLArray_Retain(CBLResultSet_ResultArray(results));
+    auto content = CBLDart_ValueToJSON(reinterpret_cast<FLValue>(array));
+    auto contentHash = std::hash<std::string_view>{}(content);
+    auto key = keyColumn_ < 0
+                   ? std::move(content)
+                   : CBLDart_ValueToJSON(FLArray_Get(array, keyColumn_));
+    rows.push_back({std::move(key), contentHash, array});
+  }
+  CBLResultSet_Release(results);
+
+  // Match the new rows with the previous rows which have the same key, in
+  // order, so that rows with duplicate keys are matched one to one.
+  std::unordered_map<std::string_view, std::deque<size_t>> previousIndexes;
+  for (size_t i = 0; i < rows_.size(); i++) {
+    previousIndexes[rows_[i].key].push_back(i);
+  }
+
+  std::vector<bool> isMatched(rows_.size(), false);
+  std::vector<ptrdiff_t> matches(rows.size(), -1);
+  for (size_t i = 0; i < rows.size(); i++) {
+    auto it = previousIndexes.find(rows[i].key);
+    if (it != previousIndexes.end() && !it->second.empty()) {
+      auto previousIndex = it->second.front();
+      it->second.pop_front();
+      matches[i] = static_cast<ptrdiff_t>(previousIndex);
+      isMatched[previousIndex] = true;
+    }
+  }
+
+  std::vector<int32_t> removed;
+  for (size_t i = 0; i < rows_.size(); i++) {
+    if (!isMatched[i]) {
+      removed.push_back(static_cast<int32_t>(i));
+    }
+  }
+
+  // Matched rows which are not part of the longest sequence of rows that keep
+  // their relative order have been moved.
+  std::vector<size_t> matchedIndexes;
+  std::vector<size_t> matchedPreviousIndexes;
+  for (size_t i = 0; i < rows.size(); i++) {
+    if (matches[i] >= 0) {
+      matchedIndexes.push_back(i);
+      matchedPreviousIndexes.push_back(static_cast<size_t>(matches[i]));
+    }
+  }
+  auto isStable = CBLDart_LongestIncreasingSubsequence(matchedPreviousIndexes);
+
+  std::vector<int32_t> movedFrom;
+  std::vector<int32_t> movedTo;
+  for (size_t i = 0; i < matchedIndexes.size(); i++) {
+    if (!isStable[i]) {
+      movedFrom.push_back(static_cast<int32_t>(matchedPreviousIndexes[i]));
+      movedTo.push_back(static_cast<int32_t>(matchedIndexes[i]));
+    }
+  }
+
+  std::vector<int32_t> inserted;
+  std::vector<int32_t> changed;
+  auto encoder = FLEncoder_New();
+  FLEncoder_BeginArray(encoder, 0);
+  for (size_t i = 0; i < rows.size(); i++) {
+    if (matches[i] < 0) {
+      inserted.push_back(static_cast<int32_t>(i));
+    } else if (!hasSameContent(rows_[matches[i]], rows[i])) {
+      changed.push_back(static_cast<int32_t>(i));
+    } else {
+      continue;
+    }
+    FLEncoder_WriteValue(encoder, reinterpret_cast<FLValue>(rows[i].content));
+  }
+  FLEncoder_EndArray(encoder);
+  auto encodedRows = FLEncoder_Finish(encoder, nullptr);
+  FLEncoder_Free(encoder);
+
+  releaseRows(rows_);
+  rows_ = std::move(rows);
+
+  Dart_CObject length{};
+  length.type = Dart_CObject_kInt64;
+  length.value.as_int64 = static_cast<int64_t>(rows_.size());
+
+  Dart_CObject removed_{};
+  CBLDart_CObject_SetInt32List(&removed_, removed);
+
+  Dart_CObject inserted_{};
+  CBLDart_CObject_SetInt32List(&inserted_, inserted);
+
+  Dart_CObject movedFrom_{};
+  CBLDart_CObject_SetInt32List(&movedFrom_, movedFrom);
+
+  Dart_CObject movedTo_{};
+  CBLDart_CObject_SetInt32List(&movedTo_, movedTo);
+
+  Dart_CObject changed_{};
+  CBLDart_CObject_SetInt32List(&changed_, changed);
+
+  Dart_CObject encodedRows_{};
+  CBLDart_CObject_SetFLString(&encodedRows_,
+                              {encodedRows.buf, encodedRows.size});
+
+  Dart_CObject *argsValues[] = {&length,     &removed_, &inserted_,
+                                &movedFrom_, &movedTo_, &changed_,
+                                &encodedRows_};
+
+  Dart_CObject args{};
+  args.type = Dart_CObject_kArray;
+  args.value.as_array.length = 7;
+  args.value.as_array.values = argsValues;
+
+  AsyncCallbackCall(*callback_).execute(args);
+
+  FLSliceResult_Release(encodedRows);
+}
+
+void QueryResultsDiffer::sendError(const CBLError &error) {
+  auto errorMessage = CBLError_Message(&error);
+
+  Dart_CObject errorDomain{};
+  errorDomain.type = Dart_CObject_kInt32;
+  errorDomain.value.as_int32 = error.domain;
+
+  Dart_CObject errorCode{};
+  errorCode.type = Dart_CObject_kInt32;
+  errorCode.value.as_int32 = error.code;
+
+  Dart_CObject errorMessage_{};
+  CBLDart_CObject_SetFLString(&errorMessage_,
+                              {errorMessage.buf, errorMessage.size});
+
+  Dart_CObject *argsValues[] = {&errorDomain, &errorCode, &errorMessage_};
+
+  Dart_CObject args{};
+  args.type = Dart_CObject_kArray;
+  args.value.as_array.length = 3;
+  args.value.as_array.values = argsValues;
+
+  AsyncCallbackCall(*callback_).execute(args);
+
+  FLSliceResult_Release(errorMessage);
+}
+
+}  // namespace CBLDart
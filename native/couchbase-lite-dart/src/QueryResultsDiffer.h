@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "AsyncCallback.h"
+#include "CBL+Dart.h"
+
+namespace CBLDart {
+
+// === QueryResultsDiffer =====================================================
+
+/**
+ * Keeps the previous results of a live query and sends the difference between
+ * consecutive results to a callback, instead of all results.
+ *
+ * Rows are matched by the value of a key column or, if there is no key column,
+ * by their content. The difference consists of the indexes of the rows which
+ * have been removed from the previous results and of the rows which have been
+ * inserted into, moved within or changed in the new results. Only the inserted
+ * and changed rows are sent to the callback, encoded as a Fleece array.
+ *
+ * Moves are minimal, in that the rows which keep their relative order form the
+ * longest such sequence.
+ */
+class QueryResultsDiffer {
+ public:
+  /** `keyColumn` is the index of the key column or `-1` if there is none. */
+  QueryResultsDiffer(AsyncCallback *callback, int keyColumn)
+      : callback_(callback), keyColumn_(keyColumn) {}
+
+  QueryResultsDiffer(const QueryResultsDiffer &) = delete;
+  QueryResultsDiffer &operator=(const QueryResultsDiffer &) = delete;
+
+  ~QueryResultsDiffer();
+
+  /**
+   * Consumes `results`, which are the new results of the query, and sends
+   * their difference to the previous results to the callback.
+   *
+   * If `results` is `nullptr`, `error` is sent to the callback instead.
+   */
+  void update(CBLResultSet *results, const CBLError &error);
+
+ private:
+  struct Row {
+    std::string key;
+    size_t contentHash;
+    /**
+     * The retained array of the column values, which is compared when the
+     * content hashes of two rows are equal.
+     */
+    FLArray content;
+  };
+
+  static bool hasSameContent(const Row &a, const Row &b);
+  static void releaseRows(std::vector<Row> &rows);
+
+  void sendError(const CBLError &error);
+
+  AsyncCallback *callback_;
+  int keyColumn_;
+  std::vector<Row> rows_;
+};
+
+}  // namespace CBLDart
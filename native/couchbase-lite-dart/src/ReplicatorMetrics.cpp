@@ -0,0 +1,67 @@
+#include "ReplicatorMetrics.h"
+
+#include <algorithm>
+
+namespace CBLDart {
+
+// === ReplicatorMetrics ======================================================
+
+void LatencyHistogram::record(std::chrono::steady_clock::duration duration) {
+  auto micros = static_cast<uint64_t>(std::max<int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count(),
+      0));
+
+  // The index of the bucket is the number of significant bits of `micros`.
+  size_t bucket = 0;
+  for (auto value = micros; value; value >>= 1) {
+    bucket++;
+  }
+  bucket = std::min<size_t>(bucket, buckets_.size() - 1);
+
+  count_.fetch_add(1, std::memory_order_relaxed);
+  totalMicros_.fetch_add(micros, std::memory_order_relaxed);
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+
+  auto max = maxMicros_.load(std::memory_order_relaxed);
+  while (micros > max && !maxMicros_.compare_exchange_weak(
+                             max, micros, std::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::read(CBLDart_LatencyHistogram *out) const {
+  out->count = count_.load(std::memory_order_relaxed);
+  out->totalMicros = totalMicros_.load(std::memory_order_relaxed);
+  out->maxMicros = maxMicros_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < buckets_.size(); i++) {
+    out->buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+}
+
+void ReplicatorMetrics::documentsReplicated(
+    bool isPush, unsigned numDocuments,
+    const CBLReplicatedDocument *documents) {
+  uint64_t errors = 0;
+  for (unsigned i = 0; i < numDocuments; i++) {
+    if (documents[i].error.code != 0) {
+      errors++;
+    }
+  }
+
+  auto &replicated = isPush ? documentsPushed_ : documentsPulled_;
+  replicated.fetch_add(numDocuments - errors, std::memory_order_relaxed);
+  documentErrors_.fetch_add(errors, std::memory_order_relaxed);
+}
+
+void ReplicatorMetrics::read(CBLDart_ReplicatorMetrics *out) const {
+  out->documentsPushed = documentsPushed_.load(std::memory_order_relaxed);
+  out->documentsPulled = documentsPulled_.load(std::memory_order_relaxed);
+  out->documentErrors = documentErrors_.load(std::memory_order_relaxed);
+  pushFilter.read(&out->pushFilter);
+  pullFilter.read(&out->pullFilter);
+  conflictResolver.read(&out->conflictResolver);
+  out->callbacksOverBudget =
+      callbacksOverBudget_.load(std::memory_order_relaxed);
+  out->callbacksTimedOut = callbacksTimedOut_.load(std::memory_order_relaxed);
+}
+
+}  // namespace CBLDart
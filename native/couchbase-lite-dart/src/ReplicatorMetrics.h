@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "CBL+Dart.h"
+
+namespace CBLDart {
+
+// === ReplicatorMetrics ======================================================
+
+/**
+ * A histogram of the durations of calls to a callback, which can be recorded
+ * concurrently and read without locking.
+ */
+class LatencyHistogram {
+ public:
+  void record(std::chrono::steady_clock::duration duration);
+
+  void read(CBLDart_LatencyHistogram *out) const;
+
+ private:
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> totalMicros_{0};
+  std::atomic<uint64_t> maxMicros_{0};
+  std::array<std::atomic<uint64_t>, kCBLDart_LatencyHistogramBuckets>
+      buckets_{};
+};
+
+/**
+ * Records the time from its construction to its destruction in a histogram,
+ * also when the measured callback throws.
+ */
+class LatencyTimer {
+ public:
+  explicit LatencyTimer(LatencyHistogram &histogram)
+      : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+
+  ~LatencyTimer() {
+    histogram_.record(std::chrono::steady_clock::now() - start_);
+  }
+
+  LatencyTimer(const LatencyTimer &) = delete;
+  LatencyTimer &operator=(const LatencyTimer &) = delete;
+
+ private:
+  LatencyHistogram &histogram_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * The metrics of a replicator, which are updated by the callback wrappers of
+ * the replicator and by a document replication listener.
+ */
+class ReplicatorMetrics {
+ public:
+  /** Counts the documents of a batch of replicated documents. */
+  void documentsReplicated(bool isPush, unsigned numDocuments,
+                           const CBLReplicatedDocument *documents);
+
+  /** Counts a call into Dart which took longer than the latency budget. */
+  void callbackOverBudget() {
+    callbacksOverBudget_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /** Counts a call into Dart which missed its deadline. */
+  void callbackTimedOut() {
+    callbacksTimedOut_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void read(CBLDart_ReplicatorMetrics *out) const;
+
+  LatencyHistogram pushFilter;
+  LatencyHistogram pullFilter;
+  LatencyHistogram conflictResolver;
+
+ private:
+  std::atomic<uint64_t> documentsPushed_{0};
+  std::atomic<uint64_t> documentsPulled_{0};
+  std::atomic<uint64_t> documentErrors_{0};
+  std::atomic<uint64_t> callbacksOverBudget_{0};
+  std::atomic<uint64_t> callbacksTimedOut_{0};
+};
+
+}  // namespace CBLDart
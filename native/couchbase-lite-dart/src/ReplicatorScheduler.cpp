@@ -0,0 +1,222 @@
+#include "ReplicatorScheduler.h"
+
+#include "Executor.h"
+
+namespace CBLDart {
+
+// === ReplicatorScheduler ====================================================
+
+ReplicatorScheduler &ReplicatorScheduler::instance() {
+  static auto scheduler = new ReplicatorScheduler;
+  return *scheduler;
+}
+
+void ReplicatorScheduler::schedule(const CBLDatabase *database,
+                                   CBLReplicator *replicator,
+                                   bool resetCheckpoint, int32_t priority) {
+  Actions actions;
+  bool isScheduled;
+  {
+    std::scoped_lock lock(mutex_);
+    auto it = entries_.find(replicator);
+    isScheduled = it != entries_.end();
+    if (isScheduled) {
+      it->second->priority = priority;
+      // The new priority can change which replicator is next in line.
+      promote(actions);
+      yieldIdle(actions);
+    }
+  }
+  if (isScheduled) {
+    run(std::move(actions));
+    return;
+  }
+
+  auto entry = std::make_shared<Entry>();
+  entry->replicator = replicator;
+  entry->databaseLock = CBLDart_CloneDatabaseLock(database);
+  entry->continuous = CBLReplicator_Config(replicator)->continuous;
+  entry->resetCheckpoint = resetCheckpoint;
+  entry->priority = priority;
+  // Changes are ignored until the entry has been added.
+  entry->listenerToken =
+      CBLReplicator_AddChangeListener(replicator, changeListener, nullptr);
+
+  bool isAdded;
+  {
+    std::scoped_lock lock(mutex_);
+    entry->sequence = nextSequence_++;
+    isAdded = entries_.emplace(replicator, entry).second;
+    promote(actions);
+  }
+  if (!isAdded) {
+    // The replicator has been scheduled concurrently.
+    retire(*entry);
+  }
+  run(std::move(actions));
+}
+
+bool ReplicatorScheduler::unschedule(CBLReplicator *replicator) {
+  std::shared_ptr<Entry> entry;
+  Actions actions;
+  {
+    std::scoped_lock lock(mutex_);
+    auto it = entries_.find(replicator);
+    if (it == entries_.end()) {
+      return false;
+    }
+    entry = it->second;
+    entries_.erase(it);
+    if (entry->isActive) {
+      activeCount_--;
+    }
+    promote(actions);
+  }
+  retire(*entry);
+  run(std::move(actions));
+  return entry->hasStarted;
+}
+
+void ReplicatorScheduler::setMaxActive(uint32_t maxActive) {
+  Actions actions;
+  {
+    std::scoped_lock lock(mutex_);
+    maxActive_ = maxActive;
+    promote(actions);
+  }
+  run(std::move(actions));
+}
+
+CBLDart_ReplicatorSchedulerStats ReplicatorScheduler::stats() {
+  std::scoped_lock lock(mutex_);
+  return {maxActive_, activeCount_, entries_.size() - activeCount_};
+}
+
+void ReplicatorScheduler::changeListener(void *context,
+                                         CBLReplicator *replicator,
+                                         const CBLReplicatorStatus *status) {
+  instance().statusChanged(replicator, *status);
+}
+
+void ReplicatorScheduler::statusChanged(CBLReplicator *replicator,
+                                        const CBLReplicatorStatus &status) {
+  std::shared_ptr<Entry> stopped;
+  Actions actions;
+  {
+    std::scoped_lock lock(mutex_);
+    auto it = entries_.find(replicator);
+    if (it == entries_.end() || !it->second->isActive) {
+      return;
+    }
+    auto entry = it->second;
+
+    if (status.activity == kCBLReplicatorStopped) {
+      stopped = entry;
+      entries_.erase(it);
+      activeCount_--;
+      promote(actions);
+    } else {
+      entry->isIdle = status.activity == kCBLReplicatorIdle;
+      if (!entry->isIdle || !entry->continuous) {
+        return;
+      }
+      yieldIdle(actions);
+    }
+  }
+
+  if (stopped) {
+    // The listener cannot be removed from within itself.
+    Executor::cleanup().submit([stopped]() { retire(*stopped); });
+  }
+  run(std::move(actions));
+}
+
+std::shared_ptr<ReplicatorScheduler::Entry> ReplicatorScheduler::nextWaiting() {
+  std::shared_ptr<Entry> next;
+  for (auto &[_, entry] : entries_) {
+    if (entry->isActive) {
+      continue;
+    }
+    if (!next || entry->priority > next->priority ||
+        (entry->priority == next->priority &&
+         entry->sequence < next->sequence)) {
+      next = entry;
+    }
+  }
+  return next;
+}
+
+void ReplicatorScheduler::promote(Actions &actions) {
+  while (maxActive_ == 0 || activeCount_ < maxActive_) {
+    auto entry = nextWaiting();
+    if (!entry) {
+      break;
+    }
+    entry->isActive = true;
+    entry->isIdle = false;
+    activeCount_++;
+    actions.emplace_back(entry,
+                         entry->wasActive ? Action::resume : Action::start);
+    entry->wasActive = true;
+  }
+}
+
+void ReplicatorScheduler::yieldIdle(Actions &actions) {
+  while (auto next = nextWaiting()) {
+    std::shared_ptr<Entry> idle;
+    for (auto &[_, entry] : entries_) {
+      if (!entry->isActive || !entry->isIdle || !entry->continuous ||
+          entry->priority > next->priority) {
+        continue;
+      }
+      if (!idle || entry->priority < idle->priority) {
+        idle = entry;
+      }
+    }
+    if (!idle) {
+      break;
+    }
+    idle->isActive = false;
+    idle->isIdle = false;
+    idle->sequence = nextSequence_++;
+    activeCount_--;
+    actions.emplace_back(idle, Action::suspend);
+    promote(actions);
+  }
+}
+
+void ReplicatorScheduler::run(Actions actions) {
+  for (auto &item : actions) {
+    auto task = [entry = item.first, action = item.second]() {
+      std::scoped_lock actionLock(entry->actionMutex);
+      if (entry->isRemoved) {
+        return;
+      }
+
+      auto databaseLock = entry->databaseLock->acquire();
+      switch (action) {
+        case Action::start:
+          CBLReplicator_Start(entry->replicator, entry->resetCheckpoint);
+          entry->hasStarted = true;
+          break;
+        case Action::resume:
+          CBLReplicator_SetSuspended(entry->replicator, false);
+          break;
+        case Action::suspend:
+          CBLReplicator_SetSuspended(entry->replicator, true);
+          break;
+      }
+    };
+    Executor::cleanup().submit(std::move(task));
+  }
+}
+
+void ReplicatorScheduler::retire(Entry &entry) {
+  {
+    std::scoped_lock actionLock(entry.actionMutex);
+    entry.isRemoved = true;
+  }
+  CBLListener_Remove(entry.listenerToken);
+}
+
+}  // namespace CBLDart
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "CBL+Dart.h"
+#include "DatabaseLock.h"
+
+namespace CBLDart {
+
+// === ReplicatorScheduler ====================================================
+
+/**
+ * Starts scheduled replicators, so that at most `maxActive` of them are active
+ * at the same time. A `maxActive` of `0` means that there is no limit.
+ *
+ * Waiting replicators are started in the order of their priority, highest
+ * first, and then in the order in which they were scheduled. A one-shot
+ * replicator frees its slot when it stops. A continuous replicator which has
+ * become idle is suspended and moved to the back of the queue, when a
+ * replicator with at least the same priority is waiting, and is resumed when
+ * its turn comes again, so that continuous replicators take turns catching up.
+ *
+ * Replicators are started, resumed and suspended on the cleanup executor,
+ * since this can happen from within a change listener of another replicator.
+ */
+class ReplicatorScheduler {
+ public:
+  static ReplicatorScheduler &instance();
+
+  ReplicatorScheduler(const ReplicatorScheduler &) = delete;
+  ReplicatorScheduler &operator=(const ReplicatorScheduler &) = delete;
+
+  /**
+   * Adds `replicator` to the queue of waiting replicators or, if it has
+   * already been scheduled, updates its priority, which can make it take the
+   * slot of an idle continuous replicator.
+   */
+  void schedule(const CBLDatabase *database, CBLReplicator *replicator,
+                bool resetCheckpoint, int32_t priority);
+
+  /**
+   * Removes `replicator` from the scheduler and returns whether the scheduler
+   * has started it.
+   *
+   * A replicator which has been started is not stopped, but it might be
+   * suspended.
+   */
+  bool unschedule(CBLReplicator *replicator);
+
+  void setMaxActive(uint32_t maxActive);
+
+  CBLDart_ReplicatorSchedulerStats stats();
+
+ private:
+  ReplicatorScheduler() = default;
+
+  enum class Action { start, resume, suspend };
+
+  struct Entry {
+    CBLReplicator *replicator;
+    CBLDart_DatabaseLock *databaseLock;
+    bool continuous;
+    bool resetCheckpoint;
+    int32_t priority;
+    uint64_t sequence = 0;
+    CBLListenerToken *listenerToken = nullptr;
+
+    /** Whether the replicator occupies a slot. */
+    bool isActive = false;
+    /** Whether the replicator has been given a slot before. */
+    bool wasActive = false;
+    /** Whether the active replicator has last reported to be idle. */
+    bool isIdle = false;
+
+    /** Serializes actions and the removal from the scheduler. */
+    std::mutex actionMutex;
+    bool hasStarted = false;
+    bool isRemoved = false;
+
+    ~Entry() { databaseLock->release(); }
+  };
+
+  using Actions = std::vector<std::pair<std::shared_ptr<Entry>, Action>>;
+
+  static void changeListener(void *context, CBLReplicator *replicator,
+                             const CBLReplicatorStatus *status);
+
+  void statusChanged(CBLReplicator *replicator,
+                     const CBLReplicatorStatus &status);
+
+  /** Returns the waiting replicator which is next in line. */
+  std::shared_ptr<Entry> nextWaiting();
+
+  /** Gives free slots to waiting replicators. */
+  void promote(Actions &actions);
+
+  /**
+   * Suspends idle continuous replicators in favor of waiting replicators with
+   * at least the same priority.
+   */
+  void yieldIdle(Actions &actions);
+
+  void run(Actions actions);
+
+  /** Ensures that no more actions are run for `entry`. */
+  static void retire(Entry &entry);
+
+  std::mutex mutex_;
+  uint32_t maxActive_ = 0;
+  size_t activeCount_ = 0;
+  uint64_t nextSequence_ = 0;
+  std::unordered_map<CBLReplicator *, std::shared_ptr<Entry>> entries_;
+};
+
+}  // namespace CBLDart
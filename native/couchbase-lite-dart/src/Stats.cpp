@@ -0,0 +1,24 @@
+#include "Stats.h"
+
+namespace CBLDart {
+
+// === Stats ==================================================================
+
+// Only consists of atomics, which are constant initialized, so that stats can
+// be recorded while other static objects are initialized or destroyed.
+Stats Stats::instance;
+
+void Stats::read(CBLDart_Stats *out) const {
+  out->asyncCallbackCalls = asyncCallbackCalls_.load(std::memory_order_relaxed);
+  blockingAsyncCallbackCalls.read(&out->blockingAsyncCallbackCalls);
+  out->listenerInvocations =
+      listenerInvocations_.load(std::memory_order_relaxed);
+  out->logCallbackMessages =
+      logCallbackMessages_.load(std::memory_order_relaxed);
+  out->blobBytesRead = blobBytesRead_.load(std::memory_order_relaxed);
+  out->databaseLockAcquisitions =
+      databaseLockAcquisitions_.load(std::memory_order_relaxed);
+  databaseLockWaits.read(&out->databaseLockWaits);
+}
+
+}  // namespace CBLDart
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "CBL+Dart.h"
+#include "ReplicatorMetrics.h"
+
+namespace CBLDart {
+
+// === Stats ==================================================================
+
+/**
+ * The statistics of the hot paths of this library, which are recorded
+ * concurrently, with relaxed atomic operations, and read by
+ * `CBLDart_Stats_Snapshot`.
+ */
+class Stats {
+ public:
+  static Stats instance;
+
+  void asyncCallbackCalled() {
+    asyncCallbackCalls_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void listenerInvoked() {
+    listenerInvocations_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void logMessagesSent(uint64_t count) {
+    logCallbackMessages_.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  void blobBytesRead(uint64_t size) {
+    blobBytesRead_.fetch_add(size, std::memory_order_relaxed);
+  }
+
+  void databaseLockAcquired() {
+    databaseLockAcquisitions_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void read(CBLDart_Stats *out) const;
+
+  LatencyHistogram blockingAsyncCallbackCalls;
+  LatencyHistogram databaseLockWaits;
+
+ private:
+  std::atomic<uint64_t> asyncCallbackCalls_{0};
+  std::atomic<uint64_t> listenerInvocations_{0};
+  std::atomic<uint64_t> logCallbackMessages_{0};
+  std::atomic<uint64_t> blobBytesRead_{0};
+  std::atomic<uint64_t> databaseLockAcquisitions_{0};
+};
+
+}  // namespace CBLDart
@@ -0,0 +1,84 @@
+#include "Timeline.h"
+
+#include <mutex>
+
+#include "dart/dart_tools_api.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include "dlfcn.h"
+#endif
+
+namespace CBLDart {
+
+// === Timeline ===============================================================
+
+typedef int64_t (*Dart_TimelineGetMicros_t)();
+typedef void (*Dart_TimelineEvent_t)(const char *label, int64_t timestamp0,
+                                     int64_t timestamp1_or_async_id,
+                                     Dart_Timeline_Event_Type type,
+                                     intptr_t argument_count,
+                                     const char **argument_names,
+                                     const char **argument_values);
+
+static Dart_TimelineGetMicros_t Dart_TimelineGetMicros_fp = nullptr;
+static Dart_TimelineEvent_t Dart_TimelineEvent_fp = nullptr;
+
+static void *CBLDart_LookupProcessSymbol(const char *name) {
+#ifdef _WIN32
+  return reinterpret_cast<void *>(
+      GetProcAddress(GetModuleHandle(nullptr), name));
+#else
+  return dlsym(RTLD_DEFAULT, name);
+#endif
+}
+
+static bool CBLDart_InitTimelineAPI() {
+  static std::once_flag initFlag;
+  std::call_once(initFlag, []() {
+    Dart_TimelineGetMicros_fp = reinterpret_cast<Dart_TimelineGetMicros_t>(
+        CBLDart_LookupProcessSymbol("Dart_TimelineGetMicros"));
+    Dart_TimelineEvent_fp = reinterpret_cast<Dart_TimelineEvent_t>(
+        CBLDart_LookupProcessSymbol("Dart_TimelineEvent"));
+  });
+  return Dart_TimelineGetMicros_fp && Dart_TimelineEvent_fp;
+}
+
+std::atomic<int32_t> Timeline::enableCount_{0};
+
+// Flow ids which are created by the Dart VM count up from a small number, so
+// native flow ids start far away from them.
+std::atomic<int64_t> Timeline::nextFlowId_{int64_t{1} << 48};
+
+bool Timeline::enable() {
+  if (!CBLDart_InitTimelineAPI()) {
+    return false;
+  }
+  enableCount_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void Timeline::disable() {
+  if (CBLDart_InitTimelineAPI()) {
+    enableCount_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+int64_t Timeline::now() { return Dart_TimelineGetMicros_fp(); }
+
+int64_t Timeline::newFlowId() {
+  return nextFlowId_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Timeline::recordDuration(const char *label, int64_t start, int64_t end) {
+  Dart_TimelineEvent_fp(label, start, end, Dart_Timeline_Event_Duration, 0,
+                        nullptr, nullptr);
+}
+
+void Timeline::recordFlowBegin(const char *label, int64_t flowId) {
+  Dart_TimelineEvent_fp(label, now(), flowId, Dart_Timeline_Event_Flow_Begin,
+                        0, nullptr, nullptr);
+}
+
+}  // namespace CBLDart
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace CBLDart {
+
+// === Timeline ===============================================================
+
+/**
+ * Records native work as events in the Dart timeline, so that it shows up in
+ * Dart DevTools, next to the events which are recorded by Dart code.
+ *
+ * The events are recorded in the `Embedder` stream of the timeline.
+ *
+ * The timeline functions of the Dart VM are not part of the dynamically
+ * linked Dart API. They are looked up in the process, when the timeline is
+ * enabled for the first time, and the timeline cannot be enabled if they are
+ * not found.
+ *
+ * The timeline is enabled while at least one call of `enable` has not been
+ * balanced by a call of `disable`. While the timeline is disabled, recording
+ * events only costs checking whether it is enabled.
+ */
+class Timeline {
+ public:
+  /** Returns false if the timeline functions of the Dart VM are missing. */
+  static bool enable();
+
+  static void disable();
+
+  static bool isEnabled() {
+    return enableCount_.load(std::memory_order_relaxed) > 0;
+  }
+
+  /** The current timestamp of the timeline, in microseconds. */
+  static int64_t now();
+
+  /**
+   * Returns a new id for a flow, which links the events of a flow across
+   * threads and isolates.
+   *
+   * The ids don't overlap with the flow ids which are created by the Dart VM.
+   */
+  static int64_t newFlowId();
+
+  /** Records an event which lasted from `start` to `end`. */
+  static void recordDuration(const char *label, int64_t start, int64_t end);
+
+  /** Records the beginning of the flow with `flowId`. */
+  static void recordFlowBegin(const char *label, int64_t flowId);
+
+ private:
+  static std::atomic<int32_t> enableCount_;
+  static std::atomic<int64_t> nextFlowId_;
+};
+
+/**
+ * Records the time from its construction to its destruction as an event in
+ * the Dart timeline, if the timeline is enabled when it is constructed.
+ *
+ * `label` must be a string literal.
+ */
+class TimelineSpan {
+ public:
+  explicit TimelineSpan(const char *label)
+      : label_(label), start_(Timeline::isEnabled() ? Timeline::now() : -1) {}
+
+  ~TimelineSpan() {
+    if (start_ >= 0) {
+      Timeline::recordDuration(label_, start_, Timeline::now());
+    }
+  }
+
+  TimelineSpan(const TimelineSpan &) = delete;
+  TimelineSpan &operator=(const TimelineSpan &) = delete;
+
+  /** Whether this span is recorded. */
+  bool isRecorded() const { return start_ >= 0; }
+
+ private:
+  const char *label_;
+  int64_t start_;
+};
+
+}  // namespace CBLDart
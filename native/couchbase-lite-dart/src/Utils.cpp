@@ -1,5 +1,7 @@
 #include "Utils.h"
 
+#include <cstring>
+
 // === Dart Native ============================================================
 
 int64_t CBLDart_CObject_getIntValueAsInt64(Dart_CObject* object) {
@@ -35,8 +37,60 @@ void CBLDart_CObject_SetFLString(Dart_CObject* object, const FLString string) {
   }
 }
 
+void CBLDart_CObject_SetPackedStrings(Dart_CObject* object,
+                                      const FLString* strings, size_t count,
+                                      CBLDart::MessageArena& arena) {
+  size_t dataSize = 0;
+  for (size_t i = 0; i < count; i++) {
+    dataSize += strings[i].size;
+  }
+
+  auto headerSize = sizeof(uint32_t) * (count + 2);
+  auto buffer = static_cast<uint8_t*>(
+      arena.allocate(headerSize + dataSize, alignof(uint32_t)));
+
+  auto header = reinterpret_cast<uint32_t*>(buffer);
+  auto data = buffer + headerSize;
+  header[0] = static_cast<uint32_t>(count);
+
+  uint32_t offset = 0;
+  for (size_t i = 0; i < count; i++) {
+    header[i + 1] = offset;
+    if (strings[i].size) {
+      std::memcpy(data + offset, strings[i].buf, strings[i].size);
+      offset += static_cast<uint32_t>(strings[i].size);
+    }
+  }
+  header[count + 1] = offset;
+
+  object->type = Dart_CObject_kTypedData;
+  object->value.as_typed_data.type = Dart_TypedData_kUint8;
+  object->value.as_typed_data.values = buffer;
+  object->value.as_typed_data.length = headerSize + dataSize;
+}
+
 // === Fleece =================================================================
 
 std::string CBLDart_FLStringToString(FLString slice) {
   return std::string((char*)slice.buf, slice.size);
 }
+
+std::string CBLDart_JSONString(std::string_view value) {
+  static const char* hexDigits = "0123456789abcdef";
+
+  std::string result = "\"";
+  for (auto c : value) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+      result += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      result += "\\u00";
+      result += hexDigits[c >> 4];
+      result += hexDigits[c & 0xf];
+    } else {
+      result += c;
+    }
+  }
+  result += "\"";
+  return result;
+}
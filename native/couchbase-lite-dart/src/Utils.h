@@ -1,3 +1,7 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "dart/dart_api_dl.h"
 #ifdef CBL_FRAMEWORK_HEADERS
 #include <CouchbaseLite/Fleece.h>
@@ -5,6 +9,7 @@
 #include "fleece/Fleece.h"
 #endif
 #include "Fleece+Dart.h"
+#include "MessageArena.h"
 
 /**
  * The external allocation size that is used for objects for which the exact
@@ -30,6 +35,22 @@ void CBLDart_CObject_SetPointer(Dart_CObject* object, const void* pointer);
 
 void CBLDart_CObject_SetFLString(Dart_CObject* object, const FLString string);
 
+/**
+ * Packs `count` strings into a buffer allocated from `arena` and sets `object`
+ * to a typed data object pointing at the buffer, which lives until the
+ * current scope of `arena` ends.
+ *
+ * The buffer starts with the number of strings as a `uint32_t`, followed by
+ * `count + 1` offsets as `uint32_t`s, which delimit the strings in the string
+ * data that follows them. All integers use the native byte order.
+ */
+void CBLDart_CObject_SetPackedStrings(Dart_CObject* object,
+                                      const FLString* strings, size_t count,
+                                      CBLDart::MessageArena& arena);
+
 // === Fleece =================================================================
 
 std::string CBLDart_FLStringToString(FLString slice);
+
+/** Encodes `value` as a JSON string. */
+std::string CBLDart_JSONString(std::string_view value);
@@ -4,24 +4,93 @@ CBL_Dart {
 		CBLDart_AsyncCallback_New;
 		CBLDart_AsyncCallback_Close;
 		CBLDart_AsyncCallback_Delete;
+		CBLDart_AsyncCallback_EnableBatching;
+		CBLDart_AsyncCallback_BatchDelivered;
 		CBLDart_AsyncCallback_CallForTest;
+		CBLDart_Stats_Snapshot;
+		CBLDart_Timeline_Enable;
+		CBLDart_Timeline_Disable;
 		CBLDart_CBLLog_SetCallback;
 		CBLDart_CBLLog_SetCallbackLevel;
+		CBLDart_CBLLog_SetCallbackDomainLevel;
 		CBLDart_CBLLog_SetFileConfig;
 		CBLDart_CBLLog_GetFileConfig;
 		CBLDart_CBLLog_SetSentryBreadcrumbs;
+		CBLDart_CBLLog_ConfigureSentryBreadcrumbs;
 		CBLDart_CBLDatabase_Open;
 		CBLDart_CBLDatabase_Release;
 		CBLDart_CBLDatabase_Close;
+		CBLDart_CBLDatabase_BeginTransaction;
+		CBLDart_CBLDatabase_EndTransaction;
+		CBLDart_CBLDatabase_OpenShared;
+		CBLDart_SharedDatabase_Database;
+		CBLDart_SharedDatabase_Close;
+		CBLDart_SharedDatabase_Release;
+		CBLDart_SharedDatabase_BeginTransaction;
+		CBLDart_SharedDatabase_EndTransaction;
+		CBLDart_CBLDatabase_ScheduleMaintenance;
 		CBLDart_CBLCollection_AddDocumentChangeListener;
 		CBLDart_CBLCollection_AddChangeListener;
+		CBLDart_CBLCollection_GetDocument;
+		CBLDart_CBLCollection_GetDocuments;
+		CBLDart_CBLCollection_SaveDocuments;
+		CBLDart_CBLCollection_SetDocumentExpiration;
+		CBLDart_CBLCollection_SetDocumentExpirations;
+		CBLDart_CBLCollection_ExpirationStats;
+		CBLDart_CBLCollection_PatchDocument;
 		CBLDart_CBLCollection_CreateIndex;
+		CBLDart_CBLCollection_BuildIndex;
+		CBLDart_IndexBuilder_Cancel;
+		CBLDart_CBLCollection_ImportJSONLines;
+		CBLDart_JSONLinesImporter_AddChunk;
+		CBLDart_JSONLinesImporter_AddFile;
+		CBLDart_JSONLinesImporter_Finish;
+		CBLDart_CBLCollection_DeleteWhere;
+		CBLDart_CBLCollection_PurgeWhere;
+		CBLDart_DocumentCache_SetLimits;
+		CBLDart_DocumentCache_Stats;
+		CBLDart_CBLCollection_NewChangeCursor;
+		CBLDart_ChangeCursor_Next;
+		CBLDart_ChangeCursor_Release;
+		CBLDart_DocumentOperations_New;
+		CBLDart_DocumentOperations_GetDocument;
+		CBLDart_DocumentOperations_SaveDocument;
+		CBLDart_DocumentOperations_DeleteDocument;
+		CBLDart_DocumentOperations_PurgeDocument;
 		CBLDart_CBLQuery_AddChangeListener;
-		CBLDart_CBLBlobReader_Read;
+		CBLDart_CBLQuery_SetChangeListenerPaused;
+		CBLDart_CBLQuery_AddDiffListener;
+		CBLDart_CBLQuery_ExecuteAsync;
+		CBLDart_QueryCache_CreateQuery;
+		CBLDart_QueryCache_ReleaseQuery;
+		CBLDart_QueryCache_SetCapacity;
+		CBLDart_QueryCache_Stats;
+		CBLDart_CBLResultSet_WriteJSON;
+		CBLDart_CBLResultSet_NextBatch;
+		CBLDart_CBLResultSet_NextBatchWithDocuments;
+		CBLDart_CBLResultSet_ExtractColumns;
+		CBLDart_CBLCollection_FullTextSearch;
+		CBLDart_CBLBlob_CreateFromFile;
+		CBLDart_CBLBlob_WriteToFile;
+		CBLDart_BlobCache_Get;
+		CBLDart_BlobCache_Put;
+		CBLDart_BlobCache_SetLimits;
+		CBLDart_BlobCache_Stats;
+		CBLDart_CBLDatabase_SaveBlob;
+		CBLDart_BlobDeduplication_Stats;
+		CBLDart_CBLBlob_ReadAhead;
+		CBLDart_BlobReadAhead_Next;
 		CBLDart_CBLReplicator_Create;
 		CBLDart_CBLReplicator_Release;
 		CBLDart_CBLReplicator_AddChangeListener;
 		CBLDart_CBLReplicator_AddDocumentReplicationListener;
+		CBLDart_CBLReplicator_AreDocumentsPending;
+		CBLDart_CBLReplicator_PendingDocumentCount;
+		CBLDart_CBLReplicator_Metrics;
+		CBLDart_CBLReplicator_Schedule;
+		CBLDart_CBLReplicator_Unschedule;
+		CBLDart_ReplicatorScheduler_SetMaxActive;
+		CBLDart_ReplicatorScheduler_Stats;
 		CBLDart_FLSliceResult_RetainByBuf;
 		CBLDart_FLSliceResult_ReleaseByBuf;
 		CBLDart_KnownSharedKeys_New;
@@ -32,10 +101,23 @@ CBL_Dart {
 		CBLDart_FLDictIterator_Begin;
 		CBLDart_FLDictIterator_Delete;
 		CBLDart_FLDictIterator_Next;
+		CBLDart_FLDictIterator_NextBatch;
 		CBLDart_FLArrayIterator_Begin;
 		CBLDart_FLArrayIterator_Delete;
 		CBLDart_FLArrayIterator_Next;
-		CBLDart_FLEncoder_WriteArrayValue;
+		CBLDart_FLArrayIterator_NextBatch;
+		CBLDart_FLStringInterner_New;
+		CBLDart_FLStringInterner_Delete;
+		CBLDart_FLTape_New;
+		CBLDart_FLTape_Delete;
+		CBLDart_FLTape_WriteValue;
+		CBLDart_FLDictProjection_New;
+		CBLDart_FLDictProjection_Delete;
+		CBLDart_FLDictProjection_Eval;
+		CBLDart_FLEncoder_WriteTape;
+		CBLDart_FLJSONBuffer_New;
+		CBLDart_FLJSONBuffer_Delete;
+		CBLDart_FLJSONBuffer_Clear;
 	local:
 		*;
 };
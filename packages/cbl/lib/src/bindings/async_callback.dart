@@ -4,6 +4,7 @@
 import 'dart:ffi';
 import 'dart:isolate';
 
+import 'base.dart';
 import 'bindings.dart';
 
 final class CBLDartAsyncCallback extends Opaque {}
@@ -30,6 +31,22 @@ typedef _CBLDart_AsyncCallback_Delete_C = Void Function(
   Pointer<CBLDartAsyncCallback> callback,
 );
 
+typedef _CBLDart_AsyncCallback_EnableBatching_C = Void Function(
+  Pointer<CBLDartAsyncCallback> callback,
+  Uint32 maxBatchSize,
+);
+typedef _CBLDart_AsyncCallback_EnableBatching = void Function(
+  Pointer<CBLDartAsyncCallback> callback,
+  int maxBatchSize,
+);
+
+typedef _CBLDart_AsyncCallback_BatchDelivered_C = Void Function(
+  Pointer<CBLDartAsyncCallback> callback,
+);
+typedef _CBLDart_AsyncCallback_BatchDelivered = void Function(
+  Pointer<CBLDartAsyncCallback> callback,
+);
+
 typedef _CBLDart_AsyncCallback_CallForTest_C = Void Function(
   Pointer<CBLDartAsyncCallback> callback,
   Int64 result,
@@ -39,33 +56,34 @@ typedef _CBLDart_AsyncCallback_CallForTest = void Function(
   int result,
 );
 
+/// Bindings for async callbacks, which are bound from the function table of
+/// [BaseBindings], once the native libraries have been initialized.
 final class AsyncCallbackBindings extends Bindings {
-  AsyncCallbackBindings(super.parent) {
-    _new = libs.cblDart.lookupFunction<_CBLDart_AsyncCallback_New_C,
-        _CBLDart_AsyncCallback_New>(
-      'CBLDart_AsyncCallback_New',
-    );
-    _deletePtr =
-        libs.cblDart.lookup<NativeFunction<_CBLDart_AsyncCallback_Delete_C>>(
-      'CBLDart_AsyncCallback_Delete',
-    );
-    _close = libs.cblDart.lookupFunction<_CBLDart_AsyncCallback_Close_C,
-        _CBLDart_AsyncCallback_Close>(
-      'CBLDart_AsyncCallback_Close',
-    );
-    _callForTest = libs.cblDart.lookupFunction<
-        _CBLDart_AsyncCallback_CallForTest_C,
-        _CBLDart_AsyncCallback_CallForTest>(
-      'CBLDart_AsyncCallback_CallForTest',
-      isLeaf: useIsLeaf,
-    );
-  }
+  AsyncCallbackBindings(super.parent, this._base);
+
+  final BaseBindings _base;
+
+  CBLDart_FunctionTable get _functionTable => _base.functionTable;
 
-  late final _CBLDart_AsyncCallback_New _new;
-  late final Pointer<NativeFunction<_CBLDart_AsyncCallback_Delete_C>>
-      _deletePtr;
-  late final _CBLDart_AsyncCallback_Close _close;
-  late final _CBLDart_AsyncCallback_CallForTest _callForTest;
+  late final _new = _functionTable.CBLDart_AsyncCallback_New
+      .cast<NativeFunction<_CBLDart_AsyncCallback_New_C>>()
+      .asFunction<_CBLDart_AsyncCallback_New>();
+  late final _deletePtr = _functionTable.CBLDart_AsyncCallback_Delete
+      .cast<NativeFunction<_CBLDart_AsyncCallback_Delete_C>>();
+  late final _close = _functionTable.CBLDart_AsyncCallback_Close
+      .cast<NativeFunction<_CBLDart_AsyncCallback_Close_C>>()
+      .asFunction<_CBLDart_AsyncCallback_Close>();
+  late final _enableBatching = _functionTable
+      .CBLDart_AsyncCallback_EnableBatching
+      .cast<NativeFunction<_CBLDart_AsyncCallback_EnableBatching_C>>()
+      .asFunction<_CBLDart_AsyncCallback_EnableBatching>(isLeaf: useIsLeaf);
+  late final _batchDelivered = _functionTable
+      .CBLDart_AsyncCallback_BatchDelivered
+      .cast<NativeFunction<_CBLDart_AsyncCallback_BatchDelivered_C>>()
+      .asFunction<_CBLDart_AsyncCallback_BatchDelivered>();
+  late final _callForTest = _functionTable.CBLDart_AsyncCallback_CallForTest
+      .cast<NativeFunction<_CBLDart_AsyncCallback_CallForTest_C>>()
+      .asFunction<_CBLDart_AsyncCallback_CallForTest>(isLeaf: useIsLeaf);
 
   late final _finalizer = NativeFinalizer(_deletePtr.cast());
 
@@ -84,6 +102,17 @@ final class AsyncCallbackBindings extends Bindings {
     _close(callback);
   }
 
+  void enableBatching(
+    Pointer<CBLDartAsyncCallback> callback,
+    int maxBatchSize,
+  ) {
+    _enableBatching(callback, maxBatchSize);
+  }
+
+  void batchDelivered(Pointer<CBLDartAsyncCallback> callback) {
+    _batchDelivered(callback);
+  }
+
   void callForTest(Pointer<CBLDartAsyncCallback> callback, int result) {
     _callForTest(callback, result);
   }
@@ -1,5 +1,5 @@
 // ignore: lines_longer_than_80_chars
-// ignore_for_file: avoid_redundant_argument_values, camel_case_types, avoid_private_typedef_functions
+// ignore_for_file: avoid_redundant_argument_values, camel_case_types, avoid_private_typedef_functions, non_constant_identifier_names
 
 import 'dart:ffi';
 import 'dart:io' as io;
@@ -62,14 +62,46 @@ extension on int {
   }
 }
 
+/// The version of the layout of [CBLDart_FunctionTable] these bindings
+/// expect.
+const _functionTableVersion = 1;
+
+/// The functions which every isolate needs during startup, as returned by
+/// `CBLDart_Initialize`.
+///
+/// The fields must be declared in the same order as in the native struct.
+final class CBLDart_FunctionTable extends Struct {
+  @Uint32()
+  external int version;
+
+  // Base
+  external Pointer<Void> CBL_Retain;
+  external Pointer<Void> CBL_Release;
+  external Pointer<Void> CBLError_Message;
+  external Pointer<Void> CBLListener_Remove;
+  external Pointer<Void> CBLDart_Stats_Snapshot;
+  external Pointer<Void> CBLDart_Timeline_Enable;
+  external Pointer<Void> CBLDart_Timeline_Disable;
+
+  // Async Callbacks
+  external Pointer<Void> CBLDart_AsyncCallback_New;
+  external Pointer<Void> CBLDart_AsyncCallback_Delete;
+  external Pointer<Void> CBLDart_AsyncCallback_Close;
+  external Pointer<Void> CBLDart_AsyncCallback_EnableBatching;
+  external Pointer<Void> CBLDart_AsyncCallback_BatchDelivered;
+  external Pointer<Void> CBLDart_AsyncCallback_CallForTest;
+}
+
 typedef _CBLDart_Initialize_C = Uint8 Function(
   Pointer<Void> dartInitializeDlData,
   Pointer<Void> cblInitContext,
+  Pointer<Pointer<CBLDart_FunctionTable>> functionTableOut,
   Pointer<CBLError> errorOut,
 );
 typedef _CBLDart_Initialize = int Function(
   Pointer<Void> dartInitializeDlData,
   Pointer<Void> cblInitContext,
+  Pointer<Pointer<CBLDart_FunctionTable>> functionTableOut,
   Pointer<CBLError> errorOut,
 );
 
@@ -302,6 +334,61 @@ extension CheckCBLErrorBoolExt on bool {
   }
 }
 
+// === Stats ===================================================================
+
+/// The number of buckets of a [CBLDart_LatencyHistogram].
+const cblDartLatencyHistogramBuckets = 24;
+
+final class CBLDart_LatencyHistogram extends Struct {
+  @Uint64()
+  external int count;
+
+  @Uint64()
+  external int totalMicros;
+
+  @Uint64()
+  external int maxMicros;
+
+  @Array(cblDartLatencyHistogramBuckets)
+  external Array<Uint64> buckets;
+}
+
+final class CBLDart_Stats extends Struct {
+  @Uint64()
+  external int asyncCallbackCalls;
+
+  external CBLDart_LatencyHistogram blockingAsyncCallbackCalls;
+
+  @Uint64()
+  external int listenerInvocations;
+
+  @Uint64()
+  external int logCallbackMessages;
+
+  @Uint64()
+  external int blobBytesRead;
+
+  @Uint64()
+  external int databaseLockAcquisitions;
+
+  external CBLDart_LatencyHistogram databaseLockWaits;
+}
+
+typedef _CBLDart_Stats_Snapshot_C = Void Function(
+  Pointer<CBLDart_Stats> statsOut,
+);
+typedef _CBLDart_Stats_Snapshot = void Function(
+  Pointer<CBLDart_Stats> statsOut,
+);
+
+// === Timeline ================================================================
+
+typedef _CBLDart_Timeline_Enable_C = Bool Function();
+typedef _CBLDart_Timeline_Enable = bool Function();
+
+typedef _CBLDart_Timeline_Disable_C = Void Function();
+typedef _CBLDart_Timeline_Disable = void Function();
+
 // === CBLRefCounted ===========================================================
 
 final class CBLRefCounted extends Opaque {}
@@ -334,36 +421,56 @@ final class BaseBindings extends Bindings {
       'CBLDart_Initialize',
       isLeaf: useIsLeaf,
     );
-
-    _retainRefCounted = libs.cbl.lookupFunction<_CBL_Retain, _CBL_Retain>(
-      'CBL_Retain',
-      isLeaf: useIsLeaf,
-    );
-    _releaseRefCountedPtr =
-        libs.cbl.lookup<NativeFunction<_CBL_Release>>('CBL_Release');
-    _releaseRefCounted = _releaseRefCountedPtr.asFunction(isLeaf: useIsLeaf);
-    _getErrorMessage =
-        libs.cbl.lookupFunction<_CBLError_Message, _CBLError_Message>(
-      'CBLError_Message',
-      isLeaf: useIsLeaf,
-    );
-    _removeListener =
-        libs.cbl.lookupFunction<_CBLListener_Remove_C, _CBLListener_Remove>(
-      'CBLListener_Remove',
-      isLeaf: useIsLeaf,
-    );
   }
 
   late final _CBLDart_Initialize _initialize;
-  late final _CBL_Retain _retainRefCounted;
-  late final Pointer<NativeFunction<_CBL_Release>> _releaseRefCountedPtr;
-  late final _CBL_Release _releaseRefCounted;
-  late final _CBLError_Message _getErrorMessage;
-  late final _CBLListener_Remove _removeListener;
+
+  Pointer<CBLDart_FunctionTable>? _functionTable;
+
+  /// The function table returned by `CBLDart_Initialize`.
+  ///
+  /// The functions in the table are bound lazily, from this table instead of
+  /// by looking up their symbols.
+  CBLDart_FunctionTable get functionTable {
+    final functionTable = _functionTable;
+    if (functionTable == null) {
+      throw StateError('The native libraries have not been initialized.');
+    }
+    return functionTable.ref;
+  }
+
+  late final _retainRefCounted = functionTable.CBL_Retain
+      .cast<NativeFunction<_CBL_Retain>>()
+      .asFunction<_CBL_Retain>(isLeaf: useIsLeaf);
+  late final _releaseRefCountedPtr =
+      functionTable.CBL_Release.cast<NativeFunction<_CBL_Release>>();
+  late final _releaseRefCounted =
+      _releaseRefCountedPtr.asFunction<_CBL_Release>(isLeaf: useIsLeaf);
+  late final _getErrorMessage = functionTable.CBLError_Message
+      .cast<NativeFunction<_CBLError_Message>>()
+      .asFunction<_CBLError_Message>(isLeaf: useIsLeaf);
+  late final _removeListener = functionTable.CBLListener_Remove
+      .cast<NativeFunction<_CBLListener_Remove_C>>()
+      .asFunction<_CBLListener_Remove>(isLeaf: useIsLeaf);
+  late final _statsSnapshot = functionTable.CBLDart_Stats_Snapshot
+      .cast<NativeFunction<_CBLDart_Stats_Snapshot_C>>()
+      .asFunction<_CBLDart_Stats_Snapshot>(isLeaf: useIsLeaf);
+  late final _enableTimeline = functionTable.CBLDart_Timeline_Enable
+      .cast<NativeFunction<_CBLDart_Timeline_Enable_C>>()
+      .asFunction<_CBLDart_Timeline_Enable>(isLeaf: useIsLeaf);
+  late final _disableTimeline = functionTable.CBLDart_Timeline_Disable
+      .cast<NativeFunction<_CBLDart_Timeline_Disable_C>>()
+      .asFunction<_CBLDart_Timeline_Disable>(isLeaf: useIsLeaf);
+
+  /// The buffer into which stats are copied, so that taking a snapshot does
+  /// not allocate native memory.
+  late final _statsBuffer = malloc<CBLDart_Stats>();
 
   late final _refCountedFinalizer =
       NativeFinalizer(_releaseRefCountedPtr.cast());
 
+  /// Initializes the native libraries, if that has not already been done by
+  /// another isolate, and binds the function table for this isolate.
   void initializeNativeLibraries([CBLInitContext? context]) {
     assert(!io.Platform.isAndroid || context != null);
 
@@ -379,15 +486,26 @@ final class BaseBindings extends Bindings {
       // The `globalCBLError` cannot be used at this point because it requires
       // initialization to be completed.
       final error = zoneArena<CBLError>();
+      final functionTable = zoneArena<Pointer<CBLDart_FunctionTable>>();
 
       final initializeResult = _initialize(
         NativeApi.initializeApiDLData,
         contextStruct.cast(),
+        functionTable,
         error,
       ).toCBLDartInitializeResult();
 
       switch (initializeResult) {
         case _CBLDartInitializeResult.success:
+          if (functionTable.value.ref.version != _functionTableVersion) {
+            throw CBLErrorException(
+              CBLErrorDomain.couchbaseLite,
+              CBLErrorCode.unsupported,
+              'The native library libcblitedart is incompatible with these '
+              'bindings.',
+            );
+          }
+          _functionTable = functionTable.value;
           return;
         case _CBLDartInitializeResult.incompatibleDartVM:
           throw CBLErrorException(
@@ -422,4 +540,13 @@ final class BaseBindings extends Bindings {
   void removeListener(Pointer<CBLListenerToken> token) {
     _removeListener(token);
   }
+
+  CBLDart_Stats statsSnapshot() {
+    _statsSnapshot(_statsBuffer);
+    return _statsBuffer.ref;
+  }
+
+  bool enableTimeline() => _enableTimeline();
+
+  void disableTimeline() => _disableTimeline();
 }
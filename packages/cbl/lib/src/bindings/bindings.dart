@@ -31,16 +31,13 @@ final class CBLBindings extends Bindings {
   CBLBindings(LibrariesConfiguration config)
       : super.root(DynamicLibraries.fromConfig(config)) {
     base = BaseBindings(this);
-    asyncCallback = AsyncCallbackBindings(this);
-    logging = LoggingBindings(this);
+    asyncCallback = AsyncCallbackBindings(this, base);
     database = DatabaseBindings(this);
     collection = CollectionBindings(this);
     document = DocumentBindings(this);
     mutableDocument = MutableDocumentBindings(this);
     query = QueryBindings(this);
     resultSet = ResultSetBindings(this);
-    blobs = BlobsBindings(this);
-    replicator = ReplicatorBindings(this);
     fleece = FleeceBindings(this);
   }
 
@@ -72,16 +69,19 @@ final class CBLBindings extends Bindings {
 
   late final BaseBindings base;
   late final AsyncCallbackBindings asyncCallback;
-  late final LoggingBindings logging;
   late final DatabaseBindings database;
   late final CollectionBindings collection;
   late final DocumentBindings document;
   late final MutableDocumentBindings mutableDocument;
   late final QueryBindings query;
   late final ResultSetBindings resultSet;
-  late final BlobsBindings blobs;
-  late final ReplicatorBindings replicator;
   late final FleeceBindings fleece;
+
+  // Groups of bindings which are rarely used, or only later on, are bound on
+  // first use, so that their symbols are not looked up during startup.
+  late final LoggingBindings logging = LoggingBindings(this);
+  late final BlobsBindings blobs = BlobsBindings(this);
+  late final ReplicatorBindings replicator = ReplicatorBindings(this);
 }
 
 set _onTracedCall(TracedCallHandler value) => onTracedCall = value;
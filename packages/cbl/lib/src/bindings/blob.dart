@@ -1,8 +1,13 @@
 // ignore: lines_longer_than_80_chars
 // ignore_for_file: avoid_redundant_argument_values, avoid_private_typedef_functions, camel_case_types
 
+import 'dart:convert';
 import 'dart:ffi';
+import 'dart:typed_data';
 
+import 'package:ffi/ffi.dart';
+
+import 'async_callback.dart';
 import 'base.dart';
 import 'bindings.dart';
 import 'data.dart';
@@ -10,6 +15,7 @@ import 'database.dart';
 import 'fleece.dart';
 import 'global.dart';
 import 'slice.dart';
+import 'tracing.dart';
 import 'utils.dart';
 
 // === CBLBlob =================================================================
@@ -49,6 +55,136 @@ typedef _FLSlot_SetBlob = void Function(
   Pointer<CBLBlob> blob,
 );
 
+typedef _CBLDart_CBLBlob_CreateFromFile_C = Void Function(
+  Pointer<CBLDatabase> db,
+  FLString path,
+  FLString contentType,
+  Pointer<CBLDartAsyncCallback> callback,
+);
+typedef _CBLDart_CBLBlob_CreateFromFile = void Function(
+  Pointer<CBLDatabase> db,
+  FLString path,
+  FLString contentType,
+  Pointer<CBLDartAsyncCallback> callback,
+);
+
+typedef _CBLDart_CBLBlob_WriteToFile_C = Void Function(
+  Pointer<CBLDatabase> db,
+  Pointer<CBLBlob> blob,
+  FLString path,
+  Pointer<CBLDartAsyncCallback> callback,
+);
+typedef _CBLDart_CBLBlob_WriteToFile = void Function(
+  Pointer<CBLDatabase> db,
+  Pointer<CBLBlob> blob,
+  FLString path,
+  Pointer<CBLDartAsyncCallback> callback,
+);
+
+typedef _CBLDart_BlobCache_Get = FLSliceResult Function(
+  Pointer<CBLDatabase> db,
+  FLString digest,
+);
+
+typedef _CBLDart_BlobCache_Put_C = Void Function(
+  Pointer<CBLDatabase> db,
+  FLString digest,
+  FLSlice content,
+);
+typedef _CBLDart_BlobCache_Put = void Function(
+  Pointer<CBLDatabase> db,
+  FLString digest,
+  FLSlice content,
+);
+
+typedef _CBLDart_BlobCache_SetLimits_C = Void Function(
+  Size maxSize,
+  Size maxEntrySize,
+);
+typedef _CBLDart_BlobCache_SetLimits = void Function(
+  int maxSize,
+  int maxEntrySize,
+);
+
+final class CBLDart_BlobCacheStats extends Struct {
+  @Uint64()
+  external int hits;
+
+  @Uint64()
+  external int misses;
+
+  @Uint64()
+  external int evictions;
+
+  @Size()
+  external int size;
+
+  @Size()
+  external int maxSize;
+
+  @Size()
+  external int maxEntrySize;
+}
+
+typedef _CBLDart_BlobCache_Stats = CBLDart_BlobCacheStats Function();
+
+typedef _CBLDart_CBLDatabase_SaveBlob_C = Bool Function(
+  Pointer<CBLDatabase> db,
+  Pointer<CBLBlob> blob,
+  Pointer<CBLError> errorOut,
+);
+typedef _CBLDart_CBLDatabase_SaveBlob = bool Function(
+  Pointer<CBLDatabase> db,
+  Pointer<CBLBlob> blob,
+  Pointer<CBLError> errorOut,
+);
+
+final class CBLDart_BlobDeduplicationStats extends Struct {
+  @Uint64()
+  external int writes;
+
+  @Uint64()
+  external int deduplications;
+
+  @Uint64()
+  external int deduplicatedSize;
+}
+
+typedef _CBLDart_BlobDeduplication_Stats = CBLDart_BlobDeduplicationStats
+    Function();
+
+/// The message which is sent to the callback of a native copy of a file into
+/// or out of a blob, once the copy has completed.
+final class BlobFileCopyCallbackMessage {
+  BlobFileCopyCallbackMessage(this.blob, this.error);
+
+  BlobFileCopyCallbackMessage.fromArguments(List<Object?> arguments)
+      : this(
+          arguments.length == 1
+              ? (arguments[0] as int?)?.toPointer<CBLBlob>()
+              : null,
+          _parseError(arguments),
+        );
+
+  static CBLErrorException? _parseError(List<Object?> arguments) {
+    if (arguments.length == 1) {
+      return null;
+    }
+
+    final domain = (arguments[0] as int).toErrorDomain();
+    final code = (arguments[1] as int).toErrorCode(domain);
+    final message =
+        utf8.decode(arguments[2] as Uint8List, allowMalformed: true);
+    return CBLErrorException(domain, code, message);
+  }
+
+  /// The blob which has been created from a file, which must be released by
+  /// the receiver.
+  final Pointer<CBLBlob>? blob;
+
+  final CBLErrorException? error;
+}
+
 final class BlobBindings extends Bindings {
   BlobBindings(super.parent) {
     _createWithData = libs.cbl
@@ -90,6 +226,46 @@ final class BlobBindings extends Bindings {
       'FLSlot_SetBlob',
       isLeaf: useIsLeaf,
     );
+    _createFromFile = libs.cblDart.lookupFunction<
+        _CBLDart_CBLBlob_CreateFromFile_C, _CBLDart_CBLBlob_CreateFromFile>(
+      'CBLDart_CBLBlob_CreateFromFile',
+      isLeaf: useIsLeaf,
+    );
+    _writeToFile = libs.cblDart.lookupFunction<_CBLDart_CBLBlob_WriteToFile_C,
+        _CBLDart_CBLBlob_WriteToFile>(
+      'CBLDart_CBLBlob_WriteToFile',
+      isLeaf: useIsLeaf,
+    );
+    _cacheGet = libs.cblDart
+        .lookupFunction<_CBLDart_BlobCache_Get, _CBLDart_BlobCache_Get>(
+      'CBLDart_BlobCache_Get',
+      isLeaf: useIsLeaf,
+    );
+    _cachePut = libs.cblDart
+        .lookupFunction<_CBLDart_BlobCache_Put_C, _CBLDart_BlobCache_Put>(
+      'CBLDart_BlobCache_Put',
+      isLeaf: useIsLeaf,
+    );
+    _setCacheLimits = libs.cblDart.lookupFunction<
+        _CBLDart_BlobCache_SetLimits_C, _CBLDart_BlobCache_SetLimits>(
+      'CBLDart_BlobCache_SetLimits',
+      isLeaf: useIsLeaf,
+    );
+    _cacheStats = libs.cblDart
+        .lookupFunction<_CBLDart_BlobCache_Stats, _CBLDart_BlobCache_Stats>(
+      'CBLDart_BlobCache_Stats',
+      isLeaf: useIsLeaf,
+    );
+    _saveDeduplicated = libs.cblDart.lookupFunction<
+        _CBLDart_CBLDatabase_SaveBlob_C, _CBLDart_CBLDatabase_SaveBlob>(
+      'CBLDart_CBLDatabase_SaveBlob',
+      isLeaf: useIsLeaf,
+    );
+    _deduplicationStats = libs.cblDart.lookupFunction<
+        _CBLDart_BlobDeduplication_Stats, _CBLDart_BlobDeduplication_Stats>(
+      'CBLDart_BlobDeduplication_Stats',
+      isLeaf: useIsLeaf,
+    );
   }
 
   late final _CBLBlob_CreateWithData _createWithData;
@@ -101,6 +277,14 @@ final class BlobBindings extends Bindings {
   late final _CBLBlob_Content _content;
   late final _CBLBlob_ContentType _contentType;
   late final _CBLBlob_Properties _properties;
+  late final _CBLDart_CBLBlob_CreateFromFile _createFromFile;
+  late final _CBLDart_CBLBlob_WriteToFile _writeToFile;
+  late final _CBLDart_BlobCache_Get _cacheGet;
+  late final _CBLDart_BlobCache_Put _cachePut;
+  late final _CBLDart_BlobCache_SetLimits _setCacheLimits;
+  late final _CBLDart_BlobCache_Stats _cacheStats;
+  late final _CBLDart_CBLDatabase_SaveBlob _saveDeduplicated;
+  late final _CBLDart_BlobDeduplication_Stats _deduplicationStats;
 
   Pointer<CBLBlob> createWithData(String? contentType, Data content) =>
       runWithSingleFLString(
@@ -132,6 +316,61 @@ final class BlobBindings extends Bindings {
       _contentType(blob).toDartString();
 
   Pointer<FLDict> properties(Pointer<CBLBlob> blob) => _properties(blob);
+
+  void createFromFile(
+    Pointer<CBLDatabase> db,
+    String path,
+    String? contentType,
+    Pointer<CBLDartAsyncCallback> callback,
+  ) {
+    withGlobalArena(() => _createFromFile(
+          db,
+          path.toFLString(),
+          contentType.toFLString(),
+          callback,
+        ));
+  }
+
+  void writeToFile(
+    Pointer<CBLDatabase> db,
+    Pointer<CBLBlob> blob,
+    String path,
+    Pointer<CBLDartAsyncCallback> callback,
+  ) {
+    runWithSingleFLString(path, (flPath) {
+      _writeToFile(db, blob, flPath, callback);
+    });
+  }
+
+  Data? cachedContent(Pointer<CBLDatabase> db, String digest) =>
+      runWithSingleFLString(
+        digest,
+        (flDigest) => _cacheGet(db, flDigest),
+      ).let(SliceResult.fromFLSliceResult)?.toData();
+
+  void cacheContent(Pointer<CBLDatabase> db, String digest, Data content) {
+    runWithSingleFLString(digest, (flDigest) {
+      final sliceResult = content.toSliceResult();
+      _cachePut(db, flDigest, sliceResult.makeGlobal().ref);
+    });
+  }
+
+  void setCacheLimits({required int maxSize, required int maxEntrySize}) =>
+      _setCacheLimits(maxSize, maxEntrySize);
+
+  CBLDart_BlobCacheStats cacheStats() => _cacheStats();
+
+  /// Saves [blob], which has been created with [createWithData], into [db],
+  /// without writing its content if a blob with the same digest already
+  /// exists.
+  void saveDeduplicated(Pointer<CBLDatabase> db, Pointer<CBLBlob> blob) {
+    nativeCallTracePoint(
+      TracedNativeCall.databaseSaveBlobDeduplicated,
+      () => _saveDeduplicated(db, blob, globalCBLError),
+    ).checkCBLError();
+  }
+
+  CBLDart_BlobDeduplicationStats deduplicationStats() => _deduplicationStats();
 }
 
 // === CBLBlobReadStream =======================================================
@@ -143,14 +382,29 @@ typedef _CBLBlob_OpenContentStream = Pointer<CBLBlobReadStream> Function(
   Pointer<CBLError> errorOut,
 );
 
-typedef _CBLDart_CBLBlobReader_Read_C = FLSliceResult Function(
+typedef _CBLBlobReader_Read_C = Int Function(
   Pointer<CBLBlobReadStream> stream,
-  Uint64 bufferSize,
+  Pointer<Uint8> dst,
+  Size maxLength,
   Pointer<CBLError> errorOut,
 );
-typedef _CBLDart_CBLBlobReader_Read = FLSliceResult Function(
+typedef _CBLBlobReader_Read = int Function(
   Pointer<CBLBlobReadStream> stream,
-  int bufferSize,
+  Pointer<Uint8> dst,
+  int maxLength,
+  Pointer<CBLError> errorOut,
+);
+
+typedef _CBLBlobReader_Seek_C = Int64 Function(
+  Pointer<CBLBlobReadStream> stream,
+  Int64 offset,
+  Uint8 base,
+  Pointer<CBLError> errorOut,
+);
+typedef _CBLBlobReader_Seek = int Function(
+  Pointer<CBLBlobReadStream> stream,
+  int offset,
+  int base,
   Pointer<CBLError> errorOut,
 );
 
@@ -165,16 +419,20 @@ final class BlobReadStreamBindings extends Bindings {
       'CBLBlob_OpenContentStream',
       isLeaf: useIsLeaf,
     );
-    _read = libs.cblDart.lookupFunction<_CBLDart_CBLBlobReader_Read_C,
-        _CBLDart_CBLBlobReader_Read>(
-      'CBLDart_CBLBlobReader_Read',
+    _read = libs.cbl.lookupFunction<_CBLBlobReader_Read_C, _CBLBlobReader_Read>(
+      'CBLBlobReader_Read',
+      isLeaf: useIsLeaf,
+    );
+    _seek = libs.cbl.lookupFunction<_CBLBlobReader_Seek_C, _CBLBlobReader_Seek>(
+      'CBLBlobReader_Seek',
       isLeaf: useIsLeaf,
     );
     _closePtr = libs.cbl.lookup('CBLBlobReader_Close');
   }
 
   late final _CBLBlob_OpenContentStream _openContentStream;
-  late final _CBLDart_CBLBlobReader_Read _read;
+  late final _CBLBlobReader_Read _read;
+  late final _CBLBlobReader_Seek _seek;
   late final Pointer<NativeFunction<_CBLBlobReader_Close_C>> _closePtr;
 
   late final _finalizer = NativeFinalizer(_closePtr.cast());
@@ -189,18 +447,130 @@ final class BlobReadStreamBindings extends Bindings {
     _finalizer.attach(object, pointer.cast());
   }
 
-  Data? read(Pointer<CBLBlobReadStream> stream, int bufferSize) {
-    final buffer = _read(stream, bufferSize, globalCBLError);
+  /// The maximum number of bytes which [read] reads at once.
+  static const maxChunkSize = 1024 * 1024;
 
-    // A null slice signals an error.
-    if (buffer.buf == nullptr) {
+  /// The buffer into which all chunks are read, before they are copied into
+  /// the Dart heap, so that reading a chunk does not allocate native memory.
+  late final _chunkBuffer = malloc<Uint8>(maxChunkSize);
+
+  /// Reads the next chunk of up to [maxLength] bytes from [stream], or returns
+  /// `null` if the stream has been fully read.
+  Uint8List? read(Pointer<CBLBlobReadStream> stream, int maxLength) {
+    assert(maxLength <= maxChunkSize);
+    final bytesRead = _read(stream, _chunkBuffer, maxLength, globalCBLError);
+
+    // A negative result signals an error.
+    if (bytesRead < 0) {
+      throwCBLError();
+    }
+
+    if (bytesRead == 0) {
+      return null;
+    }
+    return Uint8List.fromList(_chunkBuffer.asTypedList(bytesRead));
+  }
+
+  /// Moves the position of [stream] to [offset] bytes from the start of the
+  /// content.
+  void seek(Pointer<CBLBlobReadStream> stream, int offset) {
+    // 0 is kCBLSeekModeFromStart.
+    if (_seek(stream, offset, 0, globalCBLError) < 0) {
       throwCBLError();
     }
+  }
+}
+
+// === CBLDart_BlobReadAhead ==================================================
+
+final class CBLDart_BlobReadAhead extends Opaque {}
 
-    // Empty buffer means stream has been fully read, but its important to
-    // create a SliceResult to ensure the the FLSliceResult is freed.
-    final sliceResult = SliceResult.fromFLSliceResult(buffer)!;
-    return sliceResult.size == 0 ? null : sliceResult.toData();
+typedef _CBLDart_CBLBlob_ReadAhead_C = Pointer<CBLDart_BlobReadAhead> Function(
+  Pointer<CBLDatabase> db,
+  Pointer<CBLBlob> blob,
+  Uint64 start,
+  Int64 end,
+  Size chunkSize,
+  Size chunkCount,
+  Pointer<CBLDartAsyncCallback> callback,
+);
+typedef _CBLDart_CBLBlob_ReadAhead = Pointer<CBLDart_BlobReadAhead> Function(
+  Pointer<CBLDatabase> db,
+  Pointer<CBLBlob> blob,
+  int start,
+  int end,
+  int chunkSize,
+  int chunkCount,
+  Pointer<CBLDartAsyncCallback> callback,
+);
+
+typedef _CBLDart_BlobReadAhead_Next_C = Uint8 Function(
+  Pointer<CBLDart_BlobReadAhead> readAhead,
+  Pointer<FLSliceResult> chunkOut,
+  Pointer<CBLError> errorOut,
+);
+typedef _CBLDart_BlobReadAhead_Next = int Function(
+  Pointer<CBLDart_BlobReadAhead> readAhead,
+  Pointer<FLSliceResult> chunkOut,
+  Pointer<CBLError> errorOut,
+);
+
+final class BlobReadAheadBindings extends Bindings {
+  BlobReadAheadBindings(super.parent) {
+    _readAhead = libs.cblDart.lookupFunction<_CBLDart_CBLBlob_ReadAhead_C,
+        _CBLDart_CBLBlob_ReadAhead>(
+      'CBLDart_CBLBlob_ReadAhead',
+      isLeaf: useIsLeaf,
+    );
+    _next = libs.cblDart.lookupFunction<_CBLDart_BlobReadAhead_Next_C,
+        _CBLDart_BlobReadAhead_Next>(
+      'CBLDart_BlobReadAhead_Next',
+      isLeaf: useIsLeaf,
+    );
+  }
+
+  late final _CBLDart_CBLBlob_ReadAhead _readAhead;
+  late final _CBLDart_BlobReadAhead_Next _next;
+
+  // Values of CBLDart_BlobReadAheadResult.
+  static const _chunk = 0;
+  static const _pending = 1;
+  static const _done = 2;
+
+  /// Starts reading the content of [blob] from [start] up to [end], or to the
+  /// end of the content, on a background thread, keeping up to [chunkCount]
+  /// chunks of up to [chunkSize] bytes buffered.
+  ///
+  /// The read-ahead stays valid until [callback] is closed.
+  Pointer<CBLDart_BlobReadAhead> start(
+    Pointer<CBLDatabase> db,
+    Pointer<CBLBlob> blob, {
+    required int start,
+    required int? end,
+    required int chunkSize,
+    required int chunkCount,
+    required Pointer<CBLDartAsyncCallback> callback,
+  }) =>
+      _readAhead(db, blob, start, end ?? -1, chunkSize, chunkCount, callback);
+
+  /// Takes the next chunk which has been read ahead by [readAhead], without
+  /// copying it.
+  ///
+  /// Returns `null` if the next chunk has not been read yet, in which case
+  /// the callback of [readAhead] is called once it has been read. Returns an
+  /// empty [Data] once all chunks have been taken.
+  Data? next(Pointer<CBLDart_BlobReadAhead> readAhead) {
+    switch (_next(readAhead, globalFLSliceResult, globalCBLError)) {
+      case _chunk:
+        final chunk = SliceResult.fromFLSliceResult(globalFLSliceResult.ref)!;
+        return Data.fromTypedList(chunk.asTypedList());
+      case _pending:
+        return null;
+      case _done:
+        return Data.fromTypedList(Uint8List(0));
+      default:
+        throwCBLError();
+    }
   }
 }
 
@@ -296,10 +666,12 @@ final class BlobsBindings extends Bindings {
   BlobsBindings(super.parent) {
     blob = BlobBindings(this);
     readStream = BlobReadStreamBindings(this);
+    readAhead = BlobReadAheadBindings(this);
     writeStream = BlobWriteStreamBindings(this);
   }
 
   late final BlobBindings blob;
   late final BlobReadStreamBindings readStream;
+  late final BlobReadAheadBindings readAhead;
   late final BlobWriteStreamBindings writeStream;
 }
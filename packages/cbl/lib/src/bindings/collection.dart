@@ -8,10 +8,12 @@ import 'dart:typed_data';
 import 'async_callback.dart';
 import 'base.dart';
 import 'bindings.dart';
+import 'data.dart';
 import 'database.dart';
 import 'document.dart';
 import 'fleece.dart';
 import 'global.dart';
+import 'native_utf8_string.dart';
 import 'query.dart';
 import 'tracing.dart';
 import 'utils.dart';
@@ -93,14 +95,24 @@ typedef _CBLCollection_Count = int Function(
   Pointer<CBLCollection> collection,
 );
 
-typedef _CBLCollection_GetDocument_C = Pointer<CBLDocument> Function(
+typedef _CBLDart_CBLCollection_GetDocument = Pointer<CBLDocument> Function(
   Pointer<CBLCollection> collection,
   FLString docId,
   Pointer<CBLError> errorOut,
 );
-typedef _CBLCollection_GetDocument = Pointer<CBLDocument> Function(
+
+typedef _CBLDart_CBLCollection_GetDocuments_C = Bool Function(
   Pointer<CBLCollection> collection,
-  FLString docId,
+  Pointer<FLString> docIds,
+  Size count,
+  Pointer<Pointer<CBLDocument>> documentsOut,
+  Pointer<CBLError> errorOut,
+);
+typedef _CBLDart_CBLCollection_GetDocuments = bool Function(
+  Pointer<CBLCollection> collection,
+  Pointer<FLString> docIds,
+  int count,
+  Pointer<Pointer<CBLDocument>> documentsOut,
   Pointer<CBLError> errorOut,
 );
 
@@ -117,6 +129,38 @@ typedef _CBLCollection_SaveDocumentWithConcurrencyControl = bool Function(
   Pointer<CBLError> errorOut,
 );
 
+typedef _CBLDart_CBLCollection_SaveDocuments_C = Bool Function(
+  Pointer<CBLCollection> collection,
+  Pointer<Pointer<CBLMutableDocument>> documents,
+  Size count,
+  Uint8 concurrency,
+  Pointer<Uint8> resultsOut,
+  Pointer<CBLError> errorOut,
+);
+typedef _CBLDart_CBLCollection_SaveDocuments = bool Function(
+  Pointer<CBLCollection> collection,
+  Pointer<Pointer<CBLMutableDocument>> documents,
+  int count,
+  int concurrency,
+  Pointer<Uint8> resultsOut,
+  Pointer<CBLError> errorOut,
+);
+
+typedef _CBLDart_CBLCollection_PatchDocument_C = Bool Function(
+  Pointer<CBLCollection> collection,
+  FLString docId,
+  FLSlice patch,
+  Uint8 concurrency,
+  Pointer<CBLError> errorOut,
+);
+typedef _CBLDart_CBLCollection_PatchDocument = bool Function(
+  Pointer<CBLCollection> collection,
+  FLString docId,
+  FLSlice patch,
+  int concurrency,
+  Pointer<CBLError> errorOut,
+);
+
 typedef _CBLCollection_DeleteDocumentWithConcurrencyControl_C = Bool Function(
   Pointer<CBLCollection> db,
   Pointer<CBLDocument> document,
@@ -152,19 +196,48 @@ typedef _CBLCollection_GetDocumentExpiration = int Function(
   Pointer<CBLError> errorOut,
 );
 
-typedef _CBLCollection_SetDocumentExpiration_C = Bool Function(
+typedef _CBLDart_CBLCollection_SetDocumentExpiration_C = Bool Function(
   Pointer<CBLCollection> db,
   FLString docId,
   Int64 expiration,
   Pointer<CBLError> errorOut,
 );
-typedef _CBLCollection_SetDocumentExpiration = bool Function(
+typedef _CBLDart_CBLCollection_SetDocumentExpiration = bool Function(
   Pointer<CBLCollection> db,
   FLString docId,
   int expiration,
   Pointer<CBLError> errorOut,
 );
 
+typedef _CBLDart_CBLCollection_SetDocumentExpirations_C = Bool Function(
+  Pointer<CBLCollection> collection,
+  Pointer<FLString> docIds,
+  Pointer<Int64> expirations,
+  Size count,
+  Pointer<CBLError> errorOut,
+);
+typedef _CBLDart_CBLCollection_SetDocumentExpirations = bool Function(
+  Pointer<CBLCollection> collection,
+  Pointer<FLString> docIds,
+  Pointer<Int64> expirations,
+  int count,
+  Pointer<CBLError> errorOut,
+);
+
+final class CBLDart_ExpirationStats extends Struct {
+  @Uint64()
+  external int purgedCount;
+
+  @Uint64()
+  external int pendingCount;
+
+  @Int64()
+  external int nextExpiration;
+}
+
+typedef _CBLDart_CBLCollection_ExpirationStats = CBLDart_ExpirationStats
+    Function(Pointer<CBLCollection> collection);
+
 typedef _CBLCollection_GetIndexNames = Pointer<FLArray> Function(
   Pointer<CBLCollection> collection,
 );
@@ -200,6 +273,8 @@ final class CBLIndexSpec {
     required this.expressions,
     this.ignoreAccents,
     this.language,
+    this.path,
+    this.vector,
   });
 
   final CBLIndexType type;
@@ -207,17 +282,78 @@ final class CBLIndexSpec {
   final String expressions;
   final bool? ignoreAccents;
   final String? language;
+  final String? path;
+  final CBLVectorIndexSpec? vector;
 }
 
 enum CBLIndexType {
   value,
   fullText,
+  array,
+  vector,
 }
 
 extension on CBLIndexType {
   int toInt() => CBLIndexType.values.indexOf(this);
 }
 
+final class CBLVectorIndexSpec {
+  CBLVectorIndexSpec({
+    required this.dimensions,
+    required this.centroids,
+    required this.encodingType,
+    this.scalarQuantizerType,
+    this.subquantizers,
+    this.bits,
+    required this.metric,
+    this.minTrainingSize,
+    this.maxTrainingSize,
+    this.numProbes,
+  });
+
+  final int dimensions;
+  final int centroids;
+  final CBLVectorEncodingType encodingType;
+  final CBLScalarQuantizerType? scalarQuantizerType;
+  final int? subquantizers;
+  final int? bits;
+  final CBLDistanceMetric metric;
+  final int? minTrainingSize;
+  final int? maxTrainingSize;
+  final int? numProbes;
+}
+
+enum CBLVectorEncodingType {
+  none,
+  scalarQuantizer,
+  productQuantizer,
+}
+
+extension on CBLVectorEncodingType {
+  int toInt() => CBLVectorEncodingType.values.indexOf(this);
+}
+
+enum CBLScalarQuantizerType {
+  sq4(4),
+  sq6(6),
+  sq8(8);
+
+  const CBLScalarQuantizerType(this.value);
+
+  final int value;
+}
+
+enum CBLDistanceMetric {
+  euclideanSquared(1),
+  cosine(2),
+  euclidean(3),
+  dot(4);
+
+  const CBLDistanceMetric(this.value);
+
+  final int value;
+}
+
 final class _CBLDart_CBLIndexSpec extends Struct {
   @Uint8()
   // ignore: unused_field
@@ -233,11 +369,46 @@ final class _CBLDart_CBLIndexSpec extends Struct {
   external bool ignoreAccents;
 
   external FLString language;
+
+  external FLString path;
+
+  @Uint32()
+  external int dimensions;
+
+  @Uint32()
+  external int centroids;
+
+  @Uint8()
+  // ignore: unused_field
+  external int _encodingType;
+
+  @Uint32()
+  external int scalarQuantizerType;
+
+  @Uint32()
+  external int subquantizers;
+
+  @Uint32()
+  external int bits;
+
+  @Uint32()
+  external int metric;
+
+  @Uint32()
+  external int minTrainingSize;
+
+  @Uint32()
+  external int maxTrainingSize;
+
+  @Uint32()
+  external int numProbes;
 }
 
 // ignore: camel_case_extensions
 extension on _CBLDart_CBLIndexSpec {
   set type(CBLIndexType value) => _type = value.toInt();
+  set encodingType(CBLVectorEncodingType value) =>
+      _encodingType = value.toInt();
   set expressionLanguage(CBLQueryLanguage value) =>
       _expressionLanguage = value.toInt();
 }
@@ -246,12 +417,14 @@ typedef _CBLDart_CBLCollection_AddDocumentChangeListener_C = Void Function(
   Pointer<CBLDatabase> db,
   Pointer<CBLCollection> collection,
   FLString docId,
+  Uint32 debounceMilliseconds,
   Pointer<CBLDartAsyncCallback> listener,
 );
 typedef _CBLDart_CBLCollection_AddDocumentChangeListener = void Function(
   Pointer<CBLDatabase> db,
   Pointer<CBLCollection> collection,
   FLString docId,
+  int debounceMilliseconds,
   Pointer<CBLDartAsyncCallback> listener,
 );
 
@@ -266,15 +439,374 @@ typedef _CBLDart_CBLCollection_AddChangeListener = void Function(
   Pointer<CBLDartAsyncCallback> listener,
 );
 
+final class CBLDart_IndexBuilder extends Opaque {}
+
+typedef _CBLDart_CBLCollection_BuildIndex
+    = Pointer<CBLDart_IndexBuilder> Function(
+  Pointer<CBLDatabase> db,
+  Pointer<CBLCollection> collection,
+  FLString name,
+  _CBLDart_CBLIndexSpec indexSpec,
+  Pointer<CBLDartAsyncCallback> callback,
+);
+
+typedef _CBLDart_IndexBuilder_Cancel_C = Void Function(
+  Pointer<CBLDart_IndexBuilder> builder,
+);
+typedef _CBLDart_IndexBuilder_Cancel = void Function(
+  Pointer<CBLDart_IndexBuilder> builder,
+);
+
+final class CBLDart_JSONLinesImporter extends Opaque {}
+
+typedef _CBLDart_CBLCollection_ImportJSONLines_C
+    = Pointer<CBLDart_JSONLinesImporter> Function(
+  Pointer<CBLDatabase> db,
+  Pointer<CBLCollection> collection,
+  FLString idKeyPath,
+  Uint32 batchSize,
+  Pointer<CBLDartAsyncCallback> callback,
+  Pointer<CBLError> errorOut,
+);
+typedef _CBLDart_CBLCollection_ImportJSONLines
+    = Pointer<CBLDart_JSONLinesImporter> Function(
+  Pointer<CBLDatabase> db,
+  Pointer<CBLCollection> collection,
+  FLString idKeyPath,
+  int batchSize,
+  Pointer<CBLDartAsyncCallback> callback,
+  Pointer<CBLError> errorOut,
+);
+
+typedef _CBLDart_JSONLinesImporter_AddChunk_C = Void Function(
+  Pointer<CBLDart_JSONLinesImporter> importer,
+  FLSlice chunk,
+);
+typedef _CBLDart_JSONLinesImporter_AddChunk = void Function(
+  Pointer<CBLDart_JSONLinesImporter> importer,
+  FLSlice chunk,
+);
+
+typedef _CBLDart_JSONLinesImporter_AddFile_C = Void Function(
+  Pointer<CBLDart_JSONLinesImporter> importer,
+  FLString path,
+);
+typedef _CBLDart_JSONLinesImporter_AddFile = void Function(
+  Pointer<CBLDart_JSONLinesImporter> importer,
+  FLString path,
+);
+
+typedef _CBLDart_JSONLinesImporter_Finish_C = Void Function(
+  Pointer<CBLDart_JSONLinesImporter> importer,
+  Bool cancel,
+);
+typedef _CBLDart_JSONLinesImporter_Finish = void Function(
+  Pointer<CBLDart_JSONLinesImporter> importer,
+  bool cancel,
+);
+
+typedef _CBLDart_CBLCollection_RemoveWhere_C = Bool Function(
+  Pointer<CBLDatabase> db,
+  Pointer<CBLCollection> collection,
+  FLString predicate,
+  Uint32 batchSize,
+  Pointer<CBLDartAsyncCallback> callback,
+  Pointer<CBLError> errorOut,
+);
+typedef _CBLDart_CBLCollection_RemoveWhere = bool Function(
+  Pointer<CBLDatabase> db,
+  Pointer<CBLCollection> collection,
+  FLString predicate,
+  int batchSize,
+  Pointer<CBLDartAsyncCallback> callback,
+  Pointer<CBLError> errorOut,
+);
+
+typedef _CBLDart_DocumentCache_SetLimits_C = Void Function(
+  Size maxCount,
+  Size maxSize,
+);
+typedef _CBLDart_DocumentCache_SetLimits = void Function(
+  int maxCount,
+  int maxSize,
+);
+
+final class CBLDart_DocumentCacheStats extends Struct {
+  @Uint64()
+  external int hits;
+
+  @Uint64()
+  external int misses;
+
+  @Uint64()
+  external int evictions;
+
+  @Uint64()
+  external int invalidations;
+
+  @Size()
+  external int count;
+
+  @Size()
+  external int size;
+
+  @Size()
+  external int maxCount;
+
+  @Size()
+  external int maxSize;
+}
+
+typedef _CBLDart_DocumentCache_Stats = CBLDart_DocumentCacheStats Function();
+
+final class CBLDart_ChangeCursor extends Opaque {}
+
+typedef _CBLDart_CBLCollection_NewChangeCursor_C
+    = Pointer<CBLDart_ChangeCursor> Function(
+  Pointer<CBLCollection> collection,
+  Uint64 sequence,
+);
+typedef _CBLDart_CBLCollection_NewChangeCursor
+    = Pointer<CBLDart_ChangeCursor> Function(
+  Pointer<CBLCollection> collection,
+  int sequence,
+);
+
+typedef _CBLDart_ChangeCursor_Next_C = FLSliceResult Function(
+  Pointer<CBLDart_ChangeCursor> cursor,
+  Uint32 maxCount,
+  Pointer<CBLError> errorOut,
+);
+typedef _CBLDart_ChangeCursor_Next = FLSliceResult Function(
+  Pointer<CBLDart_ChangeCursor> cursor,
+  int maxCount,
+  Pointer<CBLError> errorOut,
+);
+
+typedef _CBLDart_ChangeCursor_Release_C = Void Function(
+  Pointer<CBLDart_ChangeCursor> cursor,
+);
+
+final class _CBLDart_FullTextSearchOptions extends Struct {
+  external FLString indexName;
+  external FLString query;
+
+  @Uint32()
+  external int limit;
+
+  @Uint32()
+  external int offset;
+
+  external FLString snippetProperty;
+
+  @Uint32()
+  external int snippetWordCount;
+
+  external FLString matchStart;
+  external FLString matchEnd;
+  external FLString ellipsis;
+}
+
+typedef _CBLDart_CBLCollection_FullTextSearch = FLSliceResult Function(
+  Pointer<CBLCollection> collection,
+  Pointer<_CBLDart_FullTextSearchOptions> options,
+  Pointer<CBLError> errorOut,
+);
+
+final class CBLDart_DocumentOperations extends Opaque {}
+
+typedef _CBLDart_DocumentOperations_New
+    = Pointer<CBLDart_DocumentOperations> Function(
+  Pointer<CBLDatabase> db,
+  Pointer<CBLDartAsyncCallback> callback,
+);
+
+typedef _CBLDart_DocumentOperations_GetDocument_C = Void Function(
+  Pointer<CBLDart_DocumentOperations> operations,
+  Pointer<CBLCollection> collection,
+  FLString docId,
+  Int64 operationId,
+);
+typedef _CBLDart_DocumentOperations_GetDocument = void Function(
+  Pointer<CBLDart_DocumentOperations> operations,
+  Pointer<CBLCollection> collection,
+  FLString docId,
+  int operationId,
+);
+
+typedef _CBLDart_DocumentOperations_SaveDocument_C = Void Function(
+  Pointer<CBLDart_DocumentOperations> operations,
+  Pointer<CBLCollection> collection,
+  Pointer<CBLMutableDocument> doc,
+  Uint8 concurrency,
+  Int64 operationId,
+);
+typedef _CBLDart_DocumentOperations_SaveDocument = void Function(
+  Pointer<CBLDart_DocumentOperations> operations,
+  Pointer<CBLCollection> collection,
+  Pointer<CBLMutableDocument> doc,
+  int concurrency,
+  int operationId,
+);
+
+typedef _CBLDart_DocumentOperations_DeleteDocument_C = Void Function(
+  Pointer<CBLDart_DocumentOperations> operations,
+  Pointer<CBLCollection> collection,
+  Pointer<CBLDocument> doc,
+  Uint8 concurrency,
+  Int64 operationId,
+);
+typedef _CBLDart_DocumentOperations_DeleteDocument = void Function(
+  Pointer<CBLDart_DocumentOperations> operations,
+  Pointer<CBLCollection> collection,
+  Pointer<CBLDocument> doc,
+  int concurrency,
+  int operationId,
+);
+
+typedef _CBLDart_DocumentOperations_PurgeDocument_C = Void Function(
+  Pointer<CBLDart_DocumentOperations> operations,
+  Pointer<CBLCollection> collection,
+  FLString docId,
+  Int64 operationId,
+);
+typedef _CBLDart_DocumentOperations_PurgeDocument = void Function(
+  Pointer<CBLDart_DocumentOperations> operations,
+  Pointer<CBLCollection> collection,
+  FLString docId,
+  int operationId,
+);
+
+/// A message which is sent to the callback of
+/// [CollectionBindings.newDocumentOperations] when an operation has finished.
+final class DocumentOperationCallbackMessage {
+  DocumentOperationCallbackMessage(this.operationId, this.result, this.error);
+
+  DocumentOperationCallbackMessage.fromArguments(List<Object?> arguments)
+      : this(
+          arguments[0]! as int,
+          arguments[1],
+          _parseError(arguments),
+        );
+
+  static CBLErrorException? _parseError(List<Object?> arguments) {
+    if (arguments.length <= 2) {
+      return null;
+    }
+
+    final domain = (arguments[2]! as int).toErrorDomain();
+    final code = (arguments[3]! as int).toErrorCode(domain);
+    final message =
+        utf8.decode(arguments[4]! as Uint8List, allowMalformed: true);
+    return CBLErrorException(domain, code, message);
+  }
+
+  final int operationId;
+
+  /// The address of a document, or whether the operation succeeded, depending
+  /// on the operation.
+  final Object? result;
+
+  final CBLErrorException? error;
+}
+
 final class CollectionChangeCallbackMessage {
   CollectionChangeCallbackMessage(this.documentIds);
 
   CollectionChangeCallbackMessage.fromArguments(List<Object?> message)
-      : this(message.cast<Uint8List>().map(utf8.decode).toList());
+      : this(PackedStringList(message[0]! as Uint8List));
 
   final List<String> documentIds;
 }
 
+final class IndexBuildCallbackMessage {
+  IndexBuildCallbackMessage(this.isDone, this.created, this.error);
+
+  IndexBuildCallbackMessage.fromArguments(List<Object?> arguments)
+      : this(
+          arguments[0] as bool,
+          arguments.length > 1 && arguments[1] as bool,
+          _parseError(arguments),
+        );
+
+  static CBLErrorException? _parseError(List<Object?> arguments) {
+    if (arguments.length <= 2) {
+      return null;
+    }
+
+    final domain = (arguments[2] as int).toErrorDomain();
+    final code = (arguments[3] as int).toErrorCode(domain);
+    final message =
+        utf8.decode(arguments[4] as Uint8List, allowMalformed: true);
+    return CBLErrorException(domain, code, message);
+  }
+
+  final bool isDone;
+  final bool created;
+  final CBLErrorException? error;
+}
+
+final class JsonLinesImportCallbackMessage {
+  JsonLinesImportCallbackMessage(
+    this.isDone,
+    this.importedCount,
+    this.consumedInputCount,
+    this.error,
+  );
+
+  JsonLinesImportCallbackMessage.fromArguments(List<Object?> arguments)
+      : this(
+          arguments[0] as bool,
+          arguments[1] as int,
+          arguments[2] as int,
+          _parseError(arguments),
+        );
+
+  static CBLErrorException? _parseError(List<Object?> arguments) {
+    if (arguments.length <= 3) {
+      return null;
+    }
+
+    final domain = (arguments[3] as int).toErrorDomain();
+    final code = (arguments[4] as int).toErrorCode(domain);
+    final message =
+        utf8.decode(arguments[5] as Uint8List, allowMalformed: true);
+    return CBLErrorException(domain, code, message);
+  }
+
+  final bool isDone;
+  final int importedCount;
+  final int consumedInputCount;
+  final CBLErrorException? error;
+}
+
+final class RemoveWhereCallbackMessage {
+  RemoveWhereCallbackMessage(this.isDone, this.affectedCount, this.error);
+
+  RemoveWhereCallbackMessage.fromArguments(List<Object?> arguments)
+      : this(
+          arguments[0] as bool,
+          arguments[1] as int,
+          _parseError(arguments),
+        );
+
+  static CBLErrorException? _parseError(List<Object?> arguments) {
+    if (arguments.length <= 2) {
+      return null;
+    }
+
+    final domain = (arguments[2] as int).toErrorDomain();
+    final code = (arguments[3] as int).toErrorCode(domain);
+    final message =
+        utf8.decode(arguments[4] as Uint8List, allowMalformed: true);
+    return CBLErrorException(domain, code, message);
+  }
+
+  final bool isDone;
+  final int affectedCount;
+  final CBLErrorException? error;
+}
+
 final class CollectionBindings extends Bindings {
   CollectionBindings(super.parent) {
     _database_scopeNames = libs.cbl
@@ -312,9 +844,16 @@ final class CollectionBindings extends Bindings {
       'CBLCollection_Count',
       isLeaf: useIsLeaf,
     );
-    _getDocument = libs.cbl.lookupFunction<_CBLCollection_GetDocument_C,
-        _CBLCollection_GetDocument>(
-      'CBLCollection_GetDocument',
+    _getDocument = libs.cblDart.lookupFunction<
+        _CBLDart_CBLCollection_GetDocument,
+        _CBLDart_CBLCollection_GetDocument>(
+      'CBLDart_CBLCollection_GetDocument',
+      isLeaf: useIsLeaf,
+    );
+    _getDocuments = libs.cblDart.lookupFunction<
+        _CBLDart_CBLCollection_GetDocuments_C,
+        _CBLDart_CBLCollection_GetDocuments>(
+      'CBLDart_CBLCollection_GetDocuments',
       isLeaf: useIsLeaf,
     );
     _saveDocumentWithConcurrencyControl = libs.cbl.lookupFunction<
@@ -323,6 +862,18 @@ final class CollectionBindings extends Bindings {
       'CBLCollection_SaveDocumentWithConcurrencyControl',
       isLeaf: useIsLeaf,
     );
+    _saveDocuments = libs.cblDart.lookupFunction<
+        _CBLDart_CBLCollection_SaveDocuments_C,
+        _CBLDart_CBLCollection_SaveDocuments>(
+      'CBLDart_CBLCollection_SaveDocuments',
+      isLeaf: useIsLeaf,
+    );
+    _patchDocument = libs.cblDart.lookupFunction<
+        _CBLDart_CBLCollection_PatchDocument_C,
+        _CBLDart_CBLCollection_PatchDocument>(
+      'CBLDart_CBLCollection_PatchDocument',
+      isLeaf: useIsLeaf,
+    );
     _deleteDocumentWithConcurrencyControl = libs.cbl.lookupFunction<
         _CBLCollection_DeleteDocumentWithConcurrencyControl_C,
         _CBLCollection_DeleteDocumentWithConcurrencyControl>(
@@ -340,10 +891,22 @@ final class CollectionBindings extends Bindings {
       'CBLCollection_GetDocumentExpiration',
       isLeaf: useIsLeaf,
     );
-    _setDocumentExpiration = libs.cbl.lookupFunction<
-        _CBLCollection_SetDocumentExpiration_C,
-        _CBLCollection_SetDocumentExpiration>(
-      'CBLCollection_SetDocumentExpiration',
+    _setDocumentExpiration = libs.cblDart.lookupFunction<
+        _CBLDart_CBLCollection_SetDocumentExpiration_C,
+        _CBLDart_CBLCollection_SetDocumentExpiration>(
+      'CBLDart_CBLCollection_SetDocumentExpiration',
+      isLeaf: useIsLeaf,
+    );
+    _setDocumentExpirations = libs.cblDart.lookupFunction<
+        _CBLDart_CBLCollection_SetDocumentExpirations_C,
+        _CBLDart_CBLCollection_SetDocumentExpirations>(
+      'CBLDart_CBLCollection_SetDocumentExpirations',
+      isLeaf: useIsLeaf,
+    );
+    _expirationStats = libs.cblDart.lookupFunction<
+        _CBLDart_CBLCollection_ExpirationStats,
+        _CBLDart_CBLCollection_ExpirationStats>(
+      'CBLDart_CBLCollection_ExpirationStats',
       isLeaf: useIsLeaf,
     );
     _indexNames = libs.cbl.lookupFunction<_CBLCollection_GetIndexNames,
@@ -374,6 +937,110 @@ final class CollectionBindings extends Bindings {
       'CBLDart_CBLCollection_AddChangeListener',
       isLeaf: useIsLeaf,
     );
+    _buildIndex = libs.cblDart.lookupFunction<_CBLDart_CBLCollection_BuildIndex,
+        _CBLDart_CBLCollection_BuildIndex>(
+      'CBLDart_CBLCollection_BuildIndex',
+      isLeaf: useIsLeaf,
+    );
+    _cancelIndexBuild = libs.cblDart.lookupFunction<
+        _CBLDart_IndexBuilder_Cancel_C, _CBLDart_IndexBuilder_Cancel>(
+      'CBLDart_IndexBuilder_Cancel',
+      isLeaf: useIsLeaf,
+    );
+    _importJsonLines = libs.cblDart.lookupFunction<
+        _CBLDart_CBLCollection_ImportJSONLines_C,
+        _CBLDart_CBLCollection_ImportJSONLines>(
+      'CBLDart_CBLCollection_ImportJSONLines',
+      isLeaf: useIsLeaf,
+    );
+    _addJsonLinesChunk = libs.cblDart.lookupFunction<
+        _CBLDart_JSONLinesImporter_AddChunk_C,
+        _CBLDart_JSONLinesImporter_AddChunk>(
+      'CBLDart_JSONLinesImporter_AddChunk',
+      isLeaf: useIsLeaf,
+    );
+    _addJsonLinesFile = libs.cblDart.lookupFunction<
+        _CBLDart_JSONLinesImporter_AddFile_C,
+        _CBLDart_JSONLinesImporter_AddFile>(
+      'CBLDart_JSONLinesImporter_AddFile',
+      isLeaf: useIsLeaf,
+    );
+    _finishJsonLinesImport = libs.cblDart.lookupFunction<
+        _CBLDart_JSONLinesImporter_Finish_C,
+        _CBLDart_JSONLinesImporter_Finish>(
+      'CBLDart_JSONLinesImporter_Finish',
+      isLeaf: useIsLeaf,
+    );
+    _deleteWhere = libs.cblDart.lookupFunction<
+        _CBLDart_CBLCollection_RemoveWhere_C,
+        _CBLDart_CBLCollection_RemoveWhere>(
+      'CBLDart_CBLCollection_DeleteWhere',
+      isLeaf: useIsLeaf,
+    );
+    _purgeWhere = libs.cblDart.lookupFunction<
+        _CBLDart_CBLCollection_RemoveWhere_C,
+        _CBLDart_CBLCollection_RemoveWhere>(
+      'CBLDart_CBLCollection_PurgeWhere',
+      isLeaf: useIsLeaf,
+    );
+    _setDocumentCacheLimits = libs.cblDart.lookupFunction<
+        _CBLDart_DocumentCache_SetLimits_C, _CBLDart_DocumentCache_SetLimits>(
+      'CBLDart_DocumentCache_SetLimits',
+      isLeaf: useIsLeaf,
+    );
+    _documentCacheStats = libs.cblDart.lookupFunction<
+        _CBLDart_DocumentCache_Stats, _CBLDart_DocumentCache_Stats>(
+      'CBLDart_DocumentCache_Stats',
+      isLeaf: useIsLeaf,
+    );
+    _newChangeCursor = libs.cblDart.lookupFunction<
+        _CBLDart_CBLCollection_NewChangeCursor_C,
+        _CBLDart_CBLCollection_NewChangeCursor>(
+      'CBLDart_CBLCollection_NewChangeCursor',
+      isLeaf: useIsLeaf,
+    );
+    _changeCursorNext = libs.cblDart.lookupFunction<
+        _CBLDart_ChangeCursor_Next_C, _CBLDart_ChangeCursor_Next>(
+      'CBLDart_ChangeCursor_Next',
+      isLeaf: useIsLeaf,
+    );
+    _changeCursorReleasePtr =
+        libs.cblDart.lookup('CBLDart_ChangeCursor_Release');
+    _fullTextSearch = libs.cblDart.lookupFunction<
+        _CBLDart_CBLCollection_FullTextSearch,
+        _CBLDart_CBLCollection_FullTextSearch>(
+      'CBLDart_CBLCollection_FullTextSearch',
+      isLeaf: useIsLeaf,
+    );
+    _newDocumentOperations = libs.cblDart.lookupFunction<
+        _CBLDart_DocumentOperations_New, _CBLDart_DocumentOperations_New>(
+      'CBLDart_DocumentOperations_New',
+      isLeaf: useIsLeaf,
+    );
+    _getDocumentInBackground = libs.cblDart.lookupFunction<
+        _CBLDart_DocumentOperations_GetDocument_C,
+        _CBLDart_DocumentOperations_GetDocument>(
+      'CBLDart_DocumentOperations_GetDocument',
+      isLeaf: useIsLeaf,
+    );
+    _saveDocumentInBackground = libs.cblDart.lookupFunction<
+        _CBLDart_DocumentOperations_SaveDocument_C,
+        _CBLDart_DocumentOperations_SaveDocument>(
+      'CBLDart_DocumentOperations_SaveDocument',
+      isLeaf: useIsLeaf,
+    );
+    _deleteDocumentInBackground = libs.cblDart.lookupFunction<
+        _CBLDart_DocumentOperations_DeleteDocument_C,
+        _CBLDart_DocumentOperations_DeleteDocument>(
+      'CBLDart_DocumentOperations_DeleteDocument',
+      isLeaf: useIsLeaf,
+    );
+    _purgeDocumentInBackground = libs.cblDart.lookupFunction<
+        _CBLDart_DocumentOperations_PurgeDocument_C,
+        _CBLDart_DocumentOperations_PurgeDocument>(
+      'CBLDart_DocumentOperations_PurgeDocument',
+      isLeaf: useIsLeaf,
+    );
   }
 
   late final _CBLDatabase_ScopeNames _database_scopeNames;
@@ -383,20 +1050,53 @@ final class CollectionBindings extends Bindings {
   late final _CBLDatabase_CreateCollection _database_createCollection;
   late final _CBLDatabase_DeleteCollection _database_deleteCollection;
   late final _CBLCollection_Count _count;
-  late final _CBLCollection_GetDocument _getDocument;
+  late final _CBLDart_CBLCollection_GetDocument _getDocument;
+  late final _CBLDart_CBLCollection_GetDocuments _getDocuments;
   late final _CBLCollection_SaveDocumentWithConcurrencyControl
       _saveDocumentWithConcurrencyControl;
+  late final _CBLDart_CBLCollection_SaveDocuments _saveDocuments;
+  late final _CBLDart_CBLCollection_PatchDocument _patchDocument;
   late final _CBLCollection_DeleteDocumentWithConcurrencyControl
       _deleteDocumentWithConcurrencyControl;
   late final _CBLCollection_PurgeDocumentByID _purgeDocumentByID;
   late final _CBLCollection_GetDocumentExpiration _getDocumentExpiration;
-  late final _CBLCollection_SetDocumentExpiration _setDocumentExpiration;
+  late final _CBLDart_CBLCollection_SetDocumentExpiration
+      _setDocumentExpiration;
+  late final _CBLDart_CBLCollection_SetDocumentExpirations
+      _setDocumentExpirations;
+  late final _CBLDart_CBLCollection_ExpirationStats _expirationStats;
   late final _CBLCollection_GetIndexNames _indexNames;
   late final _CBLDart_CBLCollection_CreateIndex _createIndex;
   late final _CBLCollection_DeleteIndex _deleteIndex;
   late final _CBLDart_CBLCollection_AddDocumentChangeListener
       _addDocumentChangeListener;
   late final _CBLDart_CBLCollection_AddChangeListener _addChangeListener;
+  late final _CBLDart_CBLCollection_BuildIndex _buildIndex;
+  late final _CBLDart_IndexBuilder_Cancel _cancelIndexBuild;
+  late final _CBLDart_CBLCollection_ImportJSONLines _importJsonLines;
+  late final _CBLDart_JSONLinesImporter_AddChunk _addJsonLinesChunk;
+  late final _CBLDart_JSONLinesImporter_AddFile _addJsonLinesFile;
+  late final _CBLDart_JSONLinesImporter_Finish _finishJsonLinesImport;
+  late final _CBLDart_CBLCollection_RemoveWhere _deleteWhere;
+  late final _CBLDart_CBLCollection_RemoveWhere _purgeWhere;
+  late final _CBLDart_DocumentCache_SetLimits _setDocumentCacheLimits;
+  late final _CBLDart_DocumentCache_Stats _documentCacheStats;
+  late final _CBLDart_CBLCollection_NewChangeCursor _newChangeCursor;
+  late final _CBLDart_ChangeCursor_Next _changeCursorNext;
+  late final Pointer<NativeFunction<_CBLDart_ChangeCursor_Release_C>>
+      _changeCursorReleasePtr;
+  late final _CBLDart_CBLCollection_FullTextSearch _fullTextSearch;
+
+  late final _CBLDart_DocumentOperations_New _newDocumentOperations;
+  late final _CBLDart_DocumentOperations_GetDocument _getDocumentInBackground;
+  late final _CBLDart_DocumentOperations_SaveDocument _saveDocumentInBackground;
+  late final _CBLDart_DocumentOperations_DeleteDocument
+      _deleteDocumentInBackground;
+  late final _CBLDart_DocumentOperations_PurgeDocument
+      _purgeDocumentInBackground;
+
+  late final _changeCursorFinalizer =
+      NativeFinalizer(_changeCursorReleasePtr.cast());
 
   Pointer<FLMutableArray> databaseScopeNames(Pointer<CBLDatabase> db) =>
       _database_scopeNames(db, globalCBLError).checkCBLError();
@@ -469,6 +1169,35 @@ final class CollectionBindings extends Bindings {
         ).checkCBLError().toNullable(),
       );
 
+  List<Pointer<CBLDocument>?> getDocuments(
+    Pointer<CBLCollection> collection,
+    List<String> docIds,
+  ) =>
+      withGlobalArena(() {
+        final count = docIds.length;
+        final flDocIds = globalArena<FLString>(count);
+        for (var i = 0; i < count; i++) {
+          final docId = nativeUtf8StringEncoder.encode(docIds[i], globalArena);
+          flDocIds[i]
+            ..buf = docId.buffer
+            ..size = docId.size;
+        }
+        final documents = globalArena<Pointer<CBLDocument>>(count);
+
+        nativeCallTracePoint(
+          TracedNativeCall.collectionGetDocuments,
+          () => _getDocuments(
+            collection,
+            flDocIds,
+            count,
+            documents,
+            globalCBLError,
+          ),
+        ).checkCBLError();
+
+        return [for (var i = 0; i < count; i++) documents[i].toNullable()];
+      });
+
   void saveDocumentWithConcurrencyControl(
     Pointer<CBLCollection> collection,
     Pointer<CBLMutableDocument> doc,
@@ -486,6 +1215,55 @@ final class CollectionBindings extends Bindings {
     ).checkCBLError();
   }
 
+  List<bool> saveDocuments(
+    Pointer<CBLCollection> collection,
+    List<Pointer<CBLMutableDocument>> documents,
+    CBLConcurrencyControl concurrencyControl,
+  ) =>
+      withGlobalArena(() {
+        final count = documents.length;
+        final documentsArray = globalArena<Pointer<CBLMutableDocument>>(count);
+        for (var i = 0; i < count; i++) {
+          documentsArray[i] = documents[i];
+        }
+        final results = globalArena<Uint8>(count);
+
+        nativeCallTracePoint(
+          TracedNativeCall.collectionSaveDocuments,
+          () => _saveDocuments(
+            collection,
+            documentsArray,
+            count,
+            concurrencyControl.toInt(),
+            results,
+            globalCBLError,
+          ),
+        ).checkCBLError();
+
+        return [for (var i = 0; i < count; i++) results[i] != 0];
+      });
+
+  void patchDocument(
+    Pointer<CBLCollection> collection,
+    String docId,
+    Data patch,
+    CBLConcurrencyControl concurrencyControl,
+  ) {
+    final sliceResult = patch.toSliceResult();
+    runWithSingleFLString(docId, (flDocId) {
+      nativeCallTracePoint(
+        TracedNativeCall.collectionPatchDocument,
+        () => _patchDocument(
+          collection,
+          flDocId,
+          sliceResult.makeGlobal().ref,
+          concurrencyControl.toInt(),
+          globalCBLError,
+        ),
+      ).checkCBLError();
+    });
+  }
+
   bool deleteDocumentWithConcurrencyControl(
     Pointer<CBLCollection> collection,
     Pointer<CBLDocument> document,
@@ -539,6 +1317,41 @@ final class CollectionBindings extends Bindings {
         ).checkCBLError();
       });
 
+  void setDocumentExpirations(
+    Pointer<CBLCollection> collection,
+    Map<String, DateTime?> expirations,
+  ) =>
+      withGlobalArena(() {
+        final count = expirations.length;
+        final flDocIds = globalArena<FLString>(count);
+        final flExpirations = globalArena<Int64>(count);
+        var i = 0;
+        for (final MapEntry(key: docId, value: expiration)
+            in expirations.entries) {
+          final encodedDocId =
+              nativeUtf8StringEncoder.encode(docId, globalArena);
+          flDocIds[i]
+            ..buf = encodedDocId.buffer
+            ..size = encodedDocId.size;
+          flExpirations[i] = expiration?.millisecondsSinceEpoch ?? 0;
+          i++;
+        }
+
+        nativeCallTracePoint(
+          TracedNativeCall.collectionSetDocumentExpirations,
+          () => _setDocumentExpirations(
+            collection,
+            flDocIds,
+            flExpirations,
+            count,
+            globalCBLError,
+          ),
+        ).checkCBLError();
+      });
+
+  CBLDart_ExpirationStats expirationStats(Pointer<CBLCollection> collection) =>
+      _expirationStats(collection);
+
   Pointer<FLArray> indexNames(Pointer<CBLCollection> collection) =>
       _indexNames(collection);
 
@@ -563,6 +1376,25 @@ final class CollectionBindings extends Bindings {
     });
   }
 
+  Pointer<CBLDart_IndexBuilder> buildIndex(
+    Pointer<CBLDatabase> db,
+    Pointer<CBLCollection> collection,
+    String name,
+    CBLIndexSpec spec,
+    Pointer<CBLDartAsyncCallback> callback,
+  ) =>
+      withGlobalArena(() => _buildIndex(
+            db,
+            collection,
+            name.toFLString(),
+            _createIndexSpec(spec).ref,
+            callback,
+          ));
+
+  void cancelIndexBuild(Pointer<CBLDart_IndexBuilder> builder) {
+    _cancelIndexBuild(builder);
+  }
+
   Pointer<_CBLDart_CBLIndexSpec> _createIndexSpec(CBLIndexSpec spec) {
     final result = globalArena<_CBLDart_CBLIndexSpec>();
 
@@ -571,7 +1403,18 @@ final class CollectionBindings extends Bindings {
       ..expressionLanguage = spec.expressionLanguage
       ..expressions = spec.expressions.toFLString()
       ..ignoreAccents = spec.ignoreAccents ?? false
-      ..language = spec.language.toFLString();
+      ..language = spec.language.toFLString()
+      ..path = spec.path.toFLString()
+      ..dimensions = spec.vector?.dimensions ?? 0
+      ..centroids = spec.vector?.centroids ?? 0
+      ..encodingType = spec.vector?.encodingType ?? CBLVectorEncodingType.none
+      ..scalarQuantizerType = spec.vector?.scalarQuantizerType?.value ?? 0
+      ..subquantizers = spec.vector?.subquantizers ?? 0
+      ..bits = spec.vector?.bits ?? 0
+      ..metric = spec.vector?.metric.value ?? 0
+      ..minTrainingSize = spec.vector?.minTrainingSize ?? 0
+      ..maxTrainingSize = spec.vector?.maxTrainingSize ?? 0
+      ..numProbes = spec.vector?.numProbes ?? 0;
 
     return result;
   }
@@ -580,10 +1423,17 @@ final class CollectionBindings extends Bindings {
     Pointer<CBLDatabase> db,
     Pointer<CBLCollection> collection,
     String docId,
+    Duration? debounce,
     Pointer<CBLDartAsyncCallback> listener,
   ) {
     runWithSingleFLString(docId, (flDocId) {
-      _addDocumentChangeListener(db, collection, flDocId, listener);
+      _addDocumentChangeListener(
+        db,
+        collection,
+        flDocId,
+        debounce?.inMilliseconds ?? 0,
+        listener,
+      );
     });
   }
 
@@ -594,4 +1444,175 @@ final class CollectionBindings extends Bindings {
   ) {
     _addChangeListener(db, collection, listener);
   }
+
+  Pointer<CBLDart_JSONLinesImporter> importJsonLines(
+    Pointer<CBLDatabase> db,
+    Pointer<CBLCollection> collection,
+    String? idKeyPath,
+    int batchSize,
+    Pointer<CBLDartAsyncCallback> callback,
+  ) =>
+      withGlobalArena(() => _importJsonLines(
+            db,
+            collection,
+            idKeyPath.toFLString(),
+            batchSize,
+            callback,
+            globalCBLError,
+          ).checkCBLError());
+
+  void addJsonLinesChunk(
+    Pointer<CBLDart_JSONLinesImporter> importer,
+    Data chunk,
+  ) {
+    final sliceResult = chunk.toSliceResult();
+    _addJsonLinesChunk(importer, sliceResult.makeGlobal().ref);
+  }
+
+  void addJsonLinesFile(
+    Pointer<CBLDart_JSONLinesImporter> importer,
+    String path,
+  ) {
+    runWithSingleFLString(path, (flPath) {
+      _addJsonLinesFile(importer, flPath);
+    });
+  }
+
+  void finishJsonLinesImport(
+    Pointer<CBLDart_JSONLinesImporter> importer, {
+    required bool cancel,
+  }) {
+    _finishJsonLinesImport(importer, cancel);
+  }
+
+  void removeWhere(
+    Pointer<CBLDatabase> db,
+    Pointer<CBLCollection> collection,
+    String predicate,
+    int batchSize,
+    Pointer<CBLDartAsyncCallback> callback, {
+    required bool purge,
+  }) {
+    runWithSingleFLString(predicate, (flPredicate) {
+      (purge ? _purgeWhere : _deleteWhere)(
+        db,
+        collection,
+        flPredicate,
+        batchSize,
+        callback,
+        globalCBLError,
+      ).checkCBLError();
+    });
+  }
+
+  void setDocumentCacheLimits({required int maxCount, required int maxSize}) =>
+      _setDocumentCacheLimits(maxCount, maxSize);
+
+  CBLDart_DocumentCacheStats documentCacheStats() => _documentCacheStats();
+
+  Pointer<CBLDart_ChangeCursor> newChangeCursor(
+    Finalizable object,
+    Pointer<CBLCollection> collection,
+    int sequence,
+  ) {
+    final cursor = _newChangeCursor(collection, sequence);
+    _changeCursorFinalizer.attach(object, cursor.cast());
+    return cursor;
+  }
+
+  Data changeCursorNext(Pointer<CBLDart_ChangeCursor> cursor, int maxCount) =>
+      nativeCallTracePoint(
+        TracedNativeCall.changeCursorNext,
+        () => _changeCursorNext(cursor, maxCount, globalCBLError),
+      ).checkCBLError().toData()!;
+
+  Data fullTextSearch(
+    Pointer<CBLCollection> collection, {
+    required String indexName,
+    required String query,
+    required int limit,
+    required int offset,
+    String? snippetProperty,
+    required int snippetWordCount,
+    required String matchStart,
+    required String matchEnd,
+    required String ellipsis,
+  }) =>
+      withGlobalArena(() {
+        final options = globalArena<_CBLDart_FullTextSearchOptions>();
+        options.ref
+          ..indexName = indexName.toFLString()
+          ..query = query.toFLString()
+          ..limit = limit
+          ..offset = offset
+          ..snippetProperty = snippetProperty.toFLString()
+          ..snippetWordCount = snippetWordCount
+          ..matchStart = matchStart.toFLString()
+          ..matchEnd = matchEnd.toFLString()
+          ..ellipsis = ellipsis.toFLString();
+
+        return _fullTextSearch(collection, options, globalCBLError)
+            .checkCBLError()
+            .toData()!;
+      });
+
+  Pointer<CBLDart_DocumentOperations> newDocumentOperations(
+    Pointer<CBLDatabase> db,
+    Pointer<CBLDartAsyncCallback> callback,
+  ) =>
+      _newDocumentOperations(db, callback);
+
+  void getDocumentInBackground(
+    Pointer<CBLDart_DocumentOperations> operations,
+    Pointer<CBLCollection> collection,
+    String docId,
+    int operationId,
+  ) {
+    runWithSingleFLString(docId, (flDocId) {
+      _getDocumentInBackground(operations, collection, flDocId, operationId);
+    });
+  }
+
+  void saveDocumentInBackground(
+    Pointer<CBLDart_DocumentOperations> operations,
+    Pointer<CBLCollection> collection,
+    Pointer<CBLMutableDocument> doc,
+    CBLConcurrencyControl concurrencyControl,
+    int operationId,
+  ) {
+    _saveDocumentInBackground(
+      operations,
+      collection,
+      doc,
+      concurrencyControl.toInt(),
+      operationId,
+    );
+  }
+
+  void deleteDocumentInBackground(
+    Pointer<CBLDart_DocumentOperations> operations,
+    Pointer<CBLCollection> collection,
+    Pointer<CBLDocument> doc,
+    CBLConcurrencyControl concurrencyControl,
+    int operationId,
+  ) {
+    _deleteDocumentInBackground(
+      operations,
+      collection,
+      doc,
+      concurrencyControl.toInt(),
+      operationId,
+    );
+  }
+
+  void purgeDocumentInBackground(
+    Pointer<CBLDart_DocumentOperations> operations,
+    Pointer<CBLCollection> collection,
+    String docId,
+    int operationId,
+  ) {
+    runWithSingleFLString(docId, (flDocId) {
+      _purgeDocumentInBackground(operations, collection, flDocId, operationId);
+    });
+  }
 }
@@ -1,9 +1,11 @@
 // ignore: lines_longer_than_80_chars
 // ignore_for_file: avoid_redundant_argument_values, avoid_positional_boolean_parameters, avoid_private_typedef_functions, camel_case_types
 
+import 'dart:convert';
 import 'dart:ffi';
 import 'dart:typed_data';
 
+import 'async_callback.dart';
 import 'base.dart';
 import 'bindings.dart';
 import 'blob.dart';
@@ -69,6 +71,8 @@ extension CBLConcurrencyControlExt on CBLConcurrencyControl {
 
 final class CBLDatabase extends Opaque {}
 
+final class CBLDartSharedDatabase extends Opaque {}
+
 final class CBLDatabaseConfiguration {
   CBLDatabaseConfiguration({required this.directory, this.encryptionKey});
 
@@ -138,6 +142,52 @@ typedef _CBLDart_CBLDatabase_Close = bool Function(
   Pointer<CBLError> errorOut,
 );
 
+typedef _CBLDart_CBLDatabase_OpenShared = Pointer<CBLDartSharedDatabase>
+    Function(
+  FLString name,
+  Pointer<_CBLDatabaseConfiguration> config,
+  Pointer<CBLError> errorOut,
+);
+
+typedef _CBLDart_SharedDatabase_Database = Pointer<CBLDatabase> Function(
+  Pointer<CBLDartSharedDatabase> handle,
+);
+
+typedef _CBLDart_SharedDatabase_Close_C = Bool Function(
+  Pointer<CBLDartSharedDatabase> handle,
+  Bool andDelete,
+  Pointer<CBLError> errorOut,
+);
+typedef _CBLDart_SharedDatabase_Close = bool Function(
+  Pointer<CBLDartSharedDatabase> handle,
+  bool andDelete,
+  Pointer<CBLError> errorOut,
+);
+
+typedef _CBLDart_SharedDatabase_Release_C = Void Function(
+  Pointer<CBLDartSharedDatabase> handle,
+);
+
+typedef _CBLDart_SharedDatabase_BeginTransaction_C = Bool Function(
+  Pointer<CBLDartSharedDatabase> handle,
+  Pointer<CBLError> errorOut,
+);
+typedef _CBLDart_SharedDatabase_BeginTransaction = bool Function(
+  Pointer<CBLDartSharedDatabase> handle,
+  Pointer<CBLError> errorOut,
+);
+
+typedef _CBLDart_SharedDatabase_EndTransaction_C = Bool Function(
+  Pointer<CBLDartSharedDatabase> handle,
+  Bool commit,
+  Pointer<CBLError> errorOut,
+);
+typedef _CBLDart_SharedDatabase_EndTransaction = bool Function(
+  Pointer<CBLDartSharedDatabase> handle,
+  bool commit,
+  Pointer<CBLError> errorOut,
+);
+
 enum CBLMaintenanceType {
   compact,
   reindex,
@@ -161,6 +211,69 @@ typedef _CBLDatabase_PerformMaintenance = bool Function(
   Pointer<CBLError> errorOut,
 );
 
+typedef _CBLDart_CBLDatabase_ScheduleMaintenance_C = Void Function(
+  Pointer<CBLDatabase> db,
+  Uint32 types,
+  Uint64 intervalMs,
+  Uint64 idleMs,
+  Pointer<CBLDartAsyncCallback> callback,
+);
+typedef _CBLDart_CBLDatabase_ScheduleMaintenance = void Function(
+  Pointer<CBLDatabase> db,
+  int types,
+  int intervalMs,
+  int idleMs,
+  Pointer<CBLDartAsyncCallback> callback,
+);
+
+final class MaintenanceCallbackMessage {
+  MaintenanceCallbackMessage(
+    this.isDone,
+    this.type,
+    this.sizeBefore,
+    this.sizeAfter,
+    this.error,
+  );
+
+  factory MaintenanceCallbackMessage.fromArguments(List<Object?> arguments) {
+    if (!(arguments[0] as bool)) {
+      return MaintenanceCallbackMessage(
+        false,
+        CBLMaintenanceType.values[arguments[1] as int],
+        0,
+        0,
+        null,
+      );
+    }
+
+    return MaintenanceCallbackMessage(
+      true,
+      null,
+      arguments[1] as int,
+      arguments[2] as int,
+      _parseError(arguments),
+    );
+  }
+
+  static CBLErrorException? _parseError(List<Object?> arguments) {
+    if (arguments.length <= 3) {
+      return null;
+    }
+
+    final domain = (arguments[3] as int).toErrorDomain();
+    final code = (arguments[4] as int).toErrorCode(domain);
+    final message =
+        utf8.decode(arguments[5] as Uint8List, allowMalformed: true);
+    return CBLErrorException(domain, code, message);
+  }
+
+  final bool isDone;
+  final CBLMaintenanceType? type;
+  final int sizeBefore;
+  final int sizeAfter;
+  final CBLErrorException? error;
+}
+
 typedef _CBLDatabase_BeginTransaction_C = Bool Function(
   Pointer<CBLDatabase> db,
   Pointer<CBLError> errorOut,
@@ -255,19 +368,53 @@ final class DatabaseBindings extends Bindings {
       'CBLDart_CBLDatabase_Close',
       isLeaf: useIsLeaf,
     );
+    _openShared = libs.cblDart.lookupFunction<_CBLDart_CBLDatabase_OpenShared,
+        _CBLDart_CBLDatabase_OpenShared>(
+      'CBLDart_CBLDatabase_OpenShared',
+      isLeaf: useIsLeaf,
+    );
+    _sharedDatabase = libs.cblDart.lookupFunction<
+        _CBLDart_SharedDatabase_Database, _CBLDart_SharedDatabase_Database>(
+      'CBLDart_SharedDatabase_Database',
+      isLeaf: useIsLeaf,
+    );
+    _closeShared = libs.cblDart.lookupFunction<_CBLDart_SharedDatabase_Close_C,
+        _CBLDart_SharedDatabase_Close>(
+      'CBLDart_SharedDatabase_Close',
+      isLeaf: useIsLeaf,
+    );
+    _releaseSharedPtr = libs.cblDart.lookup('CBLDart_SharedDatabase_Release');
+    // Not a leaf call, since it waits for the transactions of other handles.
+    _beginSharedTransaction = libs.cblDart.lookupFunction<
+        _CBLDart_SharedDatabase_BeginTransaction_C,
+        _CBLDart_SharedDatabase_BeginTransaction>(
+      'CBLDart_SharedDatabase_BeginTransaction',
+    );
+    _endSharedTransaction = libs.cblDart.lookupFunction<
+        _CBLDart_SharedDatabase_EndTransaction_C,
+        _CBLDart_SharedDatabase_EndTransaction>(
+      'CBLDart_SharedDatabase_EndTransaction',
+      isLeaf: useIsLeaf,
+    );
     _performMaintenance = libs.cbl.lookupFunction<
         _CBLDatabase_PerformMaintenance_C, _CBLDatabase_PerformMaintenance>(
       'CBLDatabase_PerformMaintenance',
       isLeaf: useIsLeaf,
     );
-    _beginTransaction = libs.cbl.lookupFunction<_CBLDatabase_BeginTransaction_C,
-        _CBLDatabase_BeginTransaction>(
-      'CBLDatabase_BeginTransaction',
+    _scheduleMaintenance = libs.cblDart.lookupFunction<
+        _CBLDart_CBLDatabase_ScheduleMaintenance_C,
+        _CBLDart_CBLDatabase_ScheduleMaintenance>(
+      'CBLDart_CBLDatabase_ScheduleMaintenance',
+      isLeaf: useIsLeaf,
+    );
+    _beginTransaction = libs.cblDart.lookupFunction<
+        _CBLDatabase_BeginTransaction_C, _CBLDatabase_BeginTransaction>(
+      'CBLDart_CBLDatabase_BeginTransaction',
       isLeaf: useIsLeaf,
     );
-    _endTransaction = libs.cbl.lookupFunction<_CBLDatabase_EndTransaction_C,
-        _CBLDatabase_EndTransaction>(
-      'CBLDatabase_EndTransaction',
+    _endTransaction = libs.cblDart.lookupFunction<
+        _CBLDatabase_EndTransaction_C, _CBLDatabase_EndTransaction>(
+      'CBLDart_CBLDatabase_EndTransaction',
       isLeaf: useIsLeaf,
     );
     if (libs.enterpriseEdition) {
@@ -306,7 +453,15 @@ final class DatabaseBindings extends Bindings {
   late final Pointer<NativeFunction<_CBLDart_CBLDatabase_Release_C>>
       _releasePtr;
   late final _CBLDart_CBLDatabase_Close _close;
+  late final _CBLDart_CBLDatabase_OpenShared _openShared;
+  late final _CBLDart_SharedDatabase_Database _sharedDatabase;
+  late final _CBLDart_SharedDatabase_Close _closeShared;
+  late final Pointer<NativeFunction<_CBLDart_SharedDatabase_Release_C>>
+      _releaseSharedPtr;
+  late final _CBLDart_SharedDatabase_BeginTransaction _beginSharedTransaction;
+  late final _CBLDart_SharedDatabase_EndTransaction _endSharedTransaction;
   late final _CBLDatabase_PerformMaintenance _performMaintenance;
+  late final _CBLDart_CBLDatabase_ScheduleMaintenance _scheduleMaintenance;
   late final _CBLDatabase_BeginTransaction _beginTransaction;
   late final _CBLDatabase_EndTransaction _endTransaction;
   late final _CBLDatabase_ChangeEncryptionKey _changeEncryptionKey;
@@ -316,6 +471,7 @@ final class DatabaseBindings extends Bindings {
   late final _CBLDatabase_SaveBlob _saveBlob;
 
   late final _finalizer = NativeFinalizer(_releasePtr.cast());
+  late final _sharedFinalizer = NativeFinalizer(_releaseSharedPtr.cast());
 
   CBLEncryptionKey encryptionKeyFromPassword(String password) =>
       withGlobalArena(() {
@@ -394,10 +550,78 @@ final class DatabaseBindings extends Bindings {
     _close(db, true, globalCBLError).checkCBLError();
   }
 
+  Pointer<CBLDartSharedDatabase> openShared(
+    String name,
+    CBLDatabaseConfiguration? config,
+  ) =>
+      withGlobalArena(() {
+        final nameFlStr = name.toFLString();
+        final cblConfig = _createConfig(config);
+        return nativeCallTracePoint(
+          TracedNativeCall.databaseOpen,
+          () => _openShared(nameFlStr, cblConfig, globalCBLError),
+        ).checkCBLError();
+      });
+
+  Pointer<CBLDatabase> sharedDatabase(Pointer<CBLDartSharedDatabase> handle) =>
+      _sharedDatabase(handle);
+
+  void bindSharedToDartObject(
+    Finalizable object,
+    Pointer<CBLDartSharedDatabase> handle,
+  ) {
+    _sharedFinalizer.attach(object, handle.cast());
+  }
+
+  void closeShared(Pointer<CBLDartSharedDatabase> handle) {
+    nativeCallTracePoint(
+      TracedNativeCall.databaseClose,
+      () => _closeShared(handle, false, globalCBLError),
+    ).checkCBLError();
+  }
+
+  void deleteShared(Pointer<CBLDartSharedDatabase> handle) {
+    _closeShared(handle, true, globalCBLError).checkCBLError();
+  }
+
+  void beginSharedTransaction(Pointer<CBLDartSharedDatabase> handle) {
+    nativeCallTracePoint(
+      TracedNativeCall.databaseBeginTransaction,
+      () => _beginSharedTransaction(handle, globalCBLError).checkCBLError(),
+    );
+  }
+
+  void endSharedTransaction(
+    Pointer<CBLDartSharedDatabase> handle, {
+    required bool commit,
+  }) {
+    nativeCallTracePoint(
+      TracedNativeCall.databaseEndTransaction,
+      () => _endSharedTransaction(handle, commit, globalCBLError)
+          .checkCBLError(),
+    );
+  }
+
   void performMaintenance(Pointer<CBLDatabase> db, CBLMaintenanceType type) {
     _performMaintenance(db, type.toInt(), globalCBLError).checkCBLError();
   }
 
+  void scheduleMaintenance(
+    Pointer<CBLDatabase> db,
+    Set<CBLMaintenanceType> types,
+    Duration interval,
+    Duration idle,
+    Pointer<CBLDartAsyncCallback> callback,
+  ) {
+    _scheduleMaintenance(
+      db,
+      types.fold<int>(0, (mask, type) => mask | (1 << type.toInt())),
+      interval.inMilliseconds,
+      idle.inMilliseconds,
+      callback,
+    );
+  }
+
   void beginTransaction(Pointer<CBLDatabase> db) {
     nativeCallTracePoint(
       TracedNativeCall.databaseBeginTransaction,
@@ -10,6 +10,7 @@ import 'base.dart';
 import 'bindings.dart';
 import 'data.dart';
 import 'global.dart';
+import 'native_utf8_string.dart';
 import 'slice.dart';
 import 'utils.dart';
 
@@ -1256,8 +1257,14 @@ final class MutableDictBindings extends Bindings {
 // === Decoder =================================================================
 
 @pragma('vm:prefer-inline')
-String decodeFLString(int address, int size) =>
-    utf8.decode(Pointer<Uint8>.fromAddress(address).asTypedList(size));
+/// Decodes the UTF-8 string of [size] bytes at [address].
+///
+/// If the string is known to contain only ASCII characters ([isAscii]), it is
+/// copied into a one byte string, instead of being decoded as UTF-8.
+String decodeFLString(int address, int size, {bool isAscii = false}) {
+  final bytes = Pointer<Uint8>.fromAddress(address).asTypedList(size);
+  return isAscii ? String.fromCharCodes(bytes) : utf8.decode(bytes);
+}
 
 enum FLTrust {
   untrusted,
@@ -1279,6 +1286,8 @@ typedef _CBLDart_KnownSharedKeys_Delete_C = Void Function(
 final class CBLDart_LoadedDictKey extends Struct {
   @Bool()
   external bool isKnownSharedKey;
+  @Bool()
+  external bool isAscii;
   @Int()
   external int sharedKey;
   @UintPtr()
@@ -1295,6 +1304,8 @@ final class CBLDart_LoadedFLValue extends Struct {
   external int _type;
   @Bool()
   external bool isInteger;
+  @Bool()
+  external bool isAscii;
   @Uint32()
   external int collectionSize;
   @Bool()
@@ -1383,6 +1394,19 @@ typedef _CBLDart_FLDictIterator_Next = bool Function(
   Pointer<CBLDart_FLDictIterator> iterator,
 );
 
+typedef _CBLDart_FLDictIterator_NextBatch_C = Uint32 Function(
+  Pointer<CBLDart_FLDictIterator> iterator,
+  Pointer<CBLDart_LoadedDictKey> keysOut,
+  Pointer<CBLDart_LoadedFLValue> valuesOut,
+  Uint32 capacity,
+);
+typedef _CBLDart_FLDictIterator_NextBatch = int Function(
+  Pointer<CBLDart_FLDictIterator> iterator,
+  Pointer<CBLDart_LoadedDictKey> keysOut,
+  Pointer<CBLDart_LoadedFLValue> valuesOut,
+  int capacity,
+);
+
 final class CBLDart_FLArrayIterator extends Opaque {}
 
 typedef _CBLDart_FLArrayIterator_Begin_C = Pointer<CBLDart_FLArrayIterator>
@@ -1409,6 +1433,115 @@ typedef _CBLDart_FLArrayIterator_Next = bool Function(
   Pointer<CBLDart_FLArrayIterator> iterator,
 );
 
+typedef _CBLDart_FLArrayIterator_NextBatch_C = Uint32 Function(
+  Pointer<CBLDart_FLArrayIterator> iterator,
+  Pointer<CBLDart_LoadedFLValue> valuesOut,
+  Uint32 capacity,
+);
+typedef _CBLDart_FLArrayIterator_NextBatch = int Function(
+  Pointer<CBLDart_FLArrayIterator> iterator,
+  Pointer<CBLDart_LoadedFLValue> valuesOut,
+  int capacity,
+);
+
+/// The type of [CBLDart_FLTapeEntry]s which hold the key of a dict entry.
+const dictKeyTapeEntryType = 16;
+
+final class CBLDart_FLTapeEntryPayload extends Union {
+  @Int64()
+  external int asInt;
+  @Double()
+  external double asDouble;
+  @UintPtr()
+  external int buf;
+}
+
+final class CBLDart_FLTapeEntry extends Struct {
+  @Int8()
+  external int type;
+  @Bool()
+  external bool flag;
+  @Bool()
+  external bool isAscii;
+  @Int32()
+  external int sharedKey;
+  @Uint32()
+  external int size;
+  external CBLDart_FLTapeEntryPayload payload;
+}
+
+// ignore: camel_case_extensions
+extension CBLDart_FLTapeEntryExt on CBLDart_FLTapeEntry {
+  bool get isDictKey => type == dictKeyTapeEntryType;
+  FLValueType get valueType => type.toFLValueType();
+}
+
+final class CBLDart_FLStringInterner extends Opaque {}
+
+typedef _CBLDart_FLStringInterner_New = Pointer<CBLDart_FLStringInterner>
+    Function();
+
+typedef _CBLDart_FLStringInterner_Delete_C = Void Function(
+  Pointer<CBLDart_FLStringInterner> interner,
+);
+
+final class CBLDart_FLTape extends Struct {
+  external Pointer<CBLDart_FLTapeEntry> entries;
+  @Size()
+  external int count;
+  @Size()
+  external int capacity;
+}
+
+typedef _CBLDart_FLTape_New = Pointer<CBLDart_FLTape> Function();
+
+typedef _CBLDart_FLTape_Delete_C = Void Function(Pointer<CBLDart_FLTape> tape);
+
+typedef _CBLDart_FLTape_WriteValue_C = Bool Function(
+  Pointer<CBLDart_FLTape> tape,
+  Pointer<FLValue> value,
+  Pointer<KnownSharedKeys> knownSharedKeys,
+  Pointer<CBLDart_FLStringInterner> interner,
+  Pointer<Uint32> errorOut,
+);
+typedef _CBLDart_FLTape_WriteValue = bool Function(
+  Pointer<CBLDart_FLTape> tape,
+  Pointer<FLValue> value,
+  Pointer<KnownSharedKeys> knownSharedKeys,
+  Pointer<CBLDart_FLStringInterner> interner,
+  Pointer<Uint32> errorOut,
+);
+
+final class CBLDart_FLDictProjection extends Opaque {}
+
+typedef _CBLDart_FLDictProjection_New_C = Pointer<CBLDart_FLDictProjection>
+    Function(
+  Pointer<FLString> keyPaths,
+  Uint32 count,
+  Pointer<Uint32> errorOut,
+);
+typedef _CBLDart_FLDictProjection_New = Pointer<CBLDart_FLDictProjection>
+    Function(
+  Pointer<FLString> keyPaths,
+  int count,
+  Pointer<Uint32> errorOut,
+);
+
+typedef _CBLDart_FLDictProjection_Delete_C = Void Function(
+  Pointer<CBLDart_FLDictProjection> projection,
+);
+
+typedef _CBLDart_FLDictProjection_Eval_C = Void Function(
+  Pointer<CBLDart_FLDictProjection> projection,
+  Pointer<FLDict> dict,
+  Pointer<CBLDart_LoadedFLValue> valuesOut,
+);
+typedef _CBLDart_FLDictProjection_Eval = void Function(
+  Pointer<CBLDart_FLDictProjection> projection,
+  Pointer<FLDict> dict,
+  Pointer<CBLDart_LoadedFLValue> valuesOut,
+);
+
 final class FleeceDecoderBindings extends Bindings {
   FleeceDecoderBindings(super.parent) {
     _dumpData = libs.cbl.lookupFunction<_FLData_Dump_C, _FLData_Dump>(
@@ -1448,6 +1581,11 @@ final class FleeceDecoderBindings extends Bindings {
       'CBLDart_FLDictIterator_Next',
       isLeaf: useIsLeaf,
     );
+    _dictIteratorNextBatch = libs.cblDart.lookupFunction<
+        _CBLDart_FLDictIterator_NextBatch_C, _CBLDart_FLDictIterator_NextBatch>(
+      'CBLDart_FLDictIterator_NextBatch',
+      isLeaf: useIsLeaf,
+    );
     _arrayIteratorBegin = libs.cblDart.lookupFunction<
         _CBLDart_FLArrayIterator_Begin_C, _CBLDart_FLArrayIterator_Begin>(
       'CBLDart_FLArrayIterator_Begin',
@@ -1459,6 +1597,40 @@ final class FleeceDecoderBindings extends Bindings {
       'CBLDart_FLArrayIterator_Next',
       isLeaf: useIsLeaf,
     );
+    _arrayIteratorNextBatch = libs.cblDart.lookupFunction<
+        _CBLDart_FLArrayIterator_NextBatch_C,
+        _CBLDart_FLArrayIterator_NextBatch>(
+      'CBLDart_FLArrayIterator_NextBatch',
+      isLeaf: useIsLeaf,
+    );
+    _stringInternerNew = libs.cblDart.lookupFunction<
+        _CBLDart_FLStringInterner_New, _CBLDart_FLStringInterner_New>(
+      'CBLDart_FLStringInterner_New',
+    );
+    _stringInternerDeletePtr =
+        libs.cblDart.lookup('CBLDart_FLStringInterner_Delete');
+    _tapeNew =
+        libs.cblDart.lookupFunction<_CBLDart_FLTape_New, _CBLDart_FLTape_New>(
+      'CBLDart_FLTape_New',
+    );
+    _tapeDeletePtr = libs.cblDart.lookup('CBLDart_FLTape_Delete');
+    _tapeWriteValue = libs.cblDart.lookupFunction<_CBLDart_FLTape_WriteValue_C,
+        _CBLDart_FLTape_WriteValue>(
+      'CBLDart_FLTape_WriteValue',
+      isLeaf: useIsLeaf,
+    );
+    _dictProjectionNew = libs.cblDart.lookupFunction<
+        _CBLDart_FLDictProjection_New_C, _CBLDart_FLDictProjection_New>(
+      'CBLDart_FLDictProjection_New',
+      isLeaf: useIsLeaf,
+    );
+    _dictProjectionDeletePtr =
+        libs.cblDart.lookup('CBLDart_FLDictProjection_Delete');
+    _dictProjectionEval = libs.cblDart.lookupFunction<
+        _CBLDart_FLDictProjection_Eval_C, _CBLDart_FLDictProjection_Eval>(
+      'CBLDart_FLDictProjection_Eval',
+      isLeaf: useIsLeaf,
+    );
   }
 
   late final _FLData_Dump _dumpData;
@@ -1472,10 +1644,22 @@ final class FleeceDecoderBindings extends Bindings {
   late final Pointer<NativeFunction<_CBLDart_FLDictIterator_Delete_C>>
       _dictIteratorDeletePtr;
   late final _CBLDart_FLDictIterator_Next _dictIteratorNext;
+  late final _CBLDart_FLDictIterator_NextBatch _dictIteratorNextBatch;
   late final _CBLDart_FLArrayIterator_Begin _arrayIteratorBegin;
   late final Pointer<NativeFunction<_CBLDart_FLArrayIterator_Delete_C>>
       _arrayIteratorDeletePtr;
   late final _CBLDart_FLArrayIterator_Next _arrayIteratorNext;
+  late final _CBLDart_FLArrayIterator_NextBatch _arrayIteratorNextBatch;
+  late final _CBLDart_FLStringInterner_New _stringInternerNew;
+  late final Pointer<NativeFunction<_CBLDart_FLStringInterner_Delete_C>>
+      _stringInternerDeletePtr;
+  late final _CBLDart_FLTape_New _tapeNew;
+  late final Pointer<NativeFunction<_CBLDart_FLTape_Delete_C>> _tapeDeletePtr;
+  late final _CBLDart_FLTape_WriteValue _tapeWriteValue;
+  late final _CBLDart_FLDictProjection_New _dictProjectionNew;
+  late final Pointer<NativeFunction<_CBLDart_FLDictProjection_Delete_C>>
+      _dictProjectionDeletePtr;
+  late final _CBLDart_FLDictProjection_Eval _dictProjectionEval;
 
   late final _knownSharedKeysFinalizer =
       NativeFinalizer(_knownSharedKeysDeletePtr.cast());
@@ -1483,6 +1667,11 @@ final class FleeceDecoderBindings extends Bindings {
       NativeFinalizer(_dictIteratorDeletePtr.cast());
   late final _arrayIteratorFinalizer =
       NativeFinalizer(_arrayIteratorDeletePtr.cast());
+  late final _stringInternerFinalizer =
+      NativeFinalizer(_stringInternerDeletePtr.cast());
+  late final _tapeFinalizer = NativeFinalizer(_tapeDeletePtr.cast());
+  late final _dictProjectionFinalizer =
+      NativeFinalizer(_dictProjectionDeletePtr.cast());
 
   String dumpData(Data data) => _dumpData(data.toSliceResult().makeGlobal().ref)
       .toDartStringAndRelease()!;
@@ -1540,6 +1729,14 @@ final class FleeceDecoderBindings extends Bindings {
   bool dictIteratorNext(Pointer<CBLDart_FLDictIterator> iterator) =>
       _dictIteratorNext(iterator);
 
+  int dictIteratorNextBatch(
+    Pointer<CBLDart_FLDictIterator> iterator,
+    Pointer<CBLDart_LoadedDictKey> keysOut,
+    Pointer<CBLDart_LoadedFLValue> valuesOut,
+    int capacity,
+  ) =>
+      _dictIteratorNextBatch(iterator, keysOut, valuesOut, capacity);
+
   Pointer<CBLDart_FLArrayIterator> arrayIteratorBegin(
     Finalizable? object,
     Pointer<FLArray> array,
@@ -1556,6 +1753,76 @@ final class FleeceDecoderBindings extends Bindings {
 
   bool arrayIteratorNext(Pointer<CBLDart_FLArrayIterator> iterator) =>
       _arrayIteratorNext(iterator);
+
+  int arrayIteratorNextBatch(
+    Pointer<CBLDart_FLArrayIterator> iterator,
+    Pointer<CBLDart_LoadedFLValue> valuesOut,
+    int capacity,
+  ) =>
+      _arrayIteratorNextBatch(iterator, valuesOut, capacity);
+
+  Pointer<CBLDart_FLStringInterner> createStringInterner(Finalizable object) {
+    final result = _stringInternerNew();
+    _stringInternerFinalizer.attach(object, result.cast());
+    return result;
+  }
+
+  Pointer<CBLDart_FLTape> createTape(Finalizable object) {
+    final result = _tapeNew();
+    _tapeFinalizer.attach(object, result.cast());
+    return result;
+  }
+
+  void writeTape(
+    Pointer<CBLDart_FLTape> tape,
+    Pointer<FLValue> value,
+    Pointer<KnownSharedKeys> knownSharedKeys,
+    Pointer<CBLDart_FLStringInterner> interner,
+  ) {
+    if (!_tapeWriteValue(
+      tape,
+      value,
+      knownSharedKeys,
+      interner,
+      globalFLErrorCode,
+    )) {
+      _checkFleeceError();
+    }
+  }
+
+  Pointer<CBLDart_FLDictProjection> createDictProjection(
+    Finalizable object,
+    List<String> keyPaths,
+  ) =>
+      withGlobalArena(() {
+        final flKeyPaths = globalArena<FLString>(keyPaths.length);
+        for (var i = 0; i < keyPaths.length; i++) {
+          final keyPath = nativeUtf8StringEncoder.encode(
+            keyPaths[i],
+            globalArena,
+          );
+          flKeyPaths[i]
+            ..buf = keyPath.buffer
+            ..size = keyPath.size;
+        }
+
+        final result = _dictProjectionNew(
+          flKeyPaths,
+          keyPaths.length,
+          globalFLErrorCode,
+        ).checkFleeceError();
+
+        _dictProjectionFinalizer.attach(object, result.cast());
+
+        return result;
+      });
+
+  void evalDictProjection(
+    Pointer<CBLDart_FLDictProjection> projection,
+    Pointer<FLDict> dict,
+    Pointer<CBLDart_LoadedFLValue> valuesOut,
+  ) =>
+      _dictProjectionEval(projection, dict, valuesOut);
 }
 
 // === Encoder =================================================================
@@ -1597,72 +1864,15 @@ typedef _FLEncoder_SetSharedKeys = void Function(
 typedef _FLEncoder_Reset_C = Void Function(Pointer<FLEncoder> encoder);
 typedef _FLEncoder_Reset = void Function(Pointer<FLEncoder> encoder);
 
-typedef _CBLDart_FLEncoder_WriteArrayValue_C = Bool Function(
-  Pointer<FLEncoder> encoder,
-  Pointer<FLArray> array,
-  Uint32 index,
-);
-typedef _CBLDart_FLEncoder_WriteArrayValue = bool Function(
-  Pointer<FLEncoder> encoder,
-  Pointer<FLArray> array,
-  int index,
-);
-
-typedef _FLEncoder_WriteValue_C = Bool Function(
-  Pointer<FLEncoder> encoder,
-  Pointer<FLValue> value,
-);
-typedef _FLEncoder_WriteValue = bool Function(
-  Pointer<FLEncoder> encoder,
-  Pointer<FLValue> value,
-);
-
-typedef _FLEncoder_WriteNull_C = Bool Function(Pointer<FLEncoder> encoder);
-typedef _FLEncoder_WriteNull = bool Function(Pointer<FLEncoder> encoder);
-
-typedef _FLEncoder_WriteBool_C = Bool Function(
-  Pointer<FLEncoder> encoder,
-  Bool value,
-);
-typedef _FLEncoder_WriteBool = bool Function(
-  Pointer<FLEncoder> encoder,
-  bool value,
-);
-
-typedef _FLEncoder_WriteInt_C = Bool Function(
-  Pointer<FLEncoder> encoder,
-  Int64 value,
-);
-typedef _FLEncoder_WriteInt = bool Function(
-  Pointer<FLEncoder> encoder,
-  int value,
-);
-
-typedef _FLEncoder_WriteDouble_C = Bool Function(
-  Pointer<FLEncoder> encoder,
-  Double value,
-);
-typedef _FLEncoder_WriteDouble = bool Function(
-  Pointer<FLEncoder> encoder,
-  double value,
-);
-
-typedef _FLEncoder_WriteString_C = Bool Function(
-  Pointer<FLEncoder> encoder,
-  FLString value,
-);
-typedef _FLEncoder_WriteString = bool Function(
-  Pointer<FLEncoder> encoder,
-  FLString value,
-);
-
-typedef _FLEncoder_WriteData_C = Bool Function(
+typedef _CBLDart_FLEncoder_WriteTape_C = Bool Function(
   Pointer<FLEncoder> encoder,
-  FLSlice value,
+  Pointer<Uint8> tape,
+  Size size,
 );
-typedef _FLEncoder_WriteData = bool Function(
+typedef _CBLDart_FLEncoder_WriteTape = bool Function(
   Pointer<FLEncoder> encoder,
-  FLSlice value,
+  Pointer<Uint8> tape,
+  int size,
 );
 
 typedef _FLEncoder_ConvertJSON_C = Bool Function(
@@ -1674,48 +1884,6 @@ typedef _FLEncoder_ConvertJSON = bool Function(
   FLString value,
 );
 
-typedef _FLEncoder_BeginArray_C = Bool Function(
-  Pointer<FLEncoder> encoder,
-  Size reserveCount,
-);
-typedef _FLEncoder_BeginArray = bool Function(
-  Pointer<FLEncoder> encoder,
-  int reserveCount,
-);
-
-typedef _FLEncoder_EndArray_C = Bool Function(Pointer<FLEncoder> encoder);
-typedef _FLEncoder_EndArray = bool Function(Pointer<FLEncoder> encoder);
-
-typedef _FLEncoder_BeginDict_C = Bool Function(
-  Pointer<FLEncoder> encoder,
-  Size reserveCount,
-);
-typedef _FLEncoder_BeginDict = bool Function(
-  Pointer<FLEncoder> encoder,
-  int reserveCount,
-);
-
-typedef _FLEncoder_WriteKey_C = Bool Function(
-  Pointer<FLEncoder> encoder,
-  FLString key,
-);
-typedef _FLEncoder_WriteKey = bool Function(
-  Pointer<FLEncoder> encoder,
-  FLString key,
-);
-
-typedef _FLEncoder_WriteKeyValue_C = Bool Function(
-  Pointer<FLEncoder> encoder,
-  Pointer<FLValue> key,
-);
-typedef _FLEncoder_WriteKeyValue = bool Function(
-  Pointer<FLEncoder> encoder,
-  Pointer<FLValue> key,
-);
-
-typedef _FLEncoder_EndDict_C = Bool Function(Pointer<FLEncoder> encoder);
-typedef _FLEncoder_EndDict = bool Function(Pointer<FLEncoder> encoder);
-
 typedef _FLEncoder_Finish_C = FLSliceResult Function(
   Pointer<FLEncoder> encoder,
   Pointer<Uint32> errorOut,
@@ -1735,6 +1903,27 @@ typedef _FLEncoder_GetErrorMessage = Pointer<Utf8> Function(
   Pointer<FLEncoder> encoder,
 );
 
+final class CBLDart_FLJSONBuffer extends Struct {
+  external Pointer<Uint8> buf;
+  @Size()
+  external int size;
+  @Size()
+  external int capacity;
+}
+
+typedef _CBLDart_FLJSONBuffer_New = Pointer<CBLDart_FLJSONBuffer> Function();
+
+typedef _CBLDart_FLJSONBuffer_Delete_C = Void Function(
+  Pointer<CBLDart_FLJSONBuffer> buffer,
+);
+
+typedef _CBLDart_FLJSONBuffer_Clear_C = Void Function(
+  Pointer<CBLDart_FLJSONBuffer> buffer,
+);
+typedef _CBLDart_FLJSONBuffer_Clear = void Function(
+  Pointer<CBLDart_FLJSONBuffer> buffer,
+);
+
 final class FleeceEncoderBindings extends Bindings {
   FleeceEncoderBindings(super.parent) {
     _new = libs.cbl
@@ -1752,45 +1941,19 @@ final class FleeceEncoderBindings extends Bindings {
       'FLEncoder_Reset',
       isLeaf: useIsLeaf,
     );
-    _writeArrayValue = libs.cblDart.lookupFunction<
-        _CBLDart_FLEncoder_WriteArrayValue_C,
-        _CBLDart_FLEncoder_WriteArrayValue>(
-      'CBLDart_FLEncoder_WriteArrayValue',
-      isLeaf: useIsLeaf,
-    );
-    _writeValue =
-        libs.cbl.lookupFunction<_FLEncoder_WriteValue_C, _FLEncoder_WriteValue>(
-      'FLEncoder_WriteValue',
-      isLeaf: useIsLeaf,
-    );
-    _writeNull =
-        libs.cbl.lookupFunction<_FLEncoder_WriteNull_C, _FLEncoder_WriteNull>(
-      'FLEncoder_WriteNull',
-      isLeaf: useIsLeaf,
-    );
-    _writeBool =
-        libs.cbl.lookupFunction<_FLEncoder_WriteBool_C, _FLEncoder_WriteBool>(
-      'FLEncoder_WriteBool',
-      isLeaf: useIsLeaf,
-    );
-    _writeInt =
-        libs.cbl.lookupFunction<_FLEncoder_WriteInt_C, _FLEncoder_WriteInt>(
-      'FLEncoder_WriteInt',
-      isLeaf: useIsLeaf,
-    );
-    _writeDouble = libs.cbl
-        .lookupFunction<_FLEncoder_WriteDouble_C, _FLEncoder_WriteDouble>(
-      'FLEncoder_WriteDouble',
-      isLeaf: useIsLeaf,
+    _jsonBufferNew = libs.cblDart.lookupFunction<_CBLDart_FLJSONBuffer_New,
+        _CBLDart_FLJSONBuffer_New>(
+      'CBLDart_FLJSONBuffer_New',
     );
-    _writeString = libs.cbl
-        .lookupFunction<_FLEncoder_WriteString_C, _FLEncoder_WriteString>(
-      'FLEncoder_WriteString',
+    _jsonBufferDeletePtr = libs.cblDart.lookup('CBLDart_FLJSONBuffer_Delete');
+    _jsonBufferClear = libs.cblDart.lookupFunction<
+        _CBLDart_FLJSONBuffer_Clear_C, _CBLDart_FLJSONBuffer_Clear>(
+      'CBLDart_FLJSONBuffer_Clear',
       isLeaf: useIsLeaf,
     );
-    _writeData =
-        libs.cbl.lookupFunction<_FLEncoder_WriteData_C, _FLEncoder_WriteData>(
-      'FLEncoder_WriteData',
+    _writeTape = libs.cblDart.lookupFunction<_CBLDart_FLEncoder_WriteTape_C,
+        _CBLDart_FLEncoder_WriteTape>(
+      'CBLDart_FLEncoder_WriteTape',
       isLeaf: useIsLeaf,
     );
     _writeJSON = libs.cbl
@@ -1798,36 +1961,6 @@ final class FleeceEncoderBindings extends Bindings {
       'FLEncoder_ConvertJSON',
       isLeaf: useIsLeaf,
     );
-    _beginArray =
-        libs.cbl.lookupFunction<_FLEncoder_BeginArray_C, _FLEncoder_BeginArray>(
-      'FLEncoder_BeginArray',
-      isLeaf: useIsLeaf,
-    );
-    _endArray =
-        libs.cbl.lookupFunction<_FLEncoder_EndArray_C, _FLEncoder_EndArray>(
-      'FLEncoder_EndArray',
-      isLeaf: useIsLeaf,
-    );
-    _beginDict =
-        libs.cbl.lookupFunction<_FLEncoder_BeginDict_C, _FLEncoder_BeginDict>(
-      'FLEncoder_BeginDict',
-      isLeaf: useIsLeaf,
-    );
-    _writeKey =
-        libs.cbl.lookupFunction<_FLEncoder_WriteKey_C, _FLEncoder_WriteKey>(
-      'FLEncoder_WriteKey',
-      isLeaf: useIsLeaf,
-    );
-    _writeKeyValue = libs.cbl
-        .lookupFunction<_FLEncoder_WriteKeyValue_C, _FLEncoder_WriteKeyValue>(
-      'FLEncoder_WriteKeyValue',
-      isLeaf: useIsLeaf,
-    );
-    _endDict =
-        libs.cbl.lookupFunction<_FLEncoder_EndDict_C, _FLEncoder_EndDict>(
-      'FLEncoder_EndDict',
-      isLeaf: useIsLeaf,
-    );
     _finish = libs.cbl.lookupFunction<_FLEncoder_Finish_C, _FLEncoder_Finish>(
       'FLEncoder_Finish',
       isLeaf: useIsLeaf,
@@ -1848,31 +1981,34 @@ final class FleeceEncoderBindings extends Bindings {
   late final Pointer<NativeFunction<_FLEncoder_Free_C>> _freePtr;
   late final _FLEncoder_SetSharedKeys _setSharedKeys;
   late final _FLEncoder_Reset _reset;
-  late final _CBLDart_FLEncoder_WriteArrayValue _writeArrayValue;
-  late final _FLEncoder_WriteValue _writeValue;
-  late final _FLEncoder_WriteNull _writeNull;
-  late final _FLEncoder_WriteBool _writeBool;
-  late final _FLEncoder_WriteInt _writeInt;
-  late final _FLEncoder_WriteDouble _writeDouble;
-  late final _FLEncoder_WriteString _writeString;
-  late final _FLEncoder_WriteData _writeData;
+  late final _CBLDart_FLJSONBuffer_New _jsonBufferNew;
+  late final Pointer<NativeFunction<_CBLDart_FLJSONBuffer_Delete_C>>
+      _jsonBufferDeletePtr;
+  late final _CBLDart_FLJSONBuffer_Clear _jsonBufferClear;
+  late final _CBLDart_FLEncoder_WriteTape _writeTape;
   late final _FLEncoder_ConvertJSON _writeJSON;
-  late final _FLEncoder_BeginArray _beginArray;
-  late final _FLEncoder_EndArray _endArray;
-  late final _FLEncoder_BeginDict _beginDict;
-  late final _FLEncoder_WriteKey _writeKey;
-  late final _FLEncoder_WriteKeyValue _writeKeyValue;
-  late final _FLEncoder_EndDict _endDict;
   late final _FLEncoder_Finish _finish;
   late final _FLEncoder_GetError __getError;
   late final _FLEncoder_GetErrorMessage __getErrorMessage;
 
   late final _finalizer = NativeFinalizer(_freePtr.cast());
+  late final _jsonBufferFinalizer =
+      NativeFinalizer(_jsonBufferDeletePtr.cast());
 
   void bindToDartObject(Finalizable object, Pointer<FLEncoder> encoder) {
     _finalizer.attach(object, encoder.cast());
   }
 
+  Pointer<CBLDart_FLJSONBuffer> createJsonBuffer(Finalizable object) {
+    final result = _jsonBufferNew();
+    _jsonBufferFinalizer.attach(object, result.cast());
+    return result;
+  }
+
+  void clearJsonBuffer(Pointer<CBLDart_FLJSONBuffer> buffer) {
+    _jsonBufferClear(buffer);
+  }
+
   Pointer<FLEncoder> create({
     required FLEncoderFormat format,
     required int reserveSize,
@@ -1888,50 +2024,8 @@ final class FleeceEncoderBindings extends Bindings {
     _reset(encoder);
   }
 
-  void writeArrayValue(
-    Pointer<FLEncoder> encoder,
-    Pointer<FLArray> array,
-    int index,
-  ) {
-    _checkError(encoder, _writeArrayValue(encoder, array, index));
-  }
-
-  void writeValue(Pointer<FLEncoder> encoder, Pointer<FLValue> value) {
-    if (value == nullptr) {
-      throw ArgumentError.value(value, 'value', 'must not be `nullptr`');
-    }
-
-    _checkError(encoder, _writeValue(encoder, value));
-  }
-
-  void writeNull(Pointer<FLEncoder> encoder) {
-    _checkError(encoder, _writeNull(encoder));
-  }
-
-  void writeBool(Pointer<FLEncoder> encoder, bool value) {
-    _checkError(encoder, _writeBool(encoder, value));
-  }
-
-  void writeInt(Pointer<FLEncoder> encoder, int value) {
-    _checkError(encoder, _writeInt(encoder, value));
-  }
-
-  void writeDouble(Pointer<FLEncoder> encoder, double value) {
-    _checkError(encoder, _writeDouble(encoder, value));
-  }
-
-  void writeString(Pointer<FLEncoder> encoder, String value) {
-    runWithSingleFLString(value, (flValue) {
-      _checkError(encoder, _writeString(encoder, flValue));
-    });
-  }
-
-  void writeData(Pointer<FLEncoder> encoder, Data value) {
-    final sliceResult = value.toSliceResult();
-    _checkError(
-      encoder,
-      _writeData(encoder, sliceResult.makeGlobal().ref),
-    );
+  void writeTape(Pointer<FLEncoder> encoder, Pointer<Uint8> tape, int size) {
+    _checkError(encoder, _writeTape(encoder, tape, size));
   }
 
   void writeJSON(Pointer<FLEncoder> encoder, Data value) {
@@ -1945,36 +2039,6 @@ final class FleeceEncoderBindings extends Bindings {
     );
   }
 
-  void beginArray(Pointer<FLEncoder> encoder, int reserveCount) {
-    _checkError(encoder, _beginArray(encoder, reserveCount));
-  }
-
-  void endArray(Pointer<FLEncoder> encoder) {
-    _checkError(encoder, _endArray(encoder));
-  }
-
-  void beginDict(Pointer<FLEncoder> encoder, int reserveCount) {
-    _checkError(encoder, _beginDict(encoder, reserveCount));
-  }
-
-  void writeKey(Pointer<FLEncoder> encoder, String key) {
-    runWithSingleFLString(key, (flKey) {
-      _checkError(encoder, _writeKey(encoder, flKey));
-    });
-  }
-
-  void writeKeyFLString(Pointer<FLEncoder> encoder, FLString key) {
-    _checkError(encoder, _writeKey(encoder, key));
-  }
-
-  void writeKeyValue(Pointer<FLEncoder> encoder, Pointer<FLValue> key) {
-    _checkError(encoder, _writeKeyValue(encoder, key));
-  }
-
-  void endDict(Pointer<FLEncoder> encoder) {
-    _checkError(encoder, _endDict(encoder));
-  }
-
   Data? finish(Pointer<FLEncoder> encoder) =>
       _checkError(encoder, _finish(encoder, globalFLErrorCode))
           .let(SliceResult.fromFLSliceResult)
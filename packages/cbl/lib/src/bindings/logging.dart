@@ -64,19 +64,35 @@ typedef _CBLLog_SetConsoleLevel = void Function(int logLevel);
 typedef _CBLDart_CBLLog_SetCallbackLevel_C = Void Function(Uint8 logLevel);
 typedef _CBLDart_CBLLog_SetCallbackLevel = void Function(int logLevel);
 
+typedef _CBLDart_CBLLog_SetCallbackDomainLevel_C = Void Function(
+  Uint8 domain,
+  Uint8 logLevel,
+);
+typedef _CBLDart_CBLLog_SetCallbackDomainLevel = void Function(
+  int domain,
+  int logLevel,
+);
+
 final class LogCallbackMessage {
   LogCallbackMessage(this.domain, this.level, this.message);
 
-  LogCallbackMessage.fromArguments(List<Object?> arguments)
-      : this(
-          (arguments[0] as int).toLogDomain(),
-          (arguments[1] as int).toLogLevel(),
-          utf8.decode(arguments[2] as Uint8List, allowMalformed: true),
-        );
-
   final CBLLogDomain domain;
   final CBLLogLevel level;
   final String message;
+
+  /// Parses a batch of messages, whose domains, levels and messages are
+  /// interleaved in [arguments].
+  static List<LogCallbackMessage> batchFromArguments(
+    List<Object?> arguments,
+  ) =>
+      List.generate(
+        arguments.length ~/ 3,
+        (i) => LogCallbackMessage(
+          (arguments[i * 3] as int).toLogDomain(),
+          (arguments[i * 3 + 1] as int).toLogLevel(),
+          utf8.decode(arguments[i * 3 + 2] as Uint8List, allowMalformed: true),
+        ),
+      );
 }
 
 typedef _CBLDart_CBLLog_SetCallback_C = Bool Function(
@@ -192,6 +208,12 @@ final class LoggingBindings extends Bindings {
       'CBLDart_CBLLog_SetCallbackLevel',
       isLeaf: useIsLeaf,
     );
+    _setCallbackDomainLevel = libs.cblDart.lookupFunction<
+        _CBLDart_CBLLog_SetCallbackDomainLevel_C,
+        _CBLDart_CBLLog_SetCallbackDomainLevel>(
+      'CBLDart_CBLLog_SetCallbackDomainLevel',
+      isLeaf: useIsLeaf,
+    );
     _setCallback = libs.cblDart.lookupFunction<_CBLDart_CBLLog_SetCallback_C,
         _CBLDart_CBLLog_SetCallback>(
       'CBLDart_CBLLog_SetCallback',
@@ -219,6 +241,7 @@ final class LoggingBindings extends Bindings {
   late final _CBLLog_ConsoleLevel _consoleLevel;
   late final _CBLLog_SetConsoleLevel _setConsoleLevel;
   late final _CBLDart_CBLLog_SetCallbackLevel _setCallbackLevel;
+  late final _CBLDart_CBLLog_SetCallbackDomainLevel _setCallbackDomainLevel;
   late final _CBLDart_CBLLog_SetCallback _setCallback;
   late final _CBLDart_CBLLog_SetFileConfig _setFileConfig;
   late final _CBLDart_CBLLog_GetFileConfig _getFileConfig;
@@ -245,6 +268,10 @@ final class LoggingBindings extends Bindings {
     _setCallbackLevel(logLevel.toInt());
   }
 
+  void setCallbackDomainLevel(CBLLogDomain domain, CBLLogLevel logLevel) {
+    _setCallbackDomainLevel(domain.toInt(), logLevel.toInt());
+  }
+
   bool setCallback(Pointer<CBLDartAsyncCallback> callback) =>
       _setCallback(callback);
 
@@ -1,14 +1,21 @@
 // ignore: lines_longer_than_80_chars
 // ignore_for_file: avoid_redundant_argument_values, avoid_private_typedef_functions, camel_case_types
 
+import 'dart:convert';
 import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
 
 import 'async_callback.dart';
 import 'base.dart';
 import 'bindings.dart';
+import 'collection.dart';
 import 'database.dart';
+import 'document.dart';
 import 'fleece.dart';
 import 'global.dart';
+import 'slice.dart';
 import 'tracing.dart';
 import 'utils.dart';
 
@@ -23,14 +30,14 @@ extension CBLQueryLanguageExt on CBLQueryLanguage {
 
 final class CBLQuery extends Opaque {}
 
-typedef _CBLDatabase_CreateQuery_C = Pointer<CBLQuery> Function(
+typedef _CBLDart_QueryCache_CreateQuery_C = Pointer<CBLQuery> Function(
   Pointer<CBLDatabase> db,
   Uint32 language,
   FLString queryString,
   Pointer<Int> errorPosOut,
   Pointer<CBLError> errorOut,
 );
-typedef _CBLDatabase_CreateQuery = Pointer<CBLQuery> Function(
+typedef _CBLDart_QueryCache_CreateQuery = Pointer<CBLQuery> Function(
   Pointer<CBLDatabase> db,
   int language,
   FLString queryString,
@@ -38,6 +45,32 @@ typedef _CBLDatabase_CreateQuery = Pointer<CBLQuery> Function(
   Pointer<CBLError> errorOut,
 );
 
+typedef _CBLDart_QueryCache_ReleaseQuery = Void Function(
+  Pointer<CBLQuery> query,
+);
+
+typedef _CBLDart_QueryCache_SetCapacity_C = Void Function(Size capacity);
+typedef _CBLDart_QueryCache_SetCapacity = void Function(int capacity);
+
+final class CBLDart_QueryCacheStats extends Struct {
+  @Uint64()
+  external int hits;
+
+  @Uint64()
+  external int misses;
+
+  @Uint64()
+  external int evictions;
+
+  @Size()
+  external int size;
+
+  @Size()
+  external int capacity;
+}
+
+typedef _CBLDart_QueryCache_Stats = CBLDart_QueryCacheStats Function();
+
 typedef _CBLQuery_SetParameters_C = Void Function(
   Pointer<CBLQuery> query,
   Pointer<FLDict> parameters,
@@ -79,14 +112,149 @@ typedef _CBLDart_CBLQuery_AddChangeListener_C = Pointer<CBLListenerToken>
     Function(
   Pointer<CBLDatabase> db,
   Pointer<CBLQuery> query,
+  Uint32 minIntervalMs,
   Pointer<CBLDartAsyncCallback> listener,
 );
 typedef _CBLDart_CBLQuery_AddChangeListener = Pointer<CBLListenerToken>
     Function(
   Pointer<CBLDatabase> db,
   Pointer<CBLQuery> query,
+  int minIntervalMs,
   Pointer<CBLDartAsyncCallback> listener,
 );
+
+typedef _CBLDart_CBLQuery_SetChangeListenerPaused_C = Void Function(
+  Pointer<CBLDartAsyncCallback> listener,
+  Bool paused,
+);
+typedef _CBLDart_CBLQuery_SetChangeListenerPaused = void Function(
+  Pointer<CBLDartAsyncCallback> listener,
+  bool paused,
+);
+typedef _CBLDart_CBLQuery_AddDiffListener_C = Void Function(
+  Pointer<CBLDatabase> db,
+  Pointer<CBLQuery> query,
+  Int keyColumn,
+  Pointer<CBLDartAsyncCallback> listener,
+);
+typedef _CBLDart_CBLQuery_AddDiffListener = void Function(
+  Pointer<CBLDatabase> db,
+  Pointer<CBLQuery> query,
+  int keyColumn,
+  Pointer<CBLDartAsyncCallback> listener,
+);
+
+typedef _CBLDart_CBLQuery_ExecuteAsync_C = Void Function(
+  Pointer<CBLDatabase> db,
+  Pointer<CBLQuery> query,
+  Uint32 batchSize,
+  Pointer<CBLDartAsyncCallback> callback,
+);
+typedef _CBLDart_CBLQuery_ExecuteAsync = void Function(
+  Pointer<CBLDatabase> db,
+  Pointer<CBLQuery> query,
+  int batchSize,
+  Pointer<CBLDartAsyncCallback> callback,
+);
+
+/// A message which is sent by the native side to the callback of
+/// [QueryBindings.executeAsync].
+final class QueryExecutionCallbackMessage {
+  QueryExecutionCallbackMessage({required this.rows, required this.isLast})
+      : error = null;
+
+  QueryExecutionCallbackMessage.error(CBLErrorException this.error)
+      : rows = null,
+        isLast = true;
+
+  factory QueryExecutionCallbackMessage.fromArguments(
+    List<Object?> arguments,
+  ) {
+    if (arguments.length == 3) {
+      final domain = (arguments[0] as int).toErrorDomain();
+      final code = (arguments[1] as int).toErrorCode(domain);
+      final message = arguments[2] as Uint8List?;
+      return QueryExecutionCallbackMessage.error(CBLErrorException(
+        domain,
+        code,
+        message == null ? '' : utf8.decode(message, allowMalformed: true),
+      ));
+    }
+
+    // The rows are retained while the native side waits for the call to
+    // return, instead of being copied into the message.
+    final rows = arguments[0]! as List<Object?>;
+    return QueryExecutionCallbackMessage(
+      rows: SliceResult.retainAddress(rows[0]! as int, rows[1]! as int),
+      isLast: arguments[1]! as bool,
+    );
+  }
+
+  /// The Fleece encoded array of the rows of a batch.
+  final SliceResult? rows;
+
+  /// Whether this is the last message of the execution.
+  final bool isLast;
+
+  final CBLErrorException? error;
+}
+
+final class QueryDiffCallbackMessage {
+  QueryDiffCallbackMessage({
+    required this.length,
+    required this.removed,
+    required this.inserted,
+    required this.movedFrom,
+    required this.movedTo,
+    required this.changed,
+    required this.rows,
+  }) : error = null;
+
+  QueryDiffCallbackMessage.error(CBLErrorException this.error)
+      : length = 0,
+        removed = Int32List(0),
+        inserted = Int32List(0),
+        movedFrom = Int32List(0),
+        movedTo = Int32List(0),
+        changed = Int32List(0),
+        rows = null;
+
+  factory QueryDiffCallbackMessage.fromArguments(List<Object?> arguments) {
+    if (arguments.length == 3) {
+      final domain = (arguments[0] as int).toErrorDomain();
+      final code = (arguments[1] as int).toErrorCode(domain);
+      final message = arguments[2] as Uint8List?;
+      return QueryDiffCallbackMessage.error(CBLErrorException(
+        domain,
+        code,
+        message == null ? '' : utf8.decode(message, allowMalformed: true),
+      ));
+    }
+
+    return QueryDiffCallbackMessage(
+      length: arguments[0] as int,
+      removed: arguments[1] as Int32List,
+      inserted: arguments[2] as Int32List,
+      movedFrom: arguments[3] as Int32List,
+      movedTo: arguments[4] as Int32List,
+      changed: arguments[5] as Int32List,
+      rows: arguments[6] as Uint8List?,
+    );
+  }
+
+  final int length;
+  final Int32List removed;
+  final Int32List inserted;
+  final Int32List movedFrom;
+  final Int32List movedTo;
+  final Int32List changed;
+
+  /// The Fleece encoded array of the inserted and changed rows.
+  final Uint8List? rows;
+
+  final CBLErrorException? error;
+}
+
 typedef _CBLQuery_CopyCurrentResults = Pointer<CBLResultSet> Function(
   Pointer<CBLQuery> query,
   Pointer<CBLListenerToken> listenerToken,
@@ -95,9 +263,20 @@ typedef _CBLQuery_CopyCurrentResults = Pointer<CBLResultSet> Function(
 
 final class QueryBindings extends Bindings {
   QueryBindings(super.parent) {
-    _createQuery = libs.cbl
-        .lookupFunction<_CBLDatabase_CreateQuery_C, _CBLDatabase_CreateQuery>(
-      'CBLDatabase_CreateQuery',
+    _createQuery = libs.cblDart.lookupFunction<
+        _CBLDart_QueryCache_CreateQuery_C, _CBLDart_QueryCache_CreateQuery>(
+      'CBLDart_QueryCache_CreateQuery',
+      isLeaf: useIsLeaf,
+    );
+    _releasePtr = libs.cblDart.lookup('CBLDart_QueryCache_ReleaseQuery');
+    _setCacheCapacity = libs.cblDart.lookupFunction<
+        _CBLDart_QueryCache_SetCapacity_C, _CBLDart_QueryCache_SetCapacity>(
+      'CBLDart_QueryCache_SetCapacity',
+      isLeaf: useIsLeaf,
+    );
+    _cacheStats = libs.cblDart
+        .lookupFunction<_CBLDart_QueryCache_Stats, _CBLDart_QueryCache_Stats>(
+      'CBLDart_QueryCache_Stats',
       isLeaf: useIsLeaf,
     );
     _setParameters = libs.cbl
@@ -134,6 +313,23 @@ final class QueryBindings extends Bindings {
       'CBLDart_CBLQuery_AddChangeListener',
       isLeaf: useIsLeaf,
     );
+    _setChangeListenerPaused = libs.cblDart.lookupFunction<
+        _CBLDart_CBLQuery_SetChangeListenerPaused_C,
+        _CBLDart_CBLQuery_SetChangeListenerPaused>(
+      'CBLDart_CBLQuery_SetChangeListenerPaused',
+      isLeaf: useIsLeaf,
+    );
+    _addDiffListener = libs.cblDart.lookupFunction<
+        _CBLDart_CBLQuery_AddDiffListener_C,
+        _CBLDart_CBLQuery_AddDiffListener>(
+      'CBLDart_CBLQuery_AddDiffListener',
+      isLeaf: useIsLeaf,
+    );
+    _executeAsync = libs.cblDart.lookupFunction<
+        _CBLDart_CBLQuery_ExecuteAsync_C, _CBLDart_CBLQuery_ExecuteAsync>(
+      'CBLDart_CBLQuery_ExecuteAsync',
+      isLeaf: useIsLeaf,
+    );
     _copyCurrentResults = libs.cbl.lookupFunction<_CBLQuery_CopyCurrentResults,
         _CBLQuery_CopyCurrentResults>(
       'CBLQuery_CopyCurrentResults',
@@ -141,7 +337,11 @@ final class QueryBindings extends Bindings {
     );
   }
 
-  late final _CBLDatabase_CreateQuery _createQuery;
+  late final _CBLDart_QueryCache_CreateQuery _createQuery;
+  late final Pointer<NativeFunction<_CBLDart_QueryCache_ReleaseQuery>>
+      _releasePtr;
+  late final _CBLDart_QueryCache_SetCapacity _setCacheCapacity;
+  late final _CBLDart_QueryCache_Stats _cacheStats;
   late final _CBLQuery_SetParameters _setParameters;
   late final _CBLQuery_Parameters _parameters;
   late final _CBLQuery_Execute _execute;
@@ -149,8 +349,19 @@ final class QueryBindings extends Bindings {
   late final _CBLQuery_ColumnCount _columnCount;
   late final _CBLQuery_ColumnName _columnName;
   late final _CBLDart_CBLQuery_AddChangeListener _addChangeListener;
+  late final _CBLDart_CBLQuery_SetChangeListenerPaused
+      _setChangeListenerPaused;
+  late final _CBLDart_CBLQuery_AddDiffListener _addDiffListener;
+  late final _CBLDart_CBLQuery_ExecuteAsync _executeAsync;
   late final _CBLQuery_CopyCurrentResults _copyCurrentResults;
 
+  late final _finalizer = NativeFinalizer(_releasePtr.cast());
+
+  /// Creates a query, or reuses an idle query with the same [language] and
+  /// [queryString] from the query cache.
+  ///
+  /// The query must be bound to a Dart object with [bindToDartObject], which
+  /// gives it back to the query cache when the object is finalized.
   Pointer<CBLQuery> create(
     Pointer<CBLDatabase> db,
     CBLQueryLanguage language,
@@ -171,6 +382,14 @@ final class QueryBindings extends Bindings {
         ).checkCBLError(errorSource: queryString);
       });
 
+  void bindToDartObject(Finalizable object, Pointer<CBLQuery> query) {
+    _finalizer.attach(object, query.cast());
+  }
+
+  void setCacheCapacity(int capacity) => _setCacheCapacity(capacity);
+
+  CBLDart_QueryCacheStats cacheStats() => _cacheStats();
+
   void setParameters(Pointer<CBLQuery> query, Pointer<FLDict> parameters) {
     _setParameters(query, parameters);
   }
@@ -191,12 +410,49 @@ final class QueryBindings extends Bindings {
   String columnName(Pointer<CBLQuery> query, int column) =>
       _columnName(query, column).toDartString()!;
 
+  /// Adds a change [listener] to [query], which is called at most once every
+  /// [minInterval].
   Pointer<CBLListenerToken> addChangeListener(
     Pointer<CBLDatabase> db,
     Pointer<CBLQuery> query,
-    Pointer<CBLDartAsyncCallback> listener,
-  ) =>
-      _addChangeListener(db, query, listener);
+    Pointer<CBLDartAsyncCallback> listener, {
+    Duration minInterval = Duration.zero,
+  }) =>
+      _addChangeListener(db, query, minInterval.inMilliseconds, listener);
+
+  void setChangeListenerPaused(
+    Pointer<CBLDartAsyncCallback> listener, {
+    required bool paused,
+  }) =>
+      _setChangeListenerPaused(listener, paused);
+
+  /// Adds a listener to [query], which is called with
+  /// [QueryDiffCallbackMessage]s.
+  ///
+  /// Rows are matched by the value of the column at [keyColumn] or, if it is
+  /// `null`, by their content.
+  void addDiffListener(
+    Pointer<CBLDatabase> db,
+    Pointer<CBLQuery> query,
+    Pointer<CBLDartAsyncCallback> listener, {
+    int? keyColumn,
+  }) =>
+      _addDiffListener(db, query, keyColumn ?? -1, listener);
+
+  /// Executes [query] on a native thread pool and calls [callback] with
+  /// [QueryExecutionCallbackMessage]s of up to [batchSize] rows.
+  ///
+  /// Takes ownership of [query], which must have been created with [create]
+  /// and must not be used by anyone else.
+  ///
+  /// Closing [callback] cancels the execution.
+  void executeAsync(
+    Pointer<CBLDatabase> db,
+    Pointer<CBLQuery> query,
+    Pointer<CBLDartAsyncCallback> callback, {
+    required int batchSize,
+  }) =>
+      _executeAsync(db, query, batchSize, callback);
 
   Pointer<CBLResultSet> copyCurrentResults(
     Pointer<CBLQuery> query,
@@ -236,6 +492,152 @@ typedef _CBLResultSet_GetQuery = Pointer<CBLQuery> Function(
   Pointer<CBLResultSet> resultSet,
 );
 
+typedef _CBLDart_CBLResultSet_NextBatch_C = Size Function(
+  Pointer<CBLResultSet> resultSet,
+  Pointer<Pointer<FLArray>> rowsOut,
+  Size maxCount,
+);
+typedef _CBLDart_CBLResultSet_NextBatch = int Function(
+  Pointer<CBLResultSet> resultSet,
+  Pointer<Pointer<FLArray>> rowsOut,
+  int maxCount,
+);
+
+typedef _CBLDart_CBLResultSet_NextBatchWithDocuments_C = Bool Function(
+  Pointer<CBLResultSet> resultSet,
+  Pointer<CBLCollection> collection,
+  UnsignedInt idColumn,
+  Pointer<Pointer<FLArray>> rowsOut,
+  Pointer<Pointer<CBLDocument>> documentsOut,
+  Size maxCount,
+  Pointer<Size> countOut,
+  Pointer<CBLError> errorOut,
+);
+typedef _CBLDart_CBLResultSet_NextBatchWithDocuments = bool Function(
+  Pointer<CBLResultSet> resultSet,
+  Pointer<CBLCollection> collection,
+  int idColumn,
+  Pointer<Pointer<FLArray>> rowsOut,
+  Pointer<Pointer<CBLDocument>> documentsOut,
+  int maxCount,
+  Pointer<Size> countOut,
+  Pointer<CBLError> errorOut,
+);
+
+enum CBLColumnType {
+  int64,
+  float64,
+  string,
+}
+
+extension on CBLColumnType {
+  int toInt() => CBLColumnType.values.indexOf(this);
+}
+
+/// The data of a column which has been extracted from a result set.
+final class CBLColumnData {
+  CBLColumnData({
+    required this.values,
+    required this.offsets,
+    required this.validity,
+  });
+
+  final SliceResult? values;
+  final SliceResult? offsets;
+  final SliceResult? validity;
+}
+
+final class _CBLDart_Column extends Struct {
+  @UnsignedInt()
+  external int index;
+
+  @Uint8()
+  external int type;
+
+  external FLSliceResult values;
+  external FLSliceResult offsets;
+  external FLSliceResult validity;
+}
+
+typedef _CBLDart_CBLResultSet_ExtractColumns_C = Void Function(
+  Pointer<CBLResultSet> resultSet,
+  Pointer<Pointer<FLArray>> fetchedRows,
+  Size fetchedRowCount,
+  Pointer<_CBLDart_Column> columns,
+  Size columnCount,
+  Pointer<Uint64> rowCountOut,
+);
+typedef _CBLDart_CBLResultSet_ExtractColumns = void Function(
+  Pointer<CBLResultSet> resultSet,
+  Pointer<Pointer<FLArray>> fetchedRows,
+  int fetchedRowCount,
+  Pointer<_CBLDart_Column> columns,
+  int columnCount,
+  Pointer<Uint64> rowCountOut,
+);
+
+typedef _CBLDart_CBLResultSet_WriteJSON_C = Bool Function(
+  Pointer<CBLResultSet> resultSet,
+  Pointer<CBLDart_FLJSONBuffer> buffer,
+  Size chunkSize,
+  Bool isFirstChunk,
+  Pointer<Bool> isDoneOut,
+  Pointer<CBLError> errorOut,
+);
+typedef _CBLDart_CBLResultSet_WriteJSON = bool Function(
+  Pointer<CBLResultSet> resultSet,
+  Pointer<CBLDart_FLJSONBuffer> buffer,
+  int chunkSize,
+  bool isFirstChunk,
+  Pointer<Bool> isDoneOut,
+  Pointer<CBLError> errorOut,
+);
+
+/// Native memory into which [ResultSetBindings.nextBatch] and
+/// [ResultSetBindings.nextBatchWithDocuments] write the rows of a batch.
+///
+/// The memory is freed by [free] or, if that is never called, when the buffer
+/// is garbage collected.
+final class ResultSetBatchBuffer {
+  ResultSetBatchBuffer() {
+    _finalizer.attach(this, _pointer, detach: this);
+  }
+
+  static final _finalizer = Finalizer<Pointer<Pointer<Void>>>(malloc.free);
+
+  static const _maxBatchSize = ResultSetBindings.maxBatchSize;
+
+  // The rows, the documents and the count are stored in a single allocation.
+  final Pointer<Pointer<Void>> _pointer = malloc(2 * _maxBatchSize + 1);
+  var _isFreed = false;
+
+  Pointer<Pointer<FLArray>> get _rows {
+    assert(!_isFreed);
+    return _pointer.cast();
+  }
+
+  Pointer<Pointer<CBLDocument>> get _documents {
+    assert(!_isFreed);
+    return (_pointer + _maxBatchSize).cast();
+  }
+
+  Pointer<Size> get _count {
+    assert(!_isFreed);
+    return (_pointer + 2 * _maxBatchSize).cast();
+  }
+
+  /// Frees the memory of this buffer, after which it must not be used
+  /// anymore.
+  void free() {
+    if (_isFreed) {
+      return;
+    }
+    _isFreed = true;
+    _finalizer.detach(this);
+    malloc.free(_pointer);
+  }
+}
+
 final class ResultSetBindings extends Bindings {
   ResultSetBindings(super.parent) {
     _next = libs.cbl.lookupFunction<_CBLResultSet_Next_C, _CBLResultSet_Next>(
@@ -267,14 +669,44 @@ final class ResultSetBindings extends Bindings {
       'CBLResultSet_GetQuery',
       isLeaf: useIsLeaf,
     );
+    _writeJson = libs.cblDart.lookupFunction<_CBLDart_CBLResultSet_WriteJSON_C,
+        _CBLDart_CBLResultSet_WriteJSON>(
+      'CBLDart_CBLResultSet_WriteJSON',
+      isLeaf: useIsLeaf,
+    );
+    _nextBatch = libs.cblDart.lookupFunction<_CBLDart_CBLResultSet_NextBatch_C,
+        _CBLDart_CBLResultSet_NextBatch>(
+      'CBLDart_CBLResultSet_NextBatch',
+      isLeaf: useIsLeaf,
+    );
+    _nextBatchWithDocuments = libs.cblDart.lookupFunction<
+        _CBLDart_CBLResultSet_NextBatchWithDocuments_C,
+        _CBLDart_CBLResultSet_NextBatchWithDocuments>(
+      'CBLDart_CBLResultSet_NextBatchWithDocuments',
+      isLeaf: useIsLeaf,
+    );
+    _extractColumns = libs.cblDart.lookupFunction<
+        _CBLDart_CBLResultSet_ExtractColumns_C,
+        _CBLDart_CBLResultSet_ExtractColumns>(
+      'CBLDart_CBLResultSet_ExtractColumns',
+      isLeaf: useIsLeaf,
+    );
   }
 
+  /// The maximum number of rows which [nextBatch] returns.
+  static const maxBatchSize = 64;
+
   late final _CBLResultSet_Next _next;
   late final _CBLResultSet_ValueAtIndex _valueAtIndex;
   late final _CBLResultSet_ValueForKey _valueForKey;
   late final _CBLResultSet_ResultArray _resultArray;
   late final _CBLResultSet_ResultDict _resultDict;
   late final _CBLResultSet_GetQuery _getQuery;
+  late final _CBLDart_CBLResultSet_WriteJSON _writeJson;
+  late final _CBLDart_CBLResultSet_NextBatch _nextBatch;
+  late final _CBLDart_CBLResultSet_NextBatchWithDocuments
+      _nextBatchWithDocuments;
+  late final _CBLDart_CBLResultSet_ExtractColumns _extractColumns;
 
   bool next(Pointer<CBLResultSet> resultSet) => _next(resultSet);
 
@@ -295,4 +727,122 @@ final class ResultSetBindings extends Bindings {
 
   Pointer<CBLQuery> getQuery(Pointer<CBLResultSet> resultSet) =>
       _getQuery(resultSet);
+
+  /// Writes the next chunk of the remaining rows of [resultSet] as JSON into
+  /// [buffer] and returns whether all rows have been written.
+  bool writeJson(
+    Pointer<CBLResultSet> resultSet,
+    Pointer<CBLDart_FLJSONBuffer> buffer, {
+    required int chunkSize,
+    required bool isFirstChunk,
+  }) =>
+      withGlobalArena(() {
+        final isDone = globalArena<Bool>();
+        _writeJson(
+          resultSet,
+          buffer,
+          chunkSize,
+          isFirstChunk,
+          isDone,
+          globalCBLError,
+        ).checkCBLError();
+        return isDone.value;
+      });
+
+  /// Advances [resultSet] by up to [maxBatchSize] rows and returns the arrays
+  /// of the column values of the rows, which are written to [buffer].
+  ///
+  /// The arrays are retained and must be released by the caller. An empty list
+  /// is returned when the result set has been consumed.
+  List<Pointer<FLArray>> nextBatch(
+    Pointer<CBLResultSet> resultSet,
+    ResultSetBatchBuffer buffer,
+  ) {
+    final rows = buffer._rows;
+    final count = _nextBatch(resultSet, rows, maxBatchSize);
+    return List.generate(count, (index) => rows[index]);
+  }
+
+  /// Like [nextBatch], but also loads the document of each row from
+  /// [collection], whose id is the value of the column at [idColumn].
+  ///
+  /// The documents are retained and must be released by the caller. The
+  /// document of a row is `null` if the column is not a string or the
+  /// document does not exist.
+  List<(Pointer<FLArray>, Pointer<CBLDocument>?)> nextBatchWithDocuments(
+    Pointer<CBLResultSet> resultSet,
+    Pointer<CBLCollection> collection,
+    int idColumn,
+    ResultSetBatchBuffer buffer,
+  ) {
+    final rows = buffer._rows;
+    final documents = buffer._documents;
+    final count = buffer._count;
+    _nextBatchWithDocuments(
+      resultSet,
+      collection,
+      idColumn,
+      rows,
+      documents,
+      maxBatchSize,
+      count,
+      globalCBLError,
+    ).checkCBLError();
+    return List.generate(
+      count.value,
+      (index) => (rows[index], documents[index].toNullable()),
+    );
+  }
+
+  /// Consumes the remaining rows of [resultSet] and extracts the [columns]
+  /// of the rows, as pairs of column indexes and types.
+  ///
+  /// The [fetchedRows] have already been fetched from [resultSet] and are
+  /// extracted before its remaining rows. They are not released.
+  ///
+  /// Returns the number of extracted rows and the data of each column.
+  (int, List<CBLColumnData>) extractColumns(
+    Pointer<CBLResultSet> resultSet,
+    List<Pointer<FLArray>> fetchedRows,
+    List<(int, CBLColumnType)> columns,
+  ) =>
+      withGlobalArena(() {
+        final fetchedRowsPointer =
+            globalArena<Pointer<FLArray>>(fetchedRows.length);
+        for (var i = 0; i < fetchedRows.length; i++) {
+          fetchedRowsPointer[i] = fetchedRows[i];
+        }
+
+        final columnsPointer = globalArena<_CBLDart_Column>(columns.length);
+        for (var i = 0; i < columns.length; i++) {
+          final (index, type) = columns[i];
+          columnsPointer[i]
+            ..index = index
+            ..type = type.toInt();
+        }
+
+        final rowCount = globalArena<Uint64>();
+        _extractColumns(
+          resultSet,
+          fetchedRowsPointer,
+          fetchedRows.length,
+          columnsPointer,
+          columns.length,
+          rowCount,
+        );
+
+        return (
+          rowCount.value,
+          [
+            for (var i = 0; i < columns.length; i++)
+              CBLColumnData(
+                values: SliceResult.fromFLSliceResult(columnsPointer[i].values),
+                offsets:
+                    SliceResult.fromFLSliceResult(columnsPointer[i].offsets),
+                validity:
+                    SliceResult.fromFLSliceResult(columnsPointer[i].validity),
+              ),
+          ]
+        );
+      });
 }
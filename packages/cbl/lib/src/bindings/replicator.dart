@@ -1,10 +1,13 @@
 // ignore: lines_longer_than_80_chars
 // ignore_for_file: cast_nullable_to_non_nullable,avoid_redundant_argument_values, avoid_positional_boolean_parameters, avoid_private_typedef_functions, camel_case_types
 
+import 'dart:collection';
 import 'dart:convert';
 import 'dart:ffi';
 import 'dart:typed_data';
 
+import 'package:ffi/ffi.dart';
+
 import '../bindings.dart';
 import 'base.dart';
 import 'global.dart';
@@ -106,7 +109,31 @@ final class _CBLDartReplicationCollection extends Struct {
   external Pointer<FLArray> documentIDs;
   external Pointer<CBLDartAsyncCallback> pushFilter;
   external Pointer<CBLDartAsyncCallback> pullFilter;
+  external FLString pushFilterExpression;
+  external FLString pullFilterExpression;
   external Pointer<CBLDartAsyncCallback> conflictResolver;
+  @Uint8()
+  // ignore: unused_field
+  external int _conflictResolutionStrategy;
+  external FLString conflictResolutionTimestampKeyPath;
+}
+
+// ignore: camel_case_extensions
+extension on _CBLDartReplicationCollection {
+  set conflictResolutionStrategy(CBLDartConflictResolutionStrategy value) =>
+      _conflictResolutionStrategy = value.toInt();
+}
+
+enum CBLDartConflictResolutionStrategy {
+  custom,
+  remoteWins,
+  localWins,
+  lastWriteWins,
+  mergeDicts,
+}
+
+extension on CBLDartConflictResolutionStrategy {
+  int toInt() => CBLDartConflictResolutionStrategy.values.indexOf(this);
 }
 
 final class _CBLDartReplicatorConfiguration extends Struct {
@@ -133,6 +160,12 @@ final class _CBLDartReplicatorConfiguration extends Struct {
   external Pointer<_CBLDartReplicationCollection> collections;
   @Size()
   external int collectionsCount;
+  @Uint32()
+  external int callbackTimeoutMs;
+  @Bool()
+  external bool callbackTimeoutFilterResult;
+  @Uint32()
+  external int callbackLatencyBudgetMs;
 }
 
 extension on _CBLDartReplicatorConfiguration {
@@ -147,7 +180,11 @@ final class CBLReplicationCollection {
     this.documentIDs,
     this.pushFilter,
     this.pullFilter,
+    this.pushFilterExpression,
+    this.pullFilterExpression,
     this.conflictResolver,
+    this.conflictResolutionStrategy = CBLDartConflictResolutionStrategy.custom,
+    this.conflictResolutionTimestampKeyPath,
   });
 
   final Pointer<CBLCollection> collection;
@@ -155,7 +192,11 @@ final class CBLReplicationCollection {
   final Pointer<FLArray>? documentIDs;
   final Pointer<CBLDartAsyncCallback>? pushFilter;
   final Pointer<CBLDartAsyncCallback>? pullFilter;
+  final String? pushFilterExpression;
+  final String? pullFilterExpression;
   final Pointer<CBLDartAsyncCallback>? conflictResolver;
+  final CBLDartConflictResolutionStrategy conflictResolutionStrategy;
+  final String? conflictResolutionTimestampKeyPath;
 }
 
 final class CBLReplicatorConfiguration {
@@ -174,6 +215,9 @@ final class CBLReplicatorConfiguration {
     this.pinnedServerCertificate,
     this.trustedRootCertificates,
     required this.collections,
+    this.callbackTimeout,
+    this.callbackTimeoutFilterResult = false,
+    this.callbackLatencyBudget,
   });
 
   final Pointer<CBLDatabase> database;
@@ -190,19 +234,41 @@ final class CBLReplicatorConfiguration {
   final Data? pinnedServerCertificate;
   final Data? trustedRootCertificates;
   final List<CBLReplicationCollection> collections;
+  final Duration? callbackTimeout;
+  final bool callbackTimeoutFilterResult;
+  final Duration? callbackLatencyBudget;
 }
 
 final class ReplicationFilterCallbackMessage {
   ReplicationFilterCallbackMessage(this.document, this.flags);
 
-  ReplicationFilterCallbackMessage.fromArguments(List<Object?> arguments)
-      : this(
-          (arguments[0] as int).toPointer(),
-          CBLReplicatedDocumentFlag._parseCFlags(arguments[1] as int),
-        );
-
   final Pointer<CBLDocument> document;
   final Set<CBLReplicatedDocumentFlag> flags;
+
+  /// Parses the messages of a batch of documents, whose pointers and flags
+  /// are interleaved in [arguments].
+  static List<ReplicationFilterCallbackMessage> batchFromArguments(
+    List<Object?> arguments,
+  ) =>
+      List.generate(
+        arguments.length ~/ 2,
+        (i) => ReplicationFilterCallbackMessage(
+          (arguments[i * 2] as int).toPointer(),
+          CBLReplicatedDocumentFlag._parseCFlags(arguments[i * 2 + 1] as int),
+        ),
+      );
+
+  /// Encodes the [decisions] for a batch of documents as the bitset that is
+  /// expected by the native side.
+  static Uint8List encodeBatchDecisions(List<bool> decisions) {
+    final bitset = Uint8List((decisions.length + 7) >> 3);
+    for (final (i, decision) in decisions.indexed) {
+      if (decision) {
+        bitset[i >> 3] |= 1 << (i & 7);
+      }
+    }
+    return bitset;
+  }
 }
 
 final class ReplicationConflictResolverCallbackMessage {
@@ -237,6 +303,9 @@ typedef _CBLDart_CBLReplicator_Create = Pointer<CBLReplicator> Function(
 typedef _CBLDart_CBLReplicator_Release_C = Void Function(
   Pointer<CBLReplicator> replicator,
 );
+typedef _CBLDart_CBLReplicator_Release = void Function(
+  Pointer<CBLReplicator> replicator,
+);
 
 typedef _CBLReplicator_Start_C = Void Function(
   Pointer<CBLReplicator> replicator,
@@ -247,6 +316,47 @@ typedef _CBLReplicator_Start = void Function(
   bool resetCheckpoint,
 );
 
+typedef _CBLDart_CBLReplicator_Schedule_C = Void Function(
+  Pointer<CBLDatabase> db,
+  Pointer<CBLReplicator> replicator,
+  Bool resetCheckpoint,
+  Int32 priority,
+);
+typedef _CBLDart_CBLReplicator_Schedule = void Function(
+  Pointer<CBLDatabase> db,
+  Pointer<CBLReplicator> replicator,
+  bool resetCheckpoint,
+  int priority,
+);
+
+typedef _CBLDart_CBLReplicator_Unschedule_C = Bool Function(
+  Pointer<CBLReplicator> replicator,
+);
+typedef _CBLDart_CBLReplicator_Unschedule = bool Function(
+  Pointer<CBLReplicator> replicator,
+);
+
+typedef _CBLDart_ReplicatorScheduler_SetMaxActive_C = Void Function(
+  Uint32 maxActive,
+);
+typedef _CBLDart_ReplicatorScheduler_SetMaxActive = void Function(
+  int maxActive,
+);
+
+final class CBLDart_ReplicatorSchedulerStats extends Struct {
+  @Uint32()
+  external int maxActive;
+
+  @Size()
+  external int active;
+
+  @Size()
+  external int waiting;
+}
+
+typedef _CBLDart_ReplicatorScheduler_Stats = CBLDart_ReplicatorSchedulerStats
+    Function();
+
 typedef _CBLReplicator_Stop_C = Void Function(
   Pointer<CBLReplicator> replicator,
 );
@@ -358,14 +468,44 @@ typedef _CBLReplicator_IsDocumentPending2 = bool Function(
   Pointer<CBLError> errorOut,
 );
 
+typedef _CBLDart_CBLReplicator_AreDocumentsPending_C = Bool Function(
+  Pointer<CBLReplicator> replicator,
+  Pointer<CBLCollection> collection,
+  Pointer<FLString> docIDs,
+  Size count,
+  Pointer<Uint8> bitsetOut,
+  Pointer<CBLError> errorOut,
+);
+typedef _CBLDart_CBLReplicator_AreDocumentsPending = bool Function(
+  Pointer<CBLReplicator> replicator,
+  Pointer<CBLCollection> collection,
+  Pointer<FLString> docIDs,
+  int count,
+  Pointer<Uint8> bitsetOut,
+  Pointer<CBLError> errorOut,
+);
+
+typedef _CBLDart_CBLReplicator_PendingDocumentCount_C = Int64 Function(
+  Pointer<CBLReplicator> replicator,
+  Pointer<CBLCollection> collection,
+  Pointer<CBLError> errorOut,
+);
+typedef _CBLDart_CBLReplicator_PendingDocumentCount = int Function(
+  Pointer<CBLReplicator> replicator,
+  Pointer<CBLCollection> collection,
+  Pointer<CBLError> errorOut,
+);
+
 typedef _CBLDart_CBLReplicator_AddChangeListener_C = Void Function(
   Pointer<CBLDatabase> db,
   Pointer<CBLReplicator> replicator,
+  Uint32 minIntervalMs,
   Pointer<CBLDartAsyncCallback> listener,
 );
 typedef _CBLDart_CBLReplicator_AddChangeListener = void Function(
   Pointer<CBLDatabase> db,
   Pointer<CBLReplicator> replicator,
+  int minIntervalMs,
   Pointer<CBLDartAsyncCallback> listener,
 );
 
@@ -385,14 +525,48 @@ enum CBLReplicatedDocumentFlag implements Option {
 typedef _CBLDart_CBLReplicator_AddDocumentReplicationListener_C = Void Function(
   Pointer<CBLDatabase> db,
   Pointer<CBLReplicator> replicator,
+  Bool errorsOnly,
   Pointer<CBLDartAsyncCallback> listener,
 );
 typedef _CBLDart_CBLReplicator_AddDocumentReplicationListener = void Function(
   Pointer<CBLDatabase> db,
   Pointer<CBLReplicator> replicator,
+  bool errorsOnly,
   Pointer<CBLDartAsyncCallback> listener,
 );
 
+final class CBLDart_ReplicatorMetrics extends Struct {
+  @Uint64()
+  external int documentsPushed;
+
+  @Uint64()
+  external int documentsPulled;
+
+  @Uint64()
+  external int documentErrors;
+
+  external CBLDart_LatencyHistogram pushFilter;
+
+  external CBLDart_LatencyHistogram pullFilter;
+
+  external CBLDart_LatencyHistogram conflictResolver;
+
+  @Uint64()
+  external int callbacksOverBudget;
+
+  @Uint64()
+  external int callbacksTimedOut;
+}
+
+typedef _CBLDart_CBLReplicator_Metrics_C = Bool Function(
+  Pointer<CBLReplicator> replicator,
+  Pointer<CBLDart_ReplicatorMetrics> metricsOut,
+);
+typedef _CBLDart_CBLReplicator_Metrics = bool Function(
+  Pointer<CBLReplicator> replicator,
+  Pointer<CBLDart_ReplicatorMetrics> metricsOut,
+);
+
 final class ReplicatorStatusCallbackMessage {
   ReplicatorStatusCallbackMessage(this.status);
 
@@ -444,33 +618,64 @@ final class DocumentReplicationsCallbackMessage {
   DocumentReplicationsCallbackMessage.fromArguments(List<Object?> arguments)
       : this(
           arguments[0] as bool,
-          parseDocuments(arguments[1] as List<Object?>),
-        );
-
-  static List<CBLReplicatedDocument> parseDocuments(List<Object?> documents) =>
-      documents.cast<List<Object?>>().map((document) {
-        CBLErrorException? error;
-        if (document.length > 4) {
-          final domain = (document[4] as int).toErrorDomain();
-          final code = (document[5] as int).toErrorCode(domain);
-          final message =
-              utf8.decode(document[6] as Uint8List, allowMalformed: true);
-          error = CBLErrorException(domain, code, message);
-        }
-
-        return CBLReplicatedDocument(
-          utf8.decode(document[0] as Uint8List),
-          CBLReplicatedDocumentFlag._parseCFlags(document[1] as int),
-          utf8.decode(document[2] as Uint8List),
-          utf8.decode(document[3] as Uint8List),
-          error,
+          PackedReplicatedDocumentList(
+            PackedStringList(arguments[1] as Uint8List),
+            arguments[2] as Int32List,
+          ),
         );
-      }).toList();
 
   final bool isPush;
   final List<CBLReplicatedDocument> documents;
 }
 
+/// An unmodifiable list of replicated documents, which have been packed into
+/// a string buffer and an integer buffer by
+/// `CBLDart_Replicator_SendDocumentReplications`.
+///
+/// The documents are only decoded when they are accessed and then cached.
+final class PackedReplicatedDocumentList extends ListBase<CBLReplicatedDocument>
+    with UnmodifiableListMixin<CBLReplicatedDocument> {
+  PackedReplicatedDocumentList(this._strings, this._records)
+      : length = _records.length ~/ 3,
+        _documents = List.filled(_records.length ~/ 3, null);
+
+  final PackedStringList _strings;
+  final Int32List _records;
+  final List<CBLReplicatedDocument?> _documents;
+
+  @override
+  final int length;
+
+  @override
+  CBLReplicatedDocument operator [](int index) {
+    RangeError.checkValidIndex(index, this);
+    return _documents[index] ??= _decode(index);
+  }
+
+  CBLReplicatedDocument _decode(int index) {
+    final flags = _records[index * 3];
+    final errorCode = _records[index * 3 + 2];
+
+    CBLErrorException? error;
+    if (errorCode != 0) {
+      final domain = _records[index * 3 + 1].toErrorDomain();
+      error = CBLErrorException(
+        domain,
+        errorCode.toErrorCode(domain),
+        _strings[index * 4 + 3],
+      );
+    }
+
+    return CBLReplicatedDocument(
+      _strings[index * 4],
+      CBLReplicatedDocumentFlag._parseCFlags(flags),
+      _strings[index * 4 + 1],
+      _strings[index * 4 + 2],
+      error,
+    );
+  }
+}
+
 // === ReplicatorBindings ======================================================
 
 final class ReplicatorBindings extends Bindings {
@@ -518,6 +723,27 @@ final class ReplicatorBindings extends Bindings {
       'CBLReplicator_Start',
       isLeaf: useIsLeaf,
     );
+    _schedule = libs.cblDart.lookupFunction<_CBLDart_CBLReplicator_Schedule_C,
+        _CBLDart_CBLReplicator_Schedule>(
+      'CBLDart_CBLReplicator_Schedule',
+      isLeaf: useIsLeaf,
+    );
+    _unschedule = libs.cblDart.lookupFunction<
+        _CBLDart_CBLReplicator_Unschedule_C, _CBLDart_CBLReplicator_Unschedule>(
+      'CBLDart_CBLReplicator_Unschedule',
+      isLeaf: useIsLeaf,
+    );
+    _setSchedulerMaxActive = libs.cblDart.lookupFunction<
+        _CBLDart_ReplicatorScheduler_SetMaxActive_C,
+        _CBLDart_ReplicatorScheduler_SetMaxActive>(
+      'CBLDart_ReplicatorScheduler_SetMaxActive',
+      isLeaf: useIsLeaf,
+    );
+    _schedulerStats = libs.cblDart.lookupFunction<
+        _CBLDart_ReplicatorScheduler_Stats, _CBLDart_ReplicatorScheduler_Stats>(
+      'CBLDart_ReplicatorScheduler_Stats',
+      isLeaf: useIsLeaf,
+    );
     _stop = libs.cbl.lookupFunction<_CBLReplicator_Stop_C, _CBLReplicator_Stop>(
       'CBLReplicator_Stop',
       isLeaf: useIsLeaf,
@@ -547,6 +773,18 @@ final class ReplicatorBindings extends Bindings {
       'CBLReplicator_IsDocumentPending2',
       isLeaf: useIsLeaf,
     );
+    _areDocumentsPending = libs.cblDart.lookupFunction<
+        _CBLDart_CBLReplicator_AreDocumentsPending_C,
+        _CBLDart_CBLReplicator_AreDocumentsPending>(
+      'CBLDart_CBLReplicator_AreDocumentsPending',
+      isLeaf: useIsLeaf,
+    );
+    _pendingDocumentCount = libs.cblDart.lookupFunction<
+        _CBLDart_CBLReplicator_PendingDocumentCount_C,
+        _CBLDart_CBLReplicator_PendingDocumentCount>(
+      'CBLDart_CBLReplicator_PendingDocumentCount',
+      isLeaf: useIsLeaf,
+    );
     _addChangeListener = libs.cblDart.lookupFunction<
         _CBLDart_CBLReplicator_AddChangeListener_C,
         _CBLDart_CBLReplicator_AddChangeListener>(
@@ -559,6 +797,11 @@ final class ReplicatorBindings extends Bindings {
       'CBLDart_CBLReplicator_AddDocumentReplicationListener',
       isLeaf: useIsLeaf,
     );
+    _metrics = libs.cblDart.lookupFunction<_CBLDart_CBLReplicator_Metrics_C,
+        _CBLDart_CBLReplicator_Metrics>(
+      'CBLDart_CBLReplicator_Metrics',
+      isLeaf: useIsLeaf,
+    );
   }
 
   late final _CBLEndpoint_CreateWithURL _endpointCreateWithUrl;
@@ -571,17 +814,30 @@ final class ReplicatorBindings extends Bindings {
   late final Pointer<NativeFunction<_CBLDart_CBLReplicator_Release_C>>
       _releasePtr;
   late final _CBLReplicator_Start _start;
+  late final _CBLDart_CBLReplicator_Schedule _schedule;
+  late final _CBLDart_CBLReplicator_Unschedule _unschedule;
+  late final _CBLDart_ReplicatorScheduler_SetMaxActive _setSchedulerMaxActive;
+  late final _CBLDart_ReplicatorScheduler_Stats _schedulerStats;
   late final _CBLReplicator_Stop _stop;
   late final _CBLReplicator_SetHostReachable _setHostReachable;
   late final _CBLReplicator_SetSuspended _setSuspended;
   late final _CBLReplicator_Status _status;
   late final _CBLReplicator_PendingDocumentIDs2 _pendingDocumentIDs;
   late final _CBLReplicator_IsDocumentPending2 _isDocumentPending;
+  late final _CBLDart_CBLReplicator_AreDocumentsPending _areDocumentsPending;
+  late final _CBLDart_CBLReplicator_PendingDocumentCount _pendingDocumentCount;
   late final _CBLDart_CBLReplicator_AddChangeListener _addChangeListener;
   late final _CBLDart_CBLReplicator_AddDocumentReplicationListener
       _addDocumentReplicationListener;
+  late final _CBLDart_CBLReplicator_Metrics _metrics;
+
+  /// The buffer into which the metrics of replicators are read, so that
+  /// reading them does not allocate native memory.
+  late final _metricsBuffer = malloc<CBLDart_ReplicatorMetrics>();
 
   late final _finalizer = NativeFinalizer(_releasePtr.cast());
+  late final _release =
+      _releasePtr.asFunction<_CBLDart_CBLReplicator_Release>();
 
   Pointer<CBLEndpoint> createEndpointWithUrl(String url) =>
       runWithSingleFLString(
@@ -631,6 +887,12 @@ final class ReplicatorBindings extends Bindings {
     _finalizer.attach(object, replicator.cast());
   }
 
+  /// Releases [replicator] like the finalizer of the object it is bound to
+  /// would, which means that it is stopped first if it is still running.
+  ///
+  /// Must only be used for replicators which are not bound to an object.
+  void release(Pointer<CBLReplicator> replicator) => _release(replicator);
+
   void start(
     Pointer<CBLReplicator> replicator, {
     required bool resetCheckpoint,
@@ -638,6 +900,25 @@ final class ReplicatorBindings extends Bindings {
     _start(replicator, resetCheckpoint);
   }
 
+  void schedule(
+    Pointer<CBLDatabase> db,
+    Pointer<CBLReplicator> replicator, {
+    required bool resetCheckpoint,
+    required int priority,
+  }) {
+    _schedule(db, replicator, resetCheckpoint, priority);
+  }
+
+  /// Removes [replicator] from the scheduler and returns whether the scheduler
+  /// has started it.
+  bool unschedule(Pointer<CBLReplicator> replicator) => _unschedule(replicator);
+
+  void setSchedulerMaxActive(int maxActive) {
+    _setSchedulerMaxActive(maxActive);
+  }
+
+  CBLDart_ReplicatorSchedulerStats schedulerStats() => _schedulerStats();
+
   void stop(Pointer<CBLReplicator> replicator) {
     _stop(replicator);
   }
@@ -678,20 +959,76 @@ final class ReplicatorBindings extends Bindings {
                 .checkCBLError(),
       );
 
+  /// Returns for each of the documents with the given [docIDs], whether it has
+  /// revisions pending to be pushed.
+  List<bool> areDocumentsPending(
+    Pointer<CBLReplicator> replicator,
+    List<String> docIDs,
+    Pointer<CBLCollection> collection,
+  ) =>
+      withGlobalArena(() {
+        final count = docIDs.length;
+        final flDocIDs = globalArena<FLString>(count);
+        for (var i = 0; i < count; i++) {
+          final docID = nativeUtf8StringEncoder.encode(docIDs[i], globalArena);
+          flDocIDs[i]
+            ..buf = docID.buffer
+            ..size = docID.size;
+        }
+        final bitset = globalArena<Uint8>((count + 7) >> 3);
+
+        _areDocumentsPending(
+          replicator,
+          collection,
+          flDocIDs,
+          count,
+          bitset,
+          globalCBLError,
+        ).checkCBLError();
+
+        return [
+          for (var i = 0; i < count; i++) bitset[i >> 3] & (1 << (i & 7)) != 0
+        ];
+      });
+
+  int pendingDocumentCount(
+    Pointer<CBLReplicator> replicator,
+    Pointer<CBLCollection> collection,
+  ) {
+    final count = _pendingDocumentCount(replicator, collection, globalCBLError);
+    if (count < 0) {
+      throwCBLError();
+    }
+    return count;
+  }
+
+  /// Adds a listener for status changes of [replicator], whose progress
+  /// updates are delivered at most once per [minInterval].
   void addChangeListener(
     Pointer<CBLDatabase> db,
     Pointer<CBLReplicator> replicator,
-    Pointer<CBLDartAsyncCallback> listener,
-  ) {
-    _addChangeListener(db, replicator, listener);
+    Pointer<CBLDartAsyncCallback> listener, {
+    Duration minInterval = Duration.zero,
+  }) {
+    _addChangeListener(db, replicator, minInterval.inMilliseconds, listener);
   }
 
   void addDocumentReplicationListener(
     Pointer<CBLDatabase> db,
     Pointer<CBLReplicator> replicator,
-    Pointer<CBLDartAsyncCallback> listener,
-  ) {
-    _addDocumentReplicationListener(db, replicator, listener);
+    Pointer<CBLDartAsyncCallback> listener, {
+    bool errorsOnly = false,
+  }) {
+    _addDocumentReplicationListener(db, replicator, errorsOnly, listener);
+  }
+
+  /// Reads the metrics of [replicator].
+  ///
+  /// The returned struct is only valid until this method is called again.
+  CBLDart_ReplicatorMetrics metrics(Pointer<CBLReplicator> replicator) {
+    final found = _metrics(replicator, _metricsBuffer);
+    assert(found, 'Replicator was not created by CBLDart_CBLReplicator_Create');
+    return _metricsBuffer.ref;
   }
 
   Pointer<_CBLDartReplicatorConfiguration> _createConfigurationStruct(
@@ -725,7 +1062,11 @@ final class ReplicatorBindings extends Bindings {
 
     configStruct.ref
       ..collections = collectionStructs
-      ..collectionsCount = config.collections.length;
+      ..collectionsCount = config.collections.length
+      ..callbackTimeoutMs = config.callbackTimeout?.inMilliseconds ?? 0
+      ..callbackTimeoutFilterResult = config.callbackTimeoutFilterResult
+      ..callbackLatencyBudgetMs =
+          config.callbackLatencyBudget?.inMilliseconds ?? 0;
 
     for (final (i, collection) in config.collections.indexed) {
       collectionStructs[i]
@@ -734,7 +1075,12 @@ final class ReplicatorBindings extends Bindings {
         ..documentIDs = collection.documentIDs ?? nullptr
         ..pushFilter = collection.pushFilter ?? nullptr
         ..pullFilter = collection.pullFilter ?? nullptr
-        ..conflictResolver = collection.conflictResolver ?? nullptr;
+        ..pushFilterExpression = collection.pushFilterExpression.toFLString()
+        ..pullFilterExpression = collection.pullFilterExpression.toFLString()
+        ..conflictResolver = collection.conflictResolver ?? nullptr
+        ..conflictResolutionStrategy = collection.conflictResolutionStrategy
+        ..conflictResolutionTimestampKeyPath =
+            collection.conflictResolutionTimestampKeyPath.toFLString();
     }
 
     return configStruct;
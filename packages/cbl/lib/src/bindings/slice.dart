@@ -161,6 +161,15 @@ final class SliceResult extends Slice {
     _sliceBindings.bindToDartObject(this, buf: buf, retain: retain);
   }
 
+  /// Creates a [SliceResult] for the native slice result at [address], which
+  /// has [size], and retains it.
+  ///
+  /// This adopts a slice result whose address has been sent through a port,
+  /// without copying it. The sender must keep the slice result alive until
+  /// this constructor has returned.
+  SliceResult.retainAddress(int address, int size)
+      : this._(Pointer.fromAddress(address), size, retain: true);
+
   /// Returns a [SliceResult] which has the content and size of [list].
   factory SliceResult.fromTypedList(Uint8List list) =>
       SliceResult(list.lengthInBytes)..asTypedList().setAll(0, list);
@@ -213,6 +222,35 @@ final class SliceResult extends Slice {
     return list;
   }
 
+  /// Returns a view of [length] `int64_t`s, which start at the first address
+  /// of this slice that is aligned to their size.
+  Int64List asAlignedInt64List(int length) {
+    final list = _alignedBuf(8).cast<Int64>().asTypedList(length);
+    _keepAliveForTypedList[list] = this;
+    return list;
+  }
+
+  /// Returns a view of [length] `double`s, which start at the first address
+  /// of this slice that is aligned to their size.
+  Float64List asAlignedFloat64List(int length) {
+    final list = _alignedBuf(8).cast<Double>().asTypedList(length);
+    _keepAliveForTypedList[list] = this;
+    return list;
+  }
+
+  /// Returns a view of [length] `uint32_t`s, which start at the first address
+  /// of this slice that is aligned to their size.
+  Uint32List asAlignedUint32List(int length) {
+    final list = _alignedBuf(4).cast<Uint32>().asTypedList(length);
+    _keepAliveForTypedList[list] = this;
+    return list;
+  }
+
+  Pointer<Uint8> _alignedBuf(int alignment) {
+    final padding = (alignment - buf.address % alignment) % alignment;
+    return Pointer.fromAddress(buf.address + padding);
+  }
+
   @override
   String toString() => 'SliceResult(buf: $buf, size: $size)';
 }
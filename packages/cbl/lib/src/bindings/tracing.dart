@@ -18,13 +18,21 @@ enum TracedNativeCall {
   databaseClose('CBLDart_CBLDatabase_Close'),
   databaseBeginTransaction('CBLDatabase_BeginTransaction'),
   databaseEndTransaction('CBLDatabase_EndTransaction'),
-  collectionGetDocument('CBLCollection_GetDocument'),
+  collectionGetDocument('CBLDart_CBLCollection_GetDocument'),
+  collectionGetDocuments('CBLDart_CBLCollection_GetDocuments'),
   collectionSaveDocument('CBLCollection_SaveDocumentWithConcurrencyControl'),
+  collectionSaveDocuments('CBLDart_CBLCollection_SaveDocuments'),
+  collectionPatchDocument('CBLDart_CBLCollection_PatchDocument'),
+  collectionSetDocumentExpirations(
+    'CBLDart_CBLCollection_SetDocumentExpirations',
+  ),
   collectionDeleteDocument(
     'CBLCollection_DeleteDocumentWithConcurrencyControl',
   ),
+  changeCursorNext('CBLDart_ChangeCursor_Next'),
   databaseGetBlob('CBLDatabase_GetBlob'),
   databaseSaveBlob('CBLDatabase_SaveBlob'),
+  databaseSaveBlobDeduplicated('CBLDart_CBLDatabase_SaveBlob'),
   queryCreate('CBLDatabase_CreateQuery'),
   queryExecute('CBLQuery_Execute');
 
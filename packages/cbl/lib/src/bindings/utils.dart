@@ -1,4 +1,7 @@
+import 'dart:collection';
+import 'dart:convert';
 import 'dart:ffi';
+import 'dart:typed_data';
 
 import 'package:ffi/ffi.dart';
 
@@ -104,3 +107,45 @@ extension PointerExt<T extends NativeType> on Pointer<T> {
 extension NullablePointerExt<T extends NativeType> on Pointer<T>? {
   Pointer<T> elseNullptr() => this == null ? nullptr : this!;
 }
+
+// === Packed Strings ==========================================================
+
+/// An unmodifiable list of strings, which have been packed into a single
+/// buffer by `CBLDart_CObject_SetPackedStrings`.
+///
+/// The strings are only decoded when they are accessed and then cached.
+final class PackedStringList extends ListBase<String>
+    with UnmodifiableListMixin<String> {
+  factory PackedStringList(Uint8List buffer) {
+    final header = ByteData.sublistView(buffer);
+    return PackedStringList._(buffer, header, header.getUint32(0, Endian.host));
+  }
+
+  PackedStringList._(this._buffer, this._header, this.length)
+      : _dataOffset = (length + 2) * 4,
+        _strings = List.filled(length, null);
+
+  final Uint8List _buffer;
+  final ByteData _header;
+  final int _dataOffset;
+  final List<String?> _strings;
+
+  @override
+  final int length;
+
+  @override
+  String operator [](int index) {
+    RangeError.checkValidIndex(index, this);
+    return _strings[index] ??= _decode(index);
+  }
+
+  String _decode(int index) {
+    final start = _header.getUint32((index + 1) * 4, Endian.host);
+    final end = _header.getUint32((index + 2) * 4, Endian.host);
+    return utf8.decode(Uint8List.sublistView(
+      _buffer,
+      _dataOffset + start,
+      _dataOffset + end,
+    ));
+  }
+}
@@ -4,11 +4,13 @@ import 'database/database.dart';
 import 'log.dart';
 import 'support/ffi.dart';
 import 'support/isolate.dart';
+import 'support/native_stats.dart';
 import 'support/tracing.dart';
 import 'tracing.dart';
 
 export 'support/ffi.dart' show LibrariesConfiguration, LibraryConfiguration;
 export 'support/listener_token.dart' show ListenerToken;
+export 'support/native_stats.dart' show NativeStats;
 export 'support/resource.dart' show Resource, ClosableResource;
 export 'support/streams.dart' show AsyncListenStream;
 
@@ -30,6 +32,9 @@ abstract final class CouchbaseLite {
   /// This object can be safely passed from one [Isolate] to another.
   static Object get context => IsolateContext.instance;
 
+  /// The current [NativeStats] of the native library of this package.
+  static NativeStats get nativeStats => readNativeStats();
+
   /// Initializes the `cbl` package, for a secondary isolate.
   ///
   /// A value for [context] can be obtained from [CouchbaseLite.context].
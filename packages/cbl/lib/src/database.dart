@@ -7,7 +7,12 @@ export 'database/collection.dart'
         SyncSaveConflictHandler,
         DatabaseChangeListener,
         DocumentChangeListener,
-        CollectionChangeListener;
+        CollectionChangeListener,
+        IndexBuild,
+        IndexBuildProgressListener,
+        IndexBuildState,
+        JsonLinesImportProgressListener,
+        RemoveWhereProgressListener;
 export 'database/collection_change.dart' show CollectionChange;
 export 'database/database.dart'
     show
@@ -25,4 +30,14 @@ export 'database/database_change.dart' show DatabaseChange;
 export 'database/database_configuration.dart'
     show DatabaseConfiguration, EncryptionKey;
 export 'database/document_change.dart' show DocumentChange;
+export 'database/expiration_stats.dart' show ExpirationStats;
+export 'database/full_text_search_result.dart' show FullTextSearchResult;
+export 'database/maintenance_schedule.dart'
+    show
+        MaintenanceProgress,
+        MaintenanceProgressListener,
+        MaintenanceReport,
+        MaintenanceSchedule;
 export 'database/scope.dart' show Scope, AsyncScope, SyncScope;
+export 'database/sequence_change.dart'
+    show SequenceChange, SequenceChangeBatch;
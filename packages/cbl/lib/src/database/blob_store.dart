@@ -10,9 +10,31 @@ abstract interface class BlobStore {
     Stream<Data> stream,
   );
 
+  /// Saves a blob with the content of the file at [path], which is copied
+  /// without being loaded into memory.
+  Future<Map<String, Object?>> saveBlobFromFile(
+    String contentType,
+    String path,
+  );
+
   FutureOr<bool> blobExists(Map<String, Object?> properties);
 
-  Stream<Data>? readBlob(Map<String, Object?> properties);
+  /// Returns a stream of the content of the blob with [properties], from the
+  /// byte at [start] up to, but not including, the byte at [end], or `null`
+  /// if the blob does not exist.
+  ///
+  /// If [readAhead] is larger than `0`, up to [readAhead] chunks are read
+  /// ahead of the listener.
+  Stream<Data>? readBlob(
+    Map<String, Object?> properties, {
+    int start = 0,
+    int? end,
+    int readAhead = 0,
+  });
+
+  /// Writes the content of the blob with [properties] to the file at [path],
+  /// without loading it into memory, and returns whether the blob exists.
+  Future<bool> writeBlobToFile(Map<String, Object?> properties, String path);
 }
 
 abstract interface class SyncBlobStore extends BlobStore {
@@ -4,6 +4,8 @@ import 'dart:async';
 
 import '../document.dart';
 import '../errors.dart';
+import '../query/expressions/expression.dart';
+import '../query/functions/full_text_function.dart';
 import '../query/index/index.dart';
 import '../support/listener_token.dart';
 import '../support/streams.dart';
@@ -11,7 +13,10 @@ import 'collection_change.dart';
 import 'database.dart';
 import 'database_change.dart';
 import 'document_change.dart';
+import 'expiration_stats.dart';
+import 'full_text_search_result.dart';
 import 'scope.dart';
+import 'sequence_change.dart';
 
 /// Custom conflict handler for saving a document.
 ///
@@ -77,6 +82,82 @@ typedef DatabaseChangeListener = void Function(DatabaseChange change);
 /// {@category Database}
 typedef DocumentChangeListener = void Function(DocumentChange change);
 
+/// Listener which is called with the total number of imported documents while
+/// importing JSON lines into a [Collection].
+///
+/// See also:
+///
+/// - [Collection.importJsonLines] for importing JSON lines from a [Stream].
+/// - [Collection.importJsonLinesFile] for importing JSON lines from a file.
+///
+/// {@category Database}
+typedef JsonLinesImportProgressListener = void Function(int importedCount);
+
+/// Listener which is called with the total number of affected documents while
+/// deleting or purging the documents of a [Collection] which match a
+/// predicate.
+///
+/// See also:
+///
+/// - [Collection.deleteWhere] for deleting matching documents.
+/// - [Collection.purgeWhere] for purging matching documents.
+///
+/// {@category Database}
+typedef RemoveWhereProgressListener = void Function(int affectedCount);
+
+/// The state of an [IndexBuild].
+///
+/// {@category Query}
+enum IndexBuildState {
+  /// The build is waiting to start.
+  pending,
+
+  /// The index is being built.
+  building,
+
+  /// The index has been created.
+  completed,
+
+  /// The build has been cancelled.
+  cancelled,
+
+  /// The build has failed.
+  failed,
+}
+
+/// Listener which is called when the [IndexBuildState] of an [IndexBuild]
+/// changes.
+///
+/// {@category Query}
+typedef IndexBuildProgressListener = void Function(IndexBuildState state);
+
+/// A build of an index, which runs in the background.
+///
+/// See also:
+///
+/// - [Collection.buildIndex] for starting a build.
+///
+/// {@category Query}
+abstract interface class IndexBuild {
+  /// The current state of this build.
+  IndexBuildState get state;
+
+  /// Completes with `true` when the index has been created and with `false`
+  /// when the build has been cancelled.
+  ///
+  /// Completes with an error if the build has failed.
+  Future<bool> get result;
+
+  /// Cancels this build.
+  ///
+  /// A build which has not started yet is skipped. A build which is running
+  /// cannot be interrupted. It is completed and the index is deleted again,
+  /// unless it replaced an existing index with the same name.
+  ///
+  /// Has no effect if this build has already finished.
+  void cancel();
+}
+
 /// A container for [Document]s.
 ///
 /// A collection can be thought as a table in the relational database. Each
@@ -134,6 +215,15 @@ abstract interface class Collection {
   /// Returns the [Document] with the given [id], if it exists.
   FutureOr<Document?> document(String id);
 
+  /// Returns the [Document]s with the given [ids].
+  ///
+  /// The returned list contains the document for each id in [ids], at the
+  /// same index, or `null` if the document does not exist.
+  ///
+  /// All documents are loaded at once, which is more efficient than loading
+  /// them one by one with [document].
+  FutureOr<List<Document?>> documents(List<String> ids);
+
   /// Returns the [DocumentFragment] for the [Document] with the given [id].
   FutureOr<DocumentFragment> operator [](String id);
 
@@ -151,6 +241,43 @@ abstract interface class Collection {
     ConcurrencyControl concurrencyControl = ConcurrencyControl.lastWriteWins,
   ]);
 
+  /// Saves [documents] to this collection in a single transaction, resolving
+  /// conflicts through [ConcurrencyControl].
+  ///
+  /// The returned list contains the result for each document in [documents],
+  /// at the same index, with the same meaning as the result of
+  /// [saveDocument].
+  ///
+  /// If saving a document fails for a reason other than a conflict, none of
+  /// the documents are saved.
+  ///
+  /// This is more efficient than saving the documents one by one with
+  /// [saveDocument].
+  FutureOr<List<bool>> saveDocuments(
+    List<MutableDocument> documents, [
+    ConcurrencyControl concurrencyControl = ConcurrencyControl.lastWriteWins,
+  ]);
+
+  /// Applies [patch] to the properties of the document with the given [id]
+  /// and saves it, resolving conflicts through [ConcurrencyControl].
+  ///
+  /// [patch] is applied as a JSON merge patch (RFC 7386): Entries with a
+  /// `null` value are removed, [Map]s are merged recursively and all other
+  /// values replace the existing values. The values in [patch] must be
+  /// `null` or of type [bool], [int], [double], [String], [List] or [Map].
+  /// If the document does not exist, it is created.
+  ///
+  /// The document is loaded, patched and saved natively, without decoding
+  /// its properties, which makes this more efficient than [saveDocument] for
+  /// small changes to large documents.
+  ///
+  /// The result has the same meaning as the result of [saveDocument].
+  FutureOr<bool> patchDocument(
+    String id,
+    Map<String, Object?> patch, [
+    ConcurrencyControl concurrencyControl = ConcurrencyControl.lastWriteWins,
+  ]);
+
   /// Saves a [document] to this collection, resolving conflicts with a
   /// [conflictHandler].
   ///
@@ -202,9 +329,29 @@ abstract interface class Collection {
   /// The purge will **not** be replicated to other databases.
   FutureOr<void> setDocumentExpiration(String id, DateTime? expiration);
 
+  /// Sets the expiration dates of multiple [Document]s, keyed by their ids,
+  /// in a single transaction.
+  ///
+  /// A `null` expiration date clears the expiration date of a document.
+  ///
+  /// If the expiration date of any document cannot be set, for example
+  /// because the document does not exist, no expiration dates are changed.
+  ///
+  /// See also:
+  ///
+  /// - [setDocumentExpiration] for the semantics of expiration dates.
+  FutureOr<void> setDocumentExpirations(Map<String, DateTime?> expirations);
+
   /// Gets the expiration date of a [Document] by its [id], if it exists.
   FutureOr<DateTime?> getDocumentExpiration(String id);
 
+  /// Stats about the documents of this collection, which have been purged
+  /// because they expired, or which are going to expire.
+  ///
+  /// Only expiration dates which have been set through this collection, since
+  /// the database has been opened, are covered.
+  FutureOr<ExpirationStats> get expirationStats;
+
   /// The names of all existing indexes for this collection.
   FutureOr<List<String>> get indexes;
 
@@ -219,6 +366,153 @@ abstract interface class Collection {
   /// Deletes the [Index] of the given [name].
   FutureOr<void> deleteIndex(String name);
 
+  /// Searches the full-text index with the given [indexName] for the
+  /// documents which match the full-text [query] and returns a page of the
+  /// best ranked results.
+  ///
+  /// The results are ordered by descending [FullTextSearchResult.rank], and
+  /// results with the same rank by their IDs. At most [limit] results are
+  /// returned, after skipping the first [offset] results. Only the results of
+  /// the page are read and sent to Dart, so the latency of a search does not
+  /// grow with the number of matching documents, as long as the page is
+  /// small.
+  ///
+  /// [query] uses the same syntax as [FullTextFunction.match].
+  ///
+  /// If [snippetProperty] is provided, a [FullTextSearchResult.snippet] is
+  /// made from the string at this key path in each matching document. The
+  /// snippet is the part of at most [snippetWordCount] words of the text which
+  /// contains the most terms of [query]. Each matched word is enclosed in
+  /// [matchStart] and [matchEnd], and text which has been left out at the
+  /// start or end of the snippet is marked with [ellipsis].
+  ///
+  /// Snippets are made natively from the stored text, so that the texts do
+  /// not have to be sent to Dart. Since the full-text index is not consulted,
+  /// matching words is approximate: Words match terms of [query] they start
+  /// with, and words which only differ from terms in short suffixes, to
+  /// approximate stemming.
+  ///
+  /// ```dart
+  /// final results = await collection.fullTextSearch(
+  ///   'descriptionIndex',
+  ///   'quick fox',
+  ///   snippetProperty: 'description',
+  /// );
+  /// ```
+  FutureOr<List<FullTextSearchResult>> fullTextSearch(
+    String indexName,
+    String query, {
+    int limit = 20,
+    int offset = 0,
+    String? snippetProperty,
+    int snippetWordCount = 16,
+    String matchStart = '<b>',
+    String matchEnd = '</b>',
+    String ellipsis = '…',
+  });
+
+  /// Starts building an [index] with the given [name] for the documents in
+  /// this collection, without blocking the calling isolate.
+  ///
+  /// This is the same as [createIndex], except that the index is built on a
+  /// background thread and the build can be cancelled. This is useful for
+  /// indexes of large collections, which take a long time to build.
+  ///
+  /// [onProgress] is called whenever the [IndexBuild.state] changes.
+  ///
+  /// The database is not closed while the index is being built, and other
+  /// operations on the same database object wait for the build to finish.
+  IndexBuild buildIndex(
+    String name,
+    Index index, {
+    IndexBuildProgressListener? onProgress,
+  });
+
+  /// Imports documents from JSON lines (also known as NDJSON), read from
+  /// [source], into this collection.
+  ///
+  /// {@template cbl.Collection.importJsonLines}
+  /// Every non-empty line has to contain a JSON object, which becomes the
+  /// properties of a new document. If a line does not contain a valid JSON
+  /// object, the import fails.
+  ///
+  /// If [idKeyPath] is provided, the string at this key path in the object is
+  /// used as the ID of the document. Otherwise, or if there is no string at the
+  /// key path, a random ID is used. See [KeyPathProjection] for the syntax of
+  /// key paths. Existing documents with the same ID are replaced.
+  ///
+  /// Documents are saved in transactions of [batchSize] documents. Batches
+  /// which have been saved before the import fails are not rolled back.
+  ///
+  /// [onProgress] is called with the total number of imported documents after
+  /// every saved batch.
+  ///
+  /// Returns the number of imported documents.
+  /// {@endtemplate}
+  Future<int> importJsonLines(
+    Stream<List<int>> source, {
+    String? idKeyPath,
+    int batchSize = 1000,
+    JsonLinesImportProgressListener? onProgress,
+  });
+
+  /// Imports documents from JSON lines (also known as NDJSON), read from the
+  /// file at [path], into this collection.
+  ///
+  /// {@macro cbl.Collection.importJsonLines}
+  Future<int> importJsonLinesFile(
+    String path, {
+    String? idKeyPath,
+    int batchSize = 1000,
+    JsonLinesImportProgressListener? onProgress,
+  });
+
+  /// Deletes the documents in this collection for which [predicate] evaluates
+  /// to `true`.
+  ///
+  /// {@template cbl.Collection.removeWhere}
+  /// The matching documents are found with a query and removed natively on a
+  /// background thread, in transactions of at most [batchSize] documents.
+  /// The database is only locked while a batch is removed, so that other
+  /// operations can run between batches. Documents are matched when their
+  /// batch is removed, in the order of their IDs, and batches which have been
+  /// removed before the operation fails are not rolled back.
+  ///
+  /// [predicate] can use the same expressions as the `WHERE` clause of a
+  /// query on this collection, without referring to a data source alias.
+  ///
+  /// [onProgress] is called with the total number of affected documents after
+  /// every removed batch.
+  ///
+  /// Returns the number of affected documents.
+  /// {@endtemplate}
+  ///
+  /// ```dart
+  /// final deletedCount = await collection.deleteWhere(
+  ///   Expression.property('createdAt').lessThan(Expression.date(
+  ///     DateTime.now().subtract(const Duration(days: 30)),
+  ///   )),
+  /// );
+  /// ```
+  Future<int> deleteWhere(
+    ExpressionInterface predicate, {
+    int batchSize = 1000,
+    RemoveWhereProgressListener? onProgress,
+  });
+
+  /// Purges the documents in this collection for which [predicate] evaluates
+  /// to `true`.
+  ///
+  /// Unlike deleted documents, purged documents leave no tombstones behind,
+  /// and their removal is not replicated.
+  ///
+  /// {@macro cbl.Collection.removeWhere}
+  Future<int> purgeWhere(
+    ExpressionInterface predicate, {
+    int batchSize = 1000,
+    RemoveWhereProgressListener? onProgress,
+  });
+
   /// Adds a [listener] to be notified of all changes to [Document]s in this
   /// collection.
   ///
@@ -253,6 +547,13 @@ abstract interface class Collection {
   ///
   /// {@macro cbl.Collection.addChangeListener}
   ///
+  /// {@template cbl.Collection.addDocumentChangeListener.debounce}
+  /// If a [debounce] duration is given, the listener is notified once at the
+  /// end of the window that starts with the first change of the document,
+  /// instead of for every change. This is useful for documents which change
+  /// frequently, such as counters.
+  /// {@endtemplate}
+  ///
   /// See also:
   ///
   /// - [DocumentChange] for the change event given to [listener].
@@ -262,8 +563,9 @@ abstract interface class Collection {
   /// - [removeChangeListener] for removing a previously added listener.
   FutureOr<ListenerToken> addDocumentChangeListener(
     String id,
-    DocumentChangeListener listener,
-  );
+    DocumentChangeListener listener, {
+    Duration? debounce,
+  });
 
   /// {@template cbl.Collection.removeChangeListener}
   /// Removes a previously added change listener.
@@ -305,8 +607,27 @@ abstract interface class Collection {
   /// This is an alternative stream based API for the
   /// [addDocumentChangeListener] API.
   ///
+  /// {@macro cbl.Collection.addDocumentChangeListener.debounce}
+  ///
   /// {@macro cbl.Collection.AsyncListenStream}
-  Stream<DocumentChange> documentChanges(String id);
+  Stream<DocumentChange> documentChanges(String id, {Duration? debounce});
+
+  /// Returns a [Stream] of the [Document]s in this collection whose sequence
+  /// is larger than [sequence], in the order of their sequences.
+  ///
+  /// This is useful for incremental exports: Each [SequenceChangeBatch]
+  /// contains up to [batchSize] documents, including deleted documents, and a
+  /// [SequenceChangeBatch.checkpoint] which can be persisted and passed as
+  /// [sequence] to continue the export later. Every document appears at most
+  /// once, with its current revision.
+  ///
+  /// The documents are read natively in batches, and each batch is
+  /// transferred in a single buffer. The stream ends when there are no more
+  /// documents.
+  Stream<SequenceChangeBatch> changesSince(
+    int sequence, {
+    int batchSize = 1000,
+  });
 }
 
 /// A [Collection] with a primarily synchronous API.
@@ -322,6 +643,9 @@ abstract interface class SyncCollection extends Collection {
   @override
   Document? document(String id);
 
+  @override
+  List<Document?> documents(List<String> ids);
+
   @override
   DocumentFragment operator [](String id);
 
@@ -331,6 +655,19 @@ abstract interface class SyncCollection extends Collection {
     ConcurrencyControl concurrencyControl = ConcurrencyControl.lastWriteWins,
   ]);
 
+  @override
+  List<bool> saveDocuments(
+    List<MutableDocument> documents, [
+    ConcurrencyControl concurrencyControl = ConcurrencyControl.lastWriteWins,
+  ]);
+
+  @override
+  bool patchDocument(
+    String id,
+    Map<String, Object?> patch, [
+    ConcurrencyControl concurrencyControl = ConcurrencyControl.lastWriteWins,
+  ]);
+
   /// Saves a [document] to this database, resolving conflicts with an sync
   /// [conflictHandler].
   ///
@@ -352,12 +689,67 @@ abstract interface class SyncCollection extends Collection {
   @override
   void purgeDocumentById(String id);
 
+  /// Gets an existing [Document] by its [id], without blocking the current
+  /// isolate.
+  ///
+  /// {@template cbl.SyncCollection.inBackground}
+  /// The operation is executed natively on a background thread. Unlike with an
+  /// [AsyncCollection], no worker isolate is involved and documents are not
+  /// copied between isolates.
+  ///
+  /// Background operations are not part of transactions and cannot be started
+  /// while a transaction of the database is active in the current zone.
+  /// Operations are started in the order in which they are called, but can
+  /// complete in any order.
+  /// {@endtemplate}
+  Future<Document?> documentInBackground(String id);
+
+  /// Saves a [document] to this collection, without blocking the current
+  /// isolate.
+  ///
+  /// The [document] must not be modified until the returned future completes.
+  ///
+  /// {@macro cbl.SyncCollection.inBackground}
+  ///
+  /// See also:
+  ///
+  /// - [saveDocument] for the semantics of the [concurrencyControl].
+  Future<bool> saveDocumentInBackground(
+    MutableDocument document, [
+    ConcurrencyControl concurrencyControl = ConcurrencyControl.lastWriteWins,
+  ]);
+
+  /// Deletes a [document] from this collection, without blocking the current
+  /// isolate.
+  ///
+  /// {@macro cbl.SyncCollection.inBackground}
+  ///
+  /// See also:
+  ///
+  /// - [deleteDocument] for the semantics of the [concurrencyControl].
+  Future<bool> deleteDocumentInBackground(
+    Document document, [
+    ConcurrencyControl concurrencyControl = ConcurrencyControl.lastWriteWins,
+  ]);
+
+  /// Purges a document by its [id] from this collection, without blocking the
+  /// current isolate.
+  ///
+  /// {@macro cbl.SyncCollection.inBackground}
+  Future<void> purgeDocumentByIdInBackground(String id);
+
   @override
   void setDocumentExpiration(String id, DateTime? expiration);
 
+  @override
+  void setDocumentExpirations(Map<String, DateTime?> expirations);
+
   @override
   DateTime? getDocumentExpiration(String id);
 
+  @override
+  ExpirationStats get expirationStats;
+
   @override
   List<String> get indexes;
 
@@ -367,14 +759,28 @@ abstract interface class SyncCollection extends Collection {
   @override
   void deleteIndex(String name);
 
+  @override
+  List<FullTextSearchResult> fullTextSearch(
+    String indexName,
+    String query, {
+    int limit = 20,
+    int offset = 0,
+    String? snippetProperty,
+    int snippetWordCount = 16,
+    String matchStart = '<b>',
+    String matchEnd = '</b>',
+    String ellipsis = '…',
+  });
+
   @override
   ListenerToken addChangeListener(CollectionChangeListener listener);
 
   @override
   ListenerToken addDocumentChangeListener(
     String id,
-    DocumentChangeListener listener,
-  );
+    DocumentChangeListener listener, {
+    Duration? debounce,
+  });
 
   @override
   void removeChangeListener(ListenerToken token);
@@ -393,6 +799,9 @@ abstract interface class AsyncCollection extends Collection {
   @override
   Future<Document?> document(String id);
 
+  @override
+  Future<List<Document?>> documents(List<String> ids);
+
   @override
   Future<DocumentFragment> operator [](String id);
 
@@ -402,6 +811,19 @@ abstract interface class AsyncCollection extends Collection {
     ConcurrencyControl concurrencyControl = ConcurrencyControl.lastWriteWins,
   ]);
 
+  @override
+  Future<List<bool>> saveDocuments(
+    List<MutableDocument> documents, [
+    ConcurrencyControl concurrencyControl = ConcurrencyControl.lastWriteWins,
+  ]);
+
+  @override
+  Future<bool> patchDocument(
+    String id,
+    Map<String, Object?> patch, [
+    ConcurrencyControl concurrencyControl = ConcurrencyControl.lastWriteWins,
+  ]);
+
   @override
   Future<bool> saveDocumentWithConflictHandler(
     MutableDocument document,
@@ -423,9 +845,15 @@ abstract interface class AsyncCollection extends Collection {
   @override
   Future<void> setDocumentExpiration(String id, DateTime? expiration);
 
+  @override
+  Future<void> setDocumentExpirations(Map<String, DateTime?> expirations);
+
   @override
   Future<DateTime?> getDocumentExpiration(String id);
 
+  @override
+  Future<ExpirationStats> get expirationStats;
+
   @override
   Future<List<String>> get indexes;
 
@@ -435,14 +863,28 @@ abstract interface class AsyncCollection extends Collection {
   @override
   Future<void> deleteIndex(String name);
 
+  @override
+  Future<List<FullTextSearchResult>> fullTextSearch(
+    String indexName,
+    String query, {
+    int limit = 20,
+    int offset = 0,
+    String? snippetProperty,
+    int snippetWordCount = 16,
+    String matchStart = '<b>',
+    String matchEnd = '</b>',
+    String ellipsis = '…',
+  });
+
   @override
   Future<ListenerToken> addChangeListener(CollectionChangeListener listener);
 
   @override
   Future<ListenerToken> addDocumentChangeListener(
     String id,
-    DocumentChangeListener listener,
-  );
+    DocumentChangeListener listener, {
+    Duration? debounce,
+  });
 
   @override
   Future<void> removeChangeListener(ListenerToken token);
@@ -451,5 +893,8 @@ abstract interface class AsyncCollection extends Collection {
   AsyncListenStream<CollectionChange> changes();
 
   @override
-  AsyncListenStream<DocumentChange> documentChanges(String id);
+  AsyncListenStream<DocumentChange> documentChanges(
+    String id, {
+    Duration? debounce,
+  });
 }
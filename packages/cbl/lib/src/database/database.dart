@@ -24,6 +24,7 @@ import 'database_change.dart';
 import 'database_configuration.dart';
 import 'document_change.dart';
 import 'ffi_database.dart';
+import 'maintenance_schedule.dart';
 import 'proxy_database.dart';
 import 'scope.dart';
 
@@ -51,6 +52,16 @@ enum MaintenanceType {
 
   /// Check for database corruption.
   integrityCheck,
+
+  /// Quickly update the database statistics, which help to optimize the
+  /// queries that have been run since the database was opened.
+  optimize,
+
+  /// Fully scan all indexes to update the database statistics, which help to
+  /// optimize queries.
+  ///
+  /// This can take several minutes for large databases.
+  fullOptimize,
 }
 
 /// The result of [Database.saveTypedDocument], which needs to be used to
@@ -389,6 +400,13 @@ abstract interface class Database implements ClosableResource {
   /// the database when compacting the database.
   FutureOr<void> saveBlob(Blob blob);
 
+  /// Creates a [Blob] with the content of the file at [path] and saves it
+  /// directly into this database, like [saveBlob].
+  ///
+  /// The content is copied natively on a background thread, without being
+  /// loaded into memory, and its digest is computed while it is copied.
+  Future<Blob> saveBlobFromFile(String contentType, String path);
+
   /// Gets a [Blob] using its metadata.
   ///
   /// If the blob with the specified metadata doesn’t exist, returns `null`.
@@ -506,6 +524,30 @@ abstract interface class Database implements ClosableResource {
   /// Performs database maintenance.
   FutureOr<void> performMaintenance(MaintenanceType type);
 
+  /// Starts running the maintenance [types] of this database periodically in
+  /// the background, without blocking the calling isolate.
+  ///
+  /// A run starts at most every [interval], once no document of the
+  /// collections which exist when the schedule starts has been changed for
+  /// [idleTimeout]. The [types] are performed in the order of their
+  /// declaration in [MaintenanceType]. Other operations on this database only
+  /// wait for the type of maintenance which is being performed, not for the
+  /// whole run.
+  ///
+  /// [onProgress] is called when a type of maintenance starts and when a run
+  /// has finished.
+  ///
+  /// The schedule is stopped when it or this database is closed.
+  MaintenanceSchedule scheduleMaintenance({
+    Set<MaintenanceType> types = const {
+      MaintenanceType.compact,
+      MaintenanceType.optimize,
+    },
+    Duration interval = const Duration(hours: 1),
+    Duration idleTimeout = const Duration(seconds: 30),
+    MaintenanceProgressListener? onProgress,
+  });
+
   /// Encrypts or decrypts a [Database], or changes its [EncryptionKey].
   ///
   /// {@macro cbl.EncryptionKey.enterpriseFeature}
@@ -50,7 +50,8 @@ mixin DatabaseBase<T extends DocumentDelegate> implements Database {
   SharedKeysTable get sharedKeysTable;
 
   /// Lock under which asynchronous transactions are executed.
-  final asyncTransactionLock = Lock();
+  Lock get asyncTransactionLock => _asyncTransactionLock;
+  final _asyncTransactionLock = Lock();
 
   /// Prepares [document] for being used with this database.
   ///
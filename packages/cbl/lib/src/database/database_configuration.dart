@@ -136,15 +136,23 @@ final class EncryptionKeyImpl implements EncryptionKey {
 /// {@category Database}
 final class DatabaseConfiguration {
   /// Creates a configuration for opening or copying a [Database].
-  DatabaseConfiguration({String? directory, this.encryptionKey})
-      : directory = directory ?? _defaultDirectory();
+  DatabaseConfiguration({
+    String? directory,
+    this.encryptionKey,
+    this.sharedHandle = false,
+    this.workerPoolSize = 1,
+  }) : directory = directory ?? _defaultDirectory();
 
   /// Creates a configuration from another [config], by copying its properties.
   ///
   /// Does not copy [encryptionKey], to reduce locations and length of storage
   /// of security sensitive key material.
   DatabaseConfiguration.from(DatabaseConfiguration config)
-      : this(directory: config.directory);
+      : this(
+          directory: config.directory,
+          sharedHandle: config.sharedHandle,
+          workerPoolSize: config.workerPoolSize,
+        );
 
   /// Path to the directory to store the [Database] in.
   String directory;
@@ -154,16 +162,52 @@ final class DatabaseConfiguration {
   /// {@macro cbl.EncryptionKey.enterpriseFeature}
   EncryptionKey? encryptionKey;
 
+  /// Whether to share the native database with all other openers of the
+  /// same database in this process, which have also set this option.
+  ///
+  /// Opening a database with the same name and [directory] from multiple
+  /// isolates, normally opens the database multiple times, each with its own
+  /// caches. With this option, the database is only opened once and the
+  /// native database is shared, until the last opener closes it. Opening a
+  /// shared database fails if it is already open with a different
+  /// [encryptionKey].
+  ///
+  /// Transactions of different openers are executed one after the other.
+  /// Starting a transaction waits until the transactions of other openers
+  /// have ended. Writes outside of transactions are not isolated from the
+  /// transactions of other openers.
+  ///
+  /// Deleting a shared database fails while other openers have it open.
+  bool sharedHandle;
+
+  /// The number of worker isolates an [AsyncDatabase] uses.
+  ///
+  /// An [AsyncDatabase] normally executes all its operations in one worker
+  /// isolate, so that queries queue behind each other and behind writes. With
+  /// more than one worker, the additional workers each open the database
+  /// themselves and queries are distributed between them round-robin, so that
+  /// they can execute in parallel. All other operations, including writes,
+  /// are executed by the first worker.
+  ///
+  /// This option has no effect on a [SyncDatabase]. The default is `1`.
+  int workerPoolSize;
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
       other is DatabaseConfiguration &&
           runtimeType == other.runtimeType &&
           directory == other.directory &&
-          encryptionKey == other.encryptionKey;
+          encryptionKey == other.encryptionKey &&
+          sharedHandle == other.sharedHandle &&
+          workerPoolSize == other.workerPoolSize;
 
   @override
-  int get hashCode => directory.hashCode ^ encryptionKey.hashCode;
+  int get hashCode =>
+      directory.hashCode ^
+      encryptionKey.hashCode ^
+      sharedHandle.hashCode ^
+      workerPoolSize.hashCode;
 
   @override
   String toString() => [
@@ -171,6 +215,8 @@ final class DatabaseConfiguration {
         [
           'directory: $directory',
           if (encryptionKey != null) 'ENCRYPTION-KEY',
+          if (sharedHandle) 'SHARED-HANDLE',
+          if (workerPoolSize != 1) 'workerPoolSize: $workerPoolSize',
         ].join(', '),
         ')',
       ].join();
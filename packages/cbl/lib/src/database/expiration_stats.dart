@@ -0,0 +1,54 @@
+import 'package:meta/meta.dart';
+
+import 'collection.dart';
+
+/// Stats about the expiration of the documents of a [Collection], whose
+/// expiration dates have been set through this library.
+///
+/// The stats are collected since the database has been opened and only cover
+/// expiration dates set with [Collection.setDocumentExpiration] or
+/// [Collection.setDocumentExpirations] while the database was open.
+///
+/// {@category Database}
+@immutable
+final class ExpirationStats {
+  /// Creates stats about the expiration of the documents of a [Collection].
+  const ExpirationStats({
+    required this.purgedCount,
+    required this.pendingCount,
+    this.nextExpiration,
+  });
+
+  /// The number of documents which have been purged, because they expired.
+  final int purgedCount;
+
+  /// The number of documents with an expiration date, which have not been
+  /// purged yet.
+  final int pendingCount;
+
+  /// The earliest expiration date of the documents which have not been purged
+  /// yet, or `null` if there are no such documents.
+  final DateTime? nextExpiration;
+
+  @override
+  bool operator ==(Object other) =>
+      identical(this, other) ||
+      other is ExpirationStats &&
+          purgedCount == other.purgedCount &&
+          pendingCount == other.pendingCount &&
+          nextExpiration == other.nextExpiration;
+
+  @override
+  int get hashCode => Object.hash(purgedCount, pendingCount, nextExpiration);
+
+  @override
+  String toString() => [
+        'ExpirationStats(',
+        [
+          'purgedCount: $purgedCount',
+          'pendingCount: $pendingCount',
+          if (nextExpiration != null) 'nextExpiration: $nextExpiration',
+        ].join(', '),
+        ')',
+      ].join();
+}
@@ -1,9 +1,13 @@
 import 'dart:async';
 import 'dart:ffi';
+import 'dart:math';
+import 'dart:typed_data';
 
 import '../bindings.dart';
 import '../document/blob.dart';
+import '../document/blob_cache.dart';
 import '../fleece/containers.dart';
+import '../support/async_callback.dart';
 import '../support/errors.dart';
 import '../support/ffi.dart';
 import '../support/native_object.dart';
@@ -47,13 +51,18 @@ final class FfiBlobStore implements BlobStore, SyncBlobStore {
   FfiBlobStore(this.database);
 
   static final _databaseBindings = cblBindings.database;
+  static final _blobBindings = cblBindings.blobs.blob;
 
   final FfiDatabase database;
 
   @override
   Map<String, Object?> saveBlobFromDataSync(String contentType, Data data) {
     final blob = _FfiBlob.createWithData(contentType, data);
-    _saveBlob(blob);
+    // The digest of the blob is known before its content is written, which
+    // allows saving the content to be skipped if it already exists.
+    runWithErrorTranslation(
+      () => _blobBindings.saveDeduplicated(database.pointer, blob.pointer),
+    );
     return blob.createBlobProperties();
   }
 
@@ -74,6 +83,24 @@ final class FfiBlobStore implements BlobStore, SyncBlobStore {
     return blob.createBlobProperties();
   }
 
+  @override
+  Future<Map<String, Object?>> saveBlobFromFile(
+    String contentType,
+    String path,
+  ) async {
+    final message = await _copyFile(
+      (callback) => _blobBindings.createFromFile(
+        database.pointer,
+        path,
+        contentType,
+        callback,
+      ),
+      debugName: 'FfiBlobStore.saveBlobFromFile',
+    );
+    return _FfiBlob.fromPointer(message.blob!, adopt: true)
+        .createBlobProperties();
+  }
+
   @override
   bool blobExists(Map<String, Object?> properties) {
     final dict = MutableDict(properties);
@@ -91,12 +118,126 @@ final class FfiBlobStore implements BlobStore, SyncBlobStore {
   }
 
   @override
-  Data? readBlobSync(Map<String, Object?> properties) =>
-      _getBlob(properties)?.content();
+  Data? readBlobSync(Map<String, Object?> properties) {
+    final digest = _cacheableDigest(properties);
+    if (digest == null) {
+      return _getBlob(properties)?.content();
+    }
+
+    final cachedContent =
+        _blobBindings.cachedContent(database.pointer, digest);
+    if (cachedContent != null) {
+      return cachedContent;
+    }
+
+    final content = _getBlob(properties)?.content();
+    if (content != null) {
+      _blobBindings.cacheContent(database.pointer, digest, content);
+    }
+    return content;
+  }
+
+  @override
+  Stream<Data>? readBlob(
+    Map<String, Object?> properties, {
+    int start = 0,
+    int? end,
+    int readAhead = 0,
+  }) {
+    // Small blobs are read at once, through the blob cache, instead of
+    // opening a read stream.
+    if (_cacheableDigest(properties) != null) {
+      return readBlobSync(properties)?.let((content) {
+        if (start == 0 && end == null) {
+          return Stream.value(content);
+        }
+        return Stream.value(Data.fromTypedList(
+          Uint8List.sublistView(content.toTypedList(), start, end),
+        ));
+      });
+    }
+
+    return _getBlob(properties)?.let((it) => readAhead > 0
+        ? _BlobReadAheadStream(
+            database,
+            it,
+            chunkCount: readAhead,
+            start: start,
+            end: end,
+          )
+        : _BlobReadStream(database, it, start: start, end: end));
+  }
+
+  /// Returns the digest of the blob with [properties], if its content fits
+  /// into the [BlobCache].
+  String? _cacheableDigest(Map<String, Object?> properties) {
+    final digest = properties[blobDigestProperty];
+    final length = properties[blobLengthProperty];
+    if (digest is! String || length is! int) {
+      return null;
+    }
+
+    final stats = _blobBindings.cacheStats();
+    if (length > stats.maxSize || length > stats.maxEntrySize) {
+      return null;
+    }
+    return digest;
+  }
 
   @override
-  Stream<Data>? readBlob(Map<String, Object?> properties) =>
-      _getBlob(properties)?.let((it) => _BlobReadStream(database, it));
+  Future<bool> writeBlobToFile(
+    Map<String, Object?> properties,
+    String path,
+  ) async {
+    final blob = _getBlob(properties);
+    if (blob == null) {
+      return false;
+    }
+
+    await _copyFile(
+      (callback) => _blobBindings.writeToFile(
+        database.pointer,
+        blob.pointer,
+        path,
+        callback,
+      ),
+      debugName: 'FfiBlobStore.writeBlobToFile',
+    );
+    return true;
+  }
+
+  /// Runs a native copy of a file into or out of a blob, which is started by
+  /// [start] on a background thread, and completes with its result.
+  Future<BlobFileCopyCallbackMessage> _copyFile(
+    void Function(Pointer<CBLDartAsyncCallback> callback) start, {
+    required String debugName,
+  }) {
+    final result = Completer<BlobFileCopyCallbackMessage>();
+    late final AsyncCallback callback;
+    callback = AsyncCallback(
+      (arguments) {
+        callback.close();
+        final message = BlobFileCopyCallbackMessage.fromArguments(arguments);
+        final error = message.error;
+        if (error != null) {
+          result.completeError(error.toCouchbaseLiteException());
+        } else {
+          result.complete(message);
+        }
+        return null;
+      },
+      debugName: debugName,
+    );
+
+    try {
+      start(callback.pointer);
+    } catch (_) {
+      callback.close();
+      rethrow;
+    }
+
+    return result.future;
+  }
 
   void _saveBlob(_FfiBlob blob) {
     runWithErrorTranslation(
@@ -142,16 +283,26 @@ Future<_FfiBlob> _createBlobFromStream(
 }
 
 final class _BlobReadStream extends Stream<Data> implements Finalizable {
-  _BlobReadStream(this.parent, this.blob);
+  _BlobReadStream(this.parent, this.blob, {this.start = 0, this.end});
 
-  /// Size of the chunks which a blob read stream emits.
-  static const _readStreamChunkSize = 8 * 1024;
+  /// Size of the first chunk which a blob read stream emits.
+  ///
+  /// After each chunk which filled the requested size, the chunk size is
+  /// doubled, up to [BlobReadStreamBindings.maxChunkSize], so that small blobs
+  /// are read with little memory and large blobs in few chunks.
+  static const _initialChunkSize = 8 * 1024;
 
   static final _readStreamBindings = cblBindings.blobs.readStream;
 
   final ClosableResourceMixin parent;
   final _FfiBlob blob;
 
+  /// The offset of the first byte to read.
+  final int start;
+
+  /// The offset after the last byte to read, or `null` to read to the end.
+  final int? end;
+
   late final _controller = StreamController<Data>(
     onListen: _start,
     onPause: _pause,
@@ -162,27 +313,46 @@ final class _BlobReadStream extends Stream<Data> implements Finalizable {
   late final Pointer<CBLBlobReadStream> pointer = () {
     final pointer = _readStreamBindings.openContentStream(blob.pointer);
     _readStreamBindings.bindToDartObject(this, pointer);
+    if (start > 0) {
+      runWithErrorTranslation(() => _readStreamBindings.seek(pointer, start));
+    }
     return pointer;
   }();
 
   var _isPaused = false;
+  var _chunkSize = _initialChunkSize;
+  late var _remaining = end?.let((end) => end - start);
 
   void _start() {
     try {
       _isPaused = false;
 
       while (!_isPaused) {
-        final buffer = runWithErrorTranslation(
-          () => _readStreamBindings.read(pointer, _readStreamChunkSize),
-        );
-
-        // The read stream is done (EOF).
-        if (buffer == null) {
+        final remaining = _remaining;
+        final chunk = remaining == 0
+            ? null
+            : runWithErrorTranslation(
+                () => _readStreamBindings.read(
+                  pointer,
+                  remaining == null ? _chunkSize : min(_chunkSize, remaining),
+                ),
+              );
+
+        // The read stream is done (EOF) or the end of the range is reached.
+        if (chunk == null) {
           _controller.close();
           break;
         }
 
-        _controller.add(buffer);
+        _controller.add(Data.fromTypedList(chunk));
+        if (remaining != null) {
+          _remaining = remaining - chunk.length;
+        }
+
+        if (chunk.length == _chunkSize) {
+          _chunkSize =
+              min(_chunkSize * 2, BlobReadStreamBindings.maxChunkSize);
+        }
       }
       // ignore: avoid_catches_without_on_clauses
     } catch (error, stackTrace) {
@@ -210,3 +380,130 @@ final class _BlobReadStream extends Stream<Data> implements Finalizable {
             cancelOnError: cancelOnError,
           );
 }
+
+/// A stream of the content of a blob, which is read natively on a background
+/// thread, ahead of the listener.
+///
+/// Chunks are handed over from the background thread without being copied.
+/// When the listener has taken all chunks which have been read so far, the
+/// stream waits for a callback from the background thread, instead of
+/// blocking the isolate.
+final class _BlobReadAheadStream extends Stream<Data> {
+  _BlobReadAheadStream(
+    this.database,
+    this.blob, {
+    required this.chunkCount,
+    this.start = 0,
+    this.end,
+  });
+
+  /// Size of the chunks which are read ahead.
+  static const _chunkSize = 256 * 1024;
+
+  static final _readAheadBindings = cblBindings.blobs.readAhead;
+
+  final FfiDatabase database;
+  final _FfiBlob blob;
+
+  /// The maximum number of chunks which are buffered ahead of the listener.
+  final int chunkCount;
+
+  /// The offset of the first byte to read.
+  final int start;
+
+  /// The offset after the last byte to read, or `null` to read to the end.
+  final int? end;
+
+  late final _controller = StreamController<Data>(
+    onListen: _start,
+    onPause: _pause,
+    onResume: _resume,
+    onCancel: _stop,
+  );
+
+  AsyncCallback? _callback;
+  late Pointer<CBLDart_BlobReadAhead> _pointer;
+  var _isPaused = false;
+
+  void _start() {
+    final callback = _callback = AsyncCallback(
+      (_) {
+        _deliver();
+        return null;
+      },
+      debugName: 'Blob.contentStream',
+    );
+    _pointer = _readAheadBindings.start(
+      database.pointer,
+      blob.pointer,
+      start: start,
+      end: end,
+      chunkSize: _chunkSize,
+      chunkCount: chunkCount,
+      callback: callback.pointer,
+    );
+    _deliver();
+  }
+
+  void _deliver() {
+    if (_callback == null) {
+      return;
+    }
+
+    try {
+      while (!_isPaused) {
+        final chunk = runWithErrorTranslation(
+          () => _readAheadBindings.next(_pointer),
+        );
+
+        // The next chunk has not been read yet.
+        if (chunk == null) {
+          return;
+        }
+
+        if (chunk.size == 0) {
+          _stop();
+          _controller.close();
+          return;
+        }
+
+        _controller.add(chunk);
+      }
+      // ignore: avoid_catches_without_on_clauses
+    } catch (error, stackTrace) {
+      _stop();
+      _controller
+        ..addError(error, stackTrace)
+        ..close();
+    }
+  }
+
+  void _pause() => _isPaused = true;
+
+  void _resume() {
+    _isPaused = false;
+    _deliver();
+  }
+
+  /// Closes the callback, which stops the background thread.
+  void _stop() {
+    _callback?.close();
+    _callback = null;
+  }
+
+  @override
+  StreamSubscription<Data> listen(
+    void Function(Data event)? onData, {
+    Function? onError,
+    void Function()? onDone,
+    bool? cancelOnError,
+  }) =>
+      _controller.stream
+          .transform(ResourceStreamTransformer(parent: database))
+          .listen(
+            onData,
+            onError: onError,
+            onDone: onDone,
+            cancelOnError: cancelOnError,
+          );
+}
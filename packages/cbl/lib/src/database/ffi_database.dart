@@ -1,8 +1,11 @@
 import 'dart:async';
+import 'dart:convert';
 import 'dart:ffi';
 import 'dart:io';
+import 'dart:typed_data';
 
 import 'package:path/path.dart' as path_lib;
+import 'package:synchronized/synchronized.dart';
 
 import '../bindings.dart';
 import '../document/blob.dart';
@@ -13,6 +16,8 @@ import '../errors.dart';
 import '../fleece/containers.dart' as fl;
 import '../fleece/decoder.dart';
 import '../fleece/dict_key.dart';
+import '../fleece/encoder.dart';
+import '../query/expressions/expression.dart';
 import '../query/ffi_query.dart';
 import '../query/index/index.dart';
 import '../query/query.dart';
@@ -35,8 +40,12 @@ import 'database_base.dart';
 import 'database_change.dart';
 import 'database_configuration.dart';
 import 'document_change.dart';
+import 'expiration_stats.dart';
 import 'ffi_blob_store.dart';
+import 'full_text_search_result.dart';
+import 'maintenance_schedule.dart';
 import 'scope.dart';
+import 'sequence_change.dart';
 
 final _bindings = cblBindings.database;
 
@@ -53,11 +62,32 @@ final class FfiDatabase
     // Ensure the directory exists, in which to create the database,
     Directory(config.directory).createSync(recursive: true);
 
+    final cblConfig = config.toCBLDatabaseConfiguration();
+
+    if (config.sharedHandle) {
+      // Shared databases are identified by their directory, which must be
+      // resolved, so that all paths to it identify the same database.
+      final sharedConfig = CBLDatabaseConfiguration(
+        directory: Directory(config.directory).resolveSymbolicLinksSync(),
+        encryptionKey: cblConfig.encryptionKey,
+      );
+      final sharedHandle = runWithErrorTranslation(
+        () => _bindings.openShared(name, sharedConfig),
+      );
+      return FfiDatabase._(
+        // Make a copy of the configuration, since its mutable.
+        config: DatabaseConfiguration.from(config),
+        pointer: _bindings.sharedDatabase(sharedHandle),
+        sharedHandle: sharedHandle,
+        typedDataAdapter: typedDataAdapter,
+      );
+    }
+
     return FfiDatabase._(
       // Make a copy of the configuration, since its mutable.
       config: DatabaseConfiguration.from(config),
       pointer: runWithErrorTranslation(
-        () => _bindings.open(name, config!.toCBLDatabaseConfiguration()),
+        () => _bindings.open(name, cblConfig),
       ),
       typedDataAdapter: typedDataAdapter,
     );
@@ -67,8 +97,14 @@ final class FfiDatabase
     required DatabaseConfiguration config,
     required this.pointer,
     required this.typedDataAdapter,
-  }) : _config = config {
-    _bindings.bindToDartObject(this, pointer);
+    Pointer<CBLDartSharedDatabase>? sharedHandle,
+  })  : _config = config,
+        _sharedHandle = sharedHandle {
+    if (sharedHandle != null) {
+      _bindings.bindSharedToDartObject(this, sharedHandle);
+    } else {
+      _bindings.bindToDartObject(this, pointer);
+    }
     name = _bindings.name(pointer);
     _path = _bindings.path(pointer);
   }
@@ -104,6 +140,23 @@ final class FfiDatabase
 
   final Pointer<CBLDatabase> pointer;
 
+  /// The handle through which this database shares [pointer] with other
+  /// openers, if it was opened with [DatabaseConfiguration.sharedHandle].
+  final Pointer<CBLDartSharedDatabase>? _sharedHandle;
+
+  /// The locks for the asynchronous transactions of the shared databases,
+  /// which are shared by all openers of a database in this isolate.
+  ///
+  /// Natively, a transaction of one opener waits for the transactions of
+  /// other openers to end, which would block this isolate forever, if the
+  /// other transaction has been started in this isolate too.
+  static final _sharedTransactionLocks = <int, Lock>{};
+
+  @override
+  late final Lock asyncTransactionLock = _sharedHandle == null
+      ? super.asyncTransactionLock
+      : _sharedTransactionLocks[pointer.address] ??= Lock();
+
   @override
   final TypedDataAdapter? typedDataAdapter;
 
@@ -120,6 +173,10 @@ final class FfiDatabase
 
   var _deleteOnClose = false;
 
+  /// The queue of the background document operations of the collections of
+  /// this database, which is only created when it is first used.
+  late final _documentOperations = _FfiDocumentOperations(this);
+
   @override
   late final String name;
 
@@ -210,14 +267,26 @@ final class FfiDatabase
 
   @override
   void beginTransaction() {
-    runWithErrorTranslation(() => _bindings.beginTransaction(pointer));
+    runWithErrorTranslation(() {
+      final sharedHandle = _sharedHandle;
+      if (sharedHandle != null) {
+        _bindings.beginSharedTransaction(sharedHandle);
+      } else {
+        _bindings.beginTransaction(pointer);
+      }
+    });
   }
 
   @override
   void endTransaction({required bool commit}) {
-    runWithErrorTranslation(
-      () => _bindings.endTransaction(pointer, commit: commit),
-    );
+    runWithErrorTranslation(() {
+      final sharedHandle = _sharedHandle;
+      if (sharedHandle != null) {
+        _bindings.endSharedTransaction(sharedHandle, commit: commit);
+      } else {
+        _bindings.endTransaction(pointer, commit: commit);
+      }
+    });
   }
 
   @override
@@ -303,6 +372,13 @@ final class FfiDatabase
             allowFromStreamForSyncDatabase: true,
           ));
 
+  @override
+  Future<Blob> saveBlobFromFile(String contentType, String path) =>
+      use(() async => BlobImpl.fromProperties(
+            await blobStore.saveBlobFromFile(contentType, path),
+            database: this,
+          ));
+
   @override
   Blob? getBlob(Map<String, Object?> properties) => useSync(() {
         checkBlobMetadata(properties);
@@ -355,7 +431,14 @@ final class FfiDatabase
   @override
   Future<void> performClose() async {
     runWithErrorTranslation(() {
-      if (_deleteOnClose) {
+      final sharedHandle = _sharedHandle;
+      if (sharedHandle != null) {
+        if (_deleteOnClose) {
+          _bindings.deleteShared(sharedHandle);
+        } else {
+          _bindings.closeShared(sharedHandle);
+        }
+      } else if (_deleteOnClose) {
         _bindings.delete(pointer);
       } else {
         _bindings.close(pointer);
@@ -383,6 +466,24 @@ final class FfiDatabase
         );
       });
 
+  @override
+  MaintenanceSchedule scheduleMaintenance({
+    Set<MaintenanceType> types = const {
+      MaintenanceType.compact,
+      MaintenanceType.optimize,
+    },
+    Duration interval = const Duration(hours: 1),
+    Duration idleTimeout = const Duration(seconds: 30),
+    MaintenanceProgressListener? onProgress,
+  }) =>
+      useSync(() => _FfiMaintenanceSchedule(
+            this,
+            types,
+            interval: interval,
+            idleTimeout: idleTimeout,
+            onProgress: onProgress,
+          ));
+
   @override
   void changeEncryptionKey(EncryptionKey? newKey) => useSync(() {
         runWithErrorTranslation(
@@ -525,6 +626,26 @@ final class FfiCollection
         ),
       );
 
+  @override
+  List<Document?> documents(List<String> ids) => syncOperationTracePoint(
+        () => GetDocumentsOp(this, ids),
+        () => useSync(
+          () => runWithErrorTranslation(
+            () => _collectionBindings.getDocuments(pointer, ids),
+          )
+              .map((documentPointer) => documentPointer?.let(
+                    (documentPointer) => DelegateDocument(
+                      FfiDocumentDelegate.fromPointer(
+                        documentPointer,
+                        adopt: true,
+                      ),
+                      collection: this,
+                    ),
+                  ))
+              .toList(),
+        ),
+      );
+
   @override
   DocumentFragment operator [](String id) => DocumentFragmentImpl(document(id));
 
@@ -555,6 +676,61 @@ final class FfiCollection
         ),
       );
 
+  @override
+  List<bool> saveDocuments(
+    covariant List<MutableDelegateDocument> documents, [
+    ConcurrencyControl concurrencyControl = ConcurrencyControl.lastWriteWins,
+  ]) =>
+      syncOperationTracePoint(
+        () => SaveDocumentsOp(this, documents, concurrencyControl),
+        () => useSync(
+          () => database.runInTransactionSync(() {
+            final delegates = [
+              for (final document in documents)
+                syncOperationTracePoint(
+                  () => PrepareDocumentOp(document),
+                  () => prepareDocument(document) as FfiDocumentDelegate,
+                ),
+            ];
+
+            return runWithErrorTranslation(
+              () => _collectionBindings.saveDocuments(
+                pointer,
+                [for (final delegate in delegates) delegate.pointer.cast()],
+                concurrencyControl.toCBLConcurrencyControl(),
+              ),
+            );
+          }),
+        ),
+      );
+
+  @override
+  bool patchDocument(
+    String id,
+    Map<String, Object?> patch, [
+    ConcurrencyControl concurrencyControl = ConcurrencyControl.lastWriteWins,
+  ]) =>
+      syncOperationTracePoint(
+        () => PatchDocumentOp(this, id, concurrencyControl),
+        () => useSync(
+          () => database.runInTransactionSync(() {
+            final encodedPatch =
+                (FleeceEncoder()..writeDartObject(patch)).finish();
+
+            return _catchConflictException(() {
+              runWithErrorTranslation(
+                () => _collectionBindings.patchDocument(
+                  pointer,
+                  id,
+                  encodedPatch,
+                  concurrencyControl.toCBLConcurrencyControl(),
+                ),
+              );
+            });
+          }),
+        ),
+      );
+
   @override
   FutureOr<bool> saveDocumentWithConflictHandler(
     covariant MutableDelegateDocument document,
@@ -628,12 +804,119 @@ final class FfiCollection
       );
 
   @override
-  void setDocumentExpiration(String id, DateTime? expiration) => useSync(() {
-        runWithErrorTranslation(
-          () => _collectionBindings.setDocumentExpiration(
+  Future<Document?> documentInBackground(String id) =>
+      asyncOperationTracePoint(
+        () => GetDocumentOp(this, id),
+        () => use(() async {
+          final delegate = await _runInBackground(
+            (operations, operationId) =>
+                _collectionBindings.getDocumentInBackground(
+              operations,
+              pointer,
+              id,
+              operationId,
+            ),
+          ) as FfiDocumentDelegate?;
+
+          return delegate?.let((delegate) => DelegateDocument(
+                delegate,
+                collection: this,
+              ));
+        }),
+      );
+
+  @override
+  Future<bool> saveDocumentInBackground(
+    covariant MutableDelegateDocument document, [
+    ConcurrencyControl concurrencyControl = ConcurrencyControl.lastWriteWins,
+  ]) =>
+      asyncOperationTracePoint(
+        () => SaveDocumentOp(this, document, concurrencyControl),
+        () => use(() async {
+          final delegate = syncOperationTracePoint(
+            () => PrepareDocumentOp(document),
+            () => prepareDocument(document) as FfiDocumentDelegate,
+          );
+
+          return await _runInBackground(
+            (operations, operationId) =>
+                _collectionBindings.saveDocumentInBackground(
+              operations,
+              pointer,
+              delegate.pointer.cast(),
+              concurrencyControl.toCBLConcurrencyControl(),
+              operationId,
+            ),
+          ) as bool;
+        }),
+      );
+
+  @override
+  Future<bool> deleteDocumentInBackground(
+    covariant DelegateDocument document, [
+    ConcurrencyControl concurrencyControl = ConcurrencyControl.lastWriteWins,
+  ]) =>
+      asyncOperationTracePoint(
+        () => DeleteDocumentOp(this, document, concurrencyControl),
+        () => use(() async {
+          final delegate = syncOperationTracePoint(
+            () => PrepareDocumentOp(document),
+            () => prepareDocument(document, syncProperties: false)
+                as FfiDocumentDelegate,
+          );
+
+          return await _runInBackground(
+            (operations, operationId) =>
+                _collectionBindings.deleteDocumentInBackground(
+              operations,
+              pointer,
+              delegate.pointer,
+              concurrencyControl.toCBLConcurrencyControl(),
+              operationId,
+            ),
+          ) as bool;
+        }),
+      );
+
+  @override
+  Future<void> purgeDocumentByIdInBackground(String id) => use(
+        () => _runInBackground(
+          (operations, operationId) =>
+              _collectionBindings.purgeDocumentInBackground(
+            operations,
             pointer,
             id,
-            expiration,
+            operationId,
+          ),
+        ),
+      );
+
+  Future<Object?> _runInBackground(_DocumentOperationSubmitter submit) {
+    if (database.ownsCurrentTransaction) {
+      throw DatabaseException(
+        'Background operations cannot be part of a transaction.',
+        DatabaseErrorCode.transactionNotClosed,
+      );
+    }
+
+    return database._documentOperations.run(submit);
+  }
+
+  @override
+  void setDocumentExpiration(String id, DateTime? expiration) =>
+      setDocumentExpirations({id: expiration});
+
+  @override
+  void setDocumentExpirations(Map<String, DateTime?> expirations) =>
+      useSync(() {
+        if (expirations.isEmpty) {
+          return;
+        }
+
+        runWithErrorTranslation(
+          () => _collectionBindings.setDocumentExpirations(
+            pointer,
+            expirations,
           ),
         );
       });
@@ -645,6 +928,18 @@ final class FfiCollection
         ),
       );
 
+  @override
+  ExpirationStats get expirationStats => useSync(() {
+        final stats = _collectionBindings.expirationStats(pointer);
+        return ExpirationStats(
+          purgedCount: stats.purgedCount,
+          pendingCount: stats.pendingCount,
+          nextExpiration: stats.nextExpiration == 0
+              ? null
+              : DateTime.fromMillisecondsSinceEpoch(stats.nextExpiration),
+        );
+      });
+
   @override
   List<String> get indexes => useSync(() =>
       fl.Array.fromPointer(_collectionBindings.indexNames(pointer), adopt: true)
@@ -669,6 +964,189 @@ final class FfiCollection
             () => _collectionBindings.deleteIndex(pointer, name));
       });
 
+  @override
+  List<FullTextSearchResult> fullTextSearch(
+    String indexName,
+    String query, {
+    int limit = 20,
+    int offset = 0,
+    String? snippetProperty,
+    int snippetWordCount = 16,
+    String matchStart = '<b>',
+    String matchEnd = '</b>',
+    String ellipsis = '…',
+  }) =>
+      useSync(() {
+        if (limit < 1) {
+          throw RangeError.range(limit, 1, null, 'limit');
+        }
+        if (offset < 0) {
+          throw RangeError.range(offset, 0, null, 'offset');
+        }
+        if (snippetWordCount < 1) {
+          throw RangeError.range(
+            snippetWordCount,
+            1,
+            null,
+            'snippetWordCount',
+          );
+        }
+
+        final data = runWithErrorTranslation(
+          () => _collectionBindings.fullTextSearch(
+            pointer,
+            indexName: indexName,
+            query: query,
+            limit: limit,
+            offset: offset,
+            snippetProperty: snippetProperty,
+            snippetWordCount: snippetWordCount,
+            matchStart: matchStart,
+            matchEnd: matchEnd,
+            ellipsis: ellipsis,
+          ),
+        );
+        final rows =
+            const FleeceDecoder(trust: FLTrust.trusted).convert(data)! as List;
+
+        return [
+          for (final row in rows.cast<List<Object?>>())
+            FullTextSearchResult(
+              id: row[0]! as String,
+              rank: (row[1]! as num).toDouble(),
+              snippet: row.length > 2 ? row[2] as String? : null,
+            ),
+        ];
+      });
+
+  @override
+  IndexBuild buildIndex(
+    String name,
+    covariant IndexImplInterface index, {
+    IndexBuildProgressListener? onProgress,
+  }) =>
+      useSync(() => _FfiIndexBuild(
+            this,
+            name,
+            index.toCBLIndexSpec(),
+            onProgress: onProgress,
+          ));
+
+  @override
+  Future<int> importJsonLines(
+    Stream<List<int>> source, {
+    String? idKeyPath,
+    int batchSize = 1000,
+    JsonLinesImportProgressListener? onProgress,
+  }) =>
+      use(() async {
+        final import = _FfiJsonLinesImport(
+          this,
+          idKeyPath: idKeyPath,
+          batchSize: batchSize,
+          onProgress: onProgress,
+        )..addStream(source);
+        return import.result;
+      });
+
+  @override
+  Future<int> importJsonLinesFile(
+    String path, {
+    String? idKeyPath,
+    int batchSize = 1000,
+    JsonLinesImportProgressListener? onProgress,
+  }) =>
+      use(() async {
+        final import = _FfiJsonLinesImport(
+          this,
+          idKeyPath: idKeyPath,
+          batchSize: batchSize,
+          onProgress: onProgress,
+        )..addFile(path);
+        return import.result;
+      });
+
+  @override
+  Future<int> deleteWhere(
+    covariant ExpressionImpl predicate, {
+    int batchSize = 1000,
+    RemoveWhereProgressListener? onProgress,
+  }) =>
+      use(() => _removeWhere(
+            predicate,
+            batchSize: batchSize,
+            onProgress: onProgress,
+            purge: false,
+          ));
+
+  @override
+  Future<int> purgeWhere(
+    covariant ExpressionImpl predicate, {
+    int batchSize = 1000,
+    RemoveWhereProgressListener? onProgress,
+  }) =>
+      use(() => _removeWhere(
+            predicate,
+            batchSize: batchSize,
+            onProgress: onProgress,
+            purge: true,
+          ));
+
+  Future<int> _removeWhere(
+    ExpressionImpl predicate, {
+    required int batchSize,
+    required RemoveWhereProgressListener? onProgress,
+    required bool purge,
+  }) {
+    if (batchSize < 1) {
+      throw RangeError.range(batchSize, 1, null, 'batchSize');
+    }
+
+    final result = Completer<int>();
+    var affectedCount = 0;
+    late final AsyncCallback callback;
+    callback = AsyncCallback(
+      (arguments) {
+        final message = RemoveWhereCallbackMessage.fromArguments(arguments);
+        if (message.affectedCount != affectedCount) {
+          affectedCount = message.affectedCount;
+          onProgress?.call(affectedCount);
+        }
+
+        if (message.isDone) {
+          callback.close();
+          final error = message.error;
+          if (error != null) {
+            result.completeError(error.toCouchbaseLiteException());
+          } else {
+            result.complete(affectedCount);
+          }
+        }
+        return null;
+      },
+      debugName:
+          purge ? 'FfiCollection.purgeWhere' : 'FfiCollection.deleteWhere',
+    );
+
+    try {
+      runWithErrorTranslation(
+        () => _collectionBindings.removeWhere(
+          database.pointer,
+          pointer,
+          jsonEncode(predicate.toJson()),
+          batchSize,
+          callback.pointer,
+          purge: purge,
+        ),
+      );
+    } catch (_) {
+      callback.close();
+      rethrow;
+    }
+
+    return result.future;
+  }
+
   @override
   ListenerToken addChangeListener(CollectionChangeListener listener) =>
       useSync(() => _addChangeListener(listener).also(_listenerTokens.add));
@@ -683,6 +1161,7 @@ final class FfiCollection
         return null;
       },
       debugName: 'FfiCollection.addChangeListener',
+      maxBatchSize: AsyncCallback.listenerMaxBatchSize,
     );
 
     runWithErrorTranslation(
@@ -699,14 +1178,16 @@ final class FfiCollection
   @override
   ListenerToken addDocumentChangeListener(
     String id,
-    DocumentChangeListener listener,
-  ) =>
-      useSync(() =>
-          _addDocumentChangeListener(id, listener).also(_listenerTokens.add));
+    DocumentChangeListener listener, {
+    Duration? debounce,
+  }) =>
+      useSync(() => _addDocumentChangeListener(id, listener, debounce)
+          .also(_listenerTokens.add));
 
   AbstractListenerToken _addDocumentChangeListener(
     String id,
     DocumentChangeListener listener,
+    Duration? debounce,
   ) {
     final callback = AsyncCallback(
       (_) {
@@ -715,6 +1196,7 @@ final class FfiCollection
         return null;
       },
       debugName: 'FfiCollection.addDocumentChangeListener',
+      maxBatchSize: AsyncCallback.listenerMaxBatchSize,
     );
 
     runWithErrorTranslation(
@@ -722,6 +1204,7 @@ final class FfiCollection
         database.pointer,
         pointer,
         id,
+        debounce,
         callback.pointer,
       ),
     );
@@ -742,12 +1225,46 @@ final class FfiCollection
       ));
 
   @override
-  Stream<DocumentChange> documentChanges(String id) =>
+  Stream<DocumentChange> documentChanges(String id, {Duration? debounce}) =>
       useSync(() => ListenerStream(
             parent: this,
-            addListener: (listener) => _addDocumentChangeListener(id, listener),
+            addListener: (listener) =>
+                _addDocumentChangeListener(id, listener, debounce),
           ));
 
+  @override
+  Stream<SequenceChangeBatch> changesSince(
+    int sequence, {
+    int batchSize = 1000,
+  }) =>
+      useSync(() => _changesSince(sequence, batchSize));
+
+  Stream<SequenceChangeBatch> _changesSince(
+    int sequence,
+    int batchSize,
+  ) async* {
+    final cursor = _FfiChangeCursor(this, sequence);
+    while (true) {
+      final batch = useSync(() => cursor.next(batchSize));
+      if (batch.changes.isEmpty) {
+        return;
+      }
+
+      yield batch;
+
+      if (batch.changes.length < batchSize) {
+        return;
+      }
+    }
+  }
+
+  /// Reads a batch of at most [batchSize] documents whose sequence is larger
+  /// than [sequence], in the encoding of the native change cursor.
+  ///
+  /// The batch can be decoded with [decodeSequenceChangeBatch].
+  Data readChangesSince(int sequence, int batchSize) =>
+      useSync(() => _FfiChangeCursor(this, sequence).read(batchSize));
+
   @override
   String toString() => 'FfiCollection($fullName)';
 
@@ -756,6 +1273,380 @@ final class FfiCollection
       FfiDocumentDelegate.create(oldDelegate.id);
 }
 
+/// A native cursor over the documents of a [FfiCollection] in the order of
+/// their sequences.
+final class _FfiChangeCursor implements Finalizable {
+  _FfiChangeCursor(FfiCollection collection, this._sequence) {
+    _pointer = _collectionBindings.newChangeCursor(
+      this,
+      collection.pointer,
+      _sequence,
+    );
+  }
+
+  late final Pointer<CBLDart_ChangeCursor> _pointer;
+  int _sequence;
+
+  /// Reads the next batch of at most [batchSize] documents, without decoding
+  /// it.
+  Data read(int batchSize) => runWithErrorTranslation(
+        () => _collectionBindings.changeCursorNext(_pointer, batchSize),
+      );
+
+  SequenceChangeBatch next(int batchSize) {
+    final batch = decodeSequenceChangeBatch(read(batchSize), _sequence);
+    _sequence = batch.checkpoint;
+    return batch;
+  }
+}
+
+/// A build of an index of a [FfiCollection], which is executed by a native
+/// builder on a background thread.
+final class _FfiIndexBuild implements IndexBuild {
+  _FfiIndexBuild(
+    FfiCollection collection,
+    String name,
+    CBLIndexSpec spec, {
+    required IndexBuildProgressListener? onProgress,
+  }) : _onProgress = onProgress {
+    _callback = AsyncCallback(
+      (arguments) {
+        _handleMessage(IndexBuildCallbackMessage.fromArguments(arguments));
+        return null;
+      },
+      debugName: 'FfiCollection.buildIndex',
+    );
+
+    _builder = _collectionBindings.buildIndex(
+      collection.database.pointer,
+      collection.pointer,
+      name,
+      spec,
+      _callback.pointer,
+    );
+  }
+
+  final IndexBuildProgressListener? _onProgress;
+  final _result = Completer<bool>();
+  late final AsyncCallback _callback;
+  late final Pointer<CBLDart_IndexBuilder> _builder;
+
+  @override
+  IndexBuildState get state => _state;
+  var _state = IndexBuildState.pending;
+
+  @override
+  Future<bool> get result => _result.future;
+
+  @override
+  void cancel() {
+    // After the final message the builder must not be used anymore, since
+    // closing the callback frees it.
+    if (_result.isCompleted) {
+      return;
+    }
+    _collectionBindings.cancelIndexBuild(_builder);
+  }
+
+  void _setState(IndexBuildState state) {
+    _state = state;
+    _onProgress?.call(state);
+  }
+
+  void _handleMessage(IndexBuildCallbackMessage message) {
+    if (!message.isDone) {
+      _setState(IndexBuildState.building);
+      return;
+    }
+
+    _callback.close();
+
+    final error = message.error;
+    if (error != null) {
+      _setState(IndexBuildState.failed);
+      _result.completeError(error.toCouchbaseLiteException());
+    } else if (message.created) {
+      _setState(IndexBuildState.completed);
+      _result.complete(true);
+    } else {
+      _setState(IndexBuildState.cancelled);
+      _result.complete(false);
+    }
+  }
+}
+
+typedef _DocumentOperationSubmitter = void Function(
+  Pointer<CBLDart_DocumentOperations> operations,
+  int operationId,
+);
+
+/// The queue of document operations of a [FfiDatabase], which are executed
+/// natively on background threads.
+///
+/// The queue is closed together with the database, after all pending
+/// operations have completed.
+final class _FfiDocumentOperations with ClosableResourceMixin {
+  _FfiDocumentOperations(FfiDatabase database) {
+    _callback = AsyncCallback(
+      (arguments) {
+        _handleMessage(
+          DocumentOperationCallbackMessage.fromArguments(arguments),
+        );
+        return null;
+      },
+      debugName: 'FfiDatabase.documentOperations',
+    );
+
+    _pointer = _collectionBindings.newDocumentOperations(
+      database.pointer,
+      _callback.pointer,
+    );
+
+    attachTo(database);
+  }
+
+  late final AsyncCallback _callback;
+  late final Pointer<CBLDart_DocumentOperations> _pointer;
+  final _pendingOperations = <int, Completer<Object?>>{};
+  var _nextOperationId = 0;
+
+  /// Submits an operation through [submit] and returns its result.
+  Future<Object?> run(_DocumentOperationSubmitter submit) => use(() {
+        final operationId = _nextOperationId++;
+        final completer = Completer<Object?>();
+        _pendingOperations[operationId] = completer;
+        submit(_pointer, operationId);
+        return completer.future;
+      });
+
+  void _handleMessage(DocumentOperationCallbackMessage message) {
+    final completer = _pendingOperations.remove(message.operationId)!;
+
+    final error = message.error;
+    if (error != null) {
+      completer.completeError(error.toCouchbaseLiteException());
+      return;
+    }
+
+    final result = message.result;
+    if (result is int) {
+      // The document is released after the callback returns, so it has to be
+      // retained right away.
+      completer.complete(FfiDocumentDelegate.fromPointer(
+        Pointer<CBLDocument>.fromAddress(result),
+      ));
+    } else {
+      completer.complete(result);
+    }
+  }
+
+  @override
+  void performClose() => _callback.close();
+
+  @override
+  String toString() => 'FfiDocumentOperations()';
+}
+
+/// A schedule of maintenance of a [FfiDatabase], which is run by a native
+/// scheduler on a background thread.
+final class _FfiMaintenanceSchedule
+    with ClosableResourceMixin
+    implements MaintenanceSchedule {
+  _FfiMaintenanceSchedule(
+    FfiDatabase database,
+    Set<MaintenanceType> types, {
+    required Duration interval,
+    required Duration idleTimeout,
+    required MaintenanceProgressListener? onProgress,
+  }) : _onProgress = onProgress {
+    attachTo(database);
+
+    _callback = AsyncCallback(
+      (arguments) {
+        _handleMessage(MaintenanceCallbackMessage.fromArguments(arguments));
+        return null;
+      },
+      debugName: 'FfiDatabase.scheduleMaintenance',
+    );
+
+    _bindings.scheduleMaintenance(
+      database.pointer,
+      {for (final type in types) type.toCBLMaintenanceType()},
+      interval,
+      idleTimeout,
+      _callback.pointer,
+    );
+  }
+
+  final MaintenanceProgressListener? _onProgress;
+  late final AsyncCallback _callback;
+
+  @override
+  MaintenanceReport? get lastReport => _lastReport;
+  MaintenanceReport? _lastReport;
+
+  void _handleMessage(MaintenanceCallbackMessage message) {
+    final type = message.type;
+    if (type != null) {
+      final progress =
+          MaintenanceProgress.started(MaintenanceType.values[type.index]);
+      _onProgress?.call(progress);
+      return;
+    }
+
+    final report = _lastReport = MaintenanceReport(
+      fileSizeBefore: message.sizeBefore,
+      fileSizeAfter: message.sizeAfter,
+      error: message.error?.toCouchbaseLiteException(),
+    );
+    _onProgress?.call(MaintenanceProgress.finished(report));
+  }
+
+  @override
+  void performClose() => _callback.close();
+
+  @override
+  String toString() => 'FfiMaintenanceSchedule()';
+}
+
+/// An import of JSON lines into a [FfiCollection], which is executed by a
+/// native importer on a background thread.
+final class _FfiJsonLinesImport {
+  _FfiJsonLinesImport(
+    FfiCollection collection, {
+    required String? idKeyPath,
+    required int batchSize,
+    required JsonLinesImportProgressListener? onProgress,
+  }) : _onProgress = onProgress {
+    if (batchSize < 1) {
+      throw RangeError.range(batchSize, 1, null, 'batchSize');
+    }
+
+    _callback = AsyncCallback(
+      (arguments) {
+        _handleMessage(JsonLinesImportCallbackMessage.fromArguments(arguments));
+        return null;
+      },
+      debugName: 'FfiCollection.importJsonLines',
+    );
+
+    try {
+      _importer = runWithErrorTranslation(
+        () => _collectionBindings.importJsonLines(
+          collection.database.pointer,
+          collection.pointer,
+          idKeyPath,
+          batchSize,
+          _callback.pointer,
+        ),
+      );
+    } catch (_) {
+      _callback.close();
+      rethrow;
+    }
+  }
+
+  /// The maximum number of chunks which have been added to the importer, but
+  /// not consumed yet, before the source stream is paused.
+  static const _maxPendingChunks = 4;
+
+  final JsonLinesImportProgressListener? _onProgress;
+  final _result = Completer<int>();
+  late final AsyncCallback _callback;
+  late final Pointer<CBLDart_JSONLinesImporter> _importer;
+  StreamSubscription<List<int>>? _subscription;
+  var _addedInputCount = 0;
+  var _consumedInputCount = 0;
+  var _importedCount = 0;
+  var _isFinished = false;
+
+  Future<int> get result => _result.future;
+
+  void addStream(Stream<List<int>> source) {
+    _subscription = source.listen(
+      (chunk) {
+        _collectionBindings.addJsonLinesChunk(
+          _importer,
+          Data.fromTypedList(
+            chunk is Uint8List ? chunk : Uint8List.fromList(chunk),
+          ),
+        );
+        _addedInputCount++;
+        _updateFlowControl();
+      },
+      onError: (Object error, StackTrace stackTrace) {
+        _subscription!.cancel();
+        _finish(cancel: true);
+        if (!_result.isCompleted) {
+          _result.completeError(error, stackTrace);
+        }
+      },
+      onDone: () => _finish(cancel: false),
+      cancelOnError: true,
+    );
+  }
+
+  void addFile(String path) {
+    _collectionBindings.addJsonLinesFile(_importer, path);
+    _addedInputCount++;
+    _finish(cancel: false);
+  }
+
+  void _finish({required bool cancel}) {
+    if (_isFinished) {
+      return;
+    }
+    _isFinished = true;
+    _collectionBindings.finishJsonLinesImport(_importer, cancel: cancel);
+  }
+
+  void _updateFlowControl() {
+    final subscription = _subscription;
+    if (subscription == null) {
+      return;
+    }
+
+    final pendingChunks = _addedInputCount - _consumedInputCount;
+    if (pendingChunks >= _maxPendingChunks) {
+      if (!subscription.isPaused) {
+        subscription.pause();
+      }
+    } else if (subscription.isPaused) {
+      subscription.resume();
+    }
+  }
+
+  void _handleMessage(JsonLinesImportCallbackMessage message) {
+    _consumedInputCount = message.consumedInputCount;
+    if (message.importedCount != _importedCount) {
+      _importedCount = message.importedCount;
+      _onProgress?.call(_importedCount);
+    }
+
+    if (!message.isDone) {
+      _updateFlowControl();
+      return;
+    }
+
+    // After the final message the importer must not be used anymore, since
+    // closing the callback frees it.
+    _isFinished = true;
+    _callback.close();
+    _subscription?.cancel();
+
+    if (_result.isCompleted) {
+      return;
+    }
+
+    final error = message.error;
+    if (error != null) {
+      _result.completeError(error.toCouchbaseLiteException());
+    } else {
+      _result.complete(_importedCount);
+    }
+  }
+}
+
 extension on MaintenanceType {
   CBLMaintenanceType toCBLMaintenanceType() => CBLMaintenanceType.values[index];
 }
@@ -0,0 +1,51 @@
+import 'package:meta/meta.dart';
+
+import 'collection.dart';
+
+/// A document which matched a full-text search through
+/// [Collection.fullTextSearch].
+///
+/// {@category Database}
+@immutable
+final class FullTextSearchResult {
+  /// Creates a document which matched a full-text search.
+  const FullTextSearchResult({
+    required this.id,
+    required this.rank,
+    this.snippet,
+  });
+
+  /// The ID of the matched document.
+  final String id;
+
+  /// The rank of the match, which is higher the better the document matches
+  /// the full-text query.
+  final double rank;
+
+  /// The snippet of the text of the document, in which matched words are
+  /// marked, or `null` if no snippet was requested or the snippet property
+  /// of the document is not a string.
+  final String? snippet;
+
+  @override
+  bool operator ==(Object other) =>
+      identical(this, other) ||
+      other is FullTextSearchResult &&
+          id == other.id &&
+          rank == other.rank &&
+          snippet == other.snippet;
+
+  @override
+  int get hashCode => Object.hash(id, rank, snippet);
+
+  @override
+  String toString() => [
+        'FullTextSearchResult(',
+        [
+          'id: $id',
+          'rank: $rank',
+          if (snippet != null) 'snippet: $snippet',
+        ].join(', '),
+        ')',
+      ].join();
+}
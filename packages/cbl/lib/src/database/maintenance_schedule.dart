@@ -0,0 +1,121 @@
+import 'dart:io';
+
+import 'package:meta/meta.dart';
+import 'package:path/path.dart' as path_lib;
+
+import '../errors.dart';
+import '../support/resource.dart';
+import 'database.dart';
+
+/// Listener which is called when a [MaintenanceSchedule] makes progress.
+///
+/// {@category Database}
+typedef MaintenanceProgressListener = void Function(
+  MaintenanceProgress progress,
+);
+
+/// The progress of a run of a [MaintenanceSchedule].
+///
+/// {@category Database}
+@immutable
+final class MaintenanceProgress {
+  /// Creates the progress of a run, which has started the maintenance of
+  /// [type].
+  const MaintenanceProgress.started(MaintenanceType this.type) : report = null;
+
+  /// Creates the progress of a run, which has finished with [report].
+  const MaintenanceProgress.finished(MaintenanceReport this.report)
+      : type = null;
+
+  /// The type of maintenance which has started, or `null` if the run has
+  /// finished.
+  final MaintenanceType? type;
+
+  /// The report of the run, if it has finished.
+  final MaintenanceReport? report;
+
+  @override
+  String toString() => report != null
+      ? 'MaintenanceProgress.finished($report)'
+      : 'MaintenanceProgress.started($type)';
+}
+
+/// The outcome of a run of a [MaintenanceSchedule].
+///
+/// {@category Database}
+@immutable
+final class MaintenanceReport {
+  /// Creates the outcome of a run of a [MaintenanceSchedule].
+  const MaintenanceReport({
+    required this.fileSizeBefore,
+    required this.fileSizeAfter,
+    this.error,
+  });
+
+  /// The size in bytes of the database file, including its write-ahead log,
+  /// before the run.
+  final int fileSizeBefore;
+
+  /// The size in bytes of the database file, including its write-ahead log,
+  /// after the run.
+  final int fileSizeAfter;
+
+  /// The fraction of the database file, between `0` and `1`, which has been
+  /// freed by the run.
+  ///
+  /// When the run compacted the database, this is the fraction of the file
+  /// which was unused before the run.
+  double get fragmentation {
+    if (fileSizeBefore <= 0 || fileSizeAfter >= fileSizeBefore) {
+      return 0;
+    }
+    return (fileSizeBefore - fileSizeAfter) / fileSizeBefore;
+  }
+
+  /// The error which stopped the run, if it failed.
+  final CouchbaseLiteException? error;
+
+  @override
+  String toString() => [
+        'MaintenanceReport(',
+        [
+          'fileSizeBefore: $fileSizeBefore',
+          'fileSizeAfter: $fileSizeAfter',
+          if (error != null) 'error: $error',
+        ].join(', '),
+        ')',
+      ].join();
+}
+
+/// A schedule of database maintenance, which runs in the background.
+///
+/// See also:
+///
+/// - [Database.scheduleMaintenance] for starting a schedule.
+///
+/// {@category Database}
+abstract interface class MaintenanceSchedule implements ClosableResource {
+  /// The report of the last run of this schedule, or `null` if no run has
+  /// finished yet.
+  MaintenanceReport? get lastReport;
+
+  /// Stops this schedule.
+  ///
+  /// A type of maintenance which is being performed cannot be interrupted, but
+  /// the remaining types of the run are skipped.
+  @override
+  Future<void> close();
+}
+
+/// Returns the combined size of the database file of the database at
+/// [directory] and its write-ahead log, which is where freed pages accumulate.
+int databaseFileSize(String directory) {
+  var size = 0;
+  for (final name in const ['db.sqlite3', 'db.sqlite3-wal']) {
+    final file = File(path_lib.join(directory, name));
+    if (file.existsSync()) {
+      size += file.lengthSync();
+    }
+  }
+  return size;
+}
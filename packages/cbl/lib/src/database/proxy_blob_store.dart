@@ -16,12 +16,21 @@ final class ProxyBlobStore implements BlobStore {
       ));
 
   @override
-  Stream<Data>? readBlob(Map<String, Object?> properties) => database.channel
-      .stream(ReadBlob(
-        databaseId: database.objectId,
-        properties: properties,
-      ))
-      .map((event) => event.data);
+  Stream<Data>? readBlob(
+    Map<String, Object?> properties, {
+    int start = 0,
+    int? end,
+    int readAhead = 0,
+  }) =>
+      database.channel
+          .stream(ReadBlob(
+            databaseId: database.objectId,
+            properties: properties,
+            start: start,
+            end: end,
+            readAhead: readAhead,
+          ))
+          .map((event) => event.data);
 
   @override
   Future<Map<String, Object?>> saveBlobFromData(
@@ -42,4 +51,28 @@ final class ProxyBlobStore implements BlobStore {
             uploadId: database.client.registerBlobUpload(stream),
           ))
           .then((response) => response.properties);
+
+  @override
+  Future<Map<String, Object?>> saveBlobFromFile(
+    String contentType,
+    String path,
+  ) =>
+      database.channel
+          .call(SaveBlobFromFile(
+            databaseId: database.objectId,
+            contentType: contentType,
+            path: path,
+          ))
+          .then((response) => response.properties);
+
+  @override
+  Future<bool> writeBlobToFile(
+    Map<String, Object?> properties,
+    String path,
+  ) =>
+      database.channel.call(WriteBlobToFile(
+        databaseId: database.objectId,
+        properties: properties,
+        path: path,
+      ));
 }
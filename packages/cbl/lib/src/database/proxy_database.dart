@@ -1,4 +1,5 @@
 import 'dart:async';
+import 'dart:convert';
 import 'dart:io';
 
 import 'package:web_socket_channel/web_socket_channel.dart';
@@ -12,7 +13,9 @@ import '../document/proxy_document.dart';
 import '../errors.dart';
 import '../fleece/decoder.dart';
 import '../fleece/dict_key.dart';
+import '../query/expressions/expression.dart';
 import '../query/index/index.dart';
+import '../query/parameters.dart';
 import '../query/proxy_query.dart';
 import '../query/query.dart';
 import '../service/cbl_service.dart';
@@ -20,7 +23,9 @@ import '../service/cbl_service_api.dart';
 import '../service/cbl_worker.dart';
 import '../service/channel.dart';
 import '../service/proxy_object.dart';
+import '../service/serialization/binary_packet_codec.dart';
 import '../service/serialization/json_packet_codec.dart';
+import '../service/serialization/serialization_codec.dart';
 import '../support/encoding.dart';
 import '../support/listener_token.dart';
 import '../support/resource.dart';
@@ -38,8 +43,12 @@ import 'database_base.dart';
 import 'database_change.dart';
 import 'database_configuration.dart';
 import 'document_change.dart';
+import 'expiration_stats.dart';
+import 'full_text_search_result.dart';
+import 'maintenance_schedule.dart';
 import 'proxy_blob_store.dart';
 import 'scope.dart';
+import 'sequence_change.dart';
 
 final class ProxyDatabase extends ProxyObject
     with DatabaseBase<ProxyDocumentDelegate>, ClosableResourceMixin
@@ -281,6 +290,13 @@ final class ProxyDatabase extends ProxyObject
   Future<void> saveBlob(covariant BlobImpl blob) =>
       use(() => blob.ensureIsInstalled(this));
 
+  @override
+  Future<Blob> saveBlobFromFile(String contentType, String path) =>
+      use(() async => BlobImpl.fromProperties(
+            await blobStore.saveBlobFromFile(contentType, path),
+            database: this,
+          ));
+
   @override
   Future<Blob?> getBlob(Map<String, Object?> properties) => use(() async {
         checkBlobMetadata(properties);
@@ -339,7 +355,7 @@ final class ProxyDatabase extends ProxyObject
             parent: this,
             addListener: (listener) async {
               final collection = (await defaultCollection) as ProxyCollection;
-              return collection._addDocumentChangeListener(id, listener);
+              return collection._addDocumentChangeListener(id, listener, null);
             },
           ));
 
@@ -375,6 +391,24 @@ final class ProxyDatabase extends ProxyObject
             type: type,
           )));
 
+  @override
+  MaintenanceSchedule scheduleMaintenance({
+    Set<MaintenanceType> types = const {
+      MaintenanceType.compact,
+      MaintenanceType.optimize,
+    },
+    Duration interval = const Duration(hours: 1),
+    Duration idleTimeout = const Duration(seconds: 30),
+    MaintenanceProgressListener? onProgress,
+  }) =>
+      useSync(() => _ProxyMaintenanceSchedule(
+            this,
+            types,
+            interval: interval,
+            idleTimeout: idleTimeout,
+            onProgress: onProgress,
+          ));
+
   @override
   Future<void> changeEncryptionKey(EncryptionKey? newKey) =>
       use(() => channel.call(ChangeDatabaseEncryptionKey(
@@ -395,6 +429,11 @@ final class ProxyDatabase extends ProxyObject
   Future<void> deleteIndex(String name) =>
       defaultCollection.then((collections) => collections.deleteIndex(name));
 
+  /// Returns the client and the id of the database with which the next query
+  /// is prepared.
+  ({CblServiceClient client, int databaseId}) nextQueryTarget() =>
+      (client: client, databaseId: objectId);
+
   @override
   Future<AsyncQuery> createQuery(String query, {bool json = false}) async {
     final proxyQuery = ProxyQuery(
@@ -424,6 +463,7 @@ final class ProxyDatabase extends ProxyObject
 final class WorkerDatabase extends ProxyDatabase {
   WorkerDatabase._(
     this.worker,
+    this._readers,
     CblServiceClient client,
     DatabaseConfiguration config,
     TypedDataAdapter? typedDataAdapter,
@@ -436,6 +476,9 @@ final class WorkerDatabase extends ProxyDatabase {
     TypedDataAdapter? typedDataAdapter,
   ]) async {
     config ??= DatabaseConfiguration();
+    if (config.workerPoolSize < 1) {
+      throw RangeError.range(config.workerPoolSize, 1, null, 'workerPoolSize');
+    }
 
     final worker = CblWorker(debugName: _databaseName(name));
     await worker.start();
@@ -446,14 +489,38 @@ final class WorkerDatabase extends ProxyDatabase {
       currentTracingDelegate.createWorkerDelegate(),
     ));
 
+    final DatabaseState state;
+    try {
+      state = await client.channel.call(OpenDatabase(name, config));
+    } on CouchbaseLiteException {
+      await client.channel.call(UninstallTracingDelegate());
+      await worker.stop();
+      rethrow;
+    }
+
+    // The readers are opened after the first worker, which creates the
+    // database if it does not exist yet.
+    final readers = <_WorkerDatabaseReader>[];
     try {
-      final state = await client.channel.call(OpenDatabase(name, config));
-      return WorkerDatabase._(worker, client, config, typedDataAdapter, state);
+      for (var i = 1; i < config.workerPoolSize; i++) {
+        readers.add(await _WorkerDatabaseReader.open(name, config, i));
+      }
     } on CouchbaseLiteException {
+      await Future.wait(readers.map((reader) => reader.close()));
+      await client.channel.call(ReleaseObject(state.id));
       await client.channel.call(UninstallTracingDelegate());
       await worker.stop();
       rethrow;
     }
+
+    return WorkerDatabase._(
+      worker,
+      readers,
+      client,
+      config,
+      typedDataAdapter,
+      state,
+    );
   }
 
   // TODO(blaugold): use tracing delegates in one-off workers
@@ -482,14 +549,79 @@ final class WorkerDatabase extends ProxyDatabase {
 
   final CblWorker worker;
 
+  final List<_WorkerDatabaseReader> _readers;
+  var _nextReader = 0;
+
+  @override
+  ({CblServiceClient client, int databaseId}) nextQueryTarget() {
+    if (_readers.isEmpty) {
+      return super.nextQueryTarget();
+    }
+
+    final reader = _readers[_nextReader];
+    _nextReader = (_nextReader + 1) % _readers.length;
+    return (client: reader.client, databaseId: reader.databaseId);
+  }
+
   @override
   Future<void> performClose() async {
+    // The queries of the readers have already been released, since they are
+    // closed before the database. The readers are closed first, so that
+    // deleting the database does not fail because they still have it open.
+    await Future.wait(_readers.map((reader) => reader.close()));
     await super.performClose();
     await client.channel.call(UninstallTracingDelegate());
     await worker.stop();
   }
 }
 
+/// An additional worker of a [WorkerDatabase], which has opened the database
+/// itself and executes queries.
+final class _WorkerDatabaseReader {
+  _WorkerDatabaseReader._(this.worker, this.client, this.databaseId);
+
+  static Future<_WorkerDatabaseReader> open(
+    String name,
+    DatabaseConfiguration config,
+    int index,
+  ) async {
+    final worker = CblWorker(debugName: '${_databaseName(name)}[$index]');
+    await worker.start();
+
+    final client = CblServiceClient(channel: worker.channel);
+
+    await client.channel.call(InstallTracingDelegate(
+      currentTracingDelegate.createWorkerDelegate(),
+    ));
+
+    // Each reader opens its own native database, so that its queries are not
+    // serialized with those of the other workers.
+    final readerConfig = DatabaseConfiguration(
+      directory: config.directory,
+      encryptionKey: config.encryptionKey,
+    );
+
+    try {
+      final state = await client.channel.call(OpenDatabase(name, readerConfig));
+      return _WorkerDatabaseReader._(worker, client, state.id);
+    } on CouchbaseLiteException {
+      await client.channel.call(UninstallTracingDelegate());
+      await worker.stop();
+      rethrow;
+    }
+  }
+
+  final CblWorker worker;
+  final CblServiceClient client;
+  final int databaseId;
+
+  Future<void> close() async {
+    await client.channel.call(ReleaseObject(databaseId));
+    await client.channel.call(UninstallTracingDelegate());
+    await worker.stop();
+  }
+}
+
 final class RemoteDatabase extends ProxyDatabase {
   RemoteDatabase._(
     CblServiceClient client,
@@ -498,15 +630,21 @@ final class RemoteDatabase extends ProxyDatabase {
     DatabaseState state,
   ) : super(client, config, typedDataAdapter, state, EncodingFormat.fleece);
 
+  /// Opens the database with [name] through the service at [uri].
+  ///
+  /// Packets are encoded with [packetCodec], which must match the codec of
+  /// the service. It defaults to [JsonPacketCodec], which all services
+  /// support. Use [BinaryPacketCodec] only with services which use it too.
   static Future<RemoteDatabase> open(
     Uri uri,
     String name,
     DatabaseConfiguration config, [
     TypedDataAdapter? typedDataAdapter,
+    PacketCodec? packetCodec,
   ]) async {
     final channel = Channel(
       transport: WebSocketChannel.connect(uri),
-      packetCodec: JsonPacketCodec(),
+      packetCodec: packetCodec ?? JsonPacketCodec(),
       serializationRegistry: cblServiceSerializationRegistry(),
     );
     final client = CblServiceClient(channel: channel);
@@ -637,6 +775,27 @@ final class ProxyCollection extends ProxyObject
         }),
       );
 
+  @override
+  Future<List<Document?>> documents(List<String> ids) =>
+      asyncOperationTracePoint(
+        () => GetDocumentsOp(this, ids),
+        () => use(() async {
+          final states =
+              await channel.call(GetDocuments(objectId, ids, encodingFormat));
+
+          return [
+            for (final state in states)
+              if (state == null)
+                null
+              else
+                DelegateDocument(
+                  ProxyDocumentDelegate.fromState(state, database: database),
+                  collection: this,
+                ),
+          ];
+        }),
+      );
+
   @override
   Future<DocumentFragment> operator [](String id) async =>
       DocumentFragmentImpl(await document(id));
@@ -672,6 +831,94 @@ final class ProxyCollection extends ProxyObject
         ),
       );
 
+  @override
+  Future<List<bool>> saveDocuments(
+    covariant List<MutableDelegateDocument> documents, [
+    ConcurrencyControl concurrencyControl = ConcurrencyControl.lastWriteWins,
+  ]) =>
+      asyncOperationTracePoint(
+        () => SaveDocumentsOp(this, documents, concurrencyControl),
+        () => use(
+          () => database.runInTransactionAsync(() async {
+            final delegates = [
+              for (final document in documents)
+                await asyncOperationTracePoint(
+                  () => PrepareDocumentOp(document),
+                  () async => prepareDocument(document),
+                ),
+            ];
+
+            final states = await channel.call(SaveDocuments(
+              objectId,
+              [for (final delegate in delegates) delegate.getState()],
+              concurrencyControl,
+            ));
+
+            final results = <bool>[];
+            for (var i = 0; i < states.length; i++) {
+              final state = states[i];
+              if (state != null) {
+                delegates[i].updateMetadata(state, database: database);
+              }
+              results.add(state != null);
+            }
+            return results;
+          }),
+        ),
+      );
+
+  @override
+  Stream<SequenceChangeBatch> changesSince(
+    int sequence, {
+    int batchSize = 1000,
+  }) =>
+      useSync(() => _changesSince(sequence, batchSize));
+
+  Stream<SequenceChangeBatch> _changesSince(
+    int sequence,
+    int batchSize,
+  ) async* {
+    var checkpoint = sequence;
+    while (true) {
+      final message = await use(() => channel.call(ReadChangesSince(
+            collectionId: objectId,
+            sequence: checkpoint,
+            batchSize: batchSize,
+          )));
+      final batch = decodeSequenceChangeBatch(message.data, checkpoint);
+      if (batch.changes.isEmpty) {
+        return;
+      }
+
+      yield batch;
+      checkpoint = batch.checkpoint;
+
+      if (batch.changes.length < batchSize) {
+        return;
+      }
+    }
+  }
+
+  @override
+  Future<bool> patchDocument(
+    String id,
+    Map<String, Object?> patch, [
+    ConcurrencyControl concurrencyControl = ConcurrencyControl.lastWriteWins,
+  ]) =>
+      asyncOperationTracePoint(
+        () => PatchDocumentOp(this, id, concurrencyControl),
+        () => use(
+          () => database.runInTransactionAsync(
+            () => channel.call(PatchDocument(
+              objectId,
+              id,
+              patch,
+              concurrencyControl,
+            )),
+          ),
+        ),
+      );
+
   @override
   Future<bool> saveDocumentWithConflictHandler(
     covariant MutableDelegateDocument document,
@@ -740,10 +987,21 @@ final class ProxyCollection extends ProxyObject
             expiration: expiration,
           )));
 
+  @override
+  Future<void> setDocumentExpirations(Map<String, DateTime?> expirations) =>
+      use(() => channel.call(SetDocumentExpirations(
+            collectionId: objectId,
+            expirations: expirations,
+          )));
+
   @override
   Future<DateTime?> getDocumentExpiration(String id) => use(() => channel
       .call(GetDocumentExpiration(collectionId: objectId, documentId: id)));
 
+  @override
+  Future<ExpirationStats> get expirationStats =>
+      use(() => channel.call(GetExpirationStats(objectId)));
+
   @override
   Future<List<String>> get indexes =>
       use(() => channel.call(GetCollectionIndexes(objectId)));
@@ -760,6 +1018,251 @@ final class ProxyCollection extends ProxyObject
   Future<void> deleteIndex(String name) =>
       use(() => channel.call(DeleteIndex(collectionId: objectId, name: name)));
 
+  @override
+  Future<List<FullTextSearchResult>> fullTextSearch(
+    String indexName,
+    String query, {
+    int limit = 20,
+    int offset = 0,
+    String? snippetProperty,
+    int snippetWordCount = 16,
+    String matchStart = '<b>',
+    String matchEnd = '</b>',
+    String ellipsis = '…',
+  }) =>
+      use(() {
+        if (limit < 1) {
+          throw RangeError.range(limit, 1, null, 'limit');
+        }
+        if (offset < 0) {
+          throw RangeError.range(offset, 0, null, 'offset');
+        }
+        if (snippetWordCount < 1) {
+          throw RangeError.range(
+            snippetWordCount,
+            1,
+            null,
+            'snippetWordCount',
+          );
+        }
+
+        return channel.call(FullTextSearch(
+          collectionId: objectId,
+          indexName: indexName,
+          query: query,
+          limit: limit,
+          offset: offset,
+          snippetProperty: snippetProperty,
+          snippetWordCount: snippetWordCount,
+          matchStart: matchStart,
+          matchEnd: matchEnd,
+          ellipsis: ellipsis,
+        ));
+      });
+
+  @override
+  IndexBuild buildIndex(
+    String name,
+    covariant IndexImplInterface index, {
+    IndexBuildProgressListener? onProgress,
+  }) =>
+      useSync(() => _ProxyIndexBuild(this, name, index, onProgress));
+
+  @override
+  Future<int> importJsonLines(
+    Stream<List<int>> source, {
+    String? idKeyPath,
+    int batchSize = 1000,
+    JsonLinesImportProgressListener? onProgress,
+  }) =>
+      use(() => _importJsonLines(
+            source,
+            idKeyPath: idKeyPath,
+            batchSize: batchSize,
+            onProgress: onProgress,
+          ));
+
+  @override
+  Future<int> importJsonLinesFile(
+    String path, {
+    String? idKeyPath,
+    int batchSize = 1000,
+    JsonLinesImportProgressListener? onProgress,
+  }) =>
+      use(() => _importJsonLines(
+            File(path).openRead(),
+            idKeyPath: idKeyPath,
+            batchSize: batchSize,
+            onProgress: onProgress,
+          ));
+
+  // The documents are parsed in this isolate and saved through the regular
+  // document API, since the service has no endpoint for imports.
+  Future<int> _importJsonLines(
+    Stream<List<int>> source, {
+    required String? idKeyPath,
+    required int batchSize,
+    required JsonLinesImportProgressListener? onProgress,
+  }) async {
+    if (batchSize < 1) {
+      throw RangeError.range(batchSize, 1, null, 'batchSize');
+    }
+
+    final idProjection =
+        idKeyPath == null ? null : KeyPathProjection([idKeyPath]);
+    final batch = <MutableDocument>[];
+    var importedCount = 0;
+
+    Future<void> saveBatch() async {
+      if (batch.isEmpty) {
+        return;
+      }
+
+      await database.inBatch(() async {
+        for (final document in batch) {
+          await saveDocument(document);
+        }
+      });
+
+      importedCount += batch.length;
+      batch.clear();
+      onProgress?.call(importedCount);
+    }
+
+    final lines =
+        source.transform(utf8.decoder).transform(const LineSplitter());
+    await for (final line in lines) {
+      if (line.trim().isEmpty) {
+        continue;
+      }
+
+      final Object? properties;
+      try {
+        properties = jsonDecode(line);
+      } on FormatException catch (e) {
+        throw FleeceException(e.message);
+      }
+      if (properties is! Map<String, Object?>) {
+        throw DatabaseException(
+          'JSON line does not contain an object.',
+          DatabaseErrorCode.invalidParameter,
+        );
+      }
+
+      final id = idProjection == null
+          ? null
+          : MutableDictionary(properties).project(idProjection).first;
+      batch.add(id is String
+          ? MutableDocument.withId(id, properties)
+          : MutableDocument(properties));
+
+      if (batch.length == batchSize) {
+        await saveBatch();
+      }
+    }
+
+    await saveBatch();
+
+    return importedCount;
+  }
+
+  @override
+  Future<int> deleteWhere(
+    covariant ExpressionImpl predicate, {
+    int batchSize = 1000,
+    RemoveWhereProgressListener? onProgress,
+  }) =>
+      use(() => _removeWhere(
+            predicate,
+            batchSize: batchSize,
+            onProgress: onProgress,
+            purge: false,
+          ));
+
+  @override
+  Future<int> purgeWhere(
+    covariant ExpressionImpl predicate, {
+    int batchSize = 1000,
+    RemoveWhereProgressListener? onProgress,
+  }) =>
+      use(() => _removeWhere(
+            predicate,
+            batchSize: batchSize,
+            onProgress: onProgress,
+            purge: true,
+          ));
+
+  // The matching documents are queried and removed through the regular APIs,
+  // in the same batches as by the native implementation, since the service
+  // has no endpoint for bulk removals.
+  Future<int> _removeWhere(
+    ExpressionImpl predicate, {
+    required int batchSize,
+    required RemoveWhereProgressListener? onProgress,
+    required bool purge,
+  }) async {
+    if (batchSize < 1) {
+      throw RangeError.range(batchSize, 1, null, 'batchSize');
+    }
+
+    final query = await database.createQuery(
+      jsonEncode({
+        'WHAT': [
+          ['._id']
+        ],
+        'FROM': [
+          {'COLLECTION': fullName}
+        ],
+        'WHERE': [
+          'AND',
+          predicate.toJson(),
+          [
+            '>',
+            ['._id'],
+            [r'$lastId']
+          ]
+        ],
+        'ORDER_BY': [
+          ['._id']
+        ],
+        'LIMIT': [r'$limit'],
+      }),
+      json: true,
+    );
+
+    var lastId = '';
+    var affectedCount = 0;
+    while (true) {
+      final previousAffectedCount = affectedCount;
+      var matchedCount = 0;
+      await database.inBatch(() async {
+        await query.setParameters(
+          Parameters({'lastId': lastId, 'limit': batchSize}),
+        );
+        final results = await (await query.execute()).allResults();
+        for (final result in results) {
+          final id = result.string(0)!;
+          if (purge) {
+            await purgeDocumentById(id);
+            affectedCount++;
+          } else if (await document(id) case final matchedDocument?) {
+            await deleteDocument(matchedDocument);
+            affectedCount++;
+          }
+          lastId = id;
+        }
+        matchedCount = results.length;
+      });
+
+      if (affectedCount != previousAffectedCount) {
+        onProgress?.call(affectedCount);
+      }
+      if (matchedCount < batchSize) {
+        return affectedCount;
+      }
+    }
+  }
+
   @override
   Future<ListenerToken> addChangeListener(CollectionChangeListener listener) =>
       use(() async {
@@ -786,16 +1289,18 @@ final class ProxyCollection extends ProxyObject
   @override
   Future<ListenerToken> addDocumentChangeListener(
     String id,
-    DocumentChangeListener listener,
-  ) =>
+    DocumentChangeListener listener, {
+    Duration? debounce,
+  }) =>
       use(() async {
-        final token = await _addDocumentChangeListener(id, listener);
+        final token = await _addDocumentChangeListener(id, listener, debounce);
         return token.also(_listenerTokens.add);
       });
 
   Future<AbstractListenerToken> _addDocumentChangeListener(
     String id,
     DocumentChangeListener listener,
+    Duration? debounce,
   ) async {
     late final ProxyListenerToken<DocumentChange> token;
     final listenerId = client.registerDocumentChangeListener(() {
@@ -806,6 +1311,7 @@ final class ProxyCollection extends ProxyObject
       collectionId: objectId,
       documentId: id,
       listenerId: listenerId,
+      debounce: debounce,
     ));
 
     return token = ProxyListenerToken(client, this, listenerId, listener);
@@ -822,10 +1328,14 @@ final class ProxyCollection extends ProxyObject
       ));
 
   @override
-  AsyncListenStream<DocumentChange> documentChanges(String id) =>
+  AsyncListenStream<DocumentChange> documentChanges(
+    String id, {
+    Duration? debounce,
+  }) =>
       useSync(() => ListenerStream(
             parent: this,
-            addListener: (listener) => _addDocumentChangeListener(id, listener),
+            addListener: (listener) =>
+                _addDocumentChangeListener(id, listener, debounce),
           ));
 
   @override
@@ -837,3 +1347,188 @@ final class ProxyCollection extends ProxyObject
   ) =>
       ProxyDocumentDelegate.fromDelegate(oldDelegate);
 }
+
+// The index is built by the regular create index endpoint, which already runs
+// in the isolate of the service, since the service has no endpoint for index
+// builds.
+final class _ProxyIndexBuild implements IndexBuild {
+  _ProxyIndexBuild(
+    this._collection,
+    this._name,
+    this._index,
+    this._onProgress,
+  ) {
+    _result.complete(_run());
+  }
+
+  final ProxyCollection _collection;
+  final String _name;
+  final IndexImplInterface _index;
+  final IndexBuildProgressListener? _onProgress;
+  final _result = Completer<bool>();
+  var _isCancelled = false;
+
+  @override
+  IndexBuildState get state => _state;
+  var _state = IndexBuildState.pending;
+
+  @override
+  Future<bool> get result => _result.future;
+
+  @override
+  void cancel() => _isCancelled = true;
+
+  void _setState(IndexBuildState state) {
+    _state = state;
+    _onProgress?.call(state);
+  }
+
+  Future<bool> _run() async {
+    // Gives the caller a chance to cancel the build before it starts.
+    await Future<void>.delayed(Duration.zero);
+
+    try {
+      if (_isCancelled) {
+        _setState(IndexBuildState.cancelled);
+        return false;
+      }
+
+      _setState(IndexBuildState.building);
+      final existed = (await _collection.indexes).contains(_name);
+      await _collection.createIndex(_name, _index);
+
+      if (_isCancelled && !existed) {
+        await _collection.deleteIndex(_name);
+        _setState(IndexBuildState.cancelled);
+        return false;
+      }
+
+      _setState(IndexBuildState.completed);
+      return true;
+      // ignore: avoid_catches_without_on_clauses
+    } catch (_) {
+      _setState(IndexBuildState.failed);
+      rethrow;
+    }
+  }
+}
+
+/// A schedule of maintenance of a [ProxyDatabase], which is run through the
+/// regular maintenance API of the database.
+final class _ProxyMaintenanceSchedule
+    with ClosableResourceMixin
+    implements MaintenanceSchedule {
+  _ProxyMaintenanceSchedule(
+    this._database,
+    Set<MaintenanceType> types, {
+    required Duration interval,
+    required Duration idleTimeout,
+    required MaintenanceProgressListener? onProgress,
+  })  : _types = MaintenanceType.values.where(types.contains).toList(),
+        _interval = interval,
+        _idleTimeout = idleTimeout,
+        _onProgress = onProgress {
+    attachTo(_database);
+    _addListeners = _addChangeListeners()
+        // The database can be closed while the listeners are being added.
+        .catchError((Object _) {}, test: (error) => error is StateError)
+        .then((_) => _scheduleCheck());
+  }
+
+  final ProxyDatabase _database;
+  final List<MaintenanceType> _types;
+  final Duration _interval;
+  final Duration _idleTimeout;
+  final MaintenanceProgressListener? _onProgress;
+  final _removeListeners = <Future<void> Function()>[];
+  final _sinceLastRun = Stopwatch()..start();
+  final _sinceLastChange = Stopwatch()..start();
+  late final Future<void> _addListeners;
+  Future<void>? _run;
+  Timer? _timer;
+
+  @override
+  MaintenanceReport? get lastReport => _lastReport;
+  MaintenanceReport? _lastReport;
+
+  Future<void> _addChangeListeners() async {
+    for (final scope in await _database.scopes) {
+      for (final collection in await scope.collections) {
+        final token = await collection
+            .addChangeListener((_) => _sinceLastChange.reset());
+        _removeListeners.add(() => collection.removeChangeListener(token));
+      }
+    }
+  }
+
+  void _scheduleCheck() {
+    if (isClosed) {
+      return;
+    }
+
+    final untilInterval = _interval - _sinceLastRun.elapsed;
+    final untilIdle = _idleTimeout - _sinceLastChange.elapsed;
+    final delay = untilInterval > untilIdle ? untilInterval : untilIdle;
+    _timer = Timer(delay.isNegative ? Duration.zero : delay, _check);
+  }
+
+  void _check() {
+    if (isClosed) {
+      return;
+    }
+
+    if (_sinceLastRun.elapsed < _interval ||
+        _sinceLastChange.elapsed < _idleTimeout) {
+      _scheduleCheck();
+      return;
+    }
+
+    _run = _runMaintenance().whenComplete(() {
+      _sinceLastRun.reset();
+      _scheduleCheck();
+    });
+  }
+
+  Future<void> _runMaintenance() async {
+    final fileSizeBefore = await _fileSize();
+
+    CouchbaseLiteException? error;
+    for (final type in _types) {
+      if (isClosed) {
+        break;
+      }
+
+      _onProgress?.call(MaintenanceProgress.started(type));
+      try {
+        await _database.performMaintenance(type);
+      } on CouchbaseLiteException catch (e) {
+        error = e;
+        break;
+      }
+    }
+
+    final report = _lastReport = MaintenanceReport(
+      fileSizeBefore: fileSizeBefore,
+      fileSizeAfter: await _fileSize(),
+      error: error,
+    );
+    _onProgress?.call(MaintenanceProgress.finished(report));
+  }
+
+  Future<int> _fileSize() => _database.channel
+      .call(GetDatabaseFileSize(databaseId: _database.objectId));
+
+  @override
+  Future<void> performClose() async {
+    _timer?.cancel();
+    await _addListeners;
+    await _run;
+    // Closing the database removes the listeners anyway.
+    if (!_database.isClosed) {
+      await Future.wait(_removeListeners.map((remove) => remove()));
+    }
+  }
+
+  @override
+  String toString() => 'ProxyMaintenanceSchedule()';
+}
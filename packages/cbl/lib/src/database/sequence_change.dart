@@ -0,0 +1,100 @@
+import 'package:meta/meta.dart';
+
+import '../bindings.dart';
+import '../fleece/decoder.dart';
+import 'collection.dart';
+
+/// The current revision of a document, as read from a
+/// [Collection.changesSince] stream.
+///
+/// {@category Database}
+@immutable
+final class SequenceChange {
+  /// Creates the current revision of a document, as read from a
+  /// [Collection.changesSince] stream.
+  const SequenceChange({
+    required this.id,
+    required this.sequence,
+    required this.revisionId,
+    required this.isDeleted,
+    this.properties,
+  });
+
+  /// The id of the document.
+  final String id;
+
+  /// The sequence of the document, which is unique within its collection and
+  /// increases every time the document changes.
+  final int sequence;
+
+  /// The id of the current revision of the document.
+  final String revisionId;
+
+  /// Whether the document has been deleted.
+  final bool isDeleted;
+
+  /// The properties of the document, or `null` if it has been deleted.
+  final Map<String, Object?>? properties;
+
+  @override
+  String toString() => [
+        'SequenceChange(',
+        [
+          'id: $id',
+          'sequence: $sequence',
+          'revisionId: $revisionId',
+          if (isDeleted) 'DELETED',
+        ].join(', '),
+        ')',
+      ].join();
+}
+
+/// A batch of [SequenceChange]s, as read from a [Collection.changesSince]
+/// stream.
+///
+/// {@category Database}
+@immutable
+final class SequenceChangeBatch {
+  /// Creates a batch of [SequenceChange]s, which continues after [checkpoint].
+  const SequenceChangeBatch(this.changes, this.checkpoint);
+
+  /// The changed documents, in the order of their sequences.
+  final List<SequenceChange> changes;
+
+  /// The sequence of the last document in this batch.
+  ///
+  /// Once the batch has been processed, this sequence can be persisted and
+  /// passed to [Collection.changesSince] to continue after this batch.
+  final int checkpoint;
+
+  @override
+  String toString() =>
+      'SequenceChangeBatch(${changes.length} changes, checkpoint: $checkpoint)';
+}
+
+/// Decodes a batch of changes, which has been read by a native change cursor
+/// after the [sequence].
+SequenceChangeBatch decodeSequenceChangeBatch(Data data, int sequence) {
+  final rows =
+      const FleeceDecoder(trust: FLTrust.trusted).convert(data)! as List;
+
+  final changes = <SequenceChange>[];
+  for (final row in rows.cast<List<Object?>>()) {
+    // The deleted flag is a number in query results.
+    final isDeleted = row[3] == true || row[3] == 1;
+    changes.add(SequenceChange(
+      id: row[0]! as String,
+      sequence: row[1]! as int,
+      revisionId: row[2]! as String,
+      isDeleted: isDeleted,
+      properties: !isDeleted && row.length > 4
+          ? (row[4]! as Map).cast<String, Object?>()
+          : null,
+    ));
+  }
+
+  return SequenceChangeBatch(
+    changes,
+    changes.isEmpty ? sequence : changes.last.sequence,
+  );
+}
@@ -1,6 +1,9 @@
 export 'document/array.dart'
     show Array, ArrayInterface, MutableArray, MutableArrayInterface;
 export 'document/blob.dart' show Blob;
+export 'document/blob_cache.dart' show BlobCache, BlobCacheStats;
+export 'document/blob_deduplication.dart'
+    show BlobDeduplication, BlobDeduplicationStats;
 export 'document/dictionary.dart'
     show
         Dictionary,
@@ -8,6 +11,7 @@ export 'document/dictionary.dart'
         MutableDictionary,
         MutableDictionaryInterface;
 export 'document/document.dart' show Document, MutableDocument;
+export 'document/document_cache.dart' show DocumentCache, DocumentCacheStats;
 export 'document/fragment.dart'
     show
         ArrayFragment,
@@ -19,3 +23,4 @@ export 'document/fragment.dart'
         MutableFragment,
         MutableFragmentInterface,
         MutableDictionaryFragment;
+export 'document/key_path_projection.dart' show KeyPathProjection;
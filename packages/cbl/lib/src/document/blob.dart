@@ -1,6 +1,7 @@
 // ignore_for_file: lines_longer_than_80_chars, avoid_equals_and_hash_code_on_mutable_classes
 
 import 'dart:async';
+import 'dart:io';
 import 'dart:typed_data';
 
 import '../bindings.dart';
@@ -62,7 +63,31 @@ abstract final class Blob {
   Future<Uint8List> content();
 
   /// A stream of the content of this [Blob].
-  Stream<Uint8List> contentStream();
+  ///
+  /// If [start] or [end] are given, only the content from the byte at [start]
+  /// up to, but not including, the byte at [end] is streamed. For a saved
+  /// [Blob], reading starts directly at [start], without reading the content
+  /// before it.
+  ///
+  /// If [readAhead] is larger than `0`, the content of a saved [Blob] is read
+  /// on a background thread, which keeps up to [readAhead] chunks buffered
+  /// ahead of the listener. This avoids stalls from I/O latency, when the
+  /// content is consumed at a steady rate, like when media is played.
+  ///
+  /// Throws a [RangeError] if the range is not valid for the [length] of this
+  /// [Blob].
+  Stream<Uint8List> contentStream({
+    int start = 0,
+    int? end,
+    int readAhead = 0,
+  });
+
+  /// Writes the content of this [Blob] to the file at [path], replacing an
+  /// existing file.
+  ///
+  /// The content of a saved [Blob] is copied natively on a background thread,
+  /// without being loaded into memory.
+  Future<void> writeToFile(String path);
 
   /// The type of content this [Blob] represents.
   ///
@@ -179,10 +204,28 @@ final class BlobImpl implements Blob, FleeceEncodable, CblConversions {
   Future<Uint8List> content() => byteStreamToFuture(contentStream());
 
   @override
-  Stream<Uint8List> contentStream() {
+  Stream<Uint8List> contentStream({
+    int start = 0,
+    int? end,
+    int readAhead = 0,
+  }) {
+    RangeError.checkNotNegative(readAhead, 'readAhead');
+    final length = _length;
+    if (length != null) {
+      end = RangeError.checkValidRange(start, end, length, 'start', 'end');
+    } else {
+      RangeError.checkNotNegative(start, 'start');
+      if (end != null && end < start) {
+        throw RangeError.range(end, start, null, 'end');
+      }
+    }
+    final isRange = start > 0 || (end != null && end != length);
+
     final content = _content;
     if (content != null) {
-      return Stream.value(content);
+      return Stream.value(
+        isRange ? Uint8List.sublistView(content, start, end) : content,
+      );
     }
 
     final contentStream = _contentStream;
@@ -190,18 +233,25 @@ final class BlobImpl implements Blob, FleeceEncodable, CblConversions {
       if (contentStream is! RepeatableStream) {
         _contentStream = RepeatableStream(contentStream);
       }
-      return _contentStream!;
+      return isRange
+          ? byteStreamRange(_contentStream!, start, end)
+          : _contentStream!;
     }
 
     if (_digest != null && _blobStore != null) {
       final stream = _blobStore!
-          .readBlob(_blobProperties())
+          .readBlob(
+            _blobProperties(),
+            start: start,
+            end: end,
+            readAhead: readAhead,
+          )
           ?.map((data) => data.toTypedList());
       if (stream == null) {
         _throwNotFoundError();
       }
 
-      if (_shouldCacheContent) {
+      if (_shouldCacheContent && !isRange) {
         final byteBuilder = BytesBuilder(copy: false);
         return stream.transform(StreamTransformer.fromHandlers(
           handleData: (data, sink) {
@@ -223,6 +273,24 @@ final class BlobImpl implements Blob, FleeceEncodable, CblConversions {
     _throwNotSavedError("Cannot load Blob's content.");
   }
 
+  @override
+  Future<void> writeToFile(String path) async {
+    final blobStore = _blobStore;
+    if (_digest != null && blobStore != null) {
+      if (!await blobStore.writeBlobToFile(_blobProperties(), path)) {
+        _throwNotFoundError();
+      }
+      return;
+    }
+
+    final sink = File(path).openWrite();
+    try {
+      await sink.addStream(contentStream());
+    } finally {
+      await sink.close();
+    }
+  }
+
   @override
   Map<String, Object?> get properties => _blobProperties();
 
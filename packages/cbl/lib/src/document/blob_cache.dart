@@ -0,0 +1,85 @@
+import '../bindings.dart';
+import 'blob.dart';
+
+final _bindings = cblBindings.blobs.blob;
+
+/// A native in-memory cache of the content of small [Blob]s, which allows
+/// frequently read blobs, like thumbnails, to be read without opening and
+/// reading their files again.
+///
+/// The content of a saved [Blob] is looked up in the cache by its digest,
+/// before it is read from the database. Since the digest identifies the
+/// content, cached content never becomes stale.
+///
+/// The cache keeps at most [maxSize] bytes of content for each database and
+/// evicts the least recently used content. The content of blobs which are
+/// larger than [maxEntrySize] bytes is not cached. The cached content of a
+/// database is released when the database is closed.
+///
+/// The cache is shared by all isolates, including the worker isolates of
+/// `AsyncDatabase`s.
+///
+/// {@category Document}
+abstract final class BlobCache {
+  /// The maximum number of bytes of content the cache keeps for each
+  /// database.
+  ///
+  /// A maximum size of `0` disables the cache, which is the default.
+  static int get maxSize => _bindings.cacheStats().maxSize;
+
+  static set maxSize(int value) {
+    RangeError.checkNotNegative(value, 'maxSize');
+    _bindings.setCacheLimits(maxSize: value, maxEntrySize: maxEntrySize);
+  }
+
+  /// The maximum size in bytes of the content of a single blob the cache
+  /// keeps.
+  ///
+  /// The default is `64 KiB`.
+  static int get maxEntrySize => _bindings.cacheStats().maxEntrySize;
+
+  static set maxEntrySize(int value) {
+    RangeError.checkNotNegative(value, 'maxEntrySize');
+    _bindings.setCacheLimits(maxSize: maxSize, maxEntrySize: value);
+  }
+
+  /// The current stats of the cache.
+  static BlobCacheStats get stats {
+    final stats = _bindings.cacheStats();
+    return BlobCacheStats._(
+      hits: stats.hits,
+      misses: stats.misses,
+      evictions: stats.evictions,
+      size: stats.size,
+    );
+  }
+}
+
+/// Stats of the [BlobCache].
+///
+/// {@category Document}
+final class BlobCacheStats {
+  BlobCacheStats._({
+    required this.hits,
+    required this.misses,
+    required this.evictions,
+    required this.size,
+  });
+
+  /// The number of blob reads whose content was found in the cache.
+  final int hits;
+
+  /// The number of blob reads whose content was not found in the cache.
+  final int misses;
+
+  /// The number of blob contents which have been evicted from the cache,
+  /// because it exceeded one of its limits.
+  final int evictions;
+
+  /// The total number of bytes of content in the cache.
+  final int size;
+
+  @override
+  String toString() => 'BlobCacheStats(hits: $hits, misses: $misses, '
+      'evictions: $evictions, size: $size)';
+}
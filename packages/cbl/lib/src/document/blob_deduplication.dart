@@ -0,0 +1,56 @@
+import '../bindings.dart';
+import 'blob.dart';
+
+final _bindings = cblBindings.blobs.blob;
+
+/// The deduplication of the content of [Blob]s, when they are saved.
+///
+/// The digest of a [Blob] which has been created from content in memory is
+/// known before its content is written to the database. If the database
+/// already contains a blob with the same digest, for example because the
+/// same image is attached to multiple documents, the content is not written
+/// again.
+///
+/// The content of blobs which are created from a stream or a file is always
+/// written, because their digest is only known once their content has been
+/// written.
+///
+/// {@category Document}
+abstract final class BlobDeduplication {
+  /// The current stats of the deduplication, across all databases.
+  static BlobDeduplicationStats get stats {
+    final stats = _bindings.deduplicationStats();
+    return BlobDeduplicationStats._(
+      writes: stats.writes,
+      deduplications: stats.deduplications,
+      deduplicatedSize: stats.deduplicatedSize,
+    );
+  }
+}
+
+/// Stats of the [BlobDeduplication].
+///
+/// {@category Document}
+final class BlobDeduplicationStats {
+  BlobDeduplicationStats._({
+    required this.writes,
+    required this.deduplications,
+    required this.deduplicatedSize,
+  });
+
+  /// The number of blobs created from content in memory, whose content has
+  /// been written to the database.
+  final int writes;
+
+  /// The number of blobs created from content in memory, whose content has
+  /// not been written, because it already existed in the database.
+  final int deduplications;
+
+  /// The total number of bytes of content which have not been written again.
+  final int deduplicatedSize;
+
+  @override
+  String toString() => 'BlobDeduplicationStats(writes: $writes, '
+      'deduplications: $deduplications, '
+      'deduplicatedSize: $deduplicatedSize)';
+}
@@ -249,6 +249,90 @@ bool valueWouldChange(
   return newValue != oldValue.asNative(container);
 }
 
+/// Deeply decodes [dict] into a plain [Map], directly from the Fleece data it
+/// is backed by.
+///
+/// Returns `null` if [dict] is not backed by unmodified Fleece data, in which
+/// case the plain [Map] has to be built from the values of [dict].
+Map<String, Object?>? decodePlainMap(MDict dict) {
+  final flDict = dict.flDict;
+  // A dict which is itself a blob would be decoded as a blob, which is
+  // why it is left to the slow path.
+  if (flDict == null || dict.isMutated || _blobBindings.isBlob(flDict)) {
+    return null;
+  }
+
+  final context = dict.context;
+  final result = _plainObjectDecoder(context).decode(flDict.cast());
+  cblReachabilityFence(context);
+
+  return result! as Map<String, Object?>;
+}
+
+/// Deeply decodes [array] into a plain [List], directly from the Fleece data
+/// it is backed by.
+///
+/// Returns `null` if [array] is not backed by unmodified Fleece data, in which
+/// case the plain [List] has to be built from the values of [array].
+List<Object?>? decodePlainList(MArray array) {
+  final flArray = array.flArray;
+  if (flArray == null || array.isMutated) {
+    return null;
+  }
+
+  final context = array.context;
+  final result = _plainObjectDecoder(context).decode(flArray.cast());
+  cblReachabilityFence(context);
+
+  return result! as List<Object?>;
+}
+
+/// Deeply decodes the loaded [value] into a plain object, in the same way as
+/// [CblConversions.convertToPlainObject] would convert the corresponding
+/// [MValue].
+///
+/// The caller must ensure that [context] stays reachable.
+Object? decodeLoadedPlainValue(CBLDart_LoadedFLValue value, MContext context) {
+  if (!value.exists) {
+    return null;
+  }
+
+  switch (value.type) {
+    case FLValueType.undefined:
+    case FLValueType.null_:
+      return null;
+    case FLValueType.boolean:
+      return value.asBool;
+    case FLValueType.number:
+      return value.isInteger ? value.asInt : value.asDouble;
+    case FLValueType.string:
+      return context.sharedStringsTable.decodeLoadedValue(value);
+    case FLValueType.data:
+      return value.asData.toData()?.toTypedList();
+    case FLValueType.array:
+    case FLValueType.dict:
+      return _plainObjectDecoder(context)
+          .decode(Pointer<FLValue>.fromAddress(value.value));
+  }
+}
+
+FleeceTapeDecoder _plainObjectDecoder(MContext context) {
+  Database? database;
+  if (context is DatabaseMContext) {
+    database = context.database;
+  }
+
+  return FleeceTapeDecoder(
+    sharedKeysTable: context.sharedKeysTable,
+    sharedStringsTable: context.sharedStringsTable,
+    // Query results can contain `undefined`, which is returned as `null`.
+    undefinedAsNull: true,
+    dictConverter: (properties) => Blob.isBlob(properties)
+        ? BlobImpl.fromProperties(properties, database: database)
+        : properties,
+  );
+}
+
 @pragma('vm:prefer-inline')
 T? coerceObject<T>(Object? object, {required bool coerceNull}) {
   if (!coerceNull && object == null) {
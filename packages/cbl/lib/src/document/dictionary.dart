@@ -12,6 +12,7 @@ import 'array.dart';
 import 'blob.dart';
 import 'common.dart';
 import 'fragment.dart';
+import 'key_path_projection.dart';
 
 /// Defines a set of methods for readonly accessing [Dictionary] data.
 ///
@@ -89,6 +90,16 @@ abstract interface class DictionaryInterface implements DictionaryFragment {
   ///
   /// {@macro cbl.ArrayInterface.toPrimitiveObjectConversion}
   Map<String, Object?> toPlainMap();
+
+  /// Returns the values at the key paths of [projection], in the same order
+  /// as [KeyPathProjection.keyPaths].
+  ///
+  /// The values are converted into plain Dart objects, in the same way as by
+  /// [toPlainMap]. The value for a key path which does not exist is `null`.
+  ///
+  /// Reading multiple values through a projection is faster than reading
+  /// them one by one, in particular for large dictionaries.
+  List<Object?> project(KeyPathProjection projection);
 }
 
 /// Provides readonly access to dictionary data.
@@ -203,6 +214,12 @@ final class DictionaryImpl
   @override
   T? value<T extends Object>(String key) => _getAs(key);
 
+  /// Returns the value for [key], if it can be read without decoding it into
+  /// a cached value first.
+  ///
+  /// See [MDict.getScalar].
+  Object? scalarValue(String key) => _dict.getScalar(key);
+
   @override
   String? string(String key) => _getAs(key);
 
@@ -231,12 +248,18 @@ final class DictionaryImpl
   Dictionary? dictionary(String key) => _getAs(key);
 
   @override
-  Map<String, Object?> toPlainMap() => {
+  Map<String, Object?> toPlainMap() =>
+      decodePlainMap(_dict) ??
+      {
         for (final entry in _dict.iterable)
           entry.key:
               CblConversions.convertToPlainObject(entry.value.asNative(_dict))
       };
 
+  @override
+  List<Object?> project(KeyPathProjection projection) =>
+      (projection as KeyPathProjectionImpl).evaluate(_dict, this);
+
   @override
   Fragment operator [](String key) =>
       FragmentImpl.fromDictionary(this, key: key);
@@ -314,6 +337,21 @@ final class MutableDictionaryImpl extends DictionaryImpl
     }
   }
 
+  /// Sets the property [key] to the [String], [num] or [bool] [value].
+  ///
+  /// Unlike [setValue], the value is not converted and the current value is
+  /// compared through [MDict.getScalar], so that setting a property to the
+  /// value it already has does not decode it into a cached value.
+  void setScalarValue(Object value, {required String key}) {
+    assert(value is String || value is num || value is bool);
+    final current = _dict.getScalar(key);
+    if (identical(current, MDict.notScalar)) {
+      setValue(value, key: key);
+    } else if (current != value) {
+      _dict.set(key, value);
+    }
+  }
+
   @override
   void setString(String? value, {required String key}) =>
       setValue(value, key: key);
@@ -19,6 +19,7 @@ import 'blob.dart';
 import 'common.dart';
 import 'dictionary.dart';
 import 'fragment.dart';
+import 'key_path_projection.dart';
 
 /// A Couchbase Lite document.
 ///
@@ -96,6 +97,17 @@ abstract interface class DocumentDelegate {
   /// The returned [MRoot] must have the mutability as required by [isMutable].
   MRoot createMRoot(DelegateDocument document, {required bool isMutable});
 
+  /// Writes only the changes which have been made to the properties in
+  /// [root], if [root] has been created by this delegate and this delegate
+  /// supports it.
+  ///
+  /// Returns whether the changes have been written. Otherwise, the properties
+  /// have to be encoded completely and written to [properties].
+  FutureOr<bool> writeChangedProperties(
+    MRoot root,
+    FleeceEncoder Function() createEncoder,
+  );
+
   /// Returns a copy of this delegate which can be used for a mutable document.
   DocumentDelegate toMutable();
 }
@@ -151,6 +163,13 @@ final class NewDocumentDelegate extends DocumentDelegate {
     );
   }
 
+  @override
+  bool writeChangedProperties(
+    MRoot root,
+    FleeceEncoder Function() createEncoder,
+  ) =>
+      false;
+
   @override
   DocumentDelegate toMutable() => NewDocumentDelegate.mutableCopy(this);
 }
@@ -232,21 +251,39 @@ final class DelegateDocument with IterableMixin<String> implements Document {
     EncodingFormat format = EncodingFormat.fleece,
     bool saveExternalData = false,
   }) {
-    final encoder = FleeceEncoder(format: format.toFLEncoderFormat())
-      ..extraInfo = FleeceEncoderContext(
-        database: database,
-        encodeQueryParameter: true,
-        saveExternalData: saveExternalData,
-      );
+    final encoder = _createEncoder(
+      format: format,
+      saveExternalData: saveExternalData,
+    );
 
     return _root
         .encodeTo(encoder)
         .then((_) => EncodedData(format, encoder.finish()));
   }
 
-  FutureOr<void> writePropertiesToDelegate() =>
-      encodeProperties(saveExternalData: true)
-          .then((properties) => delegate.properties = properties);
+  FutureOr<void> writePropertiesToDelegate() => delegate
+          .writeChangedProperties(
+            _root,
+            () => _createEncoder(saveExternalData: true),
+          )
+          .then<void>((written) {
+        if (written) {
+          return null;
+        }
+        return encodeProperties(saveExternalData: true)
+            .then((properties) => delegate.properties = properties);
+      });
+
+  FleeceEncoder _createEncoder({
+    EncodingFormat format = EncodingFormat.fleece,
+    required bool saveExternalData,
+  }) =>
+      FleeceEncoder(format: format.toFLEncoderFormat())
+        ..extraInfo = FleeceEncoderContext(
+          database: database,
+          encodeQueryParameter: true,
+          saveExternalData: saveExternalData,
+        );
 
   bool get _isMutable => false;
   String get _typeName => 'Document';
@@ -278,6 +315,13 @@ final class DelegateDocument with IterableMixin<String> implements Document {
   @override
   T? value<T extends Object>(String key) => _properties.value(key);
 
+  /// Returns the value of the property [key], if it can be read without
+  /// decoding it into a cached value first.
+  ///
+  /// See [MDict.getScalar].
+  Object? scalarValue(String key) =>
+      (_properties as DictionaryImpl).scalarValue(key);
+
   @override
   String? string(String key) => _properties.string(key);
 
@@ -311,6 +355,10 @@ final class DelegateDocument with IterableMixin<String> implements Document {
   @override
   Map<String, Object?> toPlainMap() => _properties.toPlainMap();
 
+  @override
+  List<Object?> project(KeyPathProjection projection) =>
+      _properties.project(projection);
+
   @override
   MutableDocument toMutable() => MutableDelegateDocument.fromDelegate(
         delegate.toMutable(),
@@ -379,6 +427,13 @@ final class MutableDelegateDocument extends DelegateDocument
   void setValue(Object? value, {required String key}) =>
       _mutableProperties.setValue(value, key: key);
 
+  /// Sets the property [key] to the [String], [num] or [bool] [value].
+  ///
+  /// See [MutableDictionaryImpl.setScalarValue].
+  void setScalarValue(Object value, {required String key}) =>
+      (_mutableProperties as MutableDictionaryImpl)
+          .setScalarValue(value, key: key);
+
   @override
   void setString(String? value, {required String key}) =>
       _mutableProperties.setString(value, key: key);
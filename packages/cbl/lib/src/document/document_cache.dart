@@ -0,0 +1,102 @@
+import '../bindings.dart';
+import 'document.dart';
+
+final _bindings = cblBindings.collection;
+
+/// A native in-memory cache of immutable [Document]s, which allows frequently
+/// read documents to be read without loading them from the database again.
+///
+/// When a document is read by its id, it is looked up in the cache of its
+/// collection before it is loaded from the database. The cache of each
+/// collection keeps at most [maxCount] documents with a total size of at most
+/// [maxSize] bytes and evicts the least recently used documents.
+///
+/// Cached documents are invalidated by a collection change listener when they
+/// are saved, deleted, purged or expire. The listener is notified of changes
+/// once they have been committed. While a transaction is open on a database,
+/// its documents bypass the cache, so that reads in the transaction see its
+/// changes and uncommitted changes are never cached. Changes made through
+/// another database instance for the same file, for example by another
+/// process, are seen once the change listener has been notified of them. The
+/// cached documents of a database are released when the database is closed.
+///
+/// The cache is shared by all isolates, including the worker isolates of
+/// `AsyncDatabase`s.
+///
+/// {@category Document}
+abstract final class DocumentCache {
+  /// The maximum number of documents the cache keeps for each collection.
+  ///
+  /// A maximum count of `0` disables the cache, which is the default.
+  static int get maxCount => _bindings.documentCacheStats().maxCount;
+
+  static set maxCount(int value) {
+    RangeError.checkNotNegative(value, 'maxCount');
+    _bindings.setDocumentCacheLimits(maxCount: value, maxSize: maxSize);
+  }
+
+  /// The maximum total size in bytes of the documents the cache keeps for
+  /// each collection.
+  ///
+  /// The size of a document is approximated by the size of its encoded
+  /// properties. The default is `16 MiB`.
+  static int get maxSize => _bindings.documentCacheStats().maxSize;
+
+  static set maxSize(int value) {
+    RangeError.checkNotNegative(value, 'maxSize');
+    _bindings.setDocumentCacheLimits(maxCount: maxCount, maxSize: value);
+  }
+
+  /// The current stats of the cache.
+  static DocumentCacheStats get stats {
+    final stats = _bindings.documentCacheStats();
+    return DocumentCacheStats._(
+      hits: stats.hits,
+      misses: stats.misses,
+      evictions: stats.evictions,
+      invalidations: stats.invalidations,
+      count: stats.count,
+      size: stats.size,
+    );
+  }
+}
+
+/// Stats of the [DocumentCache].
+///
+/// {@category Document}
+final class DocumentCacheStats {
+  DocumentCacheStats._({
+    required this.hits,
+    required this.misses,
+    required this.evictions,
+    required this.invalidations,
+    required this.count,
+    required this.size,
+  });
+
+  /// The number of document reads which found the document in the cache.
+  final int hits;
+
+  /// The number of document reads which did not find the document in the
+  /// cache.
+  final int misses;
+
+  /// The number of documents which have been evicted from the cache, because
+  /// it exceeded one of its limits.
+  final int evictions;
+
+  /// The number of documents which have been removed from the cache, because
+  /// they changed.
+  final int invalidations;
+
+  /// The number of documents in the cache.
+  final int count;
+
+  /// The approximate total size in bytes of the documents in the cache.
+  final int size;
+
+  @override
+  String toString() => 'DocumentCacheStats(hits: $hits, misses: $misses, '
+      'evictions: $evictions, invalidations: $invalidations, count: $count, '
+      'size: $size)';
+}
@@ -1,3 +1,4 @@
+import 'dart:async';
 import 'dart:ffi';
 
 import '../bindings.dart';
@@ -8,6 +9,7 @@ import '../fleece/integration/integration.dart';
 import '../support/encoding.dart';
 import '../support/ffi.dart';
 import '../support/native_object.dart';
+import '../support/utils.dart';
 import 'document.dart';
 
 final _documentBindings = cblBindings.document;
@@ -64,9 +66,46 @@ final class FfiDocumentDelegate implements DocumentDelegate, Finalizable {
         isMutable: isMutable,
       );
 
+  /// Writes only the changed subtrees of [root] into the mutable properties
+  /// of this document, which are a copy-on-write copy of its saved
+  /// properties.
+  @override
+  FutureOr<bool> writeChangedProperties(
+    MRoot root,
+    FleeceEncoder Function() createEncoder,
+  ) {
+    final dict = MDelegate.instance!.collectionFromNative(root.asNative);
+    if (dict is! MDict ||
+        dict.flDict != _documentBindings.properties(pointer)) {
+      return false;
+    }
+
+    final changes = MDictChanges.of(dict);
+    if (changes == null) {
+      return false;
+    }
+    if (changes.isEmpty) {
+      return true;
+    }
+
+    final encoder = createEncoder();
+    return changes.encodeTo(encoder).then((_) {
+      final values = fl.Doc.fromResultData(encoder.finish(), FLTrust.trusted);
+      changes.applyTo(
+        fl.MutableDict.fromPointer(
+          _mutableDocumentBindings.mutableProperties(pointer.cast()),
+        ),
+        values.root.asArray!,
+      );
+      _properties = null;
+      return true;
+    });
+  }
+
   EncodedData _readEncodedProperties() {
     final encoder = FleeceEncoder()
-      ..writeValue(_documentBindings.properties(pointer).cast());
+      ..writeValue(_documentBindings.properties(pointer).cast())
+      ..keepAlive(this);
     return EncodedData.fleece(encoder.finish());
   }
 
@@ -0,0 +1,166 @@
+import 'dart:ffi';
+
+import '../bindings.dart';
+import '../fleece/integration/integration.dart';
+import 'array.dart';
+import 'common.dart';
+import 'dictionary.dart';
+
+final _decoderBinds = cblBindings.fleece.decoder;
+
+/// A precompiled list of key paths, which can be used to read the values at
+/// multiple key paths of a dictionary at once.
+///
+/// A key path consists of dictionary keys separated by `.` and array indices
+/// in brackets, for example `address.city` or `tags[0]`. Negative array
+/// indices count from the end of the array. A `\` escapes the following
+/// character, for example `a\.b` is the key `a.b`.
+///
+/// Creating a [KeyPathProjection] is relatively expensive, compared to using
+/// it. It should be created once and reused for reading multiple
+/// dictionaries.
+///
+/// See also:
+///
+/// - [DictionaryInterface.project] for reading the values at the key paths of
+///   a [KeyPathProjection].
+///
+/// {@category Document}
+abstract final class KeyPathProjection {
+  /// Creates a [KeyPathProjection] from a list of [keyPaths].
+  ///
+  /// Throws an [ArgumentError] if one of the [keyPaths] is invalid.
+  factory KeyPathProjection(List<String> keyPaths) = KeyPathProjectionImpl;
+
+  /// The key paths of this projection.
+  List<String> get keyPaths;
+}
+
+final class KeyPathProjectionImpl implements KeyPathProjection, Finalizable {
+  KeyPathProjectionImpl(List<String> keyPaths)
+      : keyPaths = List.unmodifiable(keyPaths),
+        _segments = List.unmodifiable(keyPaths.map(_parseKeyPath));
+
+  @override
+  final List<String> keyPaths;
+
+  /// The parsed segments of [keyPaths], which are either [String] keys or
+  /// [int] indices.
+  final List<List<Object>> _segments;
+
+  late final Pointer<CBLDart_FLDictProjection> _pointer =
+      _decoderBinds.createDictProjection(this, keyPaths);
+
+  late final SliceResult _values =
+      SliceResult(keyPaths.length * sizeOf<CBLDart_LoadedFLValue>());
+
+  /// Returns the values at [keyPaths] in [dict], which is wrapped by
+  /// [dictionary].
+  List<Object?> evaluate(MDict dict, DictionaryInterface dictionary) {
+    if (keyPaths.isEmpty) {
+      return [];
+    }
+
+    final flDict = dict.flDict;
+    if (flDict == null || dict.isMutated) {
+      return [
+        for (final segments in _segments)
+          _evaluateSegments(dictionary, segments)
+      ];
+    }
+
+    final context = dict.context;
+    final values = _values.buf.cast<CBLDart_LoadedFLValue>();
+    _decoderBinds.evalDictProjection(_pointer, flDict, values);
+    final result = List<Object?>.generate(
+      keyPaths.length,
+      (i) => decodeLoadedPlainValue(values[i], context),
+    );
+    cblReachabilityFence(context);
+    cblReachabilityFence(_values);
+    cblReachabilityFence(this);
+
+    return result;
+  }
+}
+
+Object? _evaluateSegments(
+  DictionaryInterface dictionary,
+  List<Object> segments,
+) {
+  Object? value = dictionary;
+  for (final segment in segments) {
+    if (segment is String) {
+      value = value is DictionaryInterface ? value.value(segment) : null;
+    } else if (value is ArrayInterface) {
+      final length = value.length;
+      var index = segment as int;
+      if (index < 0) {
+        index += length;
+      }
+      value = index >= 0 && index < length ? value.value(index) : null;
+    } else {
+      value = null;
+    }
+
+    if (value == null) {
+      return null;
+    }
+  }
+
+  return CblConversions.convertToPlainObject(value);
+}
+
+List<Object> _parseKeyPath(String keyPath) {
+  var path = keyPath;
+  if (path.startsWith(r'$.')) {
+    path = path.substring(2);
+  } else if (path.startsWith(r'$')) {
+    path = path.substring(1);
+  }
+
+  final segments = <Object>[];
+  final key = StringBuffer();
+
+  void endKey() {
+    if (key.isNotEmpty) {
+      segments.add(key.toString());
+      key.clear();
+    }
+  }
+
+  var i = 0;
+  while (i < path.length) {
+    final char = path[i];
+    if (char == r'\') {
+      if (i + 1 == path.length) {
+        throw ArgumentError.value(keyPath, 'keyPath', 'ends with an escape');
+      }
+      key.write(path[i + 1]);
+      i += 2;
+    } else if (char == '.') {
+      endKey();
+      i++;
+    } else if (char == '[') {
+      endKey();
+      final end = path.indexOf(']', i);
+      final index =
+          end == -1 ? null : int.tryParse(path.substring(i + 1, end));
+      if (index == null) {
+        throw ArgumentError.value(
+          keyPath,
+          'keyPath',
+          'contains an invalid array index',
+        );
+      }
+      segments.add(index);
+      i = end + 1;
+    } else {
+      key.write(char);
+      i++;
+    }
+  }
+  endKey();
+
+  return segments;
+}
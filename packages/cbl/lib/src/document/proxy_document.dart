@@ -1,6 +1,7 @@
 import '../bindings.dart';
 import '../database/proxy_database.dart';
 import '../fleece/containers.dart';
+import '../fleece/encoder.dart';
 import '../fleece/integration/root.dart';
 import '../service/cbl_service_api.dart';
 import '../service/proxy_object.dart';
@@ -73,6 +74,13 @@ final class ProxyDocumentDelegate
     );
   }
 
+  @override
+  bool writeChangedProperties(
+    MRoot root,
+    FleeceEncoder Function() createEncoder,
+  ) =>
+      false;
+
   @override
   DocumentDelegate toMutable() {
     assert(
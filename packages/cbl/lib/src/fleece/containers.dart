@@ -554,7 +554,8 @@ final class _DictKeyIterator implements Iterator<String> {
   bool moveNext() {
     if (iterator.moveNext()) {
       final key = globalLoadedDictKey.ref;
-      current = decodeFLString(key.stringBuf, key.stringSize);
+      current =
+          decodeFLString(key.stringBuf, key.stringSize, isAscii: key.isAscii);
       return true;
     } else {
       return false;
@@ -14,6 +14,9 @@ final _decoderBinds = cblBindings.fleece.decoder;
 /// This method exists for debugging and learning purposes.
 String dumpData(Data data) => _decoderBinds.dumpData(data);
 
+final _globalLoadedKey = globalLoadedDictKey.ref;
+final _globalLoadedValue = globalLoadedFLValue.ref;
+
 // === SharedKeysTable =========================================================
 
 /// A table which maps shared key ids to their corresponding Dart strings.
@@ -29,7 +32,39 @@ abstract final class SharedKeysTable {
   /// Decodes the string currently loaded in [globalLoadedDictKey].
   ///
   /// The given [sharedStringsTable] might be used to decode the string.
-  String decode(SharedStringsTable sharedStringsTable);
+  String decode(SharedStringsTable sharedStringsTable) =>
+      decodeKey(_globalLoadedKey, sharedStringsTable);
+
+  /// Decodes the string loaded in [key].
+  ///
+  /// The given [sharedStringsTable] might be used to decode the string.
+  String decodeKey(
+    CBLDart_LoadedDictKey key,
+    SharedStringsTable sharedStringsTable,
+  );
+
+  /// Registers all shared keys in the batch of [count] [keys], which have been
+  /// made known while loading the batch.
+  ///
+  /// Registering the keys of a batch right after it has been loaded ensures
+  /// that the keys are known, even if not all of the keys of the batch are
+  /// decoded.
+  void _registerLoadedKeys(Pointer<CBLDart_LoadedDictKey> keys, int count);
+
+  /// Decodes the key held by the dict key tape [entry].
+  ///
+  /// The given [sharedStringsTable] might be used to decode the string.
+  String _decodeTapeKey(
+    CBLDart_FLTapeEntry entry,
+    SharedStringsTable sharedStringsTable,
+  );
+
+  /// Registers all shared keys in [tape], which have been made known while
+  /// writing the tape.
+  ///
+  /// This has to be called if a tape cannot be decoded completely, since the
+  /// keys that have not been decoded will not be loaded again.
+  void _registerTapeKeys(CBLDart_FLTape tape);
 }
 
 /// A [SharedKeysTable] which does not handle shared keys specially and instead
@@ -41,8 +76,32 @@ final class NoopSharedKeysTable extends SharedKeysTable {
   Pointer<KnownSharedKeys>? get _knownSharedKeys => null;
 
   @override
-  String decode(SharedStringsTable sharedStringsTable) =>
-      sharedStringsTable.decode(StringSource.dictKey);
+  String decodeKey(
+    CBLDart_LoadedDictKey key,
+    SharedStringsTable sharedStringsTable,
+  ) =>
+      sharedStringsTable._decodeBuffer(
+        key.stringBuf,
+        key.stringSize,
+        isAscii: key.isAscii,
+      );
+
+  @override
+  void _registerLoadedKeys(Pointer<CBLDart_LoadedDictKey> keys, int count) {}
+
+  @override
+  String _decodeTapeKey(
+    CBLDart_FLTapeEntry entry,
+    SharedStringsTable sharedStringsTable,
+  ) =>
+      sharedStringsTable._decodeBuffer(
+        entry.payload.buf,
+        entry.size,
+        isAscii: entry.isAscii,
+      );
+
+  @override
+  void _registerTapeKeys(CBLDart_FLTape tape) {}
 }
 
 final class _SharedKeysTable extends SharedKeysTable implements Finalizable {
@@ -57,20 +116,35 @@ final class _SharedKeysTable extends SharedKeysTable implements Finalizable {
   @override
   late final Pointer<KnownSharedKeys> _knownSharedKeys;
 
-  final _sharedKeys = HashMap<int, String>();
+  /// The decoded shared keys, indexed by their id.
+  ///
+  /// Shared key ids are small and dense, which is why a growable list is used
+  /// instead of a map.
+  final _sharedKeys = <String?>[];
 
-  final _loadedKey = globalLoadedDictKey.ref;
+  String? _getKey(int sharedKey) =>
+      sharedKey < _sharedKeys.length ? _sharedKeys[sharedKey] : null;
+
+  String _setKey(int sharedKey, String key) {
+    if (sharedKey >= _sharedKeys.length) {
+      _sharedKeys.length = sharedKey + 1;
+    }
+    return _sharedKeys[sharedKey] = key;
+  }
 
   @override
-  String decode(SharedStringsTable sharedStringsTable) {
-    final sharedKey = _loadedKey.sharedKey;
+  String decodeKey(
+    CBLDart_LoadedDictKey loadedKey,
+    SharedStringsTable sharedStringsTable,
+  ) {
+    final sharedKey = loadedKey.sharedKey;
     if (sharedKey != _notSharedKey) {
-      final key = _sharedKeys[sharedKey];
+      final key = _getKey(sharedKey);
       if (key != null) {
         return key;
       }
 
-      if (_loadedKey.isKnownSharedKey) {
+      if (loadedKey.isKnownSharedKey) {
         assert(
           false,
           'Shared key that should have been known is not known. When you use a '
@@ -79,11 +153,90 @@ final class _SharedKeysTable extends SharedKeysTable implements Finalizable {
         );
         throw Exception();
       } else {
-        return _sharedKeys[sharedKey] =
-            decodeFLString(_loadedKey.stringBuf, _loadedKey.stringSize);
+        return _setKey(
+          sharedKey,
+          decodeFLString(
+            loadedKey.stringBuf,
+            loadedKey.stringSize,
+            isAscii: loadedKey.isAscii,
+          ),
+        );
       }
     } else {
-      return sharedStringsTable.decode(StringSource.dictKey);
+      return sharedStringsTable._decodeBuffer(
+        loadedKey.stringBuf,
+        loadedKey.stringSize,
+        isAscii: loadedKey.isAscii,
+      );
+    }
+  }
+
+  @override
+  void _registerLoadedKeys(Pointer<CBLDart_LoadedDictKey> keys, int count) {
+    for (var i = 0; i < count; i++) {
+      final key = keys[i];
+      final sharedKey = key.sharedKey;
+      if (sharedKey != _notSharedKey &&
+          !key.isKnownSharedKey &&
+          _getKey(sharedKey) == null) {
+        _setKey(
+          sharedKey,
+          decodeFLString(key.stringBuf, key.stringSize, isAscii: key.isAscii),
+        );
+      }
+    }
+  }
+
+  @override
+  String _decodeTapeKey(
+    CBLDart_FLTapeEntry entry,
+    SharedStringsTable sharedStringsTable,
+  ) {
+    final sharedKey = entry.sharedKey;
+    if (sharedKey == _notSharedKey) {
+      return sharedStringsTable._decodeBuffer(
+        entry.payload.buf,
+        entry.size,
+        isAscii: entry.isAscii,
+      );
+    }
+
+    final key = _getKey(sharedKey);
+    if (key != null) {
+      return key;
+    }
+
+    if (entry.flag) {
+      throw StateError(
+        'Shared key $sharedKey should have been known, but is not known. '
+        'When a tape cannot be fully decoded its keys need to be registered.',
+      );
+    }
+
+    return _setKey(
+      sharedKey,
+      decodeFLString(entry.payload.buf, entry.size, isAscii: entry.isAscii),
+    );
+  }
+
+  @override
+  void _registerTapeKeys(CBLDart_FLTape tape) {
+    for (var i = 0; i < tape.count; i++) {
+      final entry = tape.entries[i];
+      final sharedKey = entry.sharedKey;
+      if (entry.isDictKey &&
+          sharedKey != _notSharedKey &&
+          !entry.flag &&
+          _getKey(sharedKey) == null) {
+        _setKey(
+          sharedKey,
+          decodeFLString(
+            entry.payload.buf,
+            entry.size,
+            isAscii: entry.isAscii,
+          ),
+        );
+      }
     }
   }
 }
@@ -117,6 +270,30 @@ abstract final class SharedStringsTable {
   /// Decodes the string currently loaded in [source].
   String decode(StringSource source);
 
+  /// Decodes the string loaded in [value].
+  String decodeLoadedValue(CBLDart_LoadedFLValue value) =>
+      _decodeBuffer(
+        value.stringBuf,
+        value.stringSize,
+        isAscii: value.isAscii,
+      );
+
+  /// Decodes the string of [size] bytes at [address].
+  ///
+  /// [isAscii] is whether the string is known to contain only ASCII
+  /// characters, which allows it to be decoded faster.
+  String _decodeBuffer(int address, int size, {required bool isAscii});
+
+  /// The native interner which should be used when writing tapes, if any.
+  Pointer<CBLDart_FLStringInterner>? get _interner => null;
+
+  /// Decodes the string of the tape [entry].
+  String _decodeTapeString(CBLDart_FLTapeEntry entry) => _decodeBuffer(
+        entry.payload.buf,
+        entry.size,
+        isAscii: entry.isAscii,
+      );
+
   /// Returns whether the given [string] has been decoded as a shared string.
   bool hasString(String string);
 }
@@ -130,19 +307,26 @@ final class NoopSharedStringsTable extends SharedStringsTable {
   String decode(StringSource source) {
     final int size;
     final int address;
+    final bool isAscii;
     switch (source) {
       case StringSource.dictKey:
         size = globalLoadedDictKey.ref.stringSize;
         address = globalLoadedDictKey.ref.stringBuf;
+        isAscii = globalLoadedDictKey.ref.isAscii;
         break;
       case StringSource.value:
         size = globalLoadedFLValue.ref.stringSize;
         address = globalLoadedFLValue.ref.stringBuf;
+        isAscii = globalLoadedFLValue.ref.isAscii;
         break;
     }
-    return decodeFLString(address, size);
+    return decodeFLString(address, size, isAscii: isAscii);
   }
 
+  @override
+  String _decodeBuffer(int address, int size, {required bool isAscii}) =>
+      decodeFLString(address, size, isAscii: isAscii);
+
   @override
   bool hasString(String string) => false;
 }
@@ -167,30 +351,126 @@ final class _SharedStringsTable extends SharedStringsTable {
   String decode(StringSource source) {
     final int size;
     final int address;
+    final bool isAscii;
     switch (source) {
       case StringSource.dictKey:
         size = _loadedKey.stringSize;
         address = _loadedKey.stringBuf;
+        isAscii = _loadedKey.isAscii;
         break;
       case StringSource.value:
         size = _loadedValue.stringSize;
         address = _loadedValue.stringBuf;
+        isAscii = _loadedValue.isAscii;
         break;
     }
 
+    return _decodeBuffer(address, size, isAscii: isAscii);
+  }
+
+  @override
+  String _decodeBuffer(int address, int size, {required bool isAscii}) {
     if (size < _minSharedStringSize || size > _maxSharedStringSize) {
-      return decodeFLString(address, size);
+      return decodeFLString(address, size, isAscii: isAscii);
     }
 
-    return _sharedStrings[address] ??= decodeFLString(address, size);
+    return _sharedStrings[address] ??=
+        decodeFLString(address, size, isAscii: isAscii);
   }
 
   @override
   bool hasString(String string) => _sharedStrings.containsValue(string);
 }
 
+/// A [SharedStringsTable] which identifies strings by their content instead
+/// of their address.
+///
+/// Strings which are decoded from tapes are interned in a native interner,
+/// which assigns them small integer ids. Each interned string is only decoded
+/// once and then looked up by its id. Strings which are decoded by other
+/// means are decoded every time they are requested.
+///
+/// Since strings are identified by their content, an
+/// [InterningSharedStringsTable] can be used with multiple instances of Fleece
+/// data, which also can be mutable.
+final class InterningSharedStringsTable extends SharedStringsTable
+    implements Finalizable {
+  InterningSharedStringsTable() : super._();
+
+  @override
+  late final Pointer<CBLDart_FLStringInterner> _interner =
+      _decoderBinds.createStringInterner(this);
+
+  final _strings = <String?>[];
+
+  @override
+  String decode(StringSource source) =>
+      const NoopSharedStringsTable().decode(source);
+
+  @override
+  String _decodeBuffer(int address, int size, {required bool isAscii}) =>
+      decodeFLString(address, size, isAscii: isAscii);
+
+  @override
+  String _decodeTapeString(CBLDart_FLTapeEntry entry) {
+    final id = entry.sharedKey;
+    if (id < 0) {
+      return super._decodeTapeString(entry);
+    }
+
+    if (id >= _strings.length) {
+      _strings.length = id + 1;
+    }
+    return _strings[id] ??= super._decodeTapeString(entry);
+  }
+
+  @override
+  bool hasString(String string) => _strings.contains(string);
+}
+
 // === Iterators ===============================================================
 
+/// A pool of buffers for loading batches of an iterator.
+///
+/// Decoding nested containers creates an iterator for each container. The
+/// buffers of iterators which are consumed completely are returned to the
+/// pool once the iterator is done, so that steady state decoding does not
+/// allocate buffers.
+final class _BatchBufferPool {
+  _BatchBufferPool(this._elementSize);
+
+  /// The number of elements each pooled buffer has room for.
+  static const capacity = 64;
+
+  static const _maxFreeBuffers = 64;
+
+  final int _elementSize;
+  final _freeBuffers = <SliceResult>[];
+
+  SliceResult acquire() => _freeBuffers.isEmpty
+      ? SliceResult(capacity * _elementSize)
+      : _freeBuffers.removeLast();
+
+  void release(SliceResult buffer) {
+    if (_freeBuffers.length < _maxFreeBuffers) {
+      _freeBuffers.add(buffer);
+    }
+  }
+}
+
+final _keysBatchPool = _BatchBufferPool(sizeOf<CBLDart_LoadedDictKey>());
+final _valuesBatchPool = _BatchBufferPool(sizeOf<CBLDart_LoadedFLValue>());
+
+/// An iterator over the entries of a Fleece dict.
+///
+/// If [batchSize] is greater than `1`, keys and values are loaded in batches
+/// of up to [batchSize] entries into buffers owned by the iterator, which
+/// reduces the number of native calls. In this case [keyOut] and [valueOut]
+/// are not used and the current entry has to be accessed through [loadedKey]
+/// and [loadedValue].
+///
+/// If the iterator is not [partiallyConsumable], it has to be consumed
+/// completely and its buffers are reused by later iterators.
 // ignore: prefer_void_to_null
 final class DictIterator implements Iterator<Null>, Finalizable {
   DictIterator(
@@ -199,50 +479,292 @@ final class DictIterator implements Iterator<Null>, Finalizable {
     Pointer<CBLDart_LoadedDictKey>? keyOut,
     Pointer<CBLDart_LoadedFLValue>? valueOut,
     bool preLoad = true,
+    int batchSize = 1,
     bool partiallyConsumable = true,
-  }) : _sharedKeysTable = sharedKeysTable {
+  })  : assert(batchSize >= 1),
+        _sharedKeysTable = sharedKeysTable,
+        _batchSize = batchSize,
+        _pooled =
+            !partiallyConsumable && batchSize <= _BatchBufferPool.capacity {
+    if (batchSize > 1) {
+      final keysBatch = _keysBatch = _pooled
+          ? _keysBatchPool.acquire()
+          : SliceResult(batchSize * sizeOf<CBLDart_LoadedDictKey>());
+      final valuesBatch = _valuesBatch = _pooled
+          ? _valuesBatchPool.acquire()
+          : SliceResult(batchSize * sizeOf<CBLDart_LoadedFLValue>());
+      _keys = keysBatch.buf.cast();
+      _values = valuesBatch.buf.cast();
+    } else {
+      _keys = keyOut ?? nullptr;
+      _values = valueOut ?? nullptr;
+    }
+
     _iterator = _decoderBinds.dictIteratorBegin(
       partiallyConsumable ? this : null,
       dict,
       _sharedKeysTable?._knownSharedKeys ?? nullptr,
-      keyOut ?? nullptr,
-      valueOut ?? nullptr,
+      _keysBatch == null ? _keys : nullptr,
+      _valuesBatch == null ? _values : nullptr,
       preLoad: preLoad,
     );
   }
 
   final SharedKeysTable? _sharedKeysTable;
+  final int _batchSize;
+  final bool _pooled;
+  SliceResult? _keysBatch;
+  SliceResult? _valuesBatch;
+  late final Pointer<CBLDart_LoadedDictKey> _keys;
+  late final Pointer<CBLDart_LoadedFLValue> _values;
+  var _batchLength = 0;
+  var _batchIndex = 0;
+  var _isDone = false;
 
   late final Pointer<CBLDart_FLDictIterator> _iterator;
 
+  /// The loaded key of the current entry.
+  ///
+  /// Only available if entries are loaded in batches or a `keyOut` has been
+  /// provided.
+  CBLDart_LoadedDictKey get loadedKey => _keys[_batchIndex];
+
+  /// The loaded value of the current entry.
+  ///
+  /// Only available if entries are loaded in batches or a `valueOut` has been
+  /// provided.
+  CBLDart_LoadedFLValue get loadedValue => _values[_batchIndex];
+
   @override
   Null get current => null;
 
   @override
-  bool moveNext() => _decoderBinds.dictIteratorNext(_iterator);
+  bool moveNext() {
+    if (_keysBatch == null) {
+      return _decoderBinds.dictIteratorNext(_iterator);
+    }
+
+    if (++_batchIndex < _batchLength) {
+      return true;
+    }
+
+    if (_isDone) {
+      return false;
+    }
+
+    _batchIndex = 0;
+    _batchLength = _decoderBinds.dictIteratorNextBatch(
+      _iterator,
+      _keys,
+      _values,
+      _batchSize,
+    );
+    _sharedKeysTable?._registerLoadedKeys(_keys, _batchLength);
+    _isDone = _batchLength == 0;
+    if (_isDone && _pooled) {
+      _keysBatchPool.release(_keysBatch!);
+      _valuesBatchPool.release(_valuesBatch!);
+    }
+    return !_isDone;
+  }
 }
 
+/// An iterator over the values of a Fleece array.
+///
+/// If [batchSize] is greater than `1`, values are loaded in batches of up to
+/// [batchSize] values into a buffer owned by the iterator, which reduces the
+/// number of native calls. In this case [valueOut] is not used and the value
+/// of the current element has to be accessed through [loadedValue].
+///
+/// If the iterator is not [partiallyConsumable], it has to be consumed
+/// completely and its buffer is reused by later iterators.
 // ignore: prefer_void_to_null
 final class ArrayIterator implements Iterator<Null>, Finalizable {
   ArrayIterator(
     Pointer<FLArray> array, {
     Pointer<CBLDart_LoadedFLValue>? valueOut,
+    int batchSize = 1,
     bool partiallyConsumable = true,
-  }) {
+  })  : assert(batchSize >= 1),
+        _batchSize = batchSize,
+        _pooled =
+            !partiallyConsumable && batchSize <= _BatchBufferPool.capacity {
+    if (batchSize > 1) {
+      final batch = _batch = _pooled
+          ? _valuesBatchPool.acquire()
+          : SliceResult(batchSize * sizeOf<CBLDart_LoadedFLValue>());
+      _values = batch.buf.cast();
+    } else {
+      _values = valueOut ?? nullptr;
+    }
+
     _iterator = _decoderBinds.arrayIteratorBegin(
       partiallyConsumable ? this : null,
       array,
-      valueOut ?? nullptr,
+      _batch == null ? _values : nullptr,
     );
   }
 
+  final int _batchSize;
+  final bool _pooled;
+  SliceResult? _batch;
+  late final Pointer<CBLDart_LoadedFLValue> _values;
+  var _batchLength = 0;
+  var _batchIndex = 0;
+  var _isDone = false;
+
   late final Pointer<CBLDart_FLArrayIterator> _iterator;
 
+  /// The loaded value of the current element.
+  ///
+  /// Only available if values are loaded in batches or a `valueOut` has been
+  /// provided.
+  CBLDart_LoadedFLValue get loadedValue => _values[_batchIndex];
+
   @override
   Null get current => null;
 
   @override
-  bool moveNext() => _decoderBinds.arrayIteratorNext(_iterator);
+  bool moveNext() {
+    if (_batch == null) {
+      return _decoderBinds.arrayIteratorNext(_iterator);
+    }
+
+    if (++_batchIndex < _batchLength) {
+      return true;
+    }
+
+    if (_isDone) {
+      return false;
+    }
+
+    _batchIndex = 0;
+    _batchLength =
+        _decoderBinds.arrayIteratorNextBatch(_iterator, _values, _batchSize);
+    _isDone = _batchLength == 0;
+    if (_isDone && _pooled) {
+      _valuesBatchPool.release(_batch!);
+    }
+    return !_isDone;
+  }
+}
+
+// === Tape ====================================================================
+
+final class _Tape implements Finalizable {
+  _Tape() {
+    pointer = _decoderBinds.createTape(this);
+  }
+
+  late final Pointer<CBLDart_FLTape> pointer;
+}
+
+/// The tape which is reused by [FleeceTapeDecoder]s, to avoid allocating a new
+/// tape for every decoded value.
+final _sharedTape = _Tape();
+var _sharedTapeInUse = false;
+
+/// A decoder which deeply decodes a Fleece value into Dart objects.
+///
+/// The value is first flattened into a tape by a single native call, from which
+/// the Dart objects are then built. This avoids a native call for every
+/// decoded value.
+final class FleeceTapeDecoder {
+  /// Creates a decoder which deeply decodes a Fleece value into Dart objects.
+  ///
+  /// If [undefinedAsNull] is `true`, `undefined` values are decoded as `null`,
+  /// instead of throwing an [UnsupportedError].
+  ///
+  /// If provided, [dictConverter] is used to convert the [Map]s of decoded
+  /// dicts, before they are added to the result.
+  FleeceTapeDecoder({
+    SharedKeysTable? sharedKeysTable,
+    SharedStringsTable? sharedStringsTable,
+    this.undefinedAsNull = false,
+    this.dictConverter,
+  })  : sharedKeysTable = sharedKeysTable ?? const NoopSharedKeysTable(),
+        sharedStringsTable = sharedStringsTable ?? SharedStringsTable();
+
+  final SharedKeysTable sharedKeysTable;
+  final SharedStringsTable sharedStringsTable;
+  final bool undefinedAsNull;
+  final Object? Function(Map<String, Object?> dict)? dictConverter;
+
+  late Pointer<CBLDart_FLTapeEntry> _entries;
+  var _index = 0;
+
+  /// Deeply decodes [value] into Dart objects.
+  Object? decode(Pointer<FLValue> value) {
+    // Decoding does not call back into code which could use the shared tape,
+    // except for the dictConverter.
+    final useSharedTape = !_sharedTapeInUse;
+    final tape = useSharedTape ? _sharedTape : _Tape();
+    _sharedTapeInUse = true;
+
+    try {
+      try {
+        _decoderBinds.writeTape(
+          tape.pointer,
+          value,
+          sharedKeysTable._knownSharedKeys ?? nullptr,
+          sharedStringsTable._interner ?? nullptr,
+        );
+
+        _entries = tape.pointer.ref.entries;
+        _index = 0;
+
+        return _readValue();
+        // ignore: avoid_catches_without_on_clauses
+      } catch (e) {
+        sharedKeysTable._registerTapeKeys(tape.pointer.ref);
+        rethrow;
+      }
+    } finally {
+      if (useSharedTape) {
+        _sharedTapeInUse = false;
+      }
+      cblReachabilityFence(tape);
+      cblReachabilityFence(sharedStringsTable);
+    }
+  }
+
+  Object? _readValue() {
+    final entry = _entries[_index++];
+    switch (entry.valueType) {
+      case FLValueType.undefined:
+        if (undefinedAsNull) {
+          return null;
+        }
+        _throwUndefinedDartRepresentation();
+      case FLValueType.null_:
+        return null;
+      case FLValueType.boolean:
+        return entry.flag;
+      case FLValueType.number:
+        return entry.flag ? entry.payload.asInt : entry.payload.asDouble;
+      case FLValueType.string:
+        return sharedStringsTable._decodeTapeString(entry);
+      case FLValueType.data:
+        return Uint8List.fromList(
+          Pointer<Uint8>.fromAddress(entry.payload.buf)
+              .asTypedList(entry.size),
+        );
+      case FLValueType.array:
+        return List<Object?>.generate(entry.size, (_) => _readValue());
+      case FLValueType.dict:
+        final length = entry.size;
+        final result = <String, Object?>{};
+        for (var i = 0; i < length; i++) {
+          final key = sharedKeysTable._decodeTapeKey(
+            _entries[_index++],
+            sharedStringsTable,
+          );
+          result[key] = _readValue();
+        }
+        final dictConverter = this.dictConverter;
+        return dictConverter != null ? dictConverter(result) : result;
+    }
+  }
 }
 
 // === Decoder =================================================================
@@ -266,6 +788,41 @@ final class FleeceDecoder extends Converter<Data, Object?> {
   final SharedKeysTable? sharedKeysTable;
   final SharedStringsTable? sharedStringsTable;
 
+  @override
+  Object? convert(Data input) {
+    final doc = Doc.fromResultData(input, trust, sharedKeys: sharedKeys);
+    final root = doc.root;
+    if (root.type == ValueType.undefined) {
+      throw ArgumentError('Invalid Fleece data');
+    }
+
+    final result = FleeceTapeDecoder(
+      sharedKeysTable: sharedKeysTable,
+      sharedStringsTable: sharedStringsTable,
+    ).decode(root.pointer);
+    cblReachabilityFence(doc);
+    return result;
+  }
+}
+
+/// Fleece decoder which uses a listener based algorithm to decode Fleece data.
+///
+/// This decoder exists only to benchmark the tape based [FleeceDecoder].
+@Deprecated('Use FleeceDecoder instead.')
+class ListenerFleeceDecoder extends Converter<Data, Object?> {
+  @Deprecated('Use FleeceDecoder instead.')
+  const ListenerFleeceDecoder({
+    this.trust = FLTrust.untrusted,
+    this.sharedKeys,
+    this.sharedKeysTable,
+    this.sharedStringsTable,
+  });
+
+  final FLTrust trust;
+  final SharedKeys? sharedKeys;
+  final SharedKeysTable? sharedKeysTable;
+  final SharedStringsTable? sharedStringsTable;
+
   @override
   Object? convert(Data input) {
     final doc = Doc.fromResultData(input, trust, sharedKeys: sharedKeys);
@@ -289,7 +846,7 @@ final class FleeceDecoder extends Converter<Data, Object?> {
 
 /// Fleece decoder which uses a recursive algorithm to decode Fleece data.
 ///
-/// This decoder exists only to benchmark the listener based [FleeceDecoder].
+/// This decoder exists only to benchmark the tape based [FleeceDecoder].
 @Deprecated('Use FleeceDecoder instead.')
 class RecursiveFleeceDecoder extends Converter<Data, Object?> {
   @Deprecated('Use FleeceDecoder instead.')
@@ -398,8 +955,6 @@ final class _FleeceListenerDecoder {
 
   void decodeGlobalLoadedValue() {
     try {
-      final value = globalLoadedFLValue.ref;
-
       while (true) {
         if (!_currentLoader.loadValue()) {
           final parent = _currentLoader.parent;
@@ -412,6 +967,7 @@ final class _FleeceListenerDecoder {
           continue;
         }
 
+        final value = _currentLoader.loadedValue;
         switch (value.type) {
           case FLValueType.undefined:
             _listener.handleUndefined();
@@ -432,7 +988,11 @@ final class _FleeceListenerDecoder {
             break;
           case FLValueType.string:
             _listener.handleString(
-              _sharedStringsTable.decode(StringSource.value),
+              _sharedStringsTable._decodeBuffer(
+                value.stringBuf,
+                value.stringSize,
+                isAscii: value.isAscii,
+              ),
             );
             _currentLoader.handleValue();
             break;
@@ -441,7 +1001,7 @@ final class _FleeceListenerDecoder {
             _currentLoader.handleValue();
             break;
           case FLValueType.array:
-            _currentLoader = _ArrayIndexLoader(
+            _currentLoader = _ArrayIteratorLoader(
               Pointer<FLArray>.fromAddress(value.value),
               value.collectionSize,
               _listener,
@@ -450,6 +1010,7 @@ final class _FleeceListenerDecoder {
           case FLValueType.dict:
             _currentLoader = _DictIteratorLoader(
               Pointer<FLDict>.fromAddress(value.value),
+              value.collectionSize,
               _listener,
               _sharedKeysTable,
               _sharedStringsTable,
@@ -478,6 +1039,9 @@ abstract final class _FleeceValueLoader {
 
   bool loadValue();
 
+  /// The value which has been loaded by the last call to [loadValue].
+  CBLDart_LoadedFLValue get loadedValue => _globalLoadedValue;
+
   void handleValue() {}
 
   void drain() {}
@@ -497,21 +1061,25 @@ final class _InitialValueLoader extends _FleeceValueLoader {
   }
 }
 
-final class _ArrayIndexLoader extends _FleeceValueLoader {
-  _ArrayIndexLoader(this._array, this._length, this._listener) {
-    _listener.beginArray(_length);
+final class _ArrayIteratorLoader extends _FleeceValueLoader {
+  _ArrayIteratorLoader(Pointer<FLArray> array, int length, this._listener)
+      : _it = ArrayIterator(
+          array,
+          valueOut: globalLoadedFLValue,
+          batchSize: length.clamp(1, _maxBatchSize),
+          partiallyConsumable: false,
+        ) {
+    _listener.beginArray(length);
   }
 
-  final Pointer<FLArray> _array;
-  final int _length;
+  static const _maxBatchSize = 64;
+
   final _FleeceListener _listener;
-  var _i = 0;
+  final ArrayIterator _it;
 
   @override
   bool loadValue() {
-    if (_i < _length) {
-      _decoderBinds.getLoadedValueFromArray(_array, _i);
-      _i++;
+    if (_it.moveNext()) {
       return true;
     } else {
       _listener.endArray();
@@ -519,15 +1087,24 @@ final class _ArrayIndexLoader extends _FleeceValueLoader {
     }
   }
 
+  @override
+  CBLDart_LoadedFLValue get loadedValue => _it.loadedValue;
+
   @override
   void handleValue() {
     _listener.arrayElement();
   }
+
+  @override
+  void drain() {
+    while (_it.moveNext()) {}
+  }
 }
 
 final class _DictIteratorLoader extends _FleeceValueLoader {
   _DictIteratorLoader(
     Pointer<FLDict> dict,
+    int length,
     this._listener,
     this._sharedKeysTable,
     this._sharedStringsTable,
@@ -536,11 +1113,14 @@ final class _DictIteratorLoader extends _FleeceValueLoader {
           sharedKeysTable: _sharedKeysTable,
           keyOut: globalLoadedDictKey,
           valueOut: globalLoadedFLValue,
+          batchSize: length.clamp(1, _maxBatchSize),
           partiallyConsumable: false,
         ) {
     _listener.beginObject();
   }
 
+  static const _maxBatchSize = 64;
+
   final _FleeceListener _listener;
   final SharedStringsTable _sharedStringsTable;
   final SharedKeysTable _sharedKeysTable;
@@ -550,7 +1130,9 @@ final class _DictIteratorLoader extends _FleeceValueLoader {
   bool loadValue() {
     if (_it.moveNext()) {
       _listener
-        ..handleString(_sharedKeysTable.decode(_sharedStringsTable))
+        ..handleString(
+          _sharedKeysTable.decodeKey(_it.loadedKey, _sharedStringsTable),
+        )
         ..propertyName();
       return true;
     } else {
@@ -559,6 +1141,9 @@ final class _DictIteratorLoader extends _FleeceValueLoader {
     }
   }
 
+  @override
+  CBLDart_LoadedFLValue get loadedValue => _it.loadedValue;
+
   @override
   void handleValue() {
     _listener.propertyValue();
@@ -112,7 +112,6 @@ abstract interface class DictKeysProvider {
 ///
 /// A [DictKeys] instance must only be used for Fleece data that shares the same
 /// set of shared keys.
-// ignore: one_member_abstracts
 abstract final class DictKeys {
   const DictKeys();
 
@@ -121,6 +120,12 @@ abstract final class DictKeys {
   /// The returned value should not be stored, as subsequent calls might return
   /// a different [DictKey].
   DictKey getKey(String key);
+
+  /// Returns a [DictKey] for the given [key], which is known to be requested
+  /// frequently, such as the key of a typed data property.
+  ///
+  /// The same note as for [getKey] applies here.
+  DictKey getFrequentKey(String key) => getKey(key);
 }
 
 /// A provider of [DictKey]s that does not use optimized keys.
@@ -179,6 +184,21 @@ final class OptimizingDictKeys extends DictKeys {
     }
   }
 
+  /// Unlike keys requested through [getKey], frequent keys are optimized
+  /// on the first request. Wide documents of which only some properties are
+  /// read would otherwise evict the keys from the table of key misses before
+  /// they are ever optimized.
+  @override
+  DictKey getFrequentKey(String key) {
+    var optimizedKey = _optimizedKeyCache[key];
+    if (optimizedKey == null) {
+      _optimizedKeyMisses.remove(key);
+      optimizedKey = _OptimizedDictKey(key);
+      _addKeyToCache(key, optimizedKey);
+    }
+    return optimizedKey;
+  }
+
   bool _shouldOptimizeKey(String key) {
     final optimizedKeyMisses = (_optimizedKeyMisses[key] ?? 0) + 1;
     if (optimizedKeyMisses < _optimizationThreshold) {
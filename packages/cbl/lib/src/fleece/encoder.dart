@@ -33,6 +33,8 @@ final class FleeceEncoder implements Finalizable {
 
   final Pointer<FLEncoder> _pointer;
 
+  final _tape = _EncoderTape();
+
   /// The output format to generate.
   ///
   /// The default is [FLEncoderFormat.fleece]
@@ -55,9 +57,12 @@ final class FleeceEncoder implements Finalizable {
 
   /// Tells the encoder to use a shared-keys mapping when encoding dictionary
   /// keys.
-  void setSharedKeys(SharedKeys? sharedKeys) => runWithErrorTranslation(() {
-        _encoderBinds.setSharedKeys(_pointer, sharedKeys?.pointer ?? nullptr);
-      });
+  void setSharedKeys(SharedKeys? sharedKeys) {
+    flush();
+    runWithErrorTranslation(() {
+      _encoderBinds.setSharedKeys(_pointer, sharedKeys?.pointer ?? nullptr);
+    });
+  }
 
   /// Arbitrary information which needs to be available to code that is using
   /// this encoder.
@@ -116,78 +121,167 @@ final class FleeceEncoder implements Finalizable {
   }
 
   /// Writes the value at [index] in [array] to this encoder.
-  void writeArrayValue(Pointer<FLArray> array, int index) =>
-      runWithErrorTranslation(
-          () => _encoderBinds.writeArrayValue(_pointer, array, index));
+  ///
+  /// {@template cbl.FleeceEncoder.nativeMemory}
+  /// Writes are recorded and only performed by the native encoder when this
+  /// encoder is flushed. The Fleece data which is passed to this method must
+  /// stay valid until then. Use [keepAlive] to ensure that the owner of the
+  /// data stays reachable.
+  /// {@endtemplate}
+  void writeArrayValue(Pointer<FLArray> array, int index) {
+    _tape.writeOpWithPointerAndUint32(
+      _EncoderTapeOp.writeArrayValue,
+      array,
+      index,
+    );
+    _didWrite();
+  }
 
   /// Writes [value] this encoder.
-  void writeValue(Pointer<FLValue> value) =>
-      runWithErrorTranslation(() => _encoderBinds.writeValue(_pointer, value));
+  ///
+  /// {@macro cbl.FleeceEncoder.nativeMemory}
+  void writeValue(Pointer<FLValue> value) {
+    if (value == nullptr) {
+      throw ArgumentError.value(value, 'value', 'must not be `nullptr`');
+    }
+
+    _tape.writeOpWithPointer(_EncoderTapeOp.writeValue, value);
+    _didWrite();
+  }
 
   /// Writes `null` to this encoder.
-  void writeNull() =>
-      runWithErrorTranslation(() => _encoderBinds.writeNull(_pointer));
+  void writeNull() {
+    _tape.writeOp(_EncoderTapeOp.writeNull);
+    _didWrite();
+  }
 
   /// Writes the [bool] [value] to this encoder.
   // ignore: avoid_positional_boolean_parameters
-  void writeBool(bool value) =>
-      runWithErrorTranslation(() => _encoderBinds.writeBool(_pointer, value));
+  void writeBool(bool value) {
+    _tape.writeOp(value ? _EncoderTapeOp.writeTrue : _EncoderTapeOp.writeFalse);
+    _didWrite();
+  }
 
   /// Writes the [int] [value] to this encoder.
-  void writeInt(int value) =>
-      runWithErrorTranslation(() => _encoderBinds.writeInt(_pointer, value));
+  void writeInt(int value) {
+    _tape.writeOpWithInt64(_EncoderTapeOp.writeInt, value);
+    _didWrite();
+  }
 
   /// Writes the [double] [value] to this encoder.
-  void writeDouble(double value) =>
-      runWithErrorTranslation(() => _encoderBinds.writeDouble(_pointer, value));
+  void writeDouble(double value) {
+    _tape.writeOpWithDouble(_EncoderTapeOp.writeDouble, value);
+    _didWrite();
+  }
 
   /// Writes the [String] [value] to this encoder.
-  void writeString(String value) =>
-      runWithErrorTranslation(() => _encoderBinds.writeString(_pointer, value));
+  void writeString(String value) {
+    if (value.length >= _EncoderTape.utf16StringThreshold) {
+      _tape.writeOpWithUtf16String(_EncoderTapeOp.writeUtf16String, value);
+    } else {
+      _tape.writeOpWithString(_EncoderTapeOp.writeString, value);
+    }
+    _didWrite();
+  }
 
   /// Writes the [TypedData] [value] to this encoder.
-  void writeData(Data value) =>
-      runWithErrorTranslation(() => _encoderBinds.writeData(_pointer, value));
+  void writeData(Data value) {
+    _tape.writeOpWithBytes(_EncoderTapeOp.writeData, value.toTypedList());
+    _didWrite();
+  }
 
   /// Writes the UTF-8 encoded JSON string [value] to this encoder.
-  void writeJson(Data value) =>
-      runWithErrorTranslation(() => _encoderBinds.writeJSON(_pointer, value));
+  void writeJson(Data value) {
+    flush();
+    runWithErrorTranslation(() => _encoderBinds.writeJSON(_pointer, value));
+  }
 
   /// Begins an array and reserves space for [reserveLength] element.
-  void beginArray(int reserveLength) => runWithErrorTranslation(
-      () => _encoderBinds.beginArray(_pointer, reserveLength));
+  void beginArray(int reserveLength) {
+    _tape.writeOpWithUint32(_EncoderTapeOp.beginArray, reserveLength);
+    _didWrite();
+  }
 
   /// Ends an array.
-  void endArray() =>
-      runWithErrorTranslation(() => _encoderBinds.endArray(_pointer));
+  void endArray() {
+    _tape.writeOp(_EncoderTapeOp.endArray);
+    _didWrite();
+  }
 
   /// Begins a dict and reserves space for [reserveLength] entries.
-  void beginDict(int reserveLength) => runWithErrorTranslation(
-      () => _encoderBinds.beginDict(_pointer, reserveLength));
+  void beginDict(int reserveLength) {
+    _tape.writeOpWithUint32(_EncoderTapeOp.beginDict, reserveLength);
+    _didWrite();
+  }
 
   /// Writes a [key] for the next entry in a dict.
-  void writeKey(String key) =>
-      runWithErrorTranslation(() => _encoderBinds.writeKey(_pointer, key));
+  void writeKey(String key) {
+    _tape.writeOpWithString(_EncoderTapeOp.writeKey, key);
+    _didWrite();
+  }
 
   /// Writes a [key] for the next entry in a dict, from a [FLString].
-  void writeKeyFLString(FLString key) => runWithErrorTranslation(
-      () => _encoderBinds.writeKeyFLString(_pointer, key));
+  void writeKeyFLString(FLString key) {
+    _tape.writeOpWithBytes(
+      _EncoderTapeOp.writeKey,
+      key.buf.asTypedList(key.size),
+    );
+    _didWrite();
+  }
 
   /// Writes a [key] for the next entry in a dict, from a [FLValue].
-  void writeKeyValue(Pointer<FLValue> key) =>
-      runWithErrorTranslation(() => _encoderBinds.writeKeyValue(_pointer, key));
+  ///
+  /// {@macro cbl.FleeceEncoder.nativeMemory}
+  void writeKeyValue(Pointer<FLValue> key) {
+    _tape.writeOpWithPointer(_EncoderTapeOp.writeKeyValue, key);
+    _didWrite();
+  }
 
   /// Ends a dict.
-  void endDict() =>
-      runWithErrorTranslation(() => _encoderBinds.endDict(_pointer));
+  void endDict() {
+    _tape.writeOp(_EncoderTapeOp.endDict);
+    _didWrite();
+  }
+
+  /// Keeps [object] reachable until the writes which have been made to this
+  /// encoder so far have been flushed.
+  void keepAlive(Object? object) {
+    _tape.keepAlive(object);
+  }
+
+  /// Performs the writes which have been recorded by this encoder with the
+  /// native encoder.
+  ///
+  /// Writes are recorded and performed in batches, to avoid a native call for
+  /// every write. This method is called automatically when enough writes have
+  /// been recorded and when encoding is finished. Errors which are caused by
+  /// writes are thrown by this method.
+  void flush() {
+    if (_tape.isEmpty) {
+      return;
+    }
+
+    try {
+      runWithErrorTranslation(
+        () => _encoderBinds.writeTape(_pointer, _tape.buf, _tape.size),
+      );
+    } finally {
+      _tape.clear();
+    }
+  }
 
   /// Resets this encoder and allows it to be used again.
-  void reset() => runWithErrorTranslation(() => _encoderBinds.reset(_pointer));
+  void reset() {
+    _tape.clear();
+    runWithErrorTranslation(() => _encoderBinds.reset(_pointer));
+  }
 
   /// Finishes encoding and returns the result.
   ///
   /// To begin a new piece of Fleece data call [reset].
   Data finish() {
+    flush();
+
     final result =
         runWithErrorTranslation(() => _encoderBinds.finish(_pointer));
 
@@ -197,4 +291,221 @@ final class FleeceEncoder implements Finalizable {
 
     return result;
   }
+
+  void _didWrite() {
+    if (_tape.size >= _EncoderTape.flushThreshold) {
+      flush();
+    }
+  }
+}
+
+/// The operations which can be recorded in an [_EncoderTape].
+///
+/// Must be kept in sync with `CBLDart_FLEncoderTapeOp` in `Fleece+Dart.h`.
+abstract final class _EncoderTapeOp {
+  static const writeNull = 0;
+  static const writeFalse = 1;
+  static const writeTrue = 2;
+  static const writeInt = 3;
+  static const writeDouble = 4;
+  static const writeString = 5;
+  static const writeData = 6;
+  static const writeValue = 7;
+  static const writeArrayValue = 8;
+  static const beginArray = 9;
+  static const endArray = 10;
+  static const beginDict = 11;
+  static const writeKey = 12;
+  static const writeKeyValue = 13;
+  static const endDict = 14;
+  static const writeUtf16String = 15;
+}
+
+/// A buffer in native memory, in which writes to a [FleeceEncoder] are
+/// recorded, so that they can be replayed with a single native call.
+final class _EncoderTape {
+  _EncoderTape() {
+    _allocate(_initialCapacity);
+  }
+
+  static const _initialCapacity = 1024;
+
+  /// The size at which a [FleeceEncoder] flushes its tape.
+  static const flushThreshold = 64 * 1024;
+
+  /// The length from which strings are recorded as UTF-16 code units, which
+  /// are transcoded to UTF-8 natively, instead of being encoded to UTF-8 in
+  /// Dart.
+  ///
+  /// Copying the code units of a string is cheaper than encoding it in Dart,
+  /// but for short strings the difference does not make up for the larger
+  /// size of the tape.
+  static const utf16StringThreshold = 64;
+
+  static final _pointerSize = sizeOf<IntPtr>();
+
+  late SliceResult _buffer;
+  late Uint8List _bytes;
+  late ByteData _data;
+  var _size = 0;
+
+  final _keepAlive = <Object?>[];
+
+  Pointer<Uint8> get buf => _buffer.buf;
+
+  int get size => _size;
+
+  bool get isEmpty => _size == 0;
+
+  void keepAlive(Object? object) {
+    _keepAlive.add(object);
+  }
+
+  void clear() {
+    _size = 0;
+    _keepAlive.clear();
+  }
+
+  void writeOp(int op) {
+    _ensureCapacity(1);
+    _bytes[_size++] = op;
+  }
+
+  void writeOpWithUint32(int op, int value) {
+    _ensureCapacity(5);
+    _bytes[_size] = op;
+    _data.setUint32(_size + 1, value, Endian.host);
+    _size += 5;
+  }
+
+  void writeOpWithInt64(int op, int value) {
+    _ensureCapacity(9);
+    _bytes[_size] = op;
+    _data.setInt64(_size + 1, value, Endian.host);
+    _size += 9;
+  }
+
+  void writeOpWithDouble(int op, double value) {
+    _ensureCapacity(9);
+    _bytes[_size] = op;
+    _data.setFloat64(_size + 1, value, Endian.host);
+    _size += 9;
+  }
+
+  void writeOpWithPointer(int op, Pointer<NativeType> pointer) {
+    _ensureCapacity(1 + _pointerSize);
+    _bytes[_size++] = op;
+    _writePointer(pointer);
+  }
+
+  void writeOpWithPointerAndUint32(
+    int op,
+    Pointer<NativeType> pointer,
+    int value,
+  ) {
+    _ensureCapacity(5 + _pointerSize);
+    _bytes[_size++] = op;
+    _writePointer(pointer);
+    _data.setUint32(_size, value, Endian.host);
+    _size += 4;
+  }
+
+  void writeOpWithBytes(int op, Uint8List bytes) {
+    final length = bytes.length;
+    _ensureCapacity(5 + length);
+    _bytes[_size] = op;
+    _data.setUint32(_size + 1, length, Endian.host);
+    _bytes.setRange(_size + 5, _size + 5 + length, bytes);
+    _size += 5 + length;
+  }
+
+  void writeOpWithString(int op, String string) {
+    final allocationSize = nativeUtf8StringEncoder.encodedAllocationSize(
+      string,
+    );
+    _ensureCapacity(5 + allocationSize);
+    final encoded = nativeUtf8StringEncoder.encodeToBuffer(
+      string,
+      _buffer.buf + _size + 5,
+      allocationSize: allocationSize,
+      end: string.length,
+    );
+    _bytes[_size] = op;
+    _data.setUint32(_size + 1, encoded.size, Endian.host);
+    _size += 5 + encoded.size;
+  }
+
+  void writeOpWithUtf16String(int op, String string) {
+    final length = string.length;
+    _ensureCapacity(5 + length * 2);
+    _bytes[_size] = op;
+    _data.setUint32(_size + 1, length, Endian.host);
+    var offset = _size + 5;
+    for (var i = 0; i < length; i++) {
+      _data.setUint16(offset, string.codeUnitAt(i), Endian.host);
+      offset += 2;
+    }
+    _size = offset;
+  }
+
+  void _writePointer(Pointer<NativeType> pointer) {
+    if (_pointerSize == 8) {
+      _data.setUint64(_size, pointer.address, Endian.host);
+    } else {
+      _data.setUint32(_size, pointer.address, Endian.host);
+    }
+    _size += _pointerSize;
+  }
+
+  void _ensureCapacity(int additionalSize) {
+    final requiredSize = _size + additionalSize;
+    var capacity = _bytes.length;
+    if (requiredSize <= capacity) {
+      return;
+    }
+
+    while (capacity < requiredSize) {
+      capacity *= 2;
+    }
+
+    final oldBuffer = _buffer;
+    final oldBytes = _bytes;
+    _allocate(capacity);
+    _bytes.setRange(0, _size, oldBytes);
+    cblReachabilityFence(oldBuffer);
+  }
+
+  void _allocate(int capacity) {
+    _buffer = SliceResult(capacity);
+    _bytes = _buffer.asTypedList();
+    _data = ByteData.sublistView(_bytes);
+  }
+}
+
+/// A native buffer into which Fleece data is written as JSON.
+///
+/// The buffer is meant to be reused for writing multiple chunks of JSON, to
+/// avoid allocating new native memory for every chunk.
+final class JsonBuffer implements Finalizable {
+  JsonBuffer() {
+    pointer = _encoderBinds.createJsonBuffer(this);
+  }
+
+  late final Pointer<CBLDart_FLJSONBuffer> pointer;
+
+  /// Whether this buffer contains no bytes.
+  bool get isEmpty {
+    final result = pointer.ref.size == 0;
+    cblReachabilityFence(this);
+    return result;
+  }
+
+  /// Returns a copy of the bytes in this buffer and clears it.
+  Uint8List takeBytes() {
+    final buffer = pointer.ref;
+    final result = Uint8List.fromList(buffer.buf.asTypedList(buffer.size));
+    _encoderBinds.clearJsonBuffer(pointer);
+    cblReachabilityFence(this);
+    return result;
+  }
 }
@@ -36,6 +36,9 @@ final class MArray extends MCollection {
   final Pointer<FLArray>? _array;
   final List<MValue?> _values;
 
+  /// The Fleece array this array is backed by, if any.
+  Pointer<FLArray>? get flArray => _array;
+
   int get length => _values.length;
 
   MValue? get(int index) {
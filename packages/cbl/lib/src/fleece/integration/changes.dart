@@ -0,0 +1,100 @@
+import 'dart:async';
+
+import '../../support/utils.dart';
+import '../containers.dart';
+import '../encoder.dart';
+import 'delegate.dart';
+import 'dict.dart';
+import 'value.dart';
+
+/// The changes which have been made to an [MDict], relative to the Fleece
+/// dict it is backed by.
+///
+/// Only the values which have been set are encoded. Nested dicts which have
+/// been changed are updated in place, so that the cost of writing the changes
+/// to a mutable copy of the Fleece dict is proportional to the size of the
+/// changes and not to the size of the dict.
+///
+/// Arrays which have been changed are encoded as a whole, since inserting and
+/// removing elements shifts the indices of all following elements.
+final class MDictChanges {
+  MDictChanges._();
+
+  /// Collects the changes which have been made to [dict], or returns `null`
+  /// if [dict] is not backed by a Fleece dict or has been cleared, in which
+  /// case it has to be encoded as a whole.
+  static MDictChanges? of(MDict dict) {
+    if (dict.flDict == null || dict.wasCleared) {
+      return null;
+    }
+
+    final changes = MDictChanges._();
+    for (final MapEntry(:key, :value) in dict.loadedEntries) {
+      if (value.isEmpty) {
+        changes._removedKeys.add(key);
+      } else if (value.isMutated) {
+        final collection =
+            MDelegate.instance!.collectionFromNative(value.asNative(dict));
+        if (collection is MDict && collection.isChildOf(dict, value)) {
+          if (collection.isMutated) {
+            final childChanges = MDictChanges.of(collection);
+            if (childChanges != null) {
+              changes._changedDicts[key] = childChanges;
+            } else {
+              changes._setValues[key] = value;
+            }
+          }
+        } else {
+          changes._setValues[key] = value;
+        }
+      }
+    }
+    return changes;
+  }
+
+  final _removedKeys = <String>[];
+  final _setValues = <String, MValue>{};
+  final _changedDicts = <String, MDictChanges>{};
+
+  /// Whether no changes have been made to the dict.
+  bool get isEmpty =>
+      _removedKeys.isEmpty && _setValues.isEmpty && _changedDicts.isEmpty;
+
+  /// The values which have been set, in the order in which they are encoded
+  /// and applied.
+  Iterable<MValue> get _values sync* {
+    yield* _setValues.values;
+    for (final changes in _changedDicts.values) {
+      yield* changes._values;
+    }
+  }
+
+  /// Encodes the values which have been set, as a Fleece array.
+  FutureOr<void> encodeTo(FleeceEncoder encoder) => syncOrAsync(() sync* {
+        encoder.beginArray(_values.length);
+        for (final value in _values) {
+          yield value.encodeTo(encoder);
+        }
+        encoder.endArray();
+      }());
+
+  /// Applies the changes to [dict], which must be a mutable copy of the
+  /// Fleece dict the changed [MDict] is backed by.
+  ///
+  /// [values] must be the array which has been encoded by [encodeTo].
+  void applyTo(MutableDict dict, Array values) =>
+      _applyTo(dict, values.iterator);
+
+  void _applyTo(MutableDict dict, Iterator<Value> values) {
+    for (final key in _removedKeys) {
+      dict.remove(key);
+    }
+    for (final key in _setValues.keys) {
+      values.moveNext();
+      dict[key] = values.current;
+    }
+    for (final MapEntry(:key, value: changes) in _changedDicts.entries) {
+      changes._applyTo(dict.mutableDict(key)!, values);
+    }
+  }
+}
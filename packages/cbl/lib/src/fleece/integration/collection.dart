@@ -47,13 +47,18 @@ abstract base class MCollection {
 
   bool get isMutated => _isMutated;
 
+  /// Whether this collection is the value of [slot] in [parent] and was
+  /// created from the Fleece value of that slot.
+  bool isChildOf(MCollection parent, MValue slot) =>
+      identical(_parent, parent) && identical(_slot, slot);
+
   Iterable<MValue> get values;
 
   FutureOr<void> encodeTo(FleeceEncoder encoder) =>
       performEncodeTo(encoder).then((_) {
-        // We keep the context alive until the end of encoding, so that
-        // MCollections can safely use Fleece data during encoding.
-        cblReachabilityFence(context);
+        // We keep the context alive until the encoder has performed the
+        // writes, so that MCollections can safely write Fleece data to it.
+        encoder.keepAlive(context);
       });
 
   FutureOr<void> performEncodeTo(FleeceEncoder encoder);
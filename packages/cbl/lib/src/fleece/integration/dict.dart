@@ -9,12 +9,15 @@ import '../encoder.dart';
 import 'collection.dart';
 import 'value.dart';
 
+final _decoderBinds = cblBindings.fleece.decoder;
+
 final class MDict extends MCollection {
   MDict()
       : _dict = null,
         _values = {},
         _length = 0,
-        _valuesHasAllKeys = true;
+        _valuesHasAllKeys = true,
+        _wasCleared = false;
 
   MDict.asCopy(MDict super.original, {bool? isMutable})
       : _dict = original._dict,
@@ -24,6 +27,7 @@ final class MDict extends MCollection {
         ),
         _length = original._length,
         _valuesHasAllKeys = original._valuesHasAllKeys,
+        _wasCleared = original._wasCleared,
         super.asCopy(isMutable: isMutable ?? original.isMutable);
 
   MDict.asChild(super.slot, super.parent, int length, {bool? isMutable})
@@ -31,10 +35,15 @@ final class MDict extends MCollection {
         _values = {},
         _length = length,
         _valuesHasAllKeys = false,
+        _wasCleared = false,
         super.asChild(
           isMutable: isMutable ?? parent.hasMutableChildren,
         );
 
+  /// The maximum number of entries which are loaded at once when iterating
+  /// over [_dict].
+  static const _maxIteratorBatchSize = 64;
+
   final Pointer<FLDict>? _dict;
   final Map<String, MValue> _values;
   int _length;
@@ -42,6 +51,17 @@ final class MDict extends MCollection {
   /// Whether [_values] contains all the keys of [_dict].
   bool _valuesHasAllKeys;
 
+  bool _wasCleared;
+
+  /// Whether this dict has been cleared since it was loaded from [flDict].
+  ///
+  /// After this dict has been cleared, [_values] no longer records which keys
+  /// of [flDict] have been removed, if it already contained all of them.
+  bool get wasCleared => _wasCleared;
+
+  /// The Fleece dict this dict is backed by, if any.
+  Pointer<FLDict>? get flDict => _dict;
+
   int get length => _length;
 
   bool contains(String key) => _getValue(key).isNotEmpty;
@@ -51,6 +71,52 @@ final class MDict extends MCollection {
     return value.isNotEmpty ? value : null;
   }
 
+  /// The value which [getScalar] returns when a value cannot be read as a
+  /// scalar.
+  static const notScalar = Object();
+
+  /// Reads the value for [key] directly from the Fleece dict this dict is
+  /// backed by, if it is a scalar, without creating and caching an [MValue]
+  /// for it.
+  ///
+  /// Returns `null` if the value is `null` or does not exist. Returns
+  /// [notScalar] if the value has already been loaded or changed, or is not a
+  /// boolean, number or string, in which case it has to be read through [get].
+  Object? getScalar(String key) {
+    final dict = _dict;
+    if (dict == null || _values.containsKey(key)) {
+      return notScalar;
+    }
+
+    final flValue = context.dictKeys.getFrequentKey(key).getValue(dict);
+    if (flValue == null) {
+      cblReachabilityFence(context);
+      return null;
+    }
+
+    _decoderBinds.getLoadedValue(flValue);
+    final loadedValue = globalLoadedFLValue.ref;
+    final Object? result;
+    switch (loadedValue.type) {
+      case FLValueType.undefined:
+      case FLValueType.null_:
+        result = null;
+      case FLValueType.boolean:
+        result = loadedValue.asBool;
+      case FLValueType.number:
+        result =
+            loadedValue.isInteger ? loadedValue.asInt : loadedValue.asDouble;
+      case FLValueType.string:
+        result = context.sharedStringsTable.decode(StringSource.value);
+      case FLValueType.data:
+      case FLValueType.array:
+      case FLValueType.dict:
+        result = notScalar;
+    }
+    cblReachabilityFence(context);
+    return result;
+  }
+
   void set(String key, Object? native) {
     assert(isMutable);
 
@@ -87,6 +153,7 @@ final class MDict extends MCollection {
     }
     _values.clear();
     _length = 0;
+    _wasCleared = true;
 
     // Shadow all keys in _dict with empty MValue.
     if (!_valuesHasAllKeys) {
@@ -143,6 +210,10 @@ final class MDict extends MCollection {
   @override
   Iterable<MValue> get values => _values.values;
 
+  /// The entries which have been loaded from [flDict] or set in this dict,
+  /// including empty values for entries which have been removed.
+  Iterable<MapEntry<String, MValue>> get loadedEntries => _values.entries;
+
   Iterable<MapEntry<String, MValue>> get iterable sync* {
     // Iterate over entries in _values.
     for (final entry in _values.entries) {
@@ -166,12 +237,12 @@ final class MDict extends MCollection {
       keyOut: globalLoadedDictKey,
       valueOut: globalLoadedFLValue,
       preLoad: false,
+      batchSize: _length.clamp(1, _maxIteratorBatchSize),
       partiallyConsumable: false,
     );
-    final loadedKey = globalLoadedDictKey.ref;
-    final loadedValue = globalLoadedFLValue.ref;
     while (it.moveNext()) {
-      final key = sharedKeysTable.decode(sharedStringsTable);
+      final loadedKey = it.loadedKey;
+      final key = sharedKeysTable.decodeKey(loadedKey, sharedStringsTable);
 
       // Skip over entries which are shadowed by _values
       if (_values.containsKey(key)) {
@@ -181,7 +252,7 @@ final class MDict extends MCollection {
       // Cache the value to speed up lookups later.
       final value = _values[key] = _MValueWithKey(
         loadedKey.value,
-        Pointer<FLValue>.fromAddress(loadedValue.value),
+        Pointer<FLValue>.fromAddress(it.loadedValue.value),
       );
       yield MapEntry(key, value);
     }
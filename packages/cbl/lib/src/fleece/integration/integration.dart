@@ -1,4 +1,5 @@
 export 'array.dart';
+export 'changes.dart';
 export 'collection.dart';
 export 'context.dart';
 export 'delegate.dart';
@@ -58,6 +58,35 @@ abstract base class Logger {
     }
   }
 
+  final _domainLevels = <LogDomain, LogLevel>{};
+
+  /// The minimum log level for which [log] will be called with messages of
+  /// [domain].
+  ///
+  /// This is the level set with [setDomainLevel] for [domain], or [level] if
+  /// no level has been set for it.
+  LogLevel levelForDomain(LogDomain domain) => _domainLevels[domain] ?? _level;
+
+  /// Sets the minimum log level for which [log] will be called with messages
+  /// of [domain], overriding [level] for that domain.
+  ///
+  /// Passing `null` removes the override, so that [level] applies again.
+  ///
+  /// Messages are filtered by their domain before they are delivered to Dart,
+  /// so that for example verbose [LogDomain.replicator] logs can be enabled
+  /// without paying for verbose logs of the other domains.
+  void setDomainLevel(LogDomain domain, LogLevel? level) {
+    final previousLevel = levelForDomain(domain);
+    if (level == null) {
+      _domainLevels.remove(domain);
+    } else {
+      _domainLevels[domain] = level;
+    }
+    if (levelForDomain(domain) != previousLevel) {
+      _levelChanged?.call();
+    }
+  }
+
   /// The callback which is invoked for each log message.
   void log(LogLevel level, LogDomain domain, String message);
 }
@@ -143,12 +172,14 @@ void _setupLogger(Logger logger) {
   // The AsyncCallback is not created every time a Logger is set.
   // The Logger should still be called in the Zone in which it was set.
   _loggerCallback = Zone.current.bindUnaryCallbackGuarded((arguments) {
-    final message = LogCallbackMessage.fromArguments(arguments);
-    logger.log(
-      message.level.toLogLevel(),
-      message.domain.toLogDomain(),
-      message.message,
-    );
+    // The native side delivers log messages in batches.
+    for (final message in LogCallbackMessage.batchFromArguments(arguments)) {
+      logger.log(
+        message.level.toLogLevel(),
+        message.domain.toLogDomain(),
+        message.message,
+      );
+    }
   });
   _logger!._levelChanged = _updateLogLevel;
   _updateLogLevel();
@@ -160,8 +191,14 @@ void _cleanUpLogger() {
   _logger = null;
 }
 
-void _updateLogLevel() =>
-    _bindings.setCallbackLevel(_logger!._level.toCBLLogLevel());
+void _updateLogLevel() {
+  for (final domain in LogDomain.values) {
+    _bindings.setCallbackDomainLevel(
+      domain.toCBLLogDomain(),
+      _logger!.levelForDomain(domain).toCBLLogLevel(),
+    );
+  }
+}
 
 void _setupCallback() {
   if (_callback != null) {
@@ -171,6 +208,7 @@ void _setupCallback() {
   _callback = AsyncCallback(
     (arguments) => _loggerCallback!(arguments),
     debugName: 'Logger.log',
+    maxBatchSize: AsyncCallback.listenerMaxBatchSize,
   );
 
   // Try to set callback as the current global callback.
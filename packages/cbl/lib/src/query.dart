@@ -18,9 +18,11 @@ export 'query/functions/array_function.dart' show ArrayFunction;
 export 'query/functions/full_text_function.dart' show FullTextFunction;
 export 'query/group_by.dart' show SyncGroupBy, GroupBy, AsyncGroupBy;
 export 'query/having.dart' show SyncHaving, Having, AsyncHaving;
-export 'query/index/index.dart' show Index, FullTextLanguage;
+export 'query/index/index.dart'
+    show DistanceMetric, FullTextLanguage, Index, ScalarQuantizerType;
 export 'query/index/index_builder.dart'
     show
+        ArrayIndex,
         FullTextIndex,
         FullTextIndexItem,
         IndexBuilder,
@@ -28,9 +30,12 @@ export 'query/index/index_builder.dart'
         ValueIndexItem;
 export 'query/index/index_configuration.dart'
     show
+        ArrayIndexConfiguration,
         FullTextIndexConfiguration,
         IndexConfiguration,
-        ValueIndexConfiguration;
+        ValueIndexConfiguration,
+        VectorEncoding,
+        VectorIndexConfiguration;
 export 'query/join.dart' show Join, JoinInterface, JoinOnInterface;
 export 'query/joins.dart' show SyncJoins, Joins, AsyncJoins;
 export 'query/limit.dart' show SyncLimit, Limit, AsyncLimit;
@@ -40,9 +45,22 @@ export 'query/parameters.dart' show Parameters;
 export 'query/query.dart' show Query, SyncQuery, AsyncQuery;
 export 'query/query_builder.dart'
     show SyncQueryBuilder, QueryBuilder, AsyncQueryBuilder;
-export 'query/query_change.dart' show QueryChange;
+export 'query/query_cache.dart' show QueryCache, QueryCacheStats;
+export 'query/query_change.dart' show QueryChange, QueryResultsDiff;
+export 'query/query_instrumentation.dart'
+    show QueryInstrumentation, QueryStats;
 export 'query/result.dart' show Result;
-export 'query/result_set.dart' show AsyncResultSet, ResultSet, SyncResultSet;
+export 'query/result_set.dart'
+    show
+        AsyncResultSet,
+        ColumnarResultSet,
+        ColumnarType,
+        Float64ResultColumn,
+        Int64ResultColumn,
+        ResultColumn,
+        ResultSet,
+        StringResultColumn,
+        SyncResultSet;
 export 'query/router/from_router.dart'
     show SyncFromRouter, FromRouter, AsyncFromRouter;
 export 'query/router/group_by_router.dart'
@@ -298,6 +298,17 @@ final class ValueExpression extends ExpressionImpl {
       ['[]', ...iterable.map(_valueToJson)];
 }
 
+/// An expression which is given by its JSON representation, for example
+/// after it has been sent to another isolate.
+final class JsonExpression extends ExpressionImpl {
+  JsonExpression(Object? json) : _json = json;
+
+  final Object? _json;
+
+  @override
+  Object? toJson() => _json;
+}
+
 final class NullaryExpression extends ExpressionImpl {
   NullaryExpression(String operator) : _operator = operator;
 
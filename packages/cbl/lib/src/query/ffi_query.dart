@@ -1,11 +1,16 @@
 import 'dart:async';
 import 'dart:collection';
+import 'dart:convert';
 import 'dart:ffi';
+import 'dart:typed_data';
 
 import '../bindings.dart';
+import '../database/collection.dart';
 import '../database/database_base.dart';
 import '../database/ffi_database.dart';
 import '../document/common.dart';
+import '../document/document.dart';
+import '../document/ffi_document.dart';
 import '../fleece/containers.dart' as fl;
 import '../fleece/encoder.dart';
 import '../support/async_callback.dart';
@@ -26,6 +31,7 @@ import 'parameters.dart';
 import 'query.dart';
 import 'query_builder.dart';
 import 'query_change.dart';
+import 'query_instrumentation.dart';
 import 'result.dart';
 import 'result_set.dart';
 import 'select_result.dart';
@@ -48,6 +54,10 @@ base class FfiQuery extends QueryBase implements SyncQuery, Finalizable {
 
   late final Pointer<CBLQuery> _pointer;
 
+  late final QueryStatsImpl? _stats = database == null || definition == null
+      ? null
+      : QueryStatsImpl.forQuery(database!.name, definition!);
+
   List<String> get columnNames => useSync(() => _columnNames);
   late final List<String> _columnNames;
 
@@ -66,15 +76,55 @@ base class FfiQuery extends QueryBase implements SyncQuery, Finalizable {
       });
 
   @override
-  SyncResultSet execute() => syncOperationTracePoint(
-        () => ExecuteQueryOp(this),
-        () => useSync(
-          () => FfiResultSet(
-            runWithErrorTranslation(() => _bindings.execute(_pointer)),
+  SyncResultSet execute() => _execute();
+
+  @override
+  SyncResultSet executeWithDocuments(
+    SyncCollection collection, {
+    Object idColumn = 'id',
+  }) =>
+      useSync(() {
+        if (collection.database != database) {
+          throw ArgumentError.value(
+            collection,
+            'collection',
+            'must belong to the database of this query',
+          );
+        }
+
+        return _execute(
+          documentsCollection: collection as FfiCollection,
+          idColumn: _resolveColumn(idColumn, 'idColumn'),
+        );
+      });
+
+  SyncResultSet _execute({
+    FfiCollection? documentsCollection,
+    int idColumn = 0,
+  }) =>
+      syncOperationTracePoint(
+        () => ExecuteQueryOp(this, _stats),
+        () => useSync(() {
+          final stats = _stats;
+          final stopwatch = stats == null ? null : (Stopwatch()..start());
+          final pointer =
+              runWithErrorTranslation(() => _bindings.execute(_pointer));
+          stats?.recordExecution(stopwatch!.elapsed);
+
+          return FfiResultSet(
+            pointer,
             query: this,
             columnNames: _columnNames,
-          ),
-        ),
+            stats: stats,
+            documentsCollection: documentsCollection,
+            idColumn: idColumn,
+          );
+        }),
+      );
+
+  @override
+  AsyncResultSet executeAsync() => useSync(
+        () => FfiAsyncResultSet(this, columnNames: _columnNames),
       );
 
   @override
@@ -82,13 +132,18 @@ base class FfiQuery extends QueryBase implements SyncQuery, Finalizable {
 
   @override
   ListenerToken addChangeListener(
-    QueryChangeListener<SyncResultSet> listener,
-  ) =>
-      useSync(() => _addChangeListener(listener).also(_listenerTokens.add));
+    QueryChangeListener<SyncResultSet> listener, {
+    Duration? minInterval,
+  }) =>
+      useSync(() => _addChangeListener(listener, minInterval: minInterval)
+          .also(_listenerTokens.add));
+
+  FfiListenerToken _addChangeListener(
+    QueryChangeListener<SyncResultSet> listener, {
+    Duration? minInterval,
+  }) {
+    checkListenerMinInterval(minInterval);
 
-  AbstractListenerToken _addChangeListener(
-    QueryChangeListener<SyncResultSet> listener,
-  ) {
     late Pointer<CBLListenerToken> listenerToken;
     final database = this.database!;
     final callback = AsyncCallback(
@@ -113,11 +168,22 @@ base class FfiQuery extends QueryBase implements SyncQuery, Finalizable {
       database.pointer,
       _pointer,
       callback.pointer,
+      minInterval: minInterval ?? Duration.zero,
     );
 
     return FfiListenerToken(callback);
   }
 
+  void _setChangeListenerPaused(
+    AbstractListenerToken token, {
+    required bool paused,
+  }) {
+    final callback = (token as FfiListenerToken).callback;
+    if (!callback.isClosed) {
+      _bindings.setChangeListenerPaused(callback.pointer, paused: paused);
+    }
+  }
+
   @override
   void removeChangeListener(ListenerToken token) => useSync(() {
         final result = _listenerTokens.remove(token);
@@ -125,10 +191,101 @@ base class FfiQuery extends QueryBase implements SyncQuery, Finalizable {
       });
 
   @override
-  Stream<QueryChange<SyncResultSet>> changes() => useSync(() => ListenerStream(
-        parent: this,
-        addListener: _addChangeListener,
-      ));
+  Stream<QueryChange<SyncResultSet>> changes({Duration? minInterval}) =>
+      useSync(() => ListenerStream(
+            parent: this,
+            addListener: (listener) =>
+                _addChangeListener(listener, minInterval: minInterval),
+            onPause: (token) => _setChangeListenerPaused(token, paused: true),
+            onResume: (token) =>
+                _setChangeListenerPaused(token, paused: false),
+          ));
+
+  @override
+  Stream<QueryResultsDiff> diffs({Object? key}) => useSync(() {
+        final keyColumn = key == null ? null : _resolveColumn(key, 'key');
+        return ListenerStream<QueryResultsDiff>(
+          parent: this,
+          addListener: (listener) => _addDiffListener(keyColumn, listener),
+        );
+      });
+
+  /// Returns the index of the column with the name or index [nameOrIndex],
+  /// which has been passed as the argument with the [name].
+  int _resolveColumn(Object nameOrIndex, String name) => switch (nameOrIndex) {
+        int() => RangeError.checkValidIndex(nameOrIndex, _columnNames, name),
+        String() => _columnNames.contains(nameOrIndex)
+            ? _columnNames.indexOf(nameOrIndex)
+            : throw RangeError('"$nameOrIndex" is not a column of the query'),
+        _ => throw ArgumentError.value(
+            nameOrIndex,
+            name,
+            'must be a String or int',
+          ),
+      };
+
+  AbstractListenerToken _addDiffListener(
+    int? keyColumn,
+    void Function(QueryResultsDiff) listener,
+  ) {
+    final database = this.database!;
+    final context = createResultSetMContext(database);
+    final callback = AsyncCallback(
+      (arguments) {
+        final message = QueryDiffCallbackMessage.fromArguments(arguments);
+        final error = message.error;
+        if (error != null) {
+          throw error.toCouchbaseLiteException();
+        }
+        listener(_createResultsDiff(message, context));
+        return null;
+      },
+      debugName: 'FfiQuery.diffs',
+    );
+
+    _bindings.addDiffListener(
+      database.pointer,
+      _pointer,
+      callback.pointer,
+      keyColumn: keyColumn,
+    );
+
+    return FfiListenerToken(callback);
+  }
+
+  QueryResultsDiff _createResultsDiff(
+    QueryDiffCallbackMessage message,
+    DatabaseMContext context,
+  ) {
+    final rowIndexes = [...message.inserted, ...message.changed]..sort();
+    final rows = <int, Result>{};
+    if (rowIndexes.isNotEmpty) {
+      final doc = fl.Doc.fromResultData(
+        Data.fromTypedList(message.rows!),
+        FLTrust.trusted,
+      );
+      final array = doc.root.asArray!;
+      for (var i = 0; i < rowIndexes.length; i++) {
+        rows[rowIndexes[i]] = ResultImpl.fromValuesArray(
+          array[i].asArray!,
+          context: context,
+          columnNames: _columnNames,
+        );
+      }
+    }
+
+    return QueryResultsDiff(
+      length: message.length,
+      removed: List.unmodifiable(message.removed),
+      inserted: List.unmodifiable(message.inserted),
+      moved: List.unmodifiable([
+        for (var i = 0; i < message.movedFrom.length; i++)
+          (from: message.movedFrom[i], to: message.movedTo[i]),
+      ]),
+      changed: List.unmodifiable(message.changed),
+      rows: Map.unmodifiable(rows),
+    );
+  }
 
   @override
   T useSync<T>(T Function() f) => super.useSync(() {
@@ -146,12 +303,17 @@ base class FfiQuery extends QueryBase implements SyncQuery, Finalizable {
   }
 
   void _performPrepare() {
-    syncOperationTracePoint(() => PrepareQueryOp(this), () {
+    syncOperationTracePoint(() => PrepareQueryOp(this, _stats), () {
       _pointer = runWithErrorTranslation(
         () => _bindings.create(database!.pointer, language, definition!),
       );
 
-      bindCBLRefCountedToDartObject(this, pointer: _pointer);
+      _bindings.bindToDartObject(this, _pointer);
+
+      final stats = _stats;
+      if (stats != null && stats.needsPlan) {
+        stats.capturePlan(_bindings.explain(_pointer));
+      }
 
       _columnNames = List.generate(
         _bindings.columnCount(_pointer),
@@ -160,7 +322,22 @@ base class FfiQuery extends QueryBase implements SyncQuery, Finalizable {
     });
   }
 
-  void _applyParameters() {
+  void _applyParameters() => _applyParametersTo(_pointer);
+
+  /// Creates a query, which is only used by the caller, with the current
+  /// parameters of this query.
+  ///
+  /// The returned query must be given to [QueryBindings.executeAsync], which
+  /// takes ownership of it.
+  Pointer<CBLQuery> _createSnapshot() {
+    final pointer = runWithErrorTranslation(
+      () => _bindings.create(database!.pointer, language, definition!),
+    );
+    _applyParametersTo(pointer);
+    return pointer;
+  }
+
+  void _applyParametersTo(Pointer<CBLQuery> pointer) {
     final encoder = FleeceEncoder()
       ..extraInfo = FleeceEncoderContext(encodeQueryParameter: true);
     final parameters = _parameters;
@@ -175,7 +352,7 @@ base class FfiQuery extends QueryBase implements SyncQuery, Finalizable {
     final data = encoder.finish();
     final doc = fl.Doc.fromResultData(data, FLTrust.trusted);
     final dict = doc.root.asDict!;
-    _bindings.setParameters(_pointer, dict.pointer.cast());
+    _bindings.setParameters(pointer, dict.pointer.cast());
   }
 }
 
@@ -184,14 +361,26 @@ final class FfiResultSet with IterableMixin<Result> implements SyncResultSet {
     Pointer<CBLResultSet> pointer, {
     required FfiQuery query,
     required List<String> columnNames,
+    QueryStatsImpl? stats,
+    FfiCollection? documentsCollection,
+    int idColumn = 0,
   })  : _database = query.database!,
         _columnNames = columnNames,
-        _iterator = ResultSetIterator.fromPointer(pointer),
+        _stats = stats,
+        _documentsCollection = documentsCollection,
+        _iterator = ResultSetIterator.fromPointer(
+          pointer,
+          documentsCollection: documentsCollection,
+          idColumn: idColumn,
+        ),
         _context = createResultSetMContext(query.database!);
 
   final DatabaseBase _database;
+  final FfiCollection? _documentsCollection;
   final List<String> _columnNames;
   final ResultSetIterator _iterator;
+  final QueryStatsImpl? _stats;
+  var _rowCount = 0;
 
   final DatabaseMContext _context;
   ResultImpl? _current;
@@ -210,6 +399,16 @@ final class FfiResultSet with IterableMixin<Result> implements SyncResultSet {
   Stream<D> asTypedStream<D extends TypedDictionaryObject>() =>
       Stream.fromIterable(asTypedIterable<D>());
 
+  @override
+  Stream<Uint8List> asJsonStream() =>
+      Stream.fromIterable(_iterator.jsonChunks(
+        encodeFetchedRow: (row) => ResultImpl.fromValuesArray(
+          row,
+          context: _context,
+          columnNames: _columnNames,
+        ).toJson(),
+      ));
+
   @override
   List<Result> allResults() => toList();
 
@@ -217,6 +416,65 @@ final class FfiResultSet with IterableMixin<Result> implements SyncResultSet {
   List<D> allTypedResults<D extends TypedDictionaryObject>() =>
       asTypedIterable<D>().toList();
 
+  @override
+  ColumnarResultSet toColumnar(Map<Object, ColumnarType> columns) {
+    _current = null;
+
+    final resolvedColumns = [
+      for (final MapEntry(key: nameOrIndex, value: type) in columns.entries)
+        switch (nameOrIndex) {
+          int() => (
+              _columnNames[
+                  RangeError.checkValidIndex(nameOrIndex, _columnNames)],
+              nameOrIndex,
+              type,
+            ),
+          String() => (
+              nameOrIndex,
+              _columnIndex(nameOrIndex),
+              type,
+            ),
+          _ => throw ArgumentError.value(
+              nameOrIndex,
+              'nameOrIndex',
+              'must be a String or int',
+            ),
+        }
+    ];
+
+    final (rowCount, data) = _iterator.extractColumns([
+      for (final (_, index, type) in resolvedColumns)
+        (
+          index,
+          switch (type) {
+            ColumnarType.int64 => CBLColumnType.int64,
+            ColumnarType.float64 => CBLColumnType.float64,
+            ColumnarType.string => CBLColumnType.string,
+          }
+        ),
+    ]);
+
+    final stats = _stats;
+    if (stats != null && _rowCount >= 0) {
+      stats.recordRows(_rowCount + rowCount);
+      _rowCount = -1;
+    }
+
+    return ColumnarResultSetImpl.fromColumnData(
+      rowCount,
+      resolvedColumns,
+      data,
+    );
+  }
+
+  int _columnIndex(String name) {
+    final index = _columnNames.indexOf(name);
+    if (index == -1) {
+      throw RangeError('"$name" is not a column of the result set');
+    }
+    return index;
+  }
+
   @override
   Iterator<Result> get iterator => this;
 
@@ -227,22 +485,167 @@ final class FfiResultSet with IterableMixin<Result> implements SyncResultSet {
         // in CBL C, a result set is encoded in a single Fleece doc.
         context: _context,
         columnNames: _columnNames,
+        document: _currentDocumentFactory(),
       );
 
+  Document? Function()? _currentDocumentFactory() {
+    final collection = _documentsCollection;
+    if (collection == null) {
+      return null;
+    }
+
+    final delegate = _iterator.currentDocument;
+    return () => delegate == null
+        ? null
+        : DelegateDocument(delegate, collection: collection);
+  }
+
   @override
   bool moveNext() {
     _current = null;
-    return _iterator.moveNext();
+    final hasNext = _iterator.moveNext();
+    final stats = _stats;
+    if (stats != null) {
+      if (hasNext) {
+        _rowCount++;
+      } else if (_rowCount >= 0) {
+        stats.recordRows(_rowCount);
+        // Marks the rows as recorded.
+        _rowCount = -1;
+      }
+    }
+    return hasNext;
   }
 
   @override
   String toString() => 'FfiResultSet()';
 }
 
+/// An [AsyncResultSet] of a query which is executed on a native thread pool.
+///
+/// The rows are delivered in batches, while the following batches are still
+/// being encoded. While the subscription of the stream of results is paused,
+/// no further batches are encoded.
+final class FfiAsyncResultSet implements AsyncResultSet {
+  FfiAsyncResultSet(FfiQuery query, {required List<String> columnNames})
+      : _query = query,
+        _columnNames = columnNames,
+        _context = createResultSetMContext(query.database!) {
+    _callback = AsyncCallback(
+      _handleMessage,
+      debugName: 'FfiAsyncResultSet',
+    );
+    // The execution gets its own query, so that changes to the parameters
+    // of [query] after this point don't affect it.
+    _bindings.executeAsync(
+      query.database!.pointer,
+      query._createSnapshot(),
+      _callback.pointer,
+      batchSize: _batchSize,
+    );
+  }
+
+  static const _batchSize = 64;
+
+  final FfiQuery _query;
+  final List<String> _columnNames;
+  final DatabaseMContext _context;
+  late final AsyncCallback _callback;
+  late final _controller = StreamController<ResultImpl>(
+    onResume: _resume,
+    onCancel: _cancel,
+  );
+  Completer<void>? _resumed;
+  var _isConsumed = false;
+
+  Future<void> _handleMessage(List<Object?> arguments) async {
+    final message = QueryExecutionCallbackMessage.fromArguments(arguments);
+    final error = message.error;
+    if (error != null) {
+      _controller.addError(error.toCouchbaseLiteException());
+      _finish();
+      return;
+    }
+
+    final doc = fl.Doc.fromResultData(
+      Data.fromSliceResult(message.rows!),
+      FLTrust.trusted,
+    );
+    for (final row in doc.root.asArray!) {
+      _controller.add(ResultImpl.fromValuesArray(
+        row.asArray!,
+        context: _context,
+        columnNames: _columnNames,
+      ));
+    }
+
+    if (message.isLast) {
+      _finish();
+      return;
+    }
+
+    // Delaying the return of the callback delays encoding the next batch.
+    if (_controller.isPaused && _controller.hasListener) {
+      await (_resumed = Completer()).future;
+    }
+  }
+
+  void _resume() {
+    _resumed?.complete();
+    _resumed = null;
+  }
+
+  void _cancel() {
+    _callback.close();
+    _resume();
+  }
+
+  void _finish() {
+    _callback.close();
+    _controller.close();
+  }
+
+  Stream<ResultImpl> _asStream() {
+    if (_isConsumed) {
+      throw StateError('This result set has already been consumed.');
+    }
+    _isConsumed = true;
+    return _controller.stream
+        .transform(ResourceStreamTransformer(parent: _query, blocking: true));
+  }
+
+  @override
+  Stream<Result> asStream() => _asStream();
+
+  @override
+  Stream<D> asTypedStream<D extends TypedDictionaryObject>() {
+    final adapter = _query.database!.useWithTypedData();
+    return _asStream()
+        .map((result) => result.asDictionary)
+        .map(adapter.dictionaryFactoryForType<D>());
+  }
+
+  @override
+  Stream<Uint8List> asJsonStream() => resultsAsJsonStream(_asStream());
+
+  @override
+  Future<List<Result>> allResults() => asStream().toList();
+
+  @override
+  Future<List<D>> allTypedResults<D extends TypedDictionaryObject>() =>
+      asTypedStream<D>().toList();
+}
+
 final class ResultSetIterator
     with IterableMixin<fl.Array>
     implements Iterator<fl.Array>, Finalizable {
-  ResultSetIterator.fromPointer(this._pointer, {this.encodeArray = false}) {
+  ResultSetIterator.fromPointer(
+    this._pointer, {
+    this.encodeArray = false,
+    FfiCollection? documentsCollection,
+    int idColumn = 0,
+  })  : _documentsCollection = documentsCollection,
+        _idColumn = idColumn {
     bindCBLRefCountedToDartObject(this, pointer: _pointer);
   }
 
@@ -250,28 +653,160 @@ final class ResultSetIterator
 
   final bool encodeArray;
   final Pointer<CBLResultSet> _pointer;
+
+  /// The collection from which the document of each row is loaded, together
+  /// with the row, or `null` if documents are not loaded.
+  final FfiCollection? _documentsCollection;
+
+  /// The index of the column which contains the ids of the documents to load.
+  final int _idColumn;
+
   var _isDone = false;
   fl.Array? _current;
+  FfiDocumentDelegate? _currentDocument;
+
+  // Rows are fetched from the native result set in batches, to avoid native
+  // calls for every row.
+  var _batch = const <fl.Array>[];
+  var _documentBatch = const <FfiDocumentDelegate?>[];
+  var _batchIndex = 0;
+
+  /// The native memory into which batches are fetched, which is freed once
+  /// the rows have been consumed.
+  ResultSetBatchBuffer? _batchBuffer;
 
   @override
   Iterator<fl.Array> get iterator => this;
 
   @override
   fl.Array get current {
-    assert(_current != null || !_isDone);
-    final result =
-        _current ??= fl.Array.fromPointer(_bindings.resultArray(_pointer));
-    return result;
+    assert(_current != null);
+    return _current!;
   }
 
+  /// The document of the current row, if documents are loaded and the
+  /// document exists.
+  FfiDocumentDelegate? get currentDocument => _currentDocument;
+
   @override
   bool moveNext() {
     if (_isDone) {
       return false;
     }
+
+    if (_batchIndex == _batch.length) {
+      _fetchBatch();
+    }
+
+    if (_batch.isEmpty) {
+      _isDone = true;
+      _freeBatchBuffer();
+      _current = null;
+      _currentDocument = null;
+      return false;
+    }
+
+    if (_documentBatch.isNotEmpty) {
+      _currentDocument = _documentBatch[_batchIndex];
+    }
+    _current = _batch[_batchIndex++];
+    return true;
+  }
+
+  void _fetchBatch() {
+    _batchIndex = 0;
+    final buffer = _batchBuffer ??= ResultSetBatchBuffer();
+
+    final collection = _documentsCollection;
+    if (collection == null) {
+      _batch = _bindings
+          .nextBatch(_pointer, buffer)
+          .map((row) => fl.Array.fromPointer(row, adopt: true))
+          .toList();
+      return;
+    }
+
+    final rows = runWithErrorTranslation(() => _bindings.nextBatchWithDocuments(
+        _pointer, collection.pointer, _idColumn, buffer));
+    cblReachabilityFence(collection);
+    _batch = [
+      for (final (row, _) in rows) fl.Array.fromPointer(row, adopt: true),
+    ];
+    _documentBatch = [
+      for (final (_, document) in rows)
+        document == null
+            ? null
+            : FfiDocumentDelegate.fromPointer(document, adopt: true),
+    ];
+  }
+
+  void _freeBatchBuffer() {
+    _batchBuffer?.free();
+    _batchBuffer = null;
+  }
+
+  /// Consumes the remaining rows and extracts the [columns] of the rows, as
+  /// pairs of column indexes and types.
+  ///
+  /// Returns the number of extracted rows and the data of each column.
+  (int, List<CBLColumnData>) extractColumns(
+    List<(int, CBLColumnType)> columns,
+  ) {
+    final fetchedRows = _batch.sublist(_batchIndex);
+    _batch = const [];
+    _batchIndex = 0;
+    _current = null;
+    _isDone = true;
+    _freeBatchBuffer();
+
+    final result = _bindings.extractColumns(
+      _pointer,
+      [for (final row in fetchedRows) row.pointer.cast()],
+      columns,
+    );
+    cblReachabilityFence(this);
+    cblReachabilityFence(fetchedRows);
+    return result;
+  }
+
+  /// Consumes the remaining rows and returns them as a JSON array of objects,
+  /// in chunks of UTF-8 encoded bytes.
+  ///
+  /// Rows which have already been fetched from the native result set, but
+  /// not consumed yet, are encoded with [encodeFetchedRow].
+  Iterable<Uint8List> jsonChunks({
+    required String Function(fl.Array row) encodeFetchedRow,
+  }) sync* {
+    if (_isDone) {
+      yield Uint8List.fromList(const [0x5B, 0x5D]); // []
+      return;
+    }
+
+    final fetchedRows = _batch.sublist(_batchIndex);
+    _batch = const [];
+    _batchIndex = 0;
     _current = null;
-    _isDone = !_bindings.next(_pointer);
-    return !_isDone;
+    _freeBatchBuffer();
+
+    final buffer = JsonBuffer();
+    var isFirstChunk = true;
+    if (fetchedRows.isNotEmpty) {
+      final json = fetchedRows.map(encodeFetchedRow).join(',');
+      yield utf8.encode('[$json');
+      isFirstChunk = false;
+    }
+
+    while (!_isDone) {
+      _isDone = runWithErrorTranslation(() => _bindings.writeJson(
+            _pointer,
+            buffer.pointer,
+            chunkSize: resultSetJsonChunkSize,
+            isFirstChunk: isFirstChunk,
+          ));
+      isFirstChunk = false;
+      cblReachabilityFence(this);
+      yield buffer.takeBytes();
+    }
   }
 }
 
@@ -29,6 +29,39 @@ enum FullTextLanguage {
   turkish,
 }
 
+/// The metric with which the distance between vectors in a vector index is
+/// measured.
+///
+/// {@category Query}
+enum DistanceMetric {
+  /// The squared euclidean distance.
+  euclideanSquared,
+
+  /// The cosine distance, which is `1` minus the cosine similarity.
+  cosine,
+
+  /// The euclidean distance.
+  euclidean,
+
+  /// The negative dot product.
+  dot,
+}
+
+/// The number of bits per dimension with which a scalar quantizer encodes
+/// vectors.
+///
+/// {@category Query}
+enum ScalarQuantizerType {
+  /// 4 bits per dimension.
+  sq4,
+
+  /// 6 bits per dimension.
+  sq6,
+
+  /// 8 bits per dimension.
+  sq8,
+}
+
 // === Impl ====================================================================
 
 /// Interface for classes wich implement [Index].
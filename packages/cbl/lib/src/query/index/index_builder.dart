@@ -65,6 +65,22 @@ final class FullTextIndexItem {
   final ExpressionImpl _expression;
 }
 
+/// An array index for queries which `UNNEST` an array.
+///
+/// {@category Query}
+final class ArrayIndex implements Index {
+  /// Creates an array index of the array at [path], from the
+  /// [ValueIndexItem]s to index for each element of the array.
+  ///
+  /// If the array contains scalars, [items] can be omitted to index the
+  /// elements themselves.
+  factory ArrayIndex(
+    String path, [
+    Iterable<ValueIndexItem> items = const [],
+  ]) =>
+      ArrayIndexImpl(path, items);
+}
+
 // ignore: avoid_classes_with_only_static_members
 /// Factor to create query indexes.
 ///
@@ -82,6 +98,16 @@ abstract final class IndexBuilder {
   /// match operation against.
   static FullTextIndex fullTextIndex(Iterable<FullTextIndexItem> items) =>
       FullTextIndex(items);
+
+  /// Creates an array index of the array at [path], with the given value
+  /// index [items].
+  ///
+  /// The index items are evaluated against the elements of the array.
+  static ArrayIndex arrayIndex(
+    String path, [
+    Iterable<ValueIndexItem> items = const [],
+  ]) =>
+      ArrayIndex(path, items);
 }
 
 // === Impl ====================================================================
@@ -141,3 +167,24 @@ final class FullTextIndexImpl implements IndexImplInterface, FullTextIndex {
         language: _language?.name,
       );
 }
+
+final class ArrayIndexImpl implements IndexImplInterface, ArrayIndex {
+  ArrayIndexImpl(this._path, Iterable<ValueIndexItem> items)
+      : _items = items.toList();
+
+  final String _path;
+  final List<ValueIndexItem> _items;
+
+  @override
+  CBLIndexSpec toCBLIndexSpec() => CBLIndexSpec(
+        expressionLanguage: CBLQueryLanguage.json,
+        type: CBLIndexType.array,
+        path: _path,
+        expressions: _items.isEmpty
+            ? ''
+            : _items
+                .map((item) => item._expression.toJson())
+                .toList()
+                .let(jsonEncode),
+      );
+}
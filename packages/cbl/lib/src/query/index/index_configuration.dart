@@ -56,6 +56,120 @@ abstract final class FullTextIndexConfiguration implements IndexConfiguration {
   set language(FullTextLanguage? value);
 }
 
+/// A specification of an array [Index], which indexes the elements of the
+/// array at [path].
+///
+/// An array index makes queries which `UNNEST` the array at [path] efficient.
+///
+/// {@category Query}
+abstract final class ArrayIndexConfiguration implements IndexConfiguration {
+  /// Creates a specification of an array [Index] for the array at [path].
+  ///
+  /// The SQL++ [expressions] are evaluated against the elements of the array
+  /// and the results are indexed. If the array contains scalars,
+  /// [expressions] can be omitted to index the elements themselves.
+  factory ArrayIndexConfiguration(
+    String path, {
+    List<String> expressions,
+  }) = _ArrayIndexConfiguration;
+
+  /// The path of the array to index.
+  ///
+  /// Nested arrays are specified by separating their paths with `[]`, for
+  /// example `contacts[].phones`.
+  String get path;
+  set path(String value);
+}
+
+/// The encoding with which vectors are stored in a vector index.
+///
+/// {@category Query}
+abstract final class VectorEncoding {
+  /// No encoding, which stores vectors in full precision.
+  factory VectorEncoding.none() => const _NoneVectorEncoding();
+
+  /// A scalar quantizer, which encodes each dimension of a vector in the
+  /// number of bits given by [type].
+  factory VectorEncoding.scalarQuantizer(ScalarQuantizerType type) =>
+      _ScalarQuantizerVectorEncoding(type);
+
+  /// A product quantizer, which divides vectors into [subquantizers] and
+  /// encodes each of them in [bits].
+  ///
+  /// The number of dimensions of the vectors must be a multiple of
+  /// [subquantizers].
+  factory VectorEncoding.productQuantizer({
+    required int subquantizers,
+    required int bits,
+  }) = _ProductQuantizerVectorEncoding;
+}
+
+/// A specification of a vector [Index], for similarity search with
+/// `APPROX_VECTOR_DISTANCE`.
+///
+/// Vector indexes are only available in the Enterprise Edition and require the
+/// vector search extension to be enabled.
+///
+/// {@category Query}
+/// {@category Enterprise Edition}
+abstract final class VectorIndexConfiguration implements Index {
+  /// Creates a specification of a vector [Index] of the vectors which
+  /// [expression] evaluates to.
+  factory VectorIndexConfiguration(
+    String expression, {
+    required int dimensions,
+    required int centroids,
+    VectorEncoding? encoding,
+    DistanceMetric? metric,
+    int? minTrainingSize,
+    int? maxTrainingSize,
+    int? numProbes,
+  }) = _VectorIndexConfiguration;
+
+  /// The SQL++ expression which evaluates to the vectors to index.
+  String get expression;
+  set expression(String value);
+
+  /// The number of dimensions of the vectors, between 2 and 4096.
+  int get dimensions;
+  set dimensions(int value);
+
+  /// The number of centroids into which vectors are clustered, between 1 and
+  /// 64000.
+  int get centroids;
+  set centroids(int value);
+
+  /// The encoding with which vectors are stored.
+  ///
+  /// The default is a scalar quantizer with [ScalarQuantizerType.sq8].
+  VectorEncoding get encoding;
+  set encoding(VectorEncoding value);
+
+  /// The metric with which the distance between vectors is measured.
+  ///
+  /// The default is [DistanceMetric.euclideanSquared].
+  DistanceMetric get metric;
+  set metric(DistanceMetric value);
+
+  /// The minimum number of vectors with which the index is trained.
+  ///
+  /// If left `null`, 25 times [centroids] is used.
+  int? get minTrainingSize;
+  set minTrainingSize(int? value);
+
+  /// The maximum number of vectors with which the index is trained.
+  ///
+  /// If left `null`, 256 times [centroids] is used.
+  int? get maxTrainingSize;
+  set maxTrainingSize(int? value);
+
+  /// The number of centroids which are searched for matches.
+  ///
+  /// If left `null`, Couchbase Lite chooses a value based on [centroids].
+  int? get numProbes;
+  set numProbes(int? value);
+}
+
 // === Impl ====================================================================
 
 abstract final class _IndexConfiguration implements IndexConfiguration {
@@ -162,3 +276,256 @@ final class _FullTextIndexConfiguration extends _IndexConfiguration
     ].join();
   }
 }
+
+final class _ArrayIndexConfiguration
+    implements ArrayIndexConfiguration, IndexImplInterface {
+  _ArrayIndexConfiguration(String path, {this.expressions = const []}) {
+    this.path = path;
+  }
+
+  String _path = '';
+
+  @override
+  String get path => _path;
+
+  @override
+  set path(String path) {
+    if (path.isEmpty) {
+      throw ArgumentError.value(path, 'path', 'must not be empty');
+    }
+    _path = path;
+  }
+
+  @override
+  List<String> expressions;
+
+  @override
+  CBLIndexSpec toCBLIndexSpec() => CBLIndexSpec(
+        expressionLanguage: CBLQueryLanguage.n1ql,
+        expressions: expressions.join(', '),
+        type: CBLIndexType.array,
+        path: path,
+      );
+
+  @override
+  bool operator ==(Object other) =>
+      identical(this, other) ||
+      other is _ArrayIndexConfiguration &&
+          runtimeType == other.runtimeType &&
+          path == other.path &&
+          const DeepCollectionEquality().equals(expressions, other.expressions);
+
+  @override
+  int get hashCode =>
+      path.hashCode ^ const DeepCollectionEquality().hash(expressions);
+
+  @override
+  String toString() => [
+        'ArrayIndexConfiguration(',
+        path,
+        if (expressions.isNotEmpty) ' | ',
+        expressions.join(', '),
+        ')'
+      ].join();
+}
+
+final class _NoneVectorEncoding implements VectorEncoding {
+  const _NoneVectorEncoding();
+
+  @override
+  bool operator ==(Object other) => other is _NoneVectorEncoding;
+
+  @override
+  int get hashCode => (_NoneVectorEncoding).hashCode;
+
+  @override
+  String toString() => 'VectorEncoding.none()';
+}
+
+final class _ScalarQuantizerVectorEncoding implements VectorEncoding {
+  _ScalarQuantizerVectorEncoding(this.type);
+
+  final ScalarQuantizerType type;
+
+  @override
+  bool operator ==(Object other) =>
+      identical(this, other) ||
+      other is _ScalarQuantizerVectorEncoding && type == other.type;
+
+  @override
+  int get hashCode => type.hashCode;
+
+  @override
+  String toString() => 'VectorEncoding.scalarQuantizer(${type.name})';
+}
+
+final class _ProductQuantizerVectorEncoding implements VectorEncoding {
+  _ProductQuantizerVectorEncoding({
+    required this.subquantizers,
+    required this.bits,
+  }) {
+    if (subquantizers < 1) {
+      throw RangeError.value(
+        subquantizers,
+        'subquantizers',
+        'must be positive',
+      );
+    }
+    RangeError.checkValueInInterval(bits, 4, 12, 'bits');
+  }
+
+  final int subquantizers;
+  final int bits;
+
+  @override
+  bool operator ==(Object other) =>
+      identical(this, other) ||
+      other is _ProductQuantizerVectorEncoding &&
+          subquantizers == other.subquantizers &&
+          bits == other.bits;
+
+  @override
+  int get hashCode => subquantizers.hashCode ^ bits.hashCode;
+
+  @override
+  String toString() => 'VectorEncoding.productQuantizer('
+      'subquantizers: $subquantizers, bits: $bits)';
+}
+
+final class _VectorIndexConfiguration
+    implements VectorIndexConfiguration, IndexImplInterface {
+  _VectorIndexConfiguration(
+    this.expression, {
+    required int dimensions,
+    required int centroids,
+    VectorEncoding? encoding,
+    DistanceMetric? metric,
+    this.minTrainingSize,
+    this.maxTrainingSize,
+    this.numProbes,
+  })  : encoding = encoding ??
+            VectorEncoding.scalarQuantizer(ScalarQuantizerType.sq8),
+        metric = metric ?? DistanceMetric.euclideanSquared {
+    this.dimensions = dimensions;
+    this.centroids = centroids;
+  }
+
+  @override
+  String expression;
+
+  int _dimensions = 2;
+
+  @override
+  int get dimensions => _dimensions;
+
+  @override
+  set dimensions(int value) {
+    RangeError.checkValueInInterval(value, 2, 4096, 'dimensions');
+    _dimensions = value;
+  }
+
+  int _centroids = 1;
+
+  @override
+  int get centroids => _centroids;
+
+  @override
+  set centroids(int value) {
+    RangeError.checkValueInInterval(value, 1, 64000, 'centroids');
+    _centroids = value;
+  }
+
+  @override
+  VectorEncoding encoding;
+
+  @override
+  DistanceMetric metric;
+
+  @override
+  int? minTrainingSize;
+
+  @override
+  int? maxTrainingSize;
+
+  @override
+  int? numProbes;
+
+  @override
+  CBLIndexSpec toCBLIndexSpec() {
+    final encoding = this.encoding;
+    return CBLIndexSpec(
+      expressionLanguage: CBLQueryLanguage.n1ql,
+      expressions: expression,
+      type: CBLIndexType.vector,
+      vector: CBLVectorIndexSpec(
+        dimensions: dimensions,
+        centroids: centroids,
+        encodingType: switch (encoding) {
+          _ScalarQuantizerVectorEncoding() =>
+            CBLVectorEncodingType.scalarQuantizer,
+          _ProductQuantizerVectorEncoding() =>
+            CBLVectorEncodingType.productQuantizer,
+          _ => CBLVectorEncodingType.none,
+        },
+        scalarQuantizerType: switch (encoding) {
+          _ScalarQuantizerVectorEncoding(:final type) =>
+            CBLScalarQuantizerType.values[type.index],
+          _ => null,
+        },
+        subquantizers: switch (encoding) {
+          _ProductQuantizerVectorEncoding(:final subquantizers) =>
+            subquantizers,
+          _ => null,
+        },
+        bits: switch (encoding) {
+          _ProductQuantizerVectorEncoding(:final bits) => bits,
+          _ => null,
+        },
+        metric: CBLDistanceMetric.values[metric.index],
+        minTrainingSize: minTrainingSize,
+        maxTrainingSize: maxTrainingSize,
+        numProbes: numProbes,
+      ),
+    );
+  }
+
+  @override
+  bool operator ==(Object other) =>
+      identical(this, other) ||
+      other is _VectorIndexConfiguration &&
+          runtimeType == other.runtimeType &&
+          expression == other.expression &&
+          dimensions == other.dimensions &&
+          centroids == other.centroids &&
+          encoding == other.encoding &&
+          metric == other.metric &&
+          minTrainingSize == other.minTrainingSize &&
+          maxTrainingSize == other.maxTrainingSize &&
+          numProbes == other.numProbes;
+
+  @override
+  int get hashCode =>
+      expression.hashCode ^
+      dimensions.hashCode ^
+      centroids.hashCode ^
+      encoding.hashCode ^
+      metric.hashCode ^
+      minTrainingSize.hashCode ^
+      maxTrainingSize.hashCode ^
+      numProbes.hashCode;
+
+  @override
+  String toString() {
+    final properties = [
+      'dimensions: $dimensions',
+      'centroids: $centroids',
+      'encoding: $encoding',
+      'metric: ${metric.name}',
+      if (minTrainingSize != null) 'minTrainingSize: $minTrainingSize',
+      if (maxTrainingSize != null) 'maxTrainingSize: $maxTrainingSize',
+      if (numProbes != null) 'numProbes: $numProbes',
+    ];
+
+    return 'VectorIndexConfiguration($expression | ${properties.join(', ')})';
+  }
+}
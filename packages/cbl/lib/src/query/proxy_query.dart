@@ -1,10 +1,12 @@
 import 'dart:async';
+import 'dart:typed_data';
 
 import 'package:synchronized/synchronized.dart';
 
 import '../bindings.dart';
 import '../database/proxy_database.dart';
 import '../fleece/encoder.dart';
+import '../service/cbl_service.dart';
 import '../service/cbl_service_api.dart';
 import '../service/proxy_object.dart';
 import '../support/encoding.dart';
@@ -40,6 +42,7 @@ base class ProxyQuery extends QueryBase
   late final _lock = Lock();
   late final _listenerTokens = ListenerTokenRegistry(this);
   late List<String> _columnNames;
+  late CblServiceClient _client;
   _ProxyQueryEarlyFinalizer? _earlyFinalizer;
 
   @override
@@ -78,16 +81,23 @@ base class ProxyQuery extends QueryBase
       use(() => channel!.call(ExplainQuery(queryId: objectId!)));
 
   @override
-  Future<ListenerToken> addChangeListener(QueryChangeListener listener) =>
+  Future<ListenerToken> addChangeListener(
+    QueryChangeListener listener, {
+    Duration? minInterval,
+  }) =>
       use(() async {
-        final token = await _addChangeListener(listener);
+        final token =
+            await _addChangeListener(listener, minInterval: minInterval);
         return token.also(_listenerTokens.add);
       });
 
   Future<AbstractListenerToken> _addChangeListener(
-    QueryChangeListener listener,
-  ) async {
-    final client = database!.client;
+    QueryChangeListener listener, {
+    Duration? minInterval,
+  }) async {
+    checkListenerMinInterval(minInterval);
+
+    final client = _client;
     late final ProxyListenerToken<QueryChange> token;
 
     final listenerId = client.registerQueryChangeListener((resultSetId) {
@@ -105,6 +115,7 @@ base class ProxyQuery extends QueryBase
     await channel!.call(AddQueryChangeListener(
       queryId: objectId!,
       listenerId: listenerId,
+      minInterval: minInterval,
     ));
 
     return token = ProxyListenerToken(client, this, listenerId, listener);
@@ -115,10 +126,12 @@ base class ProxyQuery extends QueryBase
       use(() => _listenerTokens.remove(token));
 
   @override
-  AsyncListenStream<QueryChange> changes() => useSync(() => ListenerStream(
-        parent: this,
-        addListener: (listener) => use(() => _addChangeListener(listener)),
-      ));
+  AsyncListenStream<QueryChange> changes({Duration? minInterval}) =>
+      useSync(() => ListenerStream(
+            parent: this,
+            addListener: (listener) => use(() =>
+                _addChangeListener(listener, minInterval: minInterval)),
+          ));
 
   @override
   Future<T> use<T>(FutureOr<T> Function() f) => super.use(() async {
@@ -134,16 +147,18 @@ base class ProxyQuery extends QueryBase
   Future<void> _performPrepare() =>
       asyncOperationTracePoint(() => PrepareQueryOp(this), () async {
         final database = this.database!;
-        final channel = database.channel;
+        final target = database.nextQueryTarget();
+        final channel = target.client.channel;
 
         final state = await channel.call(CreateQuery(
-          databaseId: database.objectId,
+          databaseId: target.databaseId,
           language: language,
           queryDefinition: definition!,
           resultEncoding: database.encodingFormat,
         ));
 
         _columnNames = state.columnNames;
+        _client = target.client;
 
         // We need this so we don't capture `this` in the closure of
         // proxyFinalizer.
@@ -230,6 +245,9 @@ final class ProxyResultSet implements AsyncResultSet {
         .map(adapter.dictionaryFactoryForType<D>());
   }
 
+  @override
+  Stream<Uint8List> asJsonStream() => resultsAsJsonStream(_asStream());
+
   @override
   Future<List<Result>> allResults() => asStream().toList();
 
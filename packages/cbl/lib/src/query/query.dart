@@ -72,13 +72,23 @@ abstract interface class Query implements Resource {
   /// because the contents of the database have changed or this query's
   /// [parameters] have been changed through [setParameters].
   ///
+  /// {@template cbl.Query.minInterval}
+  /// If [minInterval] is given, [listener] is called at most once per
+  /// [minInterval]. Changes within that interval are coalesced into a single
+  /// call at the end of the interval, with the latest results. This is useful
+  /// to avoid rebuilding a UI for every change of a burst of writes.
+  /// {@endtemplate}
+  ///
   /// {@macro cbl.Collection.addChangeListener}
   ///
   /// See also:
   ///
   /// - [QueryChange] for the change event given to [listener].
   /// - [removeChangeListener] for removing a previously added listener.
-  FutureOr<ListenerToken> addChangeListener(QueryChangeListener listener);
+  FutureOr<ListenerToken> addChangeListener(
+    QueryChangeListener listener, {
+    Duration? minInterval,
+  });
 
   /// {@macro cbl.Collection.removeChangeListener}
   ///
@@ -92,8 +102,14 @@ abstract interface class Query implements Resource {
   ///
   /// This is an alternative stream based API for the [addChangeListener] API.
   ///
+  /// {@macro cbl.Query.minInterval}
+  ///
+  /// While the subscription of the stream is paused, changes are not
+  /// delivered. When it is resumed, a single event with the latest results is
+  /// delivered if the results changed in the meantime.
+  ///
   /// {@macro cbl.Collection.AsyncListenStream}
-  Stream<QueryChange> changes();
+  Stream<QueryChange> changes({Duration? minInterval});
 
   /// The JSON representation of this query.
   ///
@@ -122,17 +138,64 @@ abstract interface class SyncQuery implements Query {
   @override
   SyncResultSet execute();
 
+  /// Executes this query, like [execute], and loads the document of each
+  /// result from [collection], which is available through [Result.document].
+  ///
+  /// The id of the document of a result is the value of the column with the
+  /// name or index [idColumn], for example `META().id`, which is named `id`.
+  /// The documents are loaded natively, through the document cache, in the
+  /// same pass over the results, instead of with a separate call to
+  /// [SyncCollection.document] for each result.
+  ///
+  /// Throws a [RangeError] if [idColumn] is not a column of this query.
+  SyncResultSet executeWithDocuments(
+    SyncCollection collection, {
+    Object idColumn = 'id',
+  });
+
+  /// Executes this query on a native thread pool, instead of the current
+  /// isolate, and returns the results as they become available.
+  ///
+  /// The results are delivered in batches, while the following batches are
+  /// still being encoded. While the subscription to the results is paused,
+  /// no further batches are encoded.
+  ///
+  /// The query is executed with the parameters it has when this method is
+  /// called. Since the query is executed later, it can see changes which
+  /// are made to the database after this method returns.
+  ///
+  /// The query is executed, even if the results are never consumed.
+  AsyncResultSet executeAsync();
+
   @override
   String explain();
 
   @override
-  ListenerToken addChangeListener(QueryChangeListener<SyncResultSet> listener);
+  ListenerToken addChangeListener(
+    QueryChangeListener<SyncResultSet> listener, {
+    Duration? minInterval,
+  });
 
   @override
   void removeChangeListener(ListenerToken token);
 
   @override
-  Stream<QueryChange<SyncResultSet>> changes();
+  Stream<QueryChange<SyncResultSet>> changes({Duration? minInterval});
+
+  /// Returns a stream of the differences between consecutive results of this
+  /// query.
+  ///
+  /// Instead of copying and decoding all results every time they change, like
+  /// [changes], only the rows which have been inserted or changed are decoded.
+  /// The first diff contains all rows, as inserted rows.
+  ///
+  /// Rows are matched by the value of the column with the name or index [key],
+  /// which should uniquely identify a row, for example `META().id`. If [key] is
+  /// `null`, rows are matched by their content, in which case a row is never
+  /// reported as changed.
+  ///
+  /// Throws a [RangeError] if [key] is not a column of this query.
+  Stream<QueryResultsDiff> diffs({Object? key});
 }
 
 /// A [Query] query with a primarily asynchronous API.
@@ -149,13 +212,16 @@ abstract interface class AsyncQuery implements Query {
   Future<String> explain();
 
   @override
-  Future<ListenerToken> addChangeListener(QueryChangeListener listener);
+  Future<ListenerToken> addChangeListener(
+    QueryChangeListener listener, {
+    Duration? minInterval,
+  });
 
   @override
   Future<void> removeChangeListener(ListenerToken token);
 
   @override
-  AsyncListenStream<QueryChange> changes();
+  AsyncListenStream<QueryChange> changes({Duration? minInterval});
 }
 
 abstract base class QueryBase with ClosableResourceMixin implements Query {
@@ -0,0 +1,79 @@
+import '../bindings.dart';
+import 'query.dart';
+
+final _bindings = cblBindings.query;
+
+/// A native cache of prepared [Query]s, which allows queries to be reused
+/// instead of being parsed and prepared again.
+///
+/// When a query is prepared, a prepared query with the same language and
+/// definition is reused from the cache, if one is idle. When a query is garbage
+/// collected, its prepared query is given back to the cache, with its
+/// parameters reset, so that a query which is recreated frequently, for
+/// example when a screen is shown, is only prepared once.
+///
+/// A prepared query only belongs to one [Query] at a time. Prepared queries
+/// which have had change listeners are not reused.
+///
+/// The cache keeps at most [capacity] idle prepared queries for each database
+/// and evicts the least recently used ones. The idle prepared queries of a
+/// database are released when the database is closed.
+///
+/// The cache is shared by all isolates, including the worker isolates of
+/// `AsyncDatabase`s.
+///
+/// {@category Query}
+abstract final class QueryCache {
+  /// The maximum number of idle prepared queries the cache keeps for each
+  /// database.
+  ///
+  /// A capacity of `0` disables the cache. The default is `32`.
+  static int get capacity => _bindings.cacheStats().capacity;
+
+  static set capacity(int value) {
+    RangeError.checkNotNegative(value, 'capacity');
+    _bindings.setCacheCapacity(value);
+  }
+
+  /// The current stats of the cache.
+  static QueryCacheStats get stats {
+    final stats = _bindings.cacheStats();
+    return QueryCacheStats._(
+      hits: stats.hits,
+      misses: stats.misses,
+      evictions: stats.evictions,
+      size: stats.size,
+    );
+  }
+}
+
+/// Stats of the [QueryCache].
+///
+/// {@category Query}
+final class QueryCacheStats {
+  QueryCacheStats._({
+    required this.hits,
+    required this.misses,
+    required this.evictions,
+    required this.size,
+  });
+
+  /// The number of queries which have been prepared by reusing a prepared
+  /// query from the cache.
+  final int hits;
+
+  /// The number of queries which have been prepared because there was no
+  /// idle prepared query in the cache.
+  final int misses;
+
+  /// The number of idle prepared queries which have been evicted from the
+  /// cache, because it exceeded its capacity.
+  final int evictions;
+
+  /// The number of idle prepared queries in the cache.
+  final int size;
+
+  @override
+  String toString() => 'QueryCacheStats(hits: $hits, misses: $misses, '
+      'evictions: $evictions, size: $size)';
+}
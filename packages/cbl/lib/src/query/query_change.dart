@@ -19,3 +19,107 @@ final class QueryChange<R extends ResultSet> {
   @override
   String toString() => 'QueryChange(query: $query)';
 }
+
+/// The difference between consecutive results of a [Query].
+///
+/// Rows of the previous and the new results are matched by a key. Rows which
+/// have no match in the new results have been [removed] and rows which have no
+/// match in the previous results have been [inserted]. Matched rows which do
+/// not keep their relative order have been [moved] and matched rows whose
+/// content is different have [changed].
+///
+/// Only the [rows] which have been inserted or changed are included, so that
+/// the cost of a diff is proportional to the size of the change, instead of
+/// the size of the results.
+///
+/// See also:
+///
+/// - [SyncQuery.diffs] for listening to the differences between the results
+///   of a query.
+///
+/// {@category Query}
+@immutable
+final class QueryResultsDiff {
+  /// Creates the difference between consecutive results of a [Query].
+  const QueryResultsDiff({
+    required this.length,
+    required this.removed,
+    required this.inserted,
+    required this.moved,
+    required this.changed,
+    required this.rows,
+  });
+
+  /// The number of rows in the new results.
+  final int length;
+
+  /// The indexes of rows in the previous results which have been removed, in
+  /// ascending order.
+  final List<int> removed;
+
+  /// The indexes of rows in the new results which have been inserted, in
+  /// ascending order.
+  final List<int> inserted;
+
+  /// The rows which have been moved, as pairs of their indexes in the previous
+  /// and the new results, in ascending order of the new indexes.
+  final List<({int from, int to})> moved;
+
+  /// The indexes of rows in the new results which have changed, in ascending
+  /// order.
+  final List<int> changed;
+
+  /// The inserted and changed rows, by their index in the new results.
+  final Map<int, Result> rows;
+
+  /// Whether the results have not changed.
+  bool get isEmpty =>
+      removed.isEmpty && inserted.isEmpty && moved.isEmpty && changed.isEmpty;
+
+  /// Applies this diff to the [previous] results and returns the new results.
+  ///
+  /// [previous] must contain the results to which the previous diff was
+  /// applied, or be empty for the first diff.
+  List<Result> applyTo(List<Result> previous) {
+    final results = List<Result?>.filled(length, null);
+    final isMovedOrRemoved = List.filled(previous.length, false);
+
+    for (final index in removed) {
+      isMovedOrRemoved[index] = true;
+    }
+    for (final (:from, :to) in moved) {
+      isMovedOrRemoved[from] = true;
+      results[to] = previous[from];
+    }
+    for (final index in inserted) {
+      results[index] = rows[index];
+    }
+
+    // The rows which have not been moved keep their relative order and fill
+    // the remaining slots.
+    var previousIndex = 0;
+    for (var index = 0; index < length; index++) {
+      if (results[index] != null) {
+        continue;
+      }
+      while (isMovedOrRemoved[previousIndex]) {
+        previousIndex++;
+      }
+      results[index] = previous[previousIndex++];
+    }
+
+    for (final index in changed) {
+      results[index] = rows[index];
+    }
+
+    return results.cast<Result>();
+  }
+
+  @override
+  String toString() => 'QueryResultsDiff('
+      'length: $length, '
+      'removed: $removed, '
+      'inserted: $inserted, '
+      'moved: $moved, '
+      'changed: $changed)';
+}
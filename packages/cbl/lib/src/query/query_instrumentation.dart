@@ -0,0 +1,181 @@
+import '../database/database.dart';
+import '../tracing.dart';
+import 'query.dart';
+
+/// Opt-in instrumentation of [Query]s, which captures their query plans and
+/// records how they perform.
+///
+/// While this instrumentation is [enabled], the plan of a query is captured
+/// when the query is prepared. The plan is inspected for full scans, which are
+/// scans of a collection that do not use an index. Queries that do full scans
+/// usually become slow as the collection grows and are reported to
+/// [onFullScan].
+///
+/// Every execution of a query is recorded, together with the time it took to
+/// execute and the number of rows that have been read from its results.
+///
+/// Only queries of [SyncDatabase]s are instrumented, since the queries of
+/// [AsyncDatabase]s are executed in a worker isolate.
+///
+/// The [stats] are also available to [TracingDelegate]s, through
+/// [QueryOperationOp.stats].
+///
+/// {@category Query}
+abstract final class QueryInstrumentation {
+  /// Whether queries which are prepared from now on are instrumented.
+  ///
+  /// The default is `false`.
+  static bool enabled = false;
+
+  /// Callback which is called when the plan of a query is captured and it
+  /// includes full scans.
+  ///
+  /// The callback is called once for every distinct query.
+  static void Function(QueryStats stats)? onFullScan;
+
+  /// The stats of all instrumented queries.
+  ///
+  /// Queries with the same definition, for the same database, share their
+  /// stats.
+  static List<QueryStats> get stats => List.unmodifiable(_stats.values);
+
+  /// Discards the stats of all instrumented queries.
+  static void reset() => _stats.clear();
+}
+
+/// Stats of an instrumented [Query].
+///
+/// See also:
+///
+/// - [QueryInstrumentation] for enabling the instrumentation of queries.
+///
+/// {@category Query}
+abstract final class QueryStats {
+  /// The name of the database the query belongs to.
+  String get databaseName;
+
+  /// The definition of the query, either its SQL++ or its JSON representation.
+  String get query;
+
+  /// The explanation of the query plan, as returned by [Query.explain].
+  ///
+  /// Is `null` until the query has been prepared.
+  String? get plan;
+
+  /// The lines of the [plan] which describe full scans.
+  List<String> get fullScans;
+
+  /// Whether the [plan] includes full scans.
+  bool get usesFullScan;
+
+  /// The number of times the query has been executed.
+  int get executionCount;
+
+  /// The total time the executions of the query took.
+  ///
+  /// This includes only the time to execute the query, not the time to read
+  /// its results.
+  Duration get totalExecutionTime;
+
+  /// The average time an execution of the query took.
+  Duration get averageExecutionTime;
+
+  /// The total number of rows that have been read from result sets of the
+  /// query, which have been read to the end.
+  int get rowCount;
+}
+
+// === Impl ====================================================================
+
+final _stats = <(String, String), QueryStatsImpl>{};
+
+final _planLinePattern = RegExp(r'^(\d+\|)*\s*');
+
+/// Returns all lines of a query [plan] which describe scans that do not use an
+/// index.
+List<String> findFullScans(String plan) => plan
+    .split('\n')
+    .map((line) => line.replaceFirst(_planLinePattern, ''))
+    .where((line) =>
+        line.startsWith('SCAN ') &&
+        !line.contains(' USING ') &&
+        !line.startsWith('SCAN CONSTANT ROW') &&
+        !line.startsWith('SCAN SUBQUERY'))
+    .toList();
+
+final class QueryStatsImpl implements QueryStats {
+  QueryStatsImpl._(this.databaseName, this.query);
+
+  /// Returns the shared stats for [query] of the database with
+  /// [databaseName], or `null` if [QueryInstrumentation.enabled] is `false`.
+  static QueryStatsImpl? forQuery(String databaseName, String query) {
+    if (!QueryInstrumentation.enabled) {
+      return null;
+    }
+    return _stats.putIfAbsent(
+      (databaseName, query),
+      () => QueryStatsImpl._(databaseName, query),
+    );
+  }
+
+  @override
+  final String databaseName;
+
+  @override
+  final String query;
+
+  @override
+  String? plan;
+
+  @override
+  List<String> fullScans = const [];
+
+  @override
+  bool get usesFullScan => fullScans.isNotEmpty;
+
+  @override
+  int executionCount = 0;
+
+  @override
+  Duration totalExecutionTime = Duration.zero;
+
+  @override
+  Duration get averageExecutionTime => executionCount == 0
+      ? Duration.zero
+      : totalExecutionTime ~/ executionCount;
+
+  @override
+  int rowCount = 0;
+
+  /// Whether the plan still has to be captured through [capturePlan].
+  bool get needsPlan => plan == null;
+
+  void capturePlan(String plan) {
+    this.plan = plan;
+    fullScans = List.unmodifiable(findFullScans(plan));
+    if (usesFullScan) {
+      QueryInstrumentation.onFullScan?.call(this);
+    }
+  }
+
+  void recordExecution(Duration duration) {
+    executionCount++;
+    totalExecutionTime += duration;
+  }
+
+  void recordRows(int count) => rowCount += count;
+
+  @override
+  String toString() => [
+        'QueryStats(',
+        query,
+        ' | ',
+        [
+          'executionCount: $executionCount',
+          'averageExecutionTime: $averageExecutionTime',
+          'rowCount: $rowCount',
+          if (usesFullScan) 'FULL-SCAN',
+        ].join(', '),
+        ')',
+      ].join();
+}
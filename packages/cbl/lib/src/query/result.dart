@@ -13,6 +13,7 @@ import '../fleece/encoder.dart';
 import '../fleece/integration/integration.dart';
 import '../service/cbl_service_api.dart';
 import '../support/encoding.dart';
+import 'query.dart';
 import 'result_set.dart';
 
 /// A single row in a [ResultSet].
@@ -110,6 +111,15 @@ abstract final class Result
   /// Returns a JSON string which contains a dictionary of the named columns of
   /// this result.
   String toJson();
+
+  /// The document of this result, which has been loaded together with this
+  /// result, because its query has been executed with
+  /// [SyncQuery.executeWithDocuments].
+  ///
+  /// Is `null` if the document does not exist.
+  ///
+  /// Throws a [StateError] if the query has not been executed with documents.
+  Document? get document;
 }
 
 final class ResultImpl with IterableMixin<String> implements Result {
@@ -144,6 +154,7 @@ final class ResultImpl with IterableMixin<String> implements Result {
     required List<String> columnNames,
   })  : _context = context,
         _columnNames = columnNames,
+        _documentFactory = null,
         columnValuesArray = null,
         columnValuesData = data;
 
@@ -151,12 +162,17 @@ final class ResultImpl with IterableMixin<String> implements Result {
   ///
   /// The [context] can be shared with other [Result]s, if it is guaranteed that
   /// all results are from the same chunk of encoded Fleece data.
+  ///
+  /// If [document] is provided, it is called to create the [Result.document]
+  /// of the result, when it is first accessed.
   ResultImpl.fromValuesArray(
     fl.Array array, {
     required DatabaseMContext context,
     required List<String> columnNames,
+    Document? Function()? document,
   })  : _context = context,
         _columnNames = columnNames,
+        _documentFactory = document,
         columnValuesArray = array,
         columnValuesData = null;
 
@@ -164,6 +180,8 @@ final class ResultImpl with IterableMixin<String> implements Result {
   final List<String> _columnNames;
   final Data? columnValuesData;
   final fl.Array? columnValuesArray;
+  final Document? Function()? _documentFactory;
+  late final Document? _document = _documentFactory!();
 
   late final ArrayImpl _array = _createArray();
   late final DictionaryImpl _dictionary = _createDictionary();
@@ -289,7 +307,19 @@ final class ResultImpl with IterableMixin<String> implements Result {
   List<Object?> toPlainList() => _array.toPlainList();
 
   @override
-  Map<String, Object?> toPlainMap() => _dictionary.toPlainMap();
+  Map<String, Object?> toPlainMap() {
+    // Decoding the column values as a list allows them to be decoded directly
+    // from the Fleece data, which the dictionary of this result is not
+    // backed by.
+    final values = _array.toPlainList();
+    return {
+      for (var i = 0; i < _columnNames.length; i++) _columnNames[i]: values[i],
+    };
+  }
+
+  @override
+  List<Object?> project(KeyPathProjection projection) =>
+      _dictionary.project(projection);
 
   @override
   String toJson() {
@@ -300,6 +330,16 @@ final class ResultImpl with IterableMixin<String> implements Result {
     return utf8.decode(sliceResult.asTypedList());
   }
 
+  @override
+  Document? get document {
+    if (_documentFactory == null) {
+      throw StateError(
+        'The query of this result has not been executed with documents.',
+      );
+    }
+    return _document;
+  }
+
   EncodedData encodeColumnValues(EncodingFormat format) {
     fl.Array columnValues;
 
@@ -323,7 +363,8 @@ final class ResultImpl with IterableMixin<String> implements Result {
     }
 
     final encoder = FleeceEncoder(format: format.toFLEncoderFormat())
-      ..writeValue(columnValues.pointer);
+      ..writeValue(columnValues.pointer)
+      ..keepAlive(columnValues);
     return EncodedData(format, encoder.finish());
   }
 
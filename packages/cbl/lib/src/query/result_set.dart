@@ -1,7 +1,10 @@
 import 'dart:async';
+import 'dart:convert';
+import 'dart:typed_data';
 
 import 'package:meta/meta.dart';
 
+import '../bindings.dart';
 import '../database/database_base.dart';
 import '../document/common.dart';
 import '../fleece/decoder.dart';
@@ -30,6 +33,18 @@ abstract interface class ResultSet {
   @experimental
   Stream<D> asTypedStream<D extends TypedDictionaryObject>();
 
+  /// Returns a stream which consumes this result set and emits its results as
+  /// a JSON array of objects, in chunks of UTF-8 encoded bytes.
+  ///
+  /// Each object maps the column names of a result to its values, like
+  /// [Result.toJson]. The results are written to JSON without decoding them
+  /// into Dart objects first.
+  ///
+  /// A result set can only be consumed once and listening to the returned
+  /// stream counts as consuming it. Other methods for consuming this result set
+  /// must not be used when using a stream.
+  Stream<Uint8List> asJsonStream();
+
   /// Consumes this result set and returns a list of all its [Result]s.
   FutureOr<List<Result>> allResults();
 
@@ -55,6 +70,16 @@ abstract interface class SyncResultSet
   @override
   @experimental
   List<D> allTypedResults<D extends TypedDictionaryObject>();
+
+  /// Consumes this result set and returns the given [columns] of its remaining
+  /// results, in columnar form.
+  ///
+  /// [columns] maps the names or indexes of the columns to extract to the
+  /// type to extract them as. The columns are extracted natively, in a single
+  /// pass over the results, without decoding the results into Dart objects.
+  ///
+  /// Throws a [RangeError] if a column name or index is out of range.
+  ColumnarResultSet toColumnar(Map<Object, ColumnarType> columns);
 }
 
 /// A [ResultSet] which can be iterated asynchronously.
@@ -69,6 +94,259 @@ abstract interface class AsyncResultSet extends ResultSet {
   Future<List<D>> allTypedResults<D extends TypedDictionaryObject>();
 }
 
+/// The type as which a column of a [ColumnarResultSet] is extracted.
+///
+/// {@category Query}
+enum ColumnarType {
+  /// The column is extracted into an [Int64ResultColumn].
+  int64,
+
+  /// The column is extracted into a [Float64ResultColumn].
+  float64,
+
+  /// The column is extracted into a [StringResultColumn].
+  string,
+}
+
+/// Columns of the results of a [SyncResultSet], which have been extracted
+/// into typed data.
+///
+/// See also:
+///
+/// - [SyncResultSet.toColumnar] for extracting columns from a result set.
+///
+/// {@category Query}
+abstract final class ColumnarResultSet {
+  /// The number of results which have been extracted.
+  int get length;
+
+  /// The names of the extracted columns, in the order in which they have been
+  /// requested.
+  List<String> get columnNames;
+
+  /// The extracted columns, in the order in which they have been requested.
+  List<ResultColumn> get columns;
+
+  /// Returns the extracted column with the given [nameOrIndex].
+  ///
+  /// [nameOrIndex] refers to the name or index of the column in the results of
+  /// the query, not to its position in [columns].
+  ///
+  /// Throws an [ArgumentError] if the column has not been extracted.
+  ResultColumn operator [](Object nameOrIndex);
+}
+
+/// A column of a [ColumnarResultSet].
+///
+/// A value is null if it is missing, `null` or not of the type of the column.
+/// Booleans are extracted as numbers. Numbers are converted to the type of the
+/// column, truncating floating point numbers when extracting integers.
+///
+/// The typed data of a column is a view of native memory, which is freed when
+/// the typed data is no longer reachable.
+///
+/// {@category Query}
+sealed class ResultColumn {
+  ResultColumn._(this.name, this.index, this.length, this.validity);
+
+  /// The name of this column in the results of the query.
+  final String name;
+
+  /// The index of this column in the results of the query.
+  final int index;
+
+  /// The number of values in this column.
+  final int length;
+
+  /// A bitmap with one bit for each value, which is set if the value is not
+  /// null.
+  ///
+  /// The bit of value `i` is bit `i % 8` of byte `i ~/ 8`.
+  final Uint8List validity;
+
+  /// Whether the value at [row] is null.
+  bool isNull(int row) {
+    RangeError.checkValidIndex(row, this, 'row', length);
+    return validity[row >> 3] & (1 << (row & 7)) == 0;
+  }
+}
+
+/// A [ResultColumn] of integers.
+///
+/// {@category Query}
+final class Int64ResultColumn extends ResultColumn {
+  Int64ResultColumn._(
+    super.name,
+    super.index,
+    super.length,
+    super.validity,
+    this.values,
+  ) : super._();
+
+  /// The values of this column, which are `0` for null values.
+  final Int64List values;
+
+  /// Returns the value at [row], or `null` if it is null.
+  int? operator [](int row) => isNull(row) ? null : values[row];
+}
+
+/// A [ResultColumn] of floating point numbers.
+///
+/// {@category Query}
+final class Float64ResultColumn extends ResultColumn {
+  Float64ResultColumn._(
+    super.name,
+    super.index,
+    super.length,
+    super.validity,
+    this.values,
+  ) : super._();
+
+  /// The values of this column, which are `0.0` for null values.
+  final Float64List values;
+
+  /// Returns the value at [row], or `null` if it is null.
+  double? operator [](int row) => isNull(row) ? null : values[row];
+}
+
+/// A [ResultColumn] of strings.
+///
+/// {@category Query}
+final class StringResultColumn extends ResultColumn {
+  StringResultColumn._(
+    super.name,
+    super.index,
+    super.length,
+    super.validity,
+    this.offsets,
+    this.bytes,
+  ) : super._();
+
+  /// The offsets of the strings of this column in [bytes].
+  ///
+  /// Contains [length] + 1 offsets. The string of row `i` spans from
+  /// `offsets[i]` to `offsets[i + 1]`, which is empty for null values.
+  final Uint32List offsets;
+
+  /// The UTF-8 encoded strings of this column, one after the other.
+  final Uint8List bytes;
+
+  /// Returns the value at [row], or `null` if it is null.
+  String? operator [](int row) => isNull(row)
+      ? null
+      : utf8.decode(Uint8List.sublistView(
+          bytes,
+          offsets[row],
+          offsets[row + 1],
+        ));
+}
+
+final class ColumnarResultSetImpl implements ColumnarResultSet {
+  ColumnarResultSetImpl(this.length, this.columns);
+
+  /// Creates a [ColumnarResultSetImpl] from the [data] of the [length]
+  /// results of the extracted [columns], as tuples of column names,
+  /// indexes and types.
+  factory ColumnarResultSetImpl.fromColumnData(
+    int length,
+    List<(String, int, ColumnarType)> columns,
+    List<CBLColumnData> data,
+  ) =>
+      ColumnarResultSetImpl(length, [
+        for (var i = 0; i < columns.length; i++)
+          _createColumn(length, columns[i], data[i]),
+      ]);
+
+  static ResultColumn _createColumn(
+    int length,
+    (String, int, ColumnarType) column,
+    CBLColumnData data,
+  ) {
+    final (name, index, type) = column;
+    final validity = data.validity?.asTypedList() ?? Uint8List(0);
+    return switch (type) {
+      ColumnarType.int64 => Int64ResultColumn._(
+          name,
+          index,
+          length,
+          validity,
+          data.values!.asAlignedInt64List(length),
+        ),
+      ColumnarType.float64 => Float64ResultColumn._(
+          name,
+          index,
+          length,
+          validity,
+          data.values!.asAlignedFloat64List(length),
+        ),
+      ColumnarType.string => StringResultColumn._(
+          name,
+          index,
+          length,
+          validity,
+          data.offsets!.asAlignedUint32List(length + 1),
+          data.values?.asTypedList() ?? Uint8List(0),
+        ),
+    };
+  }
+
+  @override
+  final int length;
+
+  @override
+  final List<ResultColumn> columns;
+
+  @override
+  List<String> get columnNames => [for (final column in columns) column.name];
+
+  @override
+  ResultColumn operator [](Object nameOrIndex) {
+    for (final column in columns) {
+      if (nameOrIndex is int
+          ? column.index == nameOrIndex
+          : column.name == nameOrIndex) {
+        return column;
+      }
+    }
+    throw ArgumentError.value(
+      nameOrIndex,
+      'nameOrIndex',
+      'is not an extracted column',
+    );
+  }
+
+  @override
+  String toString() => 'ColumnarResultSet(length: $length, '
+      'columns: ${columnNames.join(', ')})';
+}
+
+/// The number of bytes after which [ResultSet.asJsonStream] implementations
+/// emit a chunk.
+const resultSetJsonChunkSize = 64 * 1024;
+
+/// Writes [results] as a JSON array of objects, in chunks of UTF-8 encoded
+/// bytes.
+///
+/// This is the fallback for [ResultSet.asJsonStream] implementations which
+/// cannot write their results to JSON natively.
+Stream<Uint8List> resultsAsJsonStream(Stream<Result> results) async* {
+  final builder = BytesBuilder(copy: false)..addByte(0x5B); // [
+  var isFirst = true;
+  await for (final result in results) {
+    if (!isFirst) {
+      builder.addByte(0x2C); // ,
+    }
+    isFirst = false;
+    builder.add(utf8.encode(result.toJson()));
+
+    if (builder.length >= resultSetJsonChunkSize) {
+      yield builder.takeBytes();
+    }
+  }
+  builder.addByte(0x5D); // ]
+  yield builder.takeBytes();
+}
+
 /// Creates a [DatabaseMContext] for use in [ResultSet] implementations.
 ///
 /// Result sets don't use the shared keys of the database and so must not use
@@ -81,9 +359,13 @@ abstract interface class AsyncResultSet extends ResultSet {
 ///
 /// Result sets also cannot use a [SharedStringsTable] because the CBL C SDK
 /// does not return strictly immutable Fleece data from the result set API.
+/// Instead they use an [InterningSharedStringsTable], which identifies strings
+/// by their content, so that strings which are repeated across the rows of the
+/// result set are only decoded once.
 DatabaseMContext createResultSetMContext(DatabaseBase database) =>
     DatabaseMContext(
       database: database,
       dictKeys: OptimizingDictKeys(),
       sharedKeysTable: SharedKeysTable(),
+      sharedStringsTable: InterningSharedStringsTable(),
     );
@@ -81,7 +81,10 @@ final class SelectImpl extends QueryBase
   FutureOr<String> explain() => useSync(() => throw UnimplementedError());
 
   @override
-  FutureOr<ListenerToken> addChangeListener(QueryChangeListener listener) =>
+  FutureOr<ListenerToken> addChangeListener(
+    QueryChangeListener listener, {
+    Duration? minInterval,
+  }) =>
       useSync(() => throw UnimplementedError());
 
   @override
@@ -89,7 +92,8 @@ final class SelectImpl extends QueryBase
       useSync(() => throw UnimplementedError());
 
   @override
-  Stream<QueryChange> changes() => useSync(() => throw UnimplementedError());
+  Stream<QueryChange> changes({Duration? minInterval}) =>
+      useSync(() => throw UnimplementedError());
 
   // coverage:ignore-end
 }
@@ -11,6 +11,8 @@ export 'replication/configuration.dart'
 export 'replication/conflict.dart' show Conflict, TypedConflict;
 export 'replication/conflict_resolver.dart'
     show
+        BuiltInConflictResolver,
+        ConflictResolutionStrategy,
         ConflictResolver,
         ConflictResolverFunction,
         TypedConflictResolver,
@@ -20,10 +22,14 @@ export 'replication/document_replication.dart'
 export 'replication/endpoint.dart' show Endpoint, UrlEndpoint, DatabaseEndpoint;
 export 'replication/replicator.dart'
     show
+        LatencyHistogram,
         Replicator,
+        ReplicatorMetrics,
         ReplicatorProgress,
         ReplicatorActivityLevel,
         ReplicatorStatus,
         SyncReplicator,
         AsyncReplicator;
 export 'replication/replicator_change.dart' show ReplicatorChange;
+export 'replication/replicator_scheduler.dart'
+    show ReplicatorScheduler, ReplicatorSchedulerStats;
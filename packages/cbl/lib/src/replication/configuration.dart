@@ -1,6 +1,7 @@
 // ignore_for_file: deprecated_member_use_from_same_package
 
 import 'dart:async';
+import 'dart:convert';
 import 'dart:typed_data';
 
 import 'package:meta/meta.dart';
@@ -8,6 +9,7 @@ import 'package:meta/meta.dart';
 import '../database.dart';
 import '../database/database_base.dart';
 import '../document.dart';
+import '../query/expressions/expression.dart';
 import '../support/utils.dart';
 import '../typed_data.dart';
 import '../typed_data/adapter.dart';
@@ -84,6 +86,8 @@ final class CollectionConfiguration {
     this.documentIds,
     this.pushFilter,
     this.pullFilter,
+    this.pushFilterExpression,
+    this.pullFilterExpression,
     this.conflictResolver,
   });
 
@@ -94,6 +98,8 @@ final class CollectionConfiguration {
         documentIds = config.documentIds,
         pushFilter = config.pushFilter,
         pullFilter = config.pullFilter,
+        pushFilterExpression = config.pushFilterExpression,
+        pullFilterExpression = config.pullFilterExpression,
         conflictResolver = config.conflictResolver;
 
   /// A set of Sync Gateway channel names to pull from.
@@ -122,10 +128,46 @@ final class CollectionConfiguration {
   /// Only documents for which the function returns `true` are replicated.
   ReplicationFilter? pullFilter;
 
+  /// A filter expression for validating whether [Document]s can be pushed to
+  /// the remote endpoint.
+  ///
+  /// {@template cbl.CollectionConfiguration.filterExpression}
+  /// Unlike a [ReplicationFilter], the expression is evaluated natively,
+  /// without waiting for the isolate, which makes it considerably faster.
+  /// Only documents for which the expression evaluates to `true` are
+  /// replicated. If a filter function is configured as well, it is only
+  /// called for documents which pass the expression.
+  ///
+  /// The expression can use properties of the document, `Meta.id`,
+  /// `Meta.revisionId`, `Meta.sequence` and `Meta.isDeleted`, literal
+  /// values, the logical, comparison, `IS`, `LIKE`, `IN` and `BETWEEN`
+  /// operators, and `ArrayExpression` range predicates. Expressions which
+  /// use other features or refer to data source aliases cause the creation
+  /// of the replicator to fail.
+  ///
+  /// ```dart
+  /// final config = CollectionConfiguration(
+  ///   pushFilterExpression: Expression.property('type')
+  ///       .equalTo(Expression.string('order'))
+  ///       .and(Meta.isDeleted.equalTo(Expression.boolean(false))),
+  /// );
+  /// ```
+  /// {@endtemplate}
+  ExpressionInterface? pushFilterExpression;
+
+  /// A filter expression for validating whether [Document]s can be pulled
+  /// from the remote endpoint.
+  ///
+  /// {@macro cbl.CollectionConfiguration.filterExpression}
+  ExpressionInterface? pullFilterExpression;
+
   /// A custom conflict resolver.
   ///
   /// If this value is not set, or set to `null`, the default conflict resolver
   /// will be applied.
+  ///
+  /// A [BuiltInConflictResolver] is executed natively, without calling into
+  /// Dart, and should be preferred if one of its strategies fits.
   ConflictResolver? conflictResolver;
 
   @override
@@ -136,6 +178,8 @@ final class CollectionConfiguration {
           if (documentIds != null) 'documentIds: $documentIds',
           if (pushFilter != null) 'PUSH-FILTER',
           if (pullFilter != null) 'PULL-FILTER',
+          if (pushFilterExpression != null) 'PUSH-FILTER-EXPRESSION',
+          if (pullFilterExpression != null) 'PULL-FILTER-EXPRESSION',
           if (conflictResolver != null) 'CUSTOM-CONFLICT-RESOLVER',
         ].join(', '),
         ')'
@@ -175,11 +219,16 @@ final class ReplicatorConfiguration {
     Duration? heartbeat,
     int? maxAttempts,
     Duration? maxAttemptWaitTime,
+    Duration? callbackDeadline,
+    this.callbackDeadlineFilterResult = false,
+    Duration? callbackLatencyBudget,
   }) : _collections = {} {
     this
       ..heartbeat = heartbeat
       ..maxAttempts = maxAttempts
-      ..maxAttemptWaitTime = maxAttemptWaitTime;
+      ..maxAttemptWaitTime = maxAttemptWaitTime
+      ..callbackDeadline = callbackDeadline
+      ..callbackLatencyBudget = callbackLatencyBudget;
 
     if (typedPushFilter != null ||
         typedPullFilter != null ||
@@ -211,7 +260,10 @@ final class ReplicatorConfiguration {
         enableAutoPurge = config.enableAutoPurge,
         _heartbeat = config.heartbeat,
         _maxAttempts = config.maxAttempts,
-        _maxAttemptWaitTime = config.maxAttemptWaitTime;
+        _maxAttemptWaitTime = config.maxAttemptWaitTime,
+        _callbackDeadline = config.callbackDeadline,
+        callbackDeadlineFilterResult = config.callbackDeadlineFilterResult,
+        _callbackLatencyBudget = config.callbackLatencyBudget;
 
   final Map<Collection, CollectionConfiguration> _collections;
 
@@ -393,6 +445,76 @@ final class ReplicatorConfiguration {
     _maxAttemptWaitTime = maxAttemptWaitTime;
   }
 
+  /// The maximum time the replicator waits for a call to a filter or conflict
+  /// resolver to complete.
+  ///
+  /// Filters and conflict resolvers which are implemented in Dart block the
+  /// replicator while they are running. When a call does not complete within
+  /// this deadline, the replicator stops waiting for it and continues with a
+  /// fallback result:
+  ///
+  /// - Filters use [callbackDeadlineFilterResult].
+  /// - Conflict resolvers resolve the conflict with the local document.
+  ///
+  /// The result of a call which completes after its deadline is ignored.
+  /// Calls which missed their deadline are counted in
+  /// [ReplicatorMetrics.callbacksTimedOut].
+  ///
+  /// Setting this value to [Duration.zero] or a negative [Duration] will result
+  /// in an [RangeError] being thrown.
+  ///
+  /// To wait for calls without a deadline, which is the default, set this
+  /// property to `null`.
+  Duration? get callbackDeadline => _callbackDeadline;
+  Duration? _callbackDeadline;
+
+  set callbackDeadline(Duration? callbackDeadline) {
+    if (callbackDeadline != null && callbackDeadline.inMilliseconds <= 0) {
+      throw RangeError.range(
+        callbackDeadline.inMilliseconds,
+        1,
+        null,
+        'callbackDeadline.inMilliseconds',
+      );
+    }
+    _callbackDeadline = callbackDeadline;
+  }
+
+  /// The result of a filter call which did not complete within
+  /// [callbackDeadline].
+  ///
+  /// Defaults to `false`, which means that the document is not replicated.
+  bool callbackDeadlineFilterResult;
+
+  /// The duration a call to a filter or conflict resolver is expected to take
+  /// at most.
+  ///
+  /// Calls which take longer are counted in
+  /// [ReplicatorMetrics.callbacksOverBudget], but are otherwise unaffected.
+  /// This allows detecting callbacks which are slowing down replication,
+  /// before they have to be cut off with a [callbackDeadline].
+  ///
+  /// Setting this value to [Duration.zero] or a negative [Duration] will result
+  /// in an [RangeError] being thrown.
+  ///
+  /// To not track calls against a budget, which is the default, set this
+  /// property to `null`.
+  Duration? get callbackLatencyBudget => _callbackLatencyBudget;
+  Duration? _callbackLatencyBudget;
+
+  set callbackLatencyBudget(Duration? callbackLatencyBudget) {
+    if (callbackLatencyBudget != null &&
+        callbackLatencyBudget.inMilliseconds <= 0) {
+      throw RangeError.range(
+        callbackLatencyBudget.inMilliseconds,
+        1,
+        null,
+        'callbackLatencyBudget.inMilliseconds',
+      );
+    }
+    _callbackLatencyBudget = callbackLatencyBudget;
+  }
+
   /// Configures a [Collection] for replication.
   ///
   /// If no [CollectionConfiguration] is given, the default configuration will
@@ -479,6 +601,12 @@ final class ReplicatorConfiguration {
         if (maxAttempts != null) 'maxAttempts: $maxAttempts',
         if (maxAttemptWaitTime != null)
           'maxAttemptWaitTime: ${_maxAttemptWaitTime!.inSeconds}s',
+        if (callbackDeadline != null)
+          'callbackDeadline: ${_callbackDeadline!.inMilliseconds}ms',
+        if (callbackDeadline != null && callbackDeadlineFilterResult)
+          'ACCEPT-AFTER-DEADLINE',
+        if (callbackLatencyBudget != null)
+          'callbackLatencyBudget: ${_callbackLatencyBudget!.inMilliseconds}ms',
       ].join(', '),
       ')'
     ].join();
@@ -496,6 +624,19 @@ Map<String, String> _redactHeaders(Map<String, String> headers) {
   };
 }
 
+extension InternalCollectionConfiguration on CollectionConfiguration {
+  String? get encodedPushFilterExpression =>
+      _encodeFilterExpression(pushFilterExpression);
+
+  String? get encodedPullFilterExpression =>
+      _encodeFilterExpression(pullFilterExpression);
+}
+
+String? _encodeFilterExpression(ExpressionInterface? expression) =>
+    expression == null
+        ? null
+        : jsonEncode((expression as ExpressionImpl).toJson());
+
 extension InternalReplicatorConfiguration on ReplicatorConfiguration {
   ReplicationFilter? get combinedPushFilter => combineReplicationFilters(
         pushFilter,
@@ -95,6 +95,126 @@ final class DefaultConflictResolver implements ConflictResolver {
   }
 }
 
+/// A strategy of a [BuiltInConflictResolver].
+///
+/// {@category Replication}
+enum ConflictResolutionStrategy {
+  /// Resolves conflicts to the remote revision, including deletions.
+  remoteWins,
+
+  /// Resolves conflicts to the local revision, including deletions.
+  localWins,
+
+  /// Resolves conflicts to the revision with the greater timestamp.
+  ///
+  /// See [BuiltInConflictResolver.lastWriteWins].
+  lastWriteWins,
+
+  /// Resolves conflicts by merging the top-level properties of both revisions.
+  ///
+  /// See [BuiltInConflictResolver.mergeDicts].
+  mergeDicts,
+}
+
+/// A [ConflictResolver] which uses one of the built-in
+/// [ConflictResolutionStrategy]s.
+///
+/// When used with a [Replicator] that is running in the current isolate, the
+/// strategy is executed natively on the thread of the replicator, without
+/// calling into Dart. This can make a big difference when many conflicts need
+/// to be resolved, for example after a long period offline.
+///
+/// {@category Replication}
+final class BuiltInConflictResolver implements ConflictResolver {
+  /// Creates a resolver which resolves conflicts to the remote revision.
+  const BuiltInConflictResolver.remoteWins()
+      : strategy = ConflictResolutionStrategy.remoteWins,
+        timestampKeyPath = null;
+
+  /// Creates a resolver which resolves conflicts to the local revision.
+  const BuiltInConflictResolver.localWins()
+      : strategy = ConflictResolutionStrategy.localWins,
+        timestampKeyPath = null;
+
+  /// Creates a resolver which resolves conflicts to the revision with the
+  /// greater timestamp at [timestampKeyPath].
+  ///
+  /// Timestamps can be numbers, for example milliseconds since the epoch, or
+  /// strings which sort chronologically, for example ISO 8601 timestamps in
+  /// UTC. A revision with a timestamp wins against a revision without one.
+  /// If both timestamps are equal, the default conflict resolution strategy is
+  /// used. If the document has been deleted on either side, it is deleted.
+  const BuiltInConflictResolver.lastWriteWins(String this.timestampKeyPath)
+      : strategy = ConflictResolutionStrategy.lastWriteWins;
+
+  /// Creates a resolver which resolves conflicts by merging the top-level
+  /// properties of both revisions into a new revision.
+  ///
+  /// Properties which exist in both revisions are taken from the local
+  /// revision. If the document has been deleted on either side, it is deleted.
+  const BuiltInConflictResolver.mergeDicts()
+      : strategy = ConflictResolutionStrategy.mergeDicts,
+        timestampKeyPath = null;
+
+  /// The strategy that this resolver uses.
+  final ConflictResolutionStrategy strategy;
+
+  /// The key path of the timestamp that is used by
+  /// [ConflictResolutionStrategy.lastWriteWins].
+  final String? timestampKeyPath;
+
+  @override
+  FutureOr<Document?> resolve(Conflict conflict) {
+    final localDocument = conflict.localDocument;
+    final remoteDocument = conflict.remoteDocument;
+
+    switch (strategy) {
+      case ConflictResolutionStrategy.remoteWins:
+        return remoteDocument;
+      case ConflictResolutionStrategy.localWins:
+        return localDocument;
+      case ConflictResolutionStrategy.lastWriteWins:
+      case ConflictResolutionStrategy.mergeDicts:
+        break;
+    }
+
+    if (localDocument == null || remoteDocument == null) {
+      return null;
+    }
+
+    if (strategy == ConflictResolutionStrategy.mergeDicts) {
+      final mergedDocument = remoteDocument.toMutable();
+      for (final key in localDocument.keys) {
+        mergedDocument.setValue(localDocument.value(key), key: key);
+      }
+      return mergedDocument;
+    }
+
+    final projection = KeyPathProjection([timestampKeyPath!]);
+    final comparison = _compareTimestamps(
+      localDocument.project(projection).single,
+      remoteDocument.project(projection).single,
+    );
+    if (comparison == 0) {
+      return const DefaultConflictResolver().resolve(conflict);
+    }
+
+    return comparison > 0 ? localDocument : remoteDocument;
+  }
+}
+
+int _compareTimestamps(Object? local, Object? remote) {
+  if (local is num && remote is num) {
+    return local.compareTo(remote);
+  }
+  if (local is String && remote is String) {
+    return local.compareTo(remote);
+  }
+
+  int isTimestamp(Object? value) => value is num || value is String ? 1 : 0;
+  return isTimestamp(local) - isTimestamp(remote);
+}
+
 /// Functional version of [TypedConflictResolver].
 ///
 /// {@category Replication}
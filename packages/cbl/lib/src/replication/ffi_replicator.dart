@@ -1,6 +1,7 @@
 // ignore_for_file: deprecated_member_use_from_same_package
 
 import 'dart:async';
+import 'dart:collection';
 import 'dart:ffi';
 import 'dart:io';
 
@@ -16,6 +17,7 @@ import '../support/edition.dart';
 import '../support/errors.dart';
 import '../support/ffi.dart';
 import '../support/listener_token.dart';
+import '../support/native_stats.dart';
 import '../support/resource.dart';
 import '../support/streams.dart';
 import '../support/utils.dart';
@@ -98,8 +100,13 @@ final class FfiReplicator
 
       final pushFilterCallback = config.pushFilter?.let(createFilterCallback);
       final pullFilterCallback = config.pullFilter?.let(createFilterCallback);
-      final conflictResolverCallback =
-          config.conflictResolver?.let(createConflictResolverCallback);
+      // Built-in conflict resolvers are executed natively.
+      final conflictResolver = config.conflictResolver;
+      final builtInConflictResolver =
+          conflictResolver is BuiltInConflictResolver ? conflictResolver : null;
+      final conflictResolverCallback = builtInConflictResolver == null
+          ? conflictResolver?.let(createConflictResolverCallback)
+          : null;
 
       callbacks.addAll([
         pushFilterCallback,
@@ -120,7 +127,14 @@ final class FfiReplicator
         documentIDs: documentIDsArray?.pointer.cast(),
         pushFilter: pushFilterCallback?.pointer,
         pullFilter: pullFilterCallback?.pointer,
+        pushFilterExpression: config.encodedPushFilterExpression,
+        pullFilterExpression: config.encodedPullFilterExpression,
         conflictResolver: conflictResolverCallback?.pointer,
+        conflictResolutionStrategy:
+            builtInConflictResolver?.strategy.toCBLDartStrategy() ??
+                CBLDartConflictResolutionStrategy.custom,
+        conflictResolutionTimestampKeyPath:
+            builtInConflictResolver?.timestampKeyPath,
       );
     }).toList();
 
@@ -142,6 +156,9 @@ final class FfiReplicator
       trustedRootCertificates: config.trustedRootCertificates?.toData(),
       collections: replicationCollections,
       disableAutoPurge: !config.enableAutoPurge,
+      callbackTimeout: config.callbackDeadline,
+      callbackTimeoutFilterResult: config.callbackDeadlineFilterResult,
+      callbackLatencyBudget: config.callbackLatencyBudget,
     );
 
     try {
@@ -182,8 +199,10 @@ final class FfiReplicator
   final void Function() _closeCallbacks;
 
   var _isStarted = false;
+  var _isScheduled = false;
   var _isStopping = false;
   Completer<void>? _stopped;
+  AbstractListenerToken? _stoppedListenerToken;
 
   @override
   ReplicatorConfiguration get config => ReplicatorConfiguration.from(_config);
@@ -194,36 +213,78 @@ final class FfiReplicator
   ReplicatorStatus get _status =>
       _bindings.status(pointer).toReplicatorStatus();
 
+  @override
+  ReplicatorMetrics get metrics =>
+      useSync(() => _bindings.metrics(pointer).toReplicatorMetrics());
+
   @override
   void start({bool reset = false}) => useSync(() {
-        if (_database.ownsCurrentTransaction) {
-          throw DatabaseException(
-            'A replicator cannot be started from within a database '
-            'transaction.',
-            DatabaseErrorCode.transactionNotClosed,
-          );
-        }
+        _checkIsNotInTransaction();
 
         if (_isStarted) {
           return;
         }
-        _isStarted = true;
-        _isStopping = false;
-
-        late AbstractListenerToken token;
-        token = _addChangeListener((change) {
-          if (change.status.activity == ReplicatorActivityLevel.stopped) {
-            _isStarted = false;
-            _isStopping = false;
-            _stopped?.complete();
-            _stopped = null;
-            token.removeListener();
-          }
-        });
+        _didStart();
 
         _bindings.start(pointer, resetCheckpoint: reset);
       });
 
+  @override
+  void schedule({int priority = 0, bool reset = false}) => useSync(() {
+        _checkIsNotInTransaction();
+        RangeError.checkValueInInterval(
+          priority,
+          -0x80000000,
+          0x7FFFFFFF,
+          'priority',
+        );
+
+        if (_isStarted && !_isScheduled) {
+          return;
+        }
+        if (!_isStarted) {
+          _didStart();
+          _isScheduled = true;
+        }
+
+        _bindings.schedule(
+          _database.pointer,
+          pointer,
+          resetCheckpoint: reset,
+          priority: priority,
+        );
+      });
+
+  void _checkIsNotInTransaction() {
+    if (_database.ownsCurrentTransaction) {
+      throw DatabaseException(
+        'A replicator cannot be started from within a database '
+        'transaction.',
+        DatabaseErrorCode.transactionNotClosed,
+      );
+    }
+  }
+
+  void _didStart() {
+    _isStarted = true;
+    _isStopping = false;
+    _stoppedListenerToken = _addChangeListener((change) {
+      if (change.status.activity == ReplicatorActivityLevel.stopped) {
+        _didStop();
+      }
+    });
+  }
+
+  void _didStop() {
+    _isStarted = false;
+    _isScheduled = false;
+    _isStopping = false;
+    _stopped?.complete();
+    _stopped = null;
+    _stoppedListenerToken?.removeListener();
+    _stoppedListenerToken = null;
+  }
+
   @override
   void stop() => useSync(_stop);
 
@@ -233,6 +294,15 @@ final class FfiReplicator
     }
     _isStopping = true;
 
+    if (_isScheduled) {
+      _isScheduled = false;
+      if (!_bindings.unschedule(pointer)) {
+        // The replicator was still waiting to be started by the scheduler.
+        _didStop();
+        return;
+      }
+    }
+
     // As a workaround for a bug in Couchbase Lite, a replicator is only stopped
     // when it is not connecting. The bug can cause a crash if a replicator is
     // stopped before the web socket connection to the target has been
@@ -256,10 +326,19 @@ final class FfiReplicator
   }
 
   @override
-  ListenerToken addChangeListener(ReplicatorChangeListener listener) =>
-      useSync(() => _addChangeListener(listener).also(_listenerTokens.add));
+  ListenerToken addChangeListener(
+    ReplicatorChangeListener listener, {
+    Duration? minInterval,
+  }) =>
+      useSync(() => _addChangeListener(listener, minInterval: minInterval)
+          .also(_listenerTokens.add));
+
+  AbstractListenerToken _addChangeListener(
+    ReplicatorChangeListener listener, {
+    Duration? minInterval,
+  }) {
+    checkListenerMinInterval(minInterval);
 
-  AbstractListenerToken _addChangeListener(ReplicatorChangeListener listener) {
     final database = _database;
     final callback = AsyncCallback(
       (arguments) {
@@ -271,31 +350,40 @@ final class FfiReplicator
         return null;
       },
       debugName: 'FfiReplicator.addChangeListener',
+      maxBatchSize: AsyncCallback.listenerMaxBatchSize,
     );
 
-    _bindings.addChangeListener(database.pointer, pointer, callback.pointer);
+    _bindings.addChangeListener(
+      database.pointer,
+      pointer,
+      callback.pointer,
+      minInterval: minInterval ?? Duration.zero,
+    );
 
     return FfiListenerToken(callback);
   }
 
   @override
   ListenerToken addDocumentReplicationListener(
-    DocumentReplicationListener listener,
-  ) =>
-      useSync(() =>
-          _addDocumentReplicationListener(listener).also(_listenerTokens.add));
+    DocumentReplicationListener listener, {
+    bool errorsOnly = false,
+  }) =>
+      useSync(() => _addDocumentReplicationListener(
+            listener,
+            errorsOnly: errorsOnly,
+          ).also(_listenerTokens.add));
 
   AbstractListenerToken _addDocumentReplicationListener(
-    DocumentReplicationListener listener,
-  ) {
+    DocumentReplicationListener listener, {
+    bool errorsOnly = false,
+  }) {
     final database = _database;
     final callback = AsyncCallback(
       (arguments) {
         final message =
             DocumentReplicationsCallbackMessage.fromArguments(arguments);
 
-        final documents =
-            message.documents.map((it) => it.toReplicatedDocument()).toList();
+        final documents = _ReplicatedDocumentList(message.documents);
 
         final replication =
             DocumentReplicationImpl(this, message.isPush, documents);
@@ -303,12 +391,14 @@ final class FfiReplicator
         return null;
       },
       debugName: 'FfiReplicator.addDocumentReplicationListener',
+      maxBatchSize: AsyncCallback.listenerMaxBatchSize,
     );
 
     _bindings.addDocumentReplicationListener(
       database.pointer,
       pointer,
       callback.pointer,
+      errorsOnly: errorsOnly,
     );
 
     return FfiListenerToken(callback);
@@ -321,18 +411,23 @@ final class FfiReplicator
       });
 
   @override
-  Stream<ReplicatorChange> changes() => useSync(_changes);
-
-  Stream<ReplicatorChange> _changes() => ListenerStream(
-        parent: this,
-        addListener: _addChangeListener,
-      );
+  Stream<ReplicatorChange> changes({Duration? minInterval}) =>
+      useSync(() => ListenerStream(
+            parent: this,
+            addListener: (listener) =>
+                _addChangeListener(listener, minInterval: minInterval),
+          ));
 
   @override
-  Stream<DocumentReplication> documentReplications() =>
+  Stream<DocumentReplication> documentReplications({
+    bool errorsOnly = false,
+  }) =>
       useSync(() => ListenerStream(
             parent: this,
-            addListener: _addDocumentReplicationListener,
+            addListener: (listener) => _addDocumentReplicationListener(
+              listener,
+              errorsOnly: errorsOnly,
+            ),
           ));
 
   @override
@@ -369,6 +464,23 @@ final class FfiReplicator
             collection.pointer,
           ));
 
+  @override
+  List<bool> areDocumentsPendingInCollection(
+    List<String> documentIds,
+    covariant FfiCollection collection,
+  ) =>
+      useSync(() => _bindings.areDocumentsPending(
+            pointer,
+            documentIds,
+            collection.pointer,
+          ));
+
+  @override
+  int pendingDocumentCountInCollection(covariant FfiCollection collection) =>
+      useSync(
+        () => _bindings.pendingDocumentCount(pointer, collection.pointer),
+      );
+
   @override
   Future<void> performClose() async {
     await _ensureIsStopped();
@@ -377,13 +489,13 @@ final class FfiReplicator
 
   Future<void> _ensureIsStopped() async {
     if (_isStarted) {
-      _stopped = Completer<void>();
+      final stopped = _stopped = Completer<void>();
 
       if (!_isStopping) {
         _stop();
       }
 
-      await _stopped!.future;
+      await stopped.future;
     }
   }
 
@@ -403,6 +515,19 @@ extension on ReplicatorType {
   CBLReplicatorType toCBLReplicatorType() => CBLReplicatorType.values[index];
 }
 
+extension on ConflictResolutionStrategy {
+  CBLDartConflictResolutionStrategy toCBLDartStrategy() => switch (this) {
+        ConflictResolutionStrategy.remoteWins =>
+          CBLDartConflictResolutionStrategy.remoteWins,
+        ConflictResolutionStrategy.localWins =>
+          CBLDartConflictResolutionStrategy.localWins,
+        ConflictResolutionStrategy.lastWriteWins =>
+          CBLDartConflictResolutionStrategy.lastWriteWins,
+        ConflictResolutionStrategy.mergeDicts =>
+          CBLDartConflictResolutionStrategy.mergeDicts,
+      };
+}
+
 extension on CBLReplicatorActivityLevel {
   ReplicatorActivityLevel toReplicatorActivityLevel() =>
       ReplicatorActivityLevel.values[index];
@@ -424,6 +549,37 @@ extension on CBLReplicatorStatus {
       );
 }
 
+extension on CBLDart_ReplicatorMetrics {
+  ReplicatorMetrics toReplicatorMetrics() => ReplicatorMetrics(
+        documentsPushed: documentsPushed,
+        documentsPulled: documentsPulled,
+        documentErrors: documentErrors,
+        pushFilter: pushFilter.toLatencyHistogram(),
+        pullFilter: pullFilter.toLatencyHistogram(),
+        conflictResolver: conflictResolver.toLatencyHistogram(),
+        callbacksOverBudget: callbacksOverBudget,
+        callbacksTimedOut: callbacksTimedOut,
+      );
+}
+
+/// The [ReplicatedDocument]s of a document replication event, which are only
+/// created when they are accessed.
+final class _ReplicatedDocumentList extends ListBase<ReplicatedDocument>
+    with UnmodifiableListMixin<ReplicatedDocument> {
+  _ReplicatedDocumentList(this._documents)
+      : _replicatedDocuments = List.filled(_documents.length, null);
+
+  final List<CBLReplicatedDocument> _documents;
+  final List<ReplicatedDocument?> _replicatedDocuments;
+
+  @override
+  int get length => _documents.length;
+
+  @override
+  ReplicatedDocument operator [](int index) =>
+      _replicatedDocuments[index] ??= _documents[index].toReplicatedDocument();
+}
+
 extension on CBLReplicatedDocument {
   ReplicatedDocument toReplicatedDocument() => ReplicatedDocumentImpl(
         id,
@@ -480,16 +636,27 @@ AsyncCallback _createReplicationFilterCallback(
 }) =>
     AsyncCallback(
       (arguments) async {
-        final message =
-            ReplicationFilterCallbackMessage.fromArguments(arguments);
-        final doc = DelegateDocument(
-          FfiDocumentDelegate.fromPointer(message.document),
-          collection: collection,
-        );
+        // The native side sends the documents which are filtered concurrently
+        // in batches.
+        final messages =
+            ReplicationFilterCallbackMessage.batchFromArguments(arguments);
+        final decisions = <bool>[];
+        for (final message in messages) {
+          final doc = DelegateDocument(
+            FfiDocumentDelegate.fromPointer(message.document),
+            collection: collection,
+          );
+
+          decisions.add(await filter(
+            doc,
+            message.flags
+                .map((flag) => flag.toReplicatedDocumentFlag())
+                .toSet(),
+          ));
+        }
 
-        return filter(
-          doc,
-          message.flags.map((flag) => flag.toReplicatedDocumentFlag()).toSet(),
+        return ReplicationFilterCallbackMessage.encodeBatchDecisions(
+          decisions,
         );
       },
       errorResult: false,
@@ -525,18 +692,16 @@ AsyncCallback _createConflictResolverCallback(
         if (resolved != null) {
           if (!identical(resolved, local) && !identical(resolved, remote)) {
             resolvedDelegate = await collection.prepareDocument(resolved);
-
-            // If the resolver returned a document other than `local` or
-            // `remote`, the ref count of the resolved document needs to be
-            // incremented because the native conflict resolver callback is
-            // expected to returned a document with a ref count of +1, which the
-            // caller balances with a release. This must happen on the Dart
-            // side, because `resolvedDelegate` can be garbage collected before
-            // the document pointer makes it back to the native side.
-            cblBindings.base.retainRefCounted(resolvedDelegate.pointer.cast());
           } else {
             resolvedDelegate = resolved.delegate as FfiDocumentDelegate;
           }
+
+          // The resolved document is always returned with a ref count of +1,
+          // which the native side balances with a release. This must happen
+          // on the Dart side, because `resolvedDelegate` can be garbage
+          // collected before the document pointer makes it back to the native
+          // side.
+          cblBindings.base.retainRefCounted(resolvedDelegate.pointer.cast());
         }
 
         return resolvedDelegate?.pointer.address;
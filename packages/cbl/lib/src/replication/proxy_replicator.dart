@@ -72,9 +72,16 @@ final class ProxyReplicator extends ProxyObject
       final pullFilterId = config.pullFilter
           ?.let((it) => _wrapReplicationFilter(it, collection))
           .let(client.registerReplicationFilter);
-      final conflictResolverId = config.conflictResolver
-          ?.let((it) => _wrapConflictResolver(it, collection))
-          .let(client.registerConflictResolver);
+      // Built-in conflict resolvers are executed by the service, without
+      // calling back into this isolate.
+      final conflictResolver = config.conflictResolver;
+      final builtInConflictResolver =
+          conflictResolver is BuiltInConflictResolver ? conflictResolver : null;
+      final conflictResolverId = builtInConflictResolver == null
+          ? conflictResolver
+              ?.let((it) => _wrapConflictResolver(it, collection))
+              .let(client.registerConflictResolver)
+          : null;
 
       callbacksIds.addAll([
         pushFilterId,
@@ -88,7 +95,12 @@ final class ProxyReplicator extends ProxyObject
         documentIds: config.documentIds,
         pushFilterId: pushFilterId,
         pullFilterId: pullFilterId,
+        pushFilterExpression: config.encodedPushFilterExpression,
+        pullFilterExpression: config.encodedPullFilterExpression,
         conflictResolverId: conflictResolverId,
+        conflictResolutionStrategy: builtInConflictResolver?.strategy,
+        conflictResolutionTimestampKeyPath:
+            builtInConflictResolver?.timestampKeyPath,
       );
     }).toList();
 
@@ -106,6 +118,9 @@ final class ProxyReplicator extends ProxyObject
         heartbeat: config.heartbeat,
         maxAttempts: config.maxAttempts,
         maxAttemptWaitTime: config.maxAttemptWaitTime,
+        callbackDeadline: config.callbackDeadline,
+        callbackDeadlineFilterResult: config.callbackDeadlineFilterResult,
+        callbackLatencyBudget: config.callbackLatencyBudget,
         collections: createReplicatorCollections,
       ));
       return ProxyReplicator(
@@ -136,6 +151,12 @@ final class ProxyReplicator extends ProxyObject
             replicatorId: objectId,
           )));
 
+  @override
+  Future<ReplicatorMetrics> get metrics =>
+      use(() => channel.call(GetReplicatorMetrics(
+            replicatorId: objectId,
+          )));
+
   @override
   // ignore: prefer_expression_function_bodies
   Future<void> start({bool reset = false}) => use(() {
@@ -157,20 +178,47 @@ final class ProxyReplicator extends ProxyObject
                 )));
       });
 
+  @override
+  // ignore: prefer_expression_function_bodies
+  Future<void> schedule({int priority = 0, bool reset = false}) => use(() {
+        if (_database.ownsCurrentTransaction) {
+          throw DatabaseException(
+            'A replicator cannot be started from within a database '
+            'transaction.',
+            DatabaseErrorCode.transactionNotClosed,
+          );
+        }
+
+        return _database.asyncTransactionLock
+            .synchronized(() => channel.call(ScheduleReplicator(
+                  replicatorId: objectId,
+                  priority: priority,
+                  reset: reset,
+                )));
+      });
+
   @override
   Future<void> stop() => use(_stop);
 
   Future<void> _stop() => channel.call(StopReplicator(replicatorId: objectId));
 
   @override
-  Future<ListenerToken> addChangeListener(ReplicatorChangeListener listener) =>
+  Future<ListenerToken> addChangeListener(
+    ReplicatorChangeListener listener, {
+    Duration? minInterval,
+  }) =>
       use(() async {
-        final token = await _addChangeListener(listener);
+        final token =
+            await _addChangeListener(listener, minInterval: minInterval);
         return token.also(_listenerTokens.add);
       });
 
   Future<AbstractListenerToken> _addChangeListener(
-      ReplicatorChangeListener listener) async {
+    ReplicatorChangeListener listener, {
+    Duration? minInterval,
+  }) async {
+    checkListenerMinInterval(minInterval);
+
     late final ProxyListenerToken<ReplicatorChange> token;
     final listenerId =
         _database.client.registerReplicatorChangeListener((status) {
@@ -180,6 +228,7 @@ final class ProxyReplicator extends ProxyObject
     await channel.call(AddReplicatorChangeListener(
       replicatorId: objectId,
       listenerId: listenerId,
+      minInterval: minInterval,
     ));
 
     return token =
@@ -188,16 +237,21 @@ final class ProxyReplicator extends ProxyObject
 
   @override
   Future<ListenerToken> addDocumentReplicationListener(
-    DocumentReplicationListener listener,
-  ) =>
+    DocumentReplicationListener listener, {
+    bool errorsOnly = false,
+  }) =>
       use(() async {
-        final token = await _addDocumentReplicationListener(listener);
+        final token = await _addDocumentReplicationListener(
+          listener,
+          errorsOnly: errorsOnly,
+        );
         return token.also(_listenerTokens.add);
       });
 
   Future<AbstractListenerToken> _addDocumentReplicationListener(
-    DocumentReplicationListener listener,
-  ) async {
+    DocumentReplicationListener listener, {
+    bool errorsOnly = false,
+  }) async {
     late final ProxyListenerToken<DocumentReplication> token;
     final listenerId =
         _database.client.registerDocumentReplicationListener((event) {
@@ -211,6 +265,7 @@ final class ProxyReplicator extends ProxyObject
     await channel.call(AddDocumentReplicationListener(
       replicatorId: objectId,
       listenerId: listenerId,
+      errorsOnly: errorsOnly,
     ));
 
     return token =
@@ -222,16 +277,23 @@ final class ProxyReplicator extends ProxyObject
       use(() => _listenerTokens.remove(token));
 
   @override
-  AsyncListenStream<ReplicatorChange> changes() => useSync(() => ListenerStream(
-        parent: this,
-        addListener: _addChangeListener,
-      ));
+  AsyncListenStream<ReplicatorChange> changes({Duration? minInterval}) =>
+      useSync(() => ListenerStream(
+            parent: this,
+            addListener: (listener) =>
+                _addChangeListener(listener, minInterval: minInterval),
+          ));
 
   @override
-  AsyncListenStream<DocumentReplication> documentReplications() =>
+  AsyncListenStream<DocumentReplication> documentReplications({
+    bool errorsOnly = false,
+  }) =>
       useSync(() => ListenerStream(
             parent: this,
-            addListener: _addDocumentReplicationListener,
+            addListener: (listener) => _addDocumentReplicationListener(
+              listener,
+              errorsOnly: errorsOnly,
+            ),
           ));
 
   @override
@@ -269,6 +331,26 @@ final class ProxyReplicator extends ProxyObject
             collectionId: collection.objectId,
           )));
 
+  @override
+  Future<List<bool>> areDocumentsPendingInCollection(
+    List<String> documentIds,
+    covariant ProxyCollection collection,
+  ) =>
+      use(() => channel.call(ReplicatorAreDocumentsPending(
+            replicatorId: objectId,
+            documentIds: documentIds,
+            collectionId: collection.objectId,
+          )));
+
+  @override
+  Future<int> pendingDocumentCountInCollection(
+    covariant ProxyCollection collection,
+  ) =>
+      use(() => channel.call(ReplicatorPendingDocumentCount(
+            replicatorId: objectId,
+            collectionId: collection.objectId,
+          )));
+
   @override
   FutureOr<void> performClose() => finalizeEarly();
 
@@ -11,6 +11,7 @@ import 'document_replication.dart';
 import 'ffi_replicator.dart';
 import 'proxy_replicator.dart';
 import 'replicator_change.dart';
+import 'replicator_scheduler.dart';
 
 /// The states a [Replicator] can be in during its lifecycle.
 ///
@@ -87,6 +88,103 @@ final class ReplicatorStatus {
       ].join();
 }
 
+/// A histogram of durations, such as those of the calls to a replicator
+/// callback.
+///
+/// {@category Replication}
+final class LatencyHistogram {
+  LatencyHistogram({
+    required this.count,
+    required this.total,
+    required this.max,
+    required this.buckets,
+  });
+
+  /// The number of calls.
+  final int count;
+
+  /// The total duration of all calls.
+  final Duration total;
+
+  /// The duration of the longest call.
+  final Duration max;
+
+  /// The number of calls in each bucket of the histogram.
+  ///
+  /// The bucket at index `0` counts calls which took less than 1 microsecond
+  /// and the bucket at index `i` counts calls which took at least `2^(i - 1)`
+  /// and less than `2^i` microseconds. The last bucket also counts all longer
+  /// calls.
+  final List<int> buckets;
+
+  /// The average duration of a call.
+  Duration get average => count == 0 ? Duration.zero : total ~/ count;
+
+  @override
+  String toString() => 'LatencyHistogram(count: $count, average: $average, '
+      'max: $max)';
+}
+
+/// Metrics of a [Replicator], which are collected natively, since the
+/// replicator has been created.
+///
+/// Throughput can be derived by reading the metrics periodically and dividing
+/// the difference between two readings by the time between them.
+///
+/// {@category Replication}
+final class ReplicatorMetrics {
+  ReplicatorMetrics({
+    required this.documentsPushed,
+    required this.documentsPulled,
+    required this.documentErrors,
+    required this.pushFilter,
+    required this.pullFilter,
+    required this.conflictResolver,
+    this.callbacksOverBudget = 0,
+    this.callbacksTimedOut = 0,
+  });
+
+  /// The number of [Document]s which have been pushed.
+  final int documentsPushed;
+
+  /// The number of [Document]s which have been pulled.
+  final int documentsPulled;
+
+  /// The number of [Document]s whose replication failed.
+  final int documentErrors;
+
+  /// The durations of the calls to the push filters, including filter
+  /// expressions.
+  final LatencyHistogram pushFilter;
+
+  /// The durations of the calls to the pull filters, including filter
+  /// expressions.
+  final LatencyHistogram pullFilter;
+
+  /// The durations of the calls to the conflict resolvers, including
+  /// built-in conflict resolvers.
+  final LatencyHistogram conflictResolver;
+
+  /// The number of calls to filters and conflict resolvers which took longer
+  /// than [ReplicatorConfiguration.callbackLatencyBudget].
+  final int callbacksOverBudget;
+
+  /// The number of calls to filters and conflict resolvers which did not
+  /// complete within [ReplicatorConfiguration.callbackDeadline].
+  final int callbacksTimedOut;
+
+  @override
+  String toString() => 'ReplicatorMetrics('
+      'documentsPushed: $documentsPushed, '
+      'documentsPulled: $documentsPulled, '
+      'documentErrors: $documentErrors, '
+      'pushFilter: $pushFilter, '
+      'pullFilter: $pullFilter, '
+      'conflictResolver: $conflictResolver, '
+      'callbacksOverBudget: $callbacksOverBudget, '
+      'callbacksTimedOut: $callbacksTimedOut)';
+}
+
 /// A listener that is called when a [Replicator]s [Replicator.status] changes.
 ///
 /// {@category Replication}
@@ -152,6 +250,12 @@ abstract interface class Replicator implements ClosableResource {
   /// Returns this replicator's status.
   FutureOr<ReplicatorStatus> get status;
 
+  /// Returns the metrics of this replicator.
+  ///
+  /// The metrics are read with a single native call and are cheap enough to be
+  /// polled frequently.
+  FutureOr<ReplicatorMetrics> get metrics;
+
   /// Starts this replicator with an option to [reset] the local checkpoint of
   /// the replicator.
   ///
@@ -162,6 +266,18 @@ abstract interface class Replicator implements ClosableResource {
   /// will report its progress through the [changes] stream.
   FutureOr<void> start({bool reset = false});
 
+  /// Schedules this replicator to be started by the [ReplicatorScheduler],
+  /// once the scheduler has a free slot for it, with an option to [reset] the
+  /// local checkpoint of the replicator.
+  ///
+  /// Replicators with a higher [priority] are started first. Scheduling a
+  /// replicator which has already been scheduled updates its priority, for
+  /// example when the database of the replicator is moved to the foreground.
+  ///
+  /// Scheduling a replicator which has been started with [start] has no
+  /// effect. Stopping a scheduled replicator removes it from the scheduler.
+  FutureOr<void> schedule({int priority = 0, bool reset = false});
+
   /// Stops this replicator, if running.
   ///
   /// This method returns immediately; when the replicator actually stops, the
@@ -173,6 +289,14 @@ abstract interface class Replicator implements ClosableResource {
   /// Adds a [listener] to be notified of changes to the [status] of this
   /// replicator.
   ///
+  /// {@template cbl.Replicator.minInterval}
+  /// If [minInterval] is given, status changes which only update the progress
+  /// are delivered at most once per [minInterval], with the latest status.
+  /// Changes of the activity level and errors are always delivered
+  /// immediately. The progress updates are coalesced natively, before they
+  /// are sent to Dart.
+  /// {@endtemplate}
+  ///
   /// {@macro cbl.Collection.addChangeListener}
   ///
   /// See also:
@@ -181,7 +305,10 @@ abstract interface class Replicator implements ClosableResource {
   /// - [addDocumentReplicationListener] for listening for
   ///   [DocumentReplication]s performed by this replicator.
   /// - [removeChangeListener] for removing a previously added listener.
-  FutureOr<ListenerToken> addChangeListener(ReplicatorChangeListener listener);
+  FutureOr<ListenerToken> addChangeListener(
+    ReplicatorChangeListener listener, {
+    Duration? minInterval,
+  });
 
   /// Adds a [listener] to be notified of [DocumentReplication]s performed by
   /// this replicator.
@@ -194,6 +321,12 @@ abstract interface class Replicator implements ClosableResource {
   /// document replication events.
   /// {@endtemplate}
   ///
+  /// {@template cbl.Replicator.errorsOnly}
+  /// If [errorsOnly] is `true`, only documents whose replication failed are
+  /// reported. They are filtered before they are sent to Dart, and batches
+  /// without failed documents are not reported at all.
+  /// {@endtemplate}
+  ///
   /// {@macro cbl.Collection.addChangeListener}
   ///
   /// See also:
@@ -203,8 +336,9 @@ abstract interface class Replicator implements ClosableResource {
   ///   replicator.
   /// - [removeChangeListener] for removing a previously added listener.
   FutureOr<ListenerToken> addDocumentReplicationListener(
-    DocumentReplicationListener listener,
-  );
+    DocumentReplicationListener listener, {
+    bool errorsOnly = false,
+  });
 
   /// {@macro cbl.Collection.removeChangeListener}
   ///
@@ -221,8 +355,10 @@ abstract interface class Replicator implements ClosableResource {
   ///
   /// This is an alternative stream based API for the [addChangeListener] API.
   ///
+  /// {@macro cbl.Replicator.minInterval}
+  ///
   /// {@macro cbl.Collection.AsyncListenStream}
-  Stream<ReplicatorChange> changes();
+  Stream<ReplicatorChange> changes({Duration? minInterval});
 
   /// Returns a [Stream] to be notified of [DocumentReplication]s performed by
   /// this replicator.
@@ -232,8 +368,10 @@ abstract interface class Replicator implements ClosableResource {
   ///
   /// {@macro cbl.Replicator.addDocumentReplicationListener.listening}
   ///
+  /// {@macro cbl.Replicator.errorsOnly}
+  ///
   /// {@macro cbl.Collection.AsyncListenStream}
-  Stream<DocumentReplication> documentReplications();
+  Stream<DocumentReplication> documentReplications({bool errorsOnly = false});
 
   /// Returns a [Set] of ids for [Document]s in the default collection, who have
   /// revisions pending to be pushed.
@@ -267,6 +405,29 @@ abstract interface class Replicator implements ClosableResource {
     String documentId,
     Collection collection,
   );
+
+  /// Returns for each of the [Document]s with the given [documentIds], in the
+  /// given [collection], whether it has revisions pending to be pushed.
+  ///
+  /// The documents are checked with a single native call, which is much faster
+  /// than calling [isDocumentPendingInCollection] for each document.
+  ///
+  /// This API is a snapshot and the results may change between the time the
+  /// call was made and the time the call returns.
+  FutureOr<List<bool>> areDocumentsPendingInCollection(
+    List<String> documentIds,
+    Collection collection,
+  );
+
+  /// Returns the number of [Document]s in the given [collection] which have
+  /// revisions pending to be pushed.
+  ///
+  /// Unlike [pendingDocumentIdsInCollection], this method does not copy the
+  /// IDs of the pending documents.
+  ///
+  /// This API is a snapshot and the result may change between the time the
+  /// call was made and the time the call returns.
+  FutureOr<int> pendingDocumentCountInCollection(Collection collection);
 }
 
 /// A [Replicator] with a primarily synchronous API.
@@ -280,19 +441,29 @@ abstract interface class SyncReplicator implements Replicator {
   @override
   ReplicatorStatus get status;
 
+  @override
+  ReplicatorMetrics get metrics;
+
   @override
   void start({bool reset = false});
 
+  @override
+  void schedule({int priority = 0, bool reset = false});
+
   @override
   void stop();
 
   @override
-  ListenerToken addChangeListener(ReplicatorChangeListener listener);
+  ListenerToken addChangeListener(
+    ReplicatorChangeListener listener, {
+    Duration? minInterval,
+  });
 
   @override
   ListenerToken addDocumentReplicationListener(
-    DocumentReplicationListener listener,
-  );
+    DocumentReplicationListener listener, {
+    bool errorsOnly = false,
+  });
 
   @override
   void removeChangeListener(ListenerToken token);
@@ -313,6 +484,15 @@ abstract interface class SyncReplicator implements Replicator {
     String documentId,
     Collection collection,
   );
+
+  @override
+  List<bool> areDocumentsPendingInCollection(
+    List<String> documentIds,
+    Collection collection,
+  );
+
+  @override
+  int pendingDocumentCountInCollection(Collection collection);
 }
 
 /// A [Replicator] with a primarily asynchronous API.
@@ -326,28 +506,40 @@ abstract interface class AsyncReplicator implements Replicator {
   @override
   Future<ReplicatorStatus> get status;
 
+  @override
+  Future<ReplicatorMetrics> get metrics;
+
   @override
   Future<void> start({bool reset = false});
 
+  @override
+  Future<void> schedule({int priority = 0, bool reset = false});
+
   @override
   Future<void> stop();
 
   @override
-  Future<ListenerToken> addChangeListener(ReplicatorChangeListener listener);
+  Future<ListenerToken> addChangeListener(
+    ReplicatorChangeListener listener, {
+    Duration? minInterval,
+  });
 
   @override
   Future<ListenerToken> addDocumentReplicationListener(
-    DocumentReplicationListener listener,
-  );
+    DocumentReplicationListener listener, {
+    bool errorsOnly = false,
+  });
 
   @override
   Future<void> removeChangeListener(ListenerToken token);
 
   @override
-  AsyncListenStream<ReplicatorChange> changes();
+  AsyncListenStream<ReplicatorChange> changes({Duration? minInterval});
 
   @override
-  AsyncListenStream<DocumentReplication> documentReplications();
+  AsyncListenStream<DocumentReplication> documentReplications({
+    bool errorsOnly = false,
+  });
 
   @Deprecated('Use pendingDocumentIdsInCollection instead.')
   @override
@@ -365,4 +557,13 @@ abstract interface class AsyncReplicator implements Replicator {
     String documentId,
     Collection collection,
   );
+
+  @override
+  Future<List<bool>> areDocumentsPendingInCollection(
+    List<String> documentIds,
+    Collection collection,
+  );
+
+  @override
+  Future<int> pendingDocumentCountInCollection(Collection collection);
 }
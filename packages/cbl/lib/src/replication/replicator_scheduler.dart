@@ -0,0 +1,66 @@
+import '../bindings.dart';
+import 'replicator.dart';
+
+final _bindings = cblBindings.replicator;
+
+/// A native scheduler of [Replicator]s, which limits how many replicators are
+/// active at the same time.
+///
+/// Replicators are handed to the scheduler with [Replicator.schedule], instead
+/// of being started with [Replicator.start]. Waiting replicators are started in
+/// the order of their priority, highest first, and then in the order in which
+/// they were scheduled.
+///
+/// A one-shot replicator frees its slot when it stops. A continuous replicator
+/// which has become idle gives up its slot to a waiting replicator with at
+/// least the same priority, by being suspended until it is its turn again.
+/// This way continuous replicators take turns catching up, instead of all
+/// competing for the network and disk at the same time, for example when an
+/// app with many databases is launched.
+///
+/// The scheduler is shared by all isolates, including the worker isolates of
+/// `AsyncDatabase`s.
+///
+/// {@category Replication}
+abstract final class ReplicatorScheduler {
+  /// The maximum number of scheduled replicators which are active at the same
+  /// time.
+  ///
+  /// A value of `0` means that there is no limit. The default is `0`.
+  static int get maxActive => _bindings.schedulerStats().maxActive;
+
+  static set maxActive(int value) {
+    RangeError.checkValueInInterval(value, 0, 0xFFFFFFFF, 'maxActive');
+    _bindings.setSchedulerMaxActive(value);
+  }
+
+  /// The current stats of the scheduler.
+  static ReplicatorSchedulerStats get stats {
+    final stats = _bindings.schedulerStats();
+    return ReplicatorSchedulerStats._(
+      active: stats.active,
+      waiting: stats.waiting,
+    );
+  }
+}
+
+/// Stats of the [ReplicatorScheduler].
+///
+/// {@category Replication}
+final class ReplicatorSchedulerStats {
+  ReplicatorSchedulerStats._({
+    required this.active,
+    required this.waiting,
+  });
+
+  /// The number of scheduled replicators which are active.
+  final int active;
+
+  /// The number of scheduled replicators which are waiting to be started or
+  /// resumed.
+  final int waiting;
+
+  @override
+  String toString() =>
+      'ReplicatorSchedulerStats(active: $active, waiting: $waiting)';
+}
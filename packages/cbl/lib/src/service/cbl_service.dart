@@ -1,12 +1,17 @@
 import 'dart:async';
+import 'dart:convert';
 
 import '../bindings.dart';
 import '../database/collection.dart';
 import '../database/database.dart';
 import '../database/database_configuration.dart';
+import '../database/expiration_stats.dart';
 import '../database/ffi_database.dart';
+import '../database/full_text_search_result.dart';
+import '../database/maintenance_schedule.dart';
 import '../document/document.dart';
 import '../document/ffi_document.dart';
+import '../query/expressions/expression.dart';
 import '../query/ffi_query.dart';
 import '../query/index/index.dart';
 import '../query/parameters.dart';
@@ -274,22 +279,32 @@ final class CblService {
       ..addCallEndpoint(_getCollectionCount)
       ..addCallEndpoint(_getCollectionIndexes)
       ..addCallEndpoint(_getDocument)
+      ..addCallEndpoint(_getDocuments)
       ..addCallEndpoint(_saveDocument)
+      ..addCallEndpoint(_saveDocuments)
+      ..addCallEndpoint(_patchDocument)
+      ..addCallEndpoint(_readChangesSince)
       ..addCallEndpoint(_deleteDocument)
       ..addCallEndpoint(_purgeDocument)
       ..addCallEndpoint(_beginDatabaseTransaction)
       ..addCallEndpoint(_endDatabaseTransaction)
       ..addCallEndpoint(_setDocumentExpiration)
+      ..addCallEndpoint(_setDocumentExpirations)
       ..addCallEndpoint(_getDocumentExpiration)
+      ..addCallEndpoint(_getExpirationStats)
       ..addCallEndpoint(_performDatabaseMaintenance)
+      ..addCallEndpoint(_getDatabaseFileSize)
       ..addCallEndpoint(_changeDatabaseEncryptionKey)
       ..addCallEndpoint(_addCollectionChangeListener)
       ..addCallEndpoint(_addDocumentChangeListener)
       ..addCallEndpoint(_createIndex)
       ..addCallEndpoint(_deleteIndex)
+      ..addCallEndpoint(_fullTextSearch)
       ..addCallEndpoint(_blobExists)
       ..addStreamEndpoint(_readBlob)
       ..addCallEndpoint(_saveBlob)
+      ..addCallEndpoint(_saveBlobFromFile)
+      ..addCallEndpoint(_writeBlobToFile)
       ..addCallEndpoint(_createQuery)
       ..addCallEndpoint(_setQueryParameters)
       ..addCallEndpoint(_explainQuery)
@@ -298,12 +313,16 @@ final class CblService {
       ..addCallEndpoint(_addQueryChangeListener)
       ..addCallEndpoint(_createReplicator)
       ..addCallEndpoint(_getReplicatorStatus)
+      ..addCallEndpoint(_getReplicatorMetrics)
       ..addCallEndpoint(_startReplicator)
+      ..addCallEndpoint(_scheduleReplicator)
       ..addCallEndpoint(_stopReplicator)
       ..addCallEndpoint(_addReplicatorChangeListener)
       ..addCallEndpoint(_addDocumentReplicationsListener)
       ..addCallEndpoint(_replicatorIsDocumentPending)
-      ..addCallEndpoint(_replicatorPendingDocumentIds);
+      ..addCallEndpoint(_replicatorPendingDocumentIds)
+      ..addCallEndpoint(_replicatorAreDocumentsPending)
+      ..addCallEndpoint(_replicatorPendingDocumentCount);
   }
 
   final Channel channel;
@@ -449,6 +468,20 @@ final class CblService {
     );
   }
 
+  Future<List<DocumentState?>> _getDocuments(GetDocuments request) async {
+    final documents = _getCollectionById(request.collectionId)
+        .documents(request.documentIds);
+
+    return [
+      for (final document in documents.cast<DelegateDocument?>())
+        document?.createState(
+          withProperties: true,
+          propertiesFormat: request.propertiesFormat,
+          objectRegistry: _objectRegistry,
+        ),
+    ];
+  }
+
   Future<DocumentState?> _saveDocument(SaveDocument request) async {
     final collection = _getCollectionById(request.collectionId);
 
@@ -473,6 +506,47 @@ final class CblService {
     }
   }
 
+  Future<List<DocumentState?>> _saveDocuments(SaveDocuments request) async {
+    final collection = _getCollectionById(request.collectionId);
+
+    final documents = [
+      for (final state in request.states)
+        _getDocumentForUpdate<MutableDelegateDocument>(
+          state,
+          concurrencyControl: request.concurrencyControl,
+        )?..setEncodedProperties(state.properties!.encodedData!),
+    ];
+
+    final results = collection.saveDocuments(
+      documents.whereType<MutableDelegateDocument>().toList(),
+      request.concurrencyControl,
+    );
+
+    var resultIndex = 0;
+    return [
+      for (final document in documents)
+        if (document != null && results[resultIndex++])
+          document.createState(
+            withProperties: false,
+            objectRegistry: _objectRegistry,
+          )
+        else
+          null,
+    ];
+  }
+
+  MessageData _readChangesSince(ReadChangesSince request) => MessageData(
+        _getCollectionById(request.collectionId)
+            .readChangesSince(request.sequence, request.batchSize),
+      );
+
+  bool _patchDocument(PatchDocument request) =>
+      _getCollectionById(request.collectionId).patchDocument(
+        request.documentId,
+        request.patch,
+        request.concurrencyControl,
+      );
+
   Future<DocumentState?> _deleteDocument(DeleteDocument request) async {
     final collection = _getCollectionById(request.collectionId);
 
@@ -510,13 +584,23 @@ final class CblService {
       _getCollectionById(request.collectionId)
           .setDocumentExpiration(request.documentId, request.expiration);
 
+  void _setDocumentExpirations(SetDocumentExpirations request) =>
+      _getCollectionById(request.collectionId)
+          .setDocumentExpirations(request.expirations);
+
   DateTime? _getDocumentExpiration(GetDocumentExpiration request) =>
       _getCollectionById(request.collectionId)
           .getDocumentExpiration(request.documentId);
 
+  ExpirationStats _getExpirationStats(GetExpirationStats request) =>
+      _getCollectionById(request.collectionId).expirationStats;
+
   void _performDatabaseMaintenance(PerformDatabaseMaintenance request) =>
       _getDatabaseById(request.databaseId).performMaintenance(request.type);
 
+  int _getDatabaseFileSize(GetDatabaseFileSize request) =>
+      databaseFileSize(_getDatabaseById(request.databaseId).path!);
+
   void _changeDatabaseEncryptionKey(ChangeDatabaseEncryptionKey request) =>
       _getDatabaseById(request.databaseId)
           .changeEncryptionKey(request.encryptionKey);
@@ -534,9 +618,14 @@ final class CblService {
   void _addDocumentChangeListener(AddDocumentChangeListener request) {
     _listenerIdsToTokens[request.listenerId] =
         _getCollectionById(request.collectionId)
-            .addDocumentChangeListener(request.documentId, (_) {
-      channel.call(CallDocumentChangeListener(listenerId: request.listenerId));
-    });
+            .addDocumentChangeListener(
+      request.documentId,
+      (_) {
+        channel
+            .call(CallDocumentChangeListener(listenerId: request.listenerId));
+      },
+      debounce: request.debounce,
+    );
   }
 
   void _createIndex(CreateIndex request) =>
@@ -548,6 +637,19 @@ final class CblService {
   void _deleteIndex(DeleteIndex request) =>
       _getCollectionById(request.collectionId).deleteIndex(request.name);
 
+  List<FullTextSearchResult> _fullTextSearch(FullTextSearch request) =>
+      _getCollectionById(request.collectionId).fullTextSearch(
+        request.indexName,
+        request.query,
+        limit: request.limit,
+        offset: request.offset,
+        snippetProperty: request.snippetProperty,
+        snippetWordCount: request.snippetWordCount,
+        matchStart: request.matchStart,
+        matchEnd: request.matchEnd,
+        ellipsis: request.ellipsis,
+      );
+
   bool _blobExists(BlobExists request) => _getDatabaseById(request.databaseId)
       .blobStore
       .blobExists(request.properties);
@@ -555,7 +657,12 @@ final class CblService {
   Stream<MessageData> _readBlob(ReadBlob request) =>
       _getDatabaseById(request.databaseId)
           .blobStore
-          .readBlob(request.properties)!
+          .readBlob(
+            request.properties,
+            start: request.start,
+            end: request.end,
+            readAhead: request.readAhead,
+          )!
           .map(MessageData.new);
 
   Future<SaveBlobResponse> _saveBlob(SaveBlob request) async {
@@ -568,6 +675,16 @@ final class CblService {
     return SaveBlobResponse(properties);
   }
 
+  Future<SaveBlobResponse> _saveBlobFromFile(SaveBlobFromFile request) async =>
+      SaveBlobResponse(await _getDatabaseById(request.databaseId)
+          .blobStore
+          .saveBlobFromFile(request.contentType, request.path));
+
+  Future<bool> _writeBlobToFile(WriteBlobToFile request) =>
+      _getDatabaseById(request.databaseId)
+          .blobStore
+          .writeBlobToFile(request.properties, request.path);
+
   QueryState _createQuery(CreateQuery request) {
     final query = FfiQuery(
       database: _getDatabaseById(request.databaseId),
@@ -596,12 +713,15 @@ final class CblService {
 
   void _addQueryChangeListener(AddQueryChangeListener request) {
     _listenerIdsToTokens[request.listenerId] =
-        _getQueryById(request.queryId).addChangeListener((resultSetId) {
-      channel.call(CallQueryChangeListener(
-        listenerId: request.listenerId,
-        resultSetId: resultSetId,
-      ));
-    });
+        _getQueryById(request.queryId).addChangeListener(
+      (resultSetId) {
+        channel.call(CallQueryChangeListener(
+          listenerId: request.listenerId,
+          resultSetId: resultSetId,
+        ));
+      },
+      minInterval: request.minInterval,
+    );
   }
 
   Future<int> _createReplicator(CreateReplicator request) async {
@@ -634,6 +754,9 @@ final class CblService {
       heartbeat: request.heartbeat,
       maxAttempts: request.maxAttempts,
       maxAttemptWaitTime: request.maxAttemptWaitTime,
+      callbackDeadline: request.callbackDeadline,
+      callbackDeadlineFilterResult: request.callbackDeadlineFilterResult,
+      callbackLatencyBudget: request.callbackLatencyBudget,
     );
     for (final collection in request.collections) {
       config.addCollection(
@@ -643,7 +766,16 @@ final class CblService {
           documentIds: collection.documentIds,
           pushFilter: collection.pushFilterId?.let(createReplicationFilter),
           pullFilter: collection.pullFilterId?.let(createReplicationFilter),
-          conflictResolver:
+          pushFilterExpression: collection.pushFilterExpression
+              ?.let((it) => JsonExpression(jsonDecode(it))),
+          pullFilterExpression: collection.pullFilterExpression
+              ?.let((it) => JsonExpression(jsonDecode(it))),
+          conflictResolver: collection.conflictResolutionStrategy?.let(
+                (it) => _builtInConflictResolver(
+                  it,
+                  collection.conflictResolutionTimestampKeyPath,
+                ),
+              ) ??
               collection.conflictResolverId?.let(createConflictResolver),
         ),
       );
@@ -661,20 +793,30 @@ final class CblService {
   ReplicatorStatus _getReplicatorStatus(GetReplicatorStatus request) =>
       _getReplicatorById(request.replicatorId).status;
 
+  ReplicatorMetrics _getReplicatorMetrics(GetReplicatorMetrics request) =>
+      _getReplicatorById(request.replicatorId).metrics;
+
   void _startReplicator(StartReplicator request) =>
       _getReplicatorById(request.replicatorId).start(reset: request.reset);
 
+  void _scheduleReplicator(ScheduleReplicator request) =>
+      _getReplicatorById(request.replicatorId)
+          .schedule(priority: request.priority, reset: request.reset);
+
   void _stopReplicator(StopReplicator request) =>
       _getReplicatorById(request.replicatorId).stop();
 
   void _addReplicatorChangeListener(AddReplicatorChangeListener request) {
     _listenerIdsToTokens[request.listenerId] =
-        _getReplicatorById(request.replicatorId).addChangeListener((change) {
-      channel.call(CallReplicatorChangeListener(
-        listenerId: request.listenerId,
-        status: change.status,
-      ));
-    });
+        _getReplicatorById(request.replicatorId).addChangeListener(
+      (change) {
+        channel.call(CallReplicatorChangeListener(
+          listenerId: request.listenerId,
+          status: change.status,
+        ));
+      },
+      minInterval: request.minInterval,
+    );
   }
 
   void _addDocumentReplicationsListener(
@@ -682,15 +824,18 @@ final class CblService {
   ) {
     _listenerIdsToTokens[request.listenerId] =
         _getReplicatorById(request.replicatorId)
-            .addDocumentReplicationListener((change) {
-      channel.call(CallDocumentReplicationListener(
-        listenerId: request.listenerId,
-        event: DocumentReplicationEvent(
-          isPush: change.isPush,
-          documents: change.documents,
-        ),
-      ));
-    });
+            .addDocumentReplicationListener(
+      (change) {
+        channel.call(CallDocumentReplicationListener(
+          listenerId: request.listenerId,
+          event: DocumentReplicationEvent(
+            isPush: change.isPush,
+            documents: change.documents,
+          ),
+        ));
+      },
+      errorsOnly: request.errorsOnly,
+    );
   }
 
   bool _replicatorIsDocumentPending(ReplicatorIsDocumentPending request) =>
@@ -708,6 +853,22 @@ final class CblService {
           )
           .toList();
 
+  List<bool> _replicatorAreDocumentsPending(
+    ReplicatorAreDocumentsPending request,
+  ) =>
+      _getReplicatorById(request.replicatorId).areDocumentsPendingInCollection(
+        request.documentIds,
+        _getCollectionById(request.collectionId),
+      );
+
+  int _replicatorPendingDocumentCount(
+    ReplicatorPendingDocumentCount request,
+  ) =>
+      _getReplicatorById(request.replicatorId)
+          .pendingDocumentCountInCollection(
+        _getCollectionById(request.collectionId),
+      );
+
   // === Misc ==================================================================
 
   DatabaseState _createDatabaseState(SyncDatabase database) => DatabaseState(
@@ -835,6 +996,21 @@ final class _CBLIndexSpecIndex implements IndexImplInterface {
   CBLIndexSpec toCBLIndexSpec() => spec;
 }
 
+BuiltInConflictResolver _builtInConflictResolver(
+  ConflictResolutionStrategy strategy,
+  String? timestampKeyPath,
+) =>
+    switch (strategy) {
+      ConflictResolutionStrategy.remoteWins =>
+        const BuiltInConflictResolver.remoteWins(),
+      ConflictResolutionStrategy.localWins =>
+        const BuiltInConflictResolver.localWins(),
+      ConflictResolutionStrategy.lastWriteWins =>
+        BuiltInConflictResolver.lastWriteWins(timestampKeyPath!),
+      ConflictResolutionStrategy.mergeDicts =>
+        const BuiltInConflictResolver.mergeDicts(),
+    };
+
 final class _Query {
   _Query(this.query, this.resultEncoding);
 
@@ -844,6 +1020,8 @@ final class _Query {
   int _nextResultSetId = 0;
   final _resultSets = <int, ResultSet>{};
 
+  // The query is executed synchronously, so that it sees the parameters and
+  // the state of the database at the time of the request.
   int execute() => _storeResultSet(query.execute());
 
   int _storeResultSet(ResultSet resultSet) {
@@ -868,10 +1046,16 @@ final class _Query {
         }
       });
 
-  ListenerToken addChangeListener(void Function(int resultSetId) listener) =>
-      query.addChangeListener((change) {
-        listener(_storeResultSet(change.results));
-      });
+  ListenerToken addChangeListener(
+    void Function(int resultSetId) listener, {
+    Duration? minInterval,
+  }) =>
+      query.addChangeListener(
+        (change) {
+          listener(_storeResultSet(change.results));
+        },
+        minInterval: minInterval,
+      );
 }
 
 extension on ObjectRegistry {
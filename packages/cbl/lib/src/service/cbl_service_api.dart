@@ -12,6 +12,7 @@ import '../errors.dart';
 import '../fleece/containers.dart';
 import '../replication/authenticator.dart';
 import '../replication/configuration.dart';
+import '../replication/conflict_resolver.dart';
 import '../replication/document_replication.dart';
 import '../replication/endpoint.dart';
 import '../replication/replicator.dart';
@@ -66,7 +67,14 @@ SerializationRegistry cblServiceSerializationRegistry() =>
         GetCollectionIndexes.deserialize,
       )
       ..addSerializableCodec('GetDocument', GetDocument.deserialize)
+      ..addSerializableCodec('GetDocuments', GetDocuments.deserialize)
       ..addSerializableCodec('SaveDocument', SaveDocument.deserialize)
+      ..addSerializableCodec('SaveDocuments', SaveDocuments.deserialize)
+      ..addSerializableCodec('PatchDocument', PatchDocument.deserialize)
+      ..addSerializableCodec(
+        'ReadChangesSince',
+        ReadChangesSince.deserialize,
+      )
       ..addSerializableCodec('DeleteDocument', DeleteDocument.deserialize)
       ..addSerializableCodec('PurgeDocument', PurgeDocument.deserialize)
       ..addSerializableCodec(
@@ -81,10 +89,18 @@ SerializationRegistry cblServiceSerializationRegistry() =>
         'SetDocumentExpiration',
         SetDocumentExpiration.deserialize,
       )
+      ..addSerializableCodec(
+        'SetDocumentExpirations',
+        SetDocumentExpirations.deserialize,
+      )
       ..addSerializableCodec(
         'GetDocumentExpiration',
         GetDocumentExpiration.deserialize,
       )
+      ..addSerializableCodec(
+        'GetExpirationStats',
+        GetExpirationStats.deserialize,
+      )
       ..addSerializableCodec(
         'AddCollectionChangeListener',
         AddCollectionChangeListener.deserialize,
@@ -105,16 +121,23 @@ SerializationRegistry cblServiceSerializationRegistry() =>
         'PerformDatabaseMaintenance',
         PerformDatabaseMaintenance.deserialize,
       )
+      ..addSerializableCodec(
+        'GetDatabaseFileSize',
+        GetDatabaseFileSize.deserialize,
+      )
       ..addSerializableCodec(
         'ChangeDatabaseEncryptionKey',
         ChangeDatabaseEncryptionKey.deserialize,
       )
       ..addSerializableCodec('CreateIndex', CreateIndex.deserialize)
       ..addSerializableCodec('DeleteIndex', DeleteIndex.deserialize)
+      ..addSerializableCodec('FullTextSearch', FullTextSearch.deserialize)
       ..addSerializableCodec('BlobExists', BlobExists.deserialize)
       ..addSerializableCodec('ReadBlob', ReadBlob.deserialize)
       ..addSerializableCodec('SaveBlob', SaveBlob.deserialize)
       ..addSerializableCodec('ReadBlobUpload', ReadBlobUpload.deserialize)
+      ..addSerializableCodec('SaveBlobFromFile', SaveBlobFromFile.deserialize)
+      ..addSerializableCodec('WriteBlobToFile', WriteBlobToFile.deserialize)
       ..addSerializableCodec('CreateQuery', CreateQuery.deserialize)
       ..addSerializableCodec(
         'SetQueryParameters',
@@ -159,7 +182,15 @@ SerializationRegistry cblServiceSerializationRegistry() =>
         'GetReplicatorStatus',
         GetReplicatorStatus.deserialize,
       )
+      ..addSerializableCodec(
+        'GetReplicatorMetrics',
+        GetReplicatorMetrics.deserialize,
+      )
       ..addSerializableCodec('StartReplicator', StartReplicator.deserialize)
+      ..addSerializableCodec(
+        'ScheduleReplicator',
+        ScheduleReplicator.deserialize,
+      )
       ..addSerializableCodec('StopReplicator', StopReplicator.deserialize)
       ..addSerializableCodec(
         'AddReplicatorChangeListener',
@@ -185,6 +216,14 @@ SerializationRegistry cblServiceSerializationRegistry() =>
         'ReplicatorPendingDocumentIds',
         ReplicatorPendingDocumentIds.deserialize,
       )
+      ..addSerializableCodec(
+        'ReplicatorAreDocumentsPending',
+        ReplicatorAreDocumentsPending.deserialize,
+      )
+      ..addSerializableCodec(
+        'ReplicatorPendingDocumentCount',
+        ReplicatorPendingDocumentCount.deserialize,
+      )
 
       // CblService specific types
       ..addSerializableCodec('TransferableValue', TransferableValue.deserialize)
@@ -206,6 +245,13 @@ SerializationRegistry cblServiceSerializationRegistry() =>
             .toList(),
       )
       ..addSerializableCodec('DocumentState', DocumentState.deserialize)
+      ..addCodec<List<DocumentState?>>(
+        'List<DocumentState?>',
+        serialize: (value, context) => value.map(context.serialize).toList(),
+        deserialize: (value, context) => (value as List<Object?>)
+            .map(context.deserializeAs<DocumentState>)
+            .toList(),
+      )
       ..addSerializableCodec('SaveBlobResponse', SaveBlobResponse.deserialize)
       ..addSerializableCodec('QueryState', QueryState.deserialize)
       ..addSerializableCodec(
@@ -222,6 +268,14 @@ SerializationRegistry cblServiceSerializationRegistry() =>
             .toList(),
         handleSubTypes: true,
       )
+      ..addCodec<List<bool>>(
+        'List<bool>',
+        serialize: (value, context) => value,
+        deserialize: (value, context) => (value as List<Object?>)
+            .map((element) => element! as bool)
+            .toList(),
+        handleSubTypes: true,
+      )
       ..addCodec<Uri>(
         'Uri',
         serialize: (value, context) => value.toString(),
@@ -272,12 +326,16 @@ SerializationRegistry cblServiceSerializationRegistry() =>
         serialize: (value, context) => {
           'directory': value.directory,
           'encryptionKey':
-              context.serialize(value.encryptionKey as EncryptionKeyImpl?)
+              context.serialize(value.encryptionKey as EncryptionKeyImpl?),
+          'sharedHandle': value.sharedHandle,
+          'workerPoolSize': value.workerPoolSize,
         },
         deserialize: (map, context) => DatabaseConfiguration(
           directory: map.getAs('directory'),
           encryptionKey:
               context.deserializeAs<EncryptionKeyImpl>(map['encryptionKey']),
+          sharedHandle: map.getAs('sharedHandle'),
+          workerPoolSize: map.getAs('workerPoolSize'),
         ),
       )
       ..addCodec<ConcurrencyControl>(
@@ -311,6 +369,8 @@ SerializationRegistry cblServiceSerializationRegistry() =>
           'expressions': value.expressions,
           'ignoreAccents': value.ignoreAccents,
           'language': value.language,
+          'path': value.path,
+          'vector': context.serialize(value.vector),
         },
         deserialize: (map, context) => CBLIndexSpec(
           type: context.deserializeAs(map['type'])!,
@@ -318,6 +378,38 @@ SerializationRegistry cblServiceSerializationRegistry() =>
           expressions: map.getAs('expressions'),
           ignoreAccents: map.getAs('ignoreAccents'),
           language: map.getAs('language'),
+          path: map.getAs('path'),
+          vector: context.deserializeAs(map['vector']),
+        ),
+      )
+      ..addObjectCodec<CBLVectorIndexSpec>(
+        'CBLVectorIndexSpec',
+        serialize: (value, context) => {
+          'dimensions': value.dimensions,
+          'centroids': value.centroids,
+          'encodingType': value.encodingType.index,
+          'scalarQuantizerType': value.scalarQuantizerType?.index,
+          'subquantizers': value.subquantizers,
+          'bits': value.bits,
+          'metric': value.metric.index,
+          'minTrainingSize': value.minTrainingSize,
+          'maxTrainingSize': value.maxTrainingSize,
+          'numProbes': value.numProbes,
+        },
+        deserialize: (map, context) => CBLVectorIndexSpec(
+          dimensions: map.getAs('dimensions'),
+          centroids: map.getAs('centroids'),
+          encodingType:
+              CBLVectorEncodingType.values[map.getAs<int>('encodingType')],
+          scalarQuantizerType: map
+              .getAs<int?>('scalarQuantizerType')
+              ?.let((index) => CBLScalarQuantizerType.values[index]),
+          subquantizers: map.getAs('subquantizers'),
+          bits: map.getAs('bits'),
+          metric: CBLDistanceMetric.values[map.getAs<int>('metric')],
+          minTrainingSize: map.getAs('minTrainingSize'),
+          maxTrainingSize: map.getAs('maxTrainingSize'),
+          numProbes: map.getAs('numProbes'),
         ),
       )
 
@@ -394,6 +486,70 @@ SerializationRegistry cblServiceSerializationRegistry() =>
           context.deserializePolymorphic(map['error']),
         ),
       )
+      ..addObjectCodec<LatencyHistogram>(
+        'LatencyHistogram',
+        serialize: (value, context) => {
+          'count': value.count,
+          'total': context.serialize(value.total),
+          'max': context.serialize(value.max),
+          'buckets': value.buckets,
+        },
+        deserialize: (map, context) => LatencyHistogram(
+          count: map.getAs('count'),
+          total: context.deserializeAs(map['total'])!,
+          max: context.deserializeAs(map['max'])!,
+          buckets: map.getAs<List<Object?>>('buckets').cast(),
+        ),
+      )
+      ..addObjectCodec<ReplicatorMetrics>(
+        'ReplicatorMetrics',
+        serialize: (value, context) => {
+          'documentsPushed': value.documentsPushed,
+          'documentsPulled': value.documentsPulled,
+          'documentErrors': value.documentErrors,
+          'pushFilter': context.serialize(value.pushFilter),
+          'pullFilter': context.serialize(value.pullFilter),
+          'conflictResolver': context.serialize(value.conflictResolver),
+          'callbacksOverBudget': value.callbacksOverBudget,
+          'callbacksTimedOut': value.callbacksTimedOut,
+        },
+        deserialize: (map, context) => ReplicatorMetrics(
+          documentsPushed: map.getAs('documentsPushed'),
+          documentsPulled: map.getAs('documentsPulled'),
+          documentErrors: map.getAs('documentErrors'),
+          pushFilter: context.deserializeAs(map['pushFilter'])!,
+          pullFilter: context.deserializeAs(map['pullFilter'])!,
+          conflictResolver: context.deserializeAs(map['conflictResolver'])!,
+          callbacksOverBudget: map.getAs('callbacksOverBudget'),
+          callbacksTimedOut: map.getAs('callbacksTimedOut'),
+        ),
+      )
+      ..addObjectCodec<ExpirationStats>(
+        'ExpirationStats',
+        serialize: (value, context) => {
+          'purgedCount': value.purgedCount,
+          'pendingCount': value.pendingCount,
+          'nextExpiration': context.serialize(value.nextExpiration),
+        },
+        deserialize: (map, context) => ExpirationStats(
+          purgedCount: map.getAs('purgedCount'),
+          pendingCount: map.getAs('pendingCount'),
+          nextExpiration: context.deserializeAs(map['nextExpiration']),
+        ),
+      )
+      ..addObjectCodec<FullTextSearchResult>(
+        'FullTextSearchResult',
+        serialize: (value, context) => {
+          'id': value.id,
+          'rank': value.rank,
+          'snippet': value.snippet,
+        },
+        deserialize: (map, context) => FullTextSearchResult(
+          id: map.getAs('id'),
+          rank: map.getAs<num>('rank').toDouble(),
+          snippet: map.getAs('snippet'),
+        ),
+      )
       ..addObjectCodec<ReplicatedDocument>(
         'ReplicatedDocument',
         serialize: (value, context) => {
@@ -916,6 +1072,31 @@ final class GetDocument extends Request<DocumentState?> {
       );
 }
 
+final class GetDocuments extends Request<List<DocumentState?>> {
+  GetDocuments(this.collectionId, this.documentIds, this.propertiesFormat);
+
+  final int collectionId;
+  final List<String> documentIds;
+  final EncodingFormat? propertiesFormat;
+
+  @override
+  StringMap serialize(SerializationContext context) => {
+        'collectionId': collectionId,
+        'documentIds': context.serialize(documentIds),
+        'propertiesFormat': context.serialize(propertiesFormat),
+      };
+
+  static GetDocuments deserialize(
+    StringMap map,
+    SerializationContext context,
+  ) =>
+      GetDocuments(
+        map.getAs('collectionId'),
+        context.deserializeAs(map['documentIds'])!,
+        context.deserializeAs(map['propertiesFormat']),
+      );
+}
+
 final class SaveDocument extends Request<DocumentState?> {
   SaveDocument(
     this.collectionId,
@@ -951,6 +1132,114 @@ final class SaveDocument extends Request<DocumentState?> {
   void didReceive() => state.didReceive();
 }
 
+final class SaveDocuments extends Request<List<DocumentState?>> {
+  SaveDocuments(
+    this.collectionId,
+    this.states,
+    this.concurrencyControl,
+  );
+
+  final int collectionId;
+  final List<DocumentState> states;
+  final ConcurrencyControl concurrencyControl;
+
+  @override
+  StringMap serialize(SerializationContext context) => {
+        'collectionId': collectionId,
+        'states': states.map(context.serialize).toList(),
+        'concurrencyControl': context.serialize(concurrencyControl),
+      };
+
+  static SaveDocuments deserialize(
+    StringMap map,
+    SerializationContext context,
+  ) =>
+      SaveDocuments(
+        map.getAs('collectionId'),
+        map
+            .getAs<List<Object?>>('states')
+            .map((state) => context.deserializeAs<DocumentState>(state)!)
+            .toList(),
+        context.deserializeAs(map['concurrencyControl'])!,
+      );
+
+  @override
+  void willSend() {
+    for (final state in states) {
+      state.willSend();
+    }
+  }
+
+  @override
+  void didReceive() {
+    for (final state in states) {
+      state.didReceive();
+    }
+  }
+}
+
+final class PatchDocument extends Request<bool> {
+  PatchDocument(
+    this.collectionId,
+    this.documentId,
+    this.patch,
+    this.concurrencyControl,
+  );
+
+  final int collectionId;
+  final String documentId;
+  final StringMap patch;
+  final ConcurrencyControl concurrencyControl;
+
+  @override
+  StringMap serialize(SerializationContext context) => {
+        'collectionId': collectionId,
+        'documentId': documentId,
+        'patch': patch,
+        'concurrencyControl': context.serialize(concurrencyControl),
+      };
+
+  static PatchDocument deserialize(
+    StringMap map,
+    SerializationContext context,
+  ) =>
+      PatchDocument(
+        map.getAs('collectionId'),
+        map.getAs('documentId'),
+        map.getAs('patch'),
+        context.deserializeAs(map['concurrencyControl'])!,
+      );
+}
+
+final class ReadChangesSince extends Request<MessageData> {
+  ReadChangesSince({
+    required this.collectionId,
+    required this.sequence,
+    required this.batchSize,
+  });
+
+  final int collectionId;
+  final int sequence;
+  final int batchSize;
+
+  @override
+  StringMap serialize(SerializationContext context) => {
+        'collectionId': collectionId,
+        'sequence': sequence,
+        'batchSize': batchSize,
+      };
+
+  static ReadChangesSince deserialize(
+    StringMap map,
+    SerializationContext context,
+  ) =>
+      ReadChangesSince(
+        collectionId: map.getAs('collectionId'),
+        sequence: map.getAs('sequence'),
+        batchSize: map.getAs('batchSize'),
+      );
+}
+
 final class DeleteDocument extends Request<DocumentState?> {
   DeleteDocument(
     this.collectionId,
@@ -1076,6 +1365,39 @@ final class SetDocumentExpiration extends Request<Null> {
       );
 }
 
+final class SetDocumentExpirations extends Request<Null> {
+  SetDocumentExpirations({
+    required this.collectionId,
+    required this.expirations,
+  });
+
+  final int collectionId;
+  final Map<String, DateTime?> expirations;
+
+  @override
+  StringMap serialize(SerializationContext context) => {
+        'collectionId': collectionId,
+        'expirations': {
+          for (final MapEntry(key: id, value: expiration)
+              in expirations.entries)
+            id: context.serialize(expiration),
+        },
+      };
+
+  static SetDocumentExpirations deserialize(
+    StringMap map,
+    SerializationContext context,
+  ) =>
+      SetDocumentExpirations(
+        collectionId: map.getAs('collectionId'),
+        expirations: {
+          for (final MapEntry(key: id, value: expiration)
+              in map.getAs<StringMap>('expirations').entries)
+            id: context.deserializeAs<DateTime>(expiration),
+        },
+      );
+}
+
 final class GetDocumentExpiration extends Request<DateTime?> {
   GetDocumentExpiration({
     required this.collectionId,
@@ -1101,6 +1423,23 @@ final class GetDocumentExpiration extends Request<DateTime?> {
       );
 }
 
+final class GetExpirationStats extends Request<ExpirationStats> {
+  GetExpirationStats(this.collectionId);
+
+  final int collectionId;
+
+  @override
+  StringMap serialize(SerializationContext context) => {
+        'collectionId': collectionId,
+      };
+
+  static GetExpirationStats deserialize(
+    StringMap map,
+    SerializationContext context,
+  ) =>
+      GetExpirationStats(map.getAs('collectionId'));
+}
+
 final class AddCollectionChangeListener extends Request<Null> {
   AddCollectionChangeListener({
     required this.collectionId,
@@ -1156,17 +1495,20 @@ final class AddDocumentChangeListener extends Request<Null> {
     required this.collectionId,
     required this.documentId,
     required this.listenerId,
+    this.debounce,
   });
 
   final int collectionId;
   final String documentId;
   final int listenerId;
+  final Duration? debounce;
 
   @override
   StringMap serialize(SerializationContext context) => {
         'collectionId': collectionId,
         'documentId': documentId,
         'listenerId': listenerId,
+        'debounce': context.serialize(debounce),
       };
 
   static AddDocumentChangeListener deserialize(
@@ -1177,6 +1519,7 @@ final class AddDocumentChangeListener extends Request<Null> {
         collectionId: map.getAs('collectionId'),
         documentId: map.getAs('documentId'),
         listenerId: map.getAs('listenerId'),
+        debounce: context.deserializeAs(map['debounce']),
       );
 }
 
@@ -1221,6 +1564,23 @@ final class PerformDatabaseMaintenance extends Request<Null> {
       );
 }
 
+final class GetDatabaseFileSize extends Request<int> {
+  GetDatabaseFileSize({required this.databaseId});
+
+  final int databaseId;
+
+  @override
+  StringMap serialize(SerializationContext context) => {
+        'databaseId': databaseId,
+      };
+
+  static GetDatabaseFileSize deserialize(
+    StringMap map,
+    SerializationContext context,
+  ) =>
+      GetDatabaseFileSize(databaseId: map.getAs('databaseId'));
+}
+
 final class ChangeDatabaseEncryptionKey extends Request<Null> {
   ChangeDatabaseEncryptionKey({
     required this.databaseId,
@@ -1301,6 +1661,63 @@ final class DeleteIndex extends Request<Null> {
       );
 }
 
+final class FullTextSearch extends Request<List<FullTextSearchResult>> {
+  FullTextSearch({
+    required this.collectionId,
+    required this.indexName,
+    required this.query,
+    required this.limit,
+    required this.offset,
+    this.snippetProperty,
+    required this.snippetWordCount,
+    required this.matchStart,
+    required this.matchEnd,
+    required this.ellipsis,
+  });
+
+  final int collectionId;
+  final String indexName;
+  final String query;
+  final int limit;
+  final int offset;
+  final String? snippetProperty;
+  final int snippetWordCount;
+  final String matchStart;
+  final String matchEnd;
+  final String ellipsis;
+
+  @override
+  StringMap serialize(SerializationContext context) => {
+        'collectionId': collectionId,
+        'indexName': indexName,
+        'query': query,
+        'limit': limit,
+        'offset': offset,
+        'snippetProperty': snippetProperty,
+        'snippetWordCount': snippetWordCount,
+        'matchStart': matchStart,
+        'matchEnd': matchEnd,
+        'ellipsis': ellipsis,
+      };
+
+  static FullTextSearch deserialize(
+    StringMap map,
+    SerializationContext context,
+  ) =>
+      FullTextSearch(
+        collectionId: map.getAs('collectionId'),
+        indexName: map.getAs('indexName'),
+        query: map.getAs('query'),
+        limit: map.getAs('limit'),
+        offset: map.getAs('offset'),
+        snippetProperty: map.getAs('snippetProperty'),
+        snippetWordCount: map.getAs('snippetWordCount'),
+        matchStart: map.getAs('matchStart'),
+        matchEnd: map.getAs('matchEnd'),
+        ellipsis: map.getAs('ellipsis'),
+      );
+}
+
 final class BlobExists extends Request<bool> {
   BlobExists({
     required this.databaseId,
@@ -1330,15 +1747,24 @@ final class ReadBlob extends Request<MessageData> {
   ReadBlob({
     required this.databaseId,
     required this.properties,
+    this.start = 0,
+    this.end,
+    this.readAhead = 0,
   });
 
   final int databaseId;
   final StringMap properties;
+  final int start;
+  final int? end;
+  final int readAhead;
 
   @override
   StringMap serialize(SerializationContext context) => {
         'databaseId': databaseId,
         'properties': properties,
+        'start': start,
+        'end': end,
+        'readAhead': readAhead,
       };
 
   static ReadBlob deserialize(
@@ -1348,6 +1774,9 @@ final class ReadBlob extends Request<MessageData> {
       ReadBlob(
         databaseId: map.getAs('databaseId'),
         properties: map.getAs('properties'),
+        start: map.getAs('start'),
+        end: map.getAs('end'),
+        readAhead: map.getAs('readAhead'),
       );
 }
 
@@ -1397,6 +1826,64 @@ final class ReadBlobUpload extends Request<MessageData> {
       ReadBlobUpload(uploadId: map.getAs('uploadId'));
 }
 
+final class SaveBlobFromFile extends Request<SaveBlobResponse> {
+  SaveBlobFromFile({
+    required this.databaseId,
+    required this.contentType,
+    required this.path,
+  });
+
+  final int databaseId;
+  final String contentType;
+  final String path;
+
+  @override
+  StringMap serialize(SerializationContext context) => {
+        'databaseId': databaseId,
+        'contentType': contentType,
+        'path': path,
+      };
+
+  static SaveBlobFromFile deserialize(
+    StringMap map,
+    SerializationContext context,
+  ) =>
+      SaveBlobFromFile(
+        databaseId: map.getAs('databaseId'),
+        contentType: map.getAs('contentType'),
+        path: map.getAs('path'),
+      );
+}
+
+final class WriteBlobToFile extends Request<bool> {
+  WriteBlobToFile({
+    required this.databaseId,
+    required this.properties,
+    required this.path,
+  });
+
+  final int databaseId;
+  final StringMap properties;
+  final String path;
+
+  @override
+  StringMap serialize(SerializationContext context) => {
+        'databaseId': databaseId,
+        'properties': properties,
+        'path': path,
+      };
+
+  static WriteBlobToFile deserialize(
+    StringMap map,
+    SerializationContext context,
+  ) =>
+      WriteBlobToFile(
+        databaseId: map.getAs('databaseId'),
+        properties: map.getAs('properties'),
+        path: map.getAs('path'),
+      );
+}
+
 final class CreateQuery extends Request<QueryState> {
   CreateQuery({
     required this.databaseId,
@@ -1531,15 +2018,18 @@ final class AddQueryChangeListener extends Request<Null> {
   AddQueryChangeListener({
     required this.queryId,
     required this.listenerId,
+    this.minInterval,
   });
 
   final int queryId;
   final int listenerId;
+  final Duration? minInterval;
 
   @override
   StringMap serialize(SerializationContext context) => {
         'queryId': queryId,
         'listenerId': listenerId,
+        'minInterval': context.serialize(minInterval),
       };
 
   static AddQueryChangeListener deserialize(
@@ -1549,6 +2039,7 @@ final class AddQueryChangeListener extends Request<Null> {
       AddQueryChangeListener(
         queryId: map.getAs('queryId'),
         listenerId: map.getAs('listenerId'),
+        minInterval: context.deserializeAs(map['minInterval']),
       );
 }
 
@@ -1607,6 +2098,9 @@ final class CreateReplicator extends Request<int> {
     this.heartbeat,
     this.maxAttempts,
     this.maxAttemptWaitTime,
+    this.callbackDeadline,
+    this.callbackDeadlineFilterResult = false,
+    this.callbackLatencyBudget,
     required this.collections,
   })  : _pinnedServerCertificate =
             pinnedServerCertificate?.let(MessageData.new),
@@ -1626,6 +2120,9 @@ final class CreateReplicator extends Request<int> {
     this.heartbeat,
     this.maxAttempts,
     this.maxAttemptWaitTime,
+    this.callbackDeadline,
+    required this.callbackDeadlineFilterResult,
+    this.callbackLatencyBudget,
     required this.collections,
   })  : _pinnedServerCertificate = pinnedServerCertificate,
         _trustedRootCertificates = trustedRootCertificates;
@@ -1644,6 +2141,9 @@ final class CreateReplicator extends Request<int> {
   final Duration? heartbeat;
   final int? maxAttempts;
   final Duration? maxAttemptWaitTime;
+  final Duration? callbackDeadline;
+  final bool callbackDeadlineFilterResult;
+  final Duration? callbackLatencyBudget;
   final List<CreateReplicatorCollection> collections;
 
   @override
@@ -1660,6 +2160,9 @@ final class CreateReplicator extends Request<int> {
         'heartbeat': context.serialize(heartbeat),
         'maxAttempts': maxAttempts,
         'maxAttemptWaitTime': context.serialize(maxAttemptWaitTime),
+        'callbackDeadline': context.serialize(callbackDeadline),
+        'callbackDeadlineFilterResult': callbackDeadlineFilterResult,
+        'callbackLatencyBudget': context.serialize(callbackLatencyBudget),
         'collections': context.serialize(collections),
       };
 
@@ -1682,6 +2185,11 @@ final class CreateReplicator extends Request<int> {
         heartbeat: context.deserializeAs(map['heartbeat']),
         maxAttempts: map.getAs('maxAttempts'),
         maxAttemptWaitTime: context.deserializeAs(map['maxAttemptWaitTime']),
+        callbackDeadline: context.deserializeAs(map['callbackDeadline']),
+        callbackDeadlineFilterResult:
+            map.getAs('callbackDeadlineFilterResult'),
+        callbackLatencyBudget:
+            context.deserializeAs(map['callbackLatencyBudget']),
         collections: context.deserializeAs(map['collections'])!,
       );
 
@@ -1705,7 +2213,11 @@ final class CreateReplicatorCollection extends Serializable {
     this.documentIds,
     this.pushFilterId,
     this.pullFilterId,
+    this.pushFilterExpression,
+    this.pullFilterExpression,
     this.conflictResolverId,
+    this.conflictResolutionStrategy,
+    this.conflictResolutionTimestampKeyPath,
   });
 
   final int collectionId;
@@ -1713,8 +2225,19 @@ final class CreateReplicatorCollection extends Serializable {
   final List<String>? documentIds;
   final int? pushFilterId;
   final int? pullFilterId;
+
+  /// The push filter expression, encoded as JSON.
+  final String? pushFilterExpression;
+
+  /// The pull filter expression, encoded as JSON.
+  final String? pullFilterExpression;
   final int? conflictResolverId;
 
+  /// The strategy of a `BuiltInConflictResolver`, which is used instead of
+  /// the resolver with [conflictResolverId].
+  final ConflictResolutionStrategy? conflictResolutionStrategy;
+  final String? conflictResolutionTimestampKeyPath;
+
   @override
   StringMap serialize(SerializationContext context) => {
         'collectionId': collectionId,
@@ -1722,7 +2245,12 @@ final class CreateReplicatorCollection extends Serializable {
         'documentIds': context.serialize(documentIds),
         'pushFilterId': pushFilterId,
         'pullFilterId': pullFilterId,
+        'pushFilterExpression': pushFilterExpression,
+        'pullFilterExpression': pullFilterExpression,
         'conflictResolverId': conflictResolverId,
+        'conflictResolutionStrategy': conflictResolutionStrategy?.index,
+        'conflictResolutionTimestampKeyPath':
+            conflictResolutionTimestampKeyPath,
       };
 
   static CreateReplicatorCollection deserialize(
@@ -1735,7 +2263,14 @@ final class CreateReplicatorCollection extends Serializable {
         documentIds: context.deserializeAs(map['documentIds']),
         pushFilterId: map.getAs('pushFilterId'),
         pullFilterId: map.getAs('pullFilterId'),
+        pushFilterExpression: map.getAs('pushFilterExpression'),
+        pullFilterExpression: map.getAs('pullFilterExpression'),
         conflictResolverId: map.getAs('conflictResolverId'),
+        conflictResolutionStrategy: map
+            .getAs<int?>('conflictResolutionStrategy')
+            ?.let((it) => ConflictResolutionStrategy.values[it]),
+        conflictResolutionTimestampKeyPath:
+            map.getAs('conflictResolutionTimestampKeyPath'),
       );
 }
 
@@ -1837,6 +2372,25 @@ final class GetReplicatorStatus extends Request<ReplicatorStatus> {
       );
 }
 
+final class GetReplicatorMetrics extends Request<ReplicatorMetrics> {
+  GetReplicatorMetrics({required this.replicatorId});
+
+  final int replicatorId;
+
+  @override
+  StringMap serialize(SerializationContext context) => {
+        'replicatorId': replicatorId,
+      };
+
+  static GetReplicatorMetrics deserialize(
+    StringMap map,
+    SerializationContext context,
+  ) =>
+      GetReplicatorMetrics(
+        replicatorId: map.getAs('replicatorId'),
+      );
+}
+
 final class StartReplicator extends Request<Null> {
   StartReplicator({
     required this.replicatorId,
@@ -1862,6 +2416,35 @@ final class StartReplicator extends Request<Null> {
       );
 }
 
+final class ScheduleReplicator extends Request<Null> {
+  ScheduleReplicator({
+    required this.replicatorId,
+    required this.priority,
+    required this.reset,
+  });
+
+  final int replicatorId;
+  final int priority;
+  final bool reset;
+
+  @override
+  StringMap serialize(SerializationContext context) => {
+        'replicatorId': replicatorId,
+        'priority': priority,
+        'reset': reset,
+      };
+
+  static ScheduleReplicator deserialize(
+    StringMap map,
+    SerializationContext context,
+  ) =>
+      ScheduleReplicator(
+        replicatorId: map.getAs('replicatorId'),
+        priority: map.getAs('priority'),
+        reset: map.getAs('reset'),
+      );
+}
+
 final class StopReplicator extends Request<Null> {
   StopReplicator({
     required this.replicatorId,
@@ -1887,15 +2470,18 @@ final class AddReplicatorChangeListener extends Request<Null> {
   AddReplicatorChangeListener({
     required this.replicatorId,
     required this.listenerId,
+    this.minInterval,
   });
 
   final int replicatorId;
   final int listenerId;
+  final Duration? minInterval;
 
   @override
   StringMap serialize(SerializationContext context) => {
         'replicatorId': replicatorId,
         'listenerId': listenerId,
+        'minInterval': context.serialize(minInterval),
       };
 
   static AddReplicatorChangeListener deserialize(
@@ -1905,6 +2491,7 @@ final class AddReplicatorChangeListener extends Request<Null> {
       AddReplicatorChangeListener(
         replicatorId: map.getAs('replicatorId'),
         listenerId: map.getAs('listenerId'),
+        minInterval: context.deserializeAs(map['minInterval']),
       );
 }
 
@@ -1937,15 +2524,18 @@ final class AddDocumentReplicationListener extends Request<Null> {
   AddDocumentReplicationListener({
     required this.replicatorId,
     required this.listenerId,
+    this.errorsOnly = false,
   });
 
   final int replicatorId;
   final int listenerId;
+  final bool errorsOnly;
 
   @override
   StringMap serialize(SerializationContext context) => {
         'replicatorId': replicatorId,
         'listenerId': listenerId,
+        'errorsOnly': errorsOnly,
       };
 
   static AddDocumentReplicationListener deserialize(
@@ -1955,6 +2545,7 @@ final class AddDocumentReplicationListener extends Request<Null> {
       AddDocumentReplicationListener(
         replicatorId: map.getAs('replicatorId'),
         listenerId: map.getAs('listenerId'),
+        errorsOnly: map.getAs('errorsOnly'),
       );
 }
 
@@ -2043,6 +2634,60 @@ final class ReplicatorPendingDocumentIds extends Request<List<String>> {
       );
 }
 
+final class ReplicatorAreDocumentsPending extends Request<List<bool>> {
+  ReplicatorAreDocumentsPending({
+    required this.replicatorId,
+    required this.documentIds,
+    required this.collectionId,
+  });
+
+  final int replicatorId;
+  final List<String> documentIds;
+  final int collectionId;
+
+  @override
+  StringMap serialize(SerializationContext context) => {
+        'replicatorId': replicatorId,
+        'documentIds': context.serialize(documentIds),
+        'collectionId': collectionId,
+      };
+
+  static ReplicatorAreDocumentsPending deserialize(
+    StringMap map,
+    SerializationContext context,
+  ) =>
+      ReplicatorAreDocumentsPending(
+        replicatorId: map.getAs('replicatorId'),
+        documentIds: context.deserializeAs(map['documentIds'])!,
+        collectionId: map.getAs('collectionId'),
+      );
+}
+
+final class ReplicatorPendingDocumentCount extends Request<int> {
+  ReplicatorPendingDocumentCount({
+    required this.replicatorId,
+    required this.collectionId,
+  });
+
+  final int replicatorId;
+  final int collectionId;
+
+  @override
+  StringMap serialize(SerializationContext context) => {
+        'replicatorId': replicatorId,
+        'collectionId': collectionId,
+      };
+
+  static ReplicatorPendingDocumentCount deserialize(
+    StringMap map,
+    SerializationContext context,
+  ) =>
+      ReplicatorPendingDocumentCount(
+        replicatorId: map.getAs('replicatorId'),
+        collectionId: map.getAs('collectionId'),
+      );
+}
+
 // === Responses ===============================================================
 
 final class MessageData extends Serializable {
@@ -85,6 +85,11 @@ typedef _UntypedStreamHandler = Stream<Object?> Function(Object?);
 /// argument of [Request] is the type of the result of a call or the events of a
 /// stream initiated with such a request.
 ///
+/// Messages which are sent in the same microtask, for example the requests of
+/// calls which are made together, are sent to the other side as one batch and
+/// handled there in order. This avoids paying for a full round trip of the
+/// transport for each message of a chatty workload.
+///
 /// See also:
 ///
 /// - [open] for controlling when a [Channel] starts to respond to requests.
@@ -108,7 +113,7 @@ final class Channel {
 
     _transport = transport
         .transform(StreamChannelTransformer.fromCodec(codec))
-        .cast<_Message>();
+        .cast<Serializable>();
 
     if (autoOpen) {
       open();
@@ -122,9 +127,13 @@ final class Channel {
 
   final SerializationRegistry _serializationRegistry;
 
-  late final StreamChannel<_Message> _transport;
+  late final StreamChannel<Serializable> _transport;
   int _nextConversationId = 0;
 
+  /// The messages which have been sent in the current microtask and are sent
+  /// to the other side as one batch at the end of it.
+  final _pendingMessages = <_Message>[];
+
   var _status = ChannelStatus.initial;
   ChannelStatus get status => _status;
 
@@ -243,44 +252,52 @@ final class Channel {
     _status = ChannelStatus.open;
 
     _transport.stream.listen((message) {
-      if (_status != ChannelStatus.open) {
-        // The channel is closing and does not accept new requests.
-        return;
+      if (message is _MessageBatch) {
+        message.messages.forEach(_handleMessage);
+      } else {
+        _handleMessage(message as _Message);
       }
+    });
+  }
 
-      _restoreMessageContext(message.context, () {
-        // Associate the remote stack trace with the returned error.
-        // This can only be done for error that are not of a primitive type,
-        // which should be the case usually.
-        if (message is _ErrorMessage) {
-          final error = message.error;
-          if (_isValidExpandoKey(error)) {
-            final stackTrace = message.stackTrace;
-            if (stackTrace != null) {
-              _remoteStackTraceExpando[error] = stackTrace;
-            }
+  void _handleMessage(_Message message) {
+    if (_status != ChannelStatus.open) {
+      // The channel is closing and does not accept new requests.
+      return;
+    }
+
+    _restoreMessageContext(message.context, () {
+      // Associate the remote stack trace with the returned error.
+      // This can only be done for error that are not of a primitive type,
+      // which should be the case usually.
+      if (message is _ErrorMessage) {
+        final error = message.error;
+        if (_isValidExpandoKey(error)) {
+          final stackTrace = message.stackTrace;
+          if (stackTrace != null) {
+            _remoteStackTraceExpando[error] = stackTrace;
           }
         }
+      }
 
-        // Handle the message.
-        if (message is _CallRequest) {
-          _handleCallRequest(message);
-        } else if (message is _CallSuccess || message is _CallError) {
-          _handleCallResponse(message);
-        } else if (message is _ListenToStream) {
-          _handleListenToStream(message);
-        } else if (message is _PauseStream) {
-          _handlePauseStream(message);
-        } else if (message is _ResumeStream) {
-          _handleResumeStream(message);
-        } else if (message is _CancelStream) {
-          _handleCancelStream(message);
-        } else if (message is _StreamData || message is _StreamError) {
-          _handleStreamEvent(message);
-        } else if (message is _StreamDone) {
-          _handleStreamDone(message);
-        }
-      });
+      // Handle the message.
+      if (message is _CallRequest) {
+        _handleCallRequest(message);
+      } else if (message is _CallSuccess || message is _CallError) {
+        _handleCallResponse(message);
+      } else if (message is _ListenToStream) {
+        _handleListenToStream(message);
+      } else if (message is _PauseStream) {
+        _handlePauseStream(message);
+      } else if (message is _ResumeStream) {
+        _handleResumeStream(message);
+      } else if (message is _CancelStream) {
+        _handleCancelStream(message);
+      } else if (message is _StreamData || message is _StreamError) {
+        _handleStreamEvent(message);
+      } else if (message is _StreamDone) {
+        _handleStreamDone(message);
+      }
     });
   }
 
@@ -307,6 +324,7 @@ final class Channel {
       _sendStreamDone(id);
     }
     _streamSubscriptions.clear();
+    _flushPendingMessages();
 
     // No responses will be sent after this point.
     _status = ChannelStatus.closed;
@@ -478,7 +496,22 @@ final class Channel {
       }
     }
 
-    _transport.sink.add(message);
+    _pendingMessages.add(message);
+    if (_pendingMessages.length == 1) {
+      scheduleMicrotask(_flushPendingMessages);
+    }
+  }
+
+  void _flushPendingMessages() {
+    if (_status == ChannelStatus.closed || _pendingMessages.isEmpty) {
+      _pendingMessages.clear();
+      return;
+    }
+
+    final messages = List.of(_pendingMessages);
+    _pendingMessages.clear();
+    _transport.sink
+        .add(messages.length == 1 ? messages.single : _MessageBatch(messages));
   }
 
   void _sendCallSuccess(int conversationId, Object? data) =>
@@ -597,7 +630,8 @@ SerializationRegistry channelSerializationRegistry() => SerializationRegistry()
   .._addProtocolMessage('CancelStream', _CancelStream.deserialize)
   .._addProtocolMessage('StreamData', _StreamData.deserialize)
   .._addProtocolMessage('StreamError', _StreamError.deserialize)
-  .._addProtocolMessage('StreamDone', _StreamDone.deserialize);
+  .._addProtocolMessage('StreamDone', _StreamDone.deserialize)
+  ..addSerializableCodec('MessageBatch', _MessageBatch.deserialize);
 
 extension on SerializationRegistry {
   void _addProtocolMessage<T extends _Message>(
@@ -608,6 +642,43 @@ extension on SerializationRegistry {
   }
 }
 
+/// Messages which are sent together, to be handled in order.
+final class _MessageBatch extends Serializable {
+  _MessageBatch(this.messages);
+
+  final List<_Message> messages;
+
+  @override
+  StringMap serialize(SerializationContext context) => {
+        'messages': [
+          for (final message in messages) context.serializePolymorphic(message),
+        ],
+      };
+
+  static _MessageBatch deserialize(
+    StringMap map,
+    SerializationContext context,
+  ) =>
+      _MessageBatch([
+        for (final message in map.getAs<List<Object?>>('messages'))
+          context.deserializePolymorphic(message)! as _Message,
+      ]);
+
+  @override
+  void willSend() {
+    for (final message in messages) {
+      message.willSend();
+    }
+  }
+
+  @override
+  void didReceive() {
+    for (final message in messages) {
+      message.didReceive();
+    }
+  }
+}
+
 abstract final class _Message extends Serializable {
   _Message(this.conversationId, this.context);
 
@@ -0,0 +1,265 @@
+import 'dart:convert';
+import 'dart:typed_data';
+
+import '../../bindings.dart';
+import 'serialization.dart';
+import 'serialization_codec.dart';
+
+/// A [PacketCodec] which encodes packets in a compact binary format.
+///
+/// The value of a packet is encoded with a tag for each JSON value, followed
+/// by its content. Strings, lists and maps are prefixed with their length.
+/// Compared to `JsonPacketCodec`, numbers are not formatted and parsed and
+/// strings are not escaped.
+///
+/// The encoded value and the data of the packet are each written as a part,
+/// which is prefixed with its size. When a packet is decoded, the data are
+/// views of the input, instead of copies.
+final class BinaryPacketCodec extends PacketCodec {
+  @override
+  final SerializationTarget target = SerializationTarget.json;
+
+  @override
+  Packet decodePacket(Object? input) {
+    final packet = input! as Uint8List;
+    final bytes = packet.buffer.asByteData(
+      packet.offsetInBytes,
+      packet.lengthInBytes,
+    );
+
+    final valueSize = bytes.getUint32(0);
+    final value = _BinaryValueReader(bytes, 4).readValue();
+
+    final data = <Data>[];
+    var offset = 4 + valueSize;
+    while (offset < packet.lengthInBytes) {
+      final size = bytes.getUint32(offset);
+      offset += 4;
+      data.add(Data.fromTypedList(Uint8List.sublistView(
+        packet,
+        offset,
+        offset + size,
+      )));
+      offset += size;
+    }
+
+    return Packet(value, data);
+  }
+
+  @override
+  Object? encodePacket(Packet packet) {
+    final writer = _BinaryValueWriter()
+      // Reserve space for the size of the value.
+      ..writeUint32(0)
+      ..writeValue(packet.value);
+    final valueSize = writer.length - 4;
+    for (final data in packet.data) {
+      writer
+        ..writeUint32(data.size)
+        ..writeBytes(data.toTypedList());
+    }
+    return writer.takeBytes()..buffer.asByteData().setUint32(0, valueSize);
+  }
+}
+
+/// The tags of the values which are encoded by [BinaryPacketCodec].
+abstract final class _Tag {
+  static const nullValue = 0;
+  static const trueValue = 1;
+  static const falseValue = 2;
+  static const int32 = 3;
+
+  /// An integer which does not fit into 32 bits, as two 32 bit halves.
+  static const int64 = 4;
+  static const float64 = 5;
+  static const string = 6;
+  static const list = 7;
+  static const map = 8;
+}
+
+const _uint32Range = 0x100000000;
+
+final class _BinaryValueWriter {
+  var _buffer = Uint8List(256);
+  late var _bytes = ByteData.sublistView(_buffer);
+  var _length = 0;
+
+  int get length => _length;
+
+  Uint8List takeBytes() => Uint8List.sublistView(_buffer, 0, _length);
+
+  void writeValue(Object? value) {
+    switch (value) {
+      case null:
+        _writeUint8(_Tag.nullValue);
+      case true:
+        _writeUint8(_Tag.trueValue);
+      case false:
+        _writeUint8(_Tag.falseValue);
+      case int():
+        if (value >= -0x80000000 && value <= 0x7FFFFFFF) {
+          _ensureCapacity(5);
+          _bytes
+            ..setUint8(_length, _Tag.int32)
+            ..setInt32(_length + 1, value);
+          _length += 5;
+        } else {
+          // Splitting the integer arithmetically works for the full range of
+          // integers on the VM and for the safe integers on the web.
+          final low = value % _uint32Range;
+          final high = (value - low) ~/ _uint32Range;
+          _ensureCapacity(9);
+          _bytes
+            ..setUint8(_length, _Tag.int64)
+            ..setInt32(_length + 1, high)
+            ..setUint32(_length + 5, low);
+          _length += 9;
+        }
+      case double():
+        _ensureCapacity(9);
+        _bytes
+          ..setUint8(_length, _Tag.float64)
+          ..setFloat64(_length + 1, value);
+        _length += 9;
+      case String():
+        _writeUint8(_Tag.string);
+        _writeString(value);
+      case List<Object?>():
+        _writeUint8(_Tag.list);
+        writeUint32(value.length);
+        value.forEach(writeValue);
+      case Map<String, Object?>():
+        _writeUint8(_Tag.map);
+        writeUint32(value.length);
+        for (final entry in value.entries) {
+          _writeString(entry.key);
+          writeValue(entry.value);
+        }
+      default:
+        throw ArgumentError.value(
+          value,
+          'value',
+          'cannot be encoded by BinaryPacketCodec',
+        );
+    }
+  }
+
+  void writeUint32(int value) {
+    _ensureCapacity(4);
+    _bytes.setUint32(_length, value);
+    _length += 4;
+  }
+
+  void writeBytes(Uint8List bytes) {
+    _ensureCapacity(bytes.length);
+    _buffer.setAll(_length, bytes);
+    _length += bytes.length;
+  }
+
+  void _writeUint8(int value) {
+    _ensureCapacity(1);
+    _buffer[_length++] = value;
+  }
+
+  void _writeString(String value) {
+    // Most strings are ASCII, which can be written without encoding them
+    // into a temporary list first.
+    final length = value.length;
+    _ensureCapacity(4 + length);
+    final start = _length + 4;
+    for (var i = 0; i < length; i++) {
+      final codeUnit = value.codeUnitAt(i);
+      if (codeUnit >= 0x80) {
+        final encoded = utf8.encode(value);
+        writeUint32(encoded.length);
+        writeBytes(encoded);
+        return;
+      }
+      _buffer[start + i] = codeUnit;
+    }
+    _bytes.setUint32(_length, length);
+    _length = start + length;
+  }
+
+  void _ensureCapacity(int size) {
+    final required = _length + size;
+    if (required <= _buffer.length) {
+      return;
+    }
+
+    var capacity = _buffer.length * 2;
+    while (capacity < required) {
+      capacity *= 2;
+    }
+    _buffer = Uint8List(capacity)..setAll(0, Uint8List.sublistView(_buffer));
+    _bytes = ByteData.sublistView(_buffer);
+  }
+}
+
+final class _BinaryValueReader {
+  _BinaryValueReader(this._bytes, this._offset);
+
+  final ByteData _bytes;
+  int _offset;
+
+  Object? readValue() {
+    final tag = _bytes.getUint8(_offset++);
+    switch (tag) {
+      case _Tag.nullValue:
+        return null;
+      case _Tag.trueValue:
+        return true;
+      case _Tag.falseValue:
+        return false;
+      case _Tag.int32:
+        final value = _bytes.getInt32(_offset);
+        _offset += 4;
+        return value;
+      case _Tag.int64:
+        final high = _bytes.getInt32(_offset);
+        final low = _bytes.getUint32(_offset + 4);
+        _offset += 8;
+        return high * _uint32Range + low;
+      case _Tag.float64:
+        final value = _bytes.getFloat64(_offset);
+        _offset += 8;
+        return value;
+      case _Tag.string:
+        return _readString();
+      case _Tag.list:
+        final length = _readUint32();
+        return List<Object?>.generate(
+          length,
+          (_) => readValue(),
+          growable: false,
+        );
+      case _Tag.map:
+        final length = _readUint32();
+        final map = <String, Object?>{};
+        for (var i = 0; i < length; i++) {
+          final key = _readString();
+          map[key] = readValue();
+        }
+        return map;
+      default:
+        throw FormatException('Unknown value tag in packet: $tag');
+    }
+  }
+
+  int _readUint32() {
+    final value = _bytes.getUint32(_offset);
+    _offset += 4;
+    return value;
+  }
+
+  String _readString() {
+    final length = _readUint32();
+    final bytes = Uint8List.sublistView(
+      _bytes,
+      _offset,
+      _offset + length,
+    );
+    _offset += length;
+    return utf8.decode(bytes);
+  }
+}
@@ -1,4 +1,5 @@
 import 'dart:async';
+import 'dart:developer';
 import 'dart:ffi';
 import 'dart:isolate';
 
@@ -27,12 +28,20 @@ class AsyncCallback implements Finalizable {
   /// side.
   ///
   /// [handler] is the function which responds to calls from the native side.
+  ///
+  /// If [maxBatchSize] is provided, non-blocking calls are delivered in
+  /// batches of up to [maxBatchSize] calls, which reduces the number of
+  /// messages under bursts of calls. While a batch is being handled, further
+  /// calls are queued on the native side. The arguments of batched calls
+  /// are copied and must not refer to native memory that only lives for the
+  /// duration of the call.
   AsyncCallback(
     this.handler, {
     this.errorResult = failureResult,
     this.ignoreErrorsInDart = false,
     required this.debugName,
     this.debug = false,
+    int? maxBatchSize,
   }) {
     _receivePort = ReceivePort();
 
@@ -43,7 +52,17 @@ class AsyncCallback implements Finalizable {
       debug: debug,
     );
 
-    _receivePort.cast<List<Object?>>().listen(_messageHandler);
+    if (maxBatchSize != null) {
+      _bindings.enableBatching(pointer, maxBatchSize);
+    }
+
+    _receivePort.cast<List<Object?>>().listen((message) {
+      if (message.length == 1) {
+        _batchMessageHandler(message[0]! as List<Object?>);
+      } else {
+        _messageHandler(message);
+      }
+    });
 
     _debugLog('created ($debugName)');
   }
@@ -52,6 +71,10 @@ class AsyncCallback implements Finalizable {
   /// `std::runtime_exception`.
   static const failureResult = '__ASYNC_CALLBACK_FAILED__';
 
+  /// The batch size which is used for listeners that receive bursts of
+  /// notifications.
+  static const listenerMaxBatchSize = 64;
+
   final _id = _generateId();
 
   late final Pointer<CBLDartAsyncCallback> pointer;
@@ -82,6 +105,9 @@ class AsyncCallback implements Finalizable {
 
   var _closed = false;
 
+  /// Whether this callback has been closed.
+  bool get isClosed => _closed;
+
   /// Close this callback to free resources on the native side and the Dart
   /// side.
   ///
@@ -96,11 +122,30 @@ class AsyncCallback implements Finalizable {
     _receivePort.close();
   }
 
+  void _batchMessageHandler(List<Object?> calls) {
+    _debugLog('received batch of ${calls.length} calls');
+
+    for (final arguments in calls) {
+      if (_closed) {
+        // Like single calls, queued calls are dropped once the callback is
+        // closed.
+        return;
+      }
+      _messageHandler([null, null, arguments, null]);
+    }
+
+    if (!_closed) {
+      _bindings.batchDelivered(pointer);
+    }
+  }
+
   void _messageHandler(List<Object?> message) {
     final sendPort = message[0] as SendPort?;
-    final callAddress = message[1] as int?;
+    final callId = message[1] as int?;
     // ignore: cast_nullable_to_non_nullable
     final args = message[2] as List<Object?>;
+    // Set by the native side while the native timeline is enabled.
+    final flowId = message[3] as int?;
 
     String debugFormatArgs() => args.map((arg) {
           if (arg is! Iterable<Object?>) {
@@ -119,10 +164,10 @@ class AsyncCallback implements Finalizable {
     final isBlocking = sendPort != null;
 
     assert(
-      (sendPort != null && callAddress != null) ||
-          (sendPort == null && callAddress == null),
+      (sendPort != null && callId != null) ||
+          (sendPort == null && callId == null),
       'CBLDart::AsyncCallbackCall must send both a sendPort and '
-      'a callAddress or none',
+      'a callId or none',
     );
 
     void sendResult(Object? result) {
@@ -140,12 +185,19 @@ class AsyncCallback implements Finalizable {
         _debugLog('sending result: $result');
       }
 
-      sendPort.send([callAddress, result]);
+      sendPort.send([callId, result]);
     }
 
     Future.sync(() async {
       try {
-        final result = await handler(args);
+        final result = await (flowId == null
+            ? handler(args)
+            : Timeline.timeSync(
+                'AsyncCallback',
+                () => handler(args),
+                arguments: {'debugName': debugName},
+                flow: Flow.end(flowId),
+              ));
         assert(result == null || sendPort != null);
         sendResult(result);
         // ignore: avoid_catches_without_on_clauses
@@ -50,7 +50,9 @@ class EncodedData {
         final encoder = FleeceEncoder(format: FLEncoderFormat.json);
         final doc = Doc.fromResultData(data, FLTrust.trusted);
         final root = doc.root;
-        encoder.writeValue(root.pointer);
+        encoder
+          ..writeValue(root.pointer)
+          ..keepAlive(doc);
         return encoder.finish();
       case EncodingFormat.json:
         return data;
@@ -60,6 +60,11 @@ Future<void> initPrimaryIsolate(IsolateContext context) async {
 /// isolate has been initialized.
 Future<void> initSecondaryIsolate(IsolateContext context) async {
   await _initIsolate(context);
+  runWithErrorTranslation(() {
+    // The native libraries have already been initialized, but this isolate
+    // still needs the function table that is returned by the initialization.
+    cblBindings.base.initializeNativeLibraries(context.initContext?.toCbl());
+  });
   await _runPostIsolateInitTasks();
 }
 
@@ -8,6 +8,19 @@ import '../service/proxy_object.dart';
 import 'async_callback.dart';
 import 'resource.dart';
 
+/// Throws if [minInterval] is not a valid minimum interval for change
+/// listeners, which are throttled natively.
+void checkListenerMinInterval(Duration? minInterval) {
+  if (minInterval != null) {
+    RangeError.checkValueInInterval(
+      minInterval.inMilliseconds,
+      0,
+      0xFFFFFFFF,
+      'minInterval',
+    );
+  }
+}
+
 /// A token which is handed out when adding a listener to an observable object.
 ///
 /// To remove a listener from an observable object, call the objects
@@ -87,6 +100,8 @@ class FfiListenerToken extends SyncListenerToken {
 
   final AsyncCallback _callback;
 
+  AsyncCallback get callback => _callback;
+
   @override
   void removeListener() {
     super.removeListener();
@@ -0,0 +1,93 @@
+import '../bindings.dart';
+import '../replication/replicator.dart';
+
+final _baseBinds = cblBindings.base;
+
+/// Statistics of the hot paths of the native library of this package, which
+/// are collected since the library has been loaded.
+///
+/// The stats are collected in all builds and are shared by all isolates.
+/// Rates can be derived by reading the stats periodically and dividing the
+/// difference between two readings by the time between them.
+///
+/// {@category Tracing}
+final class NativeStats {
+  NativeStats({
+    required this.asyncCallbackCalls,
+    required this.blockingAsyncCallbackCalls,
+    required this.listenerInvocations,
+    required this.logCallbackMessages,
+    required this.blobBytesRead,
+    required this.databaseLockAcquisitions,
+    required this.databaseLockWaits,
+  });
+
+  /// The number of calls from native code into Dart, through async callbacks.
+  final int asyncCallbackCalls;
+
+  /// The durations of the calls from native code into Dart which block native
+  /// code until they have been handled, from sending a call to its
+  /// completion.
+  final LatencyHistogram blockingAsyncCallbackCalls;
+
+  /// The number of invocations of listeners, such as change listeners, by
+  /// Couchbase Lite.
+  final int listenerInvocations;
+
+  /// The number of log messages that have been sent to Dart.
+  final int logCallbackMessages;
+
+  /// The number of bytes of blob content that have been read natively, from
+  /// the blob cache or to write blobs to files.
+  final int blobBytesRead;
+
+  /// The number of times a database lock has been acquired.
+  ///
+  /// Database locks are acquired natively, for example when native code
+  /// releases objects which belong to a database.
+  final int databaseLockAcquisitions;
+
+  /// The durations of the waits for database locks which were held by
+  /// another thread.
+  final LatencyHistogram databaseLockWaits;
+
+  @override
+  String toString() => 'NativeStats('
+      'asyncCallbackCalls: $asyncCallbackCalls, '
+      'blockingAsyncCallbackCalls: $blockingAsyncCallbackCalls, '
+      'listenerInvocations: $listenerInvocations, '
+      'logCallbackMessages: $logCallbackMessages, '
+      'blobBytesRead: $blobBytesRead, '
+      'databaseLockAcquisitions: $databaseLockAcquisitions, '
+      'databaseLockWaits: $databaseLockWaits'
+      ')';
+}
+
+/// Copies the current [NativeStats] out of the native library, in a single
+/// call.
+NativeStats readNativeStats() {
+  final stats = _baseBinds.statsSnapshot();
+  return NativeStats(
+    asyncCallbackCalls: stats.asyncCallbackCalls,
+    blockingAsyncCallbackCalls:
+        stats.blockingAsyncCallbackCalls.toLatencyHistogram(),
+    listenerInvocations: stats.listenerInvocations,
+    logCallbackMessages: stats.logCallbackMessages,
+    blobBytesRead: stats.blobBytesRead,
+    databaseLockAcquisitions: stats.databaseLockAcquisitions,
+    databaseLockWaits: stats.databaseLockWaits.toLatencyHistogram(),
+  );
+}
+
+extension CBLDartLatencyHistogramExt on CBLDart_LatencyHistogram {
+  LatencyHistogram toLatencyHistogram() => LatencyHistogram(
+        count: count,
+        total: Duration(microseconds: totalMicros),
+        max: Duration(microseconds: maxMicros),
+        buckets: List.generate(
+          cblDartLatencyHistogramBuckets,
+          (i) => buckets[i],
+          growable: false,
+        ),
+      );
+}
@@ -1,4 +1,5 @@
 import 'dart:async';
+import 'dart:math';
 import 'dart:typed_data';
 
 import 'listener_token.dart';
@@ -10,6 +11,31 @@ Future<Uint8List> byteStreamToFuture(Stream<Uint8List> stream) async {
   return builder.toBytes();
 }
 
+/// Returns a stream of the bytes of [stream] from the byte at [start] up to,
+/// but not including, the byte at [end].
+Stream<Uint8List> byteStreamRange(
+  Stream<Uint8List> stream,
+  int start,
+  int? end,
+) async* {
+  var offset = 0;
+  await for (final chunk in stream) {
+    final chunkEnd = offset + chunk.length;
+    if (chunkEnd > start) {
+      final sliceStart = max(start - offset, 0);
+      final sliceEnd =
+          end == null ? chunk.length : min(end - offset, chunk.length);
+      if (sliceEnd > sliceStart) {
+        yield Uint8List.sublistView(chunk, sliceStart, sliceEnd);
+      }
+    }
+    offset = chunkEnd;
+    if (end != null && offset >= end) {
+      break;
+    }
+  }
+}
+
 /// Transforms streams into [ResourceStream]s.
 class ResourceStreamTransformer<T> extends StreamTransformerBase<T, T> {
   ResourceStreamTransformer({
@@ -223,30 +249,58 @@ class ListenerStream<T> extends AsyncListenStream<T> {
   ListenerStream({
     required this.parent,
     required this.addListener,
+    this.onPause,
+    this.onResume,
   });
 
   final ClosableResourceMixin parent;
   final FutureOr<AbstractListenerToken> Function(void Function(T)) addListener;
 
+  /// Called with the token of the listener when the subscription is paused,
+  /// to stop the source of the events while the events would be buffered.
+  final void Function(AbstractListenerToken token)? onPause;
+
+  /// Called with the token of the listener when the subscription is resumed.
+  final void Function(AbstractListenerToken token)? onResume;
+
   @override
   late final Future<void> listening = _listeningCompleter.future;
   final _listeningCompleter = Completer<void>();
 
   late final _controller = StreamController<T>(
     onListen: _onListen,
+    onPause: _onPause,
+    onResume: _onResume,
     onCancel: _onCancel,
   );
   var _isCanceled = false;
+  var _hasToken = false;
   late AbstractListenerToken _token;
 
   void _onListen() => Future.sync(() => addListener(_listener)).then(
         (token) {
           _token = token;
+          _hasToken = true;
+          if (_controller.isPaused && !_isCanceled) {
+            onPause?.call(token);
+          }
           _listeningCompleter.complete();
         },
         onError: _onAddListenerError,
       );
 
+  void _onPause() {
+    if (_hasToken) {
+      onPause?.call(_token);
+    }
+  }
+
+  void _onResume() {
+    if (_hasToken) {
+      onResume?.call(_token);
+    }
+  }
+
   Future<void> _onCancel() async {
     _isCanceled = true;
 
@@ -3,6 +3,7 @@ import 'dart:developer';
 
 import 'package:meta/meta.dart';
 
+import 'bindings.dart';
 import 'database.dart';
 import 'document.dart';
 import 'query.dart';
@@ -298,6 +299,17 @@ final class GetDocumentOp extends CollectionOperationOp {
   final String id;
 }
 
+/// Operation that loads multiple [Document]s from a [Collection].
+///
+/// {@category Tracing}
+final class GetDocumentsOp extends CollectionOperationOp {
+  GetDocumentsOp(Collection collection, this.ids)
+      : super(collection, 'GetDocuments');
+
+  /// The ids of the documents to load.
+  final List<String> ids;
+}
+
 /// Operation that prepares a [Document] to be saved or deleted.
 ///
 /// {@category Tracing}
@@ -335,6 +347,40 @@ final class SaveDocumentOp extends CollectionOperationOp
   bool get withConflictHandler => concurrencyControl == null;
 }
 
+/// Operation that saves multiple [Document]s to a [Collection].
+///
+/// {@category Tracing}
+final class SaveDocumentsOp extends CollectionOperationOp {
+  SaveDocumentsOp(
+    Collection collection,
+    this.documents,
+    this.concurrencyControl,
+  ) : super(collection, 'SaveDocuments');
+
+  /// The documents to save.
+  final List<Document> documents;
+
+  /// The concurrency control to use.
+  final ConcurrencyControl concurrencyControl;
+}
+
+/// Operation that patches a [Document] in a [Collection].
+///
+/// {@category Tracing}
+final class PatchDocumentOp extends CollectionOperationOp {
+  PatchDocumentOp(
+    Collection collection,
+    this.id,
+    this.concurrencyControl,
+  ) : super(collection, 'PatchDocument');
+
+  /// The id of the document to patch.
+  final String id;
+
+  /// The concurrency control to use.
+  final ConcurrencyControl concurrencyControl;
+}
+
 /// Operation that deletes a [Document] from a [Collection].
 ///
 /// {@category Tracing}
@@ -358,24 +404,37 @@ final class DeleteDocumentOp extends CollectionOperationOp
 ///
 /// {@category Tracing}
 abstract final class QueryOperationOp extends TracedOperation {
-  QueryOperationOp(this.query, String name) : super(name);
+  QueryOperationOp(this.query, String name, [this.stats]) : super(name);
 
   /// The query involved in this operation.
   final Query query;
+
+  /// The stats of [query], if it is instrumented.
+  ///
+  /// The stats are updated by the operation, so after a [PrepareQueryOp] they
+  /// include the query plan and after an [ExecuteQueryOp] they include the
+  /// execution.
+  ///
+  /// See also:
+  ///
+  /// - [QueryInstrumentation] for enabling the instrumentation of queries.
+  final QueryStats? stats;
 }
 
 /// Operation that prepares a [Query] to be used.
 ///
 /// {@category Tracing}
 final class PrepareQueryOp extends QueryOperationOp {
-  PrepareQueryOp(Query query) : super(query, 'PrepareQuery');
+  PrepareQueryOp(Query query, [QueryStats? stats])
+      : super(query, 'PrepareQuery', stats);
 }
 
 /// Operation that executes a [Query].
 ///
 /// {@category Tracing}
 final class ExecuteQueryOp extends QueryOperationOp {
-  ExecuteQueryOp(Query query) : super(query, 'ExecuteQuery');
+  ExecuteQueryOp(Query query, [QueryStats? stats])
+      : super(query, 'ExecuteQuery', stats);
 }
 
 /// A function to filter [TracedOperation]s.
@@ -415,6 +474,13 @@ typedef OperationDetailsResolver = Map<String, Object?>? Function(
 /// This tracing delegate records [Timeline] events, which can be viewed in Dart
 /// DevTools Performance Page.
 ///
+/// While this delegate is installed, native work, such as calls of listeners
+/// and replication filters, is recorded in the `Embedder` stream of the
+/// timeline, too. Calls from native code into Dart are linked by flows to the
+/// events of their handling in Dart. Native events are only recorded if the
+/// timeline of the Dart VM is accessible to native code, which depends on the
+/// platform.
+///
 /// {@category Tracing}
 final class DevToolsTracing extends TracingDelegate {
   /// A tracing delegate that integrates CBL Dart with the dart developer tools.
@@ -510,6 +576,10 @@ final class DevToolsTracing extends TracingDelegate {
       details['documentId'] = operation.id;
     }
 
+    if (operation is GetDocumentsOp) {
+      details['documentCount'] = operation.ids.length;
+    }
+
     if (operation is SaveDocumentOp) {
       final concurrencyControl = operation.concurrencyControl;
       if (concurrencyControl != null) {
@@ -519,6 +589,16 @@ final class DevToolsTracing extends TracingDelegate {
       }
     }
 
+    if (operation is SaveDocumentsOp) {
+      details['documentCount'] = operation.documents.length;
+      details['concurrencyControl'] = operation.concurrencyControl.name;
+    }
+
+    if (operation is PatchDocumentOp) {
+      details['documentId'] = operation.id;
+      details['concurrencyControl'] = operation.concurrencyControl.name;
+    }
+
     if (operation is DeleteDocumentOp) {
       details['concurrencyControl'] = operation.concurrencyControl.name;
     }
@@ -526,6 +606,9 @@ final class DevToolsTracing extends TracingDelegate {
     if (operation is QueryOperationOp) {
       details['query'] = operation.query.jsonRepresentation ??
           operation.query.sqlRepresentation;
+      if (operation.stats?.usesFullScan ?? false) {
+        details['fullScan'] = true;
+      }
     }
 
     return details.isEmpty ? null : details;
@@ -535,11 +618,29 @@ final class DevToolsTracing extends TracingDelegate {
   final OperationFilter _operationFilter;
   final OperationToStringResolver _operationNameResolver;
   final OperationDetailsResolver _operationDetailsResolver;
+  var _isNativeTimelineEnabled = false;
 
   @override
   TracingDelegate createWorkerDelegate() =>
       DevToolsTracing._workerDelegate(this);
 
+  @override
+  void initialize() {
+    // Native work, such as calls from native code into Dart, is recorded in
+    // the timeline as well, if the native code has access to the timeline.
+    if (!_isNativeTimelineEnabled) {
+      _isNativeTimelineEnabled = cblBindings.base.enableTimeline();
+    }
+  }
+
+  @override
+  void close() {
+    if (_isNativeTimelineEnabled) {
+      _isNativeTimelineEnabled = false;
+      cblBindings.base.disableTimeline();
+    }
+  }
+
   @override
   T traceSyncOperation<T>(
     TracedOperation operation,
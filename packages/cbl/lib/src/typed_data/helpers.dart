@@ -1,7 +1,10 @@
 import 'package:meta/meta.dart';
 
 import '../document.dart';
+import '../document/dictionary.dart';
+import '../document/document.dart';
 import '../errors.dart';
+import '../fleece/integration/integration.dart';
 import 'collection.dart';
 import 'conversion.dart';
 import 'typed_object.dart';
@@ -35,6 +38,13 @@ final class TypedDataHelpers {
     required String key,
     required ToTyped<T> converter,
   }) {
+    if (converter is IdentityConverter) {
+      final value = _readScalar(internal, key);
+      if (value is T) {
+        return value;
+      }
+    }
+
     final value = internal.value(key);
     if (value == null) {
       if (!internal.contains(key)) {
@@ -70,6 +80,13 @@ final class TypedDataHelpers {
     required String key,
     required ToTyped<T> converter,
   }) {
+    if (converter is IdentityConverter) {
+      final value = _readScalar(internal, key);
+      if (value == null || value is T) {
+        return value as T?;
+      }
+    }
+
     final value = internal.value(key);
     if (value == null) {
       return null;
@@ -86,6 +103,18 @@ final class TypedDataHelpers {
     }
   }
 
+  /// Reads a scalar property directly from the Fleece data of [internal].
+  ///
+  /// This skips the generic decoding path, which creates and caches an
+  /// intermediate value for each property. Returns [MDict.notScalar] if the
+  /// property has to be read through the generic path.
+  static Object? _readScalar(DictionaryInterface internal, String key) =>
+      switch (internal) {
+        DelegateDocument() => internal.scalarValue(key),
+        DictionaryImpl() => internal.scalarValue(key),
+        _ => MDict.notScalar,
+      };
+
   @internal
   static void writeProperty<T>({
     required MutableDictionaryInterface internal,
@@ -93,6 +122,9 @@ final class TypedDataHelpers {
     required String key,
     required ToUntyped<T> converter,
   }) {
+    if (converter is IdentityConverter && _writeScalar(internal, key, value)) {
+      return;
+    }
     internal.setValue(converter.toUntyped(value), key: key);
   }
 
@@ -105,11 +137,41 @@ final class TypedDataHelpers {
   }) {
     if (value == null) {
       internal.removeValue(key);
-    } else {
+    } else if (converter is! IdentityConverter ||
+        !_writeScalar(internal, key, value)) {
       internal.setValue(converter.toUntyped(value), key: key);
     }
   }
 
+  /// Writes a scalar property directly into the dict of [internal].
+  ///
+  /// This skips the conversion of the value and decoding the current value to
+  /// compare it with the new one. Returns `false` if the property has to be
+  /// written through the generic path.
+  ///
+  /// When the document is saved, changed properties are encoded through the
+  /// tape of the Fleece encoder, without creating intermediate maps, so
+  /// encoding needs no fast path of its own.
+  static bool _writeScalar(
+    MutableDictionaryInterface internal,
+    String key,
+    Object? value,
+  ) {
+    if (value is! String && value is! num && value is! bool) {
+      return false;
+    }
+    switch (internal) {
+      case MutableDelegateDocument():
+        internal.setScalarValue(value!, key: key);
+        return true;
+      case MutableDictionaryImpl():
+        internal.setScalarValue(value!, key: key);
+        return true;
+      default:
+        return false;
+    }
+  }
+
   @internal
   static String renderString({
     required String? indent,
@@ -1,3 +1,4 @@
+import 'benchmark_suite_test.dart' as benchmark_suite;
 import 'database/collection_test.dart' as database_collection;
 import 'database/database_change_test.dart' as database_database_change;
 import 'database/database_configuration_test.dart'
@@ -6,9 +7,11 @@ import 'database/database_test.dart' as database_database;
 import 'database/document_change_test.dart' as database_document_change;
 import 'database/typed_database_test.dart' as typed_database;
 import 'document/array_test.dart' as document_array_test;
+import 'document/blob_cache_test.dart' as document_blob_cache_test;
 import 'document/blob_test.dart' as document_blob_test;
 import 'document/dictionary_test.dart' as document_dictionary_test;
 import 'document/document_benchmark_test.dart' as document_benchmark_test;
+import 'document/document_cache_test.dart' as document_document_cache_test;
 import 'document/document_test.dart' as document_document_test;
 import 'document/fragment_test.dart' as document_fragment_test;
 import 'fleece/coding_test.dart' as fleece_coding;
@@ -24,6 +27,8 @@ import 'query/index/index_configuration_test.dart'
     as query_index_index_configuration;
 import 'query/parameters_test.dart' as query_parameters;
 import 'query/query_builder_test.dart' as query_builder;
+import 'query/query_cache_test.dart' as query_query_cache;
+import 'query/query_instrumentation_test.dart' as query_query_instrumentation;
 import 'query/query_test.dart' as query_query;
 import 'query/result_test.dart' as query_result;
 import 'replication/authenticator_test.dart' as replication_authenticator;
@@ -35,11 +40,13 @@ import 'replication/endpoint_test.dart' as replication_endpoint;
 import 'replication/replicator_change_test.dart'
     as replication_replicator_change;
 import 'replication/replicator_test.dart' as replication_replicator;
+import 'service/binary_packet_codec_test.dart' as service_binary_packet_codec;
 import 'service/cbl_service_api_test.dart' as service_cbl_service_api;
 import 'service/cbl_worker_test.dart' as service_cbl_worker;
 import 'service/channel_test.dart' as service_channel;
 import 'service/isolate_worker_test.dart' as service_isolate_worker;
 import 'support/async_callback_test.dart' as support_async_callback;
+import 'support/native_stats_test.dart' as support_native_stats;
 import 'tracing_test.dart' as tracing;
 import 'typed_data/collection_test.dart' as typed_data_collection;
 import 'typed_data/conversion_test.dart' as typed_data_conversion;
@@ -47,6 +54,7 @@ import 'typed_data/helpers_test.dart' as typed_data_helpers;
 import 'typed_data/registry_test.dart' as typed_data_runtime_support;
 
 final tests = [
+  benchmark_suite.main,
   database_collection.main,
   database_database_change.main,
   database_database_configuration.main,
@@ -54,9 +62,11 @@ final tests = [
   database_document_change.main,
   typed_database.main,
   document_array_test.main,
+  document_blob_cache_test.main,
   document_blob_test.main,
   document_dictionary_test.main,
   document_benchmark_test.main,
+  document_document_cache_test.main,
   document_document_test.main,
   document_fragment_test.main,
   fleece_coding.main,
@@ -71,6 +81,8 @@ final tests = [
   query_index_index_configuration.main,
   query_parameters.main,
   query_builder.main,
+  query_query_cache.main,
+  query_query_instrumentation.main,
   query_query.main,
   query_result.main,
   replication_authenticator.main,
@@ -80,11 +92,13 @@ final tests = [
   replication_endpoint.main,
   replication_replicator_change.main,
   replication_replicator.main,
+  service_binary_packet_codec.main,
   service_cbl_service_api.main,
   service_cbl_worker.main,
   service_isolate_worker.main,
   service_channel.main,
   support_async_callback.main,
+  support_native_stats.main,
   tracing.main,
   typed_data_collection.main,
   typed_data_conversion.main,
@@ -0,0 +1,440 @@
+import 'dart:async';
+import 'dart:convert';
+import 'dart:math';
+import 'dart:typed_data';
+
+import 'package:cbl/cbl.dart';
+
+import '../test_binding_impl.dart';
+import 'test_binding.dart';
+import 'utils/api_variant.dart' show Api;
+import 'utils/benchmark_suite.dart';
+import 'utils/database_utils.dart';
+import 'utils/replicator_utils.dart';
+
+/// The chunk size in which blobs are written.
+const _blobChunkSize = 64 * 1024;
+
+/// The number of documents which are saved in a batch with a single
+/// transaction, when the database is populated.
+const _saveBatchSize = 10000;
+
+const _querySql = 'SELECT META().id, name, age FROM _ WHERE isActive = true';
+const _markerQuerySql = "SELECT META().id FROM _ WHERE type = 'marker'";
+
+/// Benchmarks the performance of the major paths through the sync and async
+/// APIs, with databases of increasing sizes.
+///
+/// The suite is configured through [BenchmarkSuiteConfig]. Since the enabled
+/// suite takes a while, the test timeout should be disabled when running it,
+/// e.g. with `dart test --timeout none`.
+///
+/// Each test compares its own results with the baseline, so that tests can be
+/// run on their own. The results of all tests which ran are written once the
+/// suite is done.
+void main() {
+  setupTestBinding();
+
+  final config = BenchmarkSuiteConfig.fromEnvironment();
+  final report = BenchmarkReport(config);
+
+  group('Benchmark suite', () {
+    tearDownAll(report.write);
+
+    for (final api in Api.values) {
+      for (final documentCount in config.documentCounts) {
+        test('${api.name} database with $documentCount documents', () async {
+          final db = await api.openDatabase();
+          final collection = await db.defaultCollection;
+
+          await _expectNoRegressions(report, () async {
+            await _benchmarkSave(report, api, db, collection, documentCount);
+            await _benchmarkQuery(report, api, db, config, documentCount);
+            await _benchmarkLiveQuery(
+              report,
+              api,
+              db,
+              collection,
+              config,
+              documentCount,
+            );
+          });
+        });
+      }
+
+      test('${api.name} blob streams', () async {
+        final db = await api.openDatabase();
+        await _expectNoRegressions(
+          report,
+          () => _benchmarkBlobStreams(report, api, db, config),
+        );
+      });
+
+      test('${api.name} replication', () async {
+        final db = await api.openDatabase(name: 'push');
+        final collection = await db.defaultCollection;
+        final pullDb = await api.openDatabase(name: 'pull');
+        await _expectNoRegressions(
+          report,
+          () => _benchmarkReplication(
+            report,
+            api,
+            db,
+            collection,
+            pullDb,
+            config.replicationDocumentCount,
+          ),
+        );
+      });
+    }
+  });
+}
+
+/// Runs [benchmarks] and expects that none of the results they add to
+/// [report] has regressed compared with the baseline.
+Future<void> _expectNoRegressions(
+  BenchmarkReport report,
+  Future<void> Function() benchmarks,
+) async {
+  final previousResultCount = report.results.length;
+  await benchmarks();
+
+  final regressions = await report
+      .compareWithBaseline(report.results.skip(previousResultCount));
+  expect(
+    regressions,
+    isEmpty,
+    reason: 'Results regressed by more than '
+        '${(report.config.tolerance * 100).toStringAsFixed(0)}% '
+        'compared with the baseline.',
+  );
+}
+
+extension on Api {
+  Future<Database> openDatabase({String name = 'db'}) async {
+    switch (this) {
+      case Api.sync:
+        return openSyncTestDatabase(name: name);
+      case Api.async:
+        return openAsyncTestDatabase(name: name, usePublicApi: true);
+    }
+  }
+}
+
+List<Map<String, Object?>> _people() =>
+    (jsonDecode(largeJsonFixture) as List<Object?>)
+        .cast<Map<String, Object?>>();
+
+/// Creates the documents which are saved into the benchmarked databases.
+///
+/// The documents are derived from the large JSON fixture, so that they are
+/// the same in every run.
+Iterable<MutableDocument> _documents(
+  int count, {
+  String idPrefix = 'person',
+  List<String>? channels,
+}) sync* {
+  final people = _people();
+  for (var i = 0; i < count; i++) {
+    yield MutableDocument.withId('$idPrefix-$i', {
+      ...people[i % people.length],
+      'index': i,
+      if (channels != null) 'channels': channels,
+    });
+  }
+}
+
+Future<void> _saveDocuments(
+  Database db,
+  Collection collection,
+  Iterable<MutableDocument> documents,
+) async {
+  final batch = <MutableDocument>[];
+  Future<void> saveBatch() async {
+    // The sync API is measured without the overhead of awaiting its results.
+    if (db is SyncDatabase) {
+      db.inBatchSync(() {
+        batch.forEach((collection as SyncCollection).saveDocument);
+      });
+    } else {
+      await db.inBatch(() async {
+        for (final document in batch) {
+          await collection.saveDocument(document);
+        }
+      });
+    }
+    batch.clear();
+  }
+
+  for (final document in documents) {
+    batch.add(document);
+    if (batch.length == _saveBatchSize) {
+      await saveBatch();
+    }
+  }
+  if (batch.isNotEmpty) {
+    await saveBatch();
+  }
+}
+
+Future<void> _benchmarkSave(
+  BenchmarkReport report,
+  Api api,
+  Database db,
+  Collection collection,
+  int documentCount,
+) async {
+  final documents = _documents(documentCount).toList();
+  final duration = await measure(
+    () => _saveDocuments(db, collection, documents),
+  );
+  report.addThroughput(
+    'inBatch/saveDocument',
+    api: api.name,
+    documentCount: documentCount,
+    count: documentCount,
+    unit: 'documents',
+    durations: [duration],
+  );
+}
+
+Future<int> _iterateResults(ResultSet resultSet) async {
+  var count = 0;
+  if (resultSet is SyncResultSet) {
+    for (final result in resultSet) {
+      result.string('name');
+      count++;
+    }
+  } else {
+    await for (final result in resultSet.asStream()) {
+      result.string('name');
+      count++;
+    }
+  }
+  return count;
+}
+
+Future<void> _benchmarkQuery(
+  BenchmarkReport report,
+  Api api,
+  Database db,
+  BenchmarkSuiteConfig config,
+  int documentCount,
+) async {
+  // Prepared queries are cached, which would otherwise turn every but the
+  // first prepare into a cache hit.
+  final cacheCapacity = QueryCache.capacity;
+  QueryCache.capacity = 0;
+  try {
+    report.addDuration(
+      'query/prepare',
+      api: api.name,
+      documentCount: documentCount,
+      durations: await measureRepeatedly(
+        config.repetitions,
+        () => db.createQuery(_querySql),
+      ),
+    );
+  } finally {
+    QueryCache.capacity = cacheCapacity;
+  }
+
+  final query = await db.createQuery(_querySql);
+  report.addDuration(
+    'query/execute',
+    api: api.name,
+    documentCount: documentCount,
+    durations: await measureRepeatedly(
+      config.repetitions,
+      query.execute,
+    ),
+  );
+
+  late ResultSet resultSet;
+  var resultCount = 0;
+  final iterateDurations = await measureRepeatedly(
+    config.repetitions,
+    () async => resultCount = await _iterateResults(resultSet),
+    setUp: () async => resultSet = await query.execute(),
+  );
+  expect(resultCount, greaterThan(0));
+  report.addThroughput(
+    'query/iterate',
+    api: api.name,
+    documentCount: documentCount,
+    count: resultCount,
+    unit: 'results',
+    durations: iterateDurations,
+  );
+}
+
+/// Measures the time from saving a document until a live query, whose
+/// results are affected by the change, notifies its listener.
+Future<void> _benchmarkLiveQuery(
+  BenchmarkReport report,
+  Api api,
+  Database db,
+  Collection collection,
+  BenchmarkSuiteConfig config,
+  int documentCount,
+) async {
+  await collection.createIndex(
+    'type',
+    ValueIndexConfiguration(['type']),
+  );
+
+  final query = await db.createQuery(_markerQuerySql);
+  final resultCounts = StreamController<int>();
+  final changes = query.changes();
+  final subscription = changes.listen((change) async {
+    final results = await change.results.allResults();
+    resultCounts.add(results.length);
+  });
+  addTearDown(subscription.cancel);
+  if (changes is AsyncListenStream<QueryChange>) {
+    await changes.listening;
+  }
+
+  final resultCountsIterator = StreamIterator(resultCounts.stream);
+  // The first change contains the initial results.
+  expect(await resultCountsIterator.moveNext(), isTrue);
+
+  var markerCount = 0;
+  final durations = await measureRepeatedly(config.repetitions, () async {
+    markerCount++;
+    await collection.saveDocument(
+      MutableDocument.withId('marker-$markerCount', {'type': 'marker'}),
+    );
+    while (await resultCountsIterator.moveNext()) {
+      if (resultCountsIterator.current == markerCount) {
+        break;
+      }
+    }
+  });
+
+  report.addDuration(
+    'liveQuery/notificationLatency',
+    api: api.name,
+    documentCount: documentCount,
+    durations: durations,
+  );
+
+  await subscription.cancel();
+  await resultCountsIterator.cancel();
+}
+
+Stream<Uint8List> _blobContent(int size) async* {
+  final data = utf8.encode(largeJsonFixture);
+  for (var offset = 0; offset < size; offset += _blobChunkSize) {
+    final chunk = Uint8List(min(_blobChunkSize, size - offset));
+    for (var i = 0; i < chunk.length; i++) {
+      chunk[i] = data[(offset + i) % data.length];
+    }
+    yield chunk;
+  }
+}
+
+Future<void> _benchmarkBlobStreams(
+  BenchmarkReport report,
+  Api api,
+  Database db,
+  BenchmarkSuiteConfig config,
+) async {
+  final blobSize = config.blobSize;
+  final chunks = await _blobContent(blobSize).toList();
+
+  late Blob blob;
+  final writeDurations = await measureRepeatedly(config.repetitions, () async {
+    blob = Blob.fromStream(
+      'application/octet-stream',
+      Stream.fromIterable(chunks),
+    );
+    await db.saveBlob(blob);
+  });
+  report.addThroughput(
+    'blob/writeStream',
+    api: api.name,
+    count: blobSize,
+    unit: 'bytes',
+    durations: writeDurations,
+  );
+
+  final savedBlob = (await db.getBlob(blob.properties))!;
+  var bytesRead = 0;
+  final readDurations = await measureRepeatedly(config.repetitions, () async {
+    bytesRead = 0;
+    await for (final chunk in savedBlob.contentStream()) {
+      bytesRead += chunk.length;
+    }
+  });
+  expect(bytesRead, blobSize);
+  report.addThroughput(
+    'blob/readStream',
+    api: api.name,
+    count: blobSize,
+    unit: 'bytes',
+    durations: readDurations,
+  );
+}
+
+/// Measures pushing documents to and pulling them from the test Sync Gateway,
+/// with push and pull filters.
+Future<void> _benchmarkReplication(
+  BenchmarkReport report,
+  Api api,
+  Database pushDb,
+  Collection pushCollection,
+  Database pullDb,
+  int documentCount,
+) async {
+  // Documents of previous runs stay in Sync Gateway, so every run uses its
+  // own documents and channel.
+  final runId = DateTime.now().microsecondsSinceEpoch;
+  final channel = 'benchmark-$runId';
+  await _saveDocuments(
+    pushDb,
+    pushCollection,
+    _documents(
+      documentCount,
+      idPrefix: 'benchmark-$runId',
+      channels: [channel],
+    ),
+  );
+
+  var pushedCount = 0;
+  final pusher = await pushDb.createTestReplicator(
+    replicatorType: ReplicatorType.push,
+    pushFilter: (document, flags) {
+      pushedCount++;
+      return document.value('index') != null;
+    },
+  );
+  final pushDuration = await measure(pusher.replicateOneShot);
+  expect(pushedCount, documentCount);
+  report.addThroughput(
+    'replication/push',
+    api: api.name,
+    count: documentCount,
+    unit: 'documents',
+    durations: [pushDuration],
+  );
+
+  var pulledCount = 0;
+  final puller = await pullDb.createTestReplicator(
+    replicatorType: ReplicatorType.pull,
+    channels: [channel],
+    pullFilter: (document, flags) {
+      pulledCount++;
+      return document.value('index') != null;
+    },
+  );
+  final pullDuration = await measure(puller.replicateOneShot);
+  expect(pulledCount, documentCount);
+  report.addThroughput(
+    'replication/pull',
+    api: api.name,
+    count: documentCount,
+    unit: 'documents',
+    durations: [pullDuration],
+  );
+}
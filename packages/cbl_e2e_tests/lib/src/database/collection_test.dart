@@ -1,4 +1,6 @@
 import 'dart:async';
+import 'dart:convert';
+import 'dart:io';
 
 import 'package:cbl/cbl.dart';
 
@@ -95,6 +97,20 @@ void main() {
       });
     });
 
+    apiTest('documents returns the documents in the order of the ids',
+        () async {
+      final db = await openTestDatabase();
+      final collection = await db.defaultCollection;
+
+      final a = MutableDocument({'a': true});
+      final b = MutableDocument({'b': true});
+      await collection.saveDocument(a);
+      await collection.saveDocument(b);
+
+      final documents = await collection.documents([b.id, 'x', a.id]);
+      expect(documents, [b, null, a]);
+    });
+
     apiTest('saveDocument saves the document', () async {
       final db = await openTestDatabase();
       final collection = await db.defaultCollection;
@@ -108,6 +124,261 @@ void main() {
       );
     });
 
+    apiTest('saveDocument saves changes to nested properties', () async {
+      final db = await openTestDatabase();
+      final collection = await db.defaultCollection;
+
+      await collection.saveDocument(MutableDocument.withId('a', {
+        'a': {
+          'b': {'c': 1, 'd': 2},
+          'e': [1, 2],
+        },
+        'f': 'g',
+        'h': true,
+      }));
+
+      final doc = (await collection.document('a'))!.toMutable();
+      doc.dictionary('a')!.dictionary('b')!.setValue(3, key: 'c');
+      doc.dictionary('a')!.array('e')!.addValue(3);
+      doc
+        ..setValue({'j': 'k'}, key: 'i')
+        ..removeValue('h');
+      await collection.saveDocument(doc);
+
+      expect((await collection.document('a'))!.toPlainMap(), {
+        'a': {
+          'b': {'c': 3, 'd': 2},
+          'e': [1, 2, 3],
+        },
+        'f': 'g',
+        'i': {'j': 'k'},
+      });
+
+      // Saving again must apply the changes on top of the saved properties.
+      doc.dictionary('a')!.removeValue('b');
+      await collection.saveDocument(doc);
+
+      expect((await collection.document('a'))!.toPlainMap(), {
+        'a': {
+          'e': [1, 2, 3],
+        },
+        'f': 'g',
+        'i': {'j': 'k'},
+      });
+    });
+
+    apiTest('saveDocument saves cleared and replaced properties', () async {
+      final db = await openTestDatabase();
+      final collection = await db.defaultCollection;
+
+      await collection.saveDocument(MutableDocument.withId('a', {
+        'a': {'b': 1, 'c': 2},
+        'd': 'e',
+      }));
+
+      // Iterating over all properties loads all keys, before they are
+      // cleared.
+      final doc = (await collection.document('a'))!.toMutable();
+      doc.toPlainMap();
+      doc.dictionary('a')!
+        ..toPlainMap()
+        ..setData({'f': 3});
+      await collection.saveDocument(doc);
+
+      expect((await collection.document('a'))!.toPlainMap(), {
+        'a': {'f': 3},
+        'd': 'e',
+      });
+
+      final doc2 = (await collection.document('a'))!.toMutable();
+      doc2
+        ..toPlainMap()
+        ..setData({'g': 'h'});
+      await collection.saveDocument(doc2);
+
+      expect((await collection.document('a'))!.toPlainMap(), {'g': 'h'});
+    });
+
+    apiTest('saveDocuments saves all documents', () async {
+      final db = await openTestDatabase();
+      final collection = await db.defaultCollection;
+
+      final documents = [
+        for (var i = 0; i < 100; i++) MutableDocument({'i': i}),
+      ];
+      final results = await collection.saveDocuments(documents);
+
+      expect(results, everyElement(isTrue));
+      expect(await collection.count, documents.length);
+      expect(
+        (await collection.document(documents.last.id))!.toPlainMap(),
+        {'i': 99},
+      );
+    });
+
+    apiTest('saveDocuments reports conflicts for each document', () async {
+      final db = await openTestDatabase();
+      final collection = await db.defaultCollection;
+
+      final a = MutableDocument({'a': 1});
+      final b = MutableDocument({'b': 1});
+      await collection.saveDocument(a);
+      await collection.saveDocument(b);
+
+      // Create a conflict for `a`.
+      final otherA = (await collection.document(a.id))!.toMutable()
+        ..setValue(2, key: 'a');
+      await collection.saveDocument(otherA);
+
+      a.setValue(3, key: 'a');
+      b.setValue(3, key: 'b');
+      final results = await collection
+          .saveDocuments([a, b], ConcurrencyControl.failOnConflict);
+
+      expect(results, [isFalse, isTrue]);
+      expect((await collection.document(a.id))!.value('a'), 2);
+      expect((await collection.document(b.id))!.value('b'), 3);
+    });
+
+    group('patchDocument', () {
+      apiTest('merges the patch into the document', () async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+
+        final doc = MutableDocument({
+          'a': 1,
+          'b': 2,
+          'c': {'d': 3, 'e': 4},
+          'f': 5,
+        });
+        await collection.saveDocument(doc);
+
+        final result = await collection.patchDocument(doc.id, {
+          'a': 10,
+          'b': null,
+          'c': {'d': null, 'g': 6},
+          'f': {'h': 7},
+        });
+
+        expect(result, isTrue);
+        expect((await collection.document(doc.id))!.toPlainMap(), {
+          'a': 10,
+          'c': {'e': 4, 'g': 6},
+          'f': {'h': 7},
+        });
+      });
+
+      apiTest('creates the document if it does not exist', () async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+
+        final result = await collection.patchDocument('a', {'a': 1, 'b': null});
+
+        expect(result, isTrue);
+        expect((await collection.document('a'))!.toPlainMap(), {'a': 1});
+      });
+    });
+
+    group('changesSince', () {
+      apiTest('reads documents in sequence order in batches', () async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+
+        await collection.saveDocument(MutableDocument.withId('a', {'n': 1}));
+        await collection.saveDocument(MutableDocument.withId('b', {'n': 2}));
+        await collection.saveDocument(MutableDocument.withId('c', {'n': 3}));
+        await collection.deleteDocument((await collection.document('a'))!);
+
+        final batches = await collection.changesSince(0, batchSize: 2).toList();
+
+        expect(batches, hasLength(2));
+        final changes = batches.expand((batch) => batch.changes).toList();
+        expect(changes.map((change) => change.id), ['b', 'c', 'a']);
+        expect(changes.map((change) => change.isDeleted), [false, false, true]);
+        expect(changes[0].properties, {'n': 2});
+        expect(changes[2].properties, isNull);
+        expect(
+          changes.map((change) => change.sequence).toList(),
+          orderedEquals(
+            changes.map((change) => change.sequence).toList()..sort(),
+          ),
+        );
+        expect(batches.last.checkpoint, changes.last.sequence);
+      });
+
+      apiTest('continues after a checkpoint', () async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+
+        await collection.saveDocument(MutableDocument.withId('a'));
+        final checkpoint =
+            (await collection.changesSince(0).single).checkpoint;
+
+        expect(await collection.changesSince(checkpoint).toList(), isEmpty);
+
+        await collection.saveDocument(MutableDocument.withId('b'));
+        final batch = await collection.changesSince(checkpoint).single;
+        expect(batch.changes.map((change) => change.id), ['b']);
+      });
+    });
+
+    group('background operations', () {
+      test('save, get, delete and purge documents', () async {
+        final db = openSyncTestDatabase();
+        final collection = db.defaultCollection;
+
+        final doc = MutableDocument.withId('a', {'b': true});
+        expect(await collection.saveDocumentInBackground(doc), isTrue);
+        expect(doc.revisionId, isNotNull);
+
+        final loadedDoc = await collection.documentInBackground('a');
+        expect(loadedDoc!.toPlainMap(), {'b': true});
+        expect(await collection.documentInBackground('x'), isNull);
+
+        expect(await collection.deleteDocumentInBackground(loadedDoc), isTrue);
+        expect(collection.document('a'), isNull);
+
+        collection.saveDocument(MutableDocument.withId('c'));
+        await collection.purgeDocumentByIdInBackground('c');
+        expect(collection.document('c'), isNull);
+      });
+
+      test('returns false when saving a conflicting document', () async {
+        final db = openSyncTestDatabase();
+        final collection = db.defaultCollection;
+
+        final doc = MutableDocument.withId('a');
+        collection.saveDocument(doc);
+        collection.saveDocument(
+          collection.document('a')!.toMutable()..setValue(1, key: 'b'),
+        );
+
+        expect(
+          await collection.saveDocumentInBackground(
+            doc..setValue(2, key: 'b'),
+            ConcurrencyControl.failOnConflict,
+          ),
+          isFalse,
+        );
+      });
+
+      test('cannot be started in a transaction', () async {
+        final db = openSyncTestDatabase();
+        final collection = db.defaultCollection;
+
+        await db.inBatch(() async {
+          await expectLater(
+            collection.documentInBackground('a'),
+            throwsA(isA<DatabaseException>().having(
+              (it) => it.code,
+              'code',
+              DatabaseErrorCode.transactionNotClosed,
+            )),
+          );
+        });
+      });
+    });
+
     apiTest(
       'save mutable document created from unsaved mutable document',
       () async {
@@ -424,6 +695,114 @@ void main() {
       });
     });
 
+    group('setDocumentExpirations', () {
+      apiTest('sets the times of expiration of multiple documents', () async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+
+        final expiration = DateTime.now().add(const Duration(days: 1));
+        final docA = MutableDocument();
+        final docB = MutableDocument();
+        await collection.saveDocument(docA);
+        await collection.saveDocument(docB);
+        await collection.setDocumentExpiration(docB.id, expiration);
+        await collection.setDocumentExpirations({
+          docA.id: expiration,
+          docB.id: null,
+        });
+
+        expect(
+          (await collection.getDocumentExpiration(docA.id))!
+              .millisecondsSinceEpoch,
+          expiration.millisecondsSinceEpoch,
+        );
+        expect(await collection.getDocumentExpiration(docB.id), isNull);
+        expect(
+          await collection.expirationStats,
+          ExpirationStats(
+            purgedCount: 0,
+            pendingCount: 1,
+            nextExpiration: DateTime.fromMillisecondsSinceEpoch(
+              expiration.millisecondsSinceEpoch,
+            ),
+          ),
+        );
+      });
+
+      apiTest('does not change any expiration if one fails', () async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+
+        final expiration = DateTime.now().add(const Duration(days: 1));
+        final doc = MutableDocument();
+        await collection.saveDocument(doc);
+
+        await expectLater(
+          () => collection.setDocumentExpirations({
+            doc.id: expiration,
+            'missing': expiration,
+          }),
+          throwsA(isA<DatabaseException>()),
+        );
+
+        expect(await collection.getDocumentExpiration(doc.id), isNull);
+        expect((await collection.expirationStats).pendingCount, 0);
+      });
+
+      apiTest('counts documents which are purged when they expire', () async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+
+        final doc = MutableDocument();
+        await collection.saveDocument(doc);
+        await collection.setDocumentExpirations({
+          doc.id: DateTime.now().add(const Duration(milliseconds: 100)),
+        });
+
+        for (var i = 0; i < 100; i++) {
+          if ((await collection.expirationStats).purgedCount > 0) {
+            break;
+          }
+          await Future<void>.delayed(const Duration(milliseconds: 100));
+        }
+
+        expect(await collection.document(doc.id), isNull);
+        expect(
+          await collection.expirationStats,
+          const ExpirationStats(purgedCount: 1, pendingCount: 0),
+        );
+      });
+
+      apiTest(
+        'counts purged documents whose expiration was set individually',
+        () async {
+          final db = await openTestDatabase();
+          final collection = await db.defaultCollection;
+
+          final doc = MutableDocument();
+          await collection.saveDocument(doc);
+          await collection.setDocumentExpiration(
+            doc.id,
+            DateTime.now().add(const Duration(milliseconds: 100)),
+          );
+          expect((await collection.expirationStats).pendingCount, 1);
+
+          for (var i = 0; i < 100; i++) {
+            if ((await collection.expirationStats).purgedCount > 0) {
+              break;
+            }
+            await Future<void>.delayed(const Duration(milliseconds: 100));
+          }
+
+          expect(await collection.document(doc.id), isNull);
+          expect(
+            await collection.expirationStats,
+            const ExpirationStats(purgedCount: 1, pendingCount: 0),
+          );
+        },
+      );
+    });
+
     group('listeners', () {
       apiTest('database change listener is notified while listening', () async {
         final db = await openTestDatabase();
@@ -449,6 +828,31 @@ void main() {
         await collection.saveDocument(MutableDocument());
       });
 
+      apiTest('change listener receives the ids of all changed documents',
+          () async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+
+        final ids = [for (var i = 0; i < 100; i++) 'doc-$i', 'äöü-🚀'];
+        final receivedIds = <String>{};
+        final allIdsReceived = Completer<void>();
+
+        final token = await collection.addChangeListener((change) {
+          receivedIds.addAll(change.documentIds);
+          if (receivedIds.length == ids.length) {
+            allIdsReceived.complete();
+          }
+        });
+        addTearDown(() => collection.removeChangeListener(token));
+
+        for (final id in ids) {
+          await collection.saveDocument(MutableDocument.withId(id));
+        }
+
+        await allIdsReceived.future;
+        expect(receivedIds, unorderedEquals(ids));
+      });
+
       apiTest('document change listener is notified while listening', () async {
         final db = await openTestDatabase();
         final collection = await db.defaultCollection;
@@ -475,6 +879,33 @@ void main() {
         await collection.saveDocument(doc);
       });
 
+      apiTest('debounced document change listener coalesces changes',
+          () async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+
+        final doc = MutableDocument();
+        var notifications = 0;
+
+        final token = await collection.addDocumentChangeListener(
+          doc.id,
+          (change) {
+            expect(change.documentId, doc.id);
+            notifications++;
+          },
+          debounce: const Duration(milliseconds: 500),
+        );
+        addTearDown(() => collection.removeChangeListener(token));
+
+        for (var i = 0; i < 5; i++) {
+          doc.setValue(i, key: 'i');
+          await collection.saveDocument(doc);
+        }
+
+        await Future<void>.delayed(const Duration(seconds: 1));
+        expect(notifications, inInclusiveRange(1, 2));
+      });
+
       apiTest(
         'database change stream emits event when database changes',
         () async {
@@ -511,6 +942,181 @@ void main() {
       );
     });
 
+    group('importJsonLines', () {
+      apiTest('imports documents from a stream', () async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+        final progress = <int>[];
+
+        // Lines are split across chunks and blank lines are skipped.
+        final chunks = [
+          '{"id": "a", "n": 1}\n{"id": ',
+          '"b", "n": 2}\n\r\n{"n": 3}',
+        ].map(utf8.encode);
+
+        final importedCount = await collection.importJsonLines(
+          Stream.fromIterable(chunks),
+          idKeyPath: 'id',
+          batchSize: 2,
+          onProgress: progress.add,
+        );
+
+        expect(importedCount, 3);
+        expect(progress, [2, 3]);
+        expect(await collection.count, 3);
+        expect((await collection.document('a'))!.toPlainMap(), {
+          'id': 'a',
+          'n': 1,
+        });
+        expect((await collection.document('b'))!.toPlainMap(), {
+          'id': 'b',
+          'n': 2,
+        });
+      });
+
+      apiTest('imports documents from a file', () async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+        final file = File('$tmpDir/import_json_lines.ndjson');
+        await file.writeAsString(
+          [for (var i = 0; i < 10; i++) '{"id": "$i"}'].join('\n'),
+        );
+
+        final importedCount = await collection.importJsonLinesFile(
+          file.path,
+          idKeyPath: 'id',
+          batchSize: 3,
+        );
+
+        expect(importedCount, 10);
+        expect(await collection.count, 10);
+        expect(await collection.document('9'), isNotNull);
+      });
+
+      apiTest('fails when a line does not contain an object', () async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+
+        await expectLater(
+          collection.importJsonLines(
+            Stream.value(utf8.encode('{"a": true}\n[]\n')),
+            batchSize: 1,
+          ),
+          throwsA(isA<DatabaseException>().having(
+            (exception) => exception.code,
+            'code',
+            DatabaseErrorCode.invalidParameter,
+          )),
+        );
+
+        // The batch which was saved before the error is kept.
+        expect(await collection.count, 1);
+      });
+    });
+
+    group('removeWhere', () {
+      Future<Collection> createDocuments() async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+        for (var i = 0; i < 5; i++) {
+          await collection.saveDocument(
+            MutableDocument.withId('$i', {'old': i.isEven}),
+          );
+        }
+        return collection;
+      }
+
+      apiTest('deleteWhere deletes matching documents in batches', () async {
+        final collection = await createDocuments();
+        final progress = <int>[];
+
+        final deletedCount = await collection.deleteWhere(
+          Expression.property('old').equalTo(Expression.boolean(true)),
+          batchSize: 2,
+          onProgress: progress.add,
+        );
+
+        expect(deletedCount, 3);
+        expect(progress, [2, 3]);
+        expect(await collection.count, 2);
+        expect(await collection.document('0'), isNull);
+        expect(await collection.document('1'), isNotNull);
+      });
+
+      apiTest('purgeWhere purges matching documents', () async {
+        final collection = await createDocuments();
+
+        final purgedCount = await collection.purgeWhere(
+          Meta.id.greaterThan(Expression.string('2')),
+        );
+
+        expect(purgedCount, 2);
+        expect(await collection.count, 3);
+        expect(await collection.document('3'), isNull);
+        expect(await collection.document('2'), isNotNull);
+      });
+    });
+
+    group('fullTextSearch', () {
+      Future<Collection> createIndexedDocuments() async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+        await collection.createIndex('text', FullTextIndexConfiguration(['a']));
+        await collection.saveDocument(MutableDocument.withId('fox', {
+          'a': 'The quick brown fox jumps over the lazy dog.',
+        }));
+        await collection.saveDocument(MutableDocument.withId('foxes', {
+          'a': 'A fox and another fox met a third fox.',
+        }));
+        await collection.saveDocument(MutableDocument.withId('cat', {
+          'a': 'The cat sleeps.',
+        }));
+        return collection;
+      }
+
+      apiTest('returns pages of results ordered by rank', () async {
+        final collection = await createIndexedDocuments();
+
+        final results = await collection.fullTextSearch('text', 'fox');
+        expect(results.map((result) => result.id), ['foxes', 'fox']);
+        expect(results[0].rank, greaterThan(results[1].rank));
+        expect(results[0].snippet, isNull);
+
+        final secondPage = await collection.fullTextSearch(
+          'text',
+          'fox',
+          limit: 1,
+          offset: 1,
+        );
+        expect(secondPage, [results[1]]);
+      });
+
+      apiTest('makes snippets with marked matches', () async {
+        final collection = await createIndexedDocuments();
+
+        final results = await collection.fullTextSearch(
+          'text',
+          'lazy',
+          snippetProperty: 'a',
+          snippetWordCount: 3,
+          matchStart: '[',
+          matchEnd: ']',
+          ellipsis: '...',
+        );
+
+        expect(results.single.snippet, '...over the [lazy]...');
+      });
+
+      apiTest('throws when limit is out of range', () async {
+        final collection = await createIndexedDocuments();
+
+        expect(
+          () => collection.fullTextSearch('text', 'fox', limit: 0),
+          throwsRangeError,
+        );
+      });
+    });
+
     group('Index', () {
       apiTest('createIndex should work with ValueIndexConfiguration', () async {
         final db = await openTestDatabase();
@@ -575,6 +1181,58 @@ void main() {
         expect(explain, contains('fts1 VIRTUAL TABLE INDEX'));
       });
 
+      apiTest('createIndex should work with ArrayIndexConfiguration', () async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+
+        await collection.createIndex(
+          'a',
+          ArrayIndexConfiguration('contacts', expressions: ['name']),
+        );
+
+        expect(await collection.indexes, ['a']);
+      });
+
+      apiTest('createIndex should work with ArrayIndex', () async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+
+        await collection.createIndex('a', IndexBuilder.arrayIndex('tags'));
+
+        expect(await collection.indexes, ['a']);
+      });
+
+      apiTest('buildIndex should build the index in the background', () async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+        final states = <IndexBuildState>[];
+
+        final build = collection.buildIndex(
+          'a',
+          ValueIndexConfiguration(['a']),
+          onProgress: states.add,
+        );
+        expect(build.state, IndexBuildState.pending);
+
+        expect(await build.result, isTrue);
+        expect(build.state, IndexBuildState.completed);
+        expect(states, [IndexBuildState.building, IndexBuildState.completed]);
+        expect(await collection.indexes, ['a']);
+      });
+
+      apiTest('buildIndex should not create a cancelled index', () async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+
+        final build =
+            collection.buildIndex('a', ValueIndexConfiguration(['a']))
+              ..cancel();
+
+        expect(await build.result, isFalse);
+        expect(build.state, IndexBuildState.cancelled);
+        expect(await collection.indexes, isEmpty);
+      });
+
       apiTest('deleteIndex should delete the given index', () async {
         final db = await openTestDatabase();
         final collection = await db.defaultCollection;
@@ -116,6 +116,12 @@ void main() {
 
       b = DatabaseConfiguration(directory: 'B');
       expect(b, isNot(a));
+
+      b = DatabaseConfiguration(directory: 'A', sharedHandle: true);
+      expect(b, isNot(a));
+
+      b = DatabaseConfiguration(directory: 'A', workerPoolSize: 2);
+      expect(b, isNot(a));
     });
 
     test('toString', () {
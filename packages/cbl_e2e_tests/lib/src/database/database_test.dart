@@ -139,6 +139,116 @@ void main() {
         );
       });
 
+      apiTest('shared handle stays open until the last opener closes it',
+          () async {
+        final config = DatabaseConfiguration(
+          directory: databaseDirectoryForTest(),
+          sharedHandle: true,
+        );
+        final a = await openTestDatabase(config: config);
+        final b = await openTestDatabase(config: config);
+
+        await a.saveDocument(MutableDocument.withId('a'));
+        expect((await b.document('a'))?.id, 'a');
+
+        await a.close();
+        await b.saveDocument(MutableDocument.withId('b'));
+        expect(await b.count, 2);
+      });
+
+      apiTest('shared handles do not join transactions of other handles',
+          () async {
+        final config = DatabaseConfiguration(
+          directory: databaseDirectoryForTest(),
+          sharedHandle: true,
+        );
+        final a = await openTestDatabase(config: config);
+        final b = await openTestDatabase(config: config);
+
+        await Future.wait([
+          a.inBatch(() async {
+            await a.saveDocument(MutableDocument.withId('a'));
+            await Future<void>.delayed(const Duration(milliseconds: 10));
+          }),
+          expectLater(
+            b.inBatch(() async {
+              await b.saveDocument(MutableDocument.withId('b'));
+              throw Exception();
+            }),
+            throwsException,
+          ),
+        ]);
+
+        expect(await a.document('a'), isNotNull);
+        expect(await a.document('b'), isNull);
+      });
+
+      apiTest('shared handle cannot be opened with a different encryption key',
+          () async {
+        final directory = databaseDirectoryForTest();
+        await openTestDatabase(
+          config: DatabaseConfiguration(
+            directory: directory,
+            encryptionKey: EncryptionKey.key(randomRawEncryptionKey()),
+            sharedHandle: true,
+          ),
+        );
+
+        expect(
+          Future(() => openTestDatabase(
+                config: DatabaseConfiguration(
+                  directory: directory,
+                  encryptionKey: EncryptionKey.key(randomRawEncryptionKey()),
+                  sharedHandle: true,
+                ),
+              )),
+          throwsA(isA<DatabaseException>()),
+        );
+      });
+
+      test('worker pool executes queries in additional workers', () async {
+        final db = await openAsyncTestDatabase(
+          config: DatabaseConfiguration(
+            directory: databaseDirectoryForTest(),
+            workerPoolSize: 3,
+          ),
+          usePublicApi: true,
+        );
+        await db.saveDocument(MutableDocument.withId('a', {'n': 1}));
+
+        final queries = await Future.wait(List.generate(
+          4,
+          (_) => db.createQuery('SELECT n FROM _'),
+        ));
+        final results = await Future.wait(queries.map((query) async {
+          final resultSet = await query.execute();
+          return (await resultSet.allPlainMapResults()).single;
+        }));
+        expect(results, everyElement({'n': 1}));
+
+        // Writes of the first worker are seen by the queries of the others.
+        await db.saveDocument(MutableDocument.withId('b', {'n': 2}));
+        final resultSet = await queries.last.execute();
+        expect(await resultSet.allPlainMapResults(), hasLength(2));
+      });
+
+      test('worker pool database can be deleted', () async {
+        final db = await openAsyncTestDatabase(
+          config: DatabaseConfiguration(
+            directory: databaseDirectoryForTest(),
+            workerPoolSize: 2,
+          ),
+          usePublicApi: true,
+        );
+        await db.saveDocument(MutableDocument.withId('a'));
+
+        await db.delete();
+        expect(
+          await Database.exists(db.name, directory: databaseDirectoryForTest()),
+          isFalse,
+        );
+      });
+
       apiTest('performMaintenance: compact', () async {
         final db = await openTestDatabase();
         await db.performMaintenance(MaintenanceType.compact);
@@ -158,6 +268,51 @@ void main() {
         await db.performMaintenance(MaintenanceType.integrityCheck);
       });
 
+      apiTest('performMaintenance: optimize', () async {
+        final db = await openTestDatabase();
+        await db.performMaintenance(MaintenanceType.optimize);
+      });
+
+      apiTest('scheduleMaintenance runs maintenance when idle', () async {
+        final db = await openTestDatabase();
+        await db.saveDocument(MutableDocument({'a': 'b'}));
+
+        final progress = <MaintenanceProgress>[];
+        final finished = Completer<MaintenanceReport>();
+        final schedule = db.scheduleMaintenance(
+          interval: Duration.zero,
+          idleTimeout: const Duration(milliseconds: 100),
+          onProgress: (event) {
+            progress.add(event);
+            final report = event.report;
+            if (report != null && !finished.isCompleted) {
+              finished.complete(report);
+            }
+          },
+        );
+        addTearDown(schedule.close);
+
+        final report = await finished.future;
+        expect(report.error, isNull);
+        expect(report.fileSizeBefore, greaterThan(0));
+        expect(report.fragmentation, inInclusiveRange(0, 1));
+        expect(schedule.lastReport, report);
+        expect(progress.map((event) => event.type).take(2), [
+          MaintenanceType.compact,
+          MaintenanceType.optimize,
+        ]);
+      });
+
+      apiTest('scheduleMaintenance is stopped when database is closed',
+          () async {
+        final db = await openTestDatabase();
+        final schedule = db.scheduleMaintenance();
+
+        await db.close();
+
+        expect(schedule.isClosed, isTrue);
+      });
+
       apiTest('changeEncryptionKey: encrypt database', () async {
         final key = EncryptionKey.key(randomRawEncryptionKey());
         final db = await openTestDatabase();
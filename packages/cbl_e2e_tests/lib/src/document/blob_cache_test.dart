@@ -0,0 +1,72 @@
+import 'dart:typed_data';
+
+import 'package:cbl/cbl.dart';
+
+import '../../test_binding_impl.dart';
+import '../test_binding.dart';
+import '../utils/database_utils.dart';
+
+void main() {
+  setupTestBinding();
+
+  group('BlobCache', () {
+    void enableCache({int maxSize = 1024 * 1024}) {
+      final previousMaxSize = BlobCache.maxSize;
+      addTearDown(() => BlobCache.maxSize = previousMaxSize);
+      BlobCache.maxSize = maxSize;
+    }
+
+    test('reads content of small blobs from the cache', () async {
+      enableCache();
+      final db = openSyncTestDatabase();
+      final content = Uint8List.fromList([1, 2, 3]);
+      final blob = Blob.fromData('application/octet-stream', content);
+      await db.saveBlob(blob);
+
+      final stats = BlobCache.stats;
+      expect(await db.getBlob(blob.properties)!.content(), content);
+      expect(BlobCache.stats.misses, stats.misses + 1);
+
+      expect(await db.getBlob(blob.properties)!.content(), content);
+      expect(BlobCache.stats.hits, stats.hits + 1);
+      expect(
+        await db.getBlob(blob.properties)!.contentStream(start: 1).first,
+        [2, 3],
+      );
+      expect(BlobCache.stats.hits, stats.hits + 2);
+    });
+
+    test('does not cache content of large blobs', () async {
+      enableCache();
+      final db = openSyncTestDatabase();
+      final content = Uint8List(BlobCache.maxEntrySize + 1);
+      final blob = Blob.fromData('application/octet-stream', content);
+      await db.saveBlob(blob);
+
+      final stats = BlobCache.stats;
+      expect(await db.getBlob(blob.properties)!.content(), content);
+      expect(await db.getBlob(blob.properties)!.content(), content);
+      expect(BlobCache.stats.hits, stats.hits);
+      expect(BlobCache.stats.misses, stats.misses);
+    });
+
+    test('evicts content which exceeds the maximum size', () async {
+      enableCache(maxSize: 4);
+      final db = openSyncTestDatabase();
+      final a = Blob.fromData('text/plain', Uint8List.fromList([1, 2, 3]));
+      final b = Blob.fromData('text/plain', Uint8List.fromList([4, 5, 6]));
+      await db.saveBlob(a);
+      await db.saveBlob(b);
+
+      final stats = BlobCache.stats;
+      await db.getBlob(a.properties)!.content();
+      await db.getBlob(b.properties)!.content();
+      expect(BlobCache.stats.evictions, stats.evictions + 1);
+    });
+
+    test('throws when limits are negative', () {
+      expect(() => BlobCache.maxSize = -1, throwsRangeError);
+      expect(() => BlobCache.maxEntrySize = -1, throwsRangeError);
+    });
+  });
+}
@@ -2,6 +2,7 @@
 // ignore_for_file: deprecated_member_use
 
 import 'dart:convert' hide json;
+import 'dart:io';
 import 'dart:math';
 import 'dart:typed_data';
 
@@ -167,6 +168,143 @@ void main() {
       variants: [writeBlob, readTime, readMode, readBlob, blobSize],
     );
 
+    test('content stream reads large blob in growing chunks', () async {
+      final db = openSyncTestDatabase();
+      final content = Uint8List.fromList(
+        List.generate(3 * 1024 * 1024, (i) => i % 251),
+      );
+      final doc = MutableDocument({
+        'blob': Blob.fromData(contentType, content),
+      });
+      db.saveDocument(doc);
+
+      final chunks =
+          await db.document(doc.id)!.blob('blob')!.contentStream().toList();
+
+      expect(chunks.first.length, 8 * 1024);
+      expect(chunks.length, lessThan(16));
+      for (var i = 1; i < chunks.length - 1; i++) {
+        expect(chunks[i].length, greaterThanOrEqualTo(chunks[i - 1].length));
+      }
+      expect(chunks.expand((chunk) => chunk).toList(), content);
+    });
+
+    apiTest('read range of content stream', () async {
+      final db = await openTestDatabase();
+      final content = Uint8List.fromList(
+        List.generate(64 * 1024, (i) => i % 251),
+      );
+      final blob = Blob.fromData(contentType, content);
+      final doc = MutableDocument({'blob': blob});
+      await db.saveDocument(doc);
+      final loadedBlob = (await db.document(doc.id))!.blob('blob')!;
+
+      for (final readBlob in [blob, loadedBlob]) {
+        expect(
+          await byteStreamToFuture(
+            readBlob.contentStream(start: 1000, end: 30000),
+          ),
+          content.sublist(1000, 30000),
+        );
+        expect(
+          await byteStreamToFuture(readBlob.contentStream(start: 60000)),
+          content.sublist(60000),
+        );
+        expect(
+          await byteStreamToFuture(readBlob.contentStream(start: 5, end: 5)),
+          isEmpty,
+        );
+      }
+    });
+
+    apiTest('read content stream ahead', () async {
+      final db = await openTestDatabase();
+      final content = Uint8List.fromList(
+        List.generate(3 * 1024 * 1024, (i) => i % 251),
+      );
+      final doc = MutableDocument({
+        'blob': Blob.fromData(contentType, content),
+      });
+      await db.saveDocument(doc);
+      final blob = (await db.document(doc.id))!.blob('blob')!;
+
+      expect(
+        await byteStreamToFuture(blob.contentStream(readAhead: 2)),
+        content,
+      );
+      expect(
+        await byteStreamToFuture(
+          blob.contentStream(start: 1000, end: 300000, readAhead: 1),
+        ),
+        content.sublist(1000, 300000),
+      );
+
+      // Pausing the listener must not lose chunks.
+      final chunks = <Uint8List>[];
+      final subscription = blob.contentStream(readAhead: 2).listen(chunks.add);
+      subscription.pause();
+      await Future<void>.delayed(const Duration(milliseconds: 100));
+      subscription.resume();
+      await subscription.asFuture<void>();
+      expect(chunks.expand((chunk) => chunk).toList(), content);
+    });
+
+    test('read range of content stream of stream blob', () async {
+      final blob = Blob.fromStream(
+        contentType,
+        Stream.fromIterable([
+          Uint8List.fromList([0, 1, 2]),
+          Uint8List.fromList([3, 4, 5]),
+          Uint8List.fromList([6, 7, 8]),
+        ]),
+      );
+
+      expect(
+        await byteStreamToFuture(blob.contentStream(start: 2, end: 7)),
+        [2, 3, 4, 5, 6],
+      );
+    });
+
+    test('content stream throws for invalid range', () {
+      final blob = Blob.fromData(contentType, Uint8List(10));
+
+      expect(() => blob.contentStream(start: -1), throwsRangeError);
+      expect(() => blob.contentStream(start: 5, end: 4), throwsRangeError);
+      expect(() => blob.contentStream(end: 11), throwsRangeError);
+    });
+
+    apiTest('save blob from file and write it to a file', () async {
+      final db = await openTestDatabase();
+      final content = randomBytes(3 * 1024 * 1024);
+      final sourceFile = File('$tmpDir/blob_source.bin');
+      await sourceFile.writeAsBytes(content);
+
+      final blob = await db.saveBlobFromFile(contentType, sourceFile.path);
+      expect(blob.contentType, contentType);
+      expect(blob.length, content.length);
+      final dataBlob = Blob.fromData(contentType, content);
+      await db.saveBlob(dataBlob);
+      expect(blob.digest, dataBlob.digest);
+      expect(await blob.content(), content);
+
+      final targetFile = File('$tmpDir/blob_target.bin');
+      await blob.writeToFile(targetFile.path);
+      expect(await targetFile.readAsBytes(), content);
+    });
+
+    apiTest('save blob from file fails for missing file', () async {
+      final db = await openTestDatabase();
+
+      await expectLater(
+        db.saveBlobFromFile(contentType, '$tmpDir/missing_blob_source.bin'),
+        throwsA(isA<DatabaseException>().having(
+          (it) => it.code,
+          'code',
+          DatabaseErrorCode.cantOpenFile,
+        )),
+      );
+    });
+
     apiTest('remove from document', () async {
       final db = await openTestDatabase();
       final blob = blobFromData();
@@ -178,6 +316,29 @@ void main() {
       expect(loadedDoc.value('blob'), isNull);
     });
 
+    test('does not write content of blob which already exists', () {
+      final db = openSyncTestDatabase();
+      final content = Uint8List.fromList(List.generate(1024, (i) => i % 256));
+
+      db.saveDocument(MutableDocument({
+        'blob': Blob.fromData('application/octet-stream', content),
+      }));
+      final stats = BlobDeduplication.stats;
+
+      final doc = MutableDocument({
+        'blob': Blob.fromData('application/octet-stream', content),
+      });
+      db.saveDocument(doc);
+
+      expect(BlobDeduplication.stats.deduplications, stats.deduplications + 1);
+      expect(
+        BlobDeduplication.stats.deduplicatedSize,
+        stats.deduplicatedSize + content.length,
+      );
+      expect(BlobDeduplication.stats.writes, stats.writes);
+      expect(db.document(doc.id)!.blob('blob')!.content(), completion(content));
+    });
+
     test('toJson returns JSON representation of saved blob', () async {
       final db = openSyncTestDatabase();
       final blob = blobFromDataWithLength();
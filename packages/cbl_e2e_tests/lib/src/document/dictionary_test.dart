@@ -107,6 +107,43 @@ void main() {
       });
     });
 
+    test('project', () {
+      final projection = KeyPathProjection([
+        'string',
+        'array[0]',
+        'array[-1]',
+        'dictionary.key',
+        'dictionary',
+        'blob',
+        'missing',
+        'array[2]',
+      ]);
+      final data = {
+        'string': 'a',
+        'array': [false, true],
+        'dictionary': {'key': 'value'},
+        'blob': testBlob,
+      };
+      final expected = [
+        'a',
+        false,
+        true,
+        'value',
+        {'key': 'value'},
+        testBlob,
+        null,
+        null,
+      ];
+
+      expect(immutableDictionary(data).project(projection), expected);
+      expect(MutableDictionary(data).project(projection), expected);
+    });
+
+    test('KeyPathProjection throws for invalid key path', () {
+      expect(() => KeyPathProjection(['a[x]']), throwsArgumentError);
+      expect(() => KeyPathProjection([r'a\']), throwsArgumentError);
+    });
+
     test('toJson', () {
       expect(immutableDictionary().toJson(), '{}');
       expect(
@@ -0,0 +1,120 @@
+import 'package:cbl/cbl.dart';
+
+import '../../test_binding_impl.dart';
+import '../test_binding.dart';
+import '../utils/database_utils.dart';
+
+void main() {
+  setupTestBinding();
+
+  group('DocumentCache', () {
+    void enableCache({int maxCount = 100, int maxSize = 1024 * 1024}) {
+      final previousMaxCount = DocumentCache.maxCount;
+      final previousMaxSize = DocumentCache.maxSize;
+      addTearDown(() {
+        DocumentCache.maxCount = previousMaxCount;
+        DocumentCache.maxSize = previousMaxSize;
+      });
+      DocumentCache.maxCount = maxCount;
+      DocumentCache.maxSize = maxSize;
+    }
+
+    test('reads documents from the cache', () {
+      enableCache();
+      final db = openSyncTestDatabase();
+      final collection = db.defaultCollection
+        ..saveDocument(MutableDocument.withId('a', {'a': true}));
+
+      final stats = DocumentCache.stats;
+      expect(collection.document('a')!.toPlainMap(), {'a': true});
+      expect(DocumentCache.stats.misses, stats.misses + 1);
+
+      expect(collection.document('a')!.toPlainMap(), {'a': true});
+      expect(DocumentCache.stats.hits, stats.hits + 1);
+    });
+
+    test('invalidates changed documents', () {
+      enableCache();
+      final db = openSyncTestDatabase();
+      final collection = db.defaultCollection
+        ..saveDocument(MutableDocument.withId('a', {'value': 1}));
+      collection.document('a');
+
+      final stats = DocumentCache.stats;
+      collection.saveDocument(
+        collection.document('a')!.toMutable()..setValue(2, key: 'value'),
+      );
+      expect(DocumentCache.stats.invalidations, stats.invalidations + 1);
+      expect(collection.document('a')!.value('value'), 2);
+
+      collection.deleteDocument(collection.document('a')!);
+      expect(collection.document('a'), isNull);
+    });
+
+    test('reads changes made in a transaction', () {
+      enableCache();
+      final db = openSyncTestDatabase();
+      final collection = db.defaultCollection
+        ..saveDocument(MutableDocument.withId('a', {'value': 1}));
+      collection.document('a');
+
+      db.inBatchSync(() {
+        collection.saveDocument(
+          collection.document('a')!.toMutable()..setValue(2, key: 'value'),
+        );
+        expect(collection.document('a')!.value('value'), 2);
+      });
+      expect(collection.document('a')!.value('value'), 2);
+    });
+
+    test('does not cache documents of aborted transactions', () {
+      enableCache();
+      final db = openSyncTestDatabase();
+      final collection = db.defaultCollection
+        ..saveDocument(MutableDocument.withId('a', {'value': 1}));
+
+      expect(
+        () => db.inBatchSync(() {
+          collection.saveDocument(
+            collection.document('a')!.toMutable()..setValue(2, key: 'value'),
+          );
+          expect(collection.document('a')!.value('value'), 2);
+          throw Exception();
+        }),
+        throwsException,
+      );
+      expect(collection.document('a')!.value('value'), 1);
+    });
+
+    test('evicts documents which exceed the maximum count', () {
+      enableCache(maxCount: 1);
+      final db = openSyncTestDatabase();
+      final collection = db.defaultCollection
+        ..saveDocument(MutableDocument.withId('a'))
+        ..saveDocument(MutableDocument.withId('b'));
+
+      final stats = DocumentCache.stats;
+      collection
+        ..document('a')
+        ..document('b');
+      expect(DocumentCache.stats.evictions, stats.evictions + 1);
+    });
+
+    test('releases documents when the database is closed', () {
+      enableCache();
+      final db = openSyncTestDatabase();
+      db.defaultCollection
+        ..saveDocument(MutableDocument.withId('a'))
+        ..document('a');
+
+      final stats = DocumentCache.stats;
+      db.close();
+      expect(DocumentCache.stats.count, stats.count - 1);
+    });
+
+    test('throws when limits are negative', () {
+      expect(() => DocumentCache.maxCount = -1, throwsRangeError);
+      expect(() => DocumentCache.maxSize = -1, throwsRangeError);
+    });
+  });
+}
@@ -1,6 +1,9 @@
+import 'dart:convert';
 import 'dart:typed_data';
 
+import 'package:cbl/cbl.dart' show FleeceException;
 import 'package:cbl/src/bindings.dart';
+import 'package:cbl/src/fleece/containers.dart' as fl;
 import 'package:cbl/src/fleece/decoder.dart';
 import 'package:cbl/src/fleece/encoder.dart';
 
@@ -52,6 +55,52 @@ void main() {
       },
     );
 
+    test('ArrayIterator loads values in batches', () {
+      final data = FleeceEncoder().convertJson('[0, 1, 2, 3, 4, 5, 6]');
+      final sliceResult = data.toSliceResult();
+      final flArray =
+          _valueBinds.fromData(sliceResult, FLTrust.trusted)!.cast<FLArray>();
+
+      final iterator = ArrayIterator(flArray, batchSize: 3);
+      final values = <int>[];
+      while (iterator.moveNext()) {
+        values.add(iterator.loadedValue.asInt);
+      }
+
+      expect(values, [0, 1, 2, 3, 4, 5, 6]);
+      expect(iterator.moveNext(), isFalse);
+    });
+
+    test('DictIterator loads entries in batches', () {
+      final sharedKeys = fl.SharedKeys();
+      final sharedKeysTable = SharedKeysTable();
+      final sharedStringsTable = SharedStringsTable();
+      final data = (FleeceEncoder()..setSharedKeys(sharedKeys))
+          .convertJson('{"a": 0, "b": 1, "c": 2, "d": 3, "e": 4}');
+      final doc =
+          fl.Doc.fromResultData(data, FLTrust.trusted, sharedKeys: sharedKeys);
+
+      Map<String, int> decode({required int consume}) {
+        final iterator = DictIterator(
+          doc.root.pointer.cast(),
+          sharedKeysTable: sharedKeysTable,
+          batchSize: 2,
+        );
+        final entries = <String, int>{};
+        while (entries.length < consume && iterator.moveNext()) {
+          entries[sharedKeysTable.decodeKey(
+            iterator.loadedKey,
+            sharedStringsTable,
+          )] = iterator.loadedValue.asInt;
+        }
+        return entries;
+      }
+
+      // Partially consuming a batch must not lose shared keys.
+      expect(decode(consume: 1), {'a': 0});
+      expect(decode(consume: 5), {'a': 0, 'b': 1, 'c': 2, 'd': 3, 'e': 4});
+    });
+
     group('FleeceDecoder', () {
       test('converts untrusted Fleece data to Dart object', () {
         final encoder = FleeceEncoder();
@@ -135,12 +184,88 @@ void main() {
         ]);
       });
 
+      test('decodes ASCII and non-ASCII strings', () {
+        const strings = [
+          '',
+          'a',
+          'abcdefghijklmnopqrstuvwxyz0123456789',
+          'ä',
+          'abcdefghijklmnopqrstuvwxyz0123456789ä',
+          '😀',
+        ];
+        final data = FleeceEncoder().convertJson(jsonEncode({
+          for (final string in strings) string: string,
+        }));
+
+        expect(testFleeceDecoder().convert(data), {
+          for (final string in strings) string: string,
+        });
+      });
+
       test('throws when untrusted Fleece data is invalid', () {
         final data = Data.fromTypedList(Uint8List(0));
 
         expect(() => testFleeceDecoder().convert(data), throwsArgumentError);
       });
     });
+
+    group('FleeceTapeDecoder', () {
+      test('decodes values with shared keys', () {
+        final sharedKeys = fl.SharedKeys();
+        final sharedKeysTable = SharedKeysTable();
+        final decoder = FleeceTapeDecoder(sharedKeysTable: sharedKeysTable);
+
+        for (var i = 0; i < 2; i++) {
+          final data = (FleeceEncoder()..setSharedKeys(sharedKeys))
+              .convertJson('{"a": {"a": $i, "b": [{"b": "$i"}]}}');
+          final doc = fl.Doc.fromResultData(
+            data,
+            FLTrust.trusted,
+            sharedKeys: sharedKeys,
+          );
+
+          expect(decoder.decode(doc.root.pointer), {
+            'a': {
+              'a': i,
+              'b': [
+                {'b': '$i'}
+              ]
+            }
+          });
+        }
+      });
+
+      test('converts decoded dicts with dictConverter', () {
+        final data = FleeceEncoder().convertJson('{"a": {"b": true}}');
+        final doc = fl.Doc.fromResultData(data, FLTrust.trusted);
+        final decoder = FleeceTapeDecoder(
+          dictConverter: (dict) => dict.containsKey('b') ? 'b' : dict,
+        );
+
+        expect(decoder.decode(doc.root.pointer), {'a': 'b'});
+      });
+
+      test('interns strings across decodes', () {
+        final long = 'a' * 65;
+        final sharedStringsTable = InterningSharedStringsTable();
+        final decoder =
+            FleeceTapeDecoder(sharedStringsTable: sharedStringsTable);
+
+        for (var i = 0; i < 2; i++) {
+          final data =
+              FleeceEncoder().convertJson('["a", "ü", "$long", "$i"]');
+          final doc = fl.Doc.fromResultData(data, FLTrust.trusted);
+
+          expect(decoder.decode(doc.root.pointer), ['a', 'ü', long, '$i']);
+        }
+
+        expect(sharedStringsTable.hasString('a'), isTrue);
+        expect(sharedStringsTable.hasString('ü'), isTrue);
+        expect(sharedStringsTable.hasString('0'), isTrue);
+        expect(sharedStringsTable.hasString('1'), isTrue);
+        expect(sharedStringsTable.hasString(long), isFalse);
+      });
+    });
   });
 
   group('Fleece Encoding', () {
@@ -236,6 +361,44 @@ void main() {
           ],
         );
       });
+
+      test('writes values which span multiple tape flushes', () {
+        final decoder = testFleeceDecoder();
+        final value = [
+          for (var i = 0; i < 10000; i++) {'i': i, 's': 'ü' * (i % 16)}
+        ];
+        final encoder = FleeceEncoder()..writeDartObject(value);
+
+        expect(decoder.convert(encoder.finish()), value);
+      });
+
+      test('writes long ASCII and non-ASCII strings', () {
+        final decoder = testFleeceDecoder();
+        final value = [
+          'a' * 100,
+          'ä' * 100,
+          '中' * 100,
+          '${'a' * 60}😀${'b' * 60}',
+          // Unpaired surrogates are replaced with U+FFFD.
+          '${'a' * 64}\uD800',
+          '\uDC00${'a' * 64}',
+        ];
+        final encoder = FleeceEncoder()..writeDartObject(value);
+
+        expect(decoder.convert(encoder.finish()), [
+          ...value.take(4),
+          '${'a' * 64}�',
+          '�${'a' * 64}',
+        ]);
+      });
+
+      test('throws for invalid writes when flushing', () {
+        final encoder = FleeceEncoder()
+          ..beginDict(0)
+          ..writeNull();
+
+        expect(encoder.flush, throwsA(isA<FleeceException>()));
+      });
     });
   });
 }
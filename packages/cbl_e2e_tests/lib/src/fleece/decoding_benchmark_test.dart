@@ -54,6 +54,25 @@ class FleeceRecursiveDecodingBenchmark extends DecodingBenchmark {
 class FleeceListenerDecodingBenchmark extends DecodingBenchmark {
   FleeceListenerDecodingBenchmark() : super('Fleece (listener)');
 
+  final sharedKeys = fl.SharedKeys();
+  final sharedKeysTable = SharedKeysTable();
+  late final data =
+      (FleeceEncoder()..setSharedKeys(sharedKeys)).convertJson(jsonString);
+
+  @override
+  void run() {
+    // ignore: deprecated_member_use
+    ListenerFleeceDecoder(
+      trust: FLTrust.trusted,
+      sharedKeys: sharedKeys,
+      sharedKeysTable: sharedKeysTable,
+    ).convert(data);
+  }
+}
+
+class FleeceTapeDecodingBenchmark extends DecodingBenchmark {
+  FleeceTapeDecodingBenchmark() : super('Fleece (tape)');
+
   final sharedKeys = fl.SharedKeys();
   final sharedKeysTable = SharedKeysTable();
   late final data =
@@ -95,6 +114,60 @@ class FleeceWrapperDecodingBenchmark extends DecodingBenchmark {
   }
 }
 
+/// Decodes many small nested containers, for which the cost of beginning and
+/// finishing an iterator per container dominates.
+abstract class NestedContainersDecodingBenchmark extends BenchmarkBase {
+  NestedContainersDecodingBenchmark(String description)
+      : super('Decoding nested containers: $description');
+
+  final sharedKeys = fl.SharedKeys();
+  final sharedKeysTable = SharedKeysTable();
+  late final data = (FleeceEncoder()..setSharedKeys(sharedKeys)).convertJson(
+    jsonEncode([
+      for (var i = 0; i < 1000; i++)
+        {
+          'a': [
+            i,
+            {
+              'b': [i],
+              'c': <String, Object?>{},
+            },
+          ],
+        },
+    ]),
+  );
+}
+
+class NestedContainersRecursiveDecodingBenchmark
+    extends NestedContainersDecodingBenchmark {
+  NestedContainersRecursiveDecodingBenchmark() : super('Fleece (recursive)');
+
+  @override
+  void run() {
+    // ignore: deprecated_member_use
+    RecursiveFleeceDecoder(
+      trust: FLTrust.trusted,
+      sharedKeys: sharedKeys,
+      sharedKeysTable: sharedKeysTable,
+    ).convert(data);
+  }
+}
+
+class NestedContainersListenerDecodingBenchmark
+    extends NestedContainersDecodingBenchmark {
+  NestedContainersListenerDecodingBenchmark() : super('Fleece (listener)');
+
+  @override
+  void run() {
+    // ignore: deprecated_member_use
+    ListenerFleeceDecoder(
+      trust: FLTrust.trusted,
+      sharedKeys: sharedKeys,
+      sharedKeysTable: sharedKeysTable,
+    ).convert(data);
+  }
+}
+
 Future<void> main() async {
   setupTestBinding();
 
@@ -103,7 +176,10 @@ Future<void> main() async {
       JsonInDartDecodingBenchmark(),
       FleeceRecursiveDecodingBenchmark(),
       FleeceListenerDecodingBenchmark(),
+      FleeceTapeDecodingBenchmark(),
       FleeceWrapperDecodingBenchmark(),
+      NestedContainersRecursiveDecodingBenchmark(),
+      NestedContainersListenerDecodingBenchmark(),
     ]);
   }
 
@@ -114,7 +190,10 @@ Future<void> main() async {
       JsonInDartDecodingBenchmark(),
       FleeceRecursiveDecodingBenchmark(),
       FleeceListenerDecodingBenchmark(),
+      FleeceTapeDecodingBenchmark(),
       FleeceWrapperDecodingBenchmark(),
+      NestedContainersRecursiveDecodingBenchmark(),
+      NestedContainersListenerDecodingBenchmark(),
     ]);
     debugger();
   }
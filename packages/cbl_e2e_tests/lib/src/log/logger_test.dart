@@ -40,6 +40,37 @@ void main() {
       cblLogMessage(LogDomain.network, LogLevel.warning, 'A');
     });
 
+    test('filters log messages by domain', () async {
+      final messages = <String>[];
+      final receivedMessages = Completer<void>();
+
+      final logger = Database.log.custom = TestLogger((level, domain, message) {
+        messages.add('${domain.name}: $message');
+        if (message == 'done') {
+          receivedMessages.complete();
+        }
+      }, level: LogLevel.error)
+        ..setDomainLevel(LogDomain.query, LogLevel.info);
+
+      expect(logger.levelForDomain(LogDomain.query), LogLevel.info);
+      expect(logger.levelForDomain(LogDomain.network), LogLevel.error);
+
+      // Wont be logged because its under the level of the domain.
+      cblLogMessage(LogDomain.network, LogLevel.info, 'A');
+      // Will be logged because the domain has a lower level.
+      cblLogMessage(LogDomain.query, LogLevel.info, 'B');
+
+      logger.setDomainLevel(LogDomain.query, null);
+      expect(logger.levelForDomain(LogDomain.query), LogLevel.error);
+
+      // Wont be logged after the level of the domain has been removed.
+      cblLogMessage(LogDomain.query, LogLevel.info, 'C');
+      cblLogMessage(LogDomain.network, LogLevel.error, 'done');
+
+      await receivedMessages.future;
+      expect(messages, ['query: B', 'network: done']);
+    });
+
     test('remove logger', () async {
       final receivedMessage = Completer<void>();
 
@@ -60,6 +91,29 @@ void main() {
       cblLogMessage(LogDomain.network, LogLevel.warning, 'A');
     });
 
+    test('delivers batches of log messages in order', () async {
+      final messages = <String>[];
+      final receivedMessages = Completer<void>();
+
+      Database.log.custom = TestLogger((level, domain, message) {
+        // Ignore messages which are logged by CBL itself.
+        if (int.tryParse(message) == null) {
+          return;
+        }
+        messages.add(message);
+        if (messages.length == 1000) {
+          receivedMessages.complete();
+        }
+      }, level: LogLevel.info);
+
+      for (var i = 0; i < 1000; i++) {
+        cblLogMessage(LogDomain.network, LogLevel.info, '$i');
+      }
+
+      await receivedMessages.future;
+      expect(messages, [for (var i = 0; i < 1000; i++) '$i']);
+    });
+
     group('StreamLogger', () {
       test('emits log messages', () {
         final logger = Database.log.custom = StreamLogger(LogLevel.warning);
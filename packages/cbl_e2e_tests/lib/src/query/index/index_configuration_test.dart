@@ -158,4 +158,102 @@ void main() {
       );
     });
   });
+  group('ArrayIndexConfiguration', () {
+    test('throws when path is empty', () {
+      expect(() => ArrayIndexConfiguration(''), throwsArgumentError);
+      expect(
+        () => ArrayIndexConfiguration('a').path = '',
+        throwsArgumentError,
+      );
+    });
+
+    test('==', () {
+      ArrayIndexConfiguration a;
+      ArrayIndexConfiguration b;
+
+      a = ArrayIndexConfiguration('a', expressions: ['b']);
+      expect(a, a);
+
+      b = ArrayIndexConfiguration('a', expressions: ['b']);
+      expect(a, b);
+
+      b = ArrayIndexConfiguration('a');
+      expect(a, isNot(b));
+    });
+
+    test('toString', () {
+      expect(
+        ArrayIndexConfiguration('a').toString(),
+        'ArrayIndexConfiguration(a)',
+      );
+      expect(
+        ArrayIndexConfiguration('a', expressions: ['b', 'c']).toString(),
+        'ArrayIndexConfiguration(a | b, c)',
+      );
+    });
+  });
+
+  group('VectorIndexConfiguration', () {
+    test('default values', () {
+      final index = VectorIndexConfiguration(
+        'vector',
+        dimensions: 3,
+        centroids: 8,
+      );
+      expect(
+        index.encoding,
+        VectorEncoding.scalarQuantizer(ScalarQuantizerType.sq8),
+      );
+      expect(index.metric, DistanceMetric.euclideanSquared);
+      expect(index.minTrainingSize, isNull);
+      expect(index.maxTrainingSize, isNull);
+      expect(index.numProbes, isNull);
+    });
+
+    test('throws when dimensions or centroids are out of range', () {
+      expect(
+        () => VectorIndexConfiguration('v', dimensions: 1, centroids: 8),
+        throwsRangeError,
+      );
+      expect(
+        () => VectorIndexConfiguration('v', dimensions: 3, centroids: 0),
+        throwsRangeError,
+      );
+    });
+
+    test('==', () {
+      VectorIndexConfiguration a;
+      VectorIndexConfiguration b;
+
+      a = VectorIndexConfiguration('v', dimensions: 3, centroids: 8);
+      expect(a, a);
+
+      b = VectorIndexConfiguration('v', dimensions: 3, centroids: 8);
+      expect(a, b);
+
+      b = VectorIndexConfiguration(
+        'v',
+        dimensions: 3,
+        centroids: 8,
+        encoding: VectorEncoding.none(),
+      );
+      expect(a, isNot(b));
+    });
+
+    test('toString', () {
+      expect(
+        VectorIndexConfiguration(
+          'v',
+          dimensions: 4,
+          centroids: 8,
+          encoding: VectorEncoding.productQuantizer(subquantizers: 2, bits: 8),
+          metric: DistanceMetric.cosine,
+          numProbes: 2,
+        ).toString(),
+        'VectorIndexConfiguration(v | dimensions: 4, centroids: 8, '
+        'encoding: VectorEncoding.productQuantizer(subquantizers: 2, bits: 8), '
+        'metric: cosine, numProbes: 2)',
+      );
+    });
+  });
 }
@@ -0,0 +1,72 @@
+import 'package:cbl/cbl.dart';
+
+import '../../test_binding_impl.dart';
+import '../test_binding.dart';
+import '../utils/database_utils.dart';
+
+void main() {
+  setupTestBinding();
+
+  group('QueryCache', () {
+    test('counts prepared queries which are not in the cache', () {
+      final db = openSyncTestDatabase();
+      final misses = QueryCache.stats.misses;
+
+      // Both queries are in use at the same time and so cannot share a
+      // prepared query.
+      final a = db.createQuery('SELECT a FROM _')..explain();
+      final b = db.createQuery('SELECT a FROM _')..explain();
+
+      expect(QueryCache.stats.misses, misses + 2);
+      expect(a.explain(), b.explain());
+    });
+
+    test('counts prepared queries which are reused from the cache', () {
+      final capacity = QueryCache.capacity;
+      addTearDown(() => QueryCache.capacity = capacity);
+      QueryCache.capacity = 8;
+
+      final db = openSyncTestDatabase();
+      final collection = db.defaultCollection
+        ..createIndex('text', FullTextIndexConfiguration(['a']))
+        ..saveDocument(MutableDocument({'a': 'The quick brown fox.'}));
+
+      // A full-text search gives its prepared query back to the cache as soon
+      // as it is done, so that running the same search again reuses it.
+      expect(collection.fullTextSearch('text', 'fox'), hasLength(1));
+      final hits = QueryCache.stats.hits;
+      final misses = QueryCache.stats.misses;
+
+      expect(collection.fullTextSearch('text', 'fox'), hasLength(1));
+      expect(QueryCache.stats.hits, hits + 1);
+      expect(QueryCache.stats.misses, misses);
+    });
+
+    test('set capacity', () {
+      final capacity = QueryCache.capacity;
+      addTearDown(() => QueryCache.capacity = capacity);
+
+      QueryCache.capacity = 0;
+      expect(QueryCache.capacity, 0);
+      expect(QueryCache.stats.size, 0);
+
+      QueryCache.capacity = 8;
+      expect(QueryCache.capacity, 8);
+    });
+
+    test('throws when capacity is negative', () {
+      expect(() => QueryCache.capacity = -1, throwsRangeError);
+    });
+
+    test('queries work with the cache disabled', () {
+      final capacity = QueryCache.capacity;
+      addTearDown(() => QueryCache.capacity = capacity);
+      QueryCache.capacity = 0;
+
+      final db = openSyncTestDatabase()
+        ..saveDocument(MutableDocument({'a': 1}));
+      final q = db.createQuery('SELECT a FROM _');
+      expect(q.execute().single.integer('a'), 1);
+    });
+  });
+}
@@ -0,0 +1,68 @@
+import 'package:cbl/cbl.dart';
+
+import '../../test_binding_impl.dart';
+import '../test_binding.dart';
+import '../utils/database_utils.dart';
+
+void main() {
+  setupTestBinding();
+
+  group('QueryInstrumentation', () {
+    setUp(() {
+      QueryInstrumentation.enabled = true;
+      addTearDown(() {
+        QueryInstrumentation.enabled = false;
+        QueryInstrumentation.onFullScan = null;
+        QueryInstrumentation.reset();
+      });
+    });
+
+    test('records executions and rows', () {
+      final db = openSyncTestDatabase();
+      db.defaultCollection
+        ..saveDocument(MutableDocument({'a': 0}))
+        ..saveDocument(MutableDocument({'a': 1}));
+
+      final q = db.createQuery('SELECT a FROM _');
+      q.execute().allResults();
+      q.execute().allResults();
+
+      final stats = QueryInstrumentation.stats.single;
+      expect(stats.databaseName, db.name);
+      expect(stats.query, 'SELECT a FROM _');
+      expect(stats.plan, q.explain());
+      expect(stats.executionCount, 2);
+      expect(stats.rowCount, 4);
+    });
+
+    test('detects full scans', () {
+      final db = openSyncTestDatabase();
+      final fullScans = <QueryStats>[];
+      QueryInstrumentation.onFullScan = fullScans.add;
+
+      db.createQuery('SELECT a FROM _ WHERE a = 1').execute();
+
+      expect(fullScans, hasLength(1));
+      expect(fullScans.single.usesFullScan, isTrue);
+      expect(fullScans.single.fullScans, ['SCAN _']);
+    });
+
+    test('does not report queries which use an index', () {
+      final db = openSyncTestDatabase();
+      db.defaultCollection.createIndex('a', ValueIndexConfiguration(['a']));
+
+      db.createQuery('SELECT a FROM _ WHERE a = 1').execute();
+
+      expect(QueryInstrumentation.stats.single.usesFullScan, isFalse);
+    });
+
+    test('does not instrument queries while disabled', () {
+      QueryInstrumentation.enabled = false;
+      final db = openSyncTestDatabase();
+
+      db.createQuery('SELECT a FROM _').execute();
+
+      expect(QueryInstrumentation.stats, isEmpty);
+    });
+  });
+}
@@ -2,6 +2,7 @@
 // ignore_for_file: deprecated_member_use
 
 import 'dart:async';
+import 'dart:convert';
 
 import 'package:cbl/cbl.dart';
 import 'package:cbl/src/typed_data_internal.dart';
@@ -63,6 +64,228 @@ void main() {
       );
     });
 
+    apiTest('stream result set as JSON', () async {
+      final db = await openTestDatabase();
+      await db.saveDocument(MutableDocument({'a': 0, 'b': 'ü'}));
+      await db.saveDocument(MutableDocument({'a': 1}));
+
+      final q = await db.createQuery('SELECT a, b FROM _ ORDER BY a');
+      final resultSet = await q.execute();
+      final json = await utf8.decodeStream(resultSet.asJsonStream());
+
+      expect(jsonDecode(json), [
+        {'a': 0, 'b': 'ü'},
+        {'a': 1, 'b': null},
+      ]);
+    });
+
+    apiTest('iterate result set with more rows than a batch', () async {
+      final db = await openTestDatabase();
+      await db.inBatch(() async {
+        for (var i = 0; i < 150; i++) {
+          await db.saveDocument(MutableDocument({'a': i}));
+        }
+      });
+
+      final q = await db.createQuery('SELECT a FROM _ ORDER BY a');
+      final resultSet = await q.execute();
+
+      expect(
+        (await resultSet.allResults()).map((result) => result.integer('a')),
+        List.generate(150, (i) => i),
+      );
+    });
+
+    test('execute query on native thread pool', () async {
+      final db = openSyncTestDatabase();
+      db.inBatchSync(() {
+        for (var i = 0; i < 150; i++) {
+          db.saveDocument(MutableDocument({'a': i}));
+        }
+      });
+
+      final q = db.createQuery('SELECT a FROM _ ORDER BY a');
+      final resultSet = q.executeAsync();
+
+      expect(
+        (await resultSet.allResults()).map((result) => result.integer('a')),
+        List.generate(150, (i) => i),
+      );
+      expect(resultSet.allResults, throwsStateError);
+    });
+
+    test('execute query on native thread pool with current parameters',
+        () async {
+      final db = openSyncTestDatabase()
+        ..saveDocument(MutableDocument({'a': 1}))
+        ..saveDocument(MutableDocument({'a': 2}));
+
+      final q = db.createQuery(r'SELECT a FROM _ WHERE a = $a')
+        ..setParameters(Parameters({'a': 1}));
+      final resultSet = q.executeAsync();
+      q.setParameters(Parameters({'a': 2}));
+
+      expect(
+        (await resultSet.allResults()).map((result) => result.integer('a')),
+        [1],
+      );
+    });
+
+    test('cancel consuming results of query on native thread pool', () async {
+      final db = openSyncTestDatabase();
+      db.inBatchSync(() {
+        for (var i = 0; i < 500; i++) {
+          db.saveDocument(MutableDocument({'a': i}));
+        }
+      });
+
+      final q = db.createQuery('SELECT a FROM _ ORDER BY a');
+
+      expect(
+        await q
+            .executeAsync()
+            .asStream()
+            .asyncMap((result) async {
+              await Future<void>.delayed(Duration.zero);
+              return result.integer('a');
+            })
+            .take(100)
+            .toList(),
+        List.generate(100, (i) => i),
+      );
+    });
+
+    test('stream partially iterated result set as JSON', () async {
+      final db = openSyncTestDatabase();
+      for (var i = 0; i < 3; i++) {
+        db.saveDocument(MutableDocument({'a': i}));
+      }
+
+      final q = db.createQuery('SELECT a FROM _ ORDER BY a');
+      final resultSet = q.execute();
+      final iterator = resultSet.iterator..moveNext();
+      expect(iterator.current.integer('a'), 0);
+
+      final json = await utf8.decodeStream(resultSet.asJsonStream());
+      expect(jsonDecode(json), [
+        {'a': 1},
+        {'a': 2},
+      ]);
+    });
+
+    apiTest('stream empty result set as JSON', () async {
+      final db = await openTestDatabase();
+
+      final q = await db.createQuery('SELECT a FROM _');
+      final resultSet = await q.execute();
+
+      expect(await utf8.decodeStream(resultSet.asJsonStream()), '[]');
+    });
+
+    test('extract result set columns into typed data', () {
+      final db = openSyncTestDatabase();
+      for (var i = 0; i < 100; i++) {
+        db.saveDocument(MutableDocument({'a': i, 'b': i / 2, 'c': 'c$i'}));
+      }
+      db.saveDocument(MutableDocument({'a': 100, 'b': 'x', 'c': 1}));
+
+      final q = db.createQuery('SELECT a, b, c FROM _ ORDER BY a');
+      final columnar = q.execute().toColumnar({
+        'a': ColumnarType.int64,
+        1: ColumnarType.float64,
+        'c': ColumnarType.string,
+      });
+
+      expect(columnar.length, 101);
+      expect(columnar.columnNames, ['a', 'b', 'c']);
+
+      final a = columnar['a'] as Int64ResultColumn;
+      expect(a.values, List.generate(101, (i) => i));
+      expect(a.isNull(100), isFalse);
+
+      final b = columnar['b'] as Float64ResultColumn;
+      expect(b.values.take(100), List.generate(100, (i) => i / 2));
+      expect(b[99], 49.5);
+      expect(b.isNull(100), isTrue);
+      expect(b[100], isNull);
+
+      final c = columnar[2] as StringResultColumn;
+      expect(c.offsets, hasLength(102));
+      expect(c[0], 'c0');
+      expect(c[99], 'c99');
+      expect(c[100], isNull);
+    });
+
+    test('extract columns of partially iterated result set', () {
+      final db = openSyncTestDatabase();
+      for (var i = 0; i < 3; i++) {
+        db.saveDocument(MutableDocument({'a': i}));
+      }
+
+      final q = db.createQuery('SELECT a FROM _ ORDER BY a');
+      final resultSet = q.execute();
+      final iterator = resultSet.iterator..moveNext();
+      expect(iterator.current.integer('a'), 0);
+
+      final columnar = resultSet.toColumnar({'a': ColumnarType.int64});
+      expect(columnar.length, 2);
+      expect((columnar['a'] as Int64ResultColumn).values, [1, 2]);
+      expect(resultSet.moveNext(), isFalse);
+    });
+
+    test('extract columns of empty result set', () {
+      final db = openSyncTestDatabase();
+
+      final q = db.createQuery('SELECT a FROM _');
+      final columnar = q.execute().toColumnar({'a': ColumnarType.string});
+
+      expect(columnar.length, 0);
+      expect((columnar['a'] as StringResultColumn).offsets, [0]);
+    });
+
+    test('extract unknown result set column', () {
+      final db = openSyncTestDatabase();
+
+      final q = db.createQuery('SELECT a FROM _');
+      expect(
+        () => q.execute().toColumnar({'b': ColumnarType.int64}),
+        throwsRangeError,
+      );
+    });
+
+    test('execute query with documents', () {
+      final db = openSyncTestDatabase();
+      final collection = db.defaultCollection;
+      for (var i = 0; i < 100; i++) {
+        collection.saveDocument(MutableDocument.withId('$i', {'a': i}));
+      }
+
+      final q = db.createQuery(
+        'SELECT META().id, a FROM _ WHERE a < 70 ORDER BY a',
+      );
+      final results = q.executeWithDocuments(collection).allResults();
+
+      expect(results, hasLength(70));
+      for (final (i, result) in results.indexed) {
+        expect(result.document!.id, '$i');
+        expect(result.document!.integer('a'), i);
+        expect(result.document!.collection, collection);
+      }
+
+      // Rows without a document id have no document.
+      final emptyResults = db
+          .createQuery('SELECT a FROM _ WHERE a = 0')
+          .executeWithDocuments(collection, idColumn: 0)
+          .allResults();
+      expect(emptyResults.single.document, isNull);
+
+      expect(() => q.execute().first.document, throwsStateError);
+      expect(
+        () => q.executeWithDocuments(collection, idColumn: 'b'),
+        throwsRangeError,
+      );
+    });
+
     apiTest('execute query with parameters', () async {
       final db = await openTestDatabase();
       final q =
@@ -200,6 +423,61 @@ SELECT fl_result(fl_value(_.body, 'doc')) FROM kv_default AS _ WHERE (_.flags &
       );
     });
 
+    apiTest('change stream with minInterval throttles changes', () async {
+      final db = await openTestDatabase();
+      final query = await db.createQuery('SELECT META().id FROM _');
+      const minInterval = Duration(milliseconds: 300);
+      final stopwatch = Stopwatch()..start();
+      final changeTimes = <Duration>[];
+
+      await query
+          .changes(minInterval: minInterval)
+          .take(3)
+          .asyncMap((change) async {
+        changeTimes.add(stopwatch.elapsed);
+        await db.saveDocument(MutableDocument());
+      }).drain<void>();
+
+      for (var i = 1; i < changeTimes.length; i++) {
+        expect(
+          changeTimes[i] - changeTimes[i - 1],
+          greaterThanOrEqualTo(minInterval - const Duration(milliseconds: 50)),
+        );
+      }
+    });
+
+    test('paused change stream delivers latest results when resumed', () async {
+      final db = openSyncTestDatabase();
+      final query = db.createQuery('SELECT META().id FROM _');
+      final changes = <List<String?>>[];
+      final firstChange = Completer<void>();
+      final nextChange = Completer<void>();
+
+      final subscription = query.changes().listen((change) {
+        changes.add([
+          for (final result in change.results.allResults()) result.string(0),
+        ]);
+        if (!firstChange.isCompleted) {
+          firstChange.complete();
+        } else if (!nextChange.isCompleted) {
+          nextChange.complete();
+        }
+      });
+      addTearDown(subscription.cancel);
+
+      await firstChange.future;
+      subscription.pause();
+      db
+        ..saveDocument(MutableDocument.withId('A'))
+        ..saveDocument(MutableDocument.withId('B'));
+      await Future<void>.delayed(const Duration(milliseconds: 500));
+      expect(changes, [isEmpty]);
+
+      subscription.resume();
+      await nextChange.future;
+      expect(changes.last, unorderedEquals(['A', 'B']));
+    });
+
     apiTest('listen to change stream of query created by builder', () async {
       // https://github.com/cbl-dart/cbl-dart/issues/225
       final db = await openTestDatabase();
@@ -213,6 +491,117 @@ SELECT fl_result(fl_value(_.body, 'doc')) FROM kv_default AS _ WHERE (_.flags &
       );
     });
 
+    test('diff stream emits differences between results', () {
+      final db = openSyncTestDatabase();
+      final query = db.createQuery(
+        'SELECT META().id, n FROM _ ORDER BY n',
+      );
+      final a = MutableDocument.withId('A', {'n': 1});
+      final b = MutableDocument.withId('B', {'n': 2});
+      var diffIndex = 0;
+
+      expect(
+        query.diffs(key: 'id').doOnData((_) {
+          switch (diffIndex++) {
+            case 0:
+              db.inBatchSync(() {
+                db
+                  ..saveDocument(a)
+                  ..saveDocument(b);
+              });
+            case 1:
+              db.saveDocument(a..setValue(3, key: 'n'));
+            case 2:
+              db.deleteDocument(b);
+          }
+        }).map((diff) => {
+              'length': diff.length,
+              'removed': diff.removed,
+              'inserted': diff.inserted,
+              'moved': diff.moved,
+              'changed': diff.changed,
+              'rows': {
+                for (final MapEntry(:key, :value) in diff.rows.entries)
+                  key: value.toPlainList(),
+              },
+            }),
+        emitsInOrder(<Object>[
+          {
+            'length': 0,
+            'removed': isEmpty,
+            'inserted': isEmpty,
+            'moved': isEmpty,
+            'changed': isEmpty,
+            'rows': isEmpty,
+          },
+          {
+            'length': 2,
+            'removed': isEmpty,
+            'inserted': [0, 1],
+            'moved': isEmpty,
+            'changed': isEmpty,
+            'rows': {
+              0: ['A', 1],
+              1: ['B', 2],
+            },
+          },
+          {
+            'length': 2,
+            'removed': isEmpty,
+            'inserted': isEmpty,
+            'moved': [(from: 1, to: 0)],
+            'changed': [1],
+            'rows': {
+              1: ['A', 3],
+            },
+          },
+          {
+            'length': 1,
+            'removed': [0],
+            'inserted': isEmpty,
+            'moved': isEmpty,
+            'changed': isEmpty,
+            'rows': isEmpty,
+          },
+        ]),
+      );
+    });
+
+    test('apply diffs to previous results', () async {
+      final db = openSyncTestDatabase();
+      for (var i = 0; i < 10; i++) {
+        db.saveDocument(MutableDocument.withId('$i', {'n': i}));
+      }
+      final query = db.createQuery(
+        'SELECT META().id, n FROM _ ORDER BY n',
+      );
+
+      var results = <Result>[];
+      var diffIndex = 0;
+      await for (final diff in query.diffs(key: 0)) {
+        results = diff.applyTo(results);
+        expect(
+          results.map((result) => result.toPlainList()),
+          query.execute().map((result) => result.toPlainList()),
+        );
+
+        if (diffIndex++ == 2) {
+          break;
+        }
+        db.inBatchSync(() {
+          db
+            ..saveDocument(
+              db.document('3')!.toMutable()
+                ..setValue(20 + diffIndex, key: 'n'),
+            )
+            ..deleteDocument(db.document('${diffIndex + 5}')!)
+            ..saveDocument(
+              MutableDocument.withId('x$diffIndex', {'n': -diffIndex}),
+            );
+        });
+      }
+    });
+
     apiTest('bad query: error position highlighting', () async {
       final db = await openTestDatabase();
       expect(
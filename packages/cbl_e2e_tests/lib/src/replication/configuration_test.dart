@@ -41,6 +41,9 @@ void main() {
       expect(config.heartbeat, isNull);
       expect(config.maxAttempts, isNull);
       expect(config.maxAttemptWaitTime, isNull);
+      expect(config.callbackDeadline, isNull);
+      expect(config.callbackDeadlineFilterResult, isFalse);
+      expect(config.callbackLatencyBudget, isNull);
     });
 
     test('set validated properties', () {
@@ -67,6 +70,17 @@ void main() {
         () => config.maxAttemptWaitTime = Duration.zero,
         throwsRangeError,
       );
+
+      config.callbackDeadline = const Duration(milliseconds: 1);
+      expect(config.callbackDeadline, const Duration(milliseconds: 1));
+      expect(() => config.callbackDeadline = Duration.zero, throwsRangeError);
+
+      config.callbackLatencyBudget = const Duration(milliseconds: 1);
+      expect(config.callbackLatencyBudget, const Duration(milliseconds: 1));
+      expect(
+        () => config.callbackLatencyBudget = Duration.zero,
+        throwsRangeError,
+      );
     });
 
     test('from', () {
@@ -91,6 +105,9 @@ void main() {
         heartbeat: const Duration(seconds: 1),
         maxAttempts: 1,
         maxAttemptWaitTime: const Duration(seconds: 1),
+        callbackDeadline: const Duration(milliseconds: 100),
+        callbackDeadlineFilterResult: true,
+        callbackLatencyBudget: const Duration(milliseconds: 10),
       );
 
       final copy = ReplicatorConfiguration.from(source);
@@ -115,6 +132,12 @@ void main() {
       expect(copy.heartbeat, source.heartbeat);
       expect(copy.maxAttempts, source.maxAttempts);
       expect(copy.maxAttemptWaitTime, source.maxAttemptWaitTime);
+      expect(copy.callbackDeadline, source.callbackDeadline);
+      expect(
+        copy.callbackDeadlineFilterResult,
+        source.callbackDeadlineFilterResult,
+      );
+      expect(copy.callbackLatencyBudget, source.callbackLatencyBudget);
     });
 
     test('toString', () {
@@ -155,6 +178,9 @@ void main() {
         heartbeat: const Duration(seconds: 1),
         maxAttempts: 1,
         maxAttemptWaitTime: const Duration(seconds: 1),
+        callbackDeadline: const Duration(milliseconds: 100),
+        callbackDeadlineFilterResult: true,
+        callbackLatencyBudget: const Duration(milliseconds: 10),
       );
 
       expect(
@@ -180,8 +206,11 @@ void main() {
         'DISABLE-AUTO-PURGE, '
         'heartbeat: 1s, '
         'maxAttempts: 1, '
+        'maxAttemptWaitTime: 1s, '
+        'callbackDeadline: 100ms, '
+        'ACCEPT-AFTER-DEADLINE, '
         // ignore: missing_whitespace_between_adjacent_strings
-        'maxAttemptWaitTime: 1s'
+        'callbackLatencyBudget: 10ms'
         ')',
       );
     });
@@ -5,6 +5,8 @@ import 'dart:async';
 import 'dart:typed_data';
 
 import 'package:cbl/cbl.dart';
+import 'package:cbl/src/bindings.dart';
+import 'package:cbl/src/database/ffi_database.dart';
 import 'package:cbl/src/typed_data_internal.dart';
 
 import '../../test_binding_impl.dart';
@@ -257,6 +259,74 @@ void main() {
       expect(idsInPullDb, isNot(contains(docB.id)));
     });
 
+    apiTest('use pushFilterExpression to filter pushed documents', () async {
+      final pushDb = await openTestDatabase(name: 'Push');
+      final pullDb = await openTestDatabase(name: 'Pull');
+
+      final docA = MutableDocument({
+        'type': 'order',
+        'tags': ['a', 'urgent-1'],
+      });
+      await pushDb.saveDocument(docA);
+      final docB = MutableDocument({
+        'type': 'order',
+        'tags': ['b'],
+      });
+      await pushDb.saveDocument(docB);
+      final docC = MutableDocument({'type': 'invoice'});
+      await pushDb.saveDocument(docC);
+
+      final tag = ArrayExpression.variable('tag');
+      final pusher = await Replicator.create(ReplicatorConfiguration(
+        target: UrlEndpoint(syncGatewayReplicationUrl),
+        replicatorType: ReplicatorType.push,
+        authenticator: janeAuthenticator,
+      )..addCollection(
+          await pushDb.defaultCollection,
+          CollectionConfiguration(
+            pushFilterExpression: Expression.property('type')
+                .equalTo(Expression.string('order'))
+                .and(ArrayExpression.any(tag)
+                    .in_(Expression.property('tags'))
+                    .satisfies(tag.like(Expression.string('urgent-%')))),
+          ),
+        ));
+      await pusher.replicateOneShot();
+
+      final puller = await pullDb.createTestReplicator(
+        replicatorType: ReplicatorType.pull,
+      );
+      await puller.replicateOneShot();
+
+      final idsInPullDb = await pullDb.getAllIds();
+      expect(idsInPullDb, contains(docA.id));
+      expect(idsInPullDb, isNot(contains(docB.id)));
+      expect(idsInPullDb, isNot(contains(docC.id)));
+    });
+
+    apiTest('throws for unsupported filter expression', () async {
+      final db = await openTestDatabase();
+
+      final config = ReplicatorConfiguration(
+        target: UrlEndpoint(syncGatewayReplicationUrl),
+      )..addCollection(
+          await db.defaultCollection,
+          CollectionConfiguration(
+            pullFilterExpression: Function_.lower(Expression.property('type'))
+                .equalTo(Expression.string('order')),
+          ),
+        );
+
+      expect(
+        () => Replicator.create(config),
+        throwsA(isA<DatabaseException>().having(
+          (exception) => exception.code,
+          'code',
+          DatabaseErrorCode.invalidQuery,
+        )),
+      );
+    });
+
     apiTest('use typedPushFilter to filter pushed documents', () async {
       final pushDb = await openTestDatabase(
         name: 'Push',
@@ -361,6 +431,38 @@ void main() {
       expect(idsInPullDb, isNot(contains(docB.id)));
     });
 
+    apiTest('pullFilter decides for each document of a batch', () async {
+      final pushDb = await openTestDatabase(name: 'Push');
+      final pullDb = await openTestDatabase(name: 'Pull');
+
+      final docs = [
+        for (var i = 0; i < 100; i++) MutableDocument({'i': i}),
+      ];
+      for (final doc in docs) {
+        await pushDb.saveDocument(doc);
+      }
+
+      final pusher = await pushDb.createTestReplicator(
+        replicatorType: ReplicatorType.push,
+      );
+      await pusher.replicateOneShot();
+
+      final puller = await pullDb.createTestReplicator(
+        replicatorType: ReplicatorType.pull,
+        pullFilter: (document, flags) => document.integer('i').isEven,
+      );
+      await puller.replicateOneShot();
+
+      final idsInPullDb = await pullDb.getAllIds();
+      for (final doc in docs) {
+        expect(
+          idsInPullDb.contains(doc.id),
+          doc.integer('i').isEven,
+          reason: 'document ${doc.integer('i')}',
+        );
+      }
+    });
+
     apiTest('use typedPullFilter to filter pulled documents', () async {
       final pushDb = await openTestDatabase(
         name: 'Push',
@@ -503,6 +605,95 @@ void main() {
     //   expect(testDocument!.value('merged'), isTrue);
     // });
 
+    group('BuiltInConflictResolver', () {
+      Future<Replicator> createReplicator(
+        Database db,
+        ConflictResolver conflictResolver,
+      ) async =>
+          Replicator.create(ReplicatorConfiguration(
+            target: UrlEndpoint(syncGatewayReplicationUrl),
+            authenticator: janeAuthenticator,
+          )..addCollection(
+              await db.defaultCollection,
+              CollectionConfiguration(conflictResolver: conflictResolver),
+            ));
+
+      /// Creates a conflict in db A, between the properties [local] from db A
+      /// and [remote] from db B and returns the resolved document.
+      Future<Document?> resolveConflict(
+        ConflictResolver conflictResolver, {
+        required Map<String, Object?> local,
+        required Map<String, Object?> remote,
+      }) async {
+        final dbA = await openTestDatabase(name: 'A');
+        final collectionA = await dbA.defaultCollection;
+        final replicatorA = await createReplicator(dbA, conflictResolver);
+
+        final dbB = await openTestDatabase(name: 'B');
+        final collectionB = await dbB.defaultCollection;
+        final replicatorB = await dbB.createTestReplicator();
+
+        final doc = MutableDocument({'value': 'initial'});
+        await collectionA.saveDocument(doc);
+        await replicatorA.replicateOneShot();
+        await replicatorB.replicateOneShot();
+
+        await collectionA.saveDocument(doc..setData(local));
+        final docB = (await collectionB.document(doc.id))!.toMutable();
+        await collectionB.saveDocument(docB..setData(remote));
+        await replicatorB.replicateOneShot();
+        await replicatorA.replicateOneShot();
+
+        return collectionA.document(doc.id);
+      }
+
+      apiTest('remoteWins', () async {
+        final resolved = await resolveConflict(
+          const BuiltInConflictResolver.remoteWins(),
+          local: {'value': 'A'},
+          remote: {'value': 'B'},
+        );
+
+        expect(resolved!.toPlainMap(), {'value': 'B'});
+      });
+
+      apiTest('localWins', () async {
+        final resolved = await resolveConflict(
+          const BuiltInConflictResolver.localWins(),
+          local: {'value': 'A'},
+          remote: {'value': 'B'},
+        );
+
+        expect(resolved!.toPlainMap(), {'value': 'A'});
+      });
+
+      apiTest('lastWriteWins', () async {
+        final resolved = await resolveConflict(
+          const BuiltInConflictResolver.lastWriteWins('meta.updatedAt'),
+          local: {
+            'value': 'A',
+            'meta': {'updatedAt': 2},
+          },
+          remote: {
+            'value': 'B',
+            'meta': {'updatedAt': 1},
+          },
+        );
+
+        expect(resolved!.value('value'), 'A');
+      });
+
+      apiTest('mergeDicts', () async {
+        final resolved = await resolveConflict(
+          const BuiltInConflictResolver.mergeDicts(),
+          local: {'a': 'A', 'b': 'A'},
+          remote: {'b': 'B', 'c': 'B'},
+        );
+
+        expect(resolved!.toPlainMap(), {'a': 'A', 'b': 'A', 'c': 'B'});
+      });
+    });
+
     apiTest('custom typed conflict resolver', () async {
       // Create document in db A
       // Sync db A with server
@@ -580,6 +771,59 @@ void main() {
       expect(status.progress.completed, 0);
     });
 
+    apiTest('metrics measures replication and callbacks', () async {
+      final db = await openTestDatabase();
+      await db.saveDocument(MutableDocument());
+      await db.saveDocument(MutableDocument());
+
+      final replicator = await db.createTestReplicator(
+        replicatorType: ReplicatorType.push,
+        pushFilter: (document, flags) => true,
+      );
+
+      var metrics = await replicator.metrics;
+      expect(metrics.documentsPushed, 0);
+      expect(metrics.pushFilter.count, 0);
+
+      await replicator.replicateOneShot();
+
+      metrics = await replicator.metrics;
+      expect(metrics.documentsPushed, 2);
+      expect(metrics.documentsPulled, 0);
+      expect(metrics.documentErrors, 0);
+      expect(metrics.pushFilter.count, 2);
+      expect(metrics.pushFilter.buckets.reduce((a, b) => a + b), 2);
+      expect(
+        metrics.pushFilter.max,
+        lessThanOrEqualTo(metrics.pushFilter.total),
+      );
+      expect(metrics.pullFilter.count, 0);
+      expect(metrics.conflictResolver.count, 0);
+      expect(metrics.callbacksOverBudget, 0);
+      expect(metrics.callbacksTimedOut, 0);
+    });
+
+    apiTest('filter which misses callbackDeadline uses fallback result',
+        () async {
+      final db = await openTestDatabase();
+      await db.saveDocument(MutableDocument());
+
+      final replicator = await db.createTestReplicator(
+        replicatorType: ReplicatorType.push,
+        pushFilter: (document, flags) async {
+          await Future<void>.delayed(const Duration(milliseconds: 200));
+          return true;
+        },
+        callbackDeadline: const Duration(milliseconds: 10),
+      );
+
+      await replicator.replicateOneShot();
+
+      final metrics = await replicator.metrics;
+      expect(metrics.callbacksTimedOut, 1);
+      expect(metrics.documentsPushed, 0);
+    });
+
     apiTest('change listener is notified while listening', () async {
       final db = await openTestDatabase();
       final replicator = await db.createTestReplicator();
@@ -640,6 +884,24 @@ void main() {
       await replicator.replicateOneShot();
     });
 
+    apiTest('throttled changes stream emits activity changes immediately',
+        () async {
+      final db = await openTestDatabase();
+      final replicator = await db.createTestReplicator();
+
+      expect(
+        replicator
+            .changes(minInterval: const Duration(seconds: 1))
+            .map((it) => it.status.activity),
+        emitsInOrder(<Object>[
+          emits(ReplicatorActivityLevel.busy),
+          emitsThrough(ReplicatorActivityLevel.stopped)
+        ]),
+      );
+
+      await replicator.replicateOneShot();
+    });
+
     apiTest('documentReplications emits document replications', () async {
       final db = await openTestDatabase();
       final replicator = await db.createTestReplicator();
@@ -667,6 +929,23 @@ void main() {
       await replicator.replicateOneShot();
     });
 
+    apiTest(
+      'document replication listener with errorsOnly ignores replicated '
+      'documents without errors',
+      () async {
+        final db = await openTestDatabase();
+        final replicator = await db.createTestReplicator();
+        await db.saveDocument(MutableDocument());
+
+        await replicator.addDocumentReplicationListener(
+          expectAsync1((_) {}, count: 0),
+          errorsOnly: true,
+        );
+
+        await replicator.replicateOneShot();
+      },
+    );
+
     apiTest(
       'pendingDocumentIds returns ids of documents waiting to be pushed',
       () async {
@@ -699,6 +978,145 @@ void main() {
       },
     );
 
+    apiTest(
+      'areDocumentsPendingInCollection returns whether documents are waiting '
+      'to be pushed',
+      () async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+        final replicator = await db.createTestReplicator();
+        final ids = <String>[];
+        for (var i = 0; i < 20; i++) {
+          final doc = MutableDocument();
+          await db.saveDocument(doc);
+          ids.add(doc.id);
+        }
+
+        // Small batches are checked document by document and large batches
+        // against all pending document ids.
+        expect(
+          await replicator.areDocumentsPendingInCollection(
+            [ids.first, 'x'],
+            collection,
+          ),
+          [true, false],
+        );
+        expect(
+          await replicator.areDocumentsPendingInCollection(
+            [...ids, 'x'],
+            collection,
+          ),
+          [...List.filled(20, true), false],
+        );
+      },
+    );
+
+    apiTest(
+      'pendingDocumentCountInCollection returns the number of documents '
+      'waiting to be pushed',
+      () async {
+        final db = await openTestDatabase();
+        final collection = await db.defaultCollection;
+        final replicator = await db.createTestReplicator();
+        expect(
+          await replicator.pendingDocumentCountInCollection(collection),
+          0,
+        );
+
+        await db.saveDocument(MutableDocument());
+        await db.saveDocument(MutableDocument());
+        expect(
+          await replicator.pendingDocumentCountInCollection(collection),
+          2,
+        );
+      },
+    );
+
+    apiTest('scheduler starts scheduled replicators one at a time', () async {
+      ReplicatorScheduler.maxActive = 1;
+      addTearDown(() => ReplicatorScheduler.maxActive = 0);
+
+      final db = await openTestDatabase();
+      final first = await db.createTestReplicator();
+      final second = await db.createTestReplicator();
+
+      final events = <String>[];
+      final stopped = Completer<void>();
+      for (final (name, replicator) in [('first', first), ('second', second)]) {
+        var isStarted = false;
+        await replicator.addChangeListener((change) {
+          if (change.status.activity == ReplicatorActivityLevel.stopped) {
+            events.add('$name stopped');
+            if (events.length == 4) {
+              stopped.complete();
+            }
+          } else if (!isStarted) {
+            isStarted = true;
+            events.add('$name started');
+          }
+        });
+      }
+
+      await first.schedule();
+      await second.schedule();
+      await stopped.future;
+
+      expect(events, [
+        'first started',
+        'first stopped',
+        'second started',
+        'second stopped',
+      ]);
+      expect(ReplicatorScheduler.stats.active, 0);
+      expect(ReplicatorScheduler.stats.waiting, 0);
+    });
+
+    apiTest('stopping a waiting replicator removes it from the scheduler',
+        () async {
+      ReplicatorScheduler.maxActive = 1;
+      addTearDown(() => ReplicatorScheduler.maxActive = 0);
+
+      final db = await openTestDatabase();
+      final first = await db.createTestReplicator(continuous: true);
+      final second = await db.createTestReplicator();
+
+      await first.schedule();
+      // The lower priority keeps the first replicator from giving up its slot
+      // when it becomes idle.
+      await second.schedule(priority: -1);
+      await second.stop();
+
+      expect((await second.status).activity, ReplicatorActivityLevel.stopped);
+      expect(ReplicatorScheduler.stats.waiting, 0);
+
+      await first.stop();
+    });
+
+    apiTest('raising the priority of a waiting replicator starts it',
+        () async {
+      ReplicatorScheduler.maxActive = 1;
+      addTearDown(() => ReplicatorScheduler.maxActive = 0);
+
+      final db = await openTestDatabase();
+      final first = await db.createTestReplicator(continuous: true);
+      final second = await db.createTestReplicator();
+
+      await first.driveToStatus(
+        hasActivityLevel(ReplicatorActivityLevel.idle),
+        first.schedule,
+      );
+      await second.schedule(priority: -1);
+      expect(ReplicatorScheduler.stats.waiting, 1);
+
+      // The idle first replicator now has to give up its slot.
+      await second.driveToStatus(
+        hasActivityLevel(ReplicatorActivityLevel.stopped),
+        second.schedule,
+      );
+
+      await first.stop();
+    });
+
     apiTest('start and stop', () async {
       final db = await openTestDatabase();
       final repl = await db.createTestReplicator(continuous: true);
@@ -788,6 +1206,39 @@ void main() {
       },
     );
 
+    test('releases replicator while it is stopping', () async {
+      final db = openSyncTestDatabase() as FfiDatabase;
+      final collection = db.defaultCollection as FfiCollection;
+      final bindings = cblBindings.replicator;
+      final endpoint =
+          bindings.createEndpointWithUrl(syncGatewayReplicationUrl.toString());
+      addTearDown(() => bindings.freeEndpoint(endpoint));
+
+      // The replicators are released at different points while they are
+      // stopping, some of which stop while they are being released.
+      for (var i = 0; i < 20; i++) {
+        final replicator =
+            bindings.createReplicator(CBLReplicatorConfiguration(
+          database: db.pointer,
+          endpoint: endpoint,
+          replicatorType: CBLReplicatorType.pushAndPull,
+          continuous: true,
+          collections: [
+            CBLReplicationCollection(collection: collection.pointer),
+          ],
+        ));
+        bindings.start(replicator, resetCheckpoint: false);
+        await Future<void>.delayed(Duration(milliseconds: i));
+        bindings
+          ..stop(replicator)
+          ..release(replicator);
+      }
+
+      // Give the replicators time to stop and be released, before the
+      // database is closed.
+      await Future<void>.delayed(const Duration(seconds: 1));
+    });
+
     apiTest(
       'throws when starting a replicator from within a transaction',
       () async {
@@ -0,0 +1,56 @@
+import 'dart:typed_data';
+
+import 'package:cbl/src/bindings.dart';
+import 'package:cbl/src/service/serialization/binary_packet_codec.dart';
+import 'package:cbl/src/service/serialization/serialization_codec.dart';
+
+import '../../test_binding_impl.dart';
+import '../test_binding.dart';
+
+void main() {
+  setupTestBinding();
+
+  group('BinaryPacketCodec', () {
+    final codec = BinaryPacketCodec();
+
+    Packet roundTrip(Packet packet) =>
+        codec.decodePacket(codec.encodePacket(packet));
+
+    test('encodes and decodes JSON values', () {
+      final value = {
+        'null': null,
+        'bool': [true, false],
+        'int': [0, -1, 0x7FFFFFFF, -0x80000000, 0x100000001, -0x100000001],
+        'double': [.5, -1.25],
+        'string': ['', 'a', 'äöü', '😀' * 100],
+        'nested': {
+          'list': [<Object?>[], <String, Object?>{}],
+        },
+      };
+
+      expect(roundTrip(Packet(value, [])).value, value);
+    });
+
+    test('passes data through', () {
+      final packet = roundTrip(Packet('a', [
+        Uint8List.fromList([1, 2, 3]).toData(),
+        Uint8List(0).toData(),
+        Uint8List.fromList([4]).toData().toSliceResult().toData(),
+      ]));
+
+      expect(packet.value, 'a');
+      expect(packet.data.map((data) => data.toTypedList()), [
+        [1, 2, 3],
+        <int>[],
+        [4],
+      ]);
+    });
+
+    test('throws when value cannot be encoded', () {
+      expect(
+        () => codec.encodePacket(Packet(Object(), [])),
+        throwsArgumentError,
+      );
+    });
+  });
+}
@@ -45,6 +45,33 @@ void main() {
       );
     });
 
+    channelTest('calls made together return their own results', () async {
+      final channel = await openTestChannel();
+
+      final results = [
+        channel.call(EchoRequest('a')),
+        channel.call(ThrowTestError()),
+        channel.call(EchoRequest('b')),
+      ];
+
+      expect(results[0], completion('Input: a'));
+      expect(results[1], throwsA(const TestError('Oops')));
+      expect(results[2], completion('Input: b'));
+    });
+
+    channelTest('calls made together are sent in fewer packets', () async {
+      final sentPackets = <Object?>[];
+      final channel = await openTestChannel(sentPackets: sentPackets);
+
+      const callCount = 5;
+      final results = await Future.wait([
+        for (var i = 0; i < callCount; i++) channel.call(EchoRequest('$i')),
+      ]);
+
+      expect(results, [for (var i = 0; i < callCount; i++) 'Input: $i']);
+      expect(sentPackets, hasLength(lessThan(callCount)));
+    });
+
     channelTest('call with data in request and response', () async {
       final channel = await openTestChannel();
 
@@ -194,7 +221,11 @@ final channelTransport = EnumVariant<ChannelTransport>(
 
 final serializationTarget = EnumVariant(SerializationTarget.values, order: 90);
 
-Future<Channel> openTestChannel() async {
+/// Opens a channel to a remote channel with the test handlers.
+///
+/// If [sentPackets] is provided, the packets which the returned channel sends
+/// to its transport are added to it.
+Future<Channel> openTestChannel({List<Object?>? sentPackets}) async {
   StreamChannel<Object?> localTransport;
 
   switch (channelTransport.value) {
@@ -241,6 +272,18 @@ Future<Channel> openTestChannel() async {
       break;
   }
 
+  if (sentPackets != null) {
+    localTransport = localTransport.changeSink((sink) {
+      final controller = StreamController<Object?>();
+      // ignore: unawaited_futures
+      controller.stream.map((packet) {
+        sentPackets.add(packet);
+        return packet;
+      }).pipe(sink);
+      return controller.sink;
+    });
+  }
+
   final local = Channel(
     transport: localTransport,
     packetCodec: packetCoded(serializationTarget.value),
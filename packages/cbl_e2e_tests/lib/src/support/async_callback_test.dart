@@ -28,5 +28,51 @@ void main() {
 
       bindings.callForTest(callback.pointer, 0);
     });
+
+    test('delivers calls in batches', () async {
+      final arguments = <int>[];
+      final allDelivered = Completer<void>();
+      final callback = AsyncCallback(
+        (args) {
+          arguments.add(args[0]! as int);
+          if (arguments.length == 10) {
+            allDelivered.complete();
+          }
+          return null;
+        },
+        debugName: 'Test',
+        maxBatchSize: 3,
+      );
+      addTearDown(callback.close);
+
+      for (var i = 0; i < 10; i++) {
+        bindings.callForTest(callback.pointer, i);
+      }
+
+      await allDelivered.future;
+      expect(arguments, unorderedEquals(List.generate(10, (i) => i)));
+    });
+
+    test('delivers calls while native timeline is enabled', () async {
+      final isEnabled = CBLBindings.instance.base.enableTimeline();
+      addTearDown(() {
+        if (isEnabled) {
+          CBLBindings.instance.base.disableTimeline();
+        }
+      });
+
+      final called = Completer<Object?>();
+      final callback = AsyncCallback(
+        (args) {
+          called.complete(args[0]);
+          return null;
+        },
+        debugName: 'Test',
+      );
+      addTearDown(callback.close);
+
+      bindings.callForTest(callback.pointer, 42);
+      expect(await called.future, 42);
+    });
   });
 }
@@ -0,0 +1,63 @@
+import 'dart:async';
+
+import 'package:cbl/cbl.dart';
+import 'package:cbl/src/bindings.dart';
+import 'package:cbl/src/support/async_callback.dart';
+
+import '../../test_binding_impl.dart';
+import '../test_binding.dart';
+import '../utils/database_utils.dart';
+
+void main() {
+  setupTestBinding();
+
+  group('NativeStats', () {
+    test('counts async callback calls', () async {
+      final called = Completer<void>();
+      final callback = AsyncCallback(
+        (_) {
+          called.complete();
+          return null;
+        },
+        debugName: 'Test',
+      );
+      addTearDown(callback.close);
+
+      final before = CouchbaseLite.nativeStats;
+      CBLBindings.instance.asyncCallback.callForTest(callback.pointer, 0);
+      await called.future;
+
+      final after = CouchbaseLite.nativeStats;
+      expect(
+        after.asyncCallbackCalls,
+        greaterThan(before.asyncCallbackCalls),
+      );
+    });
+
+    test('counts listener invocations', () async {
+      final db = openSyncTestDatabase();
+      final collection = db.defaultCollection;
+      final changed = Completer<void>();
+      final token = collection.addChangeListener((_) {
+        if (!changed.isCompleted) {
+          changed.complete();
+        }
+      });
+      addTearDown(() => collection.removeChangeListener(token));
+
+      final before = CouchbaseLite.nativeStats;
+      collection.saveDocument(MutableDocument());
+      await changed.future;
+
+      final after = CouchbaseLite.nativeStats;
+      expect(
+        after.listenerInvocations,
+        greaterThan(before.listenerInvocations),
+      );
+      expect(
+        after.asyncCallbackCalls,
+        greaterThan(before.asyncCallbackCalls),
+      );
+    });
+  });
+}
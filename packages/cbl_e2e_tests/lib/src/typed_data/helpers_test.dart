@@ -6,6 +6,7 @@ import 'package:cbl/src/typed_data/collection.dart';
 import '../../test_binding_impl.dart';
 import '../fixtures/values.dart';
 import '../test_binding.dart' hide TypeMatcher;
+import '../utils/database_utils.dart';
 import '../utils/matchers.dart';
 
 void main() {
@@ -97,6 +98,84 @@ void main() {
           ),
         );
       });
+      test('can read properties of saved document', () {
+        final db = openSyncTestDatabase();
+        final collection = db.defaultCollection;
+        collection.saveDocument(MutableDocument.withId('a', {
+          'string': 'a',
+          'int': 1,
+          'double': .5,
+          'bool': true,
+          'null': null,
+        }));
+        final doc = collection.document('a')!;
+
+        expect(
+          TypedDataHelpers.readProperty(
+            internal: doc,
+            name: 'string',
+            key: 'string',
+            converter: TypedDataHelpers.stringConverter,
+          ),
+          'a',
+        );
+        expect(
+          TypedDataHelpers.readProperty(
+            internal: doc,
+            name: 'int',
+            key: 'int',
+            converter: TypedDataHelpers.intConverter,
+          ),
+          1,
+        );
+        expect(
+          TypedDataHelpers.readProperty(
+            internal: doc,
+            name: 'double',
+            key: 'double',
+            converter: TypedDataHelpers.doubleConverter,
+          ),
+          .5,
+        );
+        expect(
+          TypedDataHelpers.readProperty(
+            internal: doc,
+            name: 'bool',
+            key: 'bool',
+            converter: TypedDataHelpers.boolConverter,
+          ),
+          isTrue,
+        );
+        expect(
+          TypedDataHelpers.readNullableProperty(
+            internal: doc,
+            name: 'null',
+            key: 'null',
+            converter: TypedDataHelpers.stringConverter,
+          ),
+          isNull,
+        );
+        expect(
+          () => TypedDataHelpers.readProperty(
+            internal: doc,
+            name: 'bool',
+            key: 'bool',
+            converter: TypedDataHelpers.stringConverter,
+          ),
+          throwsA(isTypedDataException),
+        );
+
+        final mutableDoc = doc.toMutable()..setString('b', key: 'string');
+        expect(
+          TypedDataHelpers.readProperty(
+            internal: mutableDoc,
+            name: 'string',
+            key: 'string',
+            converter: TypedDataHelpers.stringConverter,
+          ),
+          'b',
+        );
+      });
     });
 
     group('readNullableProperty', () {
@@ -168,6 +247,41 @@ void main() {
         );
         expect(dict.toPlainMap(), {'a': 'b'});
       });
+
+      test('can write properties of saved document', () {
+        final db = openSyncTestDatabase();
+        final collection = db.defaultCollection;
+        collection.saveDocument(
+          MutableDocument.withId('a', {'string': 'a', 'int': 1}),
+        );
+        final doc = collection.document('a')!.toMutable();
+
+        TypedDataHelpers.writeProperty(
+          internal: doc,
+          key: 'string',
+          value: 'a',
+          converter: TypedDataHelpers.stringConverter,
+        );
+        TypedDataHelpers.writeProperty(
+          internal: doc,
+          key: 'int',
+          value: 2,
+          converter: TypedDataHelpers.intConverter,
+        );
+        TypedDataHelpers.writeProperty(
+          internal: doc,
+          key: 'bool',
+          value: true,
+          converter: TypedDataHelpers.boolConverter,
+        );
+        expect(doc.toPlainMap(), {'string': 'a', 'int': 2, 'bool': true});
+
+        collection.saveDocument(doc);
+        expect(
+          collection.document('a')!.toPlainMap(),
+          {'string': 'a', 'int': 2, 'bool': true},
+        );
+      });
     });
 
     group('writeNullableProperty', () {
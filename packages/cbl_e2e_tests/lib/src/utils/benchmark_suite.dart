@@ -0,0 +1,318 @@
+// ignore_for_file: avoid_print
+
+import 'dart:async';
+import 'dart:convert';
+import 'dart:io';
+
+import 'package:collection/collection.dart';
+
+/// Configuration of the benchmark suite, which is read from the process
+/// environment.
+///
+/// Unless the suite is enabled through the `CBL_BENCHMARK_SUITE` environment
+/// variable or the `cblBenchmarkSuite` Dart environment variable, every
+/// benchmark only runs once with a small number of documents, so that the
+/// suite is exercised as part of the normal tests without slowing them down.
+///
+/// When the suite is enabled, these environment variables are used:
+///
+/// - `CBL_BENCHMARK_DOCUMENT_COUNTS`: Comma separated numbers of documents
+///   the database benchmarks are run with. The default is `10000,100000`.
+/// - `CBL_BENCHMARK_REPLICATION_DOCUMENT_COUNT`: The number of documents which
+///   are pushed and pulled. The default is `10000`.
+/// - `CBL_BENCHMARK_BLOB_SIZE`: The size in bytes of the blob whose stream
+///   throughput is measured. The default is `16777216` (16 MiB).
+/// - `CBL_BENCHMARK_REPETITIONS`: The number of times a measurement is
+///   repeated. The median is reported. The default is `5`.
+/// - `CBL_BENCHMARK_RESULTS`: The path of the file the results are written
+///   to, as JSON.
+/// - `CBL_BENCHMARK_BASELINE`: The path of a results file of a previous run,
+///   which the results are compared with.
+/// - `CBL_BENCHMARK_TOLERANCE`: The relative change of a result, compared
+///   with the baseline, which is considered a regression. The default is
+///   `0.1`.
+///
+/// With a baseline, the suite fails if a result has regressed.
+final class BenchmarkSuiteConfig {
+  BenchmarkSuiteConfig._({
+    required this.isEnabled,
+    required this.documentCounts,
+    required this.replicationDocumentCount,
+    required this.blobSize,
+    required this.repetitions,
+    required this.resultsPath,
+    required this.baselinePath,
+    required this.tolerance,
+  });
+
+  factory BenchmarkSuiteConfig.fromEnvironment() {
+    final environment = Platform.environment;
+    final isEnabled = (environment['CBL_BENCHMARK_SUITE'] != null &&
+            environment['CBL_BENCHMARK_SUITE'] != 'false') ||
+        // ignore: do_not_use_environment
+        const bool.fromEnvironment('cblBenchmarkSuite');
+
+    if (!isEnabled) {
+      return BenchmarkSuiteConfig._(
+        isEnabled: false,
+        documentCounts: [100],
+        replicationDocumentCount: 100,
+        blobSize: 256 * 1024,
+        repetitions: 1,
+        resultsPath: null,
+        baselinePath: null,
+        tolerance: 0.1,
+      );
+    }
+
+    return BenchmarkSuiteConfig._(
+      isEnabled: true,
+      documentCounts: environment['CBL_BENCHMARK_DOCUMENT_COUNTS']
+              ?.split(',')
+              .map((count) => int.parse(count.trim()))
+              .toList() ??
+          [10000, 100000],
+      replicationDocumentCount: int.parse(
+        environment['CBL_BENCHMARK_REPLICATION_DOCUMENT_COUNT'] ?? '10000',
+      ),
+      blobSize: int.parse(
+        environment['CBL_BENCHMARK_BLOB_SIZE'] ?? '${16 * 1024 * 1024}',
+      ),
+      repetitions: int.parse(environment['CBL_BENCHMARK_REPETITIONS'] ?? '5'),
+      resultsPath: environment['CBL_BENCHMARK_RESULTS'],
+      baselinePath: environment['CBL_BENCHMARK_BASELINE'],
+      tolerance: double.parse(environment['CBL_BENCHMARK_TOLERANCE'] ?? '0.1'),
+    );
+  }
+
+  final bool isEnabled;
+  final List<int> documentCounts;
+  final int replicationDocumentCount;
+  final int blobSize;
+  final int repetitions;
+  final String? resultsPath;
+  final String? baselinePath;
+  final double tolerance;
+}
+
+/// The measured value of a benchmark.
+final class BenchmarkResult {
+  BenchmarkResult({
+    required this.name,
+    required this.api,
+    required this.documentCount,
+    required this.value,
+    required this.unit,
+    required this.lowerIsBetter,
+  });
+
+  factory BenchmarkResult.fromJson(Map<String, Object?> json) =>
+      BenchmarkResult(
+        name: json['name']! as String,
+        api: json['api']! as String,
+        documentCount: json['documentCount'] as int?,
+        value: (json['value']! as num).toDouble(),
+        unit: json['unit']! as String,
+        lowerIsBetter: json['lowerIsBetter']! as bool,
+      );
+
+  final String name;
+
+  /// The API the benchmark used, either `sync` or `async`.
+  final String api;
+
+  /// The number of documents in the database, if the benchmark depends on it.
+  final int? documentCount;
+
+  final double value;
+  final String unit;
+
+  /// Whether a lower [value] is better, e.g. for durations, as opposed to
+  /// throughputs.
+  final bool lowerIsBetter;
+
+  /// The key which identifies the same benchmark across runs.
+  String get key => [
+        name,
+        api,
+        if (documentCount != null) 'documents:$documentCount',
+      ].join('/');
+
+  /// The relative change of this result compared with [baseline], where a
+  /// positive change is a regression.
+  double regressionComparedTo(BenchmarkResult baseline) => lowerIsBetter
+      ? value / baseline.value - 1
+      : baseline.value / value - 1;
+
+  Map<String, Object?> toJson() => {
+        'name': name,
+        'api': api,
+        if (documentCount != null) 'documentCount': documentCount,
+        'value': value,
+        'unit': unit,
+        'lowerIsBetter': lowerIsBetter,
+      };
+
+  @override
+  String toString() => '$key: ${value.toStringAsFixed(2)} $unit';
+}
+
+/// Collects the results of the benchmark suite and compares them with a
+/// baseline.
+final class BenchmarkReport {
+  BenchmarkReport(this.config);
+
+  final BenchmarkSuiteConfig config;
+
+  final _results = <BenchmarkResult>[];
+
+  List<BenchmarkResult> get results => List.unmodifiable(_results);
+
+  void add(BenchmarkResult result) {
+    print('Benchmark result: $result');
+    _results.add(result);
+  }
+
+  /// Records the median of [durations] as the result of a benchmark, in
+  /// microseconds.
+  void addDuration(
+    String name, {
+    required String api,
+    int? documentCount,
+    required List<Duration> durations,
+  }) =>
+      add(BenchmarkResult(
+        name: name,
+        api: api,
+        documentCount: documentCount,
+        value: median(durations.map((duration) => duration.inMicroseconds)),
+        unit: 'us',
+        lowerIsBetter: true,
+      ));
+
+  /// Records the throughput of processing [count] items of [unit] in the
+  /// median of [durations] as the result of a benchmark.
+  void addThroughput(
+    String name, {
+    required String api,
+    int? documentCount,
+    required int count,
+    required String unit,
+    required List<Duration> durations,
+  }) =>
+      add(BenchmarkResult(
+        name: name,
+        api: api,
+        documentCount: documentCount,
+        value: count /
+            median(durations.map((duration) => duration.inMicroseconds)) *
+            Duration.microsecondsPerSecond,
+        unit: '$unit/s',
+        lowerIsBetter: false,
+      ));
+
+  Map<String, Object?> toJson() => {
+        'version': 1,
+        'timestamp': DateTime.now().toUtc().toIso8601String(),
+        'platform': Platform.operatingSystem,
+        'dartVersion': Platform.version,
+        'results': [for (final result in _results) result.toJson()],
+      };
+
+  /// Prints the results as JSON and writes them to the configured results
+  /// file.
+  Future<void> write() async {
+    final json = jsonEncode(toJson());
+    print('Benchmark results: $json');
+
+    final resultsPath = config.resultsPath;
+    if (resultsPath != null) {
+      await File(resultsPath).writeAsString(json);
+    }
+  }
+
+  /// Compares [results], or all results if omitted, with the configured
+  /// baseline and returns the descriptions of the results which have
+  /// regressed.
+  Future<List<String>> compareWithBaseline([
+    Iterable<BenchmarkResult>? results,
+  ]) async {
+    final baselineByKey = await _baselineByKey;
+    if (baselineByKey == null) {
+      return [];
+    }
+
+    final regressions = <String>[];
+    for (final result in results ?? _results) {
+      final baselineResult = baselineByKey[result.key];
+      if (baselineResult == null) {
+        continue;
+      }
+
+      final regression = result.regressionComparedTo(baselineResult);
+      final change = '${regression > 0 ? '+' : ''}'
+          '${(regression * 100).toStringAsFixed(1)}%';
+      final description = '$result (baseline: '
+          '${baselineResult.value.toStringAsFixed(2)} ${baselineResult.unit}, '
+          'regression: $change)';
+      print('Benchmark comparison: $description');
+
+      if (regression > config.tolerance) {
+        regressions.add(description);
+      }
+    }
+    return regressions;
+  }
+
+  late final Future<Map<String, BenchmarkResult>?> _baselineByKey =
+      _loadBaseline();
+
+  Future<Map<String, BenchmarkResult>?> _loadBaseline() async {
+    final baselinePath = config.baselinePath;
+    if (baselinePath == null) {
+      return null;
+    }
+
+    final baselineJson = jsonDecode(await File(baselinePath).readAsString())
+        as Map<String, Object?>;
+    final baseline = [
+      for (final resultJson in baselineJson['results']! as List<Object?>)
+        BenchmarkResult.fromJson(resultJson! as Map<String, Object?>),
+    ];
+    return {for (final result in baseline) result.key: result};
+  }
+}
+
+/// Measures how long [body] takes, [repetitions] times.
+///
+/// [setUp] is called before each measurement, without being measured.
+Future<List<Duration>> measureRepeatedly(
+  int repetitions,
+  FutureOr<void> Function() body, {
+  FutureOr<void> Function()? setUp,
+}) async {
+  final durations = <Duration>[];
+  for (var i = 0; i < repetitions; i++) {
+    await setUp?.call();
+    durations.add(await measure(body));
+  }
+  return durations;
+}
+
+/// Measures how long [body] takes.
+Future<Duration> measure(FutureOr<void> Function() body) async {
+  final stopwatch = Stopwatch()..start();
+  final result = body();
+  if (result is Future<void>) {
+    await result;
+  }
+  return stopwatch.elapsed;
+}
+
+double median(Iterable<num> values) {
+  final sorted = values.sorted((a, b) => a.compareTo(b));
+  final middle = sorted.length ~/ 2;
+  return sorted.length.isOdd
+      ? sorted[middle].toDouble()
+      : (sorted[middle - 1] + sorted[middle]) / 2;
+}
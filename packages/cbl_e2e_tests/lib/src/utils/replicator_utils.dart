@@ -127,6 +127,9 @@ extension ReplicatorUtilsDatabaseExtension on Database {
     TypedConflictResolverFunction? typedConflictResolver,
     bool? enableAutoPurge,
     Authenticator? authenticator,
+    Duration? callbackDeadline,
+    bool? callbackDeadlineFilterResult,
+    Duration? callbackLatencyBudget,
   }) =>
       Replicator.create(ReplicatorConfiguration(
         database: this,
@@ -147,6 +150,9 @@ extension ReplicatorUtilsDatabaseExtension on Database {
             : null,
         enableAutoPurge: enableAutoPurge ?? true,
         authenticator: authenticator ?? janeAuthenticator,
+        callbackDeadline: callbackDeadline,
+        callbackDeadlineFilterResult: callbackDeadlineFilterResult ?? false,
+        callbackLatencyBudget: callbackLatencyBudget,
       ));
 }
 
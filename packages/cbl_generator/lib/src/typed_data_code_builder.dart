@@ -93,6 +93,12 @@ class ${_classNames.immutableClassName} extends ${_classNames.implBaseName} {
       ..forEach(_writePropertyConverterField)
       ..forEach(_writeImmutableCachedPropertyField);
 
+    // The properties of immutable objects never change, so the values of
+    // un-cached properties are decoded once, when they are first accessed.
+    object.properties
+        .where((property) => !property.type.isCached)
+        .forEach(_writeImmutableMemoizedPropertyField);
+
     _writeEqualsAndHashCode();
 
     _code.writeln('}');
@@ -378,6 +384,19 @@ late final ${property.name} = ${property.readHelper}(
     ''');
   }
 
+  void _writeImmutableMemoizedPropertyField(TypedDataObjectProperty property) {
+    _code.writeln('''
+@override
+late final ${property.name} = ${property.readHelper}(
+    internal: internal,
+    name: ${escapeDartString(property.name)},
+    key: ${escapeDartString(property.property)},
+    converter: ${_buildTypeConverterExpression(property.type, forMutable: false)},
+  );
+
+    ''');
+  }
+
   void _writeMutableCachedPropertyField(TypedDataObjectProperty property) {
     final type = property.type;
     _code.writeln('''
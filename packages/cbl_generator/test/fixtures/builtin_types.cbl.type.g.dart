@@ -46,6 +46,14 @@ abstract class _StringDocImplBase<I extends Document>
 class ImmutableStringDoc extends _StringDocImplBase {
   ImmutableStringDoc.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -118,6 +126,14 @@ abstract class _IntDocImplBase<I extends Document>
 class ImmutableIntDoc extends _IntDocImplBase {
   ImmutableIntDoc.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.intConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -191,6 +207,14 @@ abstract class _DoubleDocImplBase<I extends Document>
 class ImmutableDoubleDoc extends _DoubleDocImplBase {
   ImmutableDoubleDoc.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.doubleConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -263,6 +287,14 @@ abstract class _NumDocImplBase<I extends Document>
 class ImmutableNumDoc extends _NumDocImplBase {
   ImmutableNumDoc.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.numConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -335,6 +367,14 @@ abstract class _BoolDocImplBase<I extends Document>
 class ImmutableBoolDoc extends _BoolDocImplBase {
   ImmutableBoolDoc.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.boolConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -408,6 +448,14 @@ abstract class _DateTimeDocImplBase<I extends Document>
 class ImmutableDateTimeDoc extends _DateTimeDocImplBase {
   ImmutableDateTimeDoc.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.dateTimeConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -480,6 +528,14 @@ abstract class _BlobDocImplBase<I extends Document>
 class ImmutableBlobDoc extends _BlobDocImplBase {
   ImmutableBlobDoc.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.blobConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -554,6 +610,16 @@ abstract class _EnumDocImplBase<I extends Document>
 class ImmutableEnumDoc extends _EnumDocImplBase {
   ImmutableEnumDoc.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: const ScalarConverterAdapter(
+      const EnumNameConverter(TestEnum.values),
+    ),
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -635,6 +701,14 @@ abstract class _StringDictImplBase<I extends Dictionary>
 class ImmutableStringDict extends _StringDictImplBase {
   ImmutableStringDict.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -707,6 +781,14 @@ abstract class _IntDictImplBase<I extends Dictionary>
 class ImmutableIntDict extends _IntDictImplBase {
   ImmutableIntDict.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.intConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -780,6 +862,14 @@ abstract class _DoubleDictImplBase<I extends Dictionary>
 class ImmutableDoubleDict extends _DoubleDictImplBase {
   ImmutableDoubleDict.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.doubleConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -852,6 +942,14 @@ abstract class _NumDictImplBase<I extends Dictionary>
 class ImmutableNumDict extends _NumDictImplBase {
   ImmutableNumDict.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.numConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -924,6 +1022,14 @@ abstract class _BoolDictImplBase<I extends Dictionary>
 class ImmutableBoolDict extends _BoolDictImplBase {
   ImmutableBoolDict.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.boolConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -997,6 +1103,14 @@ abstract class _DateTimeDictImplBase<I extends Dictionary>
 class ImmutableDateTimeDict extends _DateTimeDictImplBase {
   ImmutableDateTimeDict.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.dateTimeConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -1069,6 +1183,14 @@ abstract class _BlobDictImplBase<I extends Dictionary>
 class ImmutableBlobDict extends _BlobDictImplBase {
   ImmutableBlobDict.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.blobConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -1143,6 +1265,14 @@ abstract class _NullableIntDictImplBase<I extends Dictionary>
 class ImmutableNullableIntDict extends _NullableIntDictImplBase {
   ImmutableNullableIntDict.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readNullableProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.intConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -1221,6 +1351,14 @@ abstract class _NullableDoubleDictImplBase<I extends Dictionary>
 class ImmutableNullableDoubleDict extends _NullableDoubleDictImplBase {
   ImmutableNullableDoubleDict.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readNullableProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.doubleConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -1301,6 +1439,14 @@ abstract class _NullableNumDictImplBase<I extends Dictionary>
 class ImmutableNullableNumDict extends _NullableNumDictImplBase {
   ImmutableNullableNumDict.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readNullableProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.numConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -1379,6 +1525,14 @@ abstract class _NullableBoolDictImplBase<I extends Dictionary>
 class ImmutableNullableBoolDict extends _NullableBoolDictImplBase {
   ImmutableNullableBoolDict.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readNullableProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.boolConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -1459,6 +1613,16 @@ abstract class _EnumDictImplBase<I extends Dictionary>
 class ImmutableEnumDict extends _EnumDictImplBase {
   ImmutableEnumDict.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: const ScalarConverterAdapter(
+      const EnumNameConverter(TestEnum.values),
+    ),
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
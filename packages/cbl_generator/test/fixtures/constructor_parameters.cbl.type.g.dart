@@ -45,6 +45,14 @@ abstract class _ParamDocImplBase<I extends Document>
 class ImmutableParamDoc extends _ParamDocImplBase {
   ImmutableParamDoc.internal(super.internal);
 
+  @override
+  late final a = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'a',
+    key: 'a',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -119,6 +127,14 @@ abstract class _OptionalParamDocImplBase<I extends Document>
 class ImmutableOptionalParamDoc extends _OptionalParamDocImplBase {
   ImmutableOptionalParamDoc.internal(super.internal);
 
+  @override
+  late final a = TypedDataHelpers.readNullableProperty(
+    internal: internal,
+    name: 'a',
+    key: 'a',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -209,6 +225,22 @@ class ImmutablePositionalMixedParamDoc
     extends _PositionalMixedParamDocImplBase {
   ImmutablePositionalMixedParamDoc.internal(super.internal);
 
+  @override
+  late final a = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'a',
+    key: 'a',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
+  @override
+  late final b = TypedDataHelpers.readNullableProperty(
+    internal: internal,
+    name: 'b',
+    key: 'b',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -300,6 +332,14 @@ abstract class _NamedParamDocImplBase<I extends Document>
 class ImmutableNamedParamDoc extends _NamedParamDocImplBase {
   ImmutableNamedParamDoc.internal(super.internal);
 
+  @override
+  late final a = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'a',
+    key: 'a',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -374,6 +414,14 @@ abstract class _NamedOptionalParamDocImplBase<I extends Document>
 class ImmutableNamedOptionalParamDoc extends _NamedOptionalParamDocImplBase {
   ImmutableNamedOptionalParamDoc.internal(super.internal);
 
+  @override
+  late final a = TypedDataHelpers.readNullableProperty(
+    internal: internal,
+    name: 'a',
+    key: 'a',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -465,6 +513,22 @@ abstract class _NamedMixedParamDocImplBase<I extends Document>
 class ImmutableNamedMixedParamDoc extends _NamedMixedParamDocImplBase {
   ImmutableNamedMixedParamDoc.internal(super.internal);
 
+  @override
+  late final a = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'a',
+    key: 'a',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
+  @override
+  late final b = TypedDataHelpers.readNullableProperty(
+    internal: internal,
+    name: 'b',
+    key: 'b',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -560,6 +624,14 @@ abstract class _ParamDictImplBase<I extends Dictionary>
 class ImmutableParamDict extends _ParamDictImplBase {
   ImmutableParamDict.internal(super.internal);
 
+  @override
+  late final a = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'a',
+    key: 'a',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -634,6 +706,14 @@ abstract class _OptionalParamDictImplBase<I extends Dictionary>
 class ImmutableOptionalParamDict extends _OptionalParamDictImplBase {
   ImmutableOptionalParamDict.internal(super.internal);
 
+  @override
+  late final a = TypedDataHelpers.readNullableProperty(
+    internal: internal,
+    name: 'a',
+    key: 'a',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -726,6 +806,22 @@ class ImmutablePositionalMixedParamDict
     extends _PositionalMixedParamDictImplBase {
   ImmutablePositionalMixedParamDict.internal(super.internal);
 
+  @override
+  late final a = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'a',
+    key: 'a',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
+  @override
+  late final b = TypedDataHelpers.readNullableProperty(
+    internal: internal,
+    name: 'b',
+    key: 'b',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -817,6 +913,14 @@ abstract class _NamedParamDictImplBase<I extends Dictionary>
 class ImmutableNamedParamDict extends _NamedParamDictImplBase {
   ImmutableNamedParamDict.internal(super.internal);
 
+  @override
+  late final a = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'a',
+    key: 'a',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -892,6 +996,14 @@ abstract class _NamedOptionalParamDictImplBase<I extends Dictionary>
 class ImmutableNamedOptionalParamDict extends _NamedOptionalParamDictImplBase {
   ImmutableNamedOptionalParamDict.internal(super.internal);
 
+  @override
+  late final a = TypedDataHelpers.readNullableProperty(
+    internal: internal,
+    name: 'a',
+    key: 'a',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -983,6 +1095,22 @@ abstract class _NamedMixedParamDictImplBase<I extends Dictionary>
 class ImmutableNamedMixedParamDict extends _NamedMixedParamDictImplBase {
   ImmutableNamedMixedParamDict.internal(super.internal);
 
+  @override
+  late final a = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'a',
+    key: 'a',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
+  @override
+  late final b = TypedDataHelpers.readNullableProperty(
+    internal: internal,
+    name: 'b',
+    key: 'b',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -47,6 +47,14 @@ abstract class _DocCommentDictImplBase<I extends Dictionary>
 class ImmutableDocCommentDict extends _DocCommentDictImplBase {
   ImmutableDocCommentDict.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
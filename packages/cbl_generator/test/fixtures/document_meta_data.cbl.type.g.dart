@@ -169,6 +169,14 @@ abstract class _DocWithIdAndFieldImplBase<I extends Document>
 class ImmutableDocWithIdAndField extends _DocWithIdAndFieldImplBase {
   ImmutableDocWithIdAndField.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -254,6 +262,14 @@ class ImmutableDocWithOptionalIdAndField
     extends _DocWithOptionalIdAndFieldImplBase {
   ImmutableDocWithOptionalIdAndField.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -48,6 +48,14 @@ class ImmutableCustomValueTypeMatcherDoc
     extends _CustomValueTypeMatcherDocImplBase {
   ImmutableCustomValueTypeMatcherDoc.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -47,6 +47,14 @@ abstract class _CustomDataNameDictImplBase<I extends Dictionary>
 class ImmutableCustomDataNameDict extends _CustomDataNameDictImplBase {
   ImmutableCustomDataNameDict.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'custom',
+    converter: TypedDataHelpers.boolConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -124,6 +132,14 @@ abstract class _DefaultValueDictImplBase<I extends Dictionary>
 class ImmutableDefaultValueDict extends _DefaultValueDictImplBase {
   ImmutableDefaultValueDict.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: TypedDataHelpers.boolConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -203,6 +219,16 @@ abstract class _ScalarConverterDictImplBase<I extends Dictionary>
 class ImmutableScalarConverterDict extends _ScalarConverterDictImplBase {
   ImmutableScalarConverterDict.internal(super.internal);
 
+  @override
+  late final value = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'value',
+    key: 'value',
+    converter: const ScalarConverterAdapter(
+      const TestConverter(),
+    ),
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
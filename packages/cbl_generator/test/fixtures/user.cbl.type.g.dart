@@ -87,6 +87,30 @@ class ImmutableUser extends _UserImplBase {
     converter: _nameConverter,
   );
 
+  @override
+  late final email = TypedDataHelpers.readNullableProperty(
+    internal: internal,
+    name: 'email',
+    key: 'email',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
+  @override
+  late final username = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'username',
+    key: 'username',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
+  @override
+  late final createdAt = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'createdAt',
+    key: 'createdAt',
+    converter: TypedDataHelpers.dateTimeConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
@@ -231,6 +255,22 @@ abstract class _PersonalNameImplBase<I extends Dictionary>
 class ImmutablePersonalName extends _PersonalNameImplBase {
   ImmutablePersonalName.internal(super.internal);
 
+  @override
+  late final first = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'first',
+    key: 'first',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
+  @override
+  late final last = TypedDataHelpers.readProperty(
+    internal: internal,
+    name: 'last',
+    key: 'last',
+    converter: TypedDataHelpers.stringConverter,
+  );
+
   @override
   bool operator ==(Object other) =>
       identical(this, other) ||
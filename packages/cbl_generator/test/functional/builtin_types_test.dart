@@ -30,4 +30,12 @@ void main() {
     expect(EnumDict(TestEnum.a).value, TestEnum.a);
     expect(EnumDoc(TestEnum.a).value, TestEnum.a);
   });
+
+  test('immutable object decodes property once', () {
+    final doc = ImmutableDateTimeDoc.internal(
+      MutableDocument({'value': DateTime(2022).toIso8601String()}),
+    );
+    expect(doc.value, DateTime(2022));
+    expect(doc.value, same(doc.value));
+  });
 }